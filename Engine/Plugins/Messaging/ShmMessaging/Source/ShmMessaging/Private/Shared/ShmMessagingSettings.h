@@ -13,7 +13,16 @@ class UShmMessagingSettings
 
 public:
 
-	/** Whether the UDP transport channel is enabled. */
+	/** Whether the shared memory transport channel is enabled. */
 	UPROPERTY(config, EditAnywhere, Category=Transport)
 	bool EnableTransport;
+
+	/**
+	 * The size of this process' mailbox for inbound messages (in megabytes).
+	 *
+	 * Messages larger than a quarter of a mailbox are sent in segments, so larger mailboxes
+	 * mostly help to absorb bursts of messages. The size is rounded up to a power of two.
+	 */
+	UPROPERTY(config, EditAnywhere, Category=Transport, AdvancedDisplay, meta=(ClampMin="1", ClampMax="256"))
+	int32 MailboxSize;
 };
@@ -6,4 +6,5 @@
 UShmMessagingSettings::UShmMessagingSettings( const FObjectInitializer& ObjectInitializer )
 	: Super(ObjectInitializer)
 	, EnableTransport(true)
+	, MailboxSize(4)
 { }
@@ -7,14 +7,42 @@
  *****************************************************************************/
 
 #include "Core.h"
+#include "CoreUObject.h"
 #include "Messaging.h"
 
 
 /* Private constants
  *****************************************************************************/
 
-/** Defines the protocol version of the UDP message transport. */
-#define SHM_MESSAGING_TRANSPORT_PROTOCOL_VERSION 1
+/** Defines the name of the shared memory region that holds the node directory. */
+#define SHM_MESSAGING_DIRECTORY_NAME TEXT("UE4ShmMessagingDirectory")
+
+/** Defines the prefix of the names of the shared memory regions that hold node mailboxes. */
+#define SHM_MESSAGING_MAILBOX_PREFIX TEXT("UE4ShmMessagingMailbox")
+
+/** Defines the maximum number of annotations a message can have. */
+#define SHM_MESSAGING_MAX_ANNOTATIONS 128
+
+/** Defines the maximum size of a message (in bytes). */
+#define SHM_MESSAGING_MAX_MESSAGE_SIZE 64 * 1024 * 1024
+
+/** Defines the maximum number of nodes that can be registered in the node directory. */
+#define SHM_MESSAGING_MAX_NODES 64
+
+/** Defines the maximum number of recipients a message can have. */
+#define SHM_MESSAGING_MAX_RECIPIENTS 1024
+
+/** Defines the maximum size of a message segment (in bytes). */
+#define SHM_MESSAGING_MAX_SEGMENT_SIZE 256 * 1024
+
+/** Defines the time after which a node that stopped updating its heartbeat is considered lost (in seconds). */
+#define SHM_MESSAGING_NODE_TIMEOUT 5.0
+
+/** Defines how long queued messages wait for a full mailbox to make room before they're dropped (in seconds). */
+#define SHM_MESSAGING_SEND_TIMEOUT 1.0
+
+/** Defines the protocol version of the shared memory message transport. */
+#define SHM_MESSAGING_TRANSPORT_PROTOCOL_VERSION 2
 
 
 /* Private includes
@@ -24,4 +52,8 @@
 #include "ShmMessagingSettings.h"
 
 // transport
+#include "ShmMessageMailbox.h"
+#include "ShmMessageDirectory.h"
+#include "ShmDeserializedMessage.h"
+#include "ShmMessageProcessor.h"
 #include "ShmMessageTransport.h"
@@ -0,0 +1,197 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShmMessagingPrivatePCH.h"
+#include "BinaryStructDeserializerBackend.h"
+#include "StructDeserializer.h"
+
+
+/* FShmDeserializedMessage structors
+ *****************************************************************************/
+
+FShmDeserializedMessage::~FShmDeserializedMessage()
+{
+	if (MessageData != nullptr)
+	{
+		if (TypeInfo.IsValid())
+		{
+			TypeInfo->DestroyScriptStruct(MessageData);
+		}
+
+		FMemory::Free(MessageData);
+	}
+}
+
+
+/* FShmDeserializedMessage interface
+ *****************************************************************************/
+
+bool FShmDeserializedMessage::Deserialize( const TArray<uint8>& Data )
+{
+	// Note that some complex values are deserialized manually here, so that we
+	// can sanity check their values. @see FShmMessageTransport::SerializeMessage()
+
+	FMemoryReader MessageReader(Data);
+	MessageReader.ArMaxSerializeSize = NAME_SIZE;
+
+	// message type info
+	{
+		FName MessageType;
+		MessageReader << MessageType;
+
+		TypeInfo = FMessageTypeMap::MessageTypeMap.Find(MessageType.ToString());
+
+		if (!TypeInfo.IsValid(false, true))
+		{
+			return false;
+		}
+	}
+
+	// sender address
+	{
+		MessageReader << Sender;
+	}
+
+	// recipient addresses
+	{
+		int32 NumRecipients = 0;
+		MessageReader << NumRecipients;
+
+		if (NumRecipients > SHM_MESSAGING_MAX_RECIPIENTS)
+		{
+			return false;
+		}
+
+		Recipients.Empty(NumRecipients);
+
+		while (0 < NumRecipients--)
+		{
+			MessageReader << *::new(Recipients) FMessageAddress;
+		}
+	}
+
+	// message scope
+	{
+		MessageReader << Scope;
+
+		if (static_cast<uint8>(Scope.GetValue()) > static_cast<uint8>(EMessageScope::All))
+		{
+			return false;
+		}
+	}
+
+	// time sent & expiration
+	{
+		MessageReader << TimeSent;
+		MessageReader << Expiration;
+	}
+
+	// annotations
+	{
+		int32 NumAnnotations = 0;
+		MessageReader << NumAnnotations;
+
+		if (NumAnnotations > SHM_MESSAGING_MAX_ANNOTATIONS)
+		{
+			return false;
+		}
+
+		while (0 < NumAnnotations--)
+		{
+			FName Key;
+			FString Value;
+
+			MessageReader << Key;
+			MessageReader << Value;
+
+			Annotations.Add(Key, Value);
+		}
+	}
+
+	if (MessageReader.IsError())
+	{
+		return false;
+	}
+
+	// create & deserialize message body
+	MessageData = FMemory::Malloc(TypeInfo->PropertiesSize);
+	TypeInfo->InitializeScriptStruct(MessageData);
+
+	FBinaryStructDeserializerBackend Backend(MessageReader);
+
+	return FStructDeserializer::Deserialize(MessageData, *TypeInfo, Backend);
+}
+
+
+/* IMessageContext interface
+ *****************************************************************************/
+
+const TMap<FName, FString>& FShmDeserializedMessage::GetAnnotations() const
+{
+	return Annotations;
+}
+
+
+IMessageAttachmentPtr FShmDeserializedMessage::GetAttachment() const
+{
+	return nullptr;
+}
+
+
+const FDateTime& FShmDeserializedMessage::GetExpiration() const
+{
+	return Expiration;
+}
+
+
+const void* FShmDeserializedMessage::GetMessage() const
+{
+	return MessageData;
+}
+
+
+const TWeakObjectPtr<UScriptStruct>& FShmDeserializedMessage::GetMessageTypeInfo() const
+{
+	return TypeInfo;
+}
+
+
+IMessageContextPtr FShmDeserializedMessage::GetOriginalContext() const
+{
+	return nullptr;
+}
+
+
+const TArray<FMessageAddress>& FShmDeserializedMessage::GetRecipients() const
+{
+	return Recipients;
+}
+
+
+EMessageScope FShmDeserializedMessage::GetScope() const
+{
+	return Scope;
+}
+
+
+const FMessageAddress& FShmDeserializedMessage::GetSender() const
+{
+	return Sender;
+}
+
+
+ENamedThreads::Type FShmDeserializedMessage::GetSenderThread() const
+{
+	return ENamedThreads::AnyThread;
+}
+
+
+const FDateTime& FShmDeserializedMessage::GetTimeForwarded() const
+{
+	return TimeSent;
+}
+
+
+const FDateTime& FShmDeserializedMessage::GetTimeSent() const
+{
+	return TimeSent;
+}
@@ -0,0 +1,82 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+
+/**
+ * Holds a deserialized message.
+ */
+class FShmDeserializedMessage
+	: public IMessageContext
+{
+public:
+
+	/** Default constructor. */
+	FShmDeserializedMessage()
+		: MessageData(nullptr)
+	{ }
+
+	/** Destructor. */
+	~FShmDeserializedMessage();
+
+public:
+
+	/**
+	 * Deserializes the given message data.
+	 *
+	 * @param Data The message data to deserialize.
+	 * @return true on success, false otherwise.
+	 * @see FShmMessageTransport::SerializeMessage
+	 */
+	bool Deserialize( const TArray<uint8>& Data );
+
+public:
+
+	// IMessageContext interface
+
+	virtual const TMap<FName, FString>& GetAnnotations() const override;
+	virtual IMessageAttachmentPtr GetAttachment() const override;
+	virtual const FDateTime& GetExpiration() const override;
+	virtual const void* GetMessage() const override;
+	virtual const TWeakObjectPtr<UScriptStruct>& GetMessageTypeInfo() const override;
+	virtual IMessageContextPtr GetOriginalContext() const override;
+	virtual const TArray<FMessageAddress>& GetRecipients() const override;
+	virtual EMessageScope GetScope() const override;
+	virtual const FMessageAddress& GetSender() const override;
+	virtual ENamedThreads::Type GetSenderThread() const override;
+	virtual const FDateTime& GetTimeForwarded() const override;
+	virtual const FDateTime& GetTimeSent() const override;
+
+private:
+
+	/** Holds the optional message annotations. */
+	TMap<FName, FString> Annotations;
+
+	/** Holds the expiration time. */
+	FDateTime Expiration;
+
+	/** Holds the message. */
+	void* MessageData;
+
+	/** Holds the message recipients. */
+	TArray<FMessageAddress> Recipients;
+
+	/** Holds the message's scope. */
+	TEnumAsByte<EMessageScope> Scope;
+
+	/** Holds the sender's identifier. */
+	FMessageAddress Sender;
+
+	/** Holds the time at which the message was sent. */
+	FDateTime TimeSent;
+
+	/** Holds the message's type information. */
+	TWeakObjectPtr<UScriptStruct> TypeInfo;
+};
+
+
+/** Type definition for shared pointers to instances of FShmDeserializedMessage. */
+typedef TSharedPtr<FShmDeserializedMessage, ESPMode::ThreadSafe> FShmDeserializedMessagePtr;
+
+/** Type definition for shared references to instances of FShmDeserializedMessage. */
+typedef TSharedRef<FShmDeserializedMessage, ESPMode::ThreadSafe> FShmDeserializedMessageRef;
@@ -0,0 +1,296 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShmMessagingPrivatePCH.h"
+
+
+/* Shared memory layout
+ *****************************************************************************/
+
+/** Identifies an initialized directory ('SHMD'). */
+#define SHM_MESSAGING_DIRECTORY_MAGIC 0x444D4853
+
+
+enum class EShmDirectoryEntryState : int32
+{
+	/** The entry is not used. */
+	Free,
+
+	/** The entry is being filled in by the node that claimed it. */
+	Claimed,
+
+	/** The entry holds a registered node. */
+	Active
+};
+
+
+struct FShmDirectoryEntry
+{
+	/** Holds the entry's state (see EShmDirectoryEntryState). */
+	volatile int32 State;
+
+	/** Holds the identifier of the process that hosts the node. */
+	uint32 ProcessId;
+
+	/** Holds the time of the node's last heartbeat (in UTC ticks). */
+	volatile int64 Heartbeat;
+
+	/** Holds the node's identifier. */
+	FGuid NodeId;
+};
+
+
+struct FShmMessageDirectory::FHeader
+{
+	/** Holds SHM_MESSAGING_DIRECTORY_MAGIC once the directory is initialized, 1 while it is being initialized. */
+	volatile int32 Magic;
+
+	/** Reserved for future use. */
+	uint32 Reserved;
+
+	/** Holds an identifier that is unique for each incarnation of the directory. */
+	FGuid DirectoryId;
+
+	/** Holds the node entries. */
+	FShmDirectoryEntry Entries[SHM_MESSAGING_MAX_NODES];
+};
+
+
+/* FShmMessageDirectory structors
+ *****************************************************************************/
+
+FShmMessageDirectory::FShmMessageDirectory( FPlatformMemory::FSharedMemoryRegion* InRegion )
+	: Header((FHeader*)InRegion->GetAddress())
+	, EntryIndex(INDEX_NONE)
+	, Region(InRegion)
+{
+	FMemory::MemZero(ClaimedTimes);
+}
+
+
+FShmMessageDirectory::~FShmMessageDirectory()
+{
+	Unregister();
+	FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+}
+
+
+/* FShmMessageDirectory static interface
+ *****************************************************************************/
+
+FShmMessageDirectory* FShmMessageDirectory::Open()
+{
+	const FString RegionName = GetRegionName();
+	const uint32 AccessMode = FPlatformMemory::ESharedMemoryAccess::Read | FPlatformMemory::ESharedMemoryAccess::Write;
+
+	// only create the region if it doesn't exist, so that it isn't destroyed by every process that used it
+	FPlatformMemory::FSharedMemoryRegion* Region = FPlatformMemory::MapNamedSharedMemoryRegion(RegionName, false, AccessMode, sizeof(FHeader));
+
+	if (Region == nullptr)
+	{
+		Region = FPlatformMemory::MapNamedSharedMemoryRegion(RegionName, true, AccessMode, sizeof(FHeader));
+
+		if (Region == nullptr)
+		{
+			return nullptr;
+		}
+	}
+
+	// the first process to map a new region initializes it, the others wait for it
+	FHeader* Header = (FHeader*)Region->GetAddress();
+
+	if (FPlatformAtomics::InterlockedCompareExchange(&Header->Magic, 1, 0) == 0)
+	{
+		Header->DirectoryId = FGuid::NewGuid();
+		FPlatformAtomics::InterlockedExchange(&Header->Magic, SHM_MESSAGING_DIRECTORY_MAGIC);
+	}
+	else
+	{
+		const double WaitEndTime = FPlatformTime::Seconds() + 1.0;
+
+		while ((Header->Magic != SHM_MESSAGING_DIRECTORY_MAGIC) && (FPlatformTime::Seconds() < WaitEndTime))
+		{
+			FPlatformProcess::Sleep(0.0f);
+		}
+	}
+
+	if (Header->Magic != SHM_MESSAGING_DIRECTORY_MAGIC)
+	{
+		GLog->Logf(TEXT("Warning: ShmMessageDirectory: Directory %s is incompatible"), *RegionName);
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+
+		return nullptr;
+	}
+
+	FPlatformMisc::MemoryBarrier();
+
+	return new FShmMessageDirectory(Region);
+}
+
+
+/* FShmMessageDirectory interface
+ *****************************************************************************/
+
+void FShmMessageDirectory::GetNodes( TArray<FGuid>& OutNodeIds )
+{
+	const int64 TimeoutTicks = FTimespan::FromSeconds(SHM_MESSAGING_NODE_TIMEOUT).GetTicks();
+	const int64 NowTicks = FDateTime::UtcNow().GetTicks();
+	const double CurrentTime = FPlatformTime::Seconds();
+
+	OutNodeIds.Reset();
+
+	for (int32 Index = 0; Index < SHM_MESSAGING_MAX_NODES; ++Index)
+	{
+		FShmDirectoryEntry& Entry = Header->Entries[Index];
+
+		if (Index == EntryIndex)
+		{
+			continue;
+		}
+
+		if (Entry.State == (int32)EShmDirectoryEntryState::Claimed)
+		{
+			// nodes fill in their entries right after claiming them, so an entry
+			// that stays claimed belongs to a process that died while doing so
+			if (ClaimedTimes[Index] == 0.0)
+			{
+				ClaimedTimes[Index] = CurrentTime;
+			}
+			else if (CurrentTime - ClaimedTimes[Index] > SHM_MESSAGING_NODE_TIMEOUT)
+			{
+				FPlatformAtomics::InterlockedCompareExchange(&Entry.State, (int32)EShmDirectoryEntryState::Free, (int32)EShmDirectoryEntryState::Claimed);
+				ClaimedTimes[Index] = 0.0;
+			}
+
+			continue;
+		}
+
+		ClaimedTimes[Index] = 0.0;
+
+		if (Entry.State != (int32)EShmDirectoryEntryState::Active)
+		{
+			continue;
+		}
+
+		FPlatformMisc::MemoryBarrier();
+
+		const FGuid EntryNodeId = Entry.NodeId;
+		const int64 Heartbeat = Entry.Heartbeat;
+
+		if (NowTicks - Heartbeat > TimeoutTicks)
+		{
+			FPlatformAtomics::InterlockedCompareExchange(&Entry.State, (int32)EShmDirectoryEntryState::Free, (int32)EShmDirectoryEntryState::Active);
+		}
+		else
+		{
+			FPlatformMisc::MemoryBarrier();
+
+			// make sure the entry wasn't released and claimed by another node while it was being read
+			if (Entry.State == (int32)EShmDirectoryEntryState::Active)
+			{
+				OutNodeIds.Add(EntryNodeId);
+			}
+		}
+	}
+}
+
+
+bool FShmMessageDirectory::IsCurrent() const
+{
+	FPlatformMemory::FSharedMemoryRegion* CurrentRegion = FPlatformMemory::MapNamedSharedMemoryRegion(GetRegionName(), false, FPlatformMemory::ESharedMemoryAccess::Read, sizeof(FHeader));
+
+	if (CurrentRegion == nullptr)
+	{
+		return false;
+	}
+
+	const FHeader* CurrentHeader = (const FHeader*)CurrentRegion->GetAddress();
+	const bool Result = (CurrentHeader->Magic == SHM_MESSAGING_DIRECTORY_MAGIC) && (CurrentHeader->DirectoryId == Header->DirectoryId);
+
+	FPlatformMemory::UnmapNamedSharedMemoryRegion(CurrentRegion);
+
+	return Result;
+}
+
+
+bool FShmMessageDirectory::Register( const FGuid& InNodeId )
+{
+	Unregister();
+
+	for (int32 Index = 0; Index < SHM_MESSAGING_MAX_NODES; ++Index)
+	{
+		FShmDirectoryEntry& Entry = Header->Entries[Index];
+
+		if (FPlatformAtomics::InterlockedCompareExchange(&Entry.State, (int32)EShmDirectoryEntryState::Claimed, (int32)EShmDirectoryEntryState::Free) == (int32)EShmDirectoryEntryState::Free)
+		{
+			Entry.ProcessId = FPlatformProcess::GetCurrentProcessId();
+			Entry.Heartbeat = FDateTime::UtcNow().GetTicks();
+			Entry.NodeId = InNodeId;
+
+			// other nodes reclaim entries that stay claimed for too long, in which case this one is lost
+			if (FPlatformAtomics::InterlockedCompareExchange(&Entry.State, (int32)EShmDirectoryEntryState::Active, (int32)EShmDirectoryEntryState::Claimed) != (int32)EShmDirectoryEntryState::Claimed)
+			{
+				continue;
+			}
+
+			EntryIndex = Index;
+			NodeId = InNodeId;
+
+			return true;
+		}
+	}
+
+	GLog->Logf(TEXT("Warning: ShmMessageDirectory: Failed to register node %s, because the directory is full"), *InNodeId.ToString());
+
+	return false;
+}
+
+
+void FShmMessageDirectory::Unregister()
+{
+	if (EntryIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	FShmDirectoryEntry& Entry = Header->Entries[EntryIndex];
+
+	// the entry may have timed out and been claimed by another node already
+	if (Entry.NodeId == NodeId)
+	{
+		FPlatformAtomics::InterlockedCompareExchange(&Entry.State, (int32)EShmDirectoryEntryState::Free, (int32)EShmDirectoryEntryState::Active);
+	}
+
+	EntryIndex = INDEX_NONE;
+}
+
+
+bool FShmMessageDirectory::UpdateHeartbeat()
+{
+	if (EntryIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	FShmDirectoryEntry& Entry = Header->Entries[EntryIndex];
+
+	if ((Entry.State != (int32)EShmDirectoryEntryState::Active) || (Entry.NodeId != NodeId))
+	{
+		EntryIndex = INDEX_NONE;
+
+		return false;
+	}
+
+	FPlatformAtomics::InterlockedExchange(&Entry.Heartbeat, FDateTime::UtcNow().GetTicks());
+
+	return true;
+}
+
+
+/* FShmMessageDirectory implementation
+ *****************************************************************************/
+
+FString FShmMessageDirectory::GetRegionName()
+{
+	// nodes with different protocol versions use separate directories
+	return FString::Printf(TEXT("%s_%i"), SHM_MESSAGING_DIRECTORY_NAME, SHM_MESSAGING_TRANSPORT_PROTOCOL_VERSION);
+}
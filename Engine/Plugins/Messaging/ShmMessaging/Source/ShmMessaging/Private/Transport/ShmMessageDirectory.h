@@ -0,0 +1,101 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+
+/**
+ * Implements the directory through which shared memory nodes discover each other.
+ *
+ * The directory is a table of node entries in a named shared memory region that all nodes on the
+ * machine open. Each node claims an entry and updates its heartbeat periodically, so that the other
+ * nodes can tell when it went away without unregistering, i.e. because its process crashed. Entries
+ * are claimed and released with atomic operations on their state, so a process that dies at any point
+ * can't leave the directory locked, and entries that a process claimed but never filled in are
+ * released by the other nodes after the node timeout.
+ *
+ * Named shared memory on POSIX platforms goes away with the process that created it, even if other
+ * processes still map it, so nodes need to check whether their directory is still the current one.
+ */
+class FShmMessageDirectory
+{
+public:
+
+	/**
+	 * Opens the directory, creating it if needed.
+	 *
+	 * @return The directory, or nullptr if it could not be opened.
+	 */
+	static FShmMessageDirectory* Open();
+
+	/** Destructor. */
+	~FShmMessageDirectory();
+
+public:
+
+	/**
+	 * Gets the identifiers of the other registered nodes.
+	 *
+	 * Entries of nodes whose heartbeat timed out, and entries that stayed claimed
+	 * for longer than the node timeout, are released.
+	 *
+	 * @param OutNodeIds Will hold the node identifiers.
+	 */
+	void GetNodes( TArray<FGuid>& OutNodeIds );
+
+	/**
+	 * Checks whether this directory is still the one that new nodes will open.
+	 *
+	 * @return true if the directory is current, false if it needs to be opened again.
+	 */
+	bool IsCurrent() const;
+
+	/**
+	 * Registers the local node.
+	 *
+	 * @param InNodeId The local node's identifier.
+	 * @return true on success, false if the directory is full.
+	 */
+	bool Register( const FGuid& InNodeId );
+
+	/** Unregisters the local node, if it is registered. */
+	void Unregister();
+
+	/**
+	 * Updates the local node's heartbeat.
+	 *
+	 * @return true on success, false if the local node's entry has been released and it needs to register again.
+	 */
+	bool UpdateHeartbeat();
+
+protected:
+
+	/** Hidden constructor, use Open. */
+	FShmMessageDirectory( FPlatformMemory::FSharedMemoryRegion* InRegion );
+
+	/**
+	 * Gets the name of the directory's shared memory region.
+	 *
+	 * @return Region name.
+	 */
+	static FString GetRegionName();
+
+private:
+
+	/** Layout of the directory in shared memory. */
+	struct FHeader;
+
+	/** Holds the directory in shared memory. */
+	FHeader* Header;
+
+	/** Holds the times at which entries were first seen claimed (in seconds), or zero if they weren't. */
+	double ClaimedTimes[SHM_MESSAGING_MAX_NODES];
+
+	/** Holds the index of the local node's entry, or INDEX_NONE if it isn't registered. */
+	int32 EntryIndex;
+
+	/** Holds the local node's identifier. */
+	FGuid NodeId;
+
+	/** Holds the shared memory region. */
+	FPlatformMemory::FSharedMemoryRegion* Region;
+};
@@ -0,0 +1,490 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShmMessagingPrivatePCH.h"
+
+
+/* Shared memory layout
+ *****************************************************************************/
+
+/** Identifies the shared memory region of a mailbox ('SHMB'). */
+#define SHM_MESSAGING_MAILBOX_MAGIC 0x424D4853
+
+/** Defines the alignment of records in the ring buffer (in bytes), which is also the size of a record header. */
+#define SHM_MESSAGING_RECORD_ALIGNMENT 16
+
+/** Defines how much segment data senders copy between checks whether their reservation was skipped (in bytes). */
+#define SHM_MESSAGING_COPY_CHUNK_SIZE 4096
+
+
+struct FShmMessageMailbox::FHeader
+{
+	/** Holds SHM_MESSAGING_MAILBOX_MAGIC once the mailbox has been initialized. */
+	volatile int32 Magic;
+
+	/** Holds the protocol version of the node that created the mailbox. */
+	uint32 ProtocolVersion;
+
+	/** Holds the size of the ring buffer that follows the header (in bytes). */
+	uint32 Capacity;
+
+	/** Padding that keeps the read-only fields above away from the senders' cache line. */
+	uint8 Padding0[52];
+
+	/** Holds the position up to which senders reserved space, modified by senders only. */
+	volatile int32 Head;
+
+	/** Padding that keeps the head and the tail in separate cache lines. */
+	uint8 Padding1[60];
+
+	/** Holds the position up to which records were released, modified by the receiver only. */
+	volatile int32 Tail;
+
+	/** Padding that keeps the ring buffer away from the receiver's cache line. */
+	uint8 Padding2[60];
+};
+
+
+enum class EShmMailboxRecordType : uint32
+{
+	/** The record holds a message segment. */
+	Segment = 1,
+
+	/** The record fills the space before the end of the ring buffer. */
+	Padding = 2
+};
+
+
+struct FShmMessageMailbox::FRecordHeader
+{
+	/**
+	 * Holds the record's state, which is zero until the sender marks its reservation, and otherwise
+	 * packs the record's position in the ring buffer with its total size (in bytes) once it has been
+	 * committed, or its negated size while the sender is still writing it.
+	 *
+	 * @see MakeRecordState, MakeSkippedRecordState
+	 */
+	volatile int64 State;
+
+	/** Holds the type of the record. */
+	EShmMailboxRecordType Type;
+
+	/** Padding that keeps the following records aligned. */
+	uint32 Padding;
+};
+
+
+/* Local helpers
+ *****************************************************************************/
+
+/** Packs a record's position and size into a record state. */
+static int64 MakeRecordState( uint32 Position, int32 Size )
+{
+	return (int64)(((uint64)Position << 32) | (uint32)Size);
+}
+
+
+/**
+ * Makes the state that the receiver gives to records it skips, so that their senders fail to mark
+ * or commit them. It never matches another state, because record positions are always aligned.
+ */
+static int64 MakeSkippedRecordState( uint32 Position )
+{
+	return MakeRecordState(Position | 1, 0);
+}
+
+
+/** Gets the position of a record from its state. */
+static uint32 GetRecordPosition( int64 State )
+{
+	return (uint32)((uint64)State >> 32);
+}
+
+
+/** Gets the (negated, if uncommitted) size of a record from its state. */
+static int32 GetRecordSize( int64 State )
+{
+	return (int32)(uint32)State;
+}
+
+
+/* FShmMessageMailbox structors
+ *****************************************************************************/
+
+FShmMessageMailbox::FShmMessageMailbox( FPlatformMemory::FSharedMemoryRegion* InRegion, bool InReceiving )
+	: Header((FHeader*)InRegion->GetAddress())
+	, Ring((uint8*)InRegion->GetAddress() + sizeof(FHeader))
+	, Capacity(Header->Capacity)
+	, Corrupt(false)
+	, PeekedRecordSize(0)
+	, ReadPosition((uint32)Header->Tail)
+	, Receiving(InReceiving)
+	, Region(InRegion)
+	, StalledHead(0)
+	, StalledPosition(0)
+	, StalledTime(0.0)
+{
+	// leave room for a few records in flight, so that large messages are streamed through the ring
+	MaxSegmentSize = FMath::Min<uint32>(Capacity / 4 - sizeof(FRecordHeader) - sizeof(FSegmentHeader), SHM_MESSAGING_MAX_SEGMENT_SIZE);
+}
+
+
+FShmMessageMailbox::~FShmMessageMailbox()
+{
+	FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+}
+
+
+/* FShmMessageMailbox static interface
+ *****************************************************************************/
+
+FShmMessageMailbox* FShmMessageMailbox::Create( const FGuid& NodeId, uint32 Capacity )
+{
+	Capacity = FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(Capacity, 64 * 1024));
+
+	FPlatformMemory::FSharedMemoryRegion* Region = FPlatformMemory::MapNamedSharedMemoryRegion(GetRegionName(NodeId), true, FPlatformMemory::ESharedMemoryAccess::Read | FPlatformMemory::ESharedMemoryAccess::Write, sizeof(FHeader) + Capacity);
+
+	if (Region == nullptr)
+	{
+		return nullptr;
+	}
+
+	// new regions are zero filled, which is the empty state of the ring buffer
+	FHeader* Header = (FHeader*)Region->GetAddress();
+	Header->ProtocolVersion = SHM_MESSAGING_TRANSPORT_PROTOCOL_VERSION;
+	Header->Capacity = Capacity;
+	Header->Head = 0;
+	Header->Tail = 0;
+
+	FPlatformAtomics::InterlockedExchange(&Header->Magic, SHM_MESSAGING_MAILBOX_MAGIC);
+
+	return new FShmMessageMailbox(Region, true);
+}
+
+
+FShmMessageMailbox* FShmMessageMailbox::Open( const FGuid& NodeId )
+{
+	const FString RegionName = GetRegionName(NodeId);
+	const uint32 AccessMode = FPlatformMemory::ESharedMemoryAccess::Read | FPlatformMemory::ESharedMemoryAccess::Write;
+
+	// map the header first to find out how large the ring buffer is
+	uint32 Capacity = 0;
+	{
+		FPlatformMemory::FSharedMemoryRegion* HeaderRegion = FPlatformMemory::MapNamedSharedMemoryRegion(RegionName, false, AccessMode, sizeof(FHeader));
+
+		if (HeaderRegion == nullptr)
+		{
+			return nullptr;
+		}
+
+		const FHeader* Header = (const FHeader*)HeaderRegion->GetAddress();
+
+		if ((Header->Magic == SHM_MESSAGING_MAILBOX_MAGIC) && (Header->ProtocolVersion == SHM_MESSAGING_TRANSPORT_PROTOCOL_VERSION) && FMath::IsPowerOfTwo(Header->Capacity))
+		{
+			Capacity = Header->Capacity;
+		}
+
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(HeaderRegion);
+	}
+
+	if (Capacity == 0)
+	{
+		GLog->Logf(TEXT("Warning: ShmMessageMailbox: Mailbox of node %s is incompatible"), *NodeId.ToString());
+
+		return nullptr;
+	}
+
+	FPlatformMemory::FSharedMemoryRegion* Region = FPlatformMemory::MapNamedSharedMemoryRegion(RegionName, false, AccessMode, sizeof(FHeader) + Capacity);
+
+	if (Region == nullptr)
+	{
+		return nullptr;
+	}
+
+	return new FShmMessageMailbox(Region, false);
+}
+
+
+/* FShmMessageMailbox interface
+ *****************************************************************************/
+
+bool FShmMessageMailbox::Send( const FSegmentHeader& SegmentHeader, const void* Data )
+{
+	check(SegmentHeader.SegmentSize <= MaxSegmentSize);
+
+	const uint32 RecordSize = Align<uint32>(sizeof(FRecordHeader) + sizeof(FSegmentHeader) + SegmentHeader.SegmentSize, SHM_MESSAGING_RECORD_ALIGNMENT);
+
+	uint32 Head;
+	uint32 PaddingSize;
+
+	// reserve space
+	for (;;)
+	{
+		Head = (uint32)Header->Head;
+		const uint32 Tail = (uint32)Header->Tail;
+
+		// the receiver may have moved past a head that has been advanced by another sender meanwhile
+		if ((int32)(Head - Tail) < 0)
+		{
+			continue;
+		}
+
+		const uint32 Offset = Head & (Capacity - 1);
+		PaddingSize = (Capacity - Offset < RecordSize) ? Capacity - Offset : 0;
+
+		if (Head - Tail + PaddingSize + RecordSize > Capacity)
+		{
+			return false;
+		}
+
+		if (FPlatformAtomics::InterlockedCompareExchange(&Header->Head, (int32)(Head + PaddingSize + RecordSize), (int32)Head) == (int32)Head)
+		{
+			break;
+		}
+	}
+
+	// write & commit padding and segment, each of which is marked with its size first
+	// so that the receiver knows how much to skip if this process dies meanwhile
+	if (PaddingSize > 0)
+	{
+		if (!WriteRecord(Head, PaddingSize, EShmMailboxRecordType::Padding, nullptr, nullptr))
+		{
+			return false;
+		}
+
+		Head += PaddingSize;
+	}
+
+	return WriteRecord(Head, RecordSize, EShmMailboxRecordType::Segment, &SegmentHeader, Data);
+}
+
+
+const uint8* FShmMessageMailbox::Peek( FSegmentHeader& OutSegmentHeader )
+{
+	check(Receiving);
+	check(PeekedRecordSize == 0);
+
+	if (Corrupt)
+	{
+		return nullptr;
+	}
+
+	while (ReadPosition != (uint32)Header->Head)
+	{
+		const uint32 Offset = ReadPosition & (Capacity - 1);
+		const FRecordHeader* Record = (const FRecordHeader*)(Ring + Offset);
+		const int64 State = Record->State;
+
+		// records from earlier passes through the ring buffer only show up here if their senders were stalled
+		if ((GetRecordSize(State) <= 0) || (GetRecordPosition(State) != ReadPosition))
+		{
+			// the sender has reserved the record, but is still writing it or died while doing so
+			if (!SkipStalledRecord(State))
+			{
+				return nullptr;
+			}
+
+			continue;
+		}
+
+		const uint32 RecordSize = (uint32)GetRecordSize(State);
+
+		FPlatformMisc::MemoryBarrier();
+
+		// any process can write to the ring buffer, so don't trust its contents
+		if (!IsValidRecordSize(RecordSize, Offset))
+		{
+			SetCorrupt();
+
+			return nullptr;
+		}
+
+		if (Record->Type == EShmMailboxRecordType::Segment)
+		{
+			FMemory::Memcpy(&OutSegmentHeader, Record + 1, sizeof(FSegmentHeader));
+
+			if (OutSegmentHeader.SegmentSize <= RecordSize - sizeof(FRecordHeader) - sizeof(FSegmentHeader))
+			{
+				PeekedRecordSize = RecordSize;
+
+				return (const uint8*)(Record + 1) + sizeof(FSegmentHeader);
+			}
+		}
+
+		// skip padding and malformed records
+		ReleaseRecord(RecordSize);
+	}
+
+	return nullptr;
+}
+
+
+void FShmMessageMailbox::Release()
+{
+	check(PeekedRecordSize > 0);
+
+	ReleaseRecord(PeekedRecordSize);
+	PeekedRecordSize = 0;
+}
+
+
+/* FShmMessageMailbox implementation
+ *****************************************************************************/
+
+FString FShmMessageMailbox::GetRegionName( const FGuid& NodeId )
+{
+	return FString::Printf(TEXT("%s_%s"), SHM_MESSAGING_MAILBOX_PREFIX, *NodeId.ToString());
+}
+
+
+bool FShmMessageMailbox::IsValidRecordSize( uint32 RecordSize, uint32 Offset ) const
+{
+	return (RecordSize >= sizeof(FRecordHeader)) && (RecordSize <= Capacity - Offset) && (RecordSize % SHM_MESSAGING_RECORD_ALIGNMENT == 0);
+}
+
+
+void FShmMessageMailbox::ReleaseRecord( uint32 RecordSize )
+{
+	// senders rely on uncommitted records being zero, and skipped ranges may wrap around
+	const uint32 Offset = ReadPosition & (Capacity - 1);
+	const uint32 FirstSize = FMath::Min(RecordSize, Capacity - Offset);
+
+	FMemory::Memzero(Ring + Offset, FirstSize);
+	FMemory::Memzero(Ring, RecordSize - FirstSize);
+	FPlatformMisc::MemoryBarrier();
+
+	ReadPosition += RecordSize;
+	FPlatformAtomics::InterlockedExchange(&Header->Tail, (int32)ReadPosition);
+}
+
+
+void FShmMessageMailbox::SetCorrupt()
+{
+	GLog->Logf(TEXT("Error: ShmMessageMailbox: Mailbox is corrupt, no further messages will be received"));
+	Corrupt = true;
+}
+
+
+bool FShmMessageMailbox::IsReleased( uint32 Position ) const
+{
+	return ((int32)((uint32)Header->Tail - Position) > 0);
+}
+
+
+uint32 FShmMessageMailbox::FindUnmarkedReservationSize() const
+{
+	// reservations are zero filled until their senders mark them, so the first
+	// record state at its own position is where the next marked record starts
+	for (uint32 Position = ReadPosition + SHM_MESSAGING_RECORD_ALIGNMENT; (int32)(StalledHead - Position) > 0; Position += SHM_MESSAGING_RECORD_ALIGNMENT)
+	{
+		const int64 State = ((const FRecordHeader*)(Ring + (Position & (Capacity - 1))))->State;
+
+		if ((State != 0) && (GetRecordPosition(State) == Position))
+		{
+			return Position - ReadPosition;
+		}
+	}
+
+	return StalledHead - ReadPosition;
+}
+
+
+bool FShmMessageMailbox::SkipStalledRecord( int64 State )
+{
+	const double CurrentTime = FPlatformTime::Seconds();
+
+	if ((StalledTime == 0.0) || (StalledPosition != ReadPosition))
+	{
+		StalledHead = (uint32)Header->Head;
+		StalledPosition = ReadPosition;
+		StalledTime = CurrentTime;
+
+		return false;
+	}
+
+	// live senders commit their records right away, so only a sender that died or hangs can take this long
+	if (CurrentTime - StalledTime < SHM_MESSAGING_NODE_TIMEOUT)
+	{
+		return false;
+	}
+
+	uint32 SkippedSize;
+
+	if ((State != 0) && (GetRecordPosition(State) == ReadPosition))
+	{
+		SkippedSize = 0u - (uint32)GetRecordSize(State);
+
+		if (!IsValidRecordSize(SkippedSize, ReadPosition & (Capacity - 1)))
+		{
+			SetCorrupt();
+
+			return false;
+		}
+	}
+	else
+	{
+		// the sender didn't get to mark its reservation, so only skip up to the next marked record
+		SkippedSize = FindUnmarkedReservationSize();
+	}
+
+	// take the reservation away from its sender, whose marking or commit fail from now on if it is merely stalled
+	FRecordHeader* Record = (FRecordHeader*)(Ring + (ReadPosition & (Capacity - 1)));
+
+	if (FPlatformAtomics::InterlockedCompareExchange(&Record->State, MakeSkippedRecordState(ReadPosition), State) != State)
+	{
+		// the sender just woke up, so give it another chance
+		StalledTime = 0.0;
+
+		return false;
+	}
+
+	StalledTime = 0.0;
+
+	GLog->Logf(TEXT("Warning: ShmMessageMailbox: Skipping %u bytes of message segments that were never committed by their sender"), SkippedSize);
+	ReleaseRecord(SkippedSize);
+
+	return true;
+}
+
+
+bool FShmMessageMailbox::WriteRecord( uint32 Position, uint32 RecordSize, EShmMailboxRecordType Type, const FSegmentHeader* SegmentHeader, const void* Data )
+{
+	FRecordHeader* Record = (FRecordHeader*)(Ring + (Position & (Capacity - 1)));
+	const int64 MarkedState = MakeRecordState(Position, -(int32)RecordSize);
+
+	// the receiver skips reservations of senders that stall for longer than the node timeout, and their
+	// memory may be in use by other records by the time the sender wakes up, so the record's position
+	// serves as its generation: senders check the tail before each write and only ever change a state
+	// that is still their own, which leaves at most one chunk of data that can be written too late
+	if (IsReleased(Position) || (FPlatformAtomics::InterlockedCompareExchange(&Record->State, MarkedState, 0) != 0))
+	{
+		return false;
+	}
+
+	Record->Type = Type;
+
+	if (SegmentHeader != nullptr)
+	{
+		uint8* Dest = (uint8*)(Record + 1);
+		FMemory::Memcpy(Dest, SegmentHeader, sizeof(FSegmentHeader));
+		Dest += sizeof(FSegmentHeader);
+
+		for (uint32 CopiedSize = 0; CopiedSize < SegmentHeader->SegmentSize; CopiedSize += SHM_MESSAGING_COPY_CHUNK_SIZE)
+		{
+			if (IsReleased(Position))
+			{
+				FPlatformAtomics::InterlockedCompareExchange(&Record->State, 0, MarkedState);
+
+				return false;
+			}
+
+			FMemory::Memcpy(Dest + CopiedSize, (const uint8*)Data + CopiedSize, FMath::Min<uint32>(SHM_MESSAGING_COPY_CHUNK_SIZE, SegmentHeader->SegmentSize - CopiedSize));
+		}
+	}
+
+	if (FPlatformAtomics::InterlockedCompareExchange(&Record->State, MakeRecordState(Position, (int32)RecordSize), MarkedState) != MarkedState)
+	{
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,225 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+
+/** Enumerates the types of records in a mailbox's ring buffer. */
+enum class EShmMailboxRecordType : uint32;
+
+
+/**
+ * Implements the mailbox through which a shared memory node receives message segments.
+ *
+ * A mailbox is a ring buffer in a named shared memory region. It is created by the node that receives
+ * from it and opened by any number of nodes, in any process on the same machine, that send to it.
+ * Senders reserve space for a record by advancing the ring's head with a compare-and-swap, mark it
+ * with its position and size, copy the segment into it and then commit it by publishing its size.
+ * The receiver consumes committed records in order, clears their memory and then advances the ring's
+ * tail, so neither side ever waits for a lock.
+ *
+ * Records that stay uncommitted for longer than the node timeout belong to a sender that died or hangs,
+ * and are skipped by the receiver: only the stalled record if it was marked, or else the zero filled
+ * space up to the next marked record. A record's position serves as its generation, so a sender that
+ * wakes up after its record was skipped fails to commit it and stops writing.
+ *
+ * Records that don't fit before the end of the ring are preceded by a padding record up to the end.
+ */
+class FShmMessageMailbox
+{
+public:
+
+	/** Structure for the header of a message segment. */
+	struct FSegmentHeader
+	{
+		/** Holds the identifier of the node that sent the message. */
+		FGuid SenderNodeId;
+
+		/** Holds the identifier of the message, unique for its sender. */
+		uint32 MessageId;
+
+		/** Holds the total size of the message (in bytes). */
+		uint32 MessageSize;
+
+		/** Holds the offset of the segment's data in the message (in bytes). */
+		uint32 SegmentOffset;
+
+		/** Holds the size of the segment's data (in bytes). */
+		uint32 SegmentSize;
+	};
+
+public:
+
+	/**
+	 * Creates a mailbox for receiving.
+	 *
+	 * @param NodeId The identifier of the node that receives from the mailbox.
+	 * @param Capacity The desired size of the ring buffer (in bytes), will be rounded up to a power of two.
+	 * @return The mailbox, or nullptr if the shared memory region could not be created.
+	 */
+	static FShmMessageMailbox* Create( const FGuid& NodeId, uint32 Capacity );
+
+	/**
+	 * Opens another node's mailbox for sending.
+	 *
+	 * @param NodeId The identifier of the node that receives from the mailbox.
+	 * @return The mailbox, or nullptr if it doesn't exist or is incompatible.
+	 */
+	static FShmMessageMailbox* Open( const FGuid& NodeId );
+
+	/** Destructor. */
+	~FShmMessageMailbox();
+
+public:
+
+	/**
+	 * Gets the maximum size of segment data that can be sent to this mailbox.
+	 *
+	 * @return Maximum segment size (in bytes).
+	 */
+	uint32 GetMaxSegmentSize() const
+	{
+		return MaxSegmentSize;
+	}
+
+	/**
+	 * Tries to send a message segment.
+	 *
+	 * This method can be called from any thread in any process.
+	 *
+	 * @param SegmentHeader The segment's header.
+	 * @param Data The segment's data (SegmentHeader.SegmentSize bytes).
+	 * @return true if the segment was sent, false if the mailbox is currently full or the receiver skipped the segment.
+	 * @see GetMaxSegmentSize
+	 */
+	bool Send( const FSegmentHeader& SegmentHeader, const void* Data );
+
+	/**
+	 * Peeks at the next received message segment.
+	 *
+	 * This method must only be called by the mailbox's creator, and from one thread at a time. The
+	 * returned data remains valid until Release is called, which must happen before the next Peek.
+	 *
+	 * @param OutSegmentHeader Will hold the segment's header.
+	 * @return The segment's data, or nullptr if no segment is available.
+	 * @see Release
+	 */
+	const uint8* Peek( FSegmentHeader& OutSegmentHeader );
+
+	/**
+	 * Releases the segment returned by the last call to Peek, so its memory can be reused by senders.
+	 *
+	 * @see Peek
+	 */
+	void Release();
+
+protected:
+
+	/** Hidden constructor, use Create or Open. */
+	FShmMessageMailbox( FPlatformMemory::FSharedMemoryRegion* InRegion, bool InReceiving );
+
+	/**
+	 * Gets the name of the shared memory region that holds the specified node's mailbox.
+	 *
+	 * @param NodeId The node's identifier.
+	 * @return Region name.
+	 */
+	static FString GetRegionName( const FGuid& NodeId );
+
+	/**
+	 * Finds the size of the unmarked reservation at the read position.
+	 *
+	 * @return The size of the reservation (in bytes), which may wrap around the end of the ring buffer.
+	 */
+	uint32 FindUnmarkedReservationSize() const;
+
+	/**
+	 * Checks whether the receiver released the reservation at the specified position already.
+	 *
+	 * @param Position The reservation's position in the ring.
+	 * @return true if the reservation was released, false otherwise.
+	 */
+	bool IsReleased( uint32 Position ) const;
+
+	/**
+	 * Checks whether a record size read from the ring buffer can be trusted.
+	 *
+	 * @param RecordSize The size of the record (in bytes).
+	 * @param Offset The record's offset in the ring buffer.
+	 * @return true if the size is valid, false otherwise.
+	 */
+	bool IsValidRecordSize( uint32 RecordSize, uint32 Offset ) const;
+
+	/**
+	 * Clears consumed or skipped records and releases their memory to the senders.
+	 *
+	 * @param RecordSize The size of the records (in bytes), which may wrap around the end of the ring buffer.
+	 */
+	void ReleaseRecord( uint32 RecordSize );
+
+	/** Stops receiving from a mailbox whose contents can't be trusted anymore. */
+	void SetCorrupt();
+
+	/**
+	 * Skips the uncommitted record at the read position once it has been stalled for longer than the node timeout.
+	 *
+	 * @param State The state of the record as read from the ring buffer.
+	 * @return true if the record was skipped, false if it needs more time.
+	 */
+	bool SkipStalledRecord( int64 State );
+
+	/**
+	 * Marks, writes and commits a record in a reserved part of the ring buffer.
+	 *
+	 * @param Position The record's position in the ring.
+	 * @param RecordSize The total size of the record (in bytes).
+	 * @param Type The type of the record.
+	 * @param SegmentHeader The header of the segment to write, or nullptr for padding records.
+	 * @param Data The segment's data, or nullptr for padding records.
+	 * @return true if the record was committed, false if the receiver skipped it.
+	 */
+	bool WriteRecord( uint32 Position, uint32 RecordSize, EShmMailboxRecordType Type, const FSegmentHeader* SegmentHeader, const void* Data );
+
+private:
+
+	/** Layout of the mailbox header in shared memory. */
+	struct FHeader;
+
+	/** Layout of the header of each record in the ring buffer. */
+	struct FRecordHeader;
+
+	/** Holds the mailbox header in shared memory. */
+	FHeader* Header;
+
+	/** Holds the ring buffer in shared memory. */
+	uint8* Ring;
+
+	/** Holds the size of the ring buffer (in bytes). */
+	uint32 Capacity;
+
+	/** Holds a flag indicating whether the ring buffer has been found to be corrupt. */
+	bool Corrupt;
+
+	/** Holds the maximum size of segment data. */
+	uint32 MaxSegmentSize;
+
+	/** Holds the size of the record returned by the last call to Peek. */
+	uint32 PeekedRecordSize;
+
+	/** Holds the receiver's position in the ring buffer, which only it updates. */
+	uint32 ReadPosition;
+
+	/** Holds a flag indicating whether this is the receiving side of the mailbox. */
+	bool Receiving;
+
+	/** Holds the shared memory region. */
+	FPlatformMemory::FSharedMemoryRegion* Region;
+
+	/** Holds the ring's head at the time the receiver found the record at the read position uncommitted, up to which records may be skipped. */
+	uint32 StalledHead;
+
+	/** Holds the read position at which the receiver found an uncommitted record. */
+	uint32 StalledPosition;
+
+	/** Holds the time at which the receiver found the record at the read position uncommitted (in seconds), or zero. */
+	double StalledTime;
+};
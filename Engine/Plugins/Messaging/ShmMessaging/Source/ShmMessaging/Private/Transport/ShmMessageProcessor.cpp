@@ -0,0 +1,440 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShmMessagingPrivatePCH.h"
+
+
+/* FShmMessageProcessor static initialization
+ *****************************************************************************/
+
+const double FShmMessageProcessor::DirectoryUpdateInterval = 0.5;
+const int32 FShmMessageProcessor::IdleYieldCount = 1000;
+const float FShmMessageProcessor::IdleSleepTime = 0.001f;
+const int32 FShmMessageProcessor::MaxSegmentsPerUpdate = 1024;
+
+
+/* FShmMessageProcessor structors
+ *****************************************************************************/
+
+FShmMessageProcessor::FShmMessageProcessor( const FGuid& InNodeId, FShmMessageMailbox* InMailbox, FShmMessageDirectory* InDirectory )
+	: Directory(InDirectory)
+	, DirectoryUpdateTime(0.0)
+	, LocalNodeId(InNodeId)
+	, Mailbox(InMailbox)
+	, Stopping(false)
+	, Thread(nullptr)
+{
+	check(Directory != nullptr);
+	check(Mailbox != nullptr);
+}
+
+
+FShmMessageProcessor::~FShmMessageProcessor()
+{
+	if (Thread != nullptr)
+	{
+		Thread->Kill(true);
+		delete Thread;
+	}
+
+	// unregister before the mailbox goes away, so that nobody tries to open it
+	delete Directory;
+	delete Mailbox;
+}
+
+
+/* FShmMessageProcessor interface
+ *****************************************************************************/
+
+bool FShmMessageProcessor::SendMessage( const TArray<uint8>& Data, const TArray<FGuid>& Recipients )
+{
+	if (Data.Num() > SHM_MESSAGING_MAX_MESSAGE_SIZE)
+	{
+		return false;
+	}
+
+	TArray<TSharedPtr<FShmMessageMailbox, ESPMode::ThreadSafe>> Mailboxes;
+	TArray<FGuid> MailboxNodeIds;
+	bool Result = true;
+
+	// collect mailboxes
+	{
+		FScopeLock Lock(&KnownNodesCriticalSection);
+
+		if (Recipients.Num() == 0)
+		{
+			for (TMap<FGuid, FNodeInfo>::TIterator It(KnownNodes); It; ++It)
+			{
+				FNodeInfo& NodeInfo = It.Value();
+
+				if (!NodeInfo.Mailbox.IsValid())
+				{
+					NodeInfo.Mailbox = MakeShareable(FShmMessageMailbox::Open(It.Key()));
+				}
+
+				Mailboxes.Add(NodeInfo.Mailbox);
+				MailboxNodeIds.Add(It.Key());
+			}
+		}
+		else
+		{
+			for (int32 RecipientIndex = 0; RecipientIndex < Recipients.Num(); ++RecipientIndex)
+			{
+				FNodeInfo* NodeInfo = KnownNodes.Find(Recipients[RecipientIndex]);
+
+				if (NodeInfo == nullptr)
+				{
+					// the recipient registered after the last directory update
+					Mailboxes.Add(MakeShareable(FShmMessageMailbox::Open(Recipients[RecipientIndex])));
+				}
+				else
+				{
+					if (!NodeInfo->Mailbox.IsValid())
+					{
+						NodeInfo->Mailbox = MakeShareable(FShmMessageMailbox::Open(Recipients[RecipientIndex]));
+					}
+
+					Mailboxes.Add(NodeInfo->Mailbox);
+				}
+
+				MailboxNodeIds.Add(Recipients[RecipientIndex]);
+			}
+		}
+	}
+
+	// send message, queuing whatever doesn't fit
+	const uint32 MessageId = (uint32)NextMessageId.Increment();
+	TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> QueuedData;
+
+	FScopeLock Lock(&OutboundQueuesCriticalSection);
+
+	for (int32 MailboxIndex = 0; MailboxIndex < Mailboxes.Num(); ++MailboxIndex)
+	{
+		if (!Mailboxes[MailboxIndex].IsValid())
+		{
+			Result = false;
+
+			continue;
+		}
+
+		// messages must not overtake the ones that are already waiting for the same recipient
+		FOutboundQueue* OutboundQueue = OutboundQueues.Find(MailboxNodeIds[MailboxIndex]);
+		uint32 SentBytes = 0;
+
+		if ((OutboundQueue == nullptr) && SendMessageToMailbox(Data, MessageId, SentBytes, *Mailboxes[MailboxIndex]))
+		{
+			continue;
+		}
+
+		if (OutboundQueue == nullptr)
+		{
+			OutboundQueue = &OutboundQueues.Add(MailboxNodeIds[MailboxIndex], FOutboundQueue());
+			OutboundQueue->Mailbox = Mailboxes[MailboxIndex];
+			OutboundQueue->LastSegmentSentTime = FPlatformTime::Seconds();
+		}
+
+		if (!QueuedData.IsValid())
+		{
+			QueuedData = MakeShareable(new TArray<uint8>(Data));
+		}
+
+		OutboundQueue->Messages.Add(FOutboundMessage(QueuedData, MessageId, SentBytes));
+	}
+
+	return Result;
+}
+
+
+void FShmMessageProcessor::Start()
+{
+	check(Thread == nullptr);
+
+	Thread = FRunnableThread::Create(this, TEXT("FShmMessageProcessor"), 128 * 1024, TPri_AboveNormal, FPlatformAffinity::GetPoolThreadMask());
+}
+
+
+/* FRunnable interface
+ *****************************************************************************/
+
+bool FShmMessageProcessor::Init()
+{
+	return true;
+}
+
+
+uint32 FShmMessageProcessor::Run()
+{
+	int32 IdleCount = 0;
+
+	while (!Stopping)
+	{
+		// there is no cross-process event to wait for, so the mailboxes are polled,
+		// yielding while messages are likely to arrive and sleeping otherwise
+		const bool ConsumedSegments = ConsumeInboundSegments();
+		const bool SentSegments = SendOutboundMessages();
+
+		if (ConsumedSegments || SentSegments)
+		{
+			IdleCount = 0;
+		}
+		else if (++IdleCount < IdleYieldCount)
+		{
+			FPlatformProcess::Sleep(0.0f);
+		}
+		else
+		{
+			FPlatformProcess::Sleep(IdleSleepTime);
+		}
+
+		if (FPlatformTime::Seconds() >= DirectoryUpdateTime)
+		{
+			UpdateDirectory();
+		}
+	}
+
+	return 0;
+}
+
+
+void FShmMessageProcessor::Stop()
+{
+	Stopping = true;
+}
+
+
+/* FShmMessageProcessor implementation
+ *****************************************************************************/
+
+bool FShmMessageProcessor::ConsumeInboundSegments()
+{
+	FShmMessageMailbox::FSegmentHeader SegmentHeader;
+	int32 NumSegments = 0;
+
+	while (NumSegments < MaxSegmentsPerUpdate)
+	{
+		const uint8* SegmentData = Mailbox->Peek(SegmentHeader);
+
+		if (SegmentData == nullptr)
+		{
+			break;
+		}
+
+		++NumSegments;
+
+		// any process can write to the mailbox, so don't trust the header
+		if ((SegmentHeader.MessageSize > SHM_MESSAGING_MAX_MESSAGE_SIZE) || (SegmentHeader.SegmentOffset > SegmentHeader.MessageSize) || (SegmentHeader.SegmentSize > SegmentHeader.MessageSize - SegmentHeader.SegmentOffset))
+		{
+			Mailbox->Release();
+
+			continue;
+		}
+
+		// most messages fit into a single segment
+		if (SegmentHeader.SegmentSize == SegmentHeader.MessageSize)
+		{
+			TArray<uint8> Data;
+			Data.AddUninitialized(SegmentHeader.SegmentSize);
+			FMemory::Memcpy(Data.GetData(), SegmentData, SegmentHeader.SegmentSize);
+			Mailbox->Release();
+
+			MessageReassembledDelegate.ExecuteIfBound(Data, SegmentHeader.SenderNodeId);
+
+			continue;
+		}
+
+		// reassemble segmented messages
+		const FReassembledMessageKey Key(SegmentHeader.SenderNodeId, SegmentHeader.MessageId);
+		FReassembledMessage& ReassembledMessage = ReassembledMessages.FindOrAdd(Key);
+
+		if (ReassembledMessage.Data.Num() == 0)
+		{
+			ReassembledMessage.Data.AddUninitialized(SegmentHeader.MessageSize);
+		}
+		else if ((uint32)ReassembledMessage.Data.Num() != SegmentHeader.MessageSize)
+		{
+			ReassembledMessages.Remove(Key);
+			Mailbox->Release();
+
+			continue;
+		}
+
+		FMemory::Memcpy(ReassembledMessage.Data.GetData() + SegmentHeader.SegmentOffset, SegmentData, SegmentHeader.SegmentSize);
+		Mailbox->Release();
+
+		ReassembledMessage.LastSegmentReceivedTime = FPlatformTime::Seconds();
+		ReassembledMessage.ReceivedBytes += SegmentHeader.SegmentSize;
+
+		if (ReassembledMessage.ReceivedBytes >= SegmentHeader.MessageSize)
+		{
+			TArray<uint8> Data = MoveTemp(ReassembledMessage.Data);
+			ReassembledMessages.Remove(Key);
+
+			MessageReassembledDelegate.ExecuteIfBound(Data, SegmentHeader.SenderNodeId);
+		}
+	}
+
+	return (NumSegments > 0);
+}
+
+
+bool FShmMessageProcessor::SendMessageToMailbox( const TArray<uint8>& Data, uint32 MessageId, uint32& InOutSentBytes, FShmMessageMailbox& RecipientMailbox )
+{
+	FShmMessageMailbox::FSegmentHeader SegmentHeader;
+
+	SegmentHeader.SenderNodeId = LocalNodeId;
+	SegmentHeader.MessageId = MessageId;
+	SegmentHeader.MessageSize = Data.Num();
+	SegmentHeader.SegmentOffset = InOutSentBytes;
+
+	const uint32 MaxSegmentSize = RecipientMailbox.GetMaxSegmentSize();
+
+	// empty messages are sent as a single empty segment
+	do
+	{
+		SegmentHeader.SegmentSize = FMath::Min(SegmentHeader.MessageSize - SegmentHeader.SegmentOffset, MaxSegmentSize);
+
+		if (!RecipientMailbox.Send(SegmentHeader, Data.GetData() + SegmentHeader.SegmentOffset))
+		{
+			return false;
+		}
+
+		SegmentHeader.SegmentOffset += SegmentHeader.SegmentSize;
+		InOutSentBytes = SegmentHeader.SegmentOffset;
+	}
+	while (SegmentHeader.SegmentOffset < SegmentHeader.MessageSize);
+
+	return true;
+}
+
+
+bool FShmMessageProcessor::SendOutboundMessages()
+{
+	FScopeLock Lock(&OutboundQueuesCriticalSection);
+
+	if (OutboundQueues.Num() == 0)
+	{
+		return false;
+	}
+
+	const double CurrentTime = FPlatformTime::Seconds();
+	bool SentSegments = false;
+
+	for (TMap<FGuid, FOutboundQueue>::TIterator It(OutboundQueues); It; ++It)
+	{
+		FOutboundQueue& OutboundQueue = It.Value();
+
+		while (OutboundQueue.Messages.Num() > 0)
+		{
+			FOutboundMessage& OutboundMessage = OutboundQueue.Messages[0];
+			const uint32 SentBytes = OutboundMessage.SentBytes;
+			const bool SentMessage = SendMessageToMailbox(*OutboundMessage.Data, OutboundMessage.MessageId, OutboundMessage.SentBytes, *OutboundQueue.Mailbox);
+
+			if (SentMessage || (OutboundMessage.SentBytes != SentBytes))
+			{
+				OutboundQueue.LastSegmentSentTime = CurrentTime;
+				SentSegments = true;
+			}
+
+			if (!SentMessage)
+			{
+				break;
+			}
+
+			OutboundQueue.Messages.RemoveAt(0);
+		}
+
+		if (OutboundQueue.Messages.Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+		else if (CurrentTime - OutboundQueue.LastSegmentSentTime > SHM_MESSAGING_SEND_TIMEOUT)
+		{
+			GLog->Logf(TEXT("Warning: ShmMessageProcessor: Dropped %i messages to node %s, its mailbox has been full for too long"), OutboundQueue.Messages.Num(), *It.Key().ToString());
+			It.RemoveCurrent();
+		}
+	}
+
+	return SentSegments;
+}
+
+
+void FShmMessageProcessor::UpdateDirectory()
+{
+	const double CurrentTime = FPlatformTime::Seconds();
+
+	DirectoryUpdateTime = CurrentTime + DirectoryUpdateInterval;
+
+	// switch to the current directory if ours was destroyed by the process that created it
+	if (!Directory->IsCurrent())
+	{
+		FShmMessageDirectory* CurrentDirectory = FShmMessageDirectory::Open();
+
+		if (CurrentDirectory != nullptr)
+		{
+			delete Directory;
+			Directory = CurrentDirectory;
+		}
+	}
+
+	if (!Directory->UpdateHeartbeat())
+	{
+		Directory->Register(LocalNodeId);
+	}
+
+	// update known nodes
+	TArray<FGuid> NodeIds;
+	TArray<FGuid> DiscoveredNodeIds;
+	TArray<FGuid> LostNodeIds;
+
+	Directory->GetNodes(NodeIds);
+
+	{
+		FScopeLock Lock(&KnownNodesCriticalSection);
+
+		for (TMap<FGuid, FNodeInfo>::TIterator It(KnownNodes); It; ++It)
+		{
+			if (!NodeIds.Contains(It.Key()))
+			{
+				LostNodeIds.Add(It.Key());
+				It.RemoveCurrent();
+			}
+		}
+
+		for (int32 NodeIndex = 0; NodeIndex < NodeIds.Num(); ++NodeIndex)
+		{
+			if (!KnownNodes.Contains(NodeIds[NodeIndex]))
+			{
+				KnownNodes.Add(NodeIds[NodeIndex], FNodeInfo());
+				DiscoveredNodeIds.Add(NodeIds[NodeIndex]);
+			}
+		}
+	}
+
+	if (LostNodeIds.Num() > 0)
+	{
+		FScopeLock Lock(&OutboundQueuesCriticalSection);
+
+		for (int32 NodeIndex = 0; NodeIndex < LostNodeIds.Num(); ++NodeIndex)
+		{
+			OutboundQueues.Remove(LostNodeIds[NodeIndex]);
+		}
+	}
+
+	for (int32 NodeIndex = 0; NodeIndex < LostNodeIds.Num(); ++NodeIndex)
+	{
+		NodeLostDelegate.ExecuteIfBound(LostNodeIds[NodeIndex]);
+	}
+
+	for (int32 NodeIndex = 0; NodeIndex < DiscoveredNodeIds.Num(); ++NodeIndex)
+	{
+		NodeDiscoveredDelegate.ExecuteIfBound(DiscoveredNodeIds[NodeIndex]);
+	}
+
+	// discard incomplete messages from lost nodes
+	for (TMap<FReassembledMessageKey, FReassembledMessage>::TIterator It(ReassembledMessages); It; ++It)
+	{
+		if ((CurrentTime - It.Value().LastSegmentReceivedTime > SHM_MESSAGING_NODE_TIMEOUT) || LostNodeIds.Contains(It.Key().SenderNodeId))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
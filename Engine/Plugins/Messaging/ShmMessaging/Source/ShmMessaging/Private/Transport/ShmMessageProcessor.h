@@ -0,0 +1,292 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+
+/**
+ * Implements a message processor for shared memory messages.
+ *
+ * The processor's thread receives message segments from the local node's mailbox, reassembles them
+ * and keeps track of the other nodes in the directory. Messages are sent on the caller's thread
+ * straight into the recipients' mailboxes, and whatever doesn't fit is queued and sent by the
+ * processor's thread once the recipients have made room.
+ */
+class FShmMessageProcessor
+	: public FRunnable
+{
+	// Structure for known remote nodes.
+	struct FNodeInfo
+	{
+		// Holds the node's mailbox, opened when the first message is sent to it.
+		TSharedPtr<FShmMessageMailbox, ESPMode::ThreadSafe> Mailbox;
+	};
+
+
+	// Structure for messages waiting for room in a recipient's mailbox.
+	struct FOutboundMessage
+	{
+		// Holds the message data, shared by all recipients.
+		TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> Data;
+
+		// Holds the message identifier.
+		uint32 MessageId;
+
+		// Holds the number of bytes sent so far.
+		uint32 SentBytes;
+
+		// Creates and initializes a new instance.
+		FOutboundMessage( const TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>& InData, uint32 InMessageId, uint32 InSentBytes )
+			: Data(InData)
+			, MessageId(InMessageId)
+			, SentBytes(InSentBytes)
+		{ }
+	};
+
+
+	// Structure for the messages waiting for a single recipient.
+	struct FOutboundQueue
+	{
+		// Holds the recipient's mailbox.
+		TSharedPtr<FShmMessageMailbox, ESPMode::ThreadSafe> Mailbox;
+
+		// Holds the messages in the order they were sent.
+		TArray<FOutboundMessage> Messages;
+
+		// Holds the time at which the last segment was sent to the recipient (in seconds).
+		double LastSegmentSentTime;
+
+		// Default constructor.
+		FOutboundQueue()
+			: LastSegmentSentTime(0.0)
+		{ }
+	};
+
+
+	// Structure for messages being reassembled.
+	struct FReassembledMessage
+	{
+		// Holds the message data.
+		TArray<uint8> Data;
+
+		// Holds the time at which the last segment was received (in seconds).
+		double LastSegmentReceivedTime;
+
+		// Holds the number of bytes received so far.
+		uint32 ReceivedBytes;
+
+		// Default constructor.
+		FReassembledMessage()
+			: LastSegmentReceivedTime(0.0)
+			, ReceivedBytes(0)
+		{ }
+	};
+
+
+	// Structure for keys of messages being reassembled.
+	struct FReassembledMessageKey
+	{
+		// Holds the identifier of the node that sent the message.
+		FGuid SenderNodeId;
+
+		// Holds the sender's identifier of the message.
+		uint32 MessageId;
+
+		// Creates and initializes a new instance.
+		FReassembledMessageKey( const FGuid& InSenderNodeId, uint32 InMessageId )
+			: SenderNodeId(InSenderNodeId)
+			, MessageId(InMessageId)
+		{ }
+
+		// Compares two keys for equality.
+		bool operator==( const FReassembledMessageKey& Other ) const
+		{
+			return (MessageId == Other.MessageId) && (SenderNodeId == Other.SenderNodeId);
+		}
+
+		// Gets the hash for the specified key.
+		friend uint32 GetTypeHash( const FReassembledMessageKey& Key )
+		{
+			return HashCombine(GetTypeHash(Key.SenderNodeId), Key.MessageId);
+		}
+	};
+
+public:
+
+	/**
+	 * Creates and initializes a new message processor.
+	 *
+	 * The processor takes ownership of the mailbox and the directory. Its thread starts
+	 * when Start is called, so that no events are missed while delegates are being bound.
+	 *
+	 * @param InNodeId The local node identifier.
+	 * @param InMailbox The local node's mailbox.
+	 * @param InDirectory The node directory.
+	 */
+	FShmMessageProcessor( const FGuid& InNodeId, FShmMessageMailbox* InMailbox, FShmMessageDirectory* InDirectory );
+
+	/** Destructor. */
+	~FShmMessageProcessor();
+
+public:
+
+	/**
+	 * Gets the local node identifier.
+	 *
+	 * @return Node identifier.
+	 */
+	const FGuid& GetNodeId() const
+	{
+		return LocalNodeId;
+	}
+
+	/**
+	 * Sends a serialized message to the specified nodes.
+	 *
+	 * This method can be called from any thread and never blocks. Large messages are sent in segments, and
+	 * segments that don't fit into a recipient's mailbox right away are queued and sent by the processor's
+	 * thread. Queued messages are dropped if the recipient doesn't make room for SHM_MESSAGING_SEND_TIMEOUT.
+	 *
+	 * @param Data The serialized message.
+	 * @param Recipients The recipients' node identifiers, or an empty array to send to all known nodes.
+	 * @return true if the message was sent or queued for all recipients, false otherwise.
+	 */
+	bool SendMessage( const TArray<uint8>& Data, const TArray<FGuid>& Recipients );
+
+	/** Starts the processor's thread. */
+	void Start();
+
+public:
+
+	/**
+	 * Returns a delegate that is executed when a message has been received.
+	 *
+	 * @return The delegate.
+	 */
+	DECLARE_DELEGATE_TwoParams(FOnMessageReassembled, const TArray<uint8>& /*Data*/, const FGuid& /*NodeId*/)
+	FOnMessageReassembled& OnMessageReassembled()
+	{
+		return MessageReassembledDelegate;
+	}
+
+	/**
+	 * Returns a delegate that is executed when a node has been discovered.
+	 *
+	 * @return The delegate.
+	 */
+	IMessageTransport::FOnNodeDiscovered& OnNodeDiscovered()
+	{
+		return NodeDiscoveredDelegate;
+	}
+
+	/**
+	 * Returns a delegate that is executed when a node has unregistered or timed out.
+	 *
+	 * @return The delegate.
+	 */
+	IMessageTransport::FOnNodeLost& OnNodeLost()
+	{
+		return NodeLostDelegate;
+	}
+
+public:
+
+	// FRunnable interface
+
+	virtual bool Init() override;
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	virtual void Exit() override { }
+
+protected:
+
+	/**
+	 * Consumes the segments in the local node's mailbox.
+	 *
+	 * @return true if any segments were consumed, false if the mailbox was empty.
+	 */
+	bool ConsumeInboundSegments();
+
+	/**
+	 * Sends the queued segments that fit into the recipients' mailboxes.
+	 *
+	 * @return true if any segments were sent, false otherwise.
+	 */
+	bool SendOutboundMessages();
+
+	/**
+	 * Sends as many segments of a serialized message to a single node as fit into its mailbox.
+	 *
+	 * @param Data The serialized message.
+	 * @param MessageId The message identifier.
+	 * @param InOutSentBytes The number of bytes sent so far, will be updated with the segments that were sent.
+	 * @param Mailbox The recipient's mailbox.
+	 * @return true if the whole message was sent, false if the mailbox is full.
+	 */
+	bool SendMessageToMailbox( const TArray<uint8>& Data, uint32 MessageId, uint32& InOutSentBytes, FShmMessageMailbox& Mailbox );
+
+	/** Updates the local node's registration and the list of known nodes. */
+	void UpdateDirectory();
+
+private:
+
+	/** Holds the node directory. */
+	FShmMessageDirectory* Directory;
+
+	/** Holds the time at which the directory needs to be updated next. */
+	double DirectoryUpdateTime;
+
+	/** Holds the local node identifier. */
+	FGuid LocalNodeId;
+
+	/** Holds the local node's mailbox. */
+	FShmMessageMailbox* Mailbox;
+
+	/** Holds the identifier of the next message to be sent. */
+	FThreadSafeCounter NextMessageId;
+
+	/** Holds the messages waiting for room in their recipients' mailboxes. */
+	TMap<FGuid, FOutboundQueue> OutboundQueues;
+
+	/** Holds a critical section for the outbound queues, which is also held while sending to keep messages in order. */
+	FCriticalSection OutboundQueuesCriticalSection;
+
+	/** Holds the collection of known nodes. */
+	TMap<FGuid, FNodeInfo> KnownNodes;
+
+	/** Holds a critical section for the collection of known nodes. */
+	FCriticalSection KnownNodesCriticalSection;
+
+	/** Holds the messages being reassembled. */
+	TMap<FReassembledMessageKey, FReassembledMessage> ReassembledMessages;
+
+	/** Holds a flag indicating that the thread is stopping. */
+	bool Stopping;
+
+	/** Holds the thread object. */
+	FRunnableThread* Thread;
+
+private:
+
+	/** Defines the interval at which the directory is updated (in seconds). */
+	static const double DirectoryUpdateInterval;
+
+	/** Defines how often the thread yields while the mailbox is empty, before it starts to sleep. */
+	static const int32 IdleYieldCount;
+
+	/** Defines how long the thread sleeps while the mailbox is empty (in seconds). */
+	static const float IdleSleepTime;
+
+	/** Defines the maximum number of segments that are consumed between directory updates. */
+	static const int32 MaxSegmentsPerUpdate;
+
+private:
+
+	/** Holds a delegate to be invoked when a message was received. */
+	FOnMessageReassembled MessageReassembledDelegate;
+
+	/** Holds a delegate to be invoked when a node was discovered. */
+	IMessageTransport::FOnNodeDiscovered NodeDiscoveredDelegate;
+
+	/** Holds a delegate to be invoked when a node was lost. */
+	IMessageTransport::FOnNodeLost NodeLostDelegate;
+};
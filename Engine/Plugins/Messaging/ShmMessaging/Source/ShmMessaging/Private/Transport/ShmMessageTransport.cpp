@@ -1,12 +1,15 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "ShmMessagingPrivatePCH.h"
+#include "BinaryStructSerializerBackend.h"
+#include "StructSerializer.h"
 
 
 /* FShmMessageTransport structors
  *****************************************************************************/
 
 FShmMessageTransport::FShmMessageTransport()
+	: MessageProcessor(nullptr)
 { }
 
 
@@ -21,16 +24,126 @@ FShmMessageTransport::~FShmMessageTransport()
 
 bool FShmMessageTransport::StartTransport()
 {
-	return false;
+	StopTransport();
+
+	const FGuid NodeId = FGuid::NewGuid();
+	const UShmMessagingSettings& Settings = *GetDefault<UShmMessagingSettings>();
+
+	// create the mailbox before registering, so that it exists when other nodes discover this one
+	FShmMessageMailbox* Mailbox = FShmMessageMailbox::Create(NodeId, (uint32)FMath::Clamp(Settings.MailboxSize, 1, 256) * 1024 * 1024);
+
+	if (Mailbox == nullptr)
+	{
+		GLog->Logf(TEXT("ShmMessageTransport.StartTransport: Failed to create mailbox"));
+
+		return false;
+	}
+
+	FShmMessageDirectory* Directory = FShmMessageDirectory::Open();
+
+	if ((Directory == nullptr) || !Directory->Register(NodeId))
+	{
+		GLog->Logf(TEXT("ShmMessageTransport.StartTransport: Failed to register in node directory"));
+
+		delete Directory;
+		delete Mailbox;
+
+		return false;
+	}
+
+	MessageProcessor = new FShmMessageProcessor(NodeId, Mailbox, Directory);
+	MessageProcessor->OnMessageReassembled().BindRaw(this, &FShmMessageTransport::HandleProcessorMessageReassembled);
+	MessageProcessor->OnNodeDiscovered().BindRaw(this, &FShmMessageTransport::HandleProcessorNodeDiscovered);
+	MessageProcessor->OnNodeLost().BindRaw(this, &FShmMessageTransport::HandleProcessorNodeLost);
+	MessageProcessor->Start();
+
+	return true;
 }
 
 
 void FShmMessageTransport::StopTransport()
 {
+	delete MessageProcessor;
+	MessageProcessor = nullptr;
 }
 
 
 bool FShmMessageTransport::TransportMessage(const IMessageContextRef& Context, const TArray<FGuid>& Recipients)
 {
-	return false;
+	if ((MessageProcessor == nullptr) || !Context->IsValid())
+	{
+		return false;
+	}
+
+	if (Context->GetRecipients().Num() > SHM_MESSAGING_MAX_RECIPIENTS)
+	{
+		return false;
+	}
+
+	// messages are copied into the recipients' mailboxes right away, so there is no need to serialize them asynchronously
+	TArray<uint8> Data;
+	SerializeMessage(Context, Data);
+
+	return MessageProcessor->SendMessage(Data, Recipients);
+}
+
+
+/* FShmMessageTransport implementation
+ *****************************************************************************/
+
+void FShmMessageTransport::SerializeMessage( const IMessageContextRef& Context, TArray<uint8>& OutData )
+{
+	// Note that some complex values are serialized manually here, so that we can ensure
+	// a consistent wire format, if their implementations change. This allows us to sanity
+	// check the values during deserialization. @see FShmDeserializedMessage::Deserialize()
+
+	FMemoryWriter Archive(OutData);
+
+	// serialize context
+	{
+		const FName& MessageType = Context->GetMessageType();
+		Archive << const_cast<FName&>(MessageType);
+
+		const FMessageAddress& Sender = Context->GetSender();
+		Archive << const_cast<FMessageAddress&>(Sender);
+
+		const TArray<FMessageAddress>& Recipients = Context->GetRecipients();
+		Archive << const_cast<TArray<FMessageAddress>&>(Recipients);
+
+		TEnumAsByte<EMessageScope> Scope = Context->GetScope();
+		Archive << Scope;
+
+		const FDateTime& TimeSent = Context->GetTimeSent();
+		Archive << const_cast<FDateTime&>(TimeSent);
+
+		const FDateTime& Expiration = Context->GetExpiration();
+		Archive << const_cast<FDateTime&>(Expiration);
+
+		int32 NumAnnotations = Context->GetAnnotations().Num();
+		Archive << NumAnnotations;
+
+		for (TMap<FName, FString>::TConstIterator It(Context->GetAnnotations()); It; ++It)
+		{
+			Archive << const_cast<FName&>(It->Key);
+			Archive << const_cast<FString&>(It->Value);
+		}
+	}
+
+	// serialize message body
+	FBinaryStructSerializerBackend Backend(Archive);
+	FStructSerializer::Serialize(Context->GetMessage(), *Context->GetMessageTypeInfo(), Backend);
+}
+
+
+/* FShmMessageTransport event handlers
+ *****************************************************************************/
+
+void FShmMessageTransport::HandleProcessorMessageReassembled( const TArray<uint8>& Data, const FGuid& NodeId )
+{
+	FShmDeserializedMessageRef DeserializedMessage = MakeShareable(new FShmDeserializedMessage());
+
+	if (DeserializedMessage->Deserialize(Data))
+	{
+		MessageReceivedDelegate.ExecuteIfBound(DeserializedMessage, NodeId);
+	}
 }
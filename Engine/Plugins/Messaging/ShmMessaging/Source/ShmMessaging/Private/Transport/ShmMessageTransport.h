@@ -5,6 +5,10 @@
 
 /**
  * Implements a message transport technology using shared memory.
+ *
+ * Each transport is a node with its own mailbox that other nodes on the same machine, in the same
+ * or in other processes, write messages into directly. Nodes find each other through a directory
+ * in shared memory, see FShmMessageDirectory and FShmMessageMailbox for details.
  */
 class FShmMessageTransport
 	: public IMessageTransport
@@ -47,6 +51,39 @@ public:
 	virtual void StopTransport() override;
 	virtual bool TransportMessage(const IMessageContextRef& Context, const TArray<FGuid>& Recipients) override;
 
+protected:
+
+	/**
+	 * Serializes a message.
+	 *
+	 * @param Context The context of the message to serialize.
+	 * @param OutData Will hold the serialized message.
+	 * @see FShmDeserializedMessage::Deserialize
+	 */
+	void SerializeMessage( const IMessageContextRef& Context, TArray<uint8>& OutData );
+
+private:
+
+	/** Callback for messages received by the message processor. */
+	void HandleProcessorMessageReassembled( const TArray<uint8>& Data, const FGuid& NodeId );
+
+	/** Callback for nodes discovered by the message processor. */
+	void HandleProcessorNodeDiscovered( const FGuid& NodeId )
+	{
+		NodeDiscoveredDelegate.ExecuteIfBound(NodeId);
+	}
+
+	/** Callback for nodes lost by the message processor. */
+	void HandleProcessorNodeLost( const FGuid& NodeId )
+	{
+		NodeLostDelegate.ExecuteIfBound(NodeId);
+	}
+
+private:
+
+	/** Holds the message processor, if the transport is running. */
+	FShmMessageProcessor* MessageProcessor;
+
 private:
 
 	/** Holds a delegate to be invoked when a message was received on the transport channel. */
@@ -0,0 +1,190 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShmMessagingPrivatePCH.h"
+#include "AutomationTest.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShmMessageMailboxTest, "Core.Messaging.Transports.Shm.ShmMessageMailbox", EAutomationTestFlags::ATF_Editor)
+
+
+namespace ShmMessageMailboxTest
+{
+	const int32 NumSenders = 4;
+	const uint32 NumSegmentsPerSender = 5000;
+
+	/** Gets the size of a test segment, which varies so that records end up everywhere in the ring buffer. */
+	uint32 GetSegmentSize( uint32 MessageId, uint32 MaxSegmentSize )
+	{
+		return (MessageId * 7919) % (MaxSegmentSize + 1);
+	}
+
+	/** Gets the value of a byte in a test segment. */
+	uint8 GetSegmentByte( uint32 MessageId, uint32 Offset )
+	{
+		return (uint8)(MessageId * 31 + Offset);
+	}
+
+
+	/** Sends numbered segments to a mailbox from its own thread. */
+	class FSender
+		: public FRunnable
+	{
+	public:
+
+		FSender( const FGuid& InMailboxNodeId, int32 InSenderIndex )
+			: Failed(false)
+			, MailboxNodeId(InMailboxNodeId)
+			, SenderIndex(InSenderIndex)
+		{ }
+
+		virtual uint32 Run() override
+		{
+			FShmMessageMailbox* Mailbox = FShmMessageMailbox::Open(MailboxNodeId);
+
+			if (Mailbox == nullptr)
+			{
+				Failed = true;
+
+				return 0;
+			}
+
+			FShmMessageMailbox::FSegmentHeader Header;
+			Header.SenderNodeId = FGuid(SenderIndex, 0, 0, 0);
+			Header.SegmentOffset = 0;
+
+			TArray<uint8> Data;
+
+			for (uint32 MessageId = 0; (MessageId < NumSegmentsPerSender) && !Failed; ++MessageId)
+			{
+				Header.MessageId = MessageId;
+				Header.MessageSize = GetSegmentSize(MessageId, Mailbox->GetMaxSegmentSize());
+				Header.SegmentSize = Header.MessageSize;
+
+				Data.Reset();
+				Data.AddUninitialized(Header.SegmentSize);
+
+				for (uint32 Offset = 0; Offset < Header.SegmentSize; ++Offset)
+				{
+					Data[Offset] = GetSegmentByte(MessageId, Offset);
+				}
+
+				const double TimeoutTime = FPlatformTime::Seconds() + 10.0;
+
+				while (!Mailbox->Send(Header, Data.GetData()))
+				{
+					if (FPlatformTime::Seconds() > TimeoutTime)
+					{
+						Failed = true;
+
+						break;
+					}
+
+					FPlatformProcess::Sleep(0.0f);
+				}
+			}
+
+			delete Mailbox;
+
+			return 0;
+		}
+
+		bool Failed;
+
+	private:
+
+		FGuid MailboxNodeId;
+		int32 SenderIndex;
+	};
+}
+
+
+bool FShmMessageMailboxTest::RunTest( const FString& Parameters )
+{
+	using namespace ShmMessageMailboxTest;
+
+	// a small mailbox, so that the ring buffer wraps around and fills up frequently
+	const FGuid NodeId = FGuid::NewGuid();
+	FShmMessageMailbox* Mailbox = FShmMessageMailbox::Create(NodeId, 64 * 1024);
+
+	if (Mailbox == nullptr)
+	{
+		AddError(TEXT("Failed to create mailbox"));
+
+		return false;
+	}
+
+	// start senders
+	FSender* Senders[NumSenders];
+	FRunnableThread* SenderThreads[NumSenders];
+
+	for (int32 SenderIndex = 0; SenderIndex < NumSenders; ++SenderIndex)
+	{
+		Senders[SenderIndex] = new FSender(NodeId, SenderIndex);
+		SenderThreads[SenderIndex] = FRunnableThread::Create(Senders[SenderIndex], *FString::Printf(TEXT("FShmMessageMailboxTest.Sender%i"), SenderIndex));
+	}
+
+	// receive segments
+	uint32 NextMessageIds[NumSenders] = { 0 };
+	uint32 NumReceived = 0;
+	uint32 NumOutOfOrder = 0;
+	uint32 NumCorrupt = 0;
+
+	const double TimeoutTime = FPlatformTime::Seconds() + 30.0;
+
+	while ((NumReceived < NumSenders * NumSegmentsPerSender) && (FPlatformTime::Seconds() < TimeoutTime))
+	{
+		FShmMessageMailbox::FSegmentHeader Header;
+		const uint8* Data = Mailbox->Peek(Header);
+
+		if (Data == nullptr)
+		{
+			FPlatformProcess::Sleep(0.0f);
+
+			continue;
+		}
+
+		const uint32 SenderIndex = Header.SenderNodeId.A;
+
+		if ((SenderIndex < NumSenders) && (Header.MessageId == NextMessageIds[SenderIndex]))
+		{
+			bool Corrupt = (Header.SegmentSize != GetSegmentSize(Header.MessageId, Mailbox->GetMaxSegmentSize()));
+
+			for (uint32 Offset = 0; (Offset < Header.SegmentSize) && !Corrupt; ++Offset)
+			{
+				Corrupt = (Data[Offset] != GetSegmentByte(Header.MessageId, Offset));
+			}
+
+			if (Corrupt)
+			{
+				++NumCorrupt;
+			}
+
+			++NextMessageIds[SenderIndex];
+		}
+		else
+		{
+			++NumOutOfOrder;
+		}
+
+		Mailbox->Release();
+		++NumReceived;
+	}
+
+	// clean up
+	for (int32 SenderIndex = 0; SenderIndex < NumSenders; ++SenderIndex)
+	{
+		SenderThreads[SenderIndex]->WaitForCompletion();
+		TestFalse(TEXT("Senders must be able to open the mailbox and send all segments"), Senders[SenderIndex]->Failed);
+
+		delete SenderThreads[SenderIndex];
+		delete Senders[SenderIndex];
+	}
+
+	delete Mailbox;
+
+	TestEqual(TEXT("All sent segments must be received"), NumReceived, NumSenders * NumSegmentsPerSender);
+	TestEqual(TEXT("Segments from each sender must be received in the order they were sent"), NumOutOfOrder, 0u);
+	TestEqual(TEXT("Segments must be received intact"), NumCorrupt, 0u);
+
+	return true;
+}
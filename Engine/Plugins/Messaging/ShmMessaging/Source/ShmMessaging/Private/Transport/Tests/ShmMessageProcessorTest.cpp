@@ -0,0 +1,430 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "ShmMessagingPrivatePCH.h"
+#include "AutomationTest.h"
+#include "Networking.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShmMessageProcessorTest, "Core.Messaging.Transports.Shm.ShmMessageProcessor", EAutomationTestFlags::ATF_Editor)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShmMessageProcessorBenchmark, "Core.Messaging.Transports.Shm.ShmMessageBenchmark", EAutomationTestFlags::ATF_Editor)
+
+
+namespace ShmMessageProcessorTest
+{
+	/**
+	 * A node for testing, which records the events of its message processor.
+	 *
+	 * Nodes communicate through shared memory exactly like nodes in different processes do.
+	 */
+	class FNode
+	{
+	public:
+
+		FNode()
+			: Echo(false)
+			, Processor(nullptr)
+		{ }
+
+		~FNode()
+		{
+			delete Processor;
+		}
+
+		bool Start( uint32 MailboxSize )
+		{
+			const FGuid NodeId = FGuid::NewGuid();
+			FShmMessageMailbox* Mailbox = FShmMessageMailbox::Create(NodeId, MailboxSize);
+			FShmMessageDirectory* Directory = FShmMessageDirectory::Open();
+
+			if ((Mailbox == nullptr) || (Directory == nullptr) || !Directory->Register(NodeId))
+			{
+				delete Directory;
+				delete Mailbox;
+
+				return false;
+			}
+
+			Processor = new FShmMessageProcessor(NodeId, Mailbox, Directory);
+			Processor->OnMessageReassembled().BindRaw(this, &FNode::HandleMessageReassembled);
+			Processor->OnNodeDiscovered().BindRaw(this, &FNode::HandleNodeDiscovered);
+			Processor->OnNodeLost().BindRaw(this, &FNode::HandleNodeLost);
+			Processor->Start();
+
+			return true;
+		}
+
+		bool HasDiscovered( const FGuid& NodeId )
+		{
+			FScopeLock Lock(&CriticalSection);
+			return DiscoveredNodeIds.Contains(NodeId);
+		}
+
+		bool HasLost( const FGuid& NodeId )
+		{
+			FScopeLock Lock(&CriticalSection);
+			return LostNodeIds.Contains(NodeId);
+		}
+
+		int32 GetNumReceivedMessages()
+		{
+			FScopeLock Lock(&CriticalSection);
+			return ReceivedMessages.Num();
+		}
+
+		TArray<uint8> GetReceivedMessage( int32 Index )
+		{
+			FScopeLock Lock(&CriticalSection);
+			return ReceivedMessages[Index];
+		}
+
+		/** Whether received messages are sent back to their sender, instead of being recorded. */
+		bool Echo;
+
+		/** Holds the number of received bytes. */
+		FThreadSafeCounter NumReceivedBytes;
+
+		/** Holds the number of received messages. */
+		FThreadSafeCounter NumReceivedMessages;
+
+		/** Holds the message processor. */
+		FShmMessageProcessor* Processor;
+
+	private:
+
+		void HandleMessageReassembled( const TArray<uint8>& Data, const FGuid& NodeId )
+		{
+			if (Echo)
+			{
+				TArray<FGuid> Recipients;
+				Recipients.Add(NodeId);
+
+				Processor->SendMessage(Data, Recipients);
+			}
+			else
+			{
+				FScopeLock Lock(&CriticalSection);
+				ReceivedMessages.Add(Data);
+				ReceivedMessageSenders.Add(NodeId);
+			}
+
+			NumReceivedBytes.Add(Data.Num());
+			NumReceivedMessages.Increment();
+		}
+
+		void HandleNodeDiscovered( const FGuid& NodeId )
+		{
+			FScopeLock Lock(&CriticalSection);
+			DiscoveredNodeIds.AddUnique(NodeId);
+		}
+
+		void HandleNodeLost( const FGuid& NodeId )
+		{
+			FScopeLock Lock(&CriticalSection);
+			LostNodeIds.AddUnique(NodeId);
+		}
+
+		FCriticalSection CriticalSection;
+		TArray<FGuid> DiscoveredNodeIds;
+		TArray<FGuid> LostNodeIds;
+		TArray<TArray<uint8>> ReceivedMessages;
+		TArray<FGuid> ReceivedMessageSenders;
+	};
+
+
+	/** Waits until the given predicate is true, or the timeout expires. */
+	template<typename PredicateType>
+	bool WaitFor( PredicateType Predicate, double Timeout )
+	{
+		const double TimeoutTime = FPlatformTime::Seconds() + Timeout;
+
+		while (!Predicate())
+		{
+			if (FPlatformTime::Seconds() > TimeoutTime)
+			{
+				return false;
+			}
+
+			FPlatformProcess::Sleep(0.0f);
+		}
+
+		return true;
+	}
+
+
+	/** Creates a test message that can be verified by IsTestMessage. */
+	TArray<uint8> MakeTestMessage( int32 Size, uint8 Seed )
+	{
+		TArray<uint8> Message;
+		Message.AddUninitialized(Size);
+
+		for (int32 Index = 0; Index < Size; ++Index)
+		{
+			Message[Index] = (uint8)(Index * 13 + Seed);
+		}
+
+		return Message;
+	}
+
+
+	/** Checks whether a received message is intact. */
+	bool IsTestMessage( const TArray<uint8>& Message, int32 Size, uint8 Seed )
+	{
+		return (Message.Num() == Size) && (Message == MakeTestMessage(Size, Seed));
+	}
+}
+
+
+bool FShmMessageProcessorTest::RunTest( const FString& Parameters )
+{
+	using namespace ShmMessageProcessorTest;
+
+	FNode* Node1 = new FNode();
+	FNode* Node2 = new FNode();
+
+	if (!Node1->Start(1024 * 1024) || !Node2->Start(1024 * 1024))
+	{
+		AddError(TEXT("Failed to start nodes"));
+
+		delete Node1;
+		delete Node2;
+
+		return false;
+	}
+
+	const FGuid NodeId1 = Node1->Processor->GetNodeId();
+	const FGuid NodeId2 = Node2->Processor->GetNodeId();
+
+	// discovery
+	TestTrue(TEXT("Nodes must discover each other"), WaitFor([&]() { return Node1->HasDiscovered(NodeId2) && Node2->HasDiscovered(NodeId1); }, 5.0));
+
+	// sending & publishing
+	{
+		const int32 LargeMessageSize = 3 * 1024 * 1024 + 17;
+		TArray<FGuid> Recipients;
+
+		Recipients.Add(NodeId2);
+		TestTrue(TEXT("A message larger than the recipient's mailbox must be sent in segments"), Node1->Processor->SendMessage(MakeTestMessage(LargeMessageSize, 1), Recipients));
+		TestTrue(TEXT("An empty message must be sent"), Node1->Processor->SendMessage(TArray<uint8>(), Recipients));
+
+		Recipients.Reset();
+		TestTrue(TEXT("A message must be published to all other nodes"), Node2->Processor->SendMessage(MakeTestMessage(100, 2), Recipients));
+
+		TestTrue(TEXT("Sent messages must be received"), WaitFor([&]() { return (Node2->GetNumReceivedMessages() >= 2) && (Node1->GetNumReceivedMessages() >= 1); }, 5.0));
+
+		if (Node2->GetNumReceivedMessages() == 2)
+		{
+			TestTrue(TEXT("Segmented messages must be reassembled intact"), IsTestMessage(Node2->GetReceivedMessage(0), LargeMessageSize, 1));
+			TestEqual(TEXT("Empty messages must be received empty"), Node2->GetReceivedMessage(1).Num(), 0);
+		}
+
+		if (Node1->GetNumReceivedMessages() == 1)
+		{
+			TestTrue(TEXT("Published messages must be received intact"), IsTestMessage(Node1->GetReceivedMessage(0), 100, 2));
+		}
+
+		TestEqual(TEXT("Published messages must not be received by their sender"), Node2->GetNumReceivedMessages(), 2);
+	}
+
+	// node loss
+	delete Node1;
+
+	TestTrue(TEXT("Stopped nodes must be lost"), WaitFor([&]() { return Node2->HasLost(NodeId1); }, 5.0));
+
+	delete Node2;
+
+	return true;
+}
+
+
+/**
+ * Measures the latency and throughput of the shared memory transport.
+ *
+ * Raw UDP sockets on the loopback adapter serve as the baseline, because UdpMessaging adds
+ * segmentation, acknowledgments and task graph hops on top of them, so its figures are worse.
+ * Message serialization is the same for both transports and therefore not included.
+ */
+bool FShmMessageProcessorBenchmark::RunTest( const FString& Parameters )
+{
+	using namespace ShmMessageProcessorTest;
+
+	const int32 NumRoundTrips = 2000;
+	const int32 NumThroughputMessages = 256;
+	const int32 PingSize = 64;
+	const int32 ThroughputMessageSize = 1024 * 1024;
+
+	// shared memory
+	{
+		FNode* Node1 = new FNode();
+		FNode* Node2 = new FNode();
+
+		if (!Node1->Start(4 * 1024 * 1024) || !Node2->Start(4 * 1024 * 1024))
+		{
+			AddError(TEXT("Failed to start nodes"));
+
+			delete Node1;
+			delete Node2;
+
+			return false;
+		}
+
+		const FGuid NodeId2 = Node2->Processor->GetNodeId();
+
+		TArray<FGuid> Recipients;
+		Recipients.Add(NodeId2);
+
+		// latency
+		Node2->Echo = true;
+
+		const TArray<uint8> Ping = MakeTestMessage(PingSize, 0);
+		const double LatencyStartTime = FPlatformTime::Seconds();
+		int32 NumReplies = 0;
+
+		for (; NumReplies < NumRoundTrips; ++NumReplies)
+		{
+			if (!Node1->Processor->SendMessage(Ping, Recipients) || !WaitFor([&]() { return Node1->NumReceivedMessages.GetValue() > NumReplies; }, 1.0))
+			{
+				break;
+			}
+		}
+
+		const double LatencyTime = FPlatformTime::Seconds() - LatencyStartTime;
+
+		// throughput
+		Node2->Echo = false;
+
+		const TArray<uint8> Message = MakeTestMessage(ThroughputMessageSize, 0);
+		const int32 StartMessages = Node2->NumReceivedMessages.GetValue();
+		const double ThroughputStartTime = FPlatformTime::Seconds();
+
+		for (int32 MessageIndex = 0; MessageIndex < NumThroughputMessages; ++MessageIndex)
+		{
+			Node1->Processor->SendMessage(Message, Recipients);
+		}
+
+		WaitFor([&]() { return Node2->NumReceivedMessages.GetValue() - StartMessages >= NumThroughputMessages; }, 10.0);
+
+		const double ThroughputTime = FPlatformTime::Seconds() - ThroughputStartTime;
+		const int32 NumDelivered = Node2->NumReceivedMessages.GetValue() - StartMessages;
+
+		delete Node1;
+		delete Node2;
+
+		TestEqual(TEXT("All round trips must complete"), NumReplies, NumRoundTrips);
+		TestEqual(TEXT("All messages must be delivered"), NumDelivered, NumThroughputMessages);
+
+		AddLogItem(FString::Printf(TEXT("Shm: round trip %.2f us, throughput %.1f MB/s (%i x %i bytes)"),
+			1000000.0 * LatencyTime / FMath::Max(NumReplies, 1),
+			(double)NumDelivered * ThroughputMessageSize / (1024.0 * 1024.0) / ThroughputTime,
+			NumThroughputMessages, ThroughputMessageSize));
+	}
+
+	// UDP loopback baseline
+	{
+		const int32 DatagramSize = 60000;
+		ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+
+		FSocket* Socket1 = FUdpSocketBuilder(TEXT("ShmMessageBenchmark.Socket1"))
+			.BoundToEndpoint(FIPv4Endpoint(FIPv4Address(127, 0, 0, 1), 0))
+			.WithReceiveBufferSize(4 * 1024 * 1024);
+
+		FSocket* Socket2 = FUdpSocketBuilder(TEXT("ShmMessageBenchmark.Socket2"))
+			.BoundToEndpoint(FIPv4Endpoint(FIPv4Address(127, 0, 0, 1), 0))
+			.WithReceiveBufferSize(4 * 1024 * 1024);
+
+		if ((Socket1 == nullptr) || (Socket2 == nullptr))
+		{
+			AddWarning(TEXT("Failed to create UDP sockets, skipping baseline"));
+
+			if (Socket1 != nullptr)
+			{
+				SocketSubsystem->DestroySocket(Socket1);
+			}
+
+			if (Socket2 != nullptr)
+			{
+				SocketSubsystem->DestroySocket(Socket2);
+			}
+
+			return true;
+		}
+
+		const TSharedRef<FInternetAddr> Address1 = FIPv4Endpoint(FIPv4Address(127, 0, 0, 1), Socket1->GetPortNo()).ToInternetAddr();
+		const TSharedRef<FInternetAddr> Address2 = FIPv4Endpoint(FIPv4Address(127, 0, 0, 1), Socket2->GetPortNo()).ToInternetAddr();
+
+		// the second socket echoes pings and counts everything else
+		FThreadSafeCounter NumReceivedBytes;
+
+		FUdpSocketReceiver* Receiver = new FUdpSocketReceiver(Socket2, FTimespan::FromMilliseconds(100), TEXT("ShmMessageBenchmark.Receiver"));
+		Receiver->OnDataReceived().BindLambda([&]( const FArrayReaderPtr& Data, const FIPv4Endpoint& Sender ) {
+			if (Data->Num() == PingSize)
+			{
+				int32 BytesSent = 0;
+				Socket2->SendTo(Data->GetData(), Data->Num(), BytesSent, *Address1);
+			}
+			else
+			{
+				NumReceivedBytes.Add(Data->Num());
+			}
+		});
+
+		// latency
+		const TArray<uint8> Ping = MakeTestMessage(PingSize, 0);
+		TArray<uint8> Reply;
+		Reply.AddUninitialized(PingSize);
+
+		const TSharedRef<FInternetAddr> ReplyAddress = SocketSubsystem->CreateInternetAddr();
+		const double LatencyStartTime = FPlatformTime::Seconds();
+		int32 NumReplies = 0;
+
+		for (; NumReplies < NumRoundTrips; ++NumReplies)
+		{
+			int32 BytesSent = 0;
+			int32 BytesRead = 0;
+
+			if (!Socket1->SendTo(Ping.GetData(), PingSize, BytesSent, *Address2) ||
+				!Socket1->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(1.0)) ||
+				!Socket1->RecvFrom(Reply.GetData(), PingSize, BytesRead, *ReplyAddress))
+			{
+				break;
+			}
+		}
+
+		const double LatencyTime = FPlatformTime::Seconds() - LatencyStartTime;
+
+		// throughput, datagrams that overflow the receive buffer are lost, just like on a busy network
+		const TArray<uint8> Datagram = MakeTestMessage(DatagramSize, 0);
+		const int64 TotalBytes = (int64)NumThroughputMessages * ThroughputMessageSize;
+		const double ThroughputStartTime = FPlatformTime::Seconds();
+
+		for (int64 SentBytes = 0; SentBytes < TotalBytes; SentBytes += DatagramSize)
+		{
+			int32 BytesSent = 0;
+			Socket1->SendTo(Datagram.GetData(), DatagramSize, BytesSent, *Address2);
+		}
+
+		// wait until the receiver is done
+		int32 LastReceivedBytes = -1;
+
+		while (LastReceivedBytes != NumReceivedBytes.GetValue())
+		{
+			LastReceivedBytes = NumReceivedBytes.GetValue();
+			FPlatformProcess::Sleep(0.05f);
+		}
+
+		const double ThroughputTime = FPlatformTime::Seconds() - ThroughputStartTime - 0.05;
+
+		delete Receiver;
+		SocketSubsystem->DestroySocket(Socket1);
+		SocketSubsystem->DestroySocket(Socket2);
+
+		AddLogItem(FString::Printf(TEXT("UDP loopback: round trip %.2f us, throughput %.1f MB/s (%.1f%% of %i x %i byte datagrams delivered)"),
+			1000000.0 * LatencyTime / FMath::Max(NumReplies, 1),
+			LastReceivedBytes / (1024.0 * 1024.0) / ThroughputTime,
+			100.0 * LastReceivedBytes / TotalBytes,
+			(int32)(TotalBytes / DatagramSize), DatagramSize));
+	}
+
+	return true;
+}
@@ -10,6 +10,9 @@ namespace UnrealBuildTool.Rules
 				new string[] {
 					"Core",
 					"CoreUObject",
+					"Networking",
+					"Serialization",
+					"Sockets",
 				}
 			);
 
@@ -26,6 +29,7 @@ namespace UnrealBuildTool.Rules
 					"ShmMessaging/Private/Allocator",
 					"ShmMessaging/Private/Shared",
 					"ShmMessaging/Private/Transport",
+					"ShmMessaging/Private/Transport/Tests",
 				}
 			);
 		}
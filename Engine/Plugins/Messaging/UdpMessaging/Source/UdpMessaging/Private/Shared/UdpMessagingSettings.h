@@ -5,6 +5,20 @@
 #include "UdpMessagingSettings.generated.h"
 
 
+/**
+ * Enumerates the formats that message bodies can be serialized in.
+ */
+UENUM()
+enum class EUdpMessageFormat : uint8
+{
+	/** Json text, for compatibility with tools that inspect the traffic. */
+	Json,
+
+	/** Compact binary, smaller and faster to serialize than Json. */
+	Binary
+};
+
+
 UCLASS(config=Engine)
 class UUdpMessagingSettings
 	: public UObject
@@ -37,6 +51,14 @@ public:
 	UPROPERTY(config, EditAnywhere, Category=Transport, AdvancedDisplay)
 	TArray<FString> StaticEndpoints;
 
+	/**
+	 * The format to serialize sent message bodies in.
+	 *
+	 * Received messages are deserialized in whichever format they were sent.
+	 */
+	UPROPERTY(config, EditAnywhere, Category=Transport, AdvancedDisplay)
+	EUdpMessageFormat MessageFormat;
+
 public:
 
 	/** Whether the UDP tunnel is enabled. */
@@ -1,6 +1,7 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 
 #include "UdpMessagingPrivatePCH.h"
+#include "BinaryStructDeserializerBackend.h"
 #include "JsonStructDeserializerBackend.h"
 #include "StructDeserializer.h"
 
@@ -90,11 +91,29 @@ bool FUdpDeserializedMessage::Deserialize( const FUdpReassembledMessageRef& Reas
 		}
 	}
 
+	// message body format
+	uint8 Format = 0;
+	{
+		MessageReader << Format;
+
+		if ((Format != (uint8)EUdpMessageFormat::Json) && (Format != (uint8)EUdpMessageFormat::Binary))
+		{
+			return false;
+		}
+	}
+
 	// create message body
 	MessageData = FMemory::Malloc(TypeInfo->PropertiesSize);
 	TypeInfo->InitializeScriptStruct(MessageData);
 
 	// deserialize message body
+	if (Format == (uint8)EUdpMessageFormat::Binary)
+	{
+		FBinaryStructDeserializerBackend Backend(MessageReader);
+
+		return FStructDeserializer::Deserialize(MessageData, *TypeInfo, Backend);
+	}
+
 	FJsonStructDeserializerBackend Backend(MessageReader);
 
 	return FStructDeserializer::Deserialize(MessageData, *TypeInfo, Backend);
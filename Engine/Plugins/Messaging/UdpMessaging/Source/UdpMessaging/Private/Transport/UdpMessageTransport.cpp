@@ -7,8 +7,9 @@
 /* FUdpMessageTransport structors
  *****************************************************************************/
 
-FUdpMessageTransport::FUdpMessageTransport( const FIPv4Endpoint& InLocalEndpoint, const FIPv4Endpoint& InMulticastEndpoint, uint8 InMulticastTtl )
+FUdpMessageTransport::FUdpMessageTransport( const FIPv4Endpoint& InLocalEndpoint, const FIPv4Endpoint& InMulticastEndpoint, uint8 InMulticastTtl, EUdpMessageFormat InMessageFormat )
 	: LocalEndpoint(InLocalEndpoint)
+	, MessageFormat(InMessageFormat)
 	, MessageProcessor(nullptr)
 	, MessageProcessorThread(nullptr)
 	, MulticastEndpoint(InMulticastEndpoint)
@@ -122,7 +123,7 @@ bool FUdpMessageTransport::TransportMessage( const IMessageContextRef& Context,
 		return false;
 	}
 
-	FUdpSerializedMessageRef SerializedMessage = MakeShareable(new FUdpSerializedMessage());
+	FUdpSerializedMessageRef SerializedMessage = MakeShareable(new FUdpSerializedMessage(MessageFormat));
 	TGraphTask<FUdpSerializeMessageTask>::CreateTask().ConstructAndDispatchWhenReady(Context, SerializedMessage);
 
 	// publish the message
@@ -17,8 +17,9 @@ public:
 	 * @param InLocalEndpoint The local IP endpoint to receive messages on.
 	 * @param InMulticastEndpoint The multicast group endpoint to transport messages to.
 	 * @param InMulticastTtl The multicast time-to-live.
+	 * @param InMessageFormat The format to serialize sent messages in.
 	 */
-	FUdpMessageTransport( const FIPv4Endpoint& InLocalEndpoint, const FIPv4Endpoint& InMulticastEndpoint, uint8 InMulticastTtl );
+	FUdpMessageTransport( const FIPv4Endpoint& InLocalEndpoint, const FIPv4Endpoint& InMulticastEndpoint, uint8 InMulticastTtl, EUdpMessageFormat InMessageFormat );
 
 	/** Destructor. */
 	virtual ~FUdpMessageTransport();
@@ -76,6 +77,9 @@ private:
 	/** Holds the local endpoint to receive messages on. */
 	FIPv4Endpoint LocalEndpoint;
 
+	/** Holds the format to serialize sent messages in. */
+	EUdpMessageFormat MessageFormat;
+
 	/** Holds the message processor. */
 	FUdpMessageProcessor* MessageProcessor;
 
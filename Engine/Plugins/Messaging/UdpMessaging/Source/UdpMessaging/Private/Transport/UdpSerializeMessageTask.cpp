@@ -45,9 +45,18 @@ void FUdpSerializeMessageTask::DoTask( ENamedThreads::Type CurrentThread, const
 				Archive << const_cast<FName&>(It->Key);
 				Archive << const_cast<FString&>(It->Value);
 			}
+
+			uint8 Format = (uint8)SerializedMessage->GetFormat();
+			Archive << Format;
 		}
 
 		// serialize message body
+		if (SerializedMessage->GetFormat() == EUdpMessageFormat::Binary)
+		{
+			FBinaryStructSerializerBackend Backend(Archive);
+			FStructSerializer::Serialize(MessageContext->GetMessage(), *MessageContext->GetMessageTypeInfo(), Backend);
+		}
+		else
 		{
 			FJsonStructSerializerBackend Backend(Archive);
 			FStructSerializer::Serialize(MessageContext->GetMessage(), *MessageContext->GetMessageTypeInfo(), Backend);
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "BinaryStructSerializerBackend.h"
 #include "JsonStructSerializerBackend.h"
 #include "StructSerializer.h"
 
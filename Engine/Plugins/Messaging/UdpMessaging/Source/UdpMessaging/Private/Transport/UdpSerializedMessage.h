@@ -29,9 +29,14 @@ class FUdpSerializedMessage
 {
 public:
 
-	/** Default constructor. */
-	FUdpSerializedMessage()
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * @param InFormat The format to serialize the message body in.
+	 */
+	FUdpSerializedMessage( EUdpMessageFormat InFormat )
 		: FMemoryWriter(Data, true)
+		, Format(InFormat)
 		, State(EUdpSerializedMessageState::Incomplete)
 	{ }
 
@@ -49,6 +54,16 @@ public:
 		return new FMemoryReader(Data, true);
 	}
 
+	/**
+	 * Gets the format to serialize the message body in.
+	 *
+	 * @return Message body format.
+	 */
+	EUdpMessageFormat GetFormat() const
+	{
+		return Format;
+	}
+
 	/**
 	 * Gets the state of the message data.
 	 *
@@ -87,6 +102,9 @@ private:
 	/** Holds the data. */
 	TArray<uint8> Data;
 
+	/** Holds the format to serialize the message body in. */
+	EUdpMessageFormat Format;
+
 	/** Holds the message data state. */
 	EUdpSerializedMessageState State;
 
@@ -7,5 +7,6 @@ UUdpMessagingSettings::UUdpMessagingSettings( const FObjectInitializer& ObjectIn
 	: Super(ObjectInitializer)
 	, EnableTransport(true)
 	, MulticastTimeToLive(1)
+	, MessageFormat(EUdpMessageFormat::Binary)
 	, EnableTunnel(false)
 { }
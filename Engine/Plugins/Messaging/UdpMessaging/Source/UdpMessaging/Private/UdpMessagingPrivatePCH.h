@@ -30,7 +30,7 @@
 #define UDP_MESSAGING_RECEIVE_BUFFER_SIZE 2 * 1024 * 1024
 
 /** Defines the protocol version of the UDP message transport. */
-#define UDP_MESSAGING_TRANSPORT_PROTOCOL_VERSION 10
+#define UDP_MESSAGING_TRANSPORT_PROTOCOL_VERSION 11
 
 
 /* Private includes
@@ -8,7 +8,8 @@
 #include "SignedArchiveWriter.h"
 #include "KeyGenerator.h"
 #include "AES.h"
-#include "UniquePtr.h"
+#include "TaskGraphInterfaces.h"
+#include "ParallelFor.h"
 
 IMPLEMENT_APPLICATION(UnrealPak, "UnrealPak");
 
@@ -17,10 +18,18 @@ struct FPakCommandLineParameters
 	FPakCommandLineParameters()
 		: CompressionBlockSize(64*1024)
 		, FileSystemBlockSize(0)
+		, CompressionMethod(COMPRESS_Default)
+		, bSingleThreaded(false)
 	{}
 
 	int32  CompressionBlockSize;
 	int64  FileSystemBlockSize;
+	/** Compression method for files whose extension has no method of its own. */
+	ECompressionFlags CompressionMethod;
+	/** Compression methods by file extension (without the dot), i.e. fast decompression for bulk data. */
+	TMap<FString, ECompressionFlags> CompressionMethodsByExtension;
+	/** Whether to prepare files on the main thread only, instead of on the task graph. */
+	bool   bSingleThreaded;
 };
 
 struct FPakEntryPair
@@ -63,47 +72,34 @@ struct FPakEntryOrder
 	uint64  Order;
 };
 
-struct FCompressedFileBuffer
+/** A file that is ready to be written to a pak file: compressed, encrypted and hashed. */
+struct FPakFileData
 {
-	FCompressedFileBuffer()
-		: OriginalSize(0)
-		,TotalCompressedSize(0)
-		,FileCompressionBlockSize(0)
-		,CompressedBufferSize(0)
-	{
-
-	}
-
-	void Reinitialize(FArchive* File,ECompressionFlags CompressionMethod,int64 CompressionBlockSize)
-	{
-		OriginalSize = File->TotalSize();
-		TotalCompressedSize = 0;
-		FileCompressionBlockSize = 0;
-		FileCompressionMethod = CompressionMethod;
-		CompressedBlocks.Reset();
-		CompressedBlocks.AddUninitialized((OriginalSize+CompressionBlockSize-1)/CompressionBlockSize);
-	}
+	FPakFileData()
+		: Data(NULL)
+		, DataSize(0)
+		, bExists(false)
+		, ReadTime(0.0)
+		, CompressTime(0.0)
+		, EncryptTime(0.0)
+	{}
 
-	void EnsureBufferSpace(int64 RequiredSpace)
+	~FPakFileData()
 	{
-		if(RequiredSpace > CompressedBufferSize)
-		{
-			uint8* NewPtr = (uint8*)FMemory::Malloc(RequiredSpace);
-			FMemory::Memcpy(NewPtr,CompressedBuffer.Get(),CompressedBufferSize);
-			CompressedBuffer.Reset(NewPtr);
-			CompressedBufferSize = RequiredSpace;
-		}
+		FMemory::Free(Data);
 	}
 
-	bool CompressFileToWorkingBuffer(const FPakInputPair& InFile,uint8*& InOutPersistentBuffer,int64& InOutBufferSize,ECompressionFlags CompressionMethod,const int32 CompressionBlockSize);
-
-	int64						 OriginalSize;
-	int64						 TotalCompressedSize;
-	int32						 FileCompressionBlockSize;
-	ECompressionFlags			 FileCompressionMethod;
-	TArray<FPakCompressedBlock>  CompressedBlocks;
-	int64						 CompressedBufferSize;
-	TUniquePtr<uint8>		     CompressedBuffer;
+	/** Entry of the file. Compression block offsets are relative to the start of Data until the file is written. */
+	FPakEntry Info;
+	/** Data to write after the entry header, including encryption padding. */
+	uint8* Data;
+	int64  DataSize;
+	/** Whether the file could be read. */
+	bool   bExists;
+	/** Time spent reading, compressing, and encrypting and hashing the file in seconds. */
+	double ReadTime;
+	double CompressTime;
+	double EncryptTime;
 };
 
 FString GetLongestPath(TArray<FPakInputPair>& FilesToAdd)
@@ -164,165 +160,230 @@ FString GetCommonRootPath(TArray<FPakInputPair>& FilesToAdd)
 	return Root;
 }
 
-bool FCompressedFileBuffer::CompressFileToWorkingBuffer(const FPakInputPair& InFile, uint8*& InOutPersistentBuffer, int64& InOutBufferSize, ECompressionFlags CompressionMethod, const int32 CompressionBlockSize)
+/**
+ * Fills the encryption padding after data with bytes picked from the data. The bytes are picked by a random stream that
+ * is seeded per file, so the pak is the same no matter on which thread or in which order its files are prepared.
+ */
+void FillEncryptionPadding(uint8* Data, int64 DataSize, int64 PaddedSize, FRandomStream& Random)
 {
-	TAutoPtr<FArchive> FileHandle(IFileManager::Get().CreateFileReader(*InFile.Source));
-	if(!FileHandle.IsValid())
+	for (int64 FillIndex = DataSize; FillIndex < PaddedSize; ++FillIndex)
 	{
-		TotalCompressedSize = 0;
-		return false;
+		Data[FillIndex] = Data[Random.GetUnsignedInt() % DataSize];
 	}
+}
 
-	Reinitialize(FileHandle.GetOwnedPointer(), CompressionMethod, CompressionBlockSize);
-	const int64 FileSize = OriginalSize;
-	const int64 PaddedEncryptedFileSize = Align(FileSize,FAES::AESBlockSize);
-	if(InOutBufferSize < PaddedEncryptedFileSize)
+/**
+ * Encrypts data in chunks spread over the task graph. The data is encrypted one AES block at a time, so the chunks
+ * are independent as long as they start on a block boundary.
+ */
+void EncryptDataParallel(uint8* Data, int64 DataSize, uint32 ParallelForFlags)
+{
+	const int64 ChunkSize = 1024 * 1024;
+	const int32 NumChunks = (int32)((DataSize + ChunkSize - 1) / ChunkSize);
+	ParallelFor(NumChunks, [=](int32 ChunkIndex)
 	{
-		InOutPersistentBuffer = (uint8*)FMemory::Realloc(InOutPersistentBuffer,PaddedEncryptedFileSize);
-		InOutBufferSize = FileSize;
-	}
-
-	// Load to buffer
-	FileHandle->Serialize(InOutPersistentBuffer,FileSize);
-
-	// Build buffers for working
-	int64 UncompressedSize = FileSize;
-	int32 CompressionBufferSize = Align(FCompression::CompressMemoryBound(CompressionMethod,CompressionBlockSize),FAES::AESBlockSize);
-	EnsureBufferSpace(Align(FCompression::CompressMemoryBound(CompressionMethod,FileSize),FAES::AESBlockSize));
-
+		const int64 ChunkStart = ChunkIndex * ChunkSize;
+		FAES::EncryptData(Data + ChunkStart, (uint32)FMath::Min(ChunkSize, DataSize - ChunkStart));
+	}, ParallelForFlags);
+}
 
-	TotalCompressedSize = 0;
-	int64 UncompressedBytes = 0;
-	int32 CurrentBlock = 0;
-	while(UncompressedSize)
+/**
+ * Compresses the blocks of a file in parallel and packs them back to back, each one padded for encryption if needed.
+ *
+ * @return false if a block failed to compress.
+ */
+bool CompressFileData(const FPakInputPair& InFile, const uint8* FileBuffer, int64 FileSize, ECompressionFlags CompressionMethod, int32 CompressionBlockSize, uint32 ParallelForFlags, FRandomStream& Random, FPakFileData& OutData)
+{
+	const int32 NumBlocks = (int32)((FileSize + CompressionBlockSize - 1) / CompressionBlockSize);
+	const int32 CompressedBlockCapacity = Align(FCompression::CompressMemoryBound(CompressionMethod, CompressionBlockSize), FAES::AESBlockSize);
+	uint8* BlockBuffer = (uint8*)FMemory::Malloc((int64)CompressedBlockCapacity * NumBlocks);
+	TArray<int32> CompressedBlockSizes;
+	CompressedBlockSizes.AddUninitialized(NumBlocks);
+	FThreadSafeCounter NumFailedBlocks;
+
+	ParallelFor(NumBlocks, [&](int32 BlockIndex)
 	{
-		int32 BlockSize = (int32)FMath::Min<int64>(UncompressedSize,CompressionBlockSize);
-		int32 CompressedBlockSize = CompressionBufferSize;
-		FileCompressionBlockSize = FMath::Max<uint32>(BlockSize, FileCompressionBlockSize);
-		EnsureBufferSpace(TotalCompressedSize+CompressedBlockSize);
-		if(!FCompression::CompressMemory(CompressionMethod,CompressedBuffer.Get()+TotalCompressedSize,CompressedBlockSize,InOutPersistentBuffer+UncompressedBytes,BlockSize))
+		const int64 BlockStart = (int64)BlockIndex * CompressionBlockSize;
+		const int32 BlockSize = (int32)FMath::Min<int64>(CompressionBlockSize, FileSize - BlockStart);
+		CompressedBlockSizes[BlockIndex] = CompressedBlockCapacity;
+		if (!FCompression::CompressMemory(CompressionMethod, BlockBuffer + (int64)BlockIndex * CompressedBlockCapacity, CompressedBlockSizes[BlockIndex], FileBuffer + BlockStart, BlockSize))
 		{
-			return false;
+			NumFailedBlocks.Increment();
 		}
-		UncompressedSize -= BlockSize;
-		UncompressedBytes += BlockSize;
+	}, ParallelForFlags);
 
-		CompressedBlocks[CurrentBlock].CompressedStart = TotalCompressedSize;
-		CompressedBlocks[CurrentBlock].CompressedEnd = TotalCompressedSize+CompressedBlockSize;
-		++CurrentBlock;
+	if (NumFailedBlocks.GetValue() > 0)
+	{
+		FMemory::Free(BlockBuffer);
+		return false;
+	}
 
-		TotalCompressedSize += CompressedBlockSize;
+	int64 TotalCompressedSize = 0;
+	for (int32 BlockIndex = 0; BlockIndex < NumBlocks; ++BlockIndex)
+	{
+		TotalCompressedSize += InFile.bNeedEncryption ? Align(CompressedBlockSizes[BlockIndex], FAES::AESBlockSize) : CompressedBlockSizes[BlockIndex];
+	}
 
-		if(InFile.bNeedEncryption)
+	OutData.Data = (uint8*)FMemory::Malloc(TotalCompressedSize);
+	OutData.Info.CompressionBlocks.AddUninitialized(NumBlocks);
+	TotalCompressedSize = 0;
+	for (int32 BlockIndex = 0; BlockIndex < NumBlocks; ++BlockIndex)
+	{
+		FMemory::Memcpy(OutData.Data + TotalCompressedSize, BlockBuffer + (int64)BlockIndex * CompressedBlockCapacity, CompressedBlockSizes[BlockIndex]);
+		OutData.Info.CompressionBlocks[BlockIndex].CompressedStart = TotalCompressedSize;
+		OutData.Info.CompressionBlocks[BlockIndex].CompressedEnd = TotalCompressedSize + CompressedBlockSizes[BlockIndex];
+		TotalCompressedSize += CompressedBlockSizes[BlockIndex];
+
+		if (InFile.bNeedEncryption)
 		{
-			int32 EncryptionBlockPadding = Align(TotalCompressedSize,FAES::AESBlockSize);
-			for(int64 FillIndex=TotalCompressedSize; FillIndex < EncryptionBlockPadding; ++FillIndex)
-			{
-				// Fill the trailing buffer with random bytes from file
-				CompressedBuffer.Get()[FillIndex] = CompressedBuffer.Get()[rand()%TotalCompressedSize];
-			}
-			TotalCompressedSize += EncryptionBlockPadding - TotalCompressedSize;
+			const int64 EncryptionBlockPadding = Align(TotalCompressedSize, FAES::AESBlockSize);
+			FillEncryptionPadding(OutData.Data, TotalCompressedSize, EncryptionBlockPadding, Random);
+			TotalCompressedSize = EncryptionBlockPadding;
 		}
 	}
+	FMemory::Free(BlockBuffer);
 
+	OutData.DataSize = TotalCompressedSize;
+	OutData.Info.CompressionMethod = CompressionMethod;
+	OutData.Info.CompressionBlockSize = (uint32)FMath::Min<int64>(FileSize, CompressionBlockSize);
+	OutData.Info.UncompressedSize = FileSize;
+	OutData.Info.Size = TotalCompressedSize;
 	return true;
 }
 
-bool CopyFileToPak(FArchive& InPak, const FString& InMountPoint, const FPakInputPair& InFile, uint8*& InOutPersistentBuffer, int64& InOutBufferSize, FPakEntryPair& OutNewEntry)
-{	
+/**
+ * Reads a file and compresses, encrypts and hashes it as requested, so that it can be written to a pak file.
+ * Can be called from any thread.
+ *
+ * @return false if the file could not be read.
+ */
+bool PrepareFileForPak(const FPakInputPair& InFile, ECompressionFlags CompressionMethod, int32 CompressionBlockSize, bool bSingleThreaded, FPakFileData& OutData)
+{
+	const uint32 ParallelForFlags = bSingleThreaded ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+	double StartTime = FPlatformTime::Seconds();
+
 	TAutoPtr<FArchive> FileHandle(IFileManager::Get().CreateFileReader(*InFile.Source));
-	bool bFileExists = FileHandle.IsValid();
-	if (bFileExists)
+	if (!FileHandle.IsValid())
+	{
+		return false;
+	}
+
+	const int64 FileSize = FileHandle->TotalSize();
+	const int64 PaddedEncryptedFileSize = Align(FileSize, FAES::AESBlockSize);
+	uint8* FileBuffer = (uint8*)FMemory::Malloc(FMath::Max<int64>(PaddedEncryptedFileSize, 1));
+	FileHandle->Serialize(FileBuffer, FileSize);
+	FileHandle.Reset();
+
+	OutData.bExists = true;
+	OutData.Info.Offset = 0; // Don't serialize offsets here.
+	OutData.Info.bEncrypted = InFile.bNeedEncryption;
+	OutData.ReadTime = FPlatformTime::Seconds() - StartTime;
+	StartTime = FPlatformTime::Seconds();
+
+	FRandomStream Random(FCrc::StrCrc32(*InFile.Dest));
+	bool bCompressed = false;
+	if (CompressionMethod != COMPRESS_None && FileSize > 0)
 	{
-		const int64 FileSize = FileHandle->TotalSize();
-		const int64 PaddedEncryptedFileSize = Align(FileSize, FAES::AESBlockSize); 
-		OutNewEntry.Filename = InFile.Dest.Mid(InMountPoint.Len());
-		OutNewEntry.Info.Offset = 0; // Don't serialize offsets here.
-		OutNewEntry.Info.Size = FileSize;
-		OutNewEntry.Info.UncompressedSize = FileSize;
-		OutNewEntry.Info.CompressionMethod = COMPRESS_None;
-		OutNewEntry.Info.bEncrypted = InFile.bNeedEncryption;
-
-		if (InOutBufferSize < PaddedEncryptedFileSize)
+		bCompressed = CompressFileData(InFile, FileBuffer, FileSize, CompressionMethod, CompressionBlockSize, ParallelForFlags, Random, OutData);
+		if (!bCompressed)
 		{
-			InOutPersistentBuffer = (uint8*)FMemory::Realloc(InOutPersistentBuffer, PaddedEncryptedFileSize);
-			InOutBufferSize = FileSize;
+			UE_LOG(LogPakFile, Warning, TEXT("Failed to compress \"%s\", it will be stored uncompressed."), *InFile.Source);
 		}
+	}
+	OutData.CompressTime = FPlatformTime::Seconds() - StartTime;
+	StartTime = FPlatformTime::Seconds();
 
-		// Load to buffer
-		FileHandle->Serialize(InOutPersistentBuffer, FileSize);
+	if (bCompressed)
+	{
+		FMemory::Free(FileBuffer);
 
+		if (InFile.bNeedEncryption)
 		{
-			int64 SizeToWrite = FileSize;
-			if (InFile.bNeedEncryption)
-			{
-				for(int64 FillIndex=FileSize; FillIndex < PaddedEncryptedFileSize && InFile.bNeedEncryption; ++FillIndex)
-				{
-					// Fill the trailing buffer with random bytes from file
-					InOutPersistentBuffer[FillIndex] = InOutPersistentBuffer[rand()%FileSize];
-				}
-
-				//Encrypt the buffer before writing it to disk
-				FAES::EncryptData(InOutPersistentBuffer, PaddedEncryptedFileSize);
-				// Update the size to be written
-				SizeToWrite = PaddedEncryptedFileSize;
-				OutNewEntry.Info.bEncrypted = true;
-			}
+			EncryptDataParallel(OutData.Data, OutData.DataSize, ParallelForFlags);
+		}
 
-			// Calculate the buffer hash value
-			FSHA1::HashBuffer(InOutPersistentBuffer,FileSize,OutNewEntry.Info.Hash);
+		//Hash the final buffer thats written
+		FSHA1::HashBuffer(OutData.Data, (uint32)OutData.DataSize, OutData.Info.Hash);
+	}
+	else
+	{
+		OutData.Data = FileBuffer;
+		OutData.DataSize = FileSize;
+		OutData.Info.Size = FileSize;
+		OutData.Info.UncompressedSize = FileSize;
+		OutData.Info.CompressionMethod = COMPRESS_None;
 
-			// Write to file
-			OutNewEntry.Info.Serialize(InPak,FPakInfo::PakFile_Version_Latest);
-			InPak.Serialize(InOutPersistentBuffer,SizeToWrite);
+		if (InFile.bNeedEncryption)
+		{
+			// Fill the trailing buffer with random bytes from file and encrypt the buffer before writing it to disk
+			FillEncryptionPadding(FileBuffer, FileSize, PaddedEncryptedFileSize, Random);
+			EncryptDataParallel(FileBuffer, PaddedEncryptedFileSize, ParallelForFlags);
+			OutData.DataSize = PaddedEncryptedFileSize;
 		}
+
+		// Calculate the buffer hash value
+		FSHA1::HashBuffer(FileBuffer, (uint32)FileSize, OutData.Info.Hash);
 	}
-	return bFileExists;
+	OutData.EncryptTime = FPlatformTime::Seconds() - StartTime;
+
+	return true;
 }
 
-bool CopyCompressedFileToPak(FArchive& InPak, const FString& InMountPoint, const FPakInputPair& InFile, const FCompressedFileBuffer& CompressedFile, FPakEntryPair& OutNewEntry)
+/** Task that prepares a file for a pak file on a task graph worker thread. */
+class FPakPrepareFileTask
 {
-	if (CompressedFile.TotalCompressedSize == 0)
+public:
+	FPakPrepareFileTask(const FPakInputPair* InFile, ECompressionFlags InCompressionMethod, int32 InCompressionBlockSize, FPakFileData* InFileData)
+		: File(InFile)
+		, CompressionMethod(InCompressionMethod)
+		, CompressionBlockSize(InCompressionBlockSize)
+		, FileData(InFileData)
+	{}
+
+	void DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
 	{
-		return false;
+		PrepareFileForPak(*File, CompressionMethod, CompressionBlockSize, false, *FileData);
 	}
 
-	int64 HeaderTell = InPak.Tell();
-	OutNewEntry.Info.CompressionMethod = CompressedFile.FileCompressionMethod;
-	OutNewEntry.Info.CompressionBlocks.AddUninitialized(CompressedFile.CompressedBlocks.Num());
-
-	int64 TellPos = InPak.Tell() + OutNewEntry.Info.GetSerializedSize(FPakInfo::PakFile_Version_Latest);
-	const TArray<FPakCompressedBlock>& Blocks = CompressedFile.CompressedBlocks;
-	for (int32 BlockIndex = 0, BlockCount = CompressedFile.CompressedBlocks.Num(); BlockIndex < BlockCount; ++BlockIndex)
+	static ENamedThreads::Type GetDesiredThread()
 	{
-		OutNewEntry.Info.CompressionBlocks[BlockIndex].CompressedStart = Blocks[BlockIndex].CompressedStart + TellPos;
-		OutNewEntry.Info.CompressionBlocks[BlockIndex].CompressedEnd = Blocks[BlockIndex].CompressedEnd + TellPos;
+		return ENamedThreads::AnyThread;
 	}
 
-	if (InFile.bNeedEncryption)
+	static ESubsequentsMode::Type GetSubsequentsMode()
 	{
-		FAES::EncryptData(CompressedFile.CompressedBuffer.Get(), CompressedFile.TotalCompressedSize);
+		return ESubsequentsMode::TrackSubsequents;
 	}
 
-	//Hash the final buffer thats written
-	FSHA1 Hash;
-	Hash.Update(CompressedFile.CompressedBuffer.Get(), CompressedFile.TotalCompressedSize);
-	Hash.Final();
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FPakPrepareFileTask, STATGROUP_TaskGraphTasks);
+	}
 
-	// Update file size & Hash
-	OutNewEntry.Info.CompressionBlockSize = CompressedFile.FileCompressionBlockSize;
-	OutNewEntry.Info.UncompressedSize = CompressedFile.OriginalSize;
-	OutNewEntry.Info.Size = CompressedFile.TotalCompressedSize;
-	Hash.GetHash(OutNewEntry.Info.Hash);
+private:
+	const FPakInputPair* File;
+	ECompressionFlags CompressionMethod;
+	int32 CompressionBlockSize;
+	FPakFileData* FileData;
+};
 
-	//	Write the header, then the data
+/** Writes a prepared file to a pak file, at the current position. */
+void WriteFileToPak(FArchive& InPak, const FString& InMountPoint, const FPakInputPair& InFile, FPakFileData& FileData, FPakEntryPair& OutNewEntry)
+{
 	OutNewEntry.Filename = InFile.Dest.Mid(InMountPoint.Len());
-	OutNewEntry.Info.Offset = 0; // Don't serialize offsets here.
-	OutNewEntry.Info.bEncrypted = InFile.bNeedEncryption;
-	OutNewEntry.Info.Serialize(InPak,FPakInfo::PakFile_Version_Latest);
-	InPak.Serialize(CompressedFile.CompressedBuffer.Get(), CompressedFile.TotalCompressedSize);
+	OutNewEntry.Info = FileData.Info;
 
-	return true;
+	// Compression blocks are stored with their offsets in the pak file
+	const int64 TellPos = InPak.Tell() + OutNewEntry.Info.GetSerializedSize(FPakInfo::PakFile_Version_Latest);
+	for (int32 BlockIndex = 0, BlockCount = OutNewEntry.Info.CompressionBlocks.Num(); BlockIndex < BlockCount; ++BlockIndex)
+	{
+		OutNewEntry.Info.CompressionBlocks[BlockIndex].CompressedStart += TellPos;
+		OutNewEntry.Info.CompressionBlocks[BlockIndex].CompressedEnd += TellPos;
+	}
+
+	//	Write the header, then the data
+	OutNewEntry.Info.Serialize(InPak, FPakInfo::PakFile_Version_Latest);
+	InPak.Serialize(FileData.Data, FileData.DataSize);
 }
 
 void ProcessOrderFile(int32 ArgC, TCHAR* ArgV[], TMap<FString, uint64>& OrderMap)
@@ -406,6 +467,46 @@ void ProcessCommandLine(int32 ArgC, TCHAR* ArgV[], TArray<FPakInputPair>& Entrie
 		CmdLineParameters.FileSystemBlockSize = 0;
 	}
 
+	CmdLineParameters.bSingleThreaded = FParse::Param(FCommandLine::Get(), TEXT("SingleThreaded"));
+
+	FString CompressionMethodName;
+	if (FParse::Value(FCommandLine::Get(), TEXT("-compressionmethod="), CompressionMethodName))
+	{
+		ECompressionFlags CompressionMethod = FCompression::GetCompressionTypeFromName(*CompressionMethodName);
+		if (CompressionMethod != COMPRESS_None)
+		{
+			CmdLineParameters.CompressionMethod = CompressionMethod;
+		}
+		else
+		{
+			UE_LOG(LogPakFile, Error, TEXT("Unknown compression method %s, using %s."), *CompressionMethodName, FCompression::GetCodec(CmdLineParameters.CompressionMethod)->GetName());
+		}
+	}
+
+	FString ExtensionCompressionMethods;
+	if (FParse::Value(FCommandLine::Get(), TEXT("-extensioncompressionmethods="), ExtensionCompressionMethods))
+	{
+		TArray<FString> ExtensionMethodPairs;
+		ExtensionCompressionMethods.ParseIntoArray(&ExtensionMethodPairs, TEXT("+"), true);
+		for (int32 PairIndex = 0; PairIndex < ExtensionMethodPairs.Num(); PairIndex++)
+		{
+			FString Extension;
+			ECompressionFlags CompressionMethod = COMPRESS_None;
+			if (ExtensionMethodPairs[PairIndex].Split(TEXT(":"), &Extension, &CompressionMethodName))
+			{
+				CompressionMethod = FCompression::GetCompressionTypeFromName(*CompressionMethodName);
+			}
+			if (CompressionMethod != COMPRESS_None)
+			{
+				CmdLineParameters.CompressionMethodsByExtension.Add(Extension, CompressionMethod);
+			}
+			else
+			{
+				UE_LOG(LogPakFile, Error, TEXT("Unable to parse extension compression method %s, expected extension:method."), *ExtensionMethodPairs[PairIndex]);
+			}
+		}
+	}
+
 	if (FParse::Value(FCommandLine::Get(), TEXT("-create="), ResponseFile))
 	{
 		bool bCompress = false;
@@ -727,6 +828,15 @@ FArchive* CreatePakWriter(const TCHAR* Filename)
 	return Writer;
 }
 
+/**
+ * Gets the compression method for a file, based on its extension.
+ */
+ECompressionFlags GetCompressionMethodForFile(const FString& Filename, const FPakCommandLineParameters& CmdLineParameters)
+{
+	const ECompressionFlags* CompressionMethod = CmdLineParameters.CompressionMethodsByExtension.Find(FPaths::GetExtension(Filename));
+	return CompressionMethod ? *CompressionMethod : CmdLineParameters.CompressionMethod;
+}
+
 bool CreatePakFile(const TCHAR* Filename, TArray<FPakInputPair>& FilesToAdd, const FPakCommandLineParameters& CmdLineParameters)
 {	
 	const double StartTime = FPlatformTime::Seconds();
@@ -742,62 +852,94 @@ bool CreatePakFile(const TCHAR* Filename, TArray<FPakInputPair>& FilesToAdd, con
 	FPakInfo Info;
 	TArray<FPakEntryPair> Index;
 	FString MountPoint = GetCommonRootPath(FilesToAdd);
-	uint8* ReadBuffer = NULL;
-	int64 BufferSize = 0;
-	ECompressionFlags CompressionMethod = COMPRESS_None;
-	FCompressedFileBuffer CompressedFileBuffer;
 
+	// Files are read, compressed, encrypted and hashed on the task graph, a window of files ahead of the one that is
+	// written next. Files are written in order, so the pak is the same as with -SingleThreaded.
+	const bool bSingleThreaded = CmdLineParameters.bSingleThreaded || FTaskGraphInterface::Get().GetNumWorkerThreads() == 0;
+	const int32 MaxFilesInFlight = bSingleThreaded ? 1 : FTaskGraphInterface::Get().GetNumWorkerThreads() * 4;
+	const int64 MaxBytesInFlight = 512 * 1024 * 1024;
+
+	TArray<int64> FileSizes;
+	TArray<FPakFileData*> FileData;
+	TArray<FGraphEventRef> FileDataEvents;
+	FileSizes.AddUninitialized(FilesToAdd.Num());
+	FileData.AddZeroed(FilesToAdd.Num());
+	FileDataEvents.AddZeroed(FilesToAdd.Num());
 	for (int32 FileIndex = 0; FileIndex < FilesToAdd.Num(); FileIndex++)
 	{
-		//  Remember the offset but don't serialize it with the entry header.
-		int64 NewEntryOffset = PakFileHandle->Tell();
-		FPakEntryPair NewEntry;
+		FileSizes[FileIndex] = IFileManager::Get().FileSize(*FilesToAdd[FileIndex].Source);
+	}
 
-		//check if this file requested to be compression
-		int64 OriginalFileSize = IFileManager::Get().FileSize(*FilesToAdd[FileIndex].Source);
-		int64 RealFileSize = OriginalFileSize + NewEntry.Info.GetSerializedSize(FPakInfo::PakFile_Version_Latest);
-		CompressionMethod = (FilesToAdd[FileIndex].bNeedsCompression && OriginalFileSize > 0) ? COMPRESS_Default : COMPRESS_None;
+	int32 NumFilesDispatched = 0;
+	int64 BytesInFlight = 0;
+	double ReadTime = 0.0;
+	double CompressTime = 0.0;
+	double EncryptTime = 0.0;
+	double WaitTime = 0.0;
+	double WriteTime = 0.0;
 
-		if (CompressionMethod != COMPRESS_None)
+	for (int32 FileIndex = 0; FileIndex < FilesToAdd.Num(); FileIndex++)
+	{
+		// Keep the window full, but always dispatch the file that is written next
+		while (NumFilesDispatched < FilesToAdd.Num() && (NumFilesDispatched == FileIndex || (NumFilesDispatched - FileIndex < MaxFilesInFlight && BytesInFlight < MaxBytesInFlight)))
 		{
-			if (CompressedFileBuffer.CompressFileToWorkingBuffer(FilesToAdd[FileIndex], ReadBuffer, BufferSize, CompressionMethod, CmdLineParameters.CompressionBlockSize))
+			const FPakInputPair& File = FilesToAdd[NumFilesDispatched];
+			const ECompressionFlags CompressionMethod = (File.bNeedsCompression && FileSizes[NumFilesDispatched] > 0) ? GetCompressionMethodForFile(File.Source, CmdLineParameters) : COMPRESS_None;
+			FileData[NumFilesDispatched] = new FPakFileData();
+
+			if (bSingleThreaded)
 			{
-				NewEntry.Info.CompressionMethod = CompressionMethod;
-				NewEntry.Info.CompressionBlocks.AddUninitialized(CompressedFileBuffer.CompressedBlocks.Num());
-				RealFileSize = CompressedFileBuffer.TotalCompressedSize + NewEntry.Info.GetSerializedSize(FPakInfo::PakFile_Version_Latest);
-				NewEntry.Info.CompressionBlocks.Reset();
+				PrepareFileForPak(File, CompressionMethod, CmdLineParameters.CompressionBlockSize, true, *FileData[NumFilesDispatched]);
 			}
-		}
-
-		// Account for file system block size, which is a boundary we want to avoid crossing.
-		if (CmdLineParameters.FileSystemBlockSize > 0 && OriginalFileSize != INDEX_NONE && RealFileSize <= CmdLineParameters.FileSystemBlockSize)
-		{
-			if ((NewEntryOffset / CmdLineParameters.FileSystemBlockSize) != ((NewEntryOffset+RealFileSize) / CmdLineParameters.FileSystemBlockSize))
+			else
 			{
-				//File crosses a block boundary, so align it to the beginning of the next boundary
-				NewEntryOffset = AlignArbitrary(NewEntryOffset, CmdLineParameters.FileSystemBlockSize);
-				PakFileHandle->Seek(NewEntryOffset);
+				FileDataEvents[NumFilesDispatched] = TGraphTask<FPakPrepareFileTask>::CreateTask().ConstructAndDispatchWhenReady(&File, CompressionMethod, CmdLineParameters.CompressionBlockSize, FileData[NumFilesDispatched]);
 			}
-		}
 
-		bool bCopiedToPak;
-		if (FilesToAdd[FileIndex].bNeedsCompression && CompressionMethod != COMPRESS_None)
-		{
-			bCopiedToPak = CopyCompressedFileToPak(*PakFileHandle, MountPoint, FilesToAdd[FileIndex], CompressedFileBuffer, NewEntry);
+			BytesInFlight += FMath::Max<int64>(FileSizes[NumFilesDispatched], 0);
+			NumFilesDispatched++;
 		}
-		else
+
+		double StageStartTime = FPlatformTime::Seconds();
+		if (FileDataEvents[FileIndex].GetReference() != NULL)
 		{
-			bCopiedToPak = CopyFileToPak(*PakFileHandle, MountPoint, FilesToAdd[FileIndex], ReadBuffer, BufferSize, NewEntry);
+			FTaskGraphInterface::Get().WaitUntilTaskCompletes(FileDataEvents[FileIndex]);
+			FileDataEvents[FileIndex].SafeRelease();
 		}
+		WaitTime += FPlatformTime::Seconds() - StageStartTime;
+		StageStartTime = FPlatformTime::Seconds();
 
-		if (bCopiedToPak)
+		FPakFileData& CurrentFileData = *FileData[FileIndex];
+		ReadTime += CurrentFileData.ReadTime;
+		CompressTime += CurrentFileData.CompressTime;
+		EncryptTime += CurrentFileData.EncryptTime;
+
+		if (CurrentFileData.bExists)
 		{
+			//  Remember the offset but don't serialize it with the entry header.
+			int64 NewEntryOffset = PakFileHandle->Tell();
+			int64 RealFileSize = CurrentFileData.Info.Size + CurrentFileData.Info.GetSerializedSize(FPakInfo::PakFile_Version_Latest);
+			FPakEntryPair NewEntry;
+
+			// Account for file system block size, which is a boundary we want to avoid crossing.
+			if (CmdLineParameters.FileSystemBlockSize > 0 && RealFileSize <= CmdLineParameters.FileSystemBlockSize)
+			{
+				if ((NewEntryOffset / CmdLineParameters.FileSystemBlockSize) != ((NewEntryOffset+RealFileSize) / CmdLineParameters.FileSystemBlockSize))
+				{
+					//File crosses a block boundary, so align it to the beginning of the next boundary
+					NewEntryOffset = AlignArbitrary(NewEntryOffset, CmdLineParameters.FileSystemBlockSize);
+					PakFileHandle->Seek(NewEntryOffset);
+				}
+			}
+
+			WriteFileToPak(*PakFileHandle, MountPoint, FilesToAdd[FileIndex], CurrentFileData, NewEntry);
+
 			// Update offset now and store it in the index (and only in index)
 			NewEntry.Info.Offset = NewEntryOffset;
 			Index.Add(NewEntry);
-			if (FilesToAdd[FileIndex].bNeedsCompression)
+			if (NewEntry.Info.CompressionMethod != COMPRESS_None)
 			{
-				UE_LOG(LogPakFile, Display, TEXT("Added compressed file \"%s\", Compressed Size %lld bytes, Original Size %lld bytes."), *NewEntry.Filename, NewEntry.Info.Size, NewEntry.Info.UncompressedSize);
+				UE_LOG(LogPakFile, Display, TEXT("Added compressed file \"%s\", Compressed Size %lld bytes, Original Size %lld bytes, Method %s."), *NewEntry.Filename, NewEntry.Info.Size, NewEntry.Info.UncompressedSize, FCompression::GetCodec((ECompressionFlags)NewEntry.Info.CompressionMethod)->GetName());
 			}
 			else
 			{
@@ -808,10 +950,30 @@ bool CreatePakFile(const TCHAR* Filename, TArray<FPakInputPair>& FilesToAdd, con
 		{
 			UE_LOG(LogPakFile, Warning, TEXT("Missing file \"%s\" will not be added to PAK file."), *FilesToAdd[FileIndex].Source);
 		}
+
+		BytesInFlight -= FMath::Max<int64>(FileSizes[FileIndex], 0);
+		delete FileData[FileIndex];
+		FileData[FileIndex] = NULL;
+		WriteTime += FPlatformTime::Seconds() - StageStartTime;
 	}
 
-	FMemory::Free(ReadBuffer);
-	ReadBuffer = NULL;
+	UE_LOG(LogPakFile, Display, TEXT("Stage times (summed over files): read %.2lfs, compress %.2lfs, encrypt and hash %.2lfs. Writer: waiting %.2lfs, writing %.2lfs, %d threads."),
+		ReadTime, CompressTime, EncryptTime, WaitTime, WriteTime, bSingleThreaded ? 1 : FTaskGraphInterface::Get().GetNumWorkerThreads() + 1);
+
+	// Build the index the way it is used at runtime, so that mounting the pak only needs to read it.
+	TArray<FString> IndexFilenames;
+	TArray<FPakEntry> IndexEntries;
+	for (int32 EntryIndex = 0; EntryIndex < Index.Num(); EntryIndex++)
+	{
+		IndexFilenames.Add(Index[EntryIndex].Filename);
+		IndexEntries.Add(Index[EntryIndex].Info);
+	}
+	FPakIndex PakIndex;
+	if (!PakIndex.Build(IndexFilenames, IndexEntries))
+	{
+		UE_LOG(LogPakFile, Error, TEXT("Unable to create the index of pak file \"%s\"."), Filename);
+		return false;
+	}
 
 	// Remember IndexOffset
 	Info.IndexOffset = PakFileHandle->Tell();
@@ -820,15 +982,8 @@ bool CreatePakFile(const TCHAR* Filename, TArray<FPakInputPair>& FilesToAdd, con
 	TArray<uint8> IndexData;
 	FMemoryWriter IndexWriter(IndexData);
 	IndexWriter.SetByteSwapping(PakFileHandle->ForceByteSwapping());
-	int32 NumEntries = Index.Num();
 	IndexWriter << MountPoint;
-	IndexWriter << NumEntries;
-	for (int32 EntryIndex = 0; EntryIndex < Index.Num(); EntryIndex++)
-	{
-		FPakEntryPair& Entry = Index[EntryIndex];
-		IndexWriter << Entry.Filename;
-		Entry.Info.Serialize(IndexWriter, Info.Version);
-	}
+	PakIndex.Serialize(IndexWriter, Info.Version);
 	PakFileHandle->Serialize(IndexData.GetData(), IndexData.Num());
 
 	FSHA1::HashBuffer(IndexData.GetData(), IndexData.Num(), Info.IndexHash);
@@ -969,6 +1124,9 @@ bool ExtractFilesFromPak(const TCHAR* InPakFilename, const TCHAR* InDestPath)
  *   -Test test if the pak file is healthy
  *   -Extract extracts pak file contents (followed by a path, i.e.: -extract D:\ExtractedPak)
  *   -Create=filename response file to create a pak file with
+ *   -CompressionMethod=name compression method for compressed files (ZLIB or LZ4, default is ZLIB)
+ *   -ExtensionCompressionMethods=extension:name+... compression methods by file extension, i.e: -extensioncompressionmethods=ubulk:LZ4+uexp:LZ4
+ *   -SingleThreaded compress and encrypt files on the main thread only (the pak is the same as without it)
  *   -Sign=filename use the key pair in filename to sign a pak file, or: -sign=key_hex_values_separated_with_+, i.e: -sign=0x123456789abcdef+0x1234567+0x12345abc
  *    where the first number is the private key exponend, the second one is modulus and the third one is the public key exponent.
  *   -Signed use with -extract and -test to let the code know this is a signed pak
@@ -0,0 +1,172 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	ParallelFor.cpp: Implements ParallelFor.
+=============================================================================*/
+
+#include "CorePrivatePCH.h"
+#include "TaskGraphInterfaces.h"
+#include "ParallelFor.h"
+
+
+static TAutoConsoleVariable<int32> CVarParallelForForceSingleThread(
+	TEXT("ParallelFor.ForceSingleThread"),
+	0,
+	TEXT("If 1, every ParallelFor runs its iterations on the calling thread, in order. For debugging."));
+
+/** Chunks per thread for balanced loops, more chunks balance better but cost more interlocked operations. */
+static const int32 ParallelForChunksPerThread = 4;
+
+
+/** State shared by the threads running one ParallelFor. Kept alive by helper tasks that start after the call returned. */
+struct FParallelForData
+{
+	FParallelForData( int32 InNum, int32 InChunkSize, int32 InNumHelpers, TFunctionRef<void(int32)> InBody )
+		: Num(InNum)
+		, ChunkSize(InChunkSize)
+		, NumChunks((InNum + InChunkSize - 1) / InChunkSize)
+		, Body(InBody)
+		, DoneEvent(FPlatformProcess::CreateSynchEvent(true))
+	{
+		NumHelpersToSpawn.Set(InNumHelpers);
+	}
+
+	~FParallelForData()
+	{
+		delete DoneEvent;
+	}
+
+	/**
+	 * Runs chunks until there are none left to take.
+	 *
+	 * @return true if this thread completed the last iteration.
+	 */
+	bool Process()
+	{
+		bool bCompletedLast = false;
+
+		while (true)
+		{
+			const int32 ChunkIndex = NextChunk.Increment() - 1;
+			if (ChunkIndex >= NumChunks)
+			{
+				break;
+			}
+
+			const int32 Start = ChunkIndex * ChunkSize;
+			const int32 End = FMath::Min(Start + ChunkSize, Num);
+			for (int32 Index = Start; Index < End; Index++)
+			{
+				Body(Index);
+			}
+
+			// Add returns the previous value
+			bCompletedLast = NumDone.Add(End - Start) + (End - Start) == Num;
+		}
+
+		return bCompletedLast;
+	}
+
+	/** @return true if a chunk is left and another helper should start, claiming the right to start it. */
+	bool ClaimHelper()
+	{
+		if (NextChunk.GetValue() >= NumChunks)
+		{
+			return false;
+		}
+		return NumHelpersToSpawn.Decrement() >= 0;
+	}
+
+	const int32 Num;
+	const int32 ChunkSize;
+	const int32 NumChunks;
+
+	/** Only called for indices claimed before the last one completes, so it never outlives the ParallelFor call. */
+	TFunctionRef<void(int32)> Body;
+
+	FThreadSafeCounter NextChunk;
+	FThreadSafeCounter NumDone;
+	FThreadSafeCounter NumHelpersToSpawn;
+
+	/** Triggered by the helper completing the last iteration. */
+	FEvent* DoneEvent;
+};
+
+typedef TSharedRef<FParallelForData, ESPMode::ThreadSafe> FParallelForDataRef;
+
+
+/** Runs chunks of a ParallelFor on a worker thread, after starting the next helper so helpers fan out quickly. */
+class FParallelForTask
+{
+public:
+	FParallelForTask( const FParallelForDataRef& InData )
+		: Data(InData)
+	{ }
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FParallelForTask, STATGROUP_TaskGraphTasks);
+	}
+
+	static ENamedThreads::Type GetDesiredThread()
+	{
+		return ENamedThreads::AnyThread;
+	}
+
+	static ESubsequentsMode::Type GetSubsequentsMode()
+	{
+		return ESubsequentsMode::FireAndForget;
+	}
+
+	void DoTask( ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent )
+	{
+		if (Data->ClaimHelper())
+		{
+			TGraphTask<FParallelForTask>::CreateTask().ConstructAndDispatchWhenReady(Data);
+		}
+
+		if (Data->Process())
+		{
+			Data->DoneEvent->Trigger();
+		}
+	}
+
+private:
+	FParallelForDataRef Data;
+};
+
+
+void ParallelFor( int32 Num, TFunctionRef<void(int32)> Body, uint32 Flags )
+{
+	check(Num >= 0);
+
+	const int32 NumWorkers = FTaskGraphInterface::Get().GetNumWorkerThreads();
+
+	if (Num <= 1 || NumWorkers <= 0 || (Flags & EParallelForFlags::ForceSingleThread) || CVarParallelForForceSingleThread.GetValueOnAnyThread() != 0)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Body(Index);
+		}
+		return;
+	}
+
+	const int32 ChunkSize = (Flags & EParallelForFlags::Unbalanced) ? 1 : FMath::Max(1, Num / ((NumWorkers + 1) * ParallelForChunksPerThread));
+	const int32 NumChunks = (Num + ChunkSize - 1) / ChunkSize;
+
+	// One chunk is for the calling thread, helpers run on existing workers so there is no oversubscription
+	const int32 NumHelpers = FMath::Min(NumWorkers, NumChunks - 1);
+
+	FParallelForDataRef Data = MakeShareable(new FParallelForData(Num, ChunkSize, NumHelpers, Body));
+
+	if (Data->ClaimHelper())
+	{
+		TGraphTask<FParallelForTask>::CreateTask().ConstructAndDispatchWhenReady(Data);
+	}
+
+	// Wait only for chunks other threads started, helpers still in a queue will find nothing left to do
+	if (!Data->Process())
+	{
+		Data->DoneEvent->Wait();
+	}
+}
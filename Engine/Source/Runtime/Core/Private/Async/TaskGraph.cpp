@@ -3,6 +3,7 @@
 
 #include "CorePrivatePCH.h"
 #include "TaskGraphInterfaces.h"
+#include "WorkStealingQueue.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogTaskGraph, Log, All);
 
@@ -24,6 +25,12 @@ namespace ENamedThreads
 **/
 static class FTaskGraphImplementation* TaskGraphImplementationSingleton = NULL;
 
+static TAutoConsoleVariable<int32> CVarTaskGraphWorkStealing(
+	TEXT("TaskGraph.WorkStealing"),
+	0,
+	TEXT("If 1, AnyThread tasks queued from a worker thread go to a deque owned by that worker instead of the shared incoming list.\n")
+	TEXT("Workers run their own tasks first and steal from random other workers when they run out. Can be changed at any time."));
+
 #if !UE_BUILD_SHIPPING && !UE_BUILD_TEST
 
 static struct FChaosMode 
@@ -232,6 +239,7 @@ public:
 		, PerThreadIDTLSSlot(0xffffffff)
 		, bAllowsStealsFromMe(false)
 		, bStealsFromOthers(false)
+		, StealSeed(1)
 	{
 		NewTasks.Reset(128);
 	}
@@ -250,6 +258,7 @@ public:
 		PerThreadIDTLSSlot = InPerThreadIDTLSSlot;
 		bAllowsStealsFromMe = bInAllowsStealsFromMe;
 		bStealsFromOthers = bInStealsFromOthers;
+		StealSeed = 0x9E3779B9u * (uint32(InThreadId) + 1);
 	}
 
 	// Calls meant to be called from "this thread".
@@ -526,6 +535,50 @@ public:
 		return Queue(0).IncomingQueue.PopIfNotClosed();
 	}
 
+	/** 
+	 *	Attempt to take the oldest task from the work stealing deque of this worker thread.
+	 *	@return Task; Stolen task, if one was found, otherwise NULL.
+	 **/
+	FBaseGraphTask* StealFromLocalDeque()
+	{
+		checkThreadGraph(bAllowsStealsFromMe); 
+		return LocalDeque.Steal();
+	}
+
+	// Calls meant to be called from "this thread" for worker threads.
+
+	/** 
+	 *	Queue an AnyThread task on the work stealing deque of this worker thread.
+	 *	@param Task; Task to queue.
+	 **/
+	void PushToLocalDeque(FBaseGraphTask* Task)
+	{
+		checkThreadGraph(bAllowsStealsFromMe); 
+		checkThreadGraph((FTaskThread*)FPlatformTLS::GetTlsValue(PerThreadIDTLSSlot) == this); // only the owner can push
+		LocalDeque.Push(Task);
+	}
+
+	/** 
+	 *	Take the most recently queued task from the work stealing deque of this worker thread.
+	 *	@return Task, if one was found, otherwise NULL.
+	 **/
+	FBaseGraphTask* PopFromLocalDeque()
+	{
+		checkThreadGraph(bAllowsStealsFromMe); 
+		return LocalDeque.Pop();
+	}
+
+	/** 
+	 *	Returns a random number used to pick threads to steal from or to wake up, and advances it (xorshift). Owner thread only.
+	 **/
+	uint32 NextStealSeed()
+	{
+		StealSeed ^= StealSeed << 13;
+		StealSeed ^= StealSeed >> 17;
+		StealSeed ^= StealSeed << 5;
+		return StealSeed;
+	}
+
 	/** 
 	 *Return true if this thread is processing tasks. This is only a "guess" if you ask for a thread other than yourself because that can change before the function returns.
 	 *@param QueueIndex, Queue to request quit from
@@ -702,6 +755,10 @@ private:
 	bool												bAllowsStealsFromMe;
 	/** If true, this is a worker thread and I will attempt to steal tasks when I run out of work. **/
 	bool												bStealsFromOthers;
+	/** For worker threads, AnyThread tasks queued by this thread in TaskGraph.WorkStealing mode. Other workers steal from the top. **/
+	TWorkStealingQueue<FBaseGraphTask>					LocalDeque;
+	/** State of the random number generator used to pick steal victims and threads to wake up. **/
+	uint32												StealSeed;
 
 };
 
@@ -854,12 +911,26 @@ public:
 		{
 			if (FPlatformProcess::SupportsMultithreading())
 			{
-				IncomingAnyThreadTasks.Push(Task);
+				const bool bQueueToLocalDeque = CurrentThreadIfKnown >= NumNamedThreads && CVarTaskGraphWorkStealing.GetValueOnAnyThread() != 0;
+				if (bQueueToLocalDeque)
+				{
+					// The thread we wake up below steals it, unless we get back to it first
+					Thread(CurrentThreadIfKnown).PushToLocalDeque(Task);
+				}
+				else
+				{
+					IncomingAnyThreadTasks.Push(Task);
+				}
 				FTaskThread* TempTarget = StalledUnnamedThreads.Pop(); //@todo it is possible that a thread is in the process of stalling and we just missed it, non-fatal, but we could lose a whole task of potential parallelism.
 				if (TempTarget)
 				{
 					ThreadToExecuteOn = TempTarget->GetThreadId();
 				}
+				else if (bQueueToLocalDeque)
+				{
+					// Avoid the shared counter, every worker spawning tasks would contend on it
+					ThreadToExecuteOn = ENamedThreads::Type((Thread(CurrentThreadIfKnown).NextStealSeed() % uint32(NextUnnamedThreadMod)) + NumNamedThreads);
+				}
 				else
 				{
 					ThreadToExecuteOn = ENamedThreads::Type((uint32(NextUnnamedThreadForTaskFromUnknownThread.Increment()) % uint32(NextUnnamedThreadMod)) + NumNamedThreads);
@@ -1020,6 +1091,14 @@ public:
 	FBaseGraphTask* FindWork(ENamedThreads::Type ThreadInNeed)
 	{
 		TestRandomizedThreads();
+		// Deques are always checked, so nothing is stranded when TaskGraph.WorkStealing is turned off
+		{
+			FBaseGraphTask* Task = Thread(ThreadInNeed).PopFromLocalDeque();
+			if (Task)
+			{
+				return Task;
+			}
+		}
 		{
 			FBaseGraphTask* Task = SortedAnyThreadTasks.Pop();
 			if (Task)
@@ -1056,6 +1135,23 @@ public:
 				}
 			}
 		} while (!IncomingAnyThreadTasks.IsEmpty() || !SortedAnyThreadTasks.IsEmpty());
+		{
+			// Start from a random victim, so thieves don't all go after the same deque
+			const int32 NumWorkers = NumThreads - NumNamedThreads;
+			const int32 FirstVictim = int32(Thread(ThreadInNeed).NextStealSeed() % uint32(NumWorkers));
+			for (int32 Index = 0; Index < NumWorkers; Index++)
+			{
+				const int32 Victim = NumNamedThreads + (FirstVictim + Index) % NumWorkers;
+				if (Victim != ThreadInNeed)
+				{
+					FBaseGraphTask* Task = Thread(Victim).StealFromLocalDeque();
+					if (Task)
+					{
+						return Task;
+					}
+				}
+			}
+		}
 		// this can be called before my constructor is finished
 		for (int32 Pass = 0; Pass < 2; Pass++)
 		{
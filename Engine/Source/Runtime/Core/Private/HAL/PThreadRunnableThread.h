@@ -223,6 +223,9 @@ protected:
 		uint32 ExitCode = 1;
 		check(Runnable);
 
+		// Threads cache freed memory, if the allocator supports it
+		FMemory::SetupTLSCachesOnCurrentThread();
+
 		// Initialize the runnable object
 		if (Runnable->Init() == true)
 		{
@@ -239,6 +242,8 @@ protected:
 			ThreadInitSyncEvent->Trigger();
 		}
 
+		FMemory::ClearAndDisableTLSCachesOnCurrentThread();
+
 		// Clean ourselves up without waiting
 		ThreadIsRunning = false;
 		return ExitCode;
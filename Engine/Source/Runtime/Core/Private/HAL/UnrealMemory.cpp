@@ -39,6 +39,9 @@ void GCreateMalloc()
 	{
 		GMalloc = new FMallocThreadSafeProxy( GMalloc );
 	}
+
+	// Other threads do this in FRunnableThread, the main thread never exits so it doesn't clear it
+	GMalloc->SetupTLSCachesOnCurrentThread();
 }
 
 
@@ -104,6 +107,25 @@ SIZE_T FMemory::GetAllocSize( void* Original )
 	return GMalloc->GetAllocationSize( Original, Size ) ? Size : 0;
 }
 
+void FMemory::SetupTLSCachesOnCurrentThread()
+{
+	if( !GMalloc )
+	{
+		GCreateMalloc();	
+		CA_ASSUME( GMalloc != NULL );	// Don't want to assert, but suppress static analysis warnings about potentially NULL GMalloc
+	}
+
+	GMalloc->SetupTLSCachesOnCurrentThread();
+}
+
+void FMemory::ClearAndDisableTLSCachesOnCurrentThread()
+{
+	if( GMalloc )
+	{
+		GMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+	}
+}
+
 void FMemory::TestMemory()
 {
 #if !UE_BUILD_SHIPPING
@@ -3,6 +3,7 @@
 #include "CorePrivatePCH.h"
 #include <sys/file.h>	// flock()
 #include <sys/stat.h>   // mkdirp()
+#include <sys/mman.h>	// mmap()
 
 DEFINE_LOG_CATEGORY_STATIC(LogLinuxPlatformFile, Log, All);
 
@@ -91,6 +92,107 @@ public:
 	}
 };
 
+/**
+ * Linux memory mapped file region implementation
+**/
+class FMappedFileRegionLinux : public IMappedFileRegion
+{
+	/** Page aligned start of the mapping, which may begin before the first mapped byte. */
+	void* MappingPtr;
+	size_t MappingSize;
+
+public:
+	FMappedFileRegionLinux(void* InMappingPtr, size_t InMappingSize, const uint8* InMappedPtr, int64 InMappedSize)
+		: IMappedFileRegion(InMappedPtr, InMappedSize)
+		, MappingPtr(InMappingPtr)
+		, MappingSize(InMappingSize)
+	{
+	}
+
+	virtual ~FMappedFileRegionLinux()
+	{
+		if (MappingPtr != nullptr)
+		{
+			munmap(MappingPtr, MappingSize);
+		}
+	}
+
+	virtual void PreloadHint(int64 PreloadOffset, int64 BytesToPreload) override
+	{
+		check(PreloadOffset >= 0 && PreloadOffset <= GetMappedSize());
+		if (BytesToPreload < 0 || BytesToPreload > GetMappedSize() - PreloadOffset)
+		{
+			BytesToPreload = GetMappedSize() - PreloadOffset;
+		}
+		if (BytesToPreload > 0)
+		{
+			// madvise needs a page aligned address, and only schedules the reads
+			const uint8* PreloadPtr = GetMappedPtr() + PreloadOffset;
+			const UPTRINT PageSize = FPlatformMemory::GetConstants().PageSize;
+			const UPTRINT AlignedPtr = (UPTRINT)PreloadPtr & ~(PageSize - 1);
+			madvise((void*)AlignedPtr, (UPTRINT)PreloadPtr - AlignedPtr + BytesToPreload, MADV_WILLNEED);
+		}
+	}
+};
+
+/**
+ * Linux memory mapped file handle implementation
+**/
+class FMappedFileHandleLinux : public IMappedFileHandle
+{
+	int32 FileHandle;
+
+public:
+	FMappedFileHandleLinux(int32 InFileHandle, int64 InFileSize)
+		: IMappedFileHandle(InFileSize)
+		, FileHandle(InFileHandle)
+	{
+	}
+
+	virtual ~FMappedFileHandleLinux()
+	{
+		close(FileHandle);
+	}
+
+	virtual IMappedFileRegion* MapRegion(int64 Offset, int64 BytesToMap, bool bPreloadHint) override
+	{
+		check(Offset >= 0 && Offset <= GetFileSize());
+		if (BytesToMap < 0 || BytesToMap > GetFileSize() - Offset)
+		{
+			BytesToMap = GetFileSize() - Offset;
+		}
+		if (BytesToMap == 0)
+		{
+			// mmap refuses empty mappings
+			return new FMappedFileRegionLinux(nullptr, 0, nullptr, 0);
+		}
+
+		// the mapping has to start at a page boundary
+		const int64 PageSize = FPlatformMemory::GetConstants().PageSize;
+		const int64 MappingOffset = Offset & ~(PageSize - 1);
+		const int64 MappingSize = Offset - MappingOffset + BytesToMap;
+		if ((int64)(size_t)MappingSize != MappingSize)
+		{
+			return nullptr;
+		}
+
+		// shared read-only file mappings use the page cache directly, so all processes mapping the file share its pages
+		void* MappingPtr = mmap(NULL, (size_t)MappingSize, PROT_READ, MAP_SHARED, FileHandle, MappingOffset);
+		if (MappingPtr == MAP_FAILED)
+		{
+			UE_LOG(LogLinuxPlatformFile, Warning, TEXT("mmap(length=%lld, offset=%lld) failed: errno=%d (%s)"), MappingSize, MappingOffset, errno, ANSI_TO_TCHAR(strerror(errno)));
+			return nullptr;
+		}
+
+		FMappedFileRegionLinux* Region = new FMappedFileRegionLinux(MappingPtr, (size_t)MappingSize, (const uint8*)MappingPtr + (Offset - MappingOffset), BytesToMap);
+		if (bPreloadHint)
+		{
+			Region->PreloadHint(0, BytesToMap);
+		}
+		return Region;
+	}
+};
+
 /**
  * Linux File I/O implementation
 **/
@@ -246,6 +348,27 @@ IFileHandle* FLinuxPlatformFile::OpenRead(const TCHAR* Filename)
 	return NULL;
 }
 
+IMappedFileHandle* FLinuxPlatformFile::OpenMapped(const TCHAR* Filename)
+{
+	int32 Handle = open(TCHAR_TO_UTF8(*NormalizeFilename(Filename)), O_RDONLY);
+	if (Handle == -1)
+	{
+		// log non-standard errors only
+		if (ENOENT != errno)
+		{
+			UE_LOG(LogLinuxPlatformFile, Warning, TEXT( "open('%s', ORDONLY) failed: errno=%d (%s)" ), *NormalizeFilename(Filename), errno, ANSI_TO_TCHAR(strerror(errno)));
+		}
+		return NULL;
+	}
+	struct stat FileInfo;
+	if (fstat(Handle, &FileInfo) == -1 || !S_ISREG(FileInfo.st_mode))
+	{
+		close(Handle);
+		return NULL;
+	}
+	return new FMappedFileHandleLinux(Handle, FileInfo.st_size);
+}
+
 IFileHandle* FLinuxPlatformFile::OpenWrite(const TCHAR* Filename, bool bAppend, bool bAllowRead)
 {
 	int Flags = O_CREAT | O_CLOEXEC;	// prevent children from inheriting this
@@ -61,6 +61,372 @@ bool appUncompressMemoryZLIB( void* UncompressedBuffer, int32 UncompressedSize,
 	return bOperationSucceeded;
 }
 
+/*-----------------------------------------------------------------------------
+	LZ4.
+-----------------------------------------------------------------------------*/
+
+/** Number of bits of the hash table used to find matches. */
+#define LZ4_HASH_BITS 12
+
+/** Minimum length of a match. */
+#define LZ4_MIN_MATCH 4
+
+/** Maximum distance of a match. */
+#define LZ4_MAX_OFFSET 65535
+
+/** The last match must start this many bytes before the end of a block. */
+#define LZ4_MATCH_SAFE_DISTANCE 12
+
+/** The last bytes of a block are always literals. */
+#define LZ4_LAST_LITERALS 5
+
+static FORCEINLINE uint32 LZ4Read32( const uint8* Ptr )
+{
+	uint32 Value;
+	FMemory::Memcpy(&Value, Ptr, sizeof(Value));
+	return Value;
+}
+
+static FORCEINLINE uint32 LZ4Hash( uint32 Sequence )
+{
+	return (Sequence * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+/** Writes the extra bytes of a literal or match length that doesn't fit into its token nibble. */
+static FORCEINLINE uint8* LZ4WriteLength( uint8* Dest, int32 Length )
+{
+	for (; Length >= 255; Length -= 255)
+	{
+		*Dest++ = 255;
+	}
+	*Dest++ = (uint8)Length;
+	return Dest;
+}
+
+/** Writes a sequence of literals, optionally followed by a match. Returns nullptr if the destination is too small. */
+static uint8* LZ4WriteSequence( uint8* Dest, uint8* DestEnd, const uint8* Literals, int32 LiteralLength, int32 Offset, int32 MatchLength )
+{
+	// worst case size of the token, lengths, literals and offset
+	if (DestEnd - Dest < 1 + LiteralLength + LiteralLength / 255 + 1 + 2 + MatchLength / 255 + 1)
+	{
+		return nullptr;
+	}
+
+	uint8* Token = Dest++;
+	*Token = (uint8)(FMath::Min(LiteralLength, 15) << 4);
+	if (LiteralLength >= 15)
+	{
+		Dest = LZ4WriteLength(Dest, LiteralLength - 15);
+	}
+	FMemory::Memcpy(Dest, Literals, LiteralLength);
+	Dest += LiteralLength;
+
+	if (MatchLength > 0)
+	{
+		*Dest++ = (uint8)Offset;
+		*Dest++ = (uint8)(Offset >> 8);
+
+		const int32 MatchCode = MatchLength - LZ4_MIN_MATCH;
+		*Token |= (uint8)FMath::Min(MatchCode, 15);
+		if (MatchCode >= 15)
+		{
+			Dest = LZ4WriteLength(Dest, MatchCode - 15);
+		}
+	}
+
+	return Dest;
+}
+
+/**
+ * Thread-safe LZ4 compression routine. Writes the LZ4 block format with a greedy single probe match finder,
+ * which trades compression ratio for speed like the reference fast mode does.
+ *
+ * @param	CompressedBuffer			Buffer compressed data is going to be written to
+ * @param	CompressedSize	[in/out]	Size of CompressedBuffer, at exit will be size of compressed data
+ * @param	UncompressedBuffer			Buffer containing uncompressed data
+ * @param	UncompressedSize			Size of uncompressed data in bytes
+ * @return true if compression succeeds, false if it fails because CompressedBuffer was too small
+ */
+DECLARE_CYCLE_STAT(TEXT("Compress Memory LZ4"),Stat_appCompressMemoryLZ4,STATGROUP_Engine);
+
+static bool appCompressMemoryLZ4( void* CompressedBuffer, int32& CompressedSize, const void* UncompressedBuffer, int32 UncompressedSize )
+{
+	SCOPE_CYCLE_COUNTER( Stat_appCompressMemoryLZ4 );
+
+	const uint8* Src = (const uint8*)UncompressedBuffer;
+	uint8* Dest = (uint8*)CompressedBuffer;
+	uint8* DestEnd = Dest + CompressedSize;
+	int32 Anchor = 0;
+
+	if (UncompressedSize > LZ4_MATCH_SAFE_DISTANCE)
+	{
+		int32 HashTable[1 << LZ4_HASH_BITS];
+		FMemory::Memset(HashTable, 0xFF, sizeof(HashTable));
+
+		const int32 MatchStartLimit = UncompressedSize - LZ4_MATCH_SAFE_DISTANCE;
+		int32 Pos = 0;
+
+		while (Pos < MatchStartLimit)
+		{
+			const uint32 Sequence = LZ4Read32(Src + Pos);
+			const uint32 Hash = LZ4Hash(Sequence);
+			const int32 Candidate = HashTable[Hash];
+			HashTable[Hash] = Pos;
+
+			if ((Candidate < 0) || (Pos - Candidate > LZ4_MAX_OFFSET) || (LZ4Read32(Src + Candidate) != Sequence))
+			{
+				// skip faster through data that doesn't compress
+				Pos += 1 + ((Pos - Anchor) >> 6);
+				continue;
+			}
+
+			const int32 MaxMatchLength = UncompressedSize - LZ4_LAST_LITERALS - Pos;
+			int32 MatchLength = LZ4_MIN_MATCH;
+			while ((MatchLength < MaxMatchLength) && (Src[Candidate + MatchLength] == Src[Pos + MatchLength]))
+			{
+				++MatchLength;
+			}
+
+			Dest = LZ4WriteSequence(Dest, DestEnd, Src + Anchor, Pos - Anchor, Pos - Candidate, MatchLength);
+			if (Dest == nullptr)
+			{
+				return false;
+			}
+
+			Pos += MatchLength;
+			Anchor = Pos;
+		}
+	}
+
+	Dest = LZ4WriteSequence(Dest, DestEnd, Src + Anchor, UncompressedSize - Anchor, 0, 0);
+	if (Dest == nullptr)
+	{
+		return false;
+	}
+
+	CompressedSize = (int32)(Dest - (uint8*)CompressedBuffer);
+	return true;
+}
+
+/**
+ * Thread-safe LZ4 decompression routine. The compressed data is validated, so corrupt data fails instead
+ * of reading or writing outside of the buffers.
+ *
+ * @param	UncompressedBuffer			Buffer containing uncompressed data
+ * @param	UncompressedSize			Size of uncompressed data in bytes
+ * @param	CompressedBuffer			Buffer compressed data is going to be read from
+ * @param	CompressedSize				Size of CompressedBuffer data in bytes
+ * @return true if decompression succeeds and yields exactly UncompressedSize bytes, false otherwise
+ */
+DECLARE_CYCLE_STAT(TEXT("Uncompress Memory LZ4"),Stat_appUncompressMemoryLZ4,STATGROUP_Engine);
+
+static bool appUncompressMemoryLZ4( void* UncompressedBuffer, int32 UncompressedSize, const void* CompressedBuffer, int32 CompressedSize )
+{
+	SCOPE_CYCLE_COUNTER( Stat_appUncompressMemoryLZ4 );
+
+	const uint8* Src = (const uint8*)CompressedBuffer;
+	const uint8* SrcEnd = Src + CompressedSize;
+	uint8* Dest = (uint8*)UncompressedBuffer;
+	uint8* DestEnd = Dest + UncompressedSize;
+
+	while (Src < SrcEnd)
+	{
+		const uint8 Token = *Src++;
+
+		// literals
+		int32 LiteralLength = Token >> 4;
+		if (LiteralLength == 15)
+		{
+			uint8 Byte;
+			do
+			{
+				if ((Src == SrcEnd) || (LiteralLength > CompressedSize))
+				{
+					return false;
+				}
+				Byte = *Src++;
+				LiteralLength += Byte;
+			}
+			while (Byte == 255);
+		}
+
+		if ((LiteralLength > SrcEnd - Src) || (LiteralLength > DestEnd - Dest))
+		{
+			return false;
+		}
+
+		FMemory::Memcpy(Dest, Src, LiteralLength);
+		Src += LiteralLength;
+		Dest += LiteralLength;
+
+		// the last sequence has no match
+		if (Src == SrcEnd)
+		{
+			break;
+		}
+
+		// match
+		if (SrcEnd - Src < 2)
+		{
+			return false;
+		}
+
+		const int32 Offset = Src[0] | (Src[1] << 8);
+		Src += 2;
+
+		if ((Offset == 0) || (Offset > Dest - (uint8*)UncompressedBuffer))
+		{
+			return false;
+		}
+
+		int32 MatchLength = Token & 15;
+		if (MatchLength == 15)
+		{
+			uint8 Byte;
+			do
+			{
+				if ((Src == SrcEnd) || (MatchLength > UncompressedSize))
+				{
+					return false;
+				}
+				Byte = *Src++;
+				MatchLength += Byte;
+			}
+			while (Byte == 255);
+		}
+		MatchLength += LZ4_MIN_MATCH;
+
+		if (MatchLength > DestEnd - Dest)
+		{
+			return false;
+		}
+
+		const uint8* Match = Dest - Offset;
+		if (Offset >= MatchLength)
+		{
+			FMemory::Memcpy(Dest, Match, MatchLength);
+			Dest += MatchLength;
+		}
+		else
+		{
+			// overlapping matches repeat the last Offset bytes
+			for (uint8* MatchEnd = Dest + MatchLength; Dest < MatchEnd; ++Dest, ++Match)
+			{
+				*Dest = *Match;
+			}
+		}
+	}
+
+	return (Dest == DestEnd);
+}
+
+/*-----------------------------------------------------------------------------
+	Codec registry.
+-----------------------------------------------------------------------------*/
+
+/** Codec for COMPRESS_ZLIB. */
+class FZlibCompressionCodec : public ICompressionCodec
+{
+public:
+	virtual const TCHAR* GetName() const override
+	{
+		return TEXT("ZLIB");
+	}
+
+	virtual int32 CompressMemoryBound( int32 UncompressedSize ) const override
+	{
+		return compressBound(UncompressedSize);
+	}
+
+	virtual bool CompressMemory( ECompressionFlags Flags, void* CompressedBuffer, int32& CompressedSize, const void* UncompressedBuffer, int32 UncompressedSize ) const override
+	{
+		return appCompressMemoryZLIB(CompressedBuffer, CompressedSize, UncompressedBuffer, UncompressedSize);
+	}
+
+	virtual bool UncompressMemory( void* UncompressedBuffer, int32 UncompressedSize, const void* CompressedBuffer, int32 CompressedSize ) const override
+	{
+		return appUncompressMemoryZLIB(UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize);
+	}
+};
+
+/** Codec for COMPRESS_LZ4. */
+class FLZ4CompressionCodec : public ICompressionCodec
+{
+public:
+	virtual const TCHAR* GetName() const override
+	{
+		return TEXT("LZ4");
+	}
+
+	virtual int32 CompressMemoryBound( int32 UncompressedSize ) const override
+	{
+		return UncompressedSize + UncompressedSize / 255 + 16;
+	}
+
+	virtual bool CompressMemory( ECompressionFlags Flags, void* CompressedBuffer, int32& CompressedSize, const void* UncompressedBuffer, int32 UncompressedSize ) const override
+	{
+		return appCompressMemoryLZ4(CompressedBuffer, CompressedSize, UncompressedBuffer, UncompressedSize);
+	}
+
+	virtual bool UncompressMemory( void* UncompressedBuffer, int32 UncompressedSize, const void* CompressedBuffer, int32 CompressedSize ) const override
+	{
+		return appUncompressMemoryLZ4(UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize);
+	}
+};
+
+static FZlibCompressionCodec GZlibCompressionCodec;
+static FLZ4CompressionCodec GLZ4CompressionCodec;
+
+/** Registered codecs, indexed by compression type. */
+static ICompressionCodec* GCompressionCodecs[COMPRESSION_FLAGS_TYPE_MASK + 1] =
+{
+	nullptr,
+	&GZlibCompressionCodec,
+	&GLZ4CompressionCodec,
+};
+
+bool FCompression::RegisterCodec( ECompressionFlags CompressionType, ICompressionCodec* Codec )
+{
+	check(Codec != nullptr);
+
+	if ((CompressionType == COMPRESS_None) || (CompressionType & ~COMPRESSION_FLAGS_TYPE_MASK))
+	{
+		UE_LOG(LogCompression, Warning, TEXT("FCompression::RegisterCodec - Invalid compression type %d for codec %s"), (int32)CompressionType, Codec->GetName());
+		return false;
+	}
+
+	if (GCompressionCodecs[CompressionType] != nullptr)
+	{
+		UE_LOG(LogCompression, Warning, TEXT("FCompression::RegisterCodec - Compression type %d is already used by codec %s"), (int32)CompressionType, GCompressionCodecs[CompressionType]->GetName());
+		return false;
+	}
+
+	GCompressionCodecs[CompressionType] = Codec;
+	return true;
+}
+
+void FCompression::UnregisterCodec( ECompressionFlags CompressionType )
+{
+	GCompressionCodecs[CompressionType & COMPRESSION_FLAGS_TYPE_MASK] = nullptr;
+}
+
+ICompressionCodec* FCompression::GetCodec( ECompressionFlags Flags )
+{
+	return GCompressionCodecs[Flags & COMPRESSION_FLAGS_TYPE_MASK];
+}
+
+ECompressionFlags FCompression::GetCompressionTypeFromName( const TCHAR* Name )
+{
+	for (int32 CompressionType = 0; CompressionType <= COMPRESSION_FLAGS_TYPE_MASK; CompressionType++)
+	{
+		if ((GCompressionCodecs[CompressionType] != nullptr) && (FCString::Stricmp(GCompressionCodecs[CompressionType]->GetName(), Name) == 0))
+		{
+			return (ECompressionFlags)CompressionType;
+		}
+	}
+	return COMPRESS_None;
+}
+
 /** Time spent compressing data in seconds. */
 double FCompression::CompressorTime		= 0;
 /** Number of bytes before compression.		*/
@@ -105,17 +471,12 @@ int32 FCompression::CompressMemoryBound( ECompressionFlags Flags, int32 Uncompre
 {
 	int32 CompressionBound = UncompressedSize;
 	// make sure a valid compression scheme was provided
-	check(Flags & COMPRESS_ZLIB);
+	ICompressionCodec* Codec = GetCodec(Flags);
+	checkf(Codec != nullptr, TEXT("No codec registered for compression flags %d"), (int32)Flags);
 
-	Flags = CheckGlobalCompressionFlags(Flags);
-
-	switch(Flags & COMPRESSION_FLAGS_TYPE_MASK)
+	if (Codec != nullptr)
 	{
-	case COMPRESS_ZLIB:
-		CompressionBound = compressBound(UncompressedSize);
-		break;
-	default:
-		break;
+		CompressionBound = Codec->CompressMemoryBound(UncompressedSize);
 	}
 
 	return CompressionBound;
@@ -137,20 +498,21 @@ bool FCompression::CompressMemory( ECompressionFlags Flags, void* CompressedBuff
 	double CompressorStartTime = FPlatformTime::Seconds();
 
 	// make sure a valid compression scheme was provided
-	check(Flags & COMPRESS_ZLIB);
+	ICompressionCodec* Codec = GetCodec(Flags);
+	checkf(Codec != nullptr, TEXT("No codec registered for compression flags %d"), (int32)Flags);
 
 	bool bCompressSucceeded = false;
 
 	Flags = CheckGlobalCompressionFlags(Flags);
 
-	switch(Flags & COMPRESSION_FLAGS_TYPE_MASK)
+	if (Codec != nullptr)
 	{
-		case COMPRESS_ZLIB:
-			bCompressSucceeded = appCompressMemoryZLIB(CompressedBuffer, CompressedSize, UncompressedBuffer, UncompressedSize);
-			break;
-		default:
-			UE_LOG(LogCompression, Warning, TEXT("appCompressMemory - This compression type not supported"));
-			bCompressSucceeded =  false;
+		bCompressSucceeded = Codec->CompressMemory(Flags, CompressedBuffer, CompressedSize, UncompressedBuffer, UncompressedSize);
+	}
+	else
+	{
+		UE_LOG(LogCompression, Warning, TEXT("appCompressMemory - This compression type not supported"));
+		bCompressSucceeded =  false;
 	}
 
 	// Keep track of compression time and stats.
@@ -184,18 +546,19 @@ bool FCompression::UncompressMemory( ECompressionFlags Flags, void* Uncompressed
 	STAT(double UncompressorStartTime = FPlatformTime::Seconds();)
 	
 	// make sure a valid compression scheme was provided
-	check(Flags & COMPRESS_ZLIB);
+	ICompressionCodec* Codec = GetCodec(Flags);
+	checkf(Codec != nullptr, TEXT("No codec registered for compression flags %d"), (int32)Flags);
 
 	bool bUncompressSucceeded = false;
 
-	switch(Flags & COMPRESSION_FLAGS_TYPE_MASK)
+	if (Codec != nullptr)
 	{
-		case COMPRESS_ZLIB:
-			bUncompressSucceeded = appUncompressMemoryZLIB(UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize);
-			break;
-		default:
-			UE_LOG(LogCompression, Warning, TEXT("FCompression::UncompressMemory - This compression type not supported"));
-			bUncompressSucceeded = false;
+		bUncompressSucceeded = Codec->UncompressMemory(UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize);
+	}
+	else
+	{
+		UE_LOG(LogCompression, Warning, TEXT("FCompression::UncompressMemory - This compression type not supported"));
+		bUncompressSucceeded = false;
 	}
 	STAT(if (FThreadStats::IsThreadingReady()) { INC_FLOAT_STAT_BY(STAT_UncompressorTime,(float)(FPlatformTime::Seconds()-UncompressorStartTime))} );
 	
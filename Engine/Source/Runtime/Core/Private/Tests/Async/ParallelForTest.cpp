@@ -0,0 +1,74 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "CorePrivatePCH.h"
+#include "AutomationTest.h"
+#include "TaskGraphInterfaces.h"
+#include "ParallelFor.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParallelForTest, "Core.Async.ParallelFor", EAutomationTestFlags::ATF_SmokeTest)
+
+bool FParallelForTest::RunTest( const FString& Parameters )
+{
+	const int32 Num = 10000;
+
+	// every index is visited exactly once, with every set of flags
+	const uint32 FlagsToTest[] = { EParallelForFlags::None, EParallelForFlags::Unbalanced, EParallelForFlags::ForceSingleThread };
+	for (int32 FlagsIndex = 0; FlagsIndex < ARRAY_COUNT(FlagsToTest); FlagsIndex++)
+	{
+		TArray<int32> Visits;
+		Visits.AddZeroed(Num);
+
+		ParallelFor(Num, [&](int32 Index)
+		{
+			FPlatformAtomics::InterlockedIncrement(&Visits[Index]);
+		}, FlagsToTest[FlagsIndex]);
+
+		int32 NumBad = 0;
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			NumBad += Visits[Index] != 1 ? 1 : 0;
+		}
+		TestEqual(*FString::Printf(TEXT("Every index must be visited exactly once with flags %u"), FlagsToTest[FlagsIndex]), NumBad, 0);
+	}
+
+	// forcing a single thread runs in order on the calling thread
+	{
+		const uint32 CallingThreadId = FPlatformTLS::GetCurrentThreadId();
+		int32 NextIndex = 0;
+		bool bInOrderOnCallingThread = true;
+
+		ParallelFor(100, [&](int32 Index)
+		{
+			bInOrderOnCallingThread &= Index == NextIndex++ && FPlatformTLS::GetCurrentThreadId() == CallingThreadId;
+		}, EParallelForFlags::ForceSingleThread);
+
+		TestTrue(TEXT("ForceSingleThread must run every index in order on the calling thread"), bInOrderOnCallingThread);
+	}
+
+	// nested loops complete, even when every worker is busy in an outer iteration
+	{
+		const int32 NumOuter = FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads() * 2, 2);
+		const int32 NumInner = 1000;
+		FThreadSafeCounter NumInnerVisits;
+
+		ParallelFor(NumOuter, [&](int32 OuterIndex)
+		{
+			ParallelFor(NumInner, [&](int32 InnerIndex)
+			{
+				NumInnerVisits.Increment();
+			});
+		}, EParallelForFlags::Unbalanced);
+
+		TestEqual(TEXT("Nested loops must visit every inner index once per outer index"), NumInnerVisits.GetValue(), NumOuter * NumInner);
+	}
+
+	// empty loops don't call the body
+	{
+		bool bCalled = false;
+		ParallelFor(0, [&](int32 Index) { bCalled = true; });
+		TestTrue(TEXT("An empty loop must not call the body"), !bCalled);
+	}
+
+	return true;
+}
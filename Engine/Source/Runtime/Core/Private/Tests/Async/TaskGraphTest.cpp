@@ -0,0 +1,256 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "CorePrivatePCH.h"
+#include "AutomationTest.h"
+#include "TaskGraphInterfaces.h"
+#include "WorkStealingQueue.h"
+
+
+/** Steals from a work stealing queue until told to stop, marking every item it gets. */
+class FWorkStealingQueueTestThief : public FRunnable
+{
+public:
+	FWorkStealingQueueTestThief(TWorkStealingQueue<int32>& InQueue, FThreadSafeCounter& InStopCounter)
+		: Queue(InQueue)
+		, StopCounter(InStopCounter)
+		, NumStolen(0)
+	{ }
+
+	virtual uint32 Run() override
+	{
+		while (StopCounter.GetValue() == 0 || !Queue.IsEmpty())
+		{
+			int32* Item = Queue.Steal();
+			if (Item != NULL)
+			{
+				FPlatformAtomics::InterlockedIncrement(Item);
+				NumStolen++;
+			}
+		}
+		return 0;
+	}
+
+	TWorkStealingQueue<int32>& Queue;
+	FThreadSafeCounter& StopCounter;
+	int32 NumStolen;
+};
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWorkStealingQueueTest, "Core.Async.WorkStealingQueue", EAutomationTestFlags::ATF_SmokeTest)
+
+bool FWorkStealingQueueTest::RunTest( const FString& Parameters )
+{
+	int32 Items[4] = { 0, 1, 2, 3 };
+
+	// owner pops in LIFO order, thieves steal in FIFO order
+	{
+		TWorkStealingQueue<int32> Queue(2);
+
+		TestTrue(TEXT("A new queue must be empty"), Queue.IsEmpty());
+		TestNull(TEXT("Pop must fail on an empty queue"), Queue.Pop());
+		TestNull(TEXT("Steal must fail on an empty queue"), Queue.Steal());
+
+		for (int32 Index = 0; Index < ARRAY_COUNT(Items); Index++)
+		{
+			Queue.Push(&Items[Index]);
+		}
+
+		TestEqual(TEXT("Steal must return the oldest item"), Queue.Steal(), &Items[0]);
+		TestEqual(TEXT("Pop must return the newest item"), Queue.Pop(), &Items[3]);
+		TestEqual(TEXT("Steal must return the oldest item"), Queue.Steal(), &Items[1]);
+		TestEqual(TEXT("Pop must return the last item"), Queue.Pop(), &Items[2]);
+		TestTrue(TEXT("After removing all items, the queue must be empty"), Queue.IsEmpty());
+		TestNull(TEXT("Pop must fail after removing all items"), Queue.Pop());
+	}
+
+	// every item is taken exactly once with thieves racing the owner, while the queue grows
+	if (FPlatformProcess::SupportsMultithreading())
+	{
+		const int32 NumItems = 1 << 18;
+		const int32 NumThieves = 3;
+
+		TArray<int32> Taken;
+		Taken.AddZeroed(NumItems);
+
+		TWorkStealingQueue<int32> Queue(16);
+		FThreadSafeCounter StopCounter;
+
+		TArray<FWorkStealingQueueTestThief*> Thieves;
+		TArray<FRunnableThread*> Threads;
+		for (int32 Index = 0; Index < NumThieves; Index++)
+		{
+			Thieves.Add(new FWorkStealingQueueTestThief(Queue, StopCounter));
+			Threads.Add(FRunnableThread::Create(Thieves[Index], *FString::Printf(TEXT("WorkStealingQueueTestThief %d"), Index)));
+		}
+
+		int32 NumPopped = 0;
+		for (int32 Index = 0; Index < NumItems; Index++)
+		{
+			Queue.Push(&Taken[Index]);
+
+			// pop every third push, so the owner regularly races the thieves for the last item
+			if (Index % 3 == 0)
+			{
+				int32* Item = Queue.Pop();
+				if (Item != NULL)
+				{
+					FPlatformAtomics::InterlockedIncrement(Item);
+					NumPopped++;
+				}
+			}
+		}
+
+		StopCounter.Increment();
+
+		int32 NumStolen = 0;
+		for (int32 Index = 0; Index < NumThieves; Index++)
+		{
+			Threads[Index]->WaitForCompletion();
+			NumStolen += Thieves[Index]->NumStolen;
+			delete Threads[Index];
+			delete Thieves[Index];
+		}
+
+		int32 NumBad = 0;
+		for (int32 Index = 0; Index < NumItems; Index++)
+		{
+			NumBad += Taken[Index] != 1 ? 1 : 0;
+		}
+
+		TestEqual(TEXT("Every item must be taken exactly once"), NumBad, 0);
+		TestEqual(TEXT("Items popped and stolen must add up to items pushed"), NumPopped + NumStolen, NumItems);
+	}
+
+	return true;
+}
+
+
+/** State shared by the tasks of a throughput run. */
+struct FTaskGraphThroughputRun
+{
+	FThreadSafeCounter NumRemaining;
+	FEvent* DoneEvent;
+};
+
+/** A task that does nothing but count itself done. */
+class FTaskGraphThroughputLeafTask
+{
+public:
+	FTaskGraphThroughputLeafTask(FTaskGraphThroughputRun& InRun)
+		: Run(InRun)
+	{ }
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FTaskGraphThroughputLeafTask, STATGROUP_TaskGraphTasks);
+	}
+
+	static ENamedThreads::Type GetDesiredThread() { return ENamedThreads::AnyThread; }
+	static ESubsequentsMode::Type GetSubsequentsMode() { return ESubsequentsMode::FireAndForget; }
+
+	void DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+	{
+		if (Run.NumRemaining.Decrement() == 0)
+		{
+			Run.DoneEvent->Trigger();
+		}
+	}
+
+private:
+	FTaskGraphThroughputRun& Run;
+};
+
+/** A task that spawns leaf tasks from a worker thread, which is what the work stealing deques are for. */
+class FTaskGraphThroughputSpawnerTask
+{
+public:
+	FTaskGraphThroughputSpawnerTask(FTaskGraphThroughputRun& InRun, int32 InNumTasks)
+		: Run(InRun)
+		, NumTasks(InNumTasks)
+	{ }
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FTaskGraphThroughputSpawnerTask, STATGROUP_TaskGraphTasks);
+	}
+
+	static ENamedThreads::Type GetDesiredThread() { return ENamedThreads::AnyThread; }
+	static ESubsequentsMode::Type GetSubsequentsMode() { return ESubsequentsMode::FireAndForget; }
+
+	void DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+	{
+		for (int32 Index = 0; Index < NumTasks; Index++)
+		{
+			TGraphTask<FTaskGraphThroughputLeafTask>::CreateTask(NULL, CurrentThread).ConstructAndDispatchWhenReady(Run);
+		}
+	}
+
+private:
+	FTaskGraphThroughputRun& Run;
+	int32 NumTasks;
+};
+
+
+/**
+ * Measures how many tasks per second the task graph spawns and completes, with 1 to 64 spawner tasks each
+ * dispatching small tasks from worker threads at the same time, with and without TaskGraph.WorkStealing.
+ * The results are in the test log.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTaskGraphThroughputTest, "Core.Async.TaskGraphThroughput", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game | EAutomationTestFlags::ATF_Commandlet)
+
+bool FTaskGraphThroughputTest::RunTest( const FString& Parameters )
+{
+	const int32 NumTasksPerRun = 1 << 18;
+	const int32 NumRunsPerConfig = 3;
+
+	IConsoleVariable* WorkStealingVar = IConsoleManager::Get().FindConsoleVariable(TEXT("TaskGraph.WorkStealing"));
+	if (!WorkStealingVar)
+	{
+		AddError(TEXT("TaskGraph.WorkStealing is not registered"));
+		return false;
+	}
+	const int32 OldWorkStealing = WorkStealingVar->GetInt();
+
+	AddLogItem(FString::Printf(TEXT("%d worker threads, %d tasks per run, best of %d runs"), FTaskGraphInterface::Get().GetNumWorkerThreads(), NumTasksPerRun, NumRunsPerConfig));
+	AddLogItem(TEXT("Spawners, Shared queue (tasks/s), Work stealing (tasks/s)"));
+
+	FTaskGraphThroughputRun Run;
+	Run.DoneEvent = FPlatformProcess::CreateSynchEvent(true);
+
+	for (int32 NumSpawners = 1; NumSpawners <= 64; NumSpawners *= 2)
+	{
+		double TasksPerSecond[2] = { 0.0, 0.0 };
+
+		for (int32 WorkStealing = 0; WorkStealing < 2; WorkStealing++)
+		{
+			WorkStealingVar->Set(WorkStealing ? TEXT("1") : TEXT("0"));
+
+			for (int32 RunIndex = 0; RunIndex < NumRunsPerConfig; RunIndex++)
+			{
+				const int32 NumTasksPerSpawner = NumTasksPerRun / NumSpawners;
+
+				Run.NumRemaining.Set(NumTasksPerSpawner * NumSpawners);
+				Run.DoneEvent->Reset();
+
+				const double StartTime = FPlatformTime::Seconds();
+
+				for (int32 Index = 0; Index < NumSpawners; Index++)
+				{
+					TGraphTask<FTaskGraphThroughputSpawnerTask>::CreateTask().ConstructAndDispatchWhenReady(Run, NumTasksPerSpawner);
+				}
+
+				Run.DoneEvent->Wait();
+
+				const double ElapsedTime = FMath::Max(FPlatformTime::Seconds() - StartTime, 0.000001);
+				TasksPerSecond[WorkStealing] = FMath::Max(TasksPerSecond[WorkStealing], (NumTasksPerSpawner * NumSpawners) / ElapsedTime);
+			}
+		}
+
+		AddLogItem(FString::Printf(TEXT("%d, %.0f, %.0f"), NumSpawners, TasksPerSecond[0], TasksPerSecond[1]));
+	}
+
+	WorkStealingVar->Set(*FString::FromInt(OldWorkStealing));
+	delete Run.DoneEvent;
+
+	return true;
+}
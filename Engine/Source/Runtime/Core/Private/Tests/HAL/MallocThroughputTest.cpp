@@ -0,0 +1,184 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "CorePrivatePCH.h"
+#include "AutomationTest.h"
+#include "MallocBinned.h"
+#include "MallocJemalloc.h"
+#include "MallocTBB.h"
+
+
+/** Allocates and frees small blocks of random sizes from one allocator, keeping a window of blocks alive. */
+class FMallocThroughputTestWorker : public FRunnable
+{
+public:
+	FMallocThroughputTestWorker(FMalloc* InAllocator, bool bInUseThreadCaches, int32 InNumAllocs, int32 InSeed, FThreadSafeCounter& InNumReady, FEvent* InStartEvent)
+		: Allocator(InAllocator)
+		, bUseThreadCaches(bInUseThreadCaches)
+		, NumAllocs(InNumAllocs)
+		, Seed(InSeed)
+		, NumReady(InNumReady)
+		, StartEvent(InStartEvent)
+	{ }
+
+	virtual uint32 Run() override
+	{
+		const int32 NumLive = 256;
+		void* Live[NumLive] = { 0 };
+		FRandomStream Random(Seed);
+
+		if (bUseThreadCaches)
+		{
+			Allocator->SetupTLSCachesOnCurrentThread();
+		}
+
+		NumReady.Increment();
+		StartEvent->Wait();
+
+		for (int32 Index = 0; Index < NumAllocs; Index++)
+		{
+			// mostly tiny blocks, like strings and array growth, with the occasional bigger one
+			const int32 Size = Random.FRand() < 0.9f ? Random.RandRange(8, 128) : Random.RandRange(129, 4096);
+			void*& Slot = Live[Index % NumLive];
+
+			Allocator->Free(Slot);
+			Slot = Allocator->Malloc(Size, DEFAULT_ALIGNMENT);
+			*(uint8*)Slot = 0;
+		}
+
+		for (int32 Index = 0; Index < NumLive; Index++)
+		{
+			Allocator->Free(Live[Index]);
+		}
+
+		// also done for GMalloc when the thread exits, but this might be another allocator
+		Allocator->ClearAndDisableTLSCachesOnCurrentThread();
+		return 0;
+	}
+
+private:
+	FMalloc* Allocator;
+	bool bUseThreadCaches;
+	int32 NumAllocs;
+	int32 Seed;
+	FThreadSafeCounter& NumReady;
+	FEvent* StartEvent;
+};
+
+
+/**
+ * Measures how many small allocations per second an allocator serves with 1 to 32 threads allocating at the same
+ * time. Compares the binned allocator with and without thread caches, and jemalloc and TBB where they are compiled in.
+ * Each allocator is a separate instance from GMalloc. The results are in the test log.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMallocThroughputTest, "Core.HAL.MallocThroughput", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game | EAutomationTestFlags::ATF_Commandlet)
+
+bool FMallocThroughputTest::RunTest( const FString& Parameters )
+{
+	if (!FPlatformProcess::SupportsMultithreading())
+	{
+		AddLogItem(TEXT("Skipped, the platform doesn't support multithreading"));
+		return true;
+	}
+
+	struct FAllocatorConfig
+	{
+		const TCHAR* Name;
+		FMalloc* Allocator;
+		bool bUseThreadCaches;
+	};
+
+	// allocators are never destroyed, threads of other tests may still have blocks from them
+	static FMalloc* Binned = new FMallocBinned((uint32)(FPlatformMemory::GetConstants().PageSize & MAX_uint32), 0x100000000);
+	TArray<FAllocatorConfig> Configs;
+	{
+		FAllocatorConfig Config = { TEXT("Binned"), Binned, false };
+		Configs.Add(Config);
+	}
+	{
+		FAllocatorConfig Config = { TEXT("Binned thread caches"), Binned, true };
+		Configs.Add(Config);
+	}
+#if PLATFORM_SUPPORTS_JEMALLOC
+	{
+		static FMalloc* Jemalloc = new FMallocJemalloc();
+		FAllocatorConfig Config = { TEXT("Jemalloc"), Jemalloc, false };
+		Configs.Add(Config);
+	}
+#endif
+#if PLATFORM_SUPPORTS_TBB && TBB_ALLOCATOR_ALLOWED
+	{
+		static FMalloc* TBB = new FMallocTBB();
+		FAllocatorConfig Config = { TEXT("TBB"), TBB, false };
+		Configs.Add(Config);
+	}
+#endif
+
+	const int32 NumAllocsPerRun = 1 << 22;
+	const int32 NumRunsPerConfig = 3;
+
+	FString Header = TEXT("Threads");
+	for (int32 ConfigIndex = 0; ConfigIndex < Configs.Num(); ConfigIndex++)
+	{
+		Header += FString::Printf(TEXT(", %s (allocs/s)"), Configs[ConfigIndex].Name);
+	}
+	AddLogItem(FString::Printf(TEXT("%d allocations per run, best of %d runs"), NumAllocsPerRun, NumRunsPerConfig));
+	AddLogItem(Header);
+
+	FEvent* StartEvent = FPlatformProcess::CreateSynchEvent(true);
+
+	for (int32 NumThreads = 1; NumThreads <= 32; NumThreads *= 2)
+	{
+		FString Row = FString::FromInt(NumThreads);
+
+		for (int32 ConfigIndex = 0; ConfigIndex < Configs.Num(); ConfigIndex++)
+		{
+			const FAllocatorConfig& Config = Configs[ConfigIndex];
+			const int32 NumAllocsPerThread = NumAllocsPerRun / NumThreads;
+			double AllocsPerSecond = 0.0;
+
+			for (int32 RunIndex = 0; RunIndex < NumRunsPerConfig; RunIndex++)
+			{
+				FThreadSafeCounter NumReady;
+				StartEvent->Reset();
+
+				TArray<FMallocThroughputTestWorker*> Workers;
+				TArray<FRunnableThread*> Threads;
+				for (int32 Index = 0; Index < NumThreads; Index++)
+				{
+					Workers.Add(new FMallocThroughputTestWorker(Config.Allocator, Config.bUseThreadCaches, NumAllocsPerThread, Index + 1, NumReady, StartEvent));
+					Threads.Add(FRunnableThread::Create(Workers[Index], *FString::Printf(TEXT("MallocThroughputTestWorker %d"), Index)));
+				}
+
+				while (NumReady.GetValue() < NumThreads)
+				{
+					FPlatformProcess::Sleep(0.0f);
+				}
+
+				const double StartTime = FPlatformTime::Seconds();
+				StartEvent->Trigger();
+
+				for (int32 Index = 0; Index < NumThreads; Index++)
+				{
+					Threads[Index]->WaitForCompletion();
+				}
+
+				const double ElapsedTime = FMath::Max(FPlatformTime::Seconds() - StartTime, 0.000001);
+				AllocsPerSecond = FMath::Max(AllocsPerSecond, (NumAllocsPerThread * NumThreads) / ElapsedTime);
+
+				for (int32 Index = 0; Index < NumThreads; Index++)
+				{
+					delete Threads[Index];
+					delete Workers[Index];
+				}
+			}
+
+			Row += FString::Printf(TEXT(", %.0f"), AllocsPerSecond);
+		}
+
+		AddLogItem(Row);
+	}
+
+	delete StartEvent;
+
+	return true;
+}
@@ -5,6 +5,36 @@
 #include "Misc/AutomationTest.h"
 
 
+/** Enqueues a sequence of increasing values, spinning while the queue is full. */
+class FCircularQueueTestProducer : public FRunnable
+{
+public:
+
+	FCircularQueueTestProducer( TCircularQueue<uint32>& InQueue, uint32 InNumValues )
+		: Queue(InQueue)
+		, NumValues(InNumValues)
+	{ }
+
+	virtual uint32 Run( ) override
+	{
+		for (uint32 Value = 0; Value < NumValues; ++Value)
+		{
+			while (!Queue.Enqueue(Value))
+			{
+				FPlatformProcess::Sleep(0.0f);
+			}
+		}
+
+		return 0;
+	}
+
+private:
+
+	TCircularQueue<uint32>& Queue;
+	uint32 NumValues;
+};
+
+
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCircularQueueTest, "Core.Misc.CircularQueue", EAutomationTestFlags::ATF_SmokeTest)
 
 bool FCircularQueueTest::RunTest( const FString& Parameters )
@@ -28,6 +58,7 @@ bool FCircularQueueTest::RunTest( const FString& Parameters )
 		TestFalse(TEXT("Partially filled queues must not be empty"), Queue.IsEmpty());
 		TestFalse(TEXT("Partially filled queues must not be full"), Queue.IsFull());
 		TestTrue(TEXT("Peeking at a partially filled queue must succeed"), Queue.Peek(Value));
+		TestEqual(TEXT("Partially filled queues must count their items"), Queue.Count(), 1u);
 	}
 
 	// full queue
@@ -41,6 +72,7 @@ bool FCircularQueueTest::RunTest( const FString& Parameters )
 
 		TestFalse(TEXT("Full queues must not be empty"), Queue.IsEmpty());
 		TestTrue(TEXT("Full queues must be full"), Queue.IsFull());
+		TestEqual(TEXT("Full queues must count every item"), Queue.Count(), QueueSize - 1);
 		TestFalse(TEXT("Adding to full queue must fail"), Queue.Enqueue(666));
 
 		int32 Value = 0;
@@ -57,5 +89,44 @@ bool FCircularQueueTest::RunTest( const FString& Parameters )
 		TestFalse(TEXT("A queue that had all items removed must not be full"), Queue.IsFull());
 	}
 
+	// one producer and one consumer thread
+	if (FPlatformProcess::SupportsMultithreading())
+	{
+		const uint32 NumValues = 1000000;
+
+		TCircularQueue<uint32> Queue(QueueSize);
+		FCircularQueueTestProducer Producer(Queue, NumValues);
+		FRunnableThread* ProducerThread = FRunnableThread::Create(&Producer, TEXT("CircularQueueTestProducer"));
+
+		uint32 NumOutOfOrder = 0;
+		uint32 NumPeekMismatches = 0;
+		uint32 Expected = 0;
+
+		while (Expected < NumValues)
+		{
+			uint32 Peeked = 0;
+			uint32 Value = 0;
+
+			if (!Queue.Peek(Peeked))
+			{
+				FPlatformProcess::Sleep(0.0f);
+				continue;
+			}
+
+			Queue.Dequeue(Value);
+
+			NumPeekMismatches += (Peeked != Value) ? 1 : 0;
+			NumOutOfOrder += (Value != Expected) ? 1 : 0;
+			Expected = Value + 1;
+		}
+
+		ProducerThread->WaitForCompletion();
+		delete ProducerThread;
+
+		TestEqual(TEXT("Values must be dequeued in the order they were enqueued"), NumOutOfOrder, 0u);
+		TestEqual(TEXT("Peeking must return the value that is dequeued next"), NumPeekMismatches, 0u);
+		TestTrue(TEXT("The queue must be empty after the consumer caught up"), Queue.IsEmpty());
+	}
+
 	return true;
 }
@@ -0,0 +1,120 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "CorePrivatePCH.h"
+#include "AutomationTest.h"
+
+
+/**
+ * Compares the compression ratio and the compression and decompression speed of all registered codecs on cooked
+ * content, using 64KB blocks like UnrealPak does. Cooked content of the game is used if there is any, the content
+ * directories otherwise. Decompressed data is verified against the original. The results are in the test log.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCompressionBenchmark, "Core.Misc.CompressionBenchmark", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Commandlet)
+
+bool FCompressionBenchmark::RunTest( const FString& Parameters )
+{
+	const int32 BlockSize = 64 * 1024;
+	const int64 MaxDataSize = 64 * 1024 * 1024;
+	const int32 NumDecompressionRuns = 3;
+
+	// gather content until there is enough of it
+	const FString ContentDirectories[] = { FPaths::GameSavedDir() / TEXT("Cooked"), FPaths::GameContentDir(), FPaths::EngineContentDir() };
+	TArray<uint8> Data;
+
+	for (int32 DirectoryIndex = 0; (DirectoryIndex < ARRAY_COUNT(ContentDirectories)) && (Data.Num() == 0); DirectoryIndex++)
+	{
+		TArray<FString> Filenames;
+		IFileManager::Get().FindFilesRecursive(Filenames, *ContentDirectories[DirectoryIndex], TEXT("*.u*"), true, false);
+
+		for (int32 FileIndex = 0; (FileIndex < Filenames.Num()) && (Data.Num() < MaxDataSize); FileIndex++)
+		{
+			TArray<uint8> FileData;
+			if (FFileHelper::LoadFileToArray(FileData, *Filenames[FileIndex]))
+			{
+				Data.Append(FileData.GetData(), (int32)FMath::Min<int64>(FileData.Num(), MaxDataSize - Data.Num()));
+			}
+		}
+
+		if (Data.Num() > 0)
+		{
+			AddLogItem(FString::Printf(TEXT("Content: %s, %.1f MB"), *ContentDirectories[DirectoryIndex], Data.Num() / (1024.0 * 1024.0)));
+		}
+	}
+
+	if (Data.Num() == 0)
+	{
+		AddWarning(TEXT("No content found to compress"));
+		return true;
+	}
+
+	const int32 NumBlocks = (Data.Num() + BlockSize - 1) / BlockSize;
+	const double DataSizeMB = Data.Num() / (1024.0 * 1024.0);
+	TArray<uint8> UncompressedData;
+	UncompressedData.AddUninitialized(Data.Num());
+
+	AddLogItem(TEXT("Codec, Ratio, Compress (MB/s), Decompress (MB/s)"));
+
+	for (int32 CompressionType = 1; CompressionType <= COMPRESSION_FLAGS_TYPE_MASK; CompressionType++)
+	{
+		const ECompressionFlags Flags = (ECompressionFlags)CompressionType;
+		ICompressionCodec* Codec = FCompression::GetCodec(Flags);
+
+		if (Codec == nullptr)
+		{
+			continue;
+		}
+
+		// compress each block into its own slot, like pak entries
+		const int32 CompressedBlockCapacity = FCompression::CompressMemoryBound(Flags, BlockSize);
+		TArray<uint8> CompressedData;
+		TArray<int32> CompressedSizes;
+		CompressedData.AddUninitialized(CompressedBlockCapacity * NumBlocks);
+		CompressedSizes.AddUninitialized(NumBlocks);
+		int64 TotalCompressedSize = 0;
+		bool bSucceeded = true;
+
+		double StartTime = FPlatformTime::Seconds();
+
+		for (int32 BlockIndex = 0; (BlockIndex < NumBlocks) && bSucceeded; BlockIndex++)
+		{
+			const int32 Offset = BlockIndex * BlockSize;
+			CompressedSizes[BlockIndex] = CompressedBlockCapacity;
+			bSucceeded = FCompression::CompressMemory(Flags, CompressedData.GetData() + BlockIndex * CompressedBlockCapacity, CompressedSizes[BlockIndex], Data.GetData() + Offset, FMath::Min(BlockSize, Data.Num() - Offset));
+			TotalCompressedSize += CompressedSizes[BlockIndex];
+		}
+
+		const double CompressTime = FMath::Max(FPlatformTime::Seconds() - StartTime, 0.000001);
+
+		if (!bSucceeded)
+		{
+			AddError(FString::Printf(TEXT("%s failed to compress the content"), Codec->GetName()));
+			continue;
+		}
+
+		// best of several runs, as decompression is what matters at runtime
+		double DecompressTime = MAX_dbl;
+
+		for (int32 RunIndex = 0; RunIndex < NumDecompressionRuns; RunIndex++)
+		{
+			StartTime = FPlatformTime::Seconds();
+
+			for (int32 BlockIndex = 0; (BlockIndex < NumBlocks) && bSucceeded; BlockIndex++)
+			{
+				const int32 Offset = BlockIndex * BlockSize;
+				bSucceeded = FCompression::UncompressMemory(Flags, UncompressedData.GetData() + Offset, FMath::Min(BlockSize, Data.Num() - Offset), CompressedData.GetData() + BlockIndex * CompressedBlockCapacity, CompressedSizes[BlockIndex]);
+			}
+
+			DecompressTime = FMath::Min(DecompressTime, FMath::Max(FPlatformTime::Seconds() - StartTime, 0.000001));
+		}
+
+		if (!bSucceeded || (FMemory::Memcmp(UncompressedData.GetData(), Data.GetData(), Data.Num()) != 0))
+		{
+			AddError(FString::Printf(TEXT("%s failed to decompress the content"), Codec->GetName()));
+			continue;
+		}
+
+		AddLogItem(FString::Printf(TEXT("%s, %.3f, %.1f, %.1f"), Codec->GetName(), (double)TotalCompressedSize / Data.Num(), DataSizeMB / CompressTime, DataSizeMB / DecompressTime));
+	}
+
+	return true;
+}
@@ -0,0 +1,130 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "CorePrivatePCH.h"
+#include "AutomationTest.h"
+
+
+namespace CompressionTest
+{
+	/** Compresses Data with LZ4 and decompresses it again. @return true if both succeeded and the data came back unchanged. */
+	bool RoundTripLZ4(const TArray<uint8>& Data, int32& OutCompressedSize)
+	{
+		TArray<uint8> Compressed;
+		Compressed.AddUninitialized(FCompression::CompressMemoryBound(COMPRESS_LZ4, Data.Num()));
+		OutCompressedSize = Compressed.Num();
+
+		if (!FCompression::CompressMemory(COMPRESS_LZ4, Compressed.GetData(), OutCompressedSize, Data.GetData(), Data.Num()))
+		{
+			return false;
+		}
+
+		// one extra byte to catch writes past the end
+		TArray<uint8> Uncompressed;
+		Uncompressed.Init(0xCD, Data.Num() + 1);
+
+		return FCompression::UncompressMemory(COMPRESS_LZ4, Uncompressed.GetData(), Data.Num(), Compressed.GetData(), OutCompressedSize)
+			&& (FMemory::Memcmp(Uncompressed.GetData(), Data.GetData(), Data.Num()) == 0)
+			&& (Uncompressed[Data.Num()] == 0xCD);
+	}
+
+	/** @return true if Compressed decompresses to exactly UncompressedSize bytes. */
+	bool UncompressLZ4(const uint8* Compressed, int32 CompressedSize, int32 UncompressedSize, TArray<uint8>& OutData)
+	{
+		OutData.Reset();
+		OutData.AddZeroed(UncompressedSize);
+
+		return FCompression::UncompressMemory(COMPRESS_LZ4, OutData.GetData(), UncompressedSize, Compressed, CompressedSize);
+	}
+}
+
+
+/**
+ * Round trips inputs with known properties through the LZ4 codec, decodes a block written by the reference encoder and
+ * checks that truncated and corrupt blocks are rejected.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCompressionLZ4Test, "Core.Misc.CompressionLZ4", EAutomationTestFlags::ATF_SmokeTest)
+
+bool FCompressionLZ4Test::RunTest( const FString& Parameters )
+{
+	TArray<uint8> Data;
+	int32 CompressedSize = 0;
+
+	// empty input
+	TestTrue(TEXT("Empty input must round trip"), CompressionTest::RoundTripLZ4(Data, CompressedSize));
+
+	// inputs too short for any match are stored as literals
+	for (int32 Size = 1; Size <= 13; Size++)
+	{
+		Data.Reset();
+		Data.Init('a', Size);
+		TestTrue(FString::Printf(TEXT("%d byte input must round trip"), Size), CompressionTest::RoundTripLZ4(Data, CompressedSize));
+	}
+
+	// incompressible input
+	{
+		FRandomStream Random(0x4c5a34);
+		Data.Reset();
+		Data.AddUninitialized(64 * 1024);
+		for (int32 Index = 0; Index < Data.Num(); Index++)
+		{
+			Data[Index] = (uint8)Random.RandHelper(256);
+		}
+		TestTrue(TEXT("Random input must round trip"), CompressionTest::RoundTripLZ4(Data, CompressedSize));
+		TestTrue(TEXT("Random input must stay within the compression bound"), CompressedSize <= FCompression::CompressMemoryBound(COMPRESS_LZ4, Data.Num()));
+	}
+
+	// matches overlapping their own output, with offsets 1 and 3
+	{
+		Data.Reset();
+		Data.Init('z', 1000);
+		TestTrue(TEXT("A run of one byte must round trip"), CompressionTest::RoundTripLZ4(Data, CompressedSize));
+		TestTrue(TEXT("A run of one byte must compress"), CompressedSize < 32);
+
+		Data.Reset();
+		for (int32 Index = 0; Index < 1500; Index++)
+		{
+			Data.Add((uint8)"abc"[Index % 3]);
+		}
+		TestTrue(TEXT("A repeated pattern must round trip"), CompressionTest::RoundTripLZ4(Data, CompressedSize));
+		TestTrue(TEXT("A repeated pattern must compress"), CompressedSize < 32);
+	}
+
+	// 20 times 'a' as the reference encoder writes it: 1 literal, a match of 14 at offset 1, 5 last literals
+	const uint8 ReferenceBlock[] = { 0x1A, 'a', 0x01, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a' };
+	TArray<uint8> Uncompressed;
+	TestTrue(TEXT("A reference block must decompress"), CompressionTest::UncompressLZ4(ReferenceBlock, sizeof(ReferenceBlock), 20, Uncompressed));
+	int32 NumMismatches = 0;
+	for (int32 Index = 0; Index < Uncompressed.Num(); Index++)
+	{
+		NumMismatches += (Uncompressed[Index] != 'a') ? 1 : 0;
+	}
+	TestEqual(TEXT("A reference block must decompress to its data"), NumMismatches, 0);
+
+	// sizes that don't match the data
+	TestFalse(TEXT("Decompressing into a smaller buffer must fail"), CompressionTest::UncompressLZ4(ReferenceBlock, sizeof(ReferenceBlock), 19, Uncompressed));
+	TestFalse(TEXT("Decompressing into a larger buffer must fail"), CompressionTest::UncompressLZ4(ReferenceBlock, sizeof(ReferenceBlock), 21, Uncompressed));
+
+	// truncated blocks
+	for (int32 Size = 1; Size < ARRAY_COUNT(ReferenceBlock); Size++)
+	{
+		TestFalse(FString::Printf(TEXT("A block truncated to %d bytes must fail"), Size), CompressionTest::UncompressLZ4(ReferenceBlock, Size, 20, Uncompressed));
+	}
+
+	// corrupt blocks
+	const uint8 ZeroOffsetBlock[] = { 0x1A, 'a', 0x00, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a' };
+	TestFalse(TEXT("A match with offset 0 must fail"), CompressionTest::UncompressLZ4(ZeroOffsetBlock, sizeof(ZeroOffsetBlock), 20, Uncompressed));
+
+	const uint8 OffsetBeforeStartBlock[] = { 0x1A, 'a', 0x02, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a' };
+	TestFalse(TEXT("A match starting before the output must fail"), CompressionTest::UncompressLZ4(OffsetBeforeStartBlock, sizeof(OffsetBeforeStartBlock), 20, Uncompressed));
+
+	const uint8 LongLiteralsBlock[] = { 0xF0, 0xFF, 0xFF, 0x10, 'a' };
+	TestFalse(TEXT("Literals longer than the block must fail"), CompressionTest::UncompressLZ4(LongLiteralsBlock, sizeof(LongLiteralsBlock), 20, Uncompressed));
+
+	const uint8 LongMatchBlock[] = { 0x1F, 'a', 0x01, 0x00, 0xFF, 0xFF, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a' };
+	TestFalse(TEXT("A match longer than the output must fail"), CompressionTest::UncompressLZ4(LongMatchBlock, sizeof(LongMatchBlock), 20, Uncompressed));
+
+	const uint8 UnterminatedLengthBlock[] = { 0xF0, 0xFF, 0xFF };
+	TestFalse(TEXT("A length without its last byte must fail"), CompressionTest::UncompressLZ4(UnterminatedLengthBlock, sizeof(UnterminatedLengthBlock), 20, Uncompressed));
+
+	return true;
+}
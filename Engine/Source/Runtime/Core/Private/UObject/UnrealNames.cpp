@@ -9,7 +9,51 @@ DEFINE_LOG_CATEGORY_STATIC(LogUnrealNames, Log, All);
 	FName helpers.
 -----------------------------------------------------------------------------*/
 
-FNameEntry* AllocateNameEntry( const void* Name, NAME_INDEX Index, FNameEntry* HashNext, bool bIsPureAnsi );
+FNameEntry* AllocateNameEntry( const void* Name, NAME_INDEX Index, FNameEntry* HashNext, bool bIsPureAnsi, uint32 ShardIndex );
+
+/**
+ * Hashes a name for the name hash. FNV-1a costs a multiply per character where Strihash_DEPRECATED did a table lookup
+ * per byte, and nearly every name is ASCII so it's upper cased without calling ToUpper. The result is mixed so that
+ * the low bits picking the bucket and shard depend on every character.
+ */
+template <typename TCharType>
+static FORCEINLINE uint32 GetNameHash( const TCharType* InName, const ENameCase ComparisonMode )
+{
+	uint32 Hash = 2166136261U;
+	if( ComparisonMode == ENameCase::IgnoreCase )
+	{
+		for( ; *InName; InName++ )
+		{
+			TCharType Ch = *InName;
+			if( Ch >= 'a' && Ch <= 'z' )
+			{
+				Ch -= 'a' - 'A';
+			}
+			else if( (uint32)Ch >= 128 )
+			{
+				Ch = TChar<TCharType>::ToUpper(Ch);
+			}
+			Hash = (Hash ^ (uint32)Ch) * 16777619U;
+		}
+	}
+	else
+	{
+		for( ; *InName; InName++ )
+		{
+			Hash = (Hash ^ (uint32)*InName) * 16777619U;
+		}
+	}
+	Hash ^= Hash >> 16;
+	Hash *= 0x85ebca6b;
+	Hash ^= Hash >> 13;
+	return Hash;
+}
+
+/** Shard of the name hash a hash belongs to, every bucket is in a single shard. */
+static FORCEINLINE uint32 GetNameShardIndex( const uint32 Hash )
+{
+	return Hash & (FNameDefs::NameHashShardCount - 1);
+}
 
 /**
 * Helper function that can be used inside the debuggers watch window. E.g. "DebugFName(Class->Name.Index)". 
@@ -204,15 +248,16 @@ FNameEntry*** FName::GetNameTableForDebuggerVisualizers_MT()
 }
 
 
-FCriticalSection* FName::GetCriticalSection()
+FCriticalSection* FName::GetShardCriticalSection(uint32 ShardIndex)
 {
-	static FCriticalSection*	CriticalSection = NULL;
-	if( CriticalSection == NULL )
+	static FCriticalSection*	CriticalSections = NULL;
+	if( CriticalSections == NULL )
 	{
 		check(IsInGameThread());
-		CriticalSection = new FCriticalSection();
+		CriticalSections = new FCriticalSection[FNameDefs::NameHashShardCount];
 	}
-	return CriticalSection;
+	checkSlow(ShardIndex < FNameDefs::NameHashShardCount);
+	return &CriticalSections[ShardIndex];
 }
 
 FString FName::NameToDisplayString( const FString& InDisplayName, const bool bIsBool )
@@ -566,22 +611,7 @@ bool FName::InitInternal_FindOrAdd(const TCharType* InName, const EFindName Find
 #if WITH_CASE_PRESERVING_NAME
 	if(bWasFoundOrAdded && HardcodeIndex < 0)
 	{
-		TNameEntryArray& Names = GetNames();
-		const FNameEntry* const NameEntry = Names[OutComparisonIndex];
-
-		// If the string we got back doesn't match the case of the string we provided, also add a case variant version for display purposes
-		if(TCString<TCharType>::Strcmp(InName, FNameInitHelper<TCharType>::GetNameString(NameEntry)) != 0)
-		{
-			if(!InitInternal_FindOrAddNameEntry<TCharType>(InName, FindType, ENameCase::CaseSensitive, OutDisplayIndex))
-			{
-				// We don't consider failing to find/add the case variant a full failure
-				OutDisplayIndex = OutComparisonIndex;
-			}
-		}
-		else
-		{
-			OutDisplayIndex = OutComparisonIndex;
-		}
+		OutDisplayIndex = InitInternal_FindOrAddDisplayEntry<TCharType>(InName, FindType, OutComparisonIndex);
 	}
 	else
 #endif
@@ -592,11 +622,34 @@ bool FName::InitInternal_FindOrAdd(const TCharType* InName, const EFindName Find
 	return bWasFoundOrAdded;
 }
 
+#if WITH_CASE_PRESERVING_NAME
+template <typename TCharType>
+int32 FName::InitInternal_FindOrAddDisplayEntry(const TCharType* InName, const EFindName FindType, const int32 ComparisonIndex)
+{
+	TNameEntryArray& Names = GetNames();
+	const FNameEntry* const NameEntry = Names[ComparisonIndex];
+
+	// If the string we got back doesn't match the case of the string we provided, also add a case variant version for display purposes
+	if(TCString<TCharType>::Strcmp(InName, FNameInitHelper<TCharType>::GetNameString(NameEntry)) != 0)
+	{
+		int32 DisplayIndex = -1;
+		if(InitInternal_FindOrAddNameEntry<TCharType>(InName, FindType, ENameCase::CaseSensitive, DisplayIndex))
+		{
+			return DisplayIndex;
+		}
+		// We don't consider failing to find/add the case variant a full failure
+	}
+	return ComparisonIndex;
+}
+#endif
+
 template <typename TCharType>
 bool FName::InitInternal_FindOrAddNameEntry(const TCharType* InName, const EFindName FindType, const ENameCase ComparisonMode, int32& OutIndex)
 {
 	// Hash value of string
-	const int32 iHash = ( (ComparisonMode == ENameCase::IgnoreCase) ? FCrc::Strihash_DEPRECATED( InName ) : FCrc::StrCrc32( InName ) ) & (ARRAY_COUNT(NameHash)-1);
+	const uint32 Hash = GetNameHash( InName, ComparisonMode );
+	const int32 iHash = Hash & (ARRAY_COUNT(NameHash)-1);
+	const uint32 ShardIndex = GetNameShardIndex( Hash );
 
 	if (OutIndex < 0)
 	{
@@ -636,8 +689,8 @@ bool FName::InitInternal_FindOrAddNameEntry(const TCharType* InName, const EFind
 			return false;
 		}
 	}
-	// acquire the lock
-	FScopeLock ScopeLock(GetCriticalSection());
+	// acquire the lock of the shard this bucket is in, adds to other shards can go on at the same time
+	FScopeLock ScopeLock(GetShardCriticalSection(ShardIndex));
 	if (OutIndex < 0)
 	{
 		// Try to find the name in the hash. AGAIN...we might have been adding from a different thread and we just missed it
@@ -657,13 +710,14 @@ bool FName::InitInternal_FindOrAddNameEntry(const TCharType* InName, const EFind
 	TNameEntryArray& Names = GetNames();
 	if (OutIndex < 0)
 	{
+		// Lock free, other shards may be adding names too
 		OutIndex = Names.AddZeroed(1);
 	}
 	else
 	{
 		check(OutIndex < Names.Num());
 	}
-	FNameEntry* NewEntry = AllocateNameEntry( InName, OutIndex, OldHash, FNameInitHelper<TCharType>::IsAnsi );
+	FNameEntry* NewEntry = AllocateNameEntry( InName, OutIndex, OldHash, FNameInitHelper<TCharType>::IsAnsi, ShardIndex );
 	if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&Names[OutIndex], NewEntry, NULL) != NULL) // we use an atomic operation to check for unexpected concurrency, verify alignment, etc
 	{
 		UE_LOG(LogUnrealNames, Fatal, TEXT("Hardcoded name '%s' at index %i was duplicated (or unexpected concurrency). Existing entry is '%s'."), *NewEntry->GetPlainNameString(), NewEntry->GetIndex(), *Names[OutIndex]->GetPlainNameString() );
@@ -676,6 +730,78 @@ bool FName::InitInternal_FindOrAddNameEntry(const TCharType* InName, const EFind
 	return true;
 }
 
+void FName::CreateNameBatch( const FNameEntry* const* Entries, int32 NumEntries, FName* OutNames )
+{
+	// initialize the name subsystem if necessary
+	if (!GetIsInitialized())
+	{
+		StaticInit();
+	}
+
+	// Shard in the high bits, entry in the low bits, so sorting groups the names to add by shard
+	TArray<uint64, TInlineAllocator<64> > NamesToAdd;
+
+	for( int32 EntryIndex = 0; EntryIndex < NumEntries; EntryIndex++ )
+	{
+		const FNameEntry* const Entry = Entries[EntryIndex];
+
+		// Wide entries are rare and may still be pure ANSI, let Init sort them out
+		if( Entry->IsWide() )
+		{
+			OutNames[EntryIndex] = FName(ENAME_LinkerConstructor, Entry->GetWideName());
+			continue;
+		}
+
+		const ANSICHAR* const Name = Entry->GetAnsiName();
+		int32 ComparisonIndex = -1;
+		if( !Name[0] )
+		{
+			OutNames[EntryIndex] = FName(NAME_None);
+		}
+		else if( InitInternal_FindOrAddNameEntry<ANSICHAR>(Name, FNAME_Find, ENameCase::IgnoreCase, ComparisonIndex) )
+		{
+			OutNames[EntryIndex].ComparisonIndex = ComparisonIndex;
+		}
+		else
+		{
+			NamesToAdd.Add(((uint64)GetNameShardIndex(GetNameHash(Name, ENameCase::IgnoreCase)) << 32) | (uint32)EntryIndex);
+		}
+	}
+
+	NamesToAdd.Sort();
+
+	for( int32 AddIndex = 0; AddIndex < NamesToAdd.Num(); )
+	{
+		// Taking the shard lock here makes the lock taken for each add below uncontended
+		const uint32 ShardIndex = (uint32)(NamesToAdd[AddIndex] >> 32);
+		FScopeLock ScopeLock(GetShardCriticalSection(ShardIndex));
+
+		for( ; AddIndex < NamesToAdd.Num() && (uint32)(NamesToAdd[AddIndex] >> 32) == ShardIndex; AddIndex++ )
+		{
+			const int32 EntryIndex = (int32)(NamesToAdd[AddIndex] & 0xffffffff);
+			int32 ComparisonIndex = -1;
+			verify(InitInternal_FindOrAddNameEntry<ANSICHAR>(Entries[EntryIndex]->GetAnsiName(), FNAME_Add, ENameCase::IgnoreCase, ComparisonIndex));
+			OutNames[EntryIndex].ComparisonIndex = ComparisonIndex;
+		}
+	}
+
+	// Display names are looked up without holding a shard lock, their case sensitive hash is likely in another shard
+	for( int32 EntryIndex = 0; EntryIndex < NumEntries; EntryIndex++ )
+	{
+		const FNameEntry* const Entry = Entries[EntryIndex];
+		if( Entry->IsWide() || !Entry->GetAnsiName()[0] )
+		{
+			continue;
+		}
+
+		FName& OutName = OutNames[EntryIndex];
+#if WITH_CASE_PRESERVING_NAME
+		OutName.DisplayIndex = InitInternal_FindOrAddDisplayEntry<ANSICHAR>(Entry->GetAnsiName(), FNAME_Add, OutName.ComparisonIndex);
+#endif
+		OutName.Number = NAME_NO_NUMBER_INTERNAL;
+	}
+}
+
 const FNameEntry* FName::GetComparisonNameEntry() const
 {
 	TNameEntryArray& Names = GetNames();
@@ -741,7 +867,8 @@ void FName::StaticInit()
 	}
 
 	{
-		FScopeLock ScopeLock(GetCriticalSection());
+		// Create the shard locks now, while only this thread can use them
+		GetShardCriticalSection(0);
 
 		TNameEntryArray& Names = GetNames();
 		Names.AddZeroed(NAME_MaxHardcodedNameIndex + 1);
@@ -1069,15 +1196,15 @@ private:
 	FThreadSafeCounter ThreadGuard;
 };
 
-/** Global allocator for name entries. */
-FNameEntryPoolAllocator GNameEntryPoolAllocator;
+/** Global allocators for name entries, one per name hash shard so each is only used under its shard lock. */
+FNameEntryPoolAllocator GNameEntryPoolAllocators[FNameDefs::NameHashShardCount];
 
-FNameEntry* AllocateNameEntry( const void* Name, NAME_INDEX Index, FNameEntry* HashNext, bool bIsPureAnsi )
+FNameEntry* AllocateNameEntry( const void* Name, NAME_INDEX Index, FNameEntry* HashNext, bool bIsPureAnsi, uint32 ShardIndex )
 {
 	const SIZE_T NameLen  = bIsPureAnsi ? FCStringAnsi::Strlen((ANSICHAR*)Name) : FCString::Strlen((TCHAR*)Name);
 	int32 NameEntrySize	  = FNameEntry::GetSize( NameLen, bIsPureAnsi );
-	FNameEntry* NameEntry = GNameEntryPoolAllocator.Allocate( NameEntrySize );
-	FName::NameEntryMemorySize += NameEntrySize;
+	FNameEntry* NameEntry = GNameEntryPoolAllocators[ShardIndex].Allocate( NameEntrySize );
+	FPlatformAtomics::InterlockedAdd(&FName::NameEntryMemorySize, NameEntrySize);
 	NameEntry->Index      = (Index << NAME_INDEX_SHIFT) | (bIsPureAnsi ? 0 : 1);
 	NameEntry->HashNext   = HashNext;
 	// Can't rely on the template override for static arrays since the safe crt version of strcpy will fill in
@@ -1085,12 +1212,12 @@ FNameEntry* AllocateNameEntry( const void* Name, NAME_INDEX Index, FNameEntry* H
 	if( bIsPureAnsi )
 	{
 		FCStringAnsi::Strcpy( const_cast<ANSICHAR*>(NameEntry->GetAnsiName()), NameLen + 1, (ANSICHAR*) Name );
-		FName::NumAnsiNames++;
+		FPlatformAtomics::InterlockedIncrement(&FName::NumAnsiNames);
 	}
 	else
 	{
 		FCStringWide::Strcpy( const_cast<WIDECHAR*>(NameEntry->GetWideName()), NameLen + 1, (WIDECHAR*) Name );
-		FName::NumWideNames++;
+		FPlatformAtomics::InterlockedIncrement(&FName::NumWideNames);
 	}
 	return NameEntry;
 }
@@ -1194,6 +1321,71 @@ static class FFNameExec: private FSelfRegisteringExec
 				check(Test.TestCounter.GetValue() == FTest::NUM_TESTS * FTest::NUM_TASKS);
 				Ar.Logf( TEXT("Ran fname threading test."));
 			}
+			else if( FParse::Command(&Cmd,TEXT("BENCHMARK")) )
+			{
+				// Adds new names, then finds them again, from 1 to as many tasks as there are worker threads at the same time
+				int32 NamesPerTask = 50000;
+				FParse::Value(Cmd, TEXT("NAMES="), NamesPerTask);
+				const int32 MaxTasks = FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1);
+
+				struct FBenchmark
+				{
+					TArray<TArray<FString> > Strings;
+					bool bFind;
+					void Thread(int32 TaskIndex)
+					{
+						const TArray<FString>& TaskStrings = Strings[TaskIndex];
+						for (int32 Index = 0; Index < TaskStrings.Num(); Index++)
+						{
+							FName Temp(*TaskStrings[Index], bFind ? FNAME_Find : FNAME_Add);
+							check(Temp != NAME_None);
+						}
+					}
+				};
+
+				// Names are never freed, so every run needs new ones
+				static int32 RunIndex = 0;
+				RunIndex++;
+
+				Ar.Logf( TEXT("FName benchmark, %d names per task"), NamesPerTask);
+				for (int32 NumTasks = 1; NumTasks <= MaxTasks; NumTasks *= 2)
+				{
+					FBenchmark Benchmark;
+					Benchmark.Strings.AddZeroed(NumTasks);
+					for (int32 TaskIndex = 0; TaskIndex < NumTasks; TaskIndex++)
+					{
+						Benchmark.Strings[TaskIndex].Reserve(NamesPerTask);
+						for (int32 Index = 0; Index < NamesPerTask; Index++)
+						{
+							new (Benchmark.Strings[TaskIndex]) FString(FString::Printf(TEXT("Bench%dTasks%dTask%dName%d"), RunIndex, NumTasks, TaskIndex, Index));
+						}
+					}
+
+					double NamesPerSecond[2];
+					for (int32 Pass = 0; Pass < 2; Pass++)
+					{
+						Benchmark.bFind = Pass == 1;
+
+						DECLARE_CYCLE_STAT(TEXT("FSimpleDelegateGraphTask.FName Benchmark"),
+							STAT_FSimpleDelegateGraphTask_FName_Benchmark,
+							STATGROUP_TaskGraphTasks);
+
+						const double StartTime = FPlatformTime::Seconds();
+						FGraphEventArray Handles;
+						for (int32 TaskIndex = 0; TaskIndex < NumTasks; TaskIndex++)
+						{
+							new (Handles) FGraphEventRef(FSimpleDelegateGraphTask::CreateAndDispatchWhenReady(
+								FSimpleDelegateGraphTask::FDelegate::CreateRaw(&Benchmark, &FBenchmark::Thread, TaskIndex),
+								GET_STATID(STAT_FSimpleDelegateGraphTask_FName_Benchmark), NULL,
+								ENamedThreads::AnyThread));
+						}
+						FTaskGraphInterface::Get().WaitUntilTasksComplete(Handles, ENamedThreads::GameThread);
+						NamesPerSecond[Pass] = (NamesPerTask * NumTasks) / FMath::Max(FPlatformTime::Seconds() - StartTime, 0.000001);
+					}
+
+					Ar.Logf( TEXT("%d tasks: %.0f adds/s, %.0f finds/s"), NumTasks, NamesPerSecond[0], NamesPerSecond[1]);
+				}
+			}
 			return true;
 #endif // !UE_BUILD_SHIPPING
 		}
@@ -105,6 +105,9 @@ class FRunnableThreadWinRT : public FRunnableThread
 
 		ThreadID = GetCurrentThreadId();
 
+		// Threads cache freed memory, if the allocator supports it
+		FMemory::SetupTLSCachesOnCurrentThread();
+
 		// Initialize the runnable object
 		if (Runnable->Init() == true)
 		{
@@ -121,6 +124,8 @@ class FRunnableThreadWinRT : public FRunnableThread
 			ThreadInitSyncEvent->Trigger();
 		}
 
+		FMemory::ClearAndDisableTLSCachesOnCurrentThread();
+
 		return ExitCode;
 	}
 
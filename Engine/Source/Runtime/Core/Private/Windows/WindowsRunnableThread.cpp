@@ -62,6 +62,9 @@ uint32 FRunnableThreadWin::Run()
 	uint32 ExitCode = 1;
 	check(Runnable);
 
+	// Threads cache freed memory, if the allocator supports it
+	FMemory::SetupTLSCachesOnCurrentThread();
+
 	// Initialize the runnable object
 	if (Runnable->Init() == true)
 	{
@@ -78,5 +81,7 @@ uint32 FRunnableThreadWin::Run()
 		ThreadInitSyncEvent->Trigger();
 	}
 
+	FMemory::ClearAndDisableTLSCachesOnCurrentThread();
+
 	return ExitCode;
 }
@@ -0,0 +1,41 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	ParallelFor.h: Declares ParallelFor, a data parallel loop on the task graph.
+=============================================================================*/
+
+#pragma once
+
+
+namespace EParallelForFlags
+{
+	enum Type
+	{
+		None = 0,
+
+		/** Runs every iteration on the calling thread, in order. Useful to debug the loop body. */
+		ForceSingleThread = 1,
+
+		/** Iterations vary a lot in cost, hand them out one at a time instead of in chunks. */
+		Unbalanced = 2,
+	};
+}
+
+
+/**
+ * Calls Body once for every index in [0, Num), spread over the task graph worker threads.
+ *
+ * Indices are handed out in chunks from a shared counter, so threads that finish early take more chunks and
+ * no thread is left idle while another has a backlog. The calling thread runs chunks too, and only waits for
+ * chunks other threads already started, so calls can be nested in the body or made from task graph tasks
+ * without deadlocking or starting more threads than there are cores. Helper tasks that start after the work
+ * is done return immediately.
+ *
+ * Runs on the calling thread only when Num is 1, when the platform has no worker threads, with
+ * EParallelForFlags::ForceSingleThread, or when the ParallelFor.ForceSingleThread console variable is set.
+ *
+ * @param Num The number of iterations.
+ * @param Body The loop body, called with the iteration index, from several threads at the same time.
+ * @param Flags A combination of EParallelForFlags.
+ */
+CORE_API void ParallelFor( int32 Num, TFunctionRef<void(int32)> Body, uint32 Flags = EParallelForFlags::None );
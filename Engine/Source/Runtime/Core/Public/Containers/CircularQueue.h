@@ -12,8 +12,9 @@
  *
  * This class is thread safe only in two-thread scenarios, where the first thread
  * always reads and the second thread always writes. The head and tail indices are
- * stored in volatile memory to prevent the compiler from reordering the instructions
- * that are meant to update the indices AFTER items have been inserted or removed.
+ * stored in volatile memory and fenced with memory barriers on both sides, so neither the
+ * compiler nor the CPU can reorder element accesses across the index that guards them: items
+ * are written before the tail is published and read only after the tail has been observed.
  *
  * The number of items that can be enqueued is one less than the queue's capacity,
  * because one item will be used for detecting full and empty states.
@@ -49,7 +50,7 @@ public:
 	 */
 	uint32 Count( ) const
 	{
-		int32 Count = Head - Tail;
+		int32 Count = Tail - Head;
 
 		if (Count < 0)
 		{
@@ -69,7 +70,10 @@ public:
 	{
 		if (Head != Tail)
 		{
+			// don't read the element before the index that published it
+			FPlatformMisc::MemoryBarrier();
 			OutElement = Buffer[Head];
+			FPlatformMisc::MemoryBarrier();
 			Head = Buffer.GetNextIndex(Head);
 
 			return true;
@@ -100,7 +104,10 @@ public:
 
 		if (NewTail != Head)
 		{
+			// don't overwrite the slot before the consumer has finished reading it
+			FPlatformMisc::MemoryBarrier();
 			Buffer[Tail] = Element;
+			FPlatformMisc::MemoryBarrier();
 			Tail = NewTail;
 
 			return true;
@@ -141,6 +148,7 @@ public:
 	{
 		if (Head != Tail)
 		{
+			FPlatformMisc::MemoryBarrier();
 			OutItem = Buffer[Head];
 
 			return true;
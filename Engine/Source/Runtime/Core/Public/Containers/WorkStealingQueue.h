@@ -0,0 +1,244 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	WorkStealingQueue.h: Declares the TWorkStealingQueue template.
+=============================================================================*/
+
+#pragma once
+
+
+/**
+ * Implements a lock-free work stealing deque of pointers (Chase-Lev).
+ *
+ * A single owner thread pushes and pops items at the bottom of the deque, in last-in first-out
+ * order, without any interlocked operation unless the deque is down to its last item. Any other
+ * thread can steal items from the top, in first-in first-out order, with a single compare and swap.
+ *
+ * The deque grows when full. Buffers that were outgrown are kept until the deque is destroyed,
+ * because a thief may still be reading from them.
+ *
+ * @param ElementType The type of elements pointed to by the deque.
+ */
+template<typename ElementType> class TWorkStealingQueue
+{
+public:
+
+	/**
+	 * Default constructor.
+	 *
+	 * @param InitialCapacity The number of items the deque can hold before growing (will be rounded up to the next power of 2).
+	 */
+	explicit TWorkStealingQueue( int32 InitialCapacity = 1024 )
+		: Top(0)
+		, Bottom(0)
+	{
+		Buffer = new FBuffer(FPlatformMath::RoundUpToPowerOfTwo((uint32)FMath::Max(InitialCapacity, 2)));
+	}
+
+	/** Destructor. The deque must not be used by any other thread anymore. */
+	~TWorkStealingQueue( )
+	{
+		delete Buffer;
+
+		for (int32 Index = 0; Index < RetiredBuffers.Num(); Index++)
+		{
+			delete RetiredBuffers[Index];
+		}
+	}
+
+public:
+
+	/**
+	 * Adds an item to the bottom of the deque. Owner thread only.
+	 *
+	 * @param Item The item to add, must not be NULL.
+	 */
+	void Push( ElementType* Item )
+	{
+		const int64 B = Bottom;
+		const int64 T = Load(&Top);
+		FBuffer* CurrentBuffer = Buffer;
+
+		if (B - T >= CurrentBuffer->Capacity)
+		{
+			CurrentBuffer = Grow(CurrentBuffer, T, B);
+		}
+
+		CurrentBuffer->Put(B, Item);
+
+		// The item must be visible before thieves can see the new bottom
+		FPlatformMisc::MemoryBarrier();
+		Store(&Bottom, B + 1);
+	}
+
+	/**
+	 * Removes the most recently pushed item. Owner thread only.
+	 *
+	 * @return The item, or NULL if the deque is empty or a thief took the last item.
+	 */
+	ElementType* Pop( )
+	{
+		const int64 B = Bottom - 1;
+		FBuffer* CurrentBuffer = Buffer;
+
+		Store(&Bottom, B);
+
+		// Thieves must see the new bottom before we read top, or both sides could take the last item
+		FPlatformMisc::MemoryBarrier();
+		const int64 T = Load(&Top);
+
+		if (T > B)
+		{
+			// Empty
+			Store(&Bottom, B + 1);
+			return NULL;
+		}
+
+		ElementType* Item = CurrentBuffer->Get(B);
+
+		if (T == B)
+		{
+			// Last item, race the thieves for it
+			if (FPlatformAtomics::InterlockedCompareExchange(&Top, T + 1, T) != T)
+			{
+				Item = NULL;
+			}
+
+			Store(&Bottom, B + 1);
+		}
+
+		return Item;
+	}
+
+	/**
+	 * Removes the oldest item. Any thread.
+	 *
+	 * @return The item, or NULL if the deque is empty or another thread took the item first.
+	 */
+	ElementType* Steal( )
+	{
+		const int64 T = Load(&Top);
+
+		FPlatformMisc::MemoryBarrier();
+		const int64 B = Load(&Bottom);
+
+		if (T >= B)
+		{
+			return NULL;
+		}
+
+		FBuffer* CurrentBuffer = Buffer;
+		FPlatformMisc::MemoryBarrier();
+
+		ElementType* Item = CurrentBuffer->Get(T);
+
+		if (FPlatformAtomics::InterlockedCompareExchange(&Top, T + 1, T) != T)
+		{
+			return NULL;
+		}
+
+		return Item;
+	}
+
+	/**
+	 * Checks whether the deque is empty. Only a hint from other threads than the owner.
+	 *
+	 * @return true if the deque is empty, false otherwise.
+	 */
+	bool IsEmpty( ) const
+	{
+		return Load(&Bottom) <= Load(&Top);
+	}
+
+private:
+
+	/** Circular array of items, indexed by the ever increasing top and bottom indices. */
+	struct FBuffer
+	{
+		explicit FBuffer( int64 InCapacity )
+			: Capacity(InCapacity)
+			, Mask(InCapacity - 1)
+		{
+			Items = new ElementType*[(SIZE_T)InCapacity];
+		}
+
+		~FBuffer( )
+		{
+			delete[] Items;
+		}
+
+		ElementType* Get( int64 Index ) const
+		{
+			return Items[Index & Mask];
+		}
+
+		void Put( int64 Index, ElementType* Item )
+		{
+			Items[Index & Mask] = Item;
+		}
+
+		const int64 Capacity;
+		const int64 Mask;
+		ElementType** Items;
+	};
+
+	/** Replaces the buffer with one twice as large holding the same items. Owner thread only. */
+	FBuffer* Grow( FBuffer* OldBuffer, int64 T, int64 B )
+	{
+		FBuffer* NewBuffer = new FBuffer(OldBuffer->Capacity * 2);
+
+		for (int64 Index = T; Index < B; Index++)
+		{
+			NewBuffer->Put(Index, OldBuffer->Get(Index));
+		}
+
+		RetiredBuffers.Add(OldBuffer);
+
+		// The copied items must be visible before thieves can see the new buffer
+		FPlatformMisc::MemoryBarrier();
+		Buffer = NewBuffer;
+
+		return NewBuffer;
+	}
+
+	/** Reads an index written by another thread, 64 bit reads aren't atomic on 32 bit platforms. */
+	static FORCEINLINE int64 Load( const volatile int64* Src )
+	{
+#if PLATFORM_64BITS
+		return *Src;
+#else
+		return FPlatformAtomics::InterlockedCompareExchange((volatile int64*)Src, 0, 0);
+#endif
+	}
+
+	/** Writes an index read by other threads. */
+	static FORCEINLINE void Store( volatile int64* Dest, int64 Value )
+	{
+#if PLATFORM_64BITS
+		*Dest = Value;
+#else
+		FPlatformAtomics::InterlockedExchange(Dest, Value);
+#endif
+	}
+
+	/** Index of the oldest item, only ever increases. Written by thieves and by the owner for the last item. */
+	volatile int64 Top;
+
+	/** Keeps thieves hammering Top from invalidating the owner's cache line. */
+	uint8 PadToAvoidContention[CACHE_LINE_SIZE - sizeof(int64)];
+
+	/** Index one past the newest item. Written by the owner only. */
+	volatile int64 Bottom;
+
+	/** Current buffer. Replaced by the owner only. */
+	FBuffer* volatile Buffer;
+
+	/** Outgrown buffers, owner thread only. */
+	TArray<FBuffer*> RetiredBuffers;
+
+private:
+
+	// Hidden copy constructor and assignment.
+	TWorkStealingQueue( const TWorkStealingQueue& );
+	TWorkStealingQueue& operator=( const TWorkStealingQueue& );
+};
@@ -63,6 +63,89 @@ public:
 };
 
 
+/**
+ * Read-only region of a memory mapped file.
+ * The memory stays valid until the region is deleted, which is the only way to unmap it.
+**/
+class CORE_API IMappedFileRegion
+{
+	/** Pointer to the first mapped byte. **/
+	const uint8* MappedPtr;
+	/** Number of mapped bytes. **/
+	int64 MappedSize;
+
+public:
+	IMappedFileRegion(const uint8* InMappedPtr, int64 InMappedSize)
+		: MappedPtr(InMappedPtr)
+		, MappedSize(InMappedSize)
+	{
+	}
+
+	/** Destructor, unmaps the region. **/
+	virtual ~IMappedFileRegion()
+	{
+	}
+
+	/** Return the pointer to the first mapped byte. **/
+	FORCEINLINE const uint8* GetMappedPtr() const
+	{
+		return MappedPtr;
+	}
+
+	/** Return the number of mapped bytes. **/
+	FORCEINLINE int64 GetMappedSize() const
+	{
+		return MappedSize;
+	}
+
+	/**
+	 * Hint that part of the region is about to be accessed, so that the platform can start paging it in.
+	 * @param PreloadOffset		Offset of the part to preload, relative to the start of the region.
+	 * @param BytesToPreload	Number of bytes to preload, or a negative value to preload the rest of the region.
+	**/
+	virtual void PreloadHint(int64 PreloadOffset = 0, int64 BytesToPreload = -1)
+	{
+	}
+};
+
+
+/**
+ * Memory mapped file handle.
+ * Regions can be mapped from any thread and must be deleted before the handle.
+**/
+class CORE_API IMappedFileHandle
+{
+	/** Size of the mapped file. **/
+	int64 MappedFileSize;
+
+public:
+	IMappedFileHandle(int64 InFileSize)
+		: MappedFileSize(InFileSize)
+	{
+	}
+
+	/** Destructor, also the only way to close the file handle **/
+	virtual ~IMappedFileHandle()
+	{
+	}
+
+	/** Return the size of the mapped file. **/
+	FORCEINLINE int64 GetFileSize() const
+	{
+		return MappedFileSize;
+	}
+
+	/**
+	 * Map a read-only region of the file.
+	 * @param Offset		Offset of the region in the file.
+	 * @param BytesToMap	Number of bytes to map, or a negative value to map the rest of the file.
+	 * @param bPreloadHint	true if the whole region is about to be accessed.
+	 * @return				The mapped region, or nullptr on failure. Unmap it by delete'ing it.
+	**/
+	virtual IMappedFileRegion* MapRegion(int64 Offset = 0, int64 BytesToMap = -1, bool bPreloadHint = false) = 0;
+};
+
+
 /**
 * File I/O Interface
 **/
@@ -146,6 +229,14 @@ public:
 	virtual IFileHandle*	OpenRead(const TCHAR* Filename) = 0;
 	/** Attempt to open a file for writing. If successful will return a non-nullptr pointer. Close the file by delete'ing the handle. **/
 	virtual IFileHandle*	OpenWrite(const TCHAR* Filename, bool bAppend = 0, bool bAllowRead = 0) = 0;
+	/**
+	 * Attempt to open a file for memory mapped reading. Close the file by delete'ing the handle.
+	 * Returns nullptr if the platform or the file can't be mapped, in which case OpenRead should be used instead.
+	**/
+	virtual IMappedFileHandle*	OpenMapped(const TCHAR* Filename)
+	{
+		return nullptr;
+	}
 
 	/** Return true if the directory exists. **/
 	virtual bool		DirectoryExists(const TCHAR* Directory) = 0;
@@ -298,6 +298,10 @@ public:
 		}
 		return new FCachedFileHandle(InnerHandle, bAllowRead, true);
 	}
+	virtual IMappedFileHandle*	OpenMapped(const TCHAR* Filename) override
+	{
+		return LowerLevel->OpenMapped(Filename);
+	}
 	virtual bool		DirectoryExists(const TCHAR* Directory) override
 	{
 		return LowerLevel->DirectoryExists(Directory);
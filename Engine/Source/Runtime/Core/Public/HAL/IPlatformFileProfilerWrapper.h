@@ -379,6 +379,14 @@ public:
 		OpStat->Duration += FPlatformTime::Seconds() * 1000.0 - OpStat->LastOpTime;
 		return Result ? (new TProfiledFileHandle< StatsType >( Result, Filename, FileStat )) : Result;
 	}
+	virtual IMappedFileHandle*	OpenMapped(const TCHAR* Filename) override
+	{
+		StatsType* FileStat = CreateStat( Filename );
+		FProfiledFileStatsOp* OpStat = FileStat->CreateOpStat( FProfiledFileStatsOp::OpenRead );
+		IMappedFileHandle* Result = LowerLevel->OpenMapped(Filename);
+		OpStat->Duration += FPlatformTime::Seconds() * 1000.0 - OpStat->LastOpTime;
+		return Result;
+	}
 
 	virtual bool		DirectoryExists(const TCHAR* Directory) override
 	{
@@ -594,6 +602,10 @@ public:
 		IFileHandle* Result = LowerLevel->OpenWrite(Filename, bAppend, bAllowRead);
 		return Result ? (new FPlatformFileReadStatsHandle(Result, Filename, &BytePerSecThisTick, &BytesReadThisTick, &ReadsThisTick)) : Result;
 	}
+	virtual IMappedFileHandle*	OpenMapped(const TCHAR* Filename) override
+	{
+		return LowerLevel->OpenMapped(Filename);
+	}
 
 	virtual bool		DirectoryExists(const TCHAR* Directory) override
 	{
@@ -27,6 +27,23 @@
 #	define USE_FINE_GRAIN_LOCKS
 #endif
 
+// Threads that called SetupTLSCachesOnCurrentThread keep freed small blocks in per thread lists,
+// and exchange them with the pools in bundles, so most small allocations don't take any lock.
+#if defined USE_FINE_GRAIN_LOCKS
+#	define USE_THREAD_CACHES
+#endif
+
+#if defined USE_THREAD_CACHES
+	/** Largest block size cached per thread, bigger blocks always go to the pools. */
+#	define THREAD_CACHE_MAX_BLOCK_SIZE (4096)
+	/** Max number of blocks in a bundle. */
+#	define THREAD_CACHE_BUNDLE_MAX_COUNT (64)
+	/** Max number of bytes in a bundle, caps the memory a thread can keep for big blocks. */
+#	define THREAD_CACHE_BUNDLE_MAX_BYTES (16*1024)
+	/** Number of full bundles per block size that threads can hand over to each other before they go back to the pools. */
+#	define THREAD_CACHE_RECYCLER_SLOTS (8)
+#endif
+
 #include "LockFreeList.h"
 #include "Array.h"
 
@@ -145,6 +162,71 @@ private:
 	/** Default alignment for binned allocator */
 	enum { DEFAULT_BINNED_ALLOCATOR_ALIGNMENT = sizeof(FFreeMem) };
 
+#ifdef USE_THREAD_CACHES
+	/** A free block in a bundle. Blocks are at least 8 bytes, so this is all they can hold. */
+	struct FBundleNode
+	{
+		FBundleNode*	Next;
+	};
+
+	/**
+	 * Free blocks of one size cached by one thread, in two bundles. Frees fill the partial bundle, once it is
+	 * full it becomes the full bundle, and the previous full bundle goes to the recycler. Allocations empty the
+	 * partial bundle, then take the full bundle, then a bundle from the recycler or a new one from the pool.
+	 * Only ever touched by its thread.
+	 */
+	struct FThreadCacheList
+	{
+		FBundleNode*	PartialBundle;
+		uint32			PartialCount;
+		FBundleNode*	FullBundle;
+
+		FORCEINLINE void* Pop( uint32 MaxCount )
+		{
+			if( !PartialBundle )
+			{
+				if( !FullBundle )
+				{
+					return nullptr;
+				}
+				PartialBundle = FullBundle;
+				PartialCount = MaxCount;
+				FullBundle = nullptr;
+			}
+			FBundleNode* Node = PartialBundle;
+			PartialBundle = Node->Next;
+			PartialCount--;
+			return Node;
+		}
+
+		/** @return false if both bundles are full */
+		FORCEINLINE bool Push( void* Ptr, uint32 MaxCount )
+		{
+			if( PartialCount >= MaxCount )
+			{
+				if( FullBundle )
+				{
+					return false;
+				}
+				FullBundle = PartialBundle;
+				PartialBundle = nullptr;
+				PartialCount = 0;
+			}
+			FBundleNode* Node = (FBundleNode*)Ptr;
+			Node->Next = PartialBundle;
+			PartialBundle = Node;
+			PartialCount++;
+			return true;
+		}
+	};
+
+	/** Per thread cache, stored in ThreadCacheTlsSlot. */
+	struct FThreadCache
+	{
+		FThreadCacheList	Lists[POOL_COUNT];
+	};
+#endif
+
 #ifdef CACHE_FREED_OS_ALLOCS
 	/**  */
 	struct FFreePageBlock
@@ -294,6 +376,15 @@ private:
 
 	uint32		PageSize;
 
+#ifdef USE_THREAD_CACHES
+	/** TLS slot holding the FThreadCache of threads that called SetupTLSCachesOnCurrentThread */
+	uint32		ThreadCacheTlsSlot;
+	/** Number of blocks in a full bundle for each pool, 0 if the pool isn't cached */
+	uint32		BundleMaxCount[POOL_COUNT];
+	/** Full bundles waiting for a thread that needs blocks of this size, NULL for empty slots */
+	FBundleNode* volatile RecycledBundles[POOL_COUNT][THREAD_CACHE_RECYCLER_SLOTS];
+#endif
+
 #ifdef CACHE_FREED_OS_ALLOCS
 	FFreePageBlock	FreedPageBlocks[MAX_CACHED_OS_FREES];
 	uint32			FreedPageBlocksNum;
@@ -586,38 +677,7 @@ private:
 #ifdef USE_FINE_GRAIN_LOCKS
 			FScopeLock TableLock(&Table->CriticalSection);
 #endif
-#if STATS
-			Table->ActiveRequests--;
-#endif
-			// If this pool was exhausted, move to available list.
-			if( !Pool->FirstMem )
-			{
-				Pool->Unlink();
-				Pool->Link( Table->FirstPool );
-			}
-
-			// Free a pooled allocation.
-			FFreeMem* Free		= (FFreeMem*)Ptr;
-			Free->NumFreeBlocks	= 1;
-			Free->Next			= Pool->FirstMem;
-			Pool->FirstMem		= Free;
-			STAT(UsedCurrent -= Table->BlockSize);
-
-			// Free this pool.
-			checkSlow(Pool->Taken >= 1);
-			if( --Pool->Taken == 0 )
-			{
-#if STATS
-				Table->NumActivePools--;
-#endif
-				// Free the OS memory.
-				SIZE_T OsBytes = Pool->GetOsBytes(PageSize, BinnedOSTableIndex);
-				STAT(OsCurrent -= OsBytes);
-				STAT(WasteCurrent -= OsBytes - Pool->GetBytes());
-				Pool->Unlink();
-				Pool->SetAllocationSizes(0, 0, 0, BinnedOSTableIndex);
-				OSFree((void*)BasePtr, OsBytes);
-			}
+			FreeBlockToPool(Table, Pool, Ptr, BasePtr);
 		}
 		else
 		{
@@ -633,6 +693,130 @@ private:
 		MEM_TIME(MemTime += FPlatformTime::Seconds());
 	}
 
+	/**
+	* Returns a block to its pool, and the pool to the OS if it was the last block taken from it. 
+	* It's the callers responsibility to lock the table before calling this.
+	*/
+	void FreeBlockToPool( FPoolTable* Table, FPoolInfo* Pool, void* Ptr, UPTRINT BasePtr )
+	{
+#if STATS
+		Table->ActiveRequests--;
+#endif
+		// If this pool was exhausted, move to available list.
+		if( !Pool->FirstMem )
+		{
+			Pool->Unlink();
+			Pool->Link( Table->FirstPool );
+		}
+
+		// Free a pooled allocation.
+		FFreeMem* Free		= (FFreeMem*)Ptr;
+		Free->NumFreeBlocks	= 1;
+		Free->Next			= Pool->FirstMem;
+		Pool->FirstMem		= Free;
+		STAT(UsedCurrent -= Table->BlockSize);
+
+		// Free this pool.
+		checkSlow(Pool->Taken >= 1);
+		if( --Pool->Taken == 0 )
+		{
+#if STATS
+			Table->NumActivePools--;
+#endif
+			// Free the OS memory.
+			SIZE_T OsBytes = Pool->GetOsBytes(PageSize, BinnedOSTableIndex);
+			STAT(OsCurrent -= OsBytes);
+			STAT(WasteCurrent -= OsBytes - Pool->GetBytes());
+			Pool->Unlink();
+			Pool->SetAllocationSizes(0, 0, 0, BinnedOSTableIndex);
+			OSFree((void*)BasePtr, OsBytes);
+		}
+	}
+
+#ifdef USE_THREAD_CACHES
+	FORCEINLINE FThreadCache* GetThreadCache() const
+	{
+		return (FThreadCache*)FPlatformTLS::GetTlsValue(ThreadCacheTlsSlot);
+	}
+
+	/** Returns every block of a NULL terminated bundle to its pool, taking the table lock once. */
+	void FreeBundleToPool( uint32 PoolIndex, FBundleNode* Bundle )
+	{
+		FPoolTable* Table = &PoolTable[PoolIndex];
+		FScopeLock TableLock(&Table->CriticalSection);
+		while( Bundle )
+		{
+			FBundleNode* Next = Bundle->Next;
+			UPTRINT BasePtr;
+			FPoolInfo* Pool = FindPoolInfo((UPTRINT)Bundle, BasePtr);
+			checkSlow(Pool && MemSizeToPoolTable[Pool->TableIndex] == Table);
+			FreeBlockToPool(Table, Pool, Bundle, BasePtr);
+			Bundle = Next;
+		}
+	}
+
+	/** Hands a full bundle over to other threads, or gives it back to the pool if the recycler is full. */
+	void RecycleFullBundle( uint32 PoolIndex, FBundleNode* Bundle )
+	{
+		for( uint32 Slot = 0; Slot < THREAD_CACHE_RECYCLER_SLOTS; Slot++ )
+		{
+			if( !RecycledBundles[PoolIndex][Slot] && FPlatformAtomics::InterlockedCompareExchangePointer((void**)&RecycledBundles[PoolIndex][Slot], Bundle, nullptr) == nullptr )
+			{
+				return;
+			}
+		}
+		FreeBundleToPool(PoolIndex, Bundle);
+	}
+
+	/** Called when both bundles of a thread cache list are full, makes room for Ptr. */
+	void FreeToFullThreadCache( FThreadCacheList& List, uint32 PoolIndex, void* Ptr )
+	{
+		RecycleFullBundle(PoolIndex, List.FullBundle);
+		List.FullBundle = nullptr;
+		verify(List.Push(Ptr, BundleMaxCount[PoolIndex]));
+	}
+
+	/** Called when a thread cache list is empty, refills it with a full bundle from the recycler or the pool. */
+	void* AllocateFromEmptyThreadCache( FThreadCacheList& List, uint32 PoolIndex )
+	{
+		const uint32 MaxCount = BundleMaxCount[PoolIndex];
+		checkSlow(!List.PartialBundle && !List.FullBundle);
+
+		for( uint32 Slot = 0; Slot < THREAD_CACHE_RECYCLER_SLOTS; Slot++ )
+		{
+			FBundleNode* Bundle = RecycledBundles[PoolIndex][Slot];
+			if( Bundle && FPlatformAtomics::InterlockedCompareExchangePointer((void**)&RecycledBundles[PoolIndex][Slot], nullptr, Bundle) == Bundle )
+			{
+				List.FullBundle = Bundle;
+				return List.Pop(MaxCount);
+			}
+		}
+
+		// Take a whole bundle from the pool under a single lock
+		FPoolTable* Table = &PoolTable[PoolIndex];
+		FBundleNode* Bundle = nullptr;
+		{
+			FScopeLock TableLock(&Table->CriticalSection);
+			for( uint32 Index = 0; Index < MaxCount; Index++ )
+			{
+				TrackStats(Table, Table->BlockSize);
+
+				FPoolInfo* Pool = Table->FirstPool;
+				if( !Pool )
+				{
+					Pool = AllocatePoolMemory(Table, BINNED_ALLOC_POOL_SIZE, Table->BlockSize);
+				}
+
+				FBundleNode* Node = (FBundleNode*)AllocateBlockFromPool(Table, Pool);
+				Node->Next = Bundle;
+				Bundle = Node;
+			}
+		}
+		List.FullBundle = Bundle;
+		return List.Pop(MaxCount);
+	}
+#endif
+
 	void PushFreeLockless(void* Ptr)
 	{
 #ifdef USE_LOCKFREE_DELETE
@@ -868,6 +1052,19 @@ public:
 		MemSizeToPoolTable[BinnedSizeLimit+1] = &PagePoolTable[1];
 
 		check(MAX_POOLED_ALLOCATION_SIZE - 1 == PoolTable[POOL_COUNT - 1].BlockSize);
+
+#ifdef USE_THREAD_CACHES
+		ThreadCacheTlsSlot = FPlatformTLS::AllocTlsSlot();
+		for( uint32 i = 0; i < POOL_COUNT; i++ )
+		{
+			const uint32 BlockSize = PoolTable[i].BlockSize;
+			BundleMaxCount[i] = BlockSize <= THREAD_CACHE_MAX_BLOCK_SIZE ? FMath::Min<uint32>(THREAD_CACHE_BUNDLE_MAX_COUNT, THREAD_CACHE_BUNDLE_MAX_BYTES / BlockSize) : 0;
+			for( uint32 Slot = 0; Slot < THREAD_CACHE_RECYCLER_SLOTS; Slot++ )
+			{
+				RecycledBundles[i][Slot] = nullptr;
+			}
+		}
+#endif
 	}
 	
 	virtual ~FMallocBinned()
@@ -913,20 +1110,36 @@ public:
 		{
 			// Allocate from pool.
 			FPoolTable* Table = MemSizeToPoolTable[Size];
+			checkSlow(Size <= Table->BlockSize);
+#ifdef USE_THREAD_CACHES
+			const uint32 PoolIndex = Table - PoolTable;
+			FThreadCache* ThreadCache = BundleMaxCount[PoolIndex] ? GetThreadCache() : nullptr;
+			if( ThreadCache )
+			{
+				// Blocks in the thread cache were already counted as used when the cache took them from the pool
+				FThreadCacheList& List = ThreadCache->Lists[PoolIndex];
+				Free = (FFreeMem*)List.Pop(BundleMaxCount[PoolIndex]);
+				if( !Free )
+				{
+					Free = (FFreeMem*)AllocateFromEmptyThreadCache(List, PoolIndex);
+				}
+			}
+			else
+#endif
+			{
 #ifdef USE_FINE_GRAIN_LOCKS
-			FScopeLock TableLock(&Table->CriticalSection);
+				FScopeLock TableLock(&Table->CriticalSection);
 #endif
-			checkSlow(Size <= Table->BlockSize);
+				TrackStats(Table, Size);
 
-			TrackStats(Table, Size);
+				FPoolInfo* Pool = Table->FirstPool;
+				if( !Pool )
+				{
+					Pool = AllocatePoolMemory(Table, BINNED_ALLOC_POOL_SIZE/*PageSize*/, Size);
+				}
 
-			FPoolInfo* Pool = Table->FirstPool;
-			if( !Pool )
-			{
-				Pool = AllocatePoolMemory(Table, BINNED_ALLOC_POOL_SIZE/*PageSize*/, Size);
+				Free = AllocateBlockFromPool(Table, Pool);
 			}
-
-			Free = AllocateBlockFromPool(Table, Pool);
 		}
 		else if ( ((Size >= BinnedSizeLimit && Size <= PagePoolTable[0].BlockSize) ||
 				  (Size > PageSize && Size <= PagePoolTable[1].BlockSize))
@@ -1061,6 +1274,32 @@ public:
 			return;
 		}
 
+#ifdef USE_THREAD_CACHES
+		FThreadCache* ThreadCache = GetThreadCache();
+		if( ThreadCache )
+		{
+			UPTRINT BasePtr;
+			FPoolInfo* Pool = FindPoolInfo((UPTRINT)Ptr, BasePtr);
+			checkSlow(Pool);
+			if( Pool->TableIndex < BinnedSizeLimit )
+			{
+				const uint32 PoolIndex = MemSizeToPoolTable[Pool->TableIndex] - PoolTable;
+				const uint32 MaxCount = BundleMaxCount[PoolIndex];
+				if( MaxCount )
+				{
+					// Still counted as used until the block goes back to its pool
+					STAT(CurrentAllocs--);
+					FThreadCacheList& List = ThreadCache->Lists[PoolIndex];
+					if( !List.Push(Ptr, MaxCount) )
+					{
+						FreeToFullThreadCache(List, PoolIndex, Ptr);
+					}
+					return;
+				}
+			}
+		}
+#endif
+
 		PushFreeLockless(Ptr);
 	}
 
@@ -1267,6 +1506,43 @@ public:
 
 	virtual const TCHAR* GetDescriptiveName() override { return TEXT("binned"); }
 
+	virtual void SetupTLSCachesOnCurrentThread() override
+	{
+#ifdef USE_THREAD_CACHES
+		if( !GetThreadCache() )
+		{
+			// Allocated before the slot is set, so this goes through the pools like any other allocation
+			FThreadCache* ThreadCache = (FThreadCache*)Malloc(sizeof(FThreadCache), DEFAULT_ALIGNMENT);
+			FMemory::Memzero(ThreadCache, sizeof(FThreadCache));
+			FPlatformTLS::SetTlsValue(ThreadCacheTlsSlot, ThreadCache);
+		}
+#endif
+	}
+
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+	{
+#ifdef USE_THREAD_CACHES
+		FThreadCache* ThreadCache = GetThreadCache();
+		if( ThreadCache )
+		{
+			FPlatformTLS::SetTlsValue(ThreadCacheTlsSlot, nullptr);
+			for( uint32 PoolIndex = 0; PoolIndex < POOL_COUNT; PoolIndex++ )
+			{
+				FThreadCacheList& List = ThreadCache->Lists[PoolIndex];
+				if( List.PartialBundle )
+				{
+					FreeBundleToPool(PoolIndex, List.PartialBundle);
+				}
+				if( List.FullBundle )
+				{
+					RecycleFullBundle(PoolIndex, List.FullBundle);
+				}
+			}
+			Free(ThreadCache);
+		}
+#endif
+	}
+
 protected:
 
 	void UpdateSlackStat()
@@ -165,6 +165,22 @@ public:
 		return TEXT("Unspecified allocator");
 	}
 
+	/**
+	 * Lets the current thread keep a cache of freed memory, for allocators that support it.
+	 * Called by every FRunnableThread when it starts, and for the main thread when GMalloc is created.
+	 */
+	virtual void SetupTLSCachesOnCurrentThread()
+	{
+	}
+
+	/**
+	 * Gives the cache of the current thread back to the allocator and stops caching on this thread.
+	 * Must be called before a thread that called SetupTLSCachesOnCurrentThread exits, or its cache leaks.
+	 */
+	virtual void ClearAndDisableTLSCachesOnCurrentThread()
+	{
+	}
+
 protected:
 	friend struct FCurrentFrameCalls;
 
@@ -206,6 +206,9 @@
 #ifndef PLATFORM_HAS_BSD_SOCKET_FEATURE_GETHOSTNAME
 	#define PLATFORM_HAS_BSD_SOCKET_FEATURE_GETHOSTNAME	1
 #endif
+#ifndef PLATFORM_HAS_BSD_SOCKET_FEATURE_MULTI_MESSAGE
+	#define PLATFORM_HAS_BSD_SOCKET_FEATURE_MULTI_MESSAGE	0
+#endif
 #ifndef PLATFORM_HAS_NO_EPROCLIM
 	#define PLATFORM_HAS_NO_EPROCLIM			0
 #endif
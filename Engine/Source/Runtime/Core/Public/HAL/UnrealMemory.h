@@ -117,6 +117,12 @@ struct CORE_API FMemory
 
 	static SIZE_T GetAllocSize( void* Original );
 
+	/** Lets the current thread cache freed memory, if GMalloc supports it. See FMalloc::SetupTLSCachesOnCurrentThread. */
+	static void SetupTLSCachesOnCurrentThread();
+
+	/** Gives the freed memory cached by the current thread back to GMalloc, must be called before the thread exits. */
+	static void ClearAndDisableTLSCachesOnCurrentThread();
+
 	/**
 	 * A helper function that will perform a series of random heap allocations to test
 	 * the internal validity of the heap. Note, this function will "leak" memory, but another call
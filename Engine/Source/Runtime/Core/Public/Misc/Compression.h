@@ -13,6 +13,8 @@ enum ECompressionFlags
 	COMPRESS_None					= 0x00,
 	/** Compress with ZLIB															*/
 	COMPRESS_ZLIB 					= 0x01,
+	/** Compress with LZ4 (lower ratio than ZLIB, but much faster to decompress)	*/
+	COMPRESS_LZ4					= 0x02,
 	/** Prefer compression that compresses smaller (ONLY VALID FOR COMPRESSION)		*/
 	COMPRESS_BiasMemory 			= 0x10,
 	/** Prefer compression that compresses faster (ONLY VALID FOR COMPRESSION)		*/
@@ -39,6 +41,62 @@ enum ECompressionFlags
 #define LOADING_COMPRESSION_CHUNK_SIZE			131072
 #define SAVING_COMPRESSION_CHUNK_SIZE			LOADING_COMPRESSION_CHUNK_SIZE
 
+/**
+ * Interface for compression codecs.
+ *
+ * Codecs are registered with FCompression under one of the compression types that fit into
+ * COMPRESSION_FLAGS_TYPE_MASK. The type is stored with the compressed data (i.e. in pak file
+ * entries), so it must not change once data has been shipped with it.
+ */
+class ICompressionCodec
+{
+public:
+
+	/**
+	 * Gets the codec's name, as used on command lines and in logs.
+	 *
+	 * @return The name, i.e. "ZLIB".
+	 */
+	virtual const TCHAR* GetName() const = 0;
+
+	/**
+	 * Gets the maximum size of the compressed data for a buffer of the given size.
+	 *
+	 * @param	UncompressedSize			Size of uncompressed data in bytes
+	 * @return The maximum possible bytes needed for compression of data buffer of size UncompressedSize
+	 */
+	virtual int32 CompressMemoryBound( int32 UncompressedSize ) const = 0;
+
+	/**
+	 * Compresses memory. Must be thread-safe.
+	 *
+	 * @param	Flags						Flags passed to FCompression::CompressMemory, to optionally control memory vs speed
+	 * @param	CompressedBuffer			Buffer compressed data is going to be written to
+	 * @param	CompressedSize	[in/out]	Size of CompressedBuffer, at exit will be size of compressed data
+	 * @param	UncompressedBuffer			Buffer containing uncompressed data
+	 * @param	UncompressedSize			Size of uncompressed data in bytes
+	 * @return true if compression succeeds, false if it fails because CompressedBuffer was too small or other reasons
+	 */
+	virtual bool CompressMemory( ECompressionFlags Flags, void* CompressedBuffer, int32& CompressedSize, const void* UncompressedBuffer, int32 UncompressedSize ) const = 0;
+
+	/**
+	 * Uncompresses memory. Must be thread-safe.
+	 *
+	 * @param	UncompressedBuffer			Buffer containing uncompressed data
+	 * @param	UncompressedSize			Size of uncompressed data in bytes
+	 * @param	CompressedBuffer			Buffer compressed data is going to be read from
+	 * @param	CompressedSize				Size of CompressedBuffer data in bytes
+	 * @return true if decompression succeeds, false otherwise
+	 */
+	virtual bool UncompressMemory( void* UncompressedBuffer, int32 UncompressedSize, const void* CompressedBuffer, int32 CompressedSize ) const = 0;
+
+public:
+
+	/** Virtual destructor. */
+	virtual ~ICompressionCodec() { }
+};
+
+
 struct FCompression
 {
 	/** Maximum allowed size of an uncompressed buffer passed to CompressMemory or UncompressMemory. */
@@ -86,6 +144,41 @@ struct FCompression
 	 * @return true if compression succeeds, false if it fails because CompressedBuffer was too small or other reasons
 	 */
 	CORE_API static bool UncompressMemory( ECompressionFlags Flags, void* UncompressedBuffer, int32 UncompressedSize, const void* CompressedBuffer, int32 CompressedSize, bool bIsSourcePadded = false );
+
+	/**
+	 * Registers a compression codec. ZLIB and LZ4 are always registered.
+	 *
+	 * Codecs should be registered at startup (i.e. in a module's StartupModule), before any data is
+	 * compressed or uncompressed with them, and must stay alive until they are unregistered.
+	 *
+	 * @param	CompressionType				The compression type to register the codec for (i.e. COMPRESS_LZ4)
+	 * @param	Codec						The codec
+	 * @return true if the codec was registered, false if the type is invalid or already has a codec
+	 */
+	CORE_API static bool RegisterCodec( ECompressionFlags CompressionType, ICompressionCodec* Codec );
+
+	/**
+	 * Unregisters a compression codec.
+	 *
+	 * @param	CompressionType				The compression type to unregister
+	 */
+	CORE_API static void UnregisterCodec( ECompressionFlags CompressionType );
+
+	/**
+	 * Gets the codec for the compression type specified in the given flags.
+	 *
+	 * @param	Flags						Flags specifying the compression type
+	 * @return The codec, or nullptr if no codec is registered for the type
+	 */
+	CORE_API static ICompressionCodec* GetCodec( ECompressionFlags Flags );
+
+	/**
+	 * Gets the compression type of a registered codec by name.
+	 *
+	 * @param	Name						The codec's name (case insensitive), i.e. "LZ4"
+	 * @return The compression type, or COMPRESS_None if no codec with this name is registered
+	 */
+	CORE_API static ECompressionFlags GetCompressionTypeFromName( const TCHAR* Name );
 };
 
 
@@ -529,6 +529,16 @@ public:
 		check(UsedMalloc);
 		return UsedMalloc->GetDescriptiveName(); 
 	}
+
+	virtual void SetupTLSCachesOnCurrentThread() override
+	{
+		UsedMalloc->SetupTLSCachesOnCurrentThread();
+	}
+
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+	{
+		UsedMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+	}
 };
 
 #endif //USE_MALLOC_PROFILER
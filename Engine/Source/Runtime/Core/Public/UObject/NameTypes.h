@@ -71,10 +71,14 @@ namespace FNameDefs
 #if !WITH_EDITORONLY_DATA
 	// Use a modest bucket count on consoles
 	static const uint32 NameHashBucketCount = 4096;
+	// Only the async loading thread competes with the game thread for names, and every shard keeps a partially used 64K pool
+	static const uint32 NameHashShardCount = 8;
 #else
 	// On PC platform we use a large number of name hash buckets to accommodate the editor's
 	// use of FNames to store asset path and content tags
 	static const uint32 NameHashBucketCount = 65536;
+	// Buckets are split between this many locks, so threads adding names rarely wait for each other
+	static const uint32 NameHashShardCount = 32;
 #endif
 }
 
@@ -244,7 +248,7 @@ public:
 	}
 
 	// Friend for access to Flags.
-	friend FNameEntry* AllocateNameEntry( const void* Name, NAME_INDEX Index, FNameEntry* HashNext, bool bIsPureAnsi );
+	friend FNameEntry* AllocateNameEntry( const void* Name, NAME_INDEX Index, FNameEntry* HashNext, bool bIsPureAnsi, uint32 ShardIndex );
 };
 
 /**
@@ -264,37 +268,44 @@ class TStaticIndirectArrayThreadSafeRead
 	};
 	/** Static master table to chunks of pointers **/
 	ElementType** Chunks[ChunkTableSize];
-	/** Number of elements we currently have **/
+	/** Number of elements we currently have, every chunk they are in is allocated **/
 	int32 NumElements;
+	/** Number of elements handed out by AddZeroed, some of them may not be counted in NumElements yet **/
+	int32 NumReserved;
 	/** Number of chunks we currently have **/
 	int32 NumChunks;
 
 	/**
-	 * Expands the array so that Element[Index] is allocated. New pointers are all zero.
+	 * Expands the array so that Element[Index] and every element before it are allocated. New pointers are all zero.
+	 * Thread safe, threads racing to allocate the same chunk keep the first one.
 	 * @param Index The Index of an element we want to be sure is allocated
 	 **/
 	void ExpandChunksToIndex(int32 Index)
 	{
 		check(Index >= 0 && Index < MaxTotalElements);
 		int32 ChunkIndex = Index / ElementsPerChunk;
-		while (1)
+		for (int32 NewChunkIndex = NumChunks; NewChunkIndex <= ChunkIndex; NewChunkIndex++)
 		{
-			if (ChunkIndex < NumChunks)
+			if (Chunks[NewChunkIndex])
 			{
-				break;
+				continue;
 			}
-			// add a chunk, and make sure nobody else tries
-			ElementType*** Chunk = &Chunks[ChunkIndex];
+			// add a chunk, unless someone else beat us to it
+			ElementType*** Chunk = &Chunks[NewChunkIndex];
 			ElementType** NewChunk = (ElementType**)FMemory::Malloc(sizeof(ElementType*) * ElementsPerChunk);
 			FMemory::Memzero(NewChunk, sizeof(ElementType*) * ElementsPerChunk);
 			if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)Chunk, NewChunk, nullptr))
 			{
-				// someone else beat us to the add, we don't support multiple concurrent adds
-				check(0)
+				FMemory::Free(NewChunk);
 			}
-			else
+		}
+		// every chunk up to ours exists now, publish them
+		while (true)
+		{
+			const int32 OldNumChunks = NumChunks;
+			if (OldNumChunks > ChunkIndex || FPlatformAtomics::InterlockedCompareExchange((volatile int32*)&NumChunks, ChunkIndex + 1, OldNumChunks) == OldNumChunks)
 			{
-				NumChunks++;
+				break;
 			}
 		}
 		check(ChunkIndex < NumChunks && Chunks[ChunkIndex]); // should have a valid pointer now
@@ -317,6 +328,7 @@ public:
 	/** Constructor : Probably not thread safe **/
 	TStaticIndirectArrayThreadSafeRead()
 		: NumElements(0)
+		, NumReserved(0)
 		, NumChunks(0)
 	{
 		FMemory::MemZero(Chunks);
@@ -355,17 +367,24 @@ public:
 	/** 
 	 * Add more elements to the array
 	 * @param	NumToAdd	Number of elements to add
-	 * @return	the number of elements in the container before we did the add. In other words, the add index.
-	 * Not thread safe. This should only be called by one thread, but the other methods can be called while this is going on.
+	 * @return	the index of the first added element. 
+	 * Thread safe, concurrent adds get separate ranges. Elements added by other threads may still be nullptr when Num() covers them.
 	**/
 	int32 AddZeroed(int32 NumToAdd)
 	{
-		int32 Result = NumElements;
-		check(NumElements + NumToAdd <= MaxTotalElements);
-		ExpandChunksToIndex(NumElements + NumToAdd - 1);
-		check(Result == NumElements);
-		NumElements += NumToAdd;
+		const int32 Result = FPlatformAtomics::InterlockedAdd((volatile int32*)&NumReserved, NumToAdd);
+		const int32 NewNum = Result + NumToAdd;
+		check(NewNum <= MaxTotalElements);
+		ExpandChunksToIndex(NewNum - 1);
 		FPlatformMisc::MemoryBarrier();
+		while (true)
+		{
+			const int32 OldNum = NumElements;
+			if (OldNum >= NewNum || FPlatformAtomics::InterlockedCompareExchange((volatile int32*)&NumElements, NewNum, OldNum) == OldNum)
+			{
+				break;
+			}
+		}
 		return Result;
 	}
 	/** 
@@ -825,6 +844,16 @@ public:
 
 	static void StaticInit();
 	static void DisplayHash( class FOutputDevice& Ar );
+
+	/**
+	 * Creates the names of a linker's name table a batch at a time, like FName(ENAME_LinkerConstructor, ...) does for each of them.
+	 * Names that already exist are found without locking, the others are added taking each shard lock only once per batch.
+	 *
+	 * @param	Entries		Name table entries, as serialized by operator<<(FArchive&, FNameEntry&)
+	 * @param	NumEntries	Number of entries
+	 * @param	OutNames	Receives one name for each entry
+	 */
+	static void CreateNameBatch( const FNameEntry* const* Entries, int32 NumEntries, FName* OutNames );
 	static FString SafeString( int32 InDisplayIndex, int32 InstanceNumber=NAME_NO_NUMBER_INTERNAL )
 	{
 		TNameEntryArray& Names = GetNames();
@@ -936,7 +965,7 @@ private:
 	friend const TCHAR* DebugFName(int32);
 	friend const TCHAR* DebugFName(int32, int32);
 	friend const TCHAR* DebugFName(FName&);
-	friend FNameEntry* AllocateNameEntry( const void* Name, NAME_INDEX Index, FNameEntry* HashNext, bool bIsPureAnsi );
+	friend FNameEntry* AllocateNameEntry( const void* Name, NAME_INDEX Index, FNameEntry* HashNext, bool bIsPureAnsi, uint32 ShardIndex );
 
 	/**
 	 * Shared initialization code (between two constructors)
@@ -982,8 +1011,14 @@ private:
 #endif
 	}
 
-	/** Singleton to retrieve the critical section. */
-	static FCriticalSection* GetCriticalSection();
+#if WITH_CASE_PRESERVING_NAME
+	/** Finds or adds the case sensitive variant of a name if its case doesn't match the comparison entry, returns the display index to use */
+	template <typename TCharType>
+	static int32 InitInternal_FindOrAddDisplayEntry(const TCharType* InName, const EFindName FindType, const int32 ComparisonIndex);
+#endif
+
+	/** Singleton to retrieve the critical section guarding adds to the name hash buckets of a shard. */
+	static FCriticalSection* GetShardCriticalSection(uint32 ShardIndex);
 
 };
 
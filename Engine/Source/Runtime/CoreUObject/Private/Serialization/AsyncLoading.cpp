@@ -799,6 +799,10 @@ EAsyncPackageState::Type FAsyncPackage::FinishObjects()
 		UObject* Object = GObjConstructedDuringAsyncLoading[ObjectIndex];
 		Object->ClearFlags( RF_AsyncLoading );
 	}
+	if (!bLoadHasFailed)
+	{
+		CreateClustersFromLoadedObjects(GObjConstructedDuringAsyncLoading);
+	}
 	GObjConstructedDuringAsyncLoading.Empty();
 			
 	// Simulate what EndLoad does.
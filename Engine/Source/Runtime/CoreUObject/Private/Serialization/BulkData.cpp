@@ -315,6 +315,10 @@ bool FUntypedBulkData::CanLoadFromDisk() const
  */
 ECompressionFlags FUntypedBulkData::GetDecompressionFlags() const
 {
+	if (BulkDataFlags & BULKDATA_SerializeCompressedLZ4)
+	{
+		return COMPRESS_LZ4;
+	}
 	return (BulkDataFlags & BULKDATA_SerializeCompressedZLIB) ? COMPRESS_ZLIB : COMPRESS_None;
 }
 
@@ -902,7 +906,7 @@ void FUntypedBulkData::DetachFromArchive( FArchive* Ar, bool bEnsureBulkDataIsLo
 /**
  * Sets whether we should store the data compressed on disk.
  *
- * @param CompressionFlags	Flags to use for compressing the data. Use COMPRESS_NONE for no compression, or something like COMPRESS_ZLIB to compress the data
+ * @param CompressionFlags	Flags to use for compressing the data. Use COMPRESS_NONE for no compression, or COMPRESS_ZLIB or COMPRESS_LZ4 to compress the data
  */
 void FUntypedBulkData::StoreCompressedOnDisk( ECompressionFlags CompressionFlags )
 {
@@ -918,9 +922,11 @@ void FUntypedBulkData::StoreCompressedOnDisk( ECompressionFlags CompressionFlags
 		}
 		else
 		{
-			// make sure a valid compression format was specified
-			check(CompressionFlags & COMPRESS_ZLIB);
-			BulkDataFlags |= (CompressionFlags & COMPRESS_ZLIB) ? BULKDATA_SerializeCompressedZLIB : BULKDATA_None;
+			// make sure a compression format that can be stored in the flags was specified
+			const int32 CompressionType = CompressionFlags & COMPRESSION_FLAGS_TYPE_MASK;
+			check(CompressionType == COMPRESS_ZLIB || CompressionType == COMPRESS_LZ4);
+			BulkDataFlags &= ~BULKDATA_SerializeCompressed;
+			BulkDataFlags |= (CompressionType == COMPRESS_LZ4) ? BULKDATA_SerializeCompressedLZ4 : BULKDATA_SerializeCompressedZLIB;
 
 			// make sure we are not forcing the bulkdata to be stored inline if we use compression
 			BulkDataFlags &= ~BULKDATA_ForceInlinePayload;
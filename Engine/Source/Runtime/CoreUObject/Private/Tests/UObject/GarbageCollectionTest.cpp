@@ -0,0 +1,96 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreUObjectPrivate.h"
+#include "AutomationTest.h"
+#include "UObject/GarbageCollectionClusters.h"
+
+/** Stores a reference in an object on another thread, the way async loading does. */
+class FGCClusterTestStoreRunnable : public FRunnable
+{
+public:
+	FGCClusterTestStoreRunnable( UObjectRedirector* InReferencingObject, UObject* InObject )
+		: ReferencingObject(InReferencingObject)
+		, Object(InObject)
+	{ }
+
+	virtual uint32 Run() override
+	{
+		ObjectWriteBarrier(Object, ReferencingObject);
+		ReferencingObject->DestinationObject = Object;
+		return 0;
+	}
+
+private:
+	UObjectRedirector* ReferencingObject;
+	UObject* Object;
+};
+
+/**
+ * Builds a cluster, stores references to objects outside of it in its members on this thread and another one, and
+ * checks garbage collection keeps those objects while collecting an unreferenced one.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGCClusterReferenceTest, "CoreUObject.GarbageCollection.ClusterReferences", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FGCClusterReferenceTest::RunTest( const FString& Parameters )
+{
+	UPackage* Package = CreatePackage(NULL, *MakeUniqueObjectName(NULL, UPackage::StaticClass(), FName(TEXT("/Temp/GCClusterTest"))).ToString());
+	UObjectRedirector* Root = NewNamedObject<UObjectRedirector>(Package, FName(TEXT("Root")), RF_Transient);
+	UObjectRedirector* Member = NewNamedObject<UObjectRedirector>(Package, FName(TEXT("Member")), RF_Transient);
+	UObjectRedirector* AddressMember = NewNamedObject<UObjectRedirector>(Package, FName(TEXT("AddressMember")), RF_Transient);
+	Root->DestinationObject = Member;
+	Member->DestinationObject = AddressMember;
+
+	const int32 ClusterIndex = CreateGCCluster(Root);
+	if (ClusterIndex == INDEX_NONE || GetGCClusterIndex(Member) != ClusterIndex || GetGCClusterIndex(AddressMember) != ClusterIndex)
+	{
+		AddError(TEXT("The referenced redirectors in the same package must join the cluster of the root"));
+		return false;
+	}
+	Root->AddToRoot();
+
+	UObject* Target = NewNamedObject<UObjectRedirector>(GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), UObjectRedirector::StaticClass(), FName(TEXT("GCClusterTestTarget"))), RF_Transient);
+	UObject* ThreadTarget = NewNamedObject<UObjectRedirector>(GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), UObjectRedirector::StaticClass(), FName(TEXT("GCClusterTestThreadTarget"))), RF_Transient);
+	UObject* AddressTarget = NewNamedObject<UObjectRedirector>(GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), UObjectRedirector::StaticClass(), FName(TEXT("GCClusterTestAddressTarget"))), RF_Transient);
+	UObject* Unreferenced = NewNamedObject<UObjectRedirector>(GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), UObjectRedirector::StaticClass(), FName(TEXT("GCClusterTestUnreferenced"))), RF_Transient);
+	TWeakObjectPtr<UObject> WeakTarget(Target);
+	TWeakObjectPtr<UObject> WeakAddressTarget(AddressTarget);
+	TWeakObjectPtr<UObject> WeakThreadTarget(ThreadTarget);
+	TWeakObjectPtr<UObject> WeakUnreferenced(Unreferenced);
+
+	// references gained after the cluster was created
+	ObjectWriteBarrier(Target, Member);
+	Member->DestinationObject = Target;
+
+	// the same, with only the address the reference is stored at, like reflected stores without an owner
+	ObjectWriteBarrier(AddressTarget, NULL, &AddressMember->DestinationObject);
+	AddressMember->DestinationObject = AddressTarget;
+
+	if (FPlatformProcess::SupportsMultithreading())
+	{
+		FGCClusterTestStoreRunnable Runnable(Root, ThreadTarget);
+		FRunnableThread* Thread = FRunnableThread::Create(&Runnable, TEXT("GCClusterTestStore"));
+		Thread->WaitForCompletion();
+		delete Thread;
+	}
+	else
+	{
+		ObjectWriteBarrier(ThreadTarget, Root);
+		Root->DestinationObject = ThreadTarget;
+	}
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	TestEqual(TEXT("The cluster must stay intact"), GetGCClusterIndex(Member), ClusterIndex);
+	TestTrue(TEXT("An object referenced by a cluster member after the cluster was created must be kept"), WeakTarget.IsValid());
+	TestTrue(TEXT("An object stored at an address in a cluster member must be kept"), WeakAddressTarget.IsValid());
+	TestTrue(TEXT("An object referenced by a cluster member from another thread must be kept"), WeakThreadTarget.IsValid());
+	TestFalse(TEXT("An unreferenced object must be collected"), WeakUnreferenced.IsValid());
+
+	// leave everything to the next garbage collection, which dissolves the cluster
+	Root->RemoveFromRoot();
+	Root->MarkPendingKill();
+	Member->MarkPendingKill();
+	AddressMember->MarkPendingKill();
+
+	return true;
+}
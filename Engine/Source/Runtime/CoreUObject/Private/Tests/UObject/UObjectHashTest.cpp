@@ -0,0 +1,187 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreUObjectPrivate.h"
+#include "AutomationTest.h"
+
+
+/** Creates named objects in a shared outer and finds them again, along with the objects of the other workers. */
+class FUObjectHashStressTestWorker : public FRunnable
+{
+public:
+	FUObjectHashStressTestWorker(UObject* InOuter, int32 InThreadIndex, int32 InNumThreads, int32 InNumObjects, FThreadSafeCounter& InNumReady, FEvent* InStartEvent)
+		: Outer(InOuter)
+		, ThreadIndex(InThreadIndex)
+		, NumThreads(InNumThreads)
+		, NumObjects(InNumObjects)
+		, NumReady(InNumReady)
+		, StartEvent(InStartEvent)
+		, NumNotFound(0)
+		, NumWrongFound(0)
+	{ }
+
+	static FName GetObjectName(int32 ThreadIndex, int32 ObjectIndex)
+	{
+		return FName(*FString::Printf(TEXT("HashStressTestObject_%d_%d"), ThreadIndex, ObjectIndex));
+	}
+
+	virtual uint32 Run() override
+	{
+		FRandomStream Random(ThreadIndex + 1);
+
+		NumReady.Increment();
+		StartEvent->Wait();
+
+		for (int32 ObjectIndex = 0; ObjectIndex < NumObjects; ObjectIndex++)
+		{
+			const FName Name = GetObjectName(ThreadIndex, ObjectIndex);
+			UObject* Object = NewNamedObject<UObject>(Outer, Name, RF_Transient);
+
+			// our own objects must always be found
+			if (StaticFindObjectFastInternal(UObject::StaticClass(), Outer, Name, true) != Object)
+			{
+				NumNotFound++;
+			}
+
+			// objects of other workers may not exist yet, but anything found must be what was asked for
+			const FName OtherName = GetObjectName(Random.RandHelper(NumThreads), Random.RandHelper(NumObjects));
+			UObject* Other = StaticFindObjectFastInternal(UObject::StaticClass(), Outer, OtherName, true);
+			if (Other && (Other->GetFName() != OtherName || Other->GetOuter() != Outer))
+			{
+				NumWrongFound++;
+			}
+		}
+
+		return 0;
+	}
+
+	int32 GetNumNotFound() const
+	{
+		return NumNotFound;
+	}
+
+	int32 GetNumWrongFound() const
+	{
+		return NumWrongFound;
+	}
+
+private:
+	UObject* Outer;
+	int32 ThreadIndex;
+	int32 NumThreads;
+	int32 NumObjects;
+	FThreadSafeCounter& NumReady;
+	FEvent* StartEvent;
+	int32 NumNotFound;
+	int32 NumWrongFound;
+};
+
+
+/**
+ * Constructs and finds objects from several threads at the same time while the game thread iterates the object
+ * array, then checks every object is in the name, outer and class hashes exactly once.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUObjectHashStressTest, "CoreUObject.UObject.HashStress", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game | EAutomationTestFlags::ATF_Commandlet)
+
+bool FUObjectHashStressTest::RunTest( const FString& Parameters )
+{
+	if (!FPlatformProcess::SupportsMultithreading())
+	{
+		AddLogItem(TEXT("Skipped, the platform doesn't support multithreading"));
+		return true;
+	}
+
+	const int32 NumThreads = 8;
+	const int32 NumObjects = 4096;
+
+	UObject* Outer = NewNamedObject<UObject>(GetTransientPackage(), MakeUniqueObjectName(GetTransientPackage(), UObject::StaticClass(), FName(TEXT("HashStressTestOuter"))), RF_Transient);
+	Outer->AddToRoot();
+
+	FThreadSafeCounter NumReady;
+	FEvent* StartEvent = FPlatformProcess::CreateSynchEvent(true);
+
+	TArray<FUObjectHashStressTestWorker*> Workers;
+	TArray<FRunnableThread*> Threads;
+	for (int32 Index = 0; Index < NumThreads; Index++)
+	{
+		Workers.Add(new FUObjectHashStressTestWorker(Outer, Index, NumThreads, NumObjects, NumReady, StartEvent));
+		Threads.Add(FRunnableThread::Create(Workers[Index], *FString::Printf(TEXT("UObjectHashStressTestWorker %d"), Index)));
+	}
+
+	while (NumReady.GetValue() < NumThreads)
+	{
+		FPlatformProcess::Sleep(0.0f);
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	StartEvent->Trigger();
+
+	// the object array must stay readable from this thread while the workers add to it
+	TWeakObjectPtr<UObject> WeakOuter(Outer);
+	int32 NumWeakFailures = 0;
+	for (int32 Pass = 0; Pass < 16; Pass++)
+	{
+		int32 NumIterated = 0;
+		for (FRawObjectIterator It; It; ++It)
+		{
+			NumWeakFailures += (WeakOuter.Get() != Outer) ? 1 : 0;
+			NumIterated++;
+		}
+		NumWeakFailures += (NumIterated == 0) ? 1 : 0;
+	}
+
+	int32 NumNotFound = 0;
+	int32 NumWrongFound = 0;
+	for (int32 Index = 0; Index < NumThreads; Index++)
+	{
+		Threads[Index]->WaitForCompletion();
+		NumNotFound += Workers[Index]->GetNumNotFound();
+		NumWrongFound += Workers[Index]->GetNumWrongFound();
+		delete Threads[Index];
+		delete Workers[Index];
+	}
+
+	AddLogItem(FString::Printf(TEXT("%d threads constructed %d objects in %.3f s"), NumThreads, NumThreads * NumObjects, FPlatformTime::Seconds() - StartTime));
+	TestEqual(TEXT("Objects must be found by the thread that constructed them"), NumNotFound, 0);
+	TestEqual(TEXT("Objects found must have the name and outer asked for"), NumWrongFound, 0);
+	TestEqual(TEXT("Weak pointers and iteration must work while objects are constructed"), NumWeakFailures, 0);
+
+	TArray<UObject*> Inners;
+	GetObjectsWithOuter(Outer, Inners, false);
+	TestEqual(TEXT("Every object must be in the outer map once"), Inners.Num(), NumThreads * NumObjects);
+
+	int32 NumMissing = 0;
+	for (int32 ThreadIndex = 0; ThreadIndex < NumThreads; ThreadIndex++)
+	{
+		for (int32 ObjectIndex = 0; ObjectIndex < NumObjects; ObjectIndex++)
+		{
+			if (!StaticFindObjectFastInternal(UObject::StaticClass(), Outer, FUObjectHashStressTestWorker::GetObjectName(ThreadIndex, ObjectIndex), true))
+			{
+				NumMissing++;
+			}
+		}
+	}
+	TestEqual(TEXT("Every object must be in the name hash after all threads finished"), NumMissing, 0);
+
+	TSet<UObject*> UniqueInners;
+	UniqueInners.Append(Inners);
+	int32 NumInClassMap = 0;
+	TArray<UObject*> ObjectsOfClass;
+	GetObjectsOfClass(UObject::StaticClass(), ObjectsOfClass, false);
+	for (int32 Index = 0; Index < ObjectsOfClass.Num(); Index++)
+	{
+		NumInClassMap += UniqueInners.Contains(ObjectsOfClass[Index]) ? 1 : 0;
+	}
+	TestEqual(TEXT("Every object must be in the class map once"), NumInClassMap, NumThreads * NumObjects);
+
+	// leave everything to the next garbage collection
+	for (int32 Index = 0; Index < Inners.Num(); Index++)
+	{
+		Inners[Index]->MarkPendingKill();
+	}
+	Outer->RemoveFromRoot();
+	Outer->MarkPendingKill();
+
+	delete StartEvent;
+
+	return true;
+}
@@ -6,7 +6,9 @@
 
 #include "CoreUObjectPrivate.h"
 #include "TaskGraphInterfaces.h"
+#include "ParallelFor.h"
 #include "IConsoleManager.h"
+#include "UObject/GarbageCollectionClusters.h"
 
 /*-----------------------------------------------------------------------------
    Garbage collection.
@@ -156,6 +158,618 @@ void SerializeRootSet( FArchive& Ar, EObjectFlags KeepFlags )
 	}
 }
 
+/*-----------------------------------------------------------------------------
+   Incremental reachability analysis.
+-----------------------------------------------------------------------------*/
+
+static TAutoConsoleVariable<int32> CVarIncrementalReachability(
+	TEXT("gc.IncrementalReachability"),
+	0,
+	TEXT("If 1, IncrementalCollectGarbage spreads marking reachable objects over several frames, relying on a write barrier on object properties.\n")
+	TEXT("Native code storing object references without calling ObjectWriteBarrier can hide objects from it, check with gc.VerifyIncrementalReachability."));
+
+static TAutoConsoleVariable<float> CVarIncrementalReachabilityTimeLimit(
+	TEXT("gc.IncrementalReachabilityTimeLimit"),
+	2.0f,
+	TEXT("Time in ms each IncrementalCollectGarbage call spends marking objects. The call that finishes marking takes longer."));
+
+static TAutoConsoleVariable<int32> CVarVerifyIncrementalReachability(
+	TEXT("gc.VerifyIncrementalReachability"),
+	0,
+	TEXT("If 1, objects are marked again stop-the-world once incremental marking finishes, and the results compared.\n")
+	TEXT("Reachable objects the incremental marker missed are logged as errors and kept. Slow, for debugging."));
+
+volatile bool GIsIncrementalReachabilityPending = false;
+
+/**
+ * State of an incremental reachability analysis. Marks are kept in a bit array indexed by object index rather than by
+ * clearing RF_Unreachable, so game code running between time slices never sees unreachable objects. Objects in the object
+ * array when marking started that are still unmarked at the end are unreachable. Objects created while marking are marked
+ * as they are created, and scanned once marking finishes along with the root set, as their references are set after that.
+ */
+class FIncrementalReachabilityAnalysis : public FUObjectArray::FUObjectCreateListener
+{
+public:
+	/**
+	 * Marks the root set and objects with any of the KeepFlags, and starts listening for new objects.
+	 *
+	 * @param KeepFlags		Objects with these flags will be kept regardless of being referenced or not
+	 */
+	FIncrementalReachabilityAnalysis( EObjectFlags KeepFlags );
+
+	virtual ~FIncrementalReachabilityAnalysis();
+
+	/**
+	 * Scans marked objects for references until all are scanned or the time limit passed.
+	 *
+	 * @param TimeLimit		Soft time limit in seconds
+	 * @return true if all marked objects have been scanned
+	 */
+	bool Tick( double TimeLimit );
+
+	/**
+	 * Rescans the root set and the objects created since marking started without a time limit, then sets RF_Unreachable
+	 * on every unmarked object. When verifying, the flags come from a stop-the-world mark instead, compared to ours.
+	 *
+	 * @param KeepFlags		Objects with these flags will be kept regardless of being referenced or not
+	 * @param bVerify		Whether to compare the result against a stop-the-world mark
+	 */
+	void Finish( EObjectFlags KeepFlags, bool bVerify );
+
+	/**
+	 * Marks an object. Thread-safe.
+	 *
+	 * @return true if this call marked the object, and its references must be scanned
+	 */
+	FORCEINLINE bool TryMark( const UObjectBase* Object )
+	{
+		const int32 Index = GUObjectArray.ObjectToIndex(Object);
+		// Objects created after marking started are marked by NotifyUObjectCreated
+		if (Index >= NumObjectsAtStart)
+		{
+			return false;
+		}
+		volatile int32* Word = MarkBits.GetData() + (Index >> 5);
+		const int32 Bit = 1 << (Index & 31);
+		while (true)
+		{
+			const int32 OldWord = *Word;
+			if (OldWord & Bit)
+			{
+				return false;
+			}
+			if (FPlatformAtomics::InterlockedCompareExchange(Word, OldWord | Bit, OldWord) == OldWord)
+			{
+				return true;
+			}
+		}
+	}
+
+	/** Marks an object a reference to was stored in another object, it gets scanned by the next time slice. Thread-safe. */
+	void MarkFromWriteBarrier( const UObjectBase* Object );
+
+	// FUObjectCreateListener interface
+	virtual void NotifyUObjectCreated( const UObjectBase* Object, int32 Index ) override;
+
+private:
+	FORCEINLINE bool IsMarked( int32 Index ) const
+	{
+		return Index >= NumObjectsAtStart || (MarkBits[Index >> 5] & (1 << (Index & 31))) != 0;
+	}
+
+	/** Adds the root set and objects with KeepFlags to ObjectsToSerialize, marking them, and assembles missing token streams. */
+	void AddRoots( EObjectFlags KeepFlags, bool bCountObjects );
+
+	/** Moves objects marked from other threads to ObjectsToSerialize. */
+	void GatherWriteBarrierObjects();
+
+	/** Number of objects in the object array when marking started, including free slots. */
+	const int32 NumObjectsAtStart;
+	/** One bit per object index below NumObjectsAtStart. */
+	TArray<int32> MarkBits;
+	/** Marked objects whose references haven't been scanned yet, only used on the game thread. */
+	TArray<UObject*> ObjectsToSerialize;
+	/** Guards WriteBarrierObjects and NewObjects, objects can be stored and created on any thread. */
+	FCriticalSection CriticalSection;
+	/** Objects marked by the write barrier, waiting to be moved to ObjectsToSerialize. */
+	TArray<UObject*> WriteBarrierObjects;
+	/** Objects created since marking started. */
+	TArray<UObject*> NewObjects;
+};
+
+/** The incremental reachability analysis in progress, if any. */
+static FIncrementalReachabilityAnalysis* GIncrementalReachability = NULL;
+
+/*-----------------------------------------------------------------------------
+   Object clusters.
+-----------------------------------------------------------------------------*/
+
+static TAutoConsoleVariable<int32> CVarCreateGCClusters(
+	TEXT("gc.CreateGCClusters"),
+	1,
+	TEXT("If 1, cooked assets that allow it are grouped on load with the objects in their package they reference into clusters,\n")
+	TEXT("which the garbage collector marks as one, only following references leaving them. Applies to assets loaded afterwards."));
+
+static TAutoConsoleVariable<int32> CVarVerifyGCClusters(
+	TEXT("gc.VerifyGCClusters"),
+	0,
+	TEXT("If 1, references of clustered objects are collected again before every collection. Clusters referencing objects\n")
+	TEXT("they don't know about are logged as errors and dissolved. Slow, for debugging."));
+
+volatile bool GHasObjectClusters = false;
+
+/**
+ * Objects loaded together, marked reachable as one by the garbage collector. Reaching any of them marks all of them,
+ * and only the references leaving the cluster are followed instead of every member's token stream.
+ */
+struct FUObjectCluster
+{
+	/** The loaded asset the cluster was created for. */
+	UObject* Root;
+	/** Every object in the cluster, including the root. */
+	TArray<UObject*> Objects;
+	/** Objects outside the cluster referenced by its objects. */
+	TSet<UObject*> ReferencedObjects;
+	/** Set to 1 by the thread that reached the cluster first in the reachability analysis in progress. */
+	FThreadSafeCounter Marked;
+};
+
+/**
+ * All object clusters, and which cluster each object index is in. Clusters are created when loading finishes and only
+ * read while marking, both on the game thread. A cluster is dissolved, its objects becoming regular ones, when any of
+ * them is destroyed, marked pending kill, or references an object marked pending kill.
+ *
+ * Only objects of types that don't change their references after PostLoad join clusters, see UObject::CanBeInCluster.
+ * References stored in members through ObjectWriteBarrier, with the member passed or an address in its memory, are added
+ * to the cluster: right away on the game thread, at the start of the next reachability analysis from other threads.
+ */
+class FUObjectClusters : public FUObjectArray::FUObjectDeleteListener
+{
+public:
+	FUObjectClusters()
+		: bListeningForDeletes(false)
+	{}
+
+	virtual ~FUObjectClusters()
+	{
+		if (bListeningForDeletes)
+		{
+			GUObjectArray.RemoveUObjectDeleteListener(this);
+		}
+	}
+
+	/** @return the index of the cluster the object is in, or INDEX_NONE. */
+	FORCEINLINE int32 GetClusterIndex( const UObjectBase* Object ) const
+	{
+		const int32 ObjectIndex = GUObjectArray.ObjectToIndex(Object);
+		return ObjectIndex < ObjectClusterIndices.Num() ? ObjectClusterIndices[ObjectIndex] : INDEX_NONE;
+	}
+
+	FORCEINLINE FUObjectCluster& GetCluster( int32 ClusterIndex )
+	{
+		return Clusters[ClusterIndex];
+	}
+
+	/**
+	 * Creates a cluster of Root and the objects it references, directly or through other members, that are in its package,
+	 * can be in a cluster and are in no other cluster yet.
+	 *
+	 * @return the index of the new cluster, or INDEX_NONE if none was created
+	 */
+	int32 CreateCluster( UObject* Root );
+
+	/** Dissolves the cluster the object is in, if any. */
+	void DissolveClusterContaining( const UObjectBase* Object )
+	{
+		const int32 ClusterIndex = GetClusterIndex(Object);
+		if (ClusterIndex != INDEX_NONE)
+		{
+			DissolveCluster(ClusterIndex);
+		}
+	}
+
+	/**
+	 * Adds Object to the references of the cluster ReferencingObject is in, or else of the cluster whose member's memory
+	 * contains ReferenceAddress, if any. Can be called from any thread.
+	 */
+	void AddReferencedObject( const UObjectBase* ReferencingObject, const void* ReferenceAddress, const UObjectBase* Object );
+
+	/**
+	 * Resets marks before a reachability analysis, adds references stored from other threads, and dissolves clusters
+	 * referencing objects marked pending kill, as references to those have to be cleared by following their members'
+	 * token streams.
+	 */
+	void BeginReachabilityAnalysis();
+
+	// FUObjectDeleteListener interface
+	virtual void NotifyUObjectDeleted( const UObjectBase* Object, int32 Index ) override
+	{
+		if (Index < ObjectClusterIndices.Num() && ObjectClusterIndices[Index] != INDEX_NONE)
+		{
+			DissolveCluster(ObjectClusterIndices[Index]);
+		}
+	}
+
+private:
+	/** A reference stored in a cluster member on another thread, added to the cluster on the game thread. */
+	struct FPendingReference
+	{
+		int32 ClusterIndex;
+		UObject* Object;
+	};
+
+	/** The memory of a cluster member, to find the cluster a reference stored by address is in. */
+	struct FMemberRange
+	{
+		const uint8* Start;
+		const uint8* End;
+		int32 ClusterIndex;
+
+		bool operator<( const FMemberRange& Other ) const
+		{
+			return Start < Other.Start;
+		}
+	};
+
+	/** @return the index of the cluster whose member's memory contains Address, or INDEX_NONE. */
+	int32 FindClusterIndexByAddress( const void* Address ) const;
+
+	void DissolveCluster( int32 ClusterIndex );
+
+	/** @return true if every reference of the cluster's objects is to a member, to a referenced object, or to the permanent pool. */
+	bool VerifyCluster( int32 ClusterIndex );
+
+	/** Collects the references the token stream of an object follows, Class and Outer included. */
+	static void FindObjectReferences( UObject* Object, TSet<UObject*>& OutReferences );
+
+	TSparseArray<FUObjectCluster> Clusters;
+	/** Cluster index for each object index, INDEX_NONE for objects in no cluster. Grown as clusters are created. */
+	TArray<int32> ObjectClusterIndices;
+	/** References stored in cluster members on other threads since the last reachability analysis. */
+	TArray<FPendingReference> PendingReferences;
+	/** Memory of every cluster member, sorted by address. Members never overlap. */
+	TArray<FMemberRange> MemberRanges;
+	/** Guards changes to the clusters against the write barrier on other threads. Marking reads them without it. */
+	FCriticalSection ClustersCritical;
+	bool bListeningForDeletes;
+};
+
+static FUObjectClusters GUObjectClusters;
+
+void ObjectWriteBarrierSlow( const UObjectBase* Object, const UObjectBase* ReferencingObject, const void* ReferenceAddress )
+{
+	if ((ReferencingObject || ReferenceAddress) && GHasObjectClusters)
+	{
+		GUObjectClusters.AddReferencedObject(ReferencingObject, ReferenceAddress, Object);
+	}
+
+	// The analysis can't be finished or abandoned while objects are stored on other threads, those only happen during
+	// async loading, which both wait for.
+	FIncrementalReachabilityAnalysis* IncrementalReachability = GIncrementalReachability;
+	if (IncrementalReachability && !GUObjectAllocator.ResidesInPermanentPool(Object))
+	{
+		IncrementalReachability->MarkFromWriteBarrier(Object);
+	}
+}
+
+/** Collects object references into a set, cluster members can reference the same objects many times. */
+class FClusterReferenceCollector : public FReferenceCollector
+{
+public:
+	FClusterReferenceCollector( TSet<UObject*>& InReferences )
+		: References( InReferences )
+	{}
+
+	virtual void HandleObjectReference( UObject*& Object, const UObject* ReferencingObject, const UObject* ReferencingProperty ) override
+	{
+		if( Object )
+		{
+			References.Add( Object );
+		}
+	}
+	virtual bool IsIgnoringArchetypeRef() const override { return false; }
+	virtual bool IsIgnoringTransient() const override { return false; }
+
+private:
+	TSet<UObject*>& References;
+};
+
+void FUObjectClusters::FindObjectReferences( UObject* Object, TSet<UObject*>& OutReferences )
+{
+	// See FReferenceFinder::FindReferences
+	FClusterReferenceCollector Collector( OutReferences );
+	if( !Object->GetClass()->IsChildOf( UClass::StaticClass() ) )
+	{
+		FSimpleObjectReferenceCollectorArchive CollectorArchive( Object, Collector );
+		Object->SerializeScriptProperties( CollectorArchive );
+	}
+	Object->CallAddReferencedObjects( Collector );
+
+	// See UObjectBase::EmitBaseReferences
+	OutReferences.Add( Object->GetClass() );
+	if( Object->GetOuter() )
+	{
+		OutReferences.Add( Object->GetOuter() );
+	}
+}
+
+int32 FUObjectClusters::CreateCluster( UObject* Root )
+{
+	check(IsInGameThread());
+
+	if (GetClusterIndex(Root) != INDEX_NONE || GUObjectAllocator.ResidesInPermanentPool(Root) || Root->HasAnyFlags(RF_PendingKill|RF_RootSet|RF_NeedLoad|RF_NeedPostLoad|RF_AsyncLoading))
+	{
+		return INDEX_NONE;
+	}
+
+	const UPackage* Package = Root->GetOutermost();
+
+	FUObjectCluster Cluster;
+	Cluster.Root = Root;
+	TSet<UObject*> Members;
+	TArray<UObject*> ObjectsToScan;
+	TSet<UObject*> References;
+	Members.Add( Root );
+	ObjectsToScan.Add( Root );
+
+	while( ObjectsToScan.Num() )
+	{
+		UObject* Object = ObjectsToScan.Pop( false );
+		Cluster.Objects.Add( Object );
+
+		References.Reset();
+		FindObjectReferences( Object, References );
+		for( TSet<UObject*>::TConstIterator It(References); It; ++It )
+		{
+			UObject* Reference = *It;
+			if( GUObjectAllocator.ResidesInPermanentPool(Reference) || Members.Contains(Reference) || Cluster.ReferencedObjects.Contains(Reference) )
+			{
+				continue;
+			}
+
+			// Anything that could be kept alive, or changed, on its own has to stay outside
+			const bool bCanJoin = Reference->IsIn( Package ) && Reference->CanBeInCluster() && GetClusterIndex( Reference ) == INDEX_NONE &&
+				!Reference->HasAnyFlags( RF_PendingKill|RF_RootSet|RF_NeedLoad|RF_NeedPostLoad|RF_AsyncLoading );
+			if( bCanJoin )
+			{
+				Members.Add( Reference );
+				ObjectsToScan.Add( Reference );
+			}
+			else
+			{
+				Cluster.ReferencedObjects.Add( Reference );
+			}
+		}
+	}
+
+	// A single object is scanned as fast through its token stream
+	if( Cluster.Objects.Num() < 2 )
+	{
+		return INDEX_NONE;
+	}
+
+	FScopeLock ClustersLock( &ClustersCritical );
+
+	const int32 ClusterIndex = Clusters.Add( Cluster );
+	for( int32 MemberIndex = 0; MemberIndex < Cluster.Objects.Num(); MemberIndex++ )
+	{
+		const int32 ObjectIndex = GUObjectArray.ObjectToIndex( Cluster.Objects[MemberIndex] );
+		if( ObjectIndex >= ObjectClusterIndices.Num() )
+		{
+			const int32 OldNum = ObjectClusterIndices.Num();
+			ObjectClusterIndices.AddUninitialized( ObjectIndex + 1 - OldNum );
+			for( int32 Index = OldNum; Index < ObjectClusterIndices.Num(); Index++ )
+			{
+				ObjectClusterIndices[Index] = INDEX_NONE;
+			}
+		}
+		ObjectClusterIndices[ObjectIndex] = ClusterIndex;
+
+		FMemberRange& Range = *new(MemberRanges) FMemberRange;
+		Range.Start = (const uint8*)Cluster.Objects[MemberIndex];
+		Range.End = Range.Start + Cluster.Objects[MemberIndex]->GetClass()->GetPropertiesSize();
+		Range.ClusterIndex = ClusterIndex;
+	}
+	MemberRanges.Sort();
+	GHasObjectClusters = true;
+
+	if( !bListeningForDeletes )
+	{
+		GUObjectArray.AddUObjectDeleteListener( this );
+		bListeningForDeletes = true;
+	}
+
+	UE_LOG(LogGarbage, Verbose, TEXT("Created GC cluster for %s with %d objects and %d referenced objects"), *Root->GetFullName(), Cluster.Objects.Num(), Cluster.ReferencedObjects.Num());
+	return ClusterIndex;
+}
+
+void FUObjectClusters::DissolveCluster( int32 ClusterIndex )
+{
+	check(IsInGameThread());
+
+	FScopeLock ClustersLock( &ClustersCritical );
+
+	FUObjectCluster& Cluster = Clusters[ClusterIndex];
+	for( int32 MemberIndex = 0; MemberIndex < Cluster.Objects.Num(); MemberIndex++ )
+	{
+		ObjectClusterIndices[GUObjectArray.ObjectToIndex( Cluster.Objects[MemberIndex] )] = INDEX_NONE;
+	}
+	Clusters.RemoveAt( ClusterIndex );
+
+	// The members follow their own token streams again, and the index may be reused by the next cluster
+	for( int32 PendingIndex = PendingReferences.Num() - 1; PendingIndex >= 0; PendingIndex-- )
+	{
+		if( PendingReferences[PendingIndex].ClusterIndex == ClusterIndex )
+		{
+			PendingReferences.RemoveAtSwap( PendingIndex );
+		}
+	}
+
+	// Keeps the order
+	int32 NumRanges = 0;
+	for( int32 RangeIndex = 0; RangeIndex < MemberRanges.Num(); RangeIndex++ )
+	{
+		if( MemberRanges[RangeIndex].ClusterIndex != ClusterIndex )
+		{
+			MemberRanges[NumRanges++] = MemberRanges[RangeIndex];
+		}
+	}
+	MemberRanges.SetNum( NumRanges, false );
+
+	// Stays a delete listener, this may be called while the listeners are notified
+	if( Clusters.Num() == 0 )
+	{
+		ObjectClusterIndices.Empty();
+		MemberRanges.Empty();
+		GHasObjectClusters = false;
+	}
+}
+
+int32 FUObjectClusters::FindClusterIndexByAddress( const void* Address ) const
+{
+	// Last range starting at or before the address
+	int32 Min = 0;
+	int32 Max = MemberRanges.Num();
+	while( Min < Max )
+	{
+		const int32 Mid = (Min + Max) / 2;
+		if( MemberRanges[Mid].Start <= (const uint8*)Address )
+		{
+			Min = Mid + 1;
+		}
+		else
+		{
+			Max = Mid;
+		}
+	}
+	return (Min > 0 && (const uint8*)Address < MemberRanges[Min - 1].End) ? MemberRanges[Min - 1].ClusterIndex : INDEX_NONE;
+}
+
+void FUObjectClusters::AddReferencedObject( const UObjectBase* ReferencingObject, const void* ReferenceAddress, const UObjectBase* Object )
+{
+	FScopeLock ClustersLock( &ClustersCritical );
+
+	int32 ClusterIndex = ReferencingObject ? GetClusterIndex( ReferencingObject ) : INDEX_NONE;
+	if( ClusterIndex == INDEX_NONE && ReferenceAddress )
+	{
+		ClusterIndex = FindClusterIndexByAddress( ReferenceAddress );
+	}
+	if( ClusterIndex == INDEX_NONE || GUObjectAllocator.ResidesInPermanentPool( Object ) || GetClusterIndex( Object ) == ClusterIndex )
+	{
+		return;
+	}
+
+	UObject* Reference = (UObject*)Object;
+	if( IsInGameThread() )
+	{
+		// Marking happens on the game thread, or with it waiting, so the set doesn't change while it is read
+		Clusters[ClusterIndex].ReferencedObjects.Add( Reference );
+	}
+	else
+	{
+		FPendingReference& Pending = *new(PendingReferences) FPendingReference;
+		Pending.ClusterIndex = ClusterIndex;
+		Pending.Object = Reference;
+	}
+}
+
+bool FUObjectClusters::VerifyCluster( int32 ClusterIndex )
+{
+	const FUObjectCluster& Cluster = Clusters[ClusterIndex];
+	const int32 MaxReferencesToLog = 8;
+	int32 NumUnknownReferences = 0;
+
+	TSet<UObject*> References;
+	for( int32 MemberIndex = 0; MemberIndex < Cluster.Objects.Num(); MemberIndex++ )
+	{
+		UObject* Object = Cluster.Objects[MemberIndex];
+		References.Reset();
+		FindObjectReferences( Object, References );
+		for( TSet<UObject*>::TConstIterator It(References); It; ++It )
+		{
+			UObject* Reference = *It;
+			if( !GUObjectAllocator.ResidesInPermanentPool(Reference) && GetClusterIndex(Reference) != ClusterIndex && !Cluster.ReferencedObjects.Contains(Reference) )
+			{
+				if( NumUnknownReferences++ < MaxReferencesToLog )
+				{
+					UE_LOG(LogGarbage, Error, TEXT("GC cluster object %s references %s, which the cluster doesn't know about"), *Object->GetFullName(), *Reference->GetFullName());
+				}
+			}
+		}
+	}
+
+	if( NumUnknownReferences )
+	{
+		UE_LOG(LogGarbage, Error, TEXT("Dissolving GC cluster for %s, its objects changed %d references after it was created"), *Cluster.Root->GetFullName(), NumUnknownReferences);
+	}
+	return NumUnknownReferences == 0;
+}
+
+void FUObjectClusters::BeginReachabilityAnalysis()
+{
+	check(IsInGameThread());
+
+	{
+		FScopeLock ClustersLock( &ClustersCritical );
+		for( int32 PendingIndex = 0; PendingIndex < PendingReferences.Num(); PendingIndex++ )
+		{
+			const FPendingReference& Pending = PendingReferences[PendingIndex];
+			Clusters[Pending.ClusterIndex].ReferencedObjects.Add( Pending.Object );
+		}
+		PendingReferences.Empty();
+	}
+
+	const bool bVerify = CVarVerifyGCClusters.GetValueOnGameThread() != 0;
+	TArray<int32> ClustersToDissolve;
+	for( TSparseArray<FUObjectCluster>::TIterator It(Clusters); It; ++It )
+	{
+		FUObjectCluster& Cluster = *It;
+		Cluster.Marked.Reset();
+
+		bool bDissolve = bVerify && !VerifyCluster( It.GetIndex() );
+		for( TSet<UObject*>::TConstIterator ReferenceIt(Cluster.ReferencedObjects); ReferenceIt && !bDissolve; ++ReferenceIt )
+		{
+			bDissolve = (*ReferenceIt)->HasAnyFlags( RF_PendingKill );
+		}
+		if( bDissolve )
+		{
+			ClustersToDissolve.Add( It.GetIndex() );
+		}
+	}
+
+	for( int32 Index = 0; Index < ClustersToDissolve.Num(); Index++ )
+	{
+		DissolveCluster( ClustersToDissolve[Index] );
+	}
+}
+
+void CreateClustersFromLoadedObjects( const TArray<UObject*>& LoadedObjects )
+{
+	if( GIsEditor || !FPlatformProperties::RequiresCookedData() || !CVarCreateGCClusters.GetValueOnGameThread() )
+	{
+		return;
+	}
+
+	for( int32 Index = 0; Index < LoadedObjects.Num(); Index++ )
+	{
+		UObject* Object = LoadedObjects[Index];
+		if( Object->CanBeClusterRoot() )
+		{
+			GUObjectClusters.CreateCluster( Object );
+		}
+	}
+}
+
+int32 CreateGCCluster( UObject* Root )
+{
+	return GUObjectClusters.CreateCluster( Root );
+}
+
+int32 GetGCClusterIndex( const UObjectBase* Object )
+{
+	return GUObjectClusters.GetClusterIndex( Object );
+}
+
 /**
  * Handles object reference, potentially NULL'ing
  *
@@ -170,7 +784,19 @@ static FORCEINLINE void HandleObjectReference(TArray<UObject*>& ObjectsToSeriali
 	// cache friendly as it's just a pointer compare against to globals.
 	if( Object )
 	{
-		if( !GUObjectAllocator.ResidesInPermanentPool(Object) )
+		if( GIncrementalReachability && !GUObjectAllocator.ResidesInPermanentPool(Object) )
+		{
+			// Marks live in the incremental analysis rather than in RF_Unreachable, see FIncrementalReachabilityAnalysis
+			if( Object->HasAnyFlags( RF_PendingKill ) && bAllowReferenceElimination )
+			{
+				Object = NULL;
+			}
+			else if( GIncrementalReachability->TryMark( Object ) )
+			{
+				ObjectsToSerialize.Add( Object );
+			}
+		}
+		else if( !GUObjectAllocator.ResidesInPermanentPool(Object) )
 		{
 			UObject* ObjectToAdd = Object->HasAnyFlags( RF_Unreachable ) ? Object : NULL;
 			// Remove references to pending kill objects if we're allowed to do so.
@@ -380,38 +1006,12 @@ private:
 		int32		LoopStartIndex;
 	};
 
-	class FGCTask
+	enum
 	{
-		FArchiveRealtimeGC*	Owner;
-		TArray<UObject*>	ObjectsToSerialize;
-
-	public:
-		FGCTask(FArchiveRealtimeGC* InOwner, const TArray<UObject*>* InObjectsToSerialize,int32 StartIndex, int32 NumObjects)
-			: Owner(InOwner)
-		{
-			ObjectsToSerialize.Reserve(NumObjects);
-			while (NumObjects)
-			{
-				ObjectsToSerialize.Add((*InObjectsToSerialize)[StartIndex++]);
-				NumObjects--;
-			}
-		}
-		FORCEINLINE TStatId GetStatId() const
-		{
-			RETURN_QUICK_DECLARE_CYCLE_STAT(FGCTask, STATGROUP_TaskGraphTasks);
-		}
-		static ENamedThreads::Type GetDesiredThread()
-		{
-			return ENamedThreads::AnyThread;
-		}
-		static ESubsequentsMode::Type GetSubsequentsMode() 
-		{ 
-			return ESubsequentsMode::TrackSubsequents; 
-		}
-		void DoTask(ENamedThreads::Type CurrentThread, FGraphEventRef& MyCompletionGraphEvent)
-		{
-			Owner->ProcessObjectArray(ObjectsToSerialize, MyCompletionGraphEvent);
-		}
+		/** Objects found by a thread are shared with the other threads once there are at least this many. Sometimes there will be less, a lot less */
+		MinDesiredObjectsPerSubTask = 128,
+		/** Nested parallel loops beyond this depth continue on the current thread, to bound stack use on deep object graphs */
+		MaxParallelNestingDepth = 16,
 	};
 
 public:
@@ -437,6 +1037,8 @@ public:
 		// Presize array and add a bit of extra slack for prefetching.
 		ObjectsToSerialize.Empty( GUObjectArray.GetObjectArrayNumMinusPermanent() + 2 );
 
+		GUObjectClusters.BeginReachabilityAnalysis();
+
 		for ( FRawObjectIterator It(true); It; ++It )
 		{
 			UObject* Object = *It;
@@ -449,6 +1051,12 @@ public:
 			// Keep track of how many objects are around.
 			GObjectCountDuringLastMarkPhase++;
 
+			// References to objects marked pending kill are cleared through the token stream, which clusters skip
+			if( Object->HasAnyFlags( RF_PendingKill ) )
+			{
+				GUObjectClusters.DissolveClusterContaining( Object );
+			}
+
 			// Special case handling for objects that are part of the root set.
 			if( Object->HasAnyFlags( RF_RootSet ) )
 			{
@@ -488,43 +1096,241 @@ public:
 
 			if ( bForceSingleThreaded )
 			{
-				FGraphEventRef InvalidRef;
-				ProcessObjectArray( ObjectsToSerialize, InvalidRef );
+				ProcessObjectArray( ObjectsToSerialize, 0 );
 			}
 			else
 			{				
 				GIsRunningParallelReachability = true;
+				ProcessObjectArrayInParallel( ObjectsToSerialize, 0 );
+				GIsRunningParallelReachability = false;
+			}
+		}
+	}
+
+	/**
+	 * Splits objects into batches processed by all worker threads and this one, and returns once they and
+	 * everything they reference have been processed.
+	 */
+	void ProcessObjectArrayInParallel(const TArray<UObject*>& Objects, int32 Depth)
+	{
+		const int32 NumBatches = FMath::Max<int32>(1, Objects.Num() / MinDesiredObjectsPerSubTask);
+		ParallelFor(NumBatches, [&](int32 BatchIndex)
+		{
+			const int32 StartIndex = (int32)((int64)Objects.Num() * BatchIndex / NumBatches);
+			const int32 EndIndex = (int32)((int64)Objects.Num() * (BatchIndex + 1) / NumBatches);
+			TArray<UObject*> Batch;
+			Batch.Append(Objects.GetData() + StartIndex, EndIndex - StartIndex);
+			ProcessObjectArray(Batch, Depth + 1);
+		}, EParallelForFlags::Unbalanced);
+	}
+
+	/**
+	 * Follows the references of one object using its class' token stream, adding objects they reach for the first time
+	 * to NewObjectsToSerialize.
+	 */
+	FORCEINLINE void ProcessObject(UObject* CurrentObject, TArray<UObject*>& NewObjectsToSerialize, FGCCollector& ReferenceCollector, TArray<FStackEntry>& Stack)
+	{
+		const int32 ClusterIndex = GUObjectClusters.GetClusterIndex( CurrentObject );
+		if( ClusterIndex != INDEX_NONE )
+		{
+			ProcessCluster( GUObjectClusters.GetCluster( ClusterIndex ), NewObjectsToSerialize );
+			return;
+		}
+
+		//@todo rtgc: we need to handle object references in struct defaults
+
+		// Make sure that token stream has been assembled at this point as the below code relies on it.
+		checkSlow( CurrentObject->GetClass()->HasAnyClassFlags(CLASS_TokenStreamAssembled) );
+
+		// Get pointer to token stream and jump to the start.
+		FGCReferenceTokenStream* RESTRICT TokenStream = &CurrentObject->GetClass()->ReferenceTokenStream;
+		uint32 TokenStreamIndex			= 0;
+		// Keep track of index to reference info. Used to avoid LHSs.
+		uint32 ReferenceTokenStreamIndex	= 0;
+
+		// Create stack entry and initialize sane values.
+		FStackEntry* RESTRICT StackEntry = Stack.GetData();
+		uint8* StackEntryData		= (uint8*) CurrentObject;
+		StackEntry->Data			= StackEntryData;
+		StackEntry->Stride			= 0;
+		StackEntry->Count			= -1;
+		StackEntry->LoopStartIndex	= -1;
+	
+		// Keep track of token return count in separate integer as arrays need to fiddle with it.
+		int32 TokenReturnCount		= 0;
+
+		// Parse the token stream.
+		while( true )
+		{
+			// Cache current token index as it is the one pointing to the reference info.
+			ReferenceTokenStreamIndex = TokenStreamIndex;
 
-				int32 NumChunks = FMath::Min<int32>(FTaskGraphInterface::Get().GetNumWorkerThreads(), ObjectsToSerialize.Num());
-				int32 NumPerChunk = ObjectsToSerialize.Num() / NumChunks;
-				check(NumPerChunk > 0);
-				FGraphEventArray ChunkTasks;
-				ChunkTasks.Empty(NumChunks);
-				int32 StartIndex = 0;
-				for (int32 Chunk = 0; Chunk < NumChunks; Chunk++)
+			// Handle returning from an array of structs, array of structs of arrays of ... (yadda yadda)
+			for( int32 ReturnCount=0; ReturnCount<TokenReturnCount; ReturnCount++ )
+			{
+				// Make sure there's no stack underflow.
+				check( StackEntry->Count != -1 );
+
+				// We pre-decrement as we're already through the loop once at this point.
+				if( --StackEntry->Count > 0 )
 				{
-					if (Chunk + 1 == NumChunks)
-					{
-						NumPerChunk = ObjectsToSerialize.Num() - StartIndex; // last chunk takes all remaining items
-					}
-					ChunkTasks.Add(TGraphTask<FGCTask>::CreateTask().ConstructAndDispatchWhenReady(this, &ObjectsToSerialize, StartIndex, NumPerChunk));
-					StartIndex += NumPerChunk;
+					// Point data to next entry.
+					StackEntryData	 = StackEntry->Data + StackEntry->Stride;
+					StackEntry->Data = StackEntryData;
+
+					// Jump back to the beginning of the loop.
+					TokenStreamIndex = StackEntry->LoopStartIndex;
+					ReferenceTokenStreamIndex = StackEntry->LoopStartIndex;
+					// We're not done with this token loop so we need to early out instead of backing out further.
+					break;
 				}
-				FTaskGraphInterface::Get().WaitUntilTasksComplete(ChunkTasks, ENamedThreads::GameThread_Local);
-				GIsRunningParallelReachability = false;
+				else
+				{
+					StackEntry--;
+					StackEntryData = StackEntry->Data;
+				}
+			}
+
+			// Instead of reading information about reference from stream and caching it like below we access
+			// the same memory address over and over and over again to avoid a nasty LHS penalty. Not reading 
+			// the reference info means we need to manually increment the token index to skip to the next one.
+			TokenStreamIndex++;
+			// Helper to make code more readable and hide the ugliness that is avoiding LHSs from caching.
+			#define	REFERENCE_INFO TokenStream->AccessReferenceInfo( ReferenceTokenStreamIndex )
+
+			if( REFERENCE_INFO.Type == GCRT_Object )
+			{	
+				// We're dealing with an object reference.
+				UObject**	ObjectPtr	= (UObject**)(StackEntryData + REFERENCE_INFO.Offset);
+				UObject*&	Object		= *ObjectPtr;
+				TokenReturnCount		= REFERENCE_INFO.ReturnCount;
+				HandleTokenStreamObjectReference(NewObjectsToSerialize, CurrentObject, Object, ReferenceTokenStreamIndex, true);
+			}
+			else if( REFERENCE_INFO.Type == GCRT_ArrayObject )
+			{
+				// We're dealing with an array of object references.
+				TArray<UObject*>& ObjectArray = *((TArray<UObject*>*)(StackEntryData + REFERENCE_INFO.Offset));
+				TokenReturnCount = REFERENCE_INFO.ReturnCount;
+				for( int32 ObjectIndex=0; ObjectIndex<ObjectArray.Num(); ObjectIndex++ )
+				{
+					UObject*& Object = ObjectArray[ObjectIndex];
+					HandleTokenStreamObjectReference(NewObjectsToSerialize, CurrentObject, Object, ReferenceTokenStreamIndex, true);
+				}
+			}
+			else if( REFERENCE_INFO.Type == GCRT_ArrayStruct )
+			{
+				// We're dealing with a dynamic array of structs.
+				const FScriptArray& Array = *((FScriptArray*)(StackEntryData + REFERENCE_INFO.Offset));
+				StackEntry++;
+				StackEntryData				= (uint8*) Array.GetData();
+				StackEntry->Data			= StackEntryData;
+				StackEntry->Stride			= TokenStream->ReadStride( TokenStreamIndex );
+				StackEntry->Count			= Array.Num();
+			
+				const FGCSkipInfo SkipInfo	= TokenStream->ReadSkipInfo( TokenStreamIndex );
+				StackEntry->LoopStartIndex	= TokenStreamIndex;
+			
+				if( StackEntry->Count == 0 )
+				{
+					// Skip empty array by jumping to skip index and set return count to the one about to be read in.
+					TokenStreamIndex		= SkipInfo.SkipIndex;
+					TokenReturnCount		= TokenStream->GetSkipReturnCount( SkipInfo );
+				}
+				else
+				{	
+					// Loop again.
+					check( StackEntry->Data );
+					TokenReturnCount		= 0;
+				}
+			}
+			else if( REFERENCE_INFO.Type == GCRT_PersistentObject )
+			{
+				// We're dealing with an object reference.
+				UObject**	ObjectPtr	= (UObject**)(StackEntryData + REFERENCE_INFO.Offset);
+				UObject*&	Object		= *ObjectPtr;
+				TokenReturnCount		= REFERENCE_INFO.ReturnCount;
+				HandleTokenStreamObjectReference(NewObjectsToSerialize, CurrentObject, Object, ReferenceTokenStreamIndex, false);
+			}
+			else if( REFERENCE_INFO.Type == GCRT_FixedArray )
+			{
+				// We're dealing with a fixed size array
+				uint8* PreviousData	= StackEntryData;
+				StackEntry++;
+				StackEntryData				= PreviousData;
+				StackEntry->Data			= PreviousData;
+				StackEntry->Stride			= TokenStream->ReadStride( TokenStreamIndex );
+				StackEntry->Count			= TokenStream->ReadCount( TokenStreamIndex );
+				StackEntry->LoopStartIndex	= TokenStreamIndex;
+				TokenReturnCount			= 0;
+			}
+			else if( REFERENCE_INFO.Type == GCRT_AddStructReferencedObjects )
+			{
+				// We're dealing with a function call
+				void const*	StructPtr	= (void*)(StackEntryData + REFERENCE_INFO.Offset);
+				TokenReturnCount		= REFERENCE_INFO.ReturnCount;
+				UScriptStruct::ICppStructOps::TPointerToAddStructReferencedObjects Func = (UScriptStruct::ICppStructOps::TPointerToAddStructReferencedObjects) TokenStream->ReadPointer( TokenStreamIndex );
+				Func(StructPtr, ReferenceCollector);
+			}
+			else if( REFERENCE_INFO.Type == GCRT_AddReferencedObjects )
+			{
+				// Static AddReferencedObjects function call.
+				void (*AddReferencedObjects)(UObject*, FReferenceCollector&) = (void(*)(UObject*, FReferenceCollector&))TokenStream->ReadPointer( TokenStreamIndex );
+				TokenReturnCount = REFERENCE_INFO.ReturnCount;
+				AddReferencedObjects(CurrentObject, ReferenceCollector);
+			}
+			else if( REFERENCE_INFO.Type == GCRT_EndOfStream )
+			{
+				// Break out of loop.
+				break;
+			}
+			else
+			{
+				UE_LOG(LogGarbage, Fatal,TEXT("Unknown token"));
 			}
 		}
+		check(StackEntry == Stack.GetData());
 	}
 
-	void DispatchObjectTasks(TArray<UObject*>& ObjectsToSerialize)
+	/**
+	 * Marks every object of a cluster the first time any of them is reached, and follows the references leaving the
+	 * cluster instead of the token streams of its objects.
+	 */
+	void ProcessCluster(FUObjectCluster& Cluster, TArray<UObject*>& NewObjectsToSerialize)
 	{
+		if( Cluster.Marked.Set( 1 ) != 0 )
+		{
+			return;
+		}
+
+		for( int32 ObjectIndex = 0; ObjectIndex < Cluster.Objects.Num(); ObjectIndex++ )
+		{
+			UObject* Object = Cluster.Objects[ObjectIndex];
+			if( GIncrementalReachability )
+			{
+				GIncrementalReachability->TryMark( Object );
+			}
+			else if( GIsRunningParallelReachability )
+			{
+				Object->ThisThreadAtomicallyClearedRFUnreachable();
+			}
+			else
+			{
+				Object->ClearFlags( RF_Unreachable );
+			}
+		}
+
+		// Clusters referencing objects marked pending kill are dissolved before marking, no reference needs clearing
+		for( TSet<UObject*>::TConstIterator It(Cluster.ReferencedObjects); It; ++It )
+		{
+			UObject* Reference = *It;
+			HandleObjectReference( NewObjectsToSerialize, Cluster.Root, Reference, false );
+		}
 	}
 
-	void ProcessObjectArray(TArray<UObject*>& InObjectsToSerializeArray, FGraphEventRef& MyCompletionGraphEvent)
+	void ProcessObjectArray(TArray<UObject*>& InObjectsToSerializeArray, int32 Depth)
 	{		
 		UObject* CurrentObject = NULL;
 
-		const int32 MinDesiredObjectsPerSubTask = 128; // sometimes there will be less, a lot less
 		const int32 NewObjectsArrayLength = InObjectsToSerializeArray.Num() * 2;
 		int32 TotalObjectsSerialized = InObjectsToSerializeArray.Num();
 
@@ -551,169 +1357,18 @@ public:
 			FGCCollector ReferenceCollector( NewObjectsToSerialize );
 			while( CurrentIndex < ObjectsToSerialize.Num() )
 			{
-#if PERF_DETAILED_PER_CLASS_GC_STATS
-				uint32 StartCycles = FPlatformTime::Cycles();
-#endif
-				CurrentObject = ObjectsToSerialize[CurrentIndex++];
-
-				if (CurrentIndex != ObjectsToSerialize.Num())
-				{
-					UObject* NextObject = ObjectsToSerialize.GetData()[CurrentIndex]; // special syntax avoiding out of bounds checking
-					FPlatformMisc::PrefetchBlock(NextObject, NextObject->GetClass()->GetPropertiesSize());
-				}
-
-				//@todo rtgc: we need to handle object references in struct defaults
-
-				// Make sure that token stream has been assembled at this point as the below code relies on it.
-				checkSlow( CurrentObject->GetClass()->HasAnyClassFlags(CLASS_TokenStreamAssembled) );
-
-				// Get pointer to token stream and jump to the start.
-				FGCReferenceTokenStream* RESTRICT TokenStream = &CurrentObject->GetClass()->ReferenceTokenStream;
-				uint32 TokenStreamIndex			= 0;
-				// Keep track of index to reference info. Used to avoid LHSs.
-				uint32 ReferenceTokenStreamIndex	= 0;
-
-				// Create stack entry and initialize sane values.
-				FStackEntry* RESTRICT StackEntry = Stack.GetData();
-				uint8* StackEntryData		= (uint8*) CurrentObject;
-				StackEntry->Data			= StackEntryData;
-				StackEntry->Stride			= 0;
-				StackEntry->Count			= -1;
-				StackEntry->LoopStartIndex	= -1;
-			
-				// Keep track of token return count in separate integer as arrays need to fiddle with it.
-				int32 TokenReturnCount		= 0;
-
-				// Parse the token stream.
-				while( true )
-				{
-					// Cache current token index as it is the one pointing to the reference info.
-					ReferenceTokenStreamIndex = TokenStreamIndex;
-
-					// Handle returning from an array of structs, array of structs of arrays of ... (yadda yadda)
-					for( int32 ReturnCount=0; ReturnCount<TokenReturnCount; ReturnCount++ )
-					{
-						// Make sure there's no stack underflow.
-						check( StackEntry->Count != -1 );
-
-						// We pre-decrement as we're already through the loop once at this point.
-						if( --StackEntry->Count > 0 )
-						{
-							// Point data to next entry.
-							StackEntryData	 = StackEntry->Data + StackEntry->Stride;
-							StackEntry->Data = StackEntryData;
-
-							// Jump back to the beginning of the loop.
-							TokenStreamIndex = StackEntry->LoopStartIndex;
-							ReferenceTokenStreamIndex = StackEntry->LoopStartIndex;
-							// We're not done with this token loop so we need to early out instead of backing out further.
-							break;
-						}
-						else
-						{
-							StackEntry--;
-							StackEntryData = StackEntry->Data;
-						}
-					}
-
-					// Instead of reading information about reference from stream and caching it like below we access
-					// the same memory address over and over and over again to avoid a nasty LHS penalty. Not reading 
-					// the reference info means we need to manually increment the token index to skip to the next one.
-					TokenStreamIndex++;
-					// Helper to make code more readable and hide the ugliness that is avoiding LHSs from caching.
-					#define	REFERENCE_INFO TokenStream->AccessReferenceInfo( ReferenceTokenStreamIndex )
-
-					if( REFERENCE_INFO.Type == GCRT_Object )
-					{	
-						// We're dealing with an object reference.
-						UObject**	ObjectPtr	= (UObject**)(StackEntryData + REFERENCE_INFO.Offset);
-						UObject*&	Object		= *ObjectPtr;
-						TokenReturnCount		= REFERENCE_INFO.ReturnCount;
-						HandleTokenStreamObjectReference(NewObjectsToSerialize, CurrentObject, Object, ReferenceTokenStreamIndex, true);
-					}
-					else if( REFERENCE_INFO.Type == GCRT_ArrayObject )
-					{
-						// We're dealing with an array of object references.
-						TArray<UObject*>& ObjectArray = *((TArray<UObject*>*)(StackEntryData + REFERENCE_INFO.Offset));
-						TokenReturnCount = REFERENCE_INFO.ReturnCount;
-						for( int32 ObjectIndex=0; ObjectIndex<ObjectArray.Num(); ObjectIndex++ )
-						{
-							UObject*& Object = ObjectArray[ObjectIndex];
-							HandleTokenStreamObjectReference(NewObjectsToSerialize, CurrentObject, Object, ReferenceTokenStreamIndex, true);
-						}
-					}
-					else if( REFERENCE_INFO.Type == GCRT_ArrayStruct )
-					{
-						// We're dealing with a dynamic array of structs.
-						const FScriptArray& Array = *((FScriptArray*)(StackEntryData + REFERENCE_INFO.Offset));
-						StackEntry++;
-						StackEntryData				= (uint8*) Array.GetData();
-						StackEntry->Data			= StackEntryData;
-						StackEntry->Stride			= TokenStream->ReadStride( TokenStreamIndex );
-						StackEntry->Count			= Array.Num();
-					
-						const FGCSkipInfo SkipInfo	= TokenStream->ReadSkipInfo( TokenStreamIndex );
-						StackEntry->LoopStartIndex	= TokenStreamIndex;
-					
-						if( StackEntry->Count == 0 )
-						{
-							// Skip empty array by jumping to skip index and set return count to the one about to be read in.
-							TokenStreamIndex		= SkipInfo.SkipIndex;
-							TokenReturnCount		= TokenStream->GetSkipReturnCount( SkipInfo );
-						}
-						else
-						{	
-							// Loop again.
-							check( StackEntry->Data );
-							TokenReturnCount		= 0;
-						}
-					}
-					else if( REFERENCE_INFO.Type == GCRT_PersistentObject )
-					{
-						// We're dealing with an object reference.
-						UObject**	ObjectPtr	= (UObject**)(StackEntryData + REFERENCE_INFO.Offset);
-						UObject*&	Object		= *ObjectPtr;
-						TokenReturnCount		= REFERENCE_INFO.ReturnCount;
-						HandleTokenStreamObjectReference(NewObjectsToSerialize, CurrentObject, Object, ReferenceTokenStreamIndex, false);
-					}
-					else if( REFERENCE_INFO.Type == GCRT_FixedArray )
-					{
-						// We're dealing with a fixed size array
-						uint8* PreviousData	= StackEntryData;
-						StackEntry++;
-						StackEntryData				= PreviousData;
-						StackEntry->Data			= PreviousData;
-						StackEntry->Stride			= TokenStream->ReadStride( TokenStreamIndex );
-						StackEntry->Count			= TokenStream->ReadCount( TokenStreamIndex );
-						StackEntry->LoopStartIndex	= TokenStreamIndex;
-						TokenReturnCount			= 0;
-					}
-					else if( REFERENCE_INFO.Type == GCRT_AddStructReferencedObjects )
-					{
-						// We're dealing with a function call
-						void const*	StructPtr	= (void*)(StackEntryData + REFERENCE_INFO.Offset);
-						TokenReturnCount		= REFERENCE_INFO.ReturnCount;
-						UScriptStruct::ICppStructOps::TPointerToAddStructReferencedObjects Func = (UScriptStruct::ICppStructOps::TPointerToAddStructReferencedObjects) TokenStream->ReadPointer( TokenStreamIndex );
-						Func(StructPtr, ReferenceCollector);
-					}
-					else if( REFERENCE_INFO.Type == GCRT_AddReferencedObjects )
-					{
-						// Static AddReferencedObjects function call.
-						void (*AddReferencedObjects)(UObject*, FReferenceCollector&) = (void(*)(UObject*, FReferenceCollector&))TokenStream->ReadPointer( TokenStreamIndex );
-						TokenReturnCount = REFERENCE_INFO.ReturnCount;
-						AddReferencedObjects(CurrentObject, ReferenceCollector);
-					}
-					else if( REFERENCE_INFO.Type == GCRT_EndOfStream )
-					{
-						// Break out of loop.
-						break;
-					}
-					else
-					{
-						UE_LOG(LogGarbage, Fatal,TEXT("Unknown token"));
-					}
+#if PERF_DETAILED_PER_CLASS_GC_STATS
+				uint32 StartCycles = FPlatformTime::Cycles();
+#endif
+				CurrentObject = ObjectsToSerialize[CurrentIndex++];
+
+				if (CurrentIndex != ObjectsToSerialize.Num())
+				{
+					UObject* NextObject = ObjectsToSerialize.GetData()[CurrentIndex]; // special syntax avoiding out of bounds checking
+					FPlatformMisc::PrefetchBlock(NextObject, NextObject->GetClass()->GetPropertiesSize());
 				}
-				check(StackEntry == Stack.GetData());
+
+				ProcessObject( CurrentObject, NewObjectsToSerialize, ReferenceCollector, Stack );
 
 #if PERF_DETAILED_PER_CLASS_GC_STATS
 				// Detailed per class stats should not be performed when parallel GC is running
@@ -742,16 +1397,10 @@ public:
 #else
 			}
 #endif
-			if( GIsRunningParallelReachability && NewObjectsToSerialize.Num() >= MinDesiredObjectsPerSubTask )
+			if( GIsRunningParallelReachability && Depth < MaxParallelNestingDepth && NewObjectsToSerialize.Num() >= MinDesiredObjectsPerSubTask )
 			{			
-				int32 ObjectsPerSubTask = FMath::Max<int32>(MinDesiredObjectsPerSubTask,NewObjectsToSerialize.Num() / FTaskGraphInterface::Get().GetNumWorkerThreads());
-				int32 StartIndex = 0;
-				while (StartIndex < NewObjectsToSerialize.Num())
-				{
-					int32 NumThisTask = FMath::Min<int32>(ObjectsPerSubTask, NewObjectsToSerialize.Num() - StartIndex);
-					MyCompletionGraphEvent->DontCompleteUntil(TGraphTask<FGCTask>::CreateTask().ConstructAndDispatchWhenReady(this, &NewObjectsToSerialize, StartIndex, NumThisTask));
-					StartIndex += NumThisTask;
-				}
+				// Share the new objects with idle threads, this thread keeps working on them until they are all done
+				ProcessObjectArrayInParallel(NewObjectsToSerialize, Depth);
 			}
 			else if( NewObjectsToSerialize.Num() )
 			{
@@ -767,8 +1416,218 @@ public:
 		}
 		while( CurrentIndex < ObjectsToSerialize.Num() );
 	}
+
+	/**
+	 * Scans objects on this thread until none are left or the time limit passed, for the incremental reachability
+	 * analysis. Objects are taken from the end and newly reached ones added to the same array, so it stays small.
+	 *
+	 * @param ObjectsToSerialize	Marked objects whose references need to be scanned
+	 * @param TimeLimit				Soft time limit in seconds, or 0 to scan until none are left
+	 * @return true if none are left
+	 */
+	bool ProcessObjectArrayIncrementally(TArray<UObject*>& ObjectsToSerialize, double TimeLimit)
+	{
+		// Polling the time for every object would be noticeable, objects take well under a microsecond each
+		const int32 TimeLimitEnforcementGranularity = 64;
+		const double StartTime = FPlatformTime::Seconds();
+
+		TArray<FStackEntry> Stack;
+		Stack.AddUninitialized( 128 );
+
+		FGCCollector ReferenceCollector( ObjectsToSerialize );
+		int32 ProcessCount = 0;
+		while( ObjectsToSerialize.Num() )
+		{
+			UObject* CurrentObject = ObjectsToSerialize.Pop( false );
+			ProcessObject( CurrentObject, ObjectsToSerialize, ReferenceCollector, Stack );
+
+			if( TimeLimit > 0.0 && ++ProcessCount == TimeLimitEnforcementGranularity )
+			{
+				if( FPlatformTime::Seconds() - StartTime > TimeLimit )
+				{
+					break;
+				}
+				ProcessCount = 0;
+			}
+		}
+		return ObjectsToSerialize.Num() == 0;
+	}
 };
 
+FIncrementalReachabilityAnalysis::FIncrementalReachabilityAnalysis( EObjectFlags KeepFlags )
+	: NumObjectsAtStart(GUObjectArray.GetObjectArrayNum())
+{
+	check(IsInGameThread());
+	MarkBits.AddZeroed((NumObjectsAtStart + 31) / 32);
+	ObjectsToSerialize.Reserve(GUObjectArray.GetObjectArrayNumMinusPermanent() / 8);
+
+	GUObjectClusters.BeginReachabilityAnalysis();
+	AddRoots(KeepFlags, true);
+
+	GUObjectArray.AddUObjectCreateListener(this);
+	GIsIncrementalReachabilityPending = true;
+}
+
+FIncrementalReachabilityAnalysis::~FIncrementalReachabilityAnalysis()
+{
+	check(IsInGameThread());
+	GIsIncrementalReachabilityPending = false;
+	GUObjectArray.RemoveUObjectCreateListener(this);
+}
+
+void FIncrementalReachabilityAnalysis::AddRoots( EObjectFlags KeepFlags, bool bCountObjects )
+{
+	if( bCountObjects )
+	{
+		GObjectCountDuringLastMarkPhase = 0;
+	}
+
+	for( FRawObjectIterator It(true); It; ++It )
+	{
+		UObject* Object = *It;
+
+		// By now all unreachable objects should've been purged
+		checkf( !Object->HasAnyFlags(RF_Unreachable), TEXT("%s"), *Object->GetFullName() );
+
+		if( bCountObjects )
+		{
+			GObjectCountDuringLastMarkPhase++;
+		}
+
+		// See FArchiveRealtimeGC::PerformReachabilityAnalysis
+		if( Object->HasAnyFlags( RF_PendingKill ) )
+		{
+			GUObjectClusters.DissolveClusterContaining( Object );
+		}
+
+		// Roots are scanned again when marking finishes, as references from them can change without a write barrier
+		if( Object->HasAnyFlags( RF_RootSet ) || (Object->HasAnyFlags( KeepFlags ) && !Object->HasAnyFlags( RF_PendingKill )) )
+		{
+			TryMark( Object );
+			ObjectsToSerialize.Add( Object );
+		}
+
+		// Assemble token stream for UClass objects. This is only done once for each class.
+		if (UClass* Class = dynamic_cast<UClass*>(Object))
+		{
+			if (!Class->HasAnyClassFlags(CLASS_TokenStreamAssembled))
+			{
+				Class->AssembleReferenceTokenStream();
+				check(Class->HasAnyClassFlags(CLASS_TokenStreamAssembled));
+			}
+		}
+	}
+}
+
+void FIncrementalReachabilityAnalysis::MarkFromWriteBarrier( const UObjectBase* Object )
+{
+	if( TryMark( Object ) )
+	{
+		FScopeLock Lock(&CriticalSection);
+		WriteBarrierObjects.Add( (UObject*)Object );
+	}
+}
+
+void FIncrementalReachabilityAnalysis::NotifyUObjectCreated( const UObjectBase* Object, int32 Index )
+{
+	// A new object may reuse the index of one purged by the previous collection, ours are marked from the start
+	TryMark( Object );
+
+	FScopeLock Lock(&CriticalSection);
+	NewObjects.Add( (UObject*)Object );
+}
+
+void FIncrementalReachabilityAnalysis::GatherWriteBarrierObjects()
+{
+	FScopeLock Lock(&CriticalSection);
+	ObjectsToSerialize.Append( WriteBarrierObjects );
+	WriteBarrierObjects.Reset();
+}
+
+bool FIncrementalReachabilityAnalysis::Tick( double TimeLimit )
+{
+	check(IsInGameThread());
+	GatherWriteBarrierObjects();
+
+	FArchiveRealtimeGC TagUsedRealtimeGC;
+	return TagUsedRealtimeGC.ProcessObjectArrayIncrementally( ObjectsToSerialize, TimeLimit );
+}
+
+void FIncrementalReachabilityAnalysis::Finish( EObjectFlags KeepFlags, bool bVerify )
+{
+	check(IsInGameThread());
+
+	// New objects were constructed after they were marked, so their references were never seen. Classes loaded
+	// meanwhile need their token streams before any of their objects is scanned.
+	TArray<UObject*> ObjectsCreatedWhileMarking;
+	{
+		FScopeLock Lock(&CriticalSection);
+		Exchange( ObjectsCreatedWhileMarking, NewObjects );
+	}
+	AddRoots( KeepFlags, false );
+	for( int32 Index = 0; Index < ObjectsCreatedWhileMarking.Num(); Index++ )
+	{
+		UObject* Object = ObjectsCreatedWhileMarking[Index];
+		if (UClass* Class = dynamic_cast<UClass*>(Object))
+		{
+			if (!Class->HasAnyClassFlags(CLASS_TokenStreamAssembled))
+			{
+				Class->AssembleReferenceTokenStream();
+			}
+		}
+		ObjectsToSerialize.Add( Object );
+	}
+	GatherWriteBarrierObjects();
+
+	FArchiveRealtimeGC TagUsedRealtimeGC;
+	verify( TagUsedRealtimeGC.ProcessObjectArrayIncrementally( ObjectsToSerialize, 0.0 ) );
+
+	// Object references must be handled the normal way from here on
+	GIncrementalReachability = NULL;
+
+	if( !bVerify )
+	{
+		for( FRawObjectIterator It(true); It; ++It )
+		{
+			UObject* Object = *It;
+			if( !IsMarked( GUObjectArray.ObjectToIndex( Object ) ) )
+			{
+				Object->SetFlags( RF_Unreachable );
+			}
+		}
+		return;
+	}
+
+	// The stop-the-world result is the one used, objects we missed would otherwise be destroyed while still referenced
+	TagUsedRealtimeGC.PerformReachabilityAnalysis( KeepFlags, true );
+
+	const int32 MaxMissedObjectsToLog = 32;
+	int32 NumMissed = 0;
+	int32 NumFloating = 0;
+	for( FRawObjectIterator It(true); It; ++It )
+	{
+		UObject* Object = *It;
+		const bool bMarked = IsMarked( GUObjectArray.ObjectToIndex( Object ) );
+		if( !bMarked && !Object->HasAnyFlags( RF_Unreachable ) )
+		{
+			if( NumMissed++ < MaxMissedObjectsToLog )
+			{
+				UE_LOG(LogGarbage, Error, TEXT("Incremental reachability analysis missed reachable object %s, it was probably stored without a write barrier"), *Object->GetFullName());
+			}
+		}
+		else if( bMarked && Object->HasAnyFlags( RF_Unreachable ) )
+		{
+			// Unreachable objects the incremental analysis kept are collected next time, that's expected
+			NumFloating++;
+		}
+	}
+	if( NumMissed )
+	{
+		UE_LOG(LogGarbage, Error, TEXT("Incremental reachability analysis missed %d reachable objects"), NumMissed);
+	}
+	UE_LOG(LogGarbage, Log, TEXT("Verified incremental reachability analysis: %d missed, %d unreachable objects kept until the next collection"), NumMissed, NumFloating);
+}
+
 /**
  * Incrementally purge garbage by deleting all unreferenced objects after routing Destroy.
  *
@@ -1040,36 +1899,9 @@ COREUOBJECT_API EditorPostReachabilityAnalysisCallbackType EditorPostReachabilit
 static const auto CVarAllowParallelGC = 
 	IConsoleManager::Get().RegisterConsoleVariable( TEXT("AllowParallelGC"), 1, TEXT("Used to control parallel GC.") )->AsVariableInt();
 
-/** 
- * Deletes all unreferenced objects, keeping objects that have any of the passed in KeepFlags set
- *
- * @param	KeepFlags			objects with those flags will be kept regardless of being referenced or not
- * @param	bPerformFullPurge	if true, perform a full purge after the mark pass
- */
-
-void CollectGarbage( EObjectFlags KeepFlags, bool bPerformFullPurge )
+/** Verifies that objects disregarded for GC only reference objects that are, or are in the root set. */
+static void VerifyGCAssumptions()
 {
-	// We can't collect garbage while there's a load in progress. E.g. one potential issue is Import.XObject
-	check( !IsLoading() );
-
-	// Route callbacks so we can ensure that we are e.g. not in the middle of loading something by flushing
-	// the async loading, etc...
-	FCoreUObjectDelegates::PreGarbageCollect.Broadcast();
-	
-	// Set 'I'm garbage collecting' flag - might be checked inside various functions.
-	GIsGarbageCollecting = true; 
-
-	UE_LOG(LogGarbage, Log, TEXT("Collecting garbage") );
-
-	// Make sure previous incremental purge has finished or we do a full purge pass in case we haven't kicked one
-	// off yet since the last call to garbage collection.
-	if( GObjIncrementalPurgeIsInProgress || GObjPurgeIsRequired )
-	{
-		IncrementalPurgeGarbage( false );
-	}
-	check( !GObjIncrementalPurgeIsInProgress );
-	check( !GObjPurgeIsRequired );
-
 #if VERIFY_DISREGARD_GC_ASSUMPTIONS
 	// Only verify assumptions if option is enabled. This avoids false positives in the Editor or commandlets.
 	if( GUObjectArray.DisregardForGCEnabled() && GShouldVerifyGCAssumptions )
@@ -1113,25 +1945,15 @@ void CollectGarbage( EObjectFlags KeepFlags, bool bPerformFullPurge )
 		}
 	}
 #endif
+}
 
-	// Fall back to single threaded GC if processor count is 1 or parallel GC is disabled
-	// or detailed per class gc stats are enabled (not thread safe)
-	// Temporarily forcing single-threaded GC in the editor until Modify() can be safely removed from HandleObjectReference.
-	const bool bForceSingleThreadedGC = !FApp::ShouldUseThreadingForPerformance() || !FPlatformProcess::SupportsMultithreading() ||
-#if PLATFORM_SUPPORTS_MULTITHREADED_GC
-		( FPlatformMisc::NumberOfCores() < 2 || CVarAllowParallelGC->GetValueOnGameThread() == 0 || PERF_DETAILED_PER_CLASS_GC_STATS );
-#else	//PLATFORM_SUPPORTS_MULTITHREADED_GC
-		true;
-#endif	//PLATFORM_SUPPORTS_MULTITHREADED_GC
-
-	// Perform reachability analysis.
-	{
-		const double StartTime = FPlatformTime::Seconds();
-		FArchiveRealtimeGC TagUsedRealtimeGC;
-		TagUsedRealtimeGC.PerformReachabilityAnalysis( KeepFlags, bForceSingleThreadedGC );
-		UE_LOG(LogGarbage, Log, TEXT("%f ms for GC"), (FPlatformTime::Seconds() - StartTime) * 1000 );
-	}
-
+/**
+ * Begins destroying unreachable objects once reachability analysis set RF_Unreachable on them, and starts the purge.
+ *
+ * @param	bPerformFullPurge	if true, purge all unreachable objects now instead of incrementally
+ */
+static void UnhashUnreachableObjects( bool bPerformFullPurge )
+{
 #if WITH_EDITOR
 	if ( GIsEditor && EditorPostReachabilityAnalysisCallback )
 	{
@@ -1172,6 +1994,128 @@ void CollectGarbage( EObjectFlags KeepFlags, bool bPerformFullPurge )
 	FCoreUObjectDelegates::PostGarbageCollect.Broadcast();
 }
 
+/** 
+ * Deletes all unreferenced objects, keeping objects that have any of the passed in KeepFlags set
+ *
+ * @param	KeepFlags			objects with those flags will be kept regardless of being referenced or not
+ * @param	bPerformFullPurge	if true, perform a full purge after the mark pass
+ */
+
+void CollectGarbage( EObjectFlags KeepFlags, bool bPerformFullPurge )
+{
+	// We can't collect garbage while there's a load in progress. E.g. one potential issue is Import.XObject
+	check( !IsLoading() );
+
+	// Route callbacks so we can ensure that we are e.g. not in the middle of loading something by flushing
+	// the async loading, etc...
+	FCoreUObjectDelegates::PreGarbageCollect.Broadcast();
+	
+	// Set 'I'm garbage collecting' flag - might be checked inside various functions.
+	GIsGarbageCollecting = true; 
+
+	UE_LOG(LogGarbage, Log, TEXT("Collecting garbage") );
+
+	// Make sure previous incremental purge has finished or we do a full purge pass in case we haven't kicked one
+	// off yet since the last call to garbage collection.
+	if( GObjIncrementalPurgeIsInProgress || GObjPurgeIsRequired )
+	{
+		IncrementalPurgeGarbage( false );
+	}
+	check( !GObjIncrementalPurgeIsInProgress );
+	check( !GObjPurgeIsRequired );
+
+	// A full collection supersedes an incremental one in progress
+	if( GIncrementalReachability )
+	{
+		UE_LOG(LogGarbage, Log, TEXT("Abandoning incremental reachability analysis for a full collection") );
+		FIncrementalReachabilityAnalysis* IncrementalReachability = GIncrementalReachability;
+		GIncrementalReachability = NULL;
+		delete IncrementalReachability;
+	}
+
+	VerifyGCAssumptions();
+
+	// Fall back to single threaded GC if processor count is 1 or parallel GC is disabled
+	// or detailed per class gc stats are enabled (not thread safe)
+	// Temporarily forcing single-threaded GC in the editor until Modify() can be safely removed from HandleObjectReference.
+	const bool bForceSingleThreadedGC = !FApp::ShouldUseThreadingForPerformance() || !FPlatformProcess::SupportsMultithreading() ||
+#if PLATFORM_SUPPORTS_MULTITHREADED_GC
+		( FPlatformMisc::NumberOfCores() < 2 || CVarAllowParallelGC->GetValueOnGameThread() == 0 || PERF_DETAILED_PER_CLASS_GC_STATS );
+#else	//PLATFORM_SUPPORTS_MULTITHREADED_GC
+		true;
+#endif	//PLATFORM_SUPPORTS_MULTITHREADED_GC
+
+	// Perform reachability analysis.
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		FArchiveRealtimeGC TagUsedRealtimeGC;
+		TagUsedRealtimeGC.PerformReachabilityAnalysis( KeepFlags, bForceSingleThreadedGC );
+		UE_LOG(LogGarbage, Log, TEXT("%f ms for GC"), (FPlatformTime::Seconds() - StartTime) * 1000 );
+	}
+
+	UnhashUnreachableObjects( bPerformFullPurge );
+}
+
+bool IncrementalCollectGarbage( EObjectFlags KeepFlags )
+{
+	if( !GIncrementalReachability && !CVarIncrementalReachability.GetValueOnGameThread() )
+	{
+		CollectGarbage( KeepFlags, false );
+		return true;
+	}
+
+	// We can't collect garbage while there's a load in progress, this includes marking as linkers aren't followed
+	check( !IsLoading() );
+
+	if( !GIncrementalReachability )
+	{
+		// The previous purge has to finish first, it relies on RF_Unreachable and frees object indices
+		if( GObjIncrementalPurgeIsInProgress || GObjPurgeIsRequired )
+		{
+			IncrementalPurgeGarbage( false );
+		}
+		check( !GObjIncrementalPurgeIsInProgress );
+		check( !GObjPurgeIsRequired );
+
+		UE_LOG(LogGarbage, Log, TEXT("Starting incremental reachability analysis") );
+		GIncrementalReachability = new FIncrementalReachabilityAnalysis( KeepFlags );
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	bool bMarkedAll;
+	{
+		TGuardValue<bool> GuardIsGarbageCollecting(GIsGarbageCollecting, true);
+		bMarkedAll = GIncrementalReachability->Tick( CVarIncrementalReachabilityTimeLimit.GetValueOnGameThread() / 1000.0 );
+	}
+	if( !bMarkedAll )
+	{
+		return false;
+	}
+
+	// Everything reached so far is marked, finish the collection like CollectGarbage does from here
+	FCoreUObjectDelegates::PreGarbageCollect.Broadcast();
+	check( !IsLoading() );
+
+	GIsGarbageCollecting = true;
+
+	UE_LOG(LogGarbage, Log, TEXT("Collecting garbage incrementally") );
+
+	VerifyGCAssumptions();
+
+	FIncrementalReachabilityAnalysis* IncrementalReachability = GIncrementalReachability;
+	IncrementalReachability->Finish( KeepFlags, CVarVerifyIncrementalReachability.GetValueOnGameThread() != 0 );
+	delete IncrementalReachability;
+	UE_LOG(LogGarbage, Log, TEXT("%f ms to finish incremental GC"), (FPlatformTime::Seconds() - StartTime) * 1000 );
+
+	UnhashUnreachableObjects( false );
+	return true;
+}
+
+bool IsIncrementalReachabilityAnalysisPending()
+{
+	return GIncrementalReachability != NULL;
+}
+
 /**
  * Helper function to add referenced objects via serialization
  *
@@ -0,0 +1,14 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Creates a garbage collection cluster, see CreateClustersFromLoadedObjects.
+ *
+ * @param	Root	object the cluster is created for, grouped with the objects in its package it references that can be in a cluster
+ * @return	index of the new cluster, or INDEX_NONE if the object can't be a root or the cluster would only hold the root
+ */
+int32 CreateGCCluster(UObject* Root);
+
+/** @return index of the garbage collection cluster the object is in, or INDEX_NONE. */
+int32 GetGCClusterIndex(const UObjectBase* Object);
@@ -1023,23 +1023,33 @@ ULinkerLoad::ELinkerStatus ULinkerLoad::SerializeNameMap()
 		}
 	}
 
-	while( bFinishedPrecaching && NameMapIndex < Summary.NameCount && !IsTimeLimitExceeded(TEXT("serializing name map"),100) )
+	if( bFinishedPrecaching && NameMapIndex < Summary.NameCount )
 	{
-		// Read the name entry from the file.
-		FNameEntry NameEntry(ENAME_LinkerConstructor);
-		*this << NameEntry;
+		// Names are read and added to the name table a batch at a time, which lets FName take its locks once per batch
+		const int32 MaxBatchSize = 32;
+		TArray<FNameEntry> NameEntries;
+		NameEntries.AddUninitialized( FMath::Min( MaxBatchSize, Summary.NameCount - NameMapIndex ) );
+		const FNameEntry* NameEntryPtrs[MaxBatchSize];
 
-		// Add it to the name table. We disregard the context flags as we don't support flags on names for final release builds.
+		while( NameMapIndex < Summary.NameCount && !IsTimeLimitExceeded(TEXT("serializing name map"),3) )
+		{
+			const int32 BatchSize = FMath::Min( NameEntries.Num(), Summary.NameCount - NameMapIndex );
+			for( int32 BatchIndex = 0; BatchIndex < BatchSize; BatchIndex++ )
+			{
+				// Read the name entry from the file.
+				*this << NameEntries[BatchIndex];
+				NameEntryPtrs[BatchIndex] = &NameEntries[BatchIndex];
+			}
 
-		// now, we make sure we DO NOT split the name here because it will have been written out
-		// split, and we don't want to keep splitting A_3_4_9 every time
+			// Add them to the name table. We disregard the context flags as we don't support flags on names for final release builds.
 
-		NameMap.Add( 
-			NameEntry.IsWide() ? 
-				FName(ENAME_LinkerConstructor, NameEntry.GetWideName()) : 
-				FName(ENAME_LinkerConstructor, NameEntry.GetAnsiName())
-			);
-		NameMapIndex++;
+			// now, we make sure we DO NOT split the names here because they will have been written out
+			// split, and we don't want to keep splitting A_3_4_9 every time
+
+			const int32 FirstNameIndex = NameMap.AddUninitialized( BatchSize );
+			FName::CreateNameBatch( NameEntryPtrs, BatchSize, &NameMap[FirstNameIndex] );
+			NameMapIndex += BatchSize;
+		}
 	}
 
 	// Return whether we finished this step and it's safe to start with the next.
@@ -16,7 +16,7 @@ void UObjectPropertyBase::InstanceSubobjects(void* Data, void const* DefaultData
 		{
 			UObject *SubobjectTemplate = DefaultData ? GetObjectPropertyValue((uint8*)DefaultData + ArrayIndex * ElementSize): NULL;
 			UObject* NewValue = InstanceGraph->InstancePropertyValue(SubobjectTemplate, CurrentValue, Owner, HasAnyPropertyFlags(CPF_Transient), HasAnyPropertyFlags(CPF_InstancedReference));
-			SetObjectPropertyValue((uint8*)Data + ArrayIndex * ElementSize, NewValue);
+			SetObjectPropertyValue((uint8*)Data + ArrayIndex * ElementSize, NewValue, Owner);
 		}
 	}
 }
@@ -243,7 +243,7 @@ const TCHAR* UObjectPropertyBase::ImportText_Internal( const TCHAR* InBuffer, vo
 
 	bool bOk = ParseObjectPropertyValue(this, Parent, PropertyClass, PortFlags, Buffer, Result);
 
-	SetObjectPropertyValue(Data, Result);
+	SetObjectPropertyValue(Data, Result, Parent);
 	return Buffer;
 }
 
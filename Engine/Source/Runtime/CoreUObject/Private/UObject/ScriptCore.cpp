@@ -973,6 +973,7 @@ void UObject::execInstanceVariable(FFrame& Stack, RESULT_DECL)
 {
 	UProperty* VarProperty = Stack.ReadProperty();
 	Stack.MostRecentPropertyAddress = VarProperty->ContainerPtrToValuePtr<uint8>(this);
+	Stack.MostRecentPropertyContainer = this;
 
 	if (Result)
 	{
@@ -1266,6 +1267,8 @@ void UObject::execLetObj( FFrame& Stack, RESULT_DECL )
 {
 	// Get variable address.
 	Stack.MostRecentPropertyAddress = NULL;
+	// Any object whose instance variable the address expression goes through, conservatively taken as the owner
+	Stack.MostRecentPropertyContainer = NULL;
 	Stack.Step( Stack.Object, NULL ); // Evaluate variable.
 
 	if (Stack.MostRecentPropertyAddress == NULL)
@@ -1275,6 +1278,7 @@ void UObject::execLetObj( FFrame& Stack, RESULT_DECL )
 	}
 
 	void* ObjAddr = Stack.MostRecentPropertyAddress;
+	UObject* ObjContainer = Stack.MostRecentPropertyContainer;
 	UObjectPropertyBase* ObjectProperty = dynamic_cast<UObjectPropertyBase*>(Stack.MostRecentProperty);
 	if (ObjectProperty == NULL)
 	{
@@ -1292,7 +1296,7 @@ void UObject::execLetObj( FFrame& Stack, RESULT_DECL )
 	if (ObjAddr)
 	{
 		checkSlow(ObjectProperty);
-		ObjectProperty->SetObjectPropertyValue(ObjAddr, NewValue);
+		ObjectProperty->SetObjectPropertyValue(ObjAddr, NewValue, ObjContainer);
 	}
 }
 IMPLEMENT_VM_FUNCTION( EX_LetObj, execLetObj );
@@ -1301,6 +1305,8 @@ void UObject::execLetWeakObjPtr( FFrame& Stack, RESULT_DECL )
 {
 	// Get variable address.
 	Stack.MostRecentPropertyAddress = NULL;
+	// Any object whose instance variable the address expression goes through, conservatively taken as the owner
+	Stack.MostRecentPropertyContainer = NULL;
 	Stack.Step( Stack.Object, NULL ); // Evaluate variable.
 
 	if (Stack.MostRecentPropertyAddress == NULL)
@@ -1310,6 +1316,7 @@ void UObject::execLetWeakObjPtr( FFrame& Stack, RESULT_DECL )
 	}
 
 	void* ObjAddr = Stack.MostRecentPropertyAddress;
+	UObject* ObjContainer = Stack.MostRecentPropertyContainer;
 	UObjectPropertyBase* ObjectProperty = dynamic_cast<UObjectPropertyBase*>(Stack.MostRecentProperty);
 	if (ObjectProperty == NULL)
 	{
@@ -1327,7 +1334,7 @@ void UObject::execLetWeakObjPtr( FFrame& Stack, RESULT_DECL )
 	if (ObjAddr)
 	{
 		checkSlow(ObjectProperty);
-		ObjectProperty->SetObjectPropertyValue(ObjAddr, NewValue);
+		ObjectProperty->SetObjectPropertyValue(ObjAddr, NewValue, ObjContainer);
 	}
 }
 IMPLEMENT_VM_FUNCTION( EX_LetWeakObjPtr, execLetWeakObjPtr );
@@ -16,12 +16,8 @@ void FUObjectArray::AllocatePermanentObjectPool(int32 MaxObjectsNotConsideredByG
 	// GObjFirstGCIndex is the index at which the garbage collector will start for the mark phase.
 	ObjFirstGCIndex			= MaxObjectsNotConsideredByGC;
 
-	// Presize array.
+	// The array allocates its chunks as objects are added, nothing to presize.
 	check( ObjObjects.Num() == 0 );
-	if( ObjFirstGCIndex )
-	{
-		ObjObjects.Reserve( ObjFirstGCIndex );
-	}
 	FWeakObjectPtr::Init(); // this adds a delete listener
 }
 
@@ -38,34 +34,46 @@ void FUObjectArray::AllocateUObjectIndex(UObjectBase* Object)
 	int32 Index;
 	check(Object->InternalIndex == INDEX_NONE);
 
-	// Special non- garbage collectable range.
-	if (OpenForDisregardForGC && DisregardForGCEnabled())
-	{
-		Index = ObjObjects.AddUninitialized();
-		ObjLastNonGCIndex = Index;
-		ObjFirstGCIndex = FMath::Max(ObjFirstGCIndex, Index + 1);
-	}
-	// Regular pool/ range.
-	else
 	{
-		if(ObjAvailable.Num())
+		FScopeLock ObjObjectsLock(&ObjObjectsCritical);
+
+		// Special non- garbage collectable range.
+		if (OpenForDisregardForGC && DisregardForGCEnabled())
 		{
-			Index = ObjAvailable.Pop();
-			check(ObjObjects[Index]==NULL);
+			Index = ObjObjects.AddZeroed();
+			ObjLastNonGCIndex = Index;
+			ObjFirstGCIndex = FMath::Max(ObjFirstGCIndex, Index + 1);
 		}
+		// Regular pool/ range.
 		else
 		{
-			Index = ObjObjects.AddUninitialized();
+			if(ObjAvailable.Num())
+			{
+				Index = ObjAvailable.Pop();
+				check(ObjObjects[Index]==NULL);
+			}
+			else
+			{
+				Index = ObjObjects.AddZeroed();
+			}
+			check(Index >= ObjFirstGCIndex);
 		}
-		check(Index >= ObjFirstGCIndex);
+		// The slot stays NULL until the listeners know about the object, nobody else can claim it meanwhile
+		Object->InternalIndex = Index;
 	}
-	// Add to global table.
-	ObjObjects[Index] = Object;
-	Object->InternalIndex = Index;
-	for (int32 ListenerIndex = 0; ListenerIndex < UObjectCreateListeners.Num(); ListenerIndex++)
+
+	// Listeners may take their own locks, and objects are created on loader threads, so keep them outside of ours
 	{
-		UObjectCreateListeners[ListenerIndex]->NotifyUObjectCreated(Object,Index);
+		FScopeLock ListenersLock(&UObjectCreateListenersCritical);
+		for (int32 ListenerIndex = 0; ListenerIndex < UObjectCreateListeners.Num(); ListenerIndex++)
+		{
+			UObjectCreateListeners[ListenerIndex]->NotifyUObjectCreated(Object,Index);
+		}
 	}
+
+	// Add to global table. Other threads may read the slot without the lock, so the object must be fully set up first.
+	FPlatformMisc::MemoryBarrier();
+	ObjObjects[Index] = Object;
 }
 
 /**
@@ -76,6 +84,8 @@ void FUObjectArray::AllocateUObjectIndex(UObjectBase* Object)
 void FUObjectArray::FreeUObjectIndex(UObjectBase* Object)
 {
 	int32 Index = Object->InternalIndex;
+
+	FScopeLock ObjObjectsLock(&ObjObjectsCritical);
 	ObjObjects[Index] = NULL;
 	for (int32 ListenerIndex = 0; ListenerIndex < UObjectDeleteListeners.Num(); ListenerIndex++)
 	{
@@ -94,6 +104,7 @@ void FUObjectArray::FreeUObjectIndex(UObjectBase* Object)
  */
 void FUObjectArray::AddUObjectCreateListener(FUObjectCreateListener* Listener)
 {
+	FScopeLock ListenersLock(&UObjectCreateListenersCritical);
 	check(!UObjectCreateListeners.Contains(Listener));
 	UObjectCreateListeners.Add(Listener);
 }
@@ -105,6 +116,7 @@ void FUObjectArray::AddUObjectCreateListener(FUObjectCreateListener* Listener)
  */
 void FUObjectArray::RemoveUObjectCreateListener(FUObjectCreateListener* Listener)
 {
+	FScopeLock ListenersLock(&UObjectCreateListenersCritical);
 	int32 NumRemoved = UObjectCreateListeners.RemoveSingleSwap(Listener);
 	check(NumRemoved==1);
 }
@@ -174,7 +186,7 @@ void FUObjectArray::ShutdownUObjectArray()
 	ObjAvailable.Empty();
 }
 
-TArray<UObjectBase*>* FUObjectArray::GetObjectArrayForDebugVisualizers()
+UObjectBase*** FUObjectArray::GetObjectArrayForDebugVisualizers()
 {
-	return &GUObjectArray.ObjObjects;
+	return GUObjectArray.ObjObjects.GetRootBlockForDebugVisualizers();
 }
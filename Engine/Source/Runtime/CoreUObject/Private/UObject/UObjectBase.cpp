@@ -247,6 +247,7 @@ void UObjectBase::LowLevelRename(FName NewName,UObject *NewOuter)
 #endif
 	if (NewOuter)
 	{
+		ObjectWriteBarrier(NewOuter, this);
 		Outer = NewOuter;
 	}
 	HashObject(this);
@@ -260,6 +261,7 @@ void UObjectBase::SetClass(UClass* NewClass)
 #if USE_UBER_GRAPH_PERSISTENT_FRAME
 	Class->DestroyPersistentUberGraphFrame((UObject*)this);
 #endif
+	ObjectWriteBarrier(NewClass, this);
 	Class = NewClass;
 #if USE_UBER_GRAPH_PERSISTENT_FRAME
 	Class->CreatePersistentUberGraphFrame((UObject*)this);
@@ -1109,6 +1109,8 @@ void EndLoad()
 				}
 			}
 
+			CreateClustersFromLoadedObjects(ObjLoaded);
+
 #if WITH_EDITOR
 			// Send global notification for each object that was loaded.
 			// Useful for updating UI such as ContentBrowser's loaded status.
@@ -1846,10 +1848,22 @@ UObject::UObject(const FObjectInitializer& ObjectInitializer)
 	const_cast<FObjectInitializer&>(ObjectInitializer).FinalizeSubobjectClassInitialization();
 }
 
-/* Global flag so that FObjectFinders know if they are called from inside the UObject constructors or not. */
-static int32 GIsInConstructor = 0;
-/* Object that is currently being constructed with ObjectInitializer */
-static UObject* GConstructedObject = NULL;
+/** Per-thread construction state, objects can be constructed on async loading threads while the game thread constructs others. */
+class FObjectConstructionThreadContext : public TThreadSingleton<FObjectConstructionThreadContext>
+{
+	friend class TThreadSingleton<FObjectConstructionThreadContext>;
+
+	FObjectConstructionThreadContext()
+		: IsInConstructor(0)
+		, ConstructedObject(NULL)
+	{}
+
+public:
+	/* Flag so that FObjectFinders know if they are called from inside the UObject constructors or not. */
+	int32 IsInConstructor;
+	/* Object that is currently being constructed with ObjectInitializer */
+	UObject* ConstructedObject;
+};
 
 FObjectInitializer::FObjectInitializer() :
 	Obj(NULL),
@@ -1858,11 +1872,12 @@ FObjectInitializer::FObjectInitializer() :
 	bShouldIntializePropsFromArchetype(true),
 	bSubobjectClassInitializationAllowed(true),
 	InstanceGraph(NULL),
-	LastConstructedObject(GConstructedObject)
+	LastConstructedObject(FObjectConstructionThreadContext::Get().ConstructedObject)
 {
 	// Mark we're in the constructor now.	
-	GIsInConstructor++;
-	GConstructedObject = Obj;
+	FObjectConstructionThreadContext& ThreadContext = FObjectConstructionThreadContext::Get();
+	ThreadContext.IsInConstructor++;
+	ThreadContext.ConstructedObject = Obj;
 }	
 
 FObjectInitializer::FObjectInitializer(UObject* InObj, UObject* InObjectArchetype, bool bInCopyTransientsFromClassDefaults, bool bInShouldIntializeProps, struct FObjectInstancingGraph* InInstanceGraph) :
@@ -1873,11 +1888,12 @@ FObjectInitializer::FObjectInitializer(UObject* InObj, UObject* InObjectArchetyp
 	bShouldIntializePropsFromArchetype(bInShouldIntializeProps),
 	bSubobjectClassInitializationAllowed(true),
 	InstanceGraph(InInstanceGraph),
-	LastConstructedObject(GConstructedObject)
+	LastConstructedObject(FObjectConstructionThreadContext::Get().ConstructedObject)
 {
 	// Mark we're in the constructor now.
-	GIsInConstructor++;
-	GConstructedObject = Obj;
+	FObjectConstructionThreadContext& ThreadContext = FObjectConstructionThreadContext::Get();
+	ThreadContext.IsInConstructor++;
+	ThreadContext.ConstructedObject = Obj;
 }
 
 /**
@@ -1886,9 +1902,10 @@ FObjectInitializer::FObjectInitializer(UObject* InObj, UObject* InObjectArchetyp
 FObjectInitializer::~FObjectInitializer()
 {
 	// Let the FObjectFinders know we left the constructor.
-	GIsInConstructor--;
-	check(GIsInConstructor >= 0);
-	GConstructedObject = LastConstructedObject;
+	FObjectConstructionThreadContext& ThreadContext = FObjectConstructionThreadContext::Get();
+	ThreadContext.IsInConstructor--;
+	check(ThreadContext.IsInConstructor >= 0);
+	ThreadContext.ConstructedObject = LastConstructedObject;
 
 //	SCOPE_CYCLE_COUNTER(STAT_PostConstructInitializeProperties);
 	check(Obj);
@@ -2196,7 +2213,8 @@ UObject* StaticConstructObject
 
 void FObjectInitializer::AssertIfInConstructor(UObject* Outer, const TCHAR* ErrorMessage)
 {
-	UE_CLOG(GIsInConstructor && Outer == GConstructedObject, LogUObjectGlobals, Fatal, TEXT("%s"), ErrorMessage);
+	FObjectConstructionThreadContext& ThreadContext = FObjectConstructionThreadContext::Get();
+	UE_CLOG(ThreadContext.IsInConstructor && Outer == ThreadContext.ConstructedObject, LogUObjectGlobals, Fatal, TEXT("%s"), ErrorMessage);
 }
 
 /**
@@ -2251,7 +2269,7 @@ void ConstructorHelpers::CheckFoundViaRedirect(UObject *Object, const FString& P
 
 void ConstructorHelpers::CheckIfIsInConstructor(const TCHAR* ObjectToFind)
 {
-	UE_CLOG(!GIsInConstructor, LogUObjectGlobals, Fatal, TEXT("FObjectFinders can't be used outside of constructors to find %s"), ObjectToFind);
+	UE_CLOG(!FObjectConstructionThreadContext::Get().IsInConstructor, LogUObjectGlobals, Fatal, TEXT("FObjectFinders can't be used outside of constructors to find %s"), ObjectToFind);
 }
 
 void ConstructorHelpers::StripObjectClass( FString& PathName, bool bAssertOnBadPath /*= false */ )
@@ -11,6 +11,12 @@ DEFINE_LOG_CATEGORY_STATIC(LogUObjectHash, Log, All);
 /**
  * This implementation will use more space than the UE3 implementation. The goal was to make UObjects smaller to save L2 cache space. 
  * The hash is rarely used at runtime. A more space-efficient implementation is possible.
+ *
+ * All the tables are thread-safe, so objects can be constructed, renamed and found from async loading threads. The name
+ * hashes are split in shards by hash value, each with its own lock, so threads working with different names rarely contend.
+ * The outer and class maps have a lock each, they are written by HashObject and UnhashObject only.
+ * Objects returned by a lookup are not protected from being unhashed afterwards, that is still up to the garbage collector,
+ * which doesn't run while async loading.
  */
 
 
@@ -22,8 +28,28 @@ DEFINE_LOG_CATEGORY_STATIC(LogUObjectHash, Log, All);
 */
 #define OBJECT_HASH_BINS (1024*1024)
 
-static TMultiMap<int32,class UObjectBase*> ObjectHash;
-static TMultiMap<int32,class UObjectBase*> ObjectHashOuter;
+/**
+ * The number of independently locked shards each name hash is split in.
+ *
+ * NOTE: This must be power of 2 and not more than OBJECT_HASH_BINS
+ */
+#define OBJECT_HASH_SHARDS 64
+
+/** Part of a name hash, holding the buckets whose hash selects it. */
+struct FObjectHashShard
+{
+	FCriticalSection CriticalSection;
+	TMultiMap<int32,class UObjectBase*> Map;
+};
+
+static FObjectHashShard ObjectHash[OBJECT_HASH_SHARDS];
+static FObjectHashShard ObjectHashOuter[OBJECT_HASH_SHARDS];
+
+/** Returns the shard holding a hash bucket. */
+static FORCEINLINE FObjectHashShard& GetObjectHashShard(FObjectHashShard* Shards, int32 Hash)
+{
+	return Shards[Hash & (OBJECT_HASH_SHARDS - 1)];
+}
 
 /**
  * Calculates the object's hash just using the object's name index
@@ -64,7 +90,9 @@ UObject* StaticFindObjectFastExplicit( UClass* ObjectClass, FName ObjectName, co
 	checkSlow(FPackageName::IsShortPackageName(ObjectName)); //@Package name transition, we aren't checking the name here because we know this is only used for texture
 	// Find an object with the specified name and (optional) class, in any package; if bAnyPackage is false, only matches top-level packages
 	int32 Hash = GetObjectHash( ObjectName );
-	for(TMultiMap<int32,class UObjectBase*>::TConstKeyIterator HashIt(ObjectHash,Hash); HashIt; ++HashIt)
+	FObjectHashShard& Shard = GetObjectHashShard( ObjectHash, Hash );
+	FScopeLock ShardLock( &Shard.CriticalSection );
+	for(TMultiMap<int32,class UObjectBase*>::TConstKeyIterator HashIt(Shard.Map,Hash); HashIt; ++HashIt)
 	{
 		UObject *Object = (UObject *)HashIt.Value();
 		if
@@ -100,7 +128,9 @@ UObject* StaticFindObjectFastInternal( UClass* ObjectClass, UObject* ObjectPacka
 	if (ObjectPackage != NULL)
 	{
 		int32 Hash = GetObjectOuterHash( ObjectName, (PTRINT)ObjectPackage );
-		for(TMultiMap<int32,class UObjectBase*>::TConstKeyIterator HashIt(ObjectHashOuter,Hash); HashIt; ++HashIt)
+		FObjectHashShard& Shard = GetObjectHashShard( ObjectHashOuter, Hash );
+		FScopeLock ShardLock( &Shard.CriticalSection );
+		for(TMultiMap<int32,class UObjectBase*>::TConstKeyIterator HashIt(Shard.Map,Hash); HashIt; ++HashIt)
 		{
 			UObject *Object = (UObject *)HashIt.Value();
 			if
@@ -143,7 +173,9 @@ UObject* StaticFindObjectFastInternal( UClass* ObjectClass, UObject* ObjectPacka
 			ActualObjectName = FName(*ObjectNameString.Mid(DotIndex + 1));
 		}
 		const int32 Hash = GetObjectHash( ActualObjectName );
-		for(TMultiMap<int32,class UObjectBase*>::TConstKeyIterator HashIt(ObjectHash,Hash); HashIt; ++HashIt)
+		FObjectHashShard& Shard = GetObjectHashShard( ObjectHash, Hash );
+		FScopeLock ShardLock( &Shard.CriticalSection );
+		for(TMultiMap<int32,class UObjectBase*>::TConstKeyIterator HashIt(Shard.Map,Hash); HashIt; ++HashIt)
 		{
 			UObject *Object = (UObject *)HashIt.Value();
 			if
@@ -188,8 +220,14 @@ static TMap<UObjectBase*, TSet<UObjectBase*> > ObjectOuterMap;
 static TMap<UClass*, TSet<UObjectBase*> > ClassToObjectListMap;
 static TMap<UClass*, TSet<UClass*> > ClassToChildListMap;
 
+/** Guards ObjectOuterMap. */
+static FCriticalSection ObjectOuterMapCritical;
+/** Guards ClassToObjectListMap and ClassToChildListMap. */
+static FCriticalSection ClassMapCritical;
+
 static void AddToOuterMap(UObjectBase* Object)
 {
+	FScopeLock OuterMapLock(&ObjectOuterMapCritical);
 	TSet<UObjectBase*>& Inners = ObjectOuterMap.FindOrAdd(Object->GetOuter());
 	bool bIsAlreadyInSetPtr = false;
 	Inners.Add(Object, &bIsAlreadyInSetPtr);
@@ -198,6 +236,7 @@ static void AddToOuterMap(UObjectBase* Object)
 
 static void AddToClassMap(UObjectBase* Object)
 {
+	FScopeLock ClassMapLock(&ClassMapCritical);
 	{
 		check(Object->GetClass());
 		TSet<UObjectBase*>& ObjectList = ClassToObjectListMap.FindOrAdd(Object->GetClass());
@@ -223,6 +262,7 @@ static void AddToClassMap(UObjectBase* Object)
 
 static void RemoveFromOuterMap(UObjectBase* Object)
 {
+	FScopeLock OuterMapLock(&ObjectOuterMapCritical);
 	TSet<UObjectBase*>& Inners = ObjectOuterMap.FindOrAdd(Object->GetOuter());
 	int32 NumRemoved = Inners.Remove(Object);
     if (NumRemoved != 1)
@@ -239,6 +279,7 @@ static void RemoveFromOuterMap(UObjectBase* Object)
 static void RemoveFromClassMap(UObjectBase* Object)
 {
 	UObjectBaseUtility* ObjectWithUtility = static_cast<UObjectBaseUtility*>(Object);
+	FScopeLock ClassMapLock(&ClassMapCritical);
 
 	{
 		TSet<UObjectBase*>& ObjectList = ClassToObjectListMap.FindOrAdd(Object->GetClass());
@@ -285,6 +326,7 @@ void GetObjectsWithOuter(const class UObjectBase* Outer, TArray<UObject *>& Resu
 		ExclusionFlags = EObjectFlags(ExclusionFlags | RF_AsyncLoading);
 	}
 	int32 StartNum = Results.Num();
+	FScopeLock OuterMapLock(&ObjectOuterMapCritical);
 	TSet<UObjectBase*> const* Inners = ObjectOuterMap.Find(Outer);
 	if (Inners)
 	{
@@ -338,6 +380,7 @@ UObjectBase* FindObjectWithOuter(class UObjectBase* Outer, class UClass* ClassTo
 	}
 
 	UObject *Result = NULL;
+	FScopeLock OuterMapLock(&ObjectOuterMapCritical);
 	TSet<UObjectBase*> const* Inners = ObjectOuterMap.Find(Outer);
 	if (Inners)
 	{
@@ -360,7 +403,7 @@ UObjectBase* FindObjectWithOuter(class UObjectBase* Outer, class UClass* ClassTo
 	return Result;
 }
 
-/** Helper function that returns all the children of the specified class recursively */
+/** Helper function that returns all the children of the specified class recursively, ClassMapCritical must be locked */
 static void RecursivelyPopulateDerivedClasses(UClass* ParentClass, TSet<UClass*>& OutAllDerivedClass)
 {
 	TSet<UClass*>* ChildSet = ClassToChildListMap.Find(ParentClass);
@@ -388,6 +431,8 @@ void GetObjectsOfClass(UClass* ClassToLookFor, TArray<UObject *>& Results, bool
 	}
 	ExclusionFlags |= AdditionalExcludeFlags;
 
+	FScopeLock ClassMapLock(&ClassMapCritical);
+
 	TSet<UClass*> ClassesToSearch;
 	ClassesToSearch.Add(ClassToLookFor);
 	if ( bIncludeDerivedClasses )
@@ -418,6 +463,8 @@ void GetObjectsOfClass(UClass* ClassToLookFor, TArray<UObject *>& Results, bool
 
 void GetDerivedClasses(UClass* ClassToLookFor, TArray<UClass *>& Results, bool bRecursive)
 {
+	FScopeLock ClassMapLock(&ClassMapCritical);
+
 	if ( bRecursive )
 	{
 		TSet<UClass*> AllDerivedClasses;
@@ -448,12 +495,20 @@ void HashObject(UObjectBase* Object)
 	}
 
 	int32 Hash = GetObjectHash( Name );
-	checkSlow(!ObjectHash.FindPair(Hash,Object));  // if it already exists, something is wrong with the external code
-	ObjectHash.Add(Hash,Object);
+	{
+		FObjectHashShard& Shard = GetObjectHashShard( ObjectHash, Hash );
+		FScopeLock ShardLock( &Shard.CriticalSection );
+		checkSlow(!Shard.Map.FindPair(Hash,Object));  // if it already exists, something is wrong with the external code
+		Shard.Map.Add(Hash,Object);
+	}
 
 	Hash = GetObjectOuterHash(Name,(PTRINT)Object->GetOuter());
-	checkSlow(!ObjectHashOuter.FindPair(Hash,Object));  // if it already exists, something is wrong with the external code
-	ObjectHashOuter.Add(Hash,Object);
+	{
+		FObjectHashShard& Shard = GetObjectHashShard( ObjectHashOuter, Hash );
+		FScopeLock ShardLock( &Shard.CriticalSection );
+		checkSlow(!Shard.Map.FindPair(Hash,Object));  // if it already exists, something is wrong with the external code
+		Shard.Map.Add(Hash,Object);
+	}
 
 	AddToOuterMap(Object);
 	AddToClassMap(Object);
@@ -473,12 +528,20 @@ void UnhashObject(UObjectBase* Object)
 	}
 
 	int32 Hash = GetObjectHash( Name );
-	int32 NumRemoved = ObjectHash.RemoveSingle(Hash,Object);
-	check(NumRemoved == 1); // must have existed, else something is wrong with the external code
+	{
+		FObjectHashShard& Shard = GetObjectHashShard( ObjectHash, Hash );
+		FScopeLock ShardLock( &Shard.CriticalSection );
+		int32 NumRemoved = Shard.Map.RemoveSingle(Hash,Object);
+		check(NumRemoved == 1); // must have existed, else something is wrong with the external code
+	}
 
 	Hash = GetObjectOuterHash(Name,(PTRINT)Object->GetOuter());
-	NumRemoved = ObjectHashOuter.RemoveSingle(Hash,Object);
-	check(NumRemoved == 1); // must have existed, else something is wrong with the external code
+	{
+		FObjectHashShard& Shard = GetObjectHashShard( ObjectHashOuter, Hash );
+		FScopeLock ShardLock( &Shard.CriticalSection );
+		int32 NumRemoved = Shard.Map.RemoveSingle(Hash,Object);
+		check(NumRemoved == 1); // must have existed, else something is wrong with the external code
+	}
 
 	RemoveFromOuterMap(Object);
 	RemoveFromClassMap(Object);
@@ -23,8 +23,10 @@ enum EBulkDataFlags
 	BULKDATA_Unused								= 1<<5,
 	/** Forces the payload to be saved inline, regardless of its size				*/
 	BULKDATA_ForceInlinePayload					= 1<<6,
-	/** Flag to check if either compression mode is specified						*/
-	BULKDATA_SerializeCompressed				= (BULKDATA_SerializeCompressedZLIB),
+	/** If set, payload should be [un]compressed using LZ4 during serialization.	*/
+	BULKDATA_SerializeCompressedLZ4				= 1<<7,
+	/** Mask to check if either compression mode is specified, never set it as is		*/
+	BULKDATA_SerializeCompressed				= (BULKDATA_SerializeCompressedZLIB | BULKDATA_SerializeCompressedLZ4),
 
 };
 
@@ -273,7 +275,7 @@ struct COREUOBJECT_API FUntypedBulkData
 	/**
 	 * Sets whether we should store the data compressed on disk.
 	 *
-	 * @param CompressionFlags	Flags to use for compressing the data. Use COMPRESS_NONE for no compression, or something like COMPRESS_ZLIB to compress the data
+	 * @param CompressionFlags	Flags to use for compressing the data. Use COMPRESS_NONE for no compression, or COMPRESS_ZLIB or COMPRESS_LZ4 to compress the data
 	 */
 	void StoreCompressedOnDisk( ECompressionFlags CompressionFlags );
 
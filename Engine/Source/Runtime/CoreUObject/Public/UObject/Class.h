@@ -263,6 +263,7 @@ public:
 	virtual void FinishDestroy() override;
 	virtual void RegisterDependencies() override;
 	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+	virtual bool CanBeInCluster() const override { return false; }
 
 	// UField interface.
 	virtual void AddCppProperty(UProperty* Property) override;
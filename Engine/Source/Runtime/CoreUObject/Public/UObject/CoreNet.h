@@ -199,10 +199,11 @@ public:
 	uint16				RepIndex;
 	ELifetimeCondition	Condition;
 	ELifetimeRepNotifyCondition RepNotifyCondition;
+	bool				bIsPushBased;		// If true, the property is only compared after it has been marked dirty (see FNetPushModel)
 
-	FLifetimeProperty() : RepIndex( 0 ), Condition( COND_None ), RepNotifyCondition(REPNOTIFY_OnChanged) {}
-	FLifetimeProperty( int32 InRepIndex ) : RepIndex( InRepIndex ), Condition( COND_None ), RepNotifyCondition(REPNOTIFY_OnChanged) { check( InRepIndex <= 65535 ); }
-	FLifetimeProperty(int32 InRepIndex, ELifetimeCondition InCondition, ELifetimeRepNotifyCondition InRepNotifyCondition=REPNOTIFY_OnChanged) : RepIndex(InRepIndex), Condition(InCondition), RepNotifyCondition(InRepNotifyCondition) { check(InRepIndex <= 65535); }
+	FLifetimeProperty() : RepIndex( 0 ), Condition( COND_None ), RepNotifyCondition(REPNOTIFY_OnChanged), bIsPushBased( false ) {}
+	FLifetimeProperty( int32 InRepIndex ) : RepIndex( InRepIndex ), Condition( COND_None ), RepNotifyCondition(REPNOTIFY_OnChanged), bIsPushBased( false ) { check( InRepIndex <= 65535 ); }
+	FLifetimeProperty(int32 InRepIndex, ELifetimeCondition InCondition, ELifetimeRepNotifyCondition InRepNotifyCondition=REPNOTIFY_OnChanged, bool bInIsPushBased=false) : RepIndex(InRepIndex), Condition(InCondition), RepNotifyCondition(InRepNotifyCondition), bIsPushBased(bInIsPushBased) { check(InRepIndex <= 65535); }
 
 	inline bool operator==( const FLifetimeProperty& Other ) const
 	{
@@ -210,6 +211,7 @@ public:
 		{
 			check( Condition == Other.Condition );		// Can't have different conditions if the RepIndex matches, doesn't make sense
 			check( RepNotifyCondition == Other.RepNotifyCondition);
+			check( bIsPushBased == Other.bIsPushBased );
 			return true;
 		}
 
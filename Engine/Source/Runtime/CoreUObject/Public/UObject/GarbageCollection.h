@@ -8,6 +8,47 @@
 /** Context sensitive keep flags for garbage collection */
 #define GARBAGE_COLLECTION_KEEPFLAGS	(GIsEditor ? RF_Native|RF_AsyncLoading|RF_Standalone : RF_Native|RF_AsyncLoading)
 
+/** Whether an incremental reachability analysis is marking objects, the write barrier only does work while it is. */
+extern COREUOBJECT_API volatile bool GIsIncrementalReachabilityPending;
+
+/** Whether any garbage collection cluster exists, the write barrier only looks for them while there are. */
+extern COREUOBJECT_API volatile bool GHasObjectClusters;
+
+/**
+ * Marks an object reachable for the incremental reachability analysis in progress, and adds it to the references of
+ * the cluster the reference is stored in. Use ObjectWriteBarrier instead.
+ */
+COREUOBJECT_API void ObjectWriteBarrierSlow(const class UObjectBase* Object, const class UObjectBase* ReferencingObject, const void* ReferenceAddress);
+
+/**
+ * Write barrier for garbage collection, called with the new value whenever a reference to an object is stored in another
+ * object. While an incremental reachability analysis is spread over several frames, it makes sure objects the marker
+ * already went past can't hide an object from it. When the object the reference is stored in is in a garbage collection
+ * cluster, the cluster learns about the new reference. That object is the one passed, or else the cluster member whose
+ * memory contains ReferenceAddress; references stored outside of any object's memory, e.g. in a TArray, are only found
+ * through the object passed. Reflected object properties and renames go through it, native code storing references
+ * that the token stream follows should call it too.
+ *
+ * @param	Object				object a reference is being stored to, can be NULL
+ * @param	ReferencingObject	object the reference is stored in or owned by, if known
+ * @param	ReferenceAddress	address the reference is being stored at, if known
+ */
+FORCEINLINE void ObjectWriteBarrier(const class UObjectBase* Object, const class UObjectBase* ReferencingObject = NULL, const void* ReferenceAddress = NULL)
+{
+	if ((GIsIncrementalReachabilityPending || (GHasObjectClusters && (ReferencingObject || ReferenceAddress))) && Object)
+	{
+		ObjectWriteBarrierSlow(Object, ReferencingObject, ReferenceAddress);
+	}
+}
+
+/**
+ * Groups objects that just finished loading into garbage collection clusters, one for each of them that allows it, see
+ * UObject::CanBeClusterRoot. Only done in cooked games with gc.CreateGCClusters set.
+ *
+ * @param	LoadedObjects	objects that were loaded and had PostLoad called on them
+ */
+void CreateClustersFromLoadedObjects(const TArray<class UObject*>& LoadedObjects);
+
 /*-----------------------------------------------------------------------------
 	Realtime garbage collection helper classes.
 -----------------------------------------------------------------------------*/
@@ -85,6 +85,9 @@ public:
 	UProperty* MostRecentProperty;
 	uint8* MostRecentPropertyAddress;
 
+	/** Object whose instance variable was evaluated last, passed to the garbage collector as the owner of object references stored by the VM. */
+	UObject* MostRecentPropertyContainer;
+
 	/** The execution flow stack for compiled Kismet code */
 	FlowStackType FlowStack;
 
@@ -175,6 +178,7 @@ inline FFrame::FFrame( UObject* InObject, UFunction* InNode, void* InLocals, FFr
 	, Locals((uint8*)InLocals)
 	, MostRecentProperty(NULL)
 	, MostRecentPropertyAddress(NULL)
+	, MostRecentPropertyContainer(NULL)
 	, PreviousFrame(InPreviousFrame)
 	, OutParms(NULL)
 	, PropertyChainForCompiledIn(InPropertyChainForCompiledIn)
@@ -451,6 +451,26 @@ public:
 	/** Returns true if this object is safe to add to the root set. */
 	virtual bool IsSafeForRootSet() const;
 
+	/**
+	 * Returns true if this object can be the root of a garbage collection cluster. When loaded in a cooked game, it is
+	 * grouped with the objects in its package it references and that can be in a cluster, which the garbage collector
+	 * then marks as one. Only return true for assets that never change which objects they reference after PostLoad.
+	 */
+	virtual bool CanBeClusterRoot() const
+	{
+		return false;
+	}
+
+	/**
+	 * Returns true if this object can be added to the garbage collection cluster of an object referencing it. Only return
+	 * true for types that never change which objects they reference after PostLoad; native code that still does must
+	 * pass the object to ObjectWriteBarrier along with the new reference.
+	 */
+	virtual bool CanBeInCluster() const
+	{
+		return CanBeClusterRoot();
+	}
+
 	/** 
 	 * Tags objects that are part of the same asset with the specified object flag, used for GC checking
 	 *
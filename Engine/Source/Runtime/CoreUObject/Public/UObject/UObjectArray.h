@@ -22,6 +22,102 @@ extern COREUOBJECT_API int32** GSerialNumberBlocksForDebugVisualizersRoot;
 **/
 
 
+/**
+ * Array of object pointers that grows by chunks allocated on demand. Elements never move, so other threads can read
+ * them without a lock while elements are added. Only the table of chunk pointers is allocated up front.
+ */
+class FChunkedUObjectArray
+{
+	enum
+	{
+		/** Number of elements in a chunk, 512KB of pointers on 64 bit platforms */
+		NumElementsPerChunk = 64 * 1024,
+		/** Size of the chunk table, enough for 128M objects */
+		MaxChunks = 2048,
+	};
+
+	/** Chunks of element pointers, allocated when the first element in them is added */
+	UObjectBase** Chunks[MaxChunks];
+	/** Number of elements, every chunk they are in is allocated */
+	volatile int32 NumElements;
+	/** Number of allocated chunks */
+	int32 NumChunks;
+
+public:
+	FChunkedUObjectArray()
+		: NumElements(0)
+		, NumChunks(0)
+	{
+		FMemory::MemZero(Chunks);
+	}
+
+	/** @return the number of elements. Thread safe, other threads may add elements meanwhile. */
+	FORCEINLINE int32 Num() const
+	{
+		return NumElements;
+	}
+
+	/** @return true if the index is valid. Thread safe, an index that is valid stays valid. */
+	FORCEINLINE bool IsValidIndex(int32 Index) const
+	{
+		return Index >= 0 && Index < NumElements;
+	}
+
+	FORCEINLINE UObjectBase*& operator[](int32 Index)
+	{
+		checkSlow(IsValidIndex(Index));
+		return Chunks[Index / NumElementsPerChunk][Index % NumElementsPerChunk];
+	}
+
+	FORCEINLINE UObjectBase* const& operator[](int32 Index) const
+	{
+		checkSlow(IsValidIndex(Index));
+		return Chunks[Index / NumElementsPerChunk][Index % NumElementsPerChunk];
+	}
+
+	/**
+	 * Adds a NULL element at the end, allocating a new chunk if needed. Not thread safe with other adds.
+	 *
+	 * @return index of the new element
+	 */
+	int32 AddZeroed()
+	{
+		const int32 Index = NumElements;
+		const int32 ChunkIndex = Index / NumElementsPerChunk;
+		if (ChunkIndex >= NumChunks)
+		{
+			checkf(ChunkIndex < MaxChunks, TEXT("Maximum number of UObjects (%d) exceeded."), (int32)(MaxChunks * NumElementsPerChunk));
+			UObjectBase** NewChunk = (UObjectBase**)FMemory::Malloc(sizeof(UObjectBase*) * NumElementsPerChunk);
+			FMemory::Memzero(NewChunk, sizeof(UObjectBase*) * NumElementsPerChunk);
+			Chunks[ChunkIndex] = NewChunk;
+			NumChunks = ChunkIndex + 1;
+		}
+		// The chunk must be visible before threads reading without a lock see the new count
+		FPlatformMisc::MemoryBarrier();
+		NumElements = Index + 1;
+		return Index;
+	}
+
+	/** Frees all chunks. Not thread safe. */
+	void Empty()
+	{
+		for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ChunkIndex++)
+		{
+			FMemory::Free(Chunks[ChunkIndex]);
+			Chunks[ChunkIndex] = NULL;
+		}
+		NumElements = 0;
+		NumChunks = 0;
+	}
+
+	/** @return the chunk table for debug visualizers */
+	UObjectBase*** GetRootBlockForDebugVisualizers()
+	{
+		return Chunks;
+	}
+};
+
+
 class COREUOBJECT_API FUObjectArray
 {
 public:
@@ -104,6 +200,9 @@ public:
 
 	/**
 	 * Adds a uobject to the global array which is used for uobject iteration
+	 * Can be called from several threads at once. The array grows by chunks and never moves, so other threads can
+	 * keep iterating it and looking up objects by index meanwhile. Creation listeners are notified before the object
+	 * is stored in the array, outside of the lock guarding it.
 	 *
 	 * @param	Object Object to allocate an index for
 	 */
@@ -376,7 +475,7 @@ private:
 	/**
 	 * return the object array for use by debug visualizers
 	 */
-	static TArray<UObjectBase*>* GetObjectArrayForDebugVisualizers();
+	static UObjectBase*** GetObjectArrayForDebugVisualizers();
 
 	// note these variables are left with the Obj prefix so they can be related to the historical GObj versions
 
@@ -387,13 +486,17 @@ private:
 	/** If true this is the intial load and we should load objects int the disregarded for GC range.	*/
 	int32							OpenForDisregardForGC;
 	/** Array of all live objects.											*/
-	TArray<UObjectBase*>		ObjObjects;
+	FChunkedUObjectArray			ObjObjects;
 	/** Available object indices.											*/
 	TArray<int32>					ObjAvailable;	
+	/** Guards allocating and freeing indices, so objects can be constructed and destroyed from several threads. */
+	FCriticalSection				ObjObjectsCritical;
 	/**
 	 * Array of things to notify when a UObjectBase is created
 	 */
 	TArray<FUObjectCreateListener* > UObjectCreateListeners;
+	/** Guards the creation listeners, so they can't be removed while they are notified on another thread. */
+	FCriticalSection				UObjectCreateListenersCritical;
 	/**
 	 * Array of things to notify when a UObjectBase is destroyed
 	 */
@@ -293,6 +293,23 @@ COREUOBJECT_API float GetAsyncLoadPercentage( const FString& PackageName );
  * @param	bPerformFullPurge	if true, perform a full purge after the mark pass
  */
 COREUOBJECT_API void CollectGarbage( EObjectFlags KeepFlags, bool bPerformFullPurge = true );
+
+/**
+ * Garbage collects with the mark phase spread over several calls, when gc.IncrementalReachability is set. The first call
+ * starts marking reachable objects and following calls continue it, each for at most gc.IncrementalReachabilityTimeLimit.
+ * The call that finishes marking rescans the root set and the objects created meanwhile, then unhashes unreachable objects
+ * like CollectGarbage without a full purge. When gc.IncrementalReachability is 0 this is CollectGarbage( KeepFlags, false ).
+ *
+ * @param	KeepFlags	objects with those flags will be kept regardless of being referenced or not
+ * @return	true if the garbage collection finished marking and unhashed unreachable objects in this call
+ */
+COREUOBJECT_API bool IncrementalCollectGarbage( EObjectFlags KeepFlags );
+
+/**
+ * Returns whether an incremental garbage collection started marking and needs more calls to IncrementalCollectGarbage.
+ * CollectGarbage abandons it and does a full collection instead.
+ */
+COREUOBJECT_API bool IsIncrementalReachabilityAnalysisPending();
 COREUOBJECT_API void SerializeRootSet( FArchive& Ar, EObjectFlags KeepFlags );
 
 /**
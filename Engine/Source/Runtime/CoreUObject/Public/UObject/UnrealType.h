@@ -1700,7 +1700,14 @@ public:
 	{
 		return GetObjectPropertyValue(ContainerPtrToValuePtr<void>(PropertyValueAddress, ArrayIndex));
 	}
-	virtual void SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value) const
+	/**
+	 * Stores an object reference.
+	 *
+	 * @param	PropertyValueAddress	address of the value
+	 * @param	Value					the object to store
+	 * @param	Owner					object the value is in or owned by, if known, which garbage collection clusters need
+	 */
+	virtual void SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value, const UObject* Owner = NULL) const
 	{
 		check(0);
 	}
@@ -1708,6 +1715,10 @@ public:
 	{
 		SetObjectPropertyValue(ContainerPtrToValuePtr<void>(PropertyValueAddress, ArrayIndex), Value);
 	}
+	FORCEINLINE void SetObjectPropertyValue_InContainer(UObject* Container, UObject* Value, int32 ArrayIndex = 0) const
+	{
+		SetObjectPropertyValue(ContainerPtrToValuePtr<void>(Container, ArrayIndex), Value, Container);
+	}
 
 protected:
 	virtual bool AllowCrossLevel() const
@@ -1777,8 +1788,9 @@ class COREUOBJECT_API UObjectProperty : public TUObjectPropertyBase<UObject*>
 	{
 		return GetPropertyValue(PropertyValueAddress);
 	}
-	virtual void SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value) const override
+	virtual void SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value, const UObject* Owner = NULL) const override
 	{
+		ObjectWriteBarrier(Value, Owner, PropertyValueAddress);
 		SetPropertyValue(PropertyValueAddress, Value);
 	}
 	// End of UObjectPropertyBase interface
@@ -1810,7 +1822,7 @@ class COREUOBJECT_API UWeakObjectProperty : public TUObjectPropertyBase<FWeakObj
 	{
 		return GetPropertyValue(PropertyValueAddress).Get();
 	}
-	virtual void SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value) const override
+	virtual void SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value, const UObject* Owner = NULL) const override
 	{
 		SetPropertyValue(PropertyValueAddress, TCppType(Value));
 	}
@@ -1845,7 +1857,7 @@ class COREUOBJECT_API ULazyObjectProperty : public TUObjectPropertyBase<FLazyObj
 	{
 		return GetPropertyValue(PropertyValueAddress).Get();
 	}
-	virtual void SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value) const override
+	virtual void SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value, const UObject* Owner = NULL) const override
 	{
 		SetPropertyValue(PropertyValueAddress, TCppType(Value));
 	}
@@ -1885,7 +1897,7 @@ class COREUOBJECT_API UAssetObjectProperty : public TUObjectPropertyBase<FAssetP
 	{
 		return GetPropertyValue(PropertyValueAddress).Get();
 	}
-	virtual void SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value) const override
+	virtual void SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value, const UObject* Owner = NULL) const override
 	{
 		SetPropertyValue(PropertyValueAddress, TCppType(Value));
 	}
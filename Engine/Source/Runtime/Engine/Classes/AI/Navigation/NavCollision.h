@@ -79,6 +79,7 @@ class ENGINE_API UNavCollision : public UObject
 	virtual void Serialize(FArchive& Ar) override;
 	virtual void PostLoad() override;
 	virtual SIZE_T GetResourceSize(EResourceSizeMode::Type Mode) override;
+	virtual bool CanBeInCluster() const override { return true; }
 	// End UObject interface.
 
 	FGuid GetGuid() const;
@@ -51,5 +51,9 @@ class UDistribution : public UObject, public FCurveEdInterface
 {
 	GENERATED_UCLASS_BODY()
 
+	// Begin UObject interface
+	virtual bool CanBeInCluster() const override { return true; }
+	// End UObject interface
+
 };
 
@@ -5,6 +5,43 @@
 #pragma once
 #include "DemoNetDriver.generated.h"
 
+/**
+ * A chunk of a demo file: consecutive demo frames, compressed together.
+ * Written before the chunk data, and again in the index at the end of the file.
+ */
+struct FDemoChunkInfo
+{
+	/** File offset of the chunk data */
+	int64	Offset;
+	/** Size of the chunk data in the file */
+	int32	FileSize;
+	/** Size of the chunk's frames once uncompressed */
+	int32	UncompressedSize;
+	/** Flags the chunk data was compressed with, COMPRESS_None if stored as is */
+	int32	CompressionFlags;
+	/** Demo time before the chunk's first frame */
+	float	StartTime;
+	/** Number of frames recorded before the chunk */
+	int32	StartFrame;
+	/** True if the chunk starts on a new recording connection that replicates the whole world, so playback can start from it */
+	bool	bIsCheckpoint;
+
+	FDemoChunkInfo()
+		: Offset( 0 )
+		, FileSize( 0 )
+		, UncompressedSize( 0 )
+		, CompressionFlags( COMPRESS_None )
+		, StartTime( 0 )
+		, StartFrame( 0 )
+		, bIsCheckpoint( false )
+	{}
+
+	friend FArchive& operator<<( FArchive& Ar, FDemoChunkInfo& Info )
+	{
+		return Ar << Info.Offset << Info.FileSize << Info.UncompressedSize << Info.CompressionFlags << Info.StartTime << Info.StartFrame << Info.bIsCheckpoint;
+	}
+};
+
 UCLASS(transient, config=Engine)
 class UDemoNetDriver : public UNetDriver
 {
@@ -15,9 +52,42 @@ class UDemoNetDriver : public UNetDriver
 	/** Name of the file to read/write from */
 	FString				DemoFilename;
 
-	/** Handle to the archive that will read/write network packets */
+	/** Handle to the demo file, written by ChunkWriteTask while recording */
 	FArchive*			FileAr;
 
+	/** Reads or writes the demo frames of the current chunk in ChunkData */
+	FArchive*			StreamAr;
+
+	/** Uncompressed demo frames of the chunk being recorded or played back */
+	TArray<uint8>		ChunkData;
+
+	/** During recording, the chunk being recorded */
+	FDemoChunkInfo		CurrentChunk;
+
+	/** Every chunk of the demo. During recording, the chunks written so far */
+	TArray<FDemoChunkInfo> DemoChunks;
+
+	/** During playback, index in DemoChunks of the chunk being played */
+	int32				CurrentChunkIndex;
+
+	/** Compresses and writes the finished chunks off the game thread, one at a time so they stay in order */
+	FAsyncTask<class FDemoChunkWriteTask>* ChunkWriteTask;
+
+	/** Demo time of the last frame recorded or played back */
+	float				DemoCurrentTime;
+
+	/** During playback, length of the demo in seconds */
+	float				DemoTotalTime;
+
+	/** During recording, demo time of the last checkpoint */
+	float				LastCheckpointTime;
+
+	/** During playback, actors that were replicated on the previous connection, destroyed if the checkpoint doesn't replicate them again */
+	TArray< TWeakObjectPtr<AActor> > CheckpointActors;
+
+	/** During playback, true until the first frame of a checkpoint chunk we jumped to has been read */
+	bool				bReadingCheckpointFrame;
+
 	/** @todo document */
 	int32				DemoFrameNum;
 
@@ -73,4 +143,33 @@ class UDemoNetDriver : public UNetDriver
 	void SpawnDemoRecSpectator( UNetConnection* Connection );
 
 	void StopDemo();
+
+	/**
+	 * Jumps playback to a demo time, by restarting it from the last checkpoint before that time and catching up from there.
+	 *
+	 * @param Time seconds from the start of the demo, clamped to its length
+	 */
+	void GotoTimeInSeconds( float Time );
+
+protected:
+	/** Hands the chunk being recorded to ChunkWriteTask and starts a new one */
+	void FlushDemoChunk();
+
+	/** Waits for ChunkWriteTask and records the chunk it wrote in DemoChunks */
+	void FinishDemoChunkWrite();
+
+	/** Replaces the recording connection with a new one, so the next frame replicates the whole world from scratch */
+	void ResetRecordingConnection();
+
+	/** Reads the chunk index from the end of the demo file, or rebuilds it from the chunk headers if the recording wasn't stopped properly */
+	bool ReadDemoIndex();
+
+	/** Loads and decompresses a chunk for playback, switching to a new playback connection if it is a checkpoint */
+	bool LoadDemoChunk( int32 ChunkIndex, bool bNewConnection );
+
+	/** Replaces the playback connection with a new one, keeping the actors it replicated so the next checkpoint can reuse them */
+	void ResetPlaybackConnection();
+
+	/** Destroys the actors from the previous playback connection the checkpoint did not replicate again */
+	void DestroyCheckpointActors();
 };
@@ -174,6 +174,8 @@ public:
 	// Internal.
 	UPROPERTY()
 	double			LastReceiveTime;		// Last time a packet was received, for timeout checking.
+	/** Seconds the packet being received waited between being read from the socket and being processed, negative if the driver doesn't know */
+	float			ReceiveQueueDelay;
 	double			LastSendTime;			// Last time a packet was sent, for keepalives.
 	double			LastTickTime;			// Last time of polling.
 	int32			QueuedBytes;			// Bytes assumed to be queued up.
@@ -155,6 +155,14 @@ public:
 	UPROPERTY(Config)
 	bool RequireEngineVersionMatch;
 
+	/** If true, ServerReplicateActors uses a spatial grid to skip relevancy checks for actors outside their NetCullDistance (only with distance based relevancy) */
+	UPROPERTY(Config)
+	uint32 bUseNetRelevancyGrid:1;
+
+	/** Size along X and Y of a relevancy grid cell, in world units */
+	UPROPERTY(Config)
+	float NetRelevancyGridCellSize;
+
 	/** Connection to the server (this net driver is a client) */
 	UPROPERTY()
 	class UNetConnection* ServerConnection;
@@ -172,6 +180,9 @@ public:
 
 	TSharedPtr< class FClassNetCacheMgr >	NetCache;
 
+	/** Spatial index of network actors, only valid if bUseNetRelevancyGrid is set */
+	TSharedPtr< class FNetRelevancyGrid >	RelevancyGrid;
+
 	/** The loaded UClass of the net connection type to use */
 	UPROPERTY()
 	UClass* NetConnectionClass;
@@ -476,6 +487,9 @@ public:
 	ENGINE_API virtual void NotifyStreamingLevelUnload( ULevel* );
 
 	ENGINE_API virtual void NotifyActorLevelUnloaded( AActor* Actor );
+
+	/** Called when an actor is taken out of the world's network actor list, e.g. because its level was streamed out. */
+	ENGINE_API void RemoveNetworkActor( AActor* Actor );
 	
 	/** creates a child connection and adds it to the given parent connection */
 	ENGINE_API virtual class UChildConnection* CreateChild(UNetConnection* Parent);
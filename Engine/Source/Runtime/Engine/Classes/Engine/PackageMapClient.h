@@ -16,6 +16,11 @@
  *		-Flexibility. No precomputed net indices or large package lists need to be exchanged for UObject serialization.
  *		-Cross version communication. The name is all that is needed to exchange references.
  *		-Efficiency in that a very small % of UObjects will ever be serialized. Only Objects that serialized are assigned NetGUIDs.
+ *
+ *	Exports are made smaller in a few ways that don't give up the above:
+ *		-Objects named after their outer package (Foo.Foo, Foo.Foo_C, Foo.Default__Foo_C) don't send their name.
+ *		-When the client has the same FNetPathTable as the server, cooked packages are sent as an index in the table.
+ *		-Export bunches are compressed, see net.CompressNetGUIDExports.
  */
 
 #pragma once
@@ -98,6 +103,8 @@ class UPackageMapClient : public UPackageMap
 	{
 		GuidCache				= InNetGUIDCache;
 		ExportNetGUIDCount		= 0;
+		ExportBunchCheckBits	= 0;
+		bUsePathTable			= false;
 	}
 
 	virtual ~UPackageMapClient()
@@ -144,10 +151,23 @@ class UPackageMapClient : public UPackageMap
 
 	TArray< FNetworkGUID > & GetMustBeMappedGuidsInLastBunch() { return MustBeMappedGuidsInLastBunch; }
 
+	/** Called with the FNetPathTable checksum the remote side sent. Packages are exported as an index in the table if it matches ours */
+	void SetRemotePathTableChecksum( uint32 RemoteChecksum );
+
 protected:
 
 	bool	ExportNetGUID( FNetworkGUID NetGUID, const UObject* Object, FString PathName, UObject* ObjOuter );
 	void	ExportNetGUIDHeader();
+	void	ReceiveNetGUIDExports( FArchive& Ar, int32 NumGUIDsInBunch );
+
+	/** @return the max size of an export bunch that still fits in a packet */
+	int64	GetMaxExportBunchBits() const;
+
+	/** @return true if CurrentExportBunch will fit in a packet once compressed */
+	bool	ExportBunchFitsInPacket();
+
+	/** Compresses the exports in CurrentExportBunch into ExportCompressionBuffer. Returns the size of the compressed bunch in bits, or -1 on failure */
+	int64	CompressCurrentExportBunch();
 
 	void			InternalWriteObject( FArchive& Ar, FNetworkGUID NetGUID, const UObject* Object, FString ObjectPathName, UObject* ObjectOuter );	
 	FNetworkGUID	InternalLoadObject( FArchive & Ar, UObject *& Object, int InternalLoadObjectRecursionCount );
@@ -173,6 +193,11 @@ protected:
 
 	int32								ExportNetGUIDCount;
 
+	int64								ExportBunchCheckBits;				// CurrentExportBunch is known to fit in a packet until it grows past this size
+	TArray< uint8 >						ExportCompressionBuffer;			// Compressed exports of CurrentExportBunch
+
+	bool								bUsePathTable;						// True if the remote side has the same FNetPathTable as us
+
 	TSharedPtr< FNetGUIDCache >			GuidCache;
 
 	TArray< FNetworkGUID >				MustBeMappedGuidsInLastBunch;
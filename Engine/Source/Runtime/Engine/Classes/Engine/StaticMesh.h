@@ -493,6 +493,7 @@ public:
 	ENGINE_API virtual FString GetDesc() override;
 	ENGINE_API virtual SIZE_T GetResourceSize(EResourceSizeMode::Type Mode) override;
 	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+	virtual bool CanBeClusterRoot() const override { return true; }
 	// End UObject interface.
 
 	/**
@@ -48,6 +48,10 @@ class UStaticMeshSocket : public UObject
 	 */
 	ENGINE_API bool AttachActor(AActor* Actor, class UStaticMeshComponent* MeshComp) const;
 
+	// Begin UObject interface
+	virtual bool CanBeInCluster() const override { return true; }
+	// End UObject interface
+
 public:
 #if WITH_EDITOR
 	/** Broadcasts a notification whenever the socket property has changed. */
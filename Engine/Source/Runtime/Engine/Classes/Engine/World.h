@@ -2071,6 +2071,9 @@ private:
 	/** Utility function to handle Exec/Console Commands related to stopping demo playback */
 	bool HandleDemoStopCommand( const TCHAR* Cmd, FOutputDevice& Ar, UWorld* InWorld );
 
+	/** Utility function to handle Exec/Console Commands related to jumping to a time in demo playback */
+	bool HandleDemoScrubCommand( const TCHAR* Cmd, FOutputDevice& Ar, UWorld* InWorld );
+
 public:
 
 	// Destroys the current demo net driver
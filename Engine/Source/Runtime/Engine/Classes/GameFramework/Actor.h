@@ -150,6 +150,13 @@ public:
 	UPROPERTY(Category=Replication, EditDefaultsOnly, BlueprintReadWrite)
 	uint32 bNetUseOwnerRelevancy:1;
 
+	/**
+	 * Lets the net driver's relevancy grid skip this actor for connections outside its NetCullDistance.
+	 * Only set this for classes that don't override IsNetRelevantFor, their relevancy may not depend on distance alone.
+	 */
+	UPROPERTY(Category=Replication, EditDefaultsOnly, AdvancedDisplay)
+	uint32 bNetRelevancyGridCulling:1;
+
 	/** If true, all input on the stack below this actor will not be considered */
 	UPROPERTY(EditDefaultsOnly, Category=Input)
 	uint32 bBlockInput:1;
@@ -815,6 +815,7 @@ public:
 	ENGINE_API virtual void FinishDestroy() override;
 	ENGINE_API virtual SIZE_T GetResourceSize(EResourceSizeMode::Type Mode) override;
 	ENGINE_API static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+	virtual bool CanBeClusterRoot() const override { return true; }
 	// End UObject Interface
 
 #if WITH_EDITOR
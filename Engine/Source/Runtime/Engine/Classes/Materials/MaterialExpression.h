@@ -183,6 +183,7 @@ class ENGINE_API UMaterialExpression : public UObject
 
 	virtual bool Modify( bool bAlwaysMarkDirty=true ) override;
 	virtual void Serialize( FArchive& Ar );
+	virtual bool CanBeInCluster() const override { return true; }
 	// End UObject interface.
 
 	/**
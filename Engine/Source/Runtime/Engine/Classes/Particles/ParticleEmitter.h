@@ -172,6 +172,7 @@ class UParticleEmitter : public UObject
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif // WITH_EDITOR
 	virtual void PostLoad() override;
+	virtual bool CanBeInCluster() const override { return true; }
 	// End UObject Interface
 
 	// @todo document
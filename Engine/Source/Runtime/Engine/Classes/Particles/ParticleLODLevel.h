@@ -72,6 +72,7 @@ class UParticleLODLevel : public UObject
 
 	// Begin UObject Interface
 	virtual void	PostLoad() override;
+	virtual bool	CanBeInCluster() const override { return true; }
 	// End UObject Interface
 
 	// @todo document
@@ -211,6 +211,7 @@ class UParticleModule : public UObject
 #if WITH_EDITOR
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif // WITH_EDITOR
+	virtual bool CanBeInCluster() const override { return true; }
 	// End UObject Interface
 
 	/**
@@ -331,6 +331,7 @@ public:
 	virtual void PostLoad() override;
 	virtual SIZE_T GetResourceSize(EResourceSizeMode::Type Mode) override;
 	virtual void GetAssetRegistryTags(TArray<FAssetRegistryTag>& OutTags) const override;
+	virtual bool CanBeClusterRoot() const override { return true; }
 	// End UObject interface.
 
 
@@ -521,6 +521,7 @@ public:
 	virtual void PostEditUndo() override;
 #endif // WITH_EDITOR
 	virtual SIZE_T GetResourceSize(EResourceSizeMode::Type Mode) override;
+	virtual bool CanBeInCluster() const override { return true; }
 	// End UObject interface.
 
 	//
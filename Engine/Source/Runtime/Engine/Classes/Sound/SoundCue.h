@@ -83,6 +83,7 @@ public:
 	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
 	virtual void PostLoad() override;
 #endif
+	virtual bool CanBeClusterRoot() const override { return true; }
 	// End UObject interface.
 
 	// Begin USoundBase interface.
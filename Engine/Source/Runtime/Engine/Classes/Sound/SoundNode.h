@@ -69,6 +69,7 @@ public:
 	virtual void Serialize(FArchive& Ar) override;
 	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
 #endif //WITH_EDITOR
+	virtual bool CanBeInCluster() const override { return true; }
 	// End UObject Interface
 
 	//
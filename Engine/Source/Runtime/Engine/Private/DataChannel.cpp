@@ -8,6 +8,7 @@
 #include "Net/DataChannel.h"
 #include "Net/DataReplication.h"
 #include "Net/NetworkProfiler.h"
+#include "Net/NetReplicationProfiler.h"
 #include "Net/UnrealNetwork.h"
 #include "Engine/ActorChannel.h"
 #include "Engine/ControlChannel.h"
@@ -922,6 +923,7 @@ IMPLEMENT_CONTROL_CHANNEL_MESSAGE(Abort);
 IMPLEMENT_CONTROL_CHANNEL_MESSAGE(PCSwap);
 IMPLEMENT_CONTROL_CHANNEL_MESSAGE(ActorChannelFailure);
 IMPLEMENT_CONTROL_CHANNEL_MESSAGE(DebugText);
+IMPLEMENT_CONTROL_CHANNEL_MESSAGE(NetGUIDPathTable);
 IMPLEMENT_CONTROL_CHANNEL_MESSAGE(BeaconWelcome);
 IMPLEMENT_CONTROL_CHANNEL_MESSAGE(BeaconJoin);
 IMPLEMENT_CONTROL_CHANNEL_MESSAGE(BeaconAssignGUID);
@@ -1866,6 +1868,9 @@ bool UActorChannel::ReplicateActor()
 #if USE_NETWORK_PROFILER 
 	const uint32 ActorReplicateStartTime = GNetworkProfiler.IsTrackingEnabled() ? FPlatformTime::Cycles() : 0;
 #endif
+#if USE_NET_REPLICATION_PROFILER
+	const uint32 ActorReplicateStartCycles = GNetReplicationProfiler.IsTrackingEnabled() ? FPlatformTime::Cycles() : 0;
+#endif
 
 	// The Actor
 	WroteSomethingImportant |= ActorReplicator->ReplicateProperties( Bunch, RepFlags );
@@ -1891,6 +1896,7 @@ bool UActorChannel::ReplicateActor()
 
 
 	NETWORK_PROFILER(GNetworkProfiler.TrackReplicateActor(Actor, RepFlags, FPlatformTime::Cycles() - ActorReplicateStartTime ));
+	NET_REPLICATION_PROFILER(GNetReplicationProfiler.TrackReplicateActor(Actor, Connection, WroteSomethingImportant ? Bunch.GetNumBits() : 0, FPlatformTime::Cycles() - ActorReplicateStartCycles));
 
 	// -----------------------------
 	// Send if necessary
@@ -10,17 +10,99 @@
 #include "Engine/DemoPendingNetGame.h"
 #include "Engine/ActorChannel.h"
 #include "RepLayout.h"
+#include "Net/NetPushModel.h"
 #include "GameFramework/SpectatorPawn.h"
 
 DEFINE_LOG_CATEGORY_STATIC( LogDemo, Log, All );
 
 static TAutoConsoleVariable<float> CVarDemoRecordHz( TEXT( "demo.RecordHz" ), 10, TEXT( "Number of demo frames recorded per second" ) );
 static TAutoConsoleVariable<float> CVarDemoTimeDilation( TEXT( "demo.TimeDilation" ), 1.0f, TEXT( "Override time dilation during demo playback" ) );
+static TAutoConsoleVariable<float> CVarDemoCheckpointInterval( TEXT( "demo.CheckpointInterval" ), 30.0f, TEXT( "Seconds of demo time between checkpoints playback can jump to, 0 to only have the one at the start" ) );
+static TAutoConsoleVariable<int32> CVarDemoMaxChunkSize( TEXT( "demo.MaxChunkSize" ), 256 * 1024, TEXT( "Bytes of demo frames recorded before they are compressed and written as a chunk" ) );
+static TAutoConsoleVariable<int32> CVarDemoCompressChunks( TEXT( "demo.CompressChunks" ), 1, TEXT( "Compress demo chunks when recording" ) );
 
 static const int32 MAX_DEMO_READ_WRITE_BUFFER = 1024 * 2;
 
+/**
+ * Demo file layout:
+ *
+ *	Header:	magic, file version, engine version, level name, streaming levels
+ *	Chunks:	FDemoChunkInfo followed by the (compressed) demo frames of the chunk
+ *	Index:	total frames, total time, FDemoChunkInfo of every chunk
+ *	Footer:	int64 offset of the index, magic
+ *
+ * A demo frame is the frame's delta time followed by its packets, each prefixed by its size, and a size of 0.
+ */
+static const uint32 DEMO_FILE_MAGIC		= 0x2CF5A13D;
+static const uint32 DEMO_FILE_VERSION	= 1;
+
 #define DEMO_CHECKSUMS 0
 
+/*-----------------------------------------------------------------------------
+	FDemoChunkWriteTask.
+-----------------------------------------------------------------------------*/
+
+/** Compresses a recorded chunk and appends it to the demo file */
+class FDemoChunkWriteTask : public FNonAbandonableTask
+{
+	friend class FAsyncTask<FDemoChunkWriteTask>;
+
+public:
+	FDemoChunkWriteTask( FArchive* InFileAr )
+		: FileAr( InFileAr )
+		, bCompress( false )
+		, bHasChunk( false )
+	{}
+
+	/** Demo file the chunk is appended to */
+	FArchive*		FileAr;
+
+	/** Uncompressed demo frames of the chunk */
+	TArray<uint8>	Data;
+
+	/** Chunk being written, Offset and sizes are filled in by DoWork */
+	FDemoChunkInfo	Info;
+
+	/** Compress the chunk data */
+	bool			bCompress;
+
+	/** True from when the chunk is handed to the task until it is added to the driver's index */
+	bool			bHasChunk;
+
+private:
+	void DoWork()
+	{
+		Info.UncompressedSize	= Data.Num();
+		Info.CompressionFlags	= bCompress ? COMPRESS_ZLIB : COMPRESS_None;
+
+		// Write the info with a FileSize of 0 until the data is complete, so a chunk cut short by a crash is ignored
+		const int64 InfoPos = FileAr->Tell();
+		*FileAr << Info;
+
+		Info.Offset = FileAr->Tell();
+
+		if ( bCompress )
+		{
+			FileAr->SerializeCompressed( Data.GetData(), Data.Num(), COMPRESS_ZLIB );
+		}
+		else
+		{
+			FileAr->Serialize( Data.GetData(), Data.Num() );
+		}
+
+		Info.FileSize = (int32)( FileAr->Tell() - Info.Offset );
+
+		FileAr->Seek( InfoPos );
+		*FileAr << Info;
+		FileAr->Seek( Info.Offset + Info.FileSize );
+	}
+
+	static const TCHAR* Name()
+	{
+		return TEXT( "FDemoChunkWriteTask" );
+	}
+};
+
 /*-----------------------------------------------------------------------------
 	UDemoNetDriver.
 -----------------------------------------------------------------------------*/
@@ -39,6 +121,10 @@ bool UDemoNetDriver::InitBase( bool bInitAsClient, FNetworkNotify* InNotify, con
 		DemoFrameNum			= 0;
 		bIsRecordingDemoFrame	= false;
 		bDemoPlaybackDone		= false;
+		DemoCurrentTime			= 0;
+		DemoTotalTime			= 0;
+		CurrentChunkIndex		= 0;
+		bReadingCheckpointFrame	= false;
 
 		return true;
 	}
@@ -96,11 +182,22 @@ bool UDemoNetDriver::InitConnect( FNetworkNotify* InNotify, const FURL& ConnectU
 	// DEMO_FIXME: This is messing up for some reason, investigate
 	//FileAr->SetByteSwapping( true );
 
+	uint32 Magic = 0;
+	uint32 FileVersion = 0;
+	(*FileAr) << Magic;
+	(*FileAr) << FileVersion;
+
+	if ( Magic != DEMO_FILE_MAGIC || FileVersion != DEMO_FILE_VERSION )
+	{
+		Error = FString::Printf( TEXT( "Demo file %s is not a demo or was recorded with an incompatible version" ), *DemoFilename );
+		UE_LOG( LogDemo, Error, TEXT( "UDemoNetDriver::InitConnect: %s" ), *Error );
+		return false;
+	}
+
 	int32 EngineVersion = 0;
 	(*FileAr) << EngineVersion;
-	(*FileAr) << PlaybackTotalFrames;
 
-	UE_LOG( LogDemo, Log, TEXT( "Starting demo playback with demo. Filename: %s, Frames: %i, Version %i" ), *DemoFilename, PlaybackTotalFrames, EngineVersion );
+	UE_LOG( LogDemo, Log, TEXT( "Starting demo playback with demo. Filename: %s, Version %i" ), *DemoFilename, EngineVersion );
 
 #if 1
 	// Bypass UDemoPendingNetLevel
@@ -171,6 +268,15 @@ bool UDemoNetDriver::InitConnect( FNetworkNotify* InNotify, const FURL& ConnectU
 		UE_LOG( LogDemo, Log, TEXT( "  Loading streamingLevel: %s, %s" ), *PackageName, *PackageNameToLoad );
 	}
 
+	if ( !ReadDemoIndex() || !LoadDemoChunk( 0, false ) )
+	{
+		Error = FString::Printf( TEXT( "Couldn't read the demo frames of %s" ), *DemoFilename );
+		UE_LOG( LogDemo, Error, TEXT( "UDemoNetDriver::InitConnect: %s" ), *Error );
+		return false;
+	}
+
+	UE_LOG( LogDemo, Log, TEXT( "  Frames: %i, Time: %.2f, Chunks: %i" ), PlaybackTotalFrames, DemoTotalTime, DemoChunks.Num() );
+
 	DemoDeltaTime = 0;
 
 	return true;
@@ -211,14 +317,15 @@ bool UDemoNetDriver::InitListen( FNetworkNotify* InNotify, FURL& ListenURL, bool
 	//@note: swap on non console platforms as the console archives have byte swapping compiled out by default
 	//FileAr->SetByteSwapping(true);
 
+	uint32 Magic = DEMO_FILE_MAGIC;
+	uint32 FileVersion = DEMO_FILE_VERSION;
+	(*FileAr) << Magic;
+	(*FileAr) << FileVersion;
+
 	// write engine version info
 	int32 EngineVersion = GEngineNetVersion;
 	(*FileAr) << EngineVersion;
 
-	// write placeholder for total frames - will be updated when the demo is stopped
-	PlaybackTotalFrames = 0;
-	(*FileAr) << PlaybackTotalFrames;
-
 #if 0
 	// Create the control channel.
 	Connection->CreateChannel( CHTYPE_Control, 1, 0 );
@@ -266,11 +373,21 @@ bool UDemoNetDriver::InitListen( FNetworkNotify* InNotify, FURL& ListenURL, bool
 		}
 	}
 
+	// Frames are recorded in memory, and written a chunk at a time in the background.
+	// The first chunk replicates the whole world, so it is a checkpoint too.
+	DemoChunks.Empty();
+	ChunkData.Empty();
+	StreamAr = new FMemoryWriter( ChunkData );
+	CurrentChunk = FDemoChunkInfo();
+	CurrentChunk.bIsCheckpoint = true;
+	ChunkWriteTask = new FAsyncTask<FDemoChunkWriteTask>( FileAr );
+
 	// Spawn the demo recording spectator.
 	SpawnDemoRecSpectator( Connection );
 
 	DemoDeltaTime = 0;
 	LastRecordTime = 0;
+	LastCheckpointTime = 0;
 
 	return true;
 }
@@ -358,14 +475,32 @@ void UDemoNetDriver::StopDemo()
 
 	if ( !ServerConnection )
 	{
-		// write the total number of frames in the placeholder at the beginning of the file
 		if ( FileAr != NULL && World != NULL )
 		{
+			FlushDemoChunk();
+			FinishDemoChunkWrite();
+
+			// Write the index, followed by where it starts so playback can find it from the end of the file
+			int64 IndexOffset = FileAr->Tell();
 			PlaybackTotalFrames = DemoFrameNum;
-			int32 OldPos = FileAr->Tell();
-			FileAr->Seek( sizeof( int32 ) );
+			DemoTotalTime = DemoCurrentTime;
 			(*FileAr) << PlaybackTotalFrames;
-			FileAr->Seek( OldPos );
+			(*FileAr) << DemoTotalTime;
+			(*FileAr) << DemoChunks;
+
+			uint32 Magic = DEMO_FILE_MAGIC;
+			(*FileAr) << IndexOffset;
+			(*FileAr) << Magic;
+
+			int64 FrameBytes = 0;
+			int64 ChunkBytes = 0;
+			for ( int32 i = 0; i < DemoChunks.Num(); i++ )
+			{
+				FrameBytes += DemoChunks[i].UncompressedSize;
+				ChunkBytes += DemoChunks[i].FileSize;
+			}
+
+			UE_LOG( LogDemo, Log, TEXT( "StopDemo: %i chunks, %.2f seconds, %lld bytes of frames written as %lld bytes" ), DemoChunks.Num(), DemoTotalTime, FrameBytes, ChunkBytes );
 		}
 
 		// let GC cleanup the object
@@ -389,6 +524,17 @@ void UDemoNetDriver::StopDemo()
 		//SetWorld( NULL );
 	}
 
+	if ( ChunkWriteTask != NULL )
+	{
+		// The chunk being written still needs the file
+		ChunkWriteTask->EnsureCompletion();
+		delete ChunkWriteTask;
+		ChunkWriteTask = NULL;
+	}
+
+	delete StreamAr;
+	StreamAr = NULL;
+
 	delete FileAr;
 	FileAr = NULL;
 
@@ -469,15 +615,17 @@ void UDemoNetDriver::TickDemoRecord( float DeltaSeconds )
 	// Save out a frame
 	DemoFrameNum++;
 	ReplicationFrame++;
+	FNetPushModel::AdvanceEpoch();
 
 	// Save elapsed game time
-	*FileAr << DemoDeltaTime;
+	*StreamAr << DemoDeltaTime;
 
 #if DEMO_CHECKSUMS == 1
 	uint32 DeltaTimeChecksum = FCrc::MemCrc32( &DemoDeltaTime, sizeof( DemoDeltaTime ), 0 );
-	*FileAr << DeltaTimeChecksum;
+	*StreamAr << DeltaTimeChecksum;
 #endif
 
+	DemoCurrentTime += DemoDeltaTime;
 	DemoDeltaTime = 0;
 
 	// Make sure we don't have anything in the buffer for this new frame
@@ -517,18 +665,121 @@ void UDemoNetDriver::TickDemoRecord( float DeltaSeconds )
 	// Write a count of 0 to signal the end of the frame
 	int32 EndCount = 0;
 
-	*FileAr << EndCount;
+	*StreamAr << EndCount;
+
+	// Start a new chunk once this one is big enough, or a checkpoint once it is time for one
+	const float CheckpointInterval = CVarDemoCheckpointInterval.GetValueOnGameThread();
+	const bool bCheckpoint = CheckpointInterval > 0 && DemoCurrentTime - LastCheckpointTime >= CheckpointInterval;
+
+	if ( bCheckpoint || ChunkData.Num() >= CVarDemoMaxChunkSize.GetValueOnGameThread() )
+	{
+		FlushDemoChunk();
+
+		if ( bCheckpoint )
+		{
+			ResetRecordingConnection();
+			CurrentChunk.bIsCheckpoint = true;
+			LastCheckpointTime = DemoCurrentTime;
+		}
+	}
+}
+
+void UDemoNetDriver::FlushDemoChunk()
+{
+	if ( ChunkData.Num() == 0 )
+	{
+		return;
+	}
+
+	// Only one chunk is written at a time, so they end up in the file in order
+	FinishDemoChunkWrite();
+
+	FDemoChunkWriteTask& Task = ChunkWriteTask->GetTask();
+	Task.Info		= CurrentChunk;
+	Task.bCompress	= CVarDemoCompressChunks.GetValueOnGameThread() != 0;
+	Task.bHasChunk	= true;
+
+	// The task's buffer was already written, reuse it for the next chunk
+	Exchange( Task.Data, ChunkData );
+	ChunkData.Reset();
+
+	delete StreamAr;
+	StreamAr = new FMemoryWriter( ChunkData );
+
+	ChunkWriteTask->StartBackgroundTask();
+
+	CurrentChunk = FDemoChunkInfo();
+	CurrentChunk.StartTime	= DemoCurrentTime;
+	CurrentChunk.StartFrame	= DemoFrameNum;
+}
+
+void UDemoNetDriver::FinishDemoChunkWrite()
+{
+	if ( ChunkWriteTask == NULL )
+	{
+		return;
+	}
+
+	ChunkWriteTask->EnsureCompletion();
+
+	FDemoChunkWriteTask& Task = ChunkWriteTask->GetTask();
+
+	if ( Task.bHasChunk )
+	{
+		DemoChunks.Add( Task.Info );
+		Task.bHasChunk = false;
+	}
+}
+
+void UDemoNetDriver::ResetRecordingConnection()
+{
+	UDemoNetConnection* OldConnection = CastChecked< UDemoNetConnection >( ClientConnections[0] );
+	APlayerController* Spectator = OldConnection->PlayerController;
+	const FURL URL = OldConnection->URL;
+
+	// Keep the spectator, cleaning up the connection would destroy it
+	OldConnection->PlayerController = NULL;
+	OldConnection->OwningActor = NULL;
+
+	// Anything the old connection sends from now on is queued, and thrown away with it
+	OldConnection->Close();
+	OldConnection->CleanUp();
+
+	check( ClientConnections.Num() == 0 );
+
+	// The new connection has no channels and no exported guids, so the next frame replicates the whole world
+	UDemoNetConnection* Connection = ConstructObject<UDemoNetConnection>( UDemoNetConnection::StaticClass() );
+	Connection->InitConnection( this, USOCK_Open, URL, 1000000 );
+	Connection->InitSendBuffer();
+	ClientConnections.Add( Connection );
+
+	if ( Spectator != NULL )
+	{
+		Spectator->SetPlayer( Connection );
+	}
 }
 
 bool UDemoNetDriver::ReadDemoFrame()
 {
-	if ( FileAr->IsError() )
+	if ( FileAr->IsError() || StreamAr->IsError() )
 	{
 		StopDemo();
 		return false;
 	}
 
-	if ( FileAr->AtEnd() )
+	if ( StreamAr->AtEnd() && DemoChunks.IsValidIndex( CurrentChunkIndex + 1 ) )
+	{
+		const int32 NextChunkIndex = CurrentChunkIndex + 1;
+
+		// The recording switched connections at each checkpoint, playback has to follow
+		if ( !LoadDemoChunk( NextChunkIndex, DemoChunks[NextChunkIndex].bIsCheckpoint ) )
+		{
+			StopDemo();
+			return false;
+		}
+	}
+
+	if ( StreamAr->AtEnd() )
 	{
 		bDemoPlaybackDone = true;
 
@@ -553,17 +804,17 @@ bool UDemoNetDriver::ReadDemoFrame()
 		return false;
 	}
 
-	const int32 OldFilePos = FileAr->Tell();
+	const int64 OldStreamPos = StreamAr->Tell();
 
 	float ServerDeltaTime;
 
 	// Peek at the next demo delta time, and see if we should process this frame
-	*FileAr << ServerDeltaTime;
+	*StreamAr << ServerDeltaTime;
 
 #if DEMO_CHECKSUMS == 1
 	{
 		uint32 ServerDeltaTimeCheksum = 0;
-		*FileAr << ServerDeltaTimeCheksum;
+		*StreamAr << ServerDeltaTimeCheksum;
 
 		const uint32 DeltaTimeChecksum = FCrc::MemCrc32( &ServerDeltaTime, sizeof( ServerDeltaTime ), 0 );
 
@@ -576,21 +827,24 @@ bool UDemoNetDriver::ReadDemoFrame()
 	}
 #endif
 
-	if ( FileAr->IsError() )
+	if ( StreamAr->IsError() )
 	{
 		UE_LOG( LogDemo, Error, TEXT( "UDemoNetDriver::ReadDemoFrame: Failed to read demo ServerDeltaTime" ) );
 		StopDemo();
 		return false;
 	}
 
-	if ( DemoDeltaTime - ServerDeltaTime < 0 )//&& ServerConnection->State != USOCK_Pending )
+	// The checkpoint we jumped to is read right away, the world has to be restored before anything else
+	if ( !bReadingCheckpointFrame && DemoDeltaTime - ServerDeltaTime < 0 )//&& ServerConnection->State != USOCK_Pending )
 	{
 		// Not enough time has passed to read another frame
-		FileAr->Seek( OldFilePos );
+		StreamAr->Seek( OldStreamPos );
 		return false;
 	}
 
-	DemoDeltaTime -= ServerDeltaTime;
+	DemoDeltaTime = FMath::Max( DemoDeltaTime - ServerDeltaTime, 0.0f );
+	DemoCurrentTime += ServerDeltaTime;
+	bReadingCheckpointFrame = false;
 
 	while ( true )
 	{
@@ -598,9 +852,9 @@ bool UDemoNetDriver::ReadDemoFrame()
 
 		int32 PacketBytes;
 
-		*FileAr << PacketBytes;
+		*StreamAr << PacketBytes;
 
-		if ( FileAr->IsError() )
+		if ( StreamAr->IsError() )
 		{
 			UE_LOG( LogDemo, Error, TEXT( "UDemoNetDriver::ReadDemoFrame: Failed to read demo PacketBytes" ) );
 			StopDemo();
@@ -619,10 +873,10 @@ bool UDemoNetDriver::ReadDemoFrame()
 			return false;
 		}
 
-		// Read data from file.
-		FileAr->Serialize( ReadBuffer, PacketBytes );
+		// Read data from the chunk.
+		StreamAr->Serialize( ReadBuffer, PacketBytes );
 
-		if ( FileAr->IsError() )
+		if ( StreamAr->IsError() )
 		{
 			UE_LOG( LogDemo, Error, TEXT( "UDemoNetDriver::ReadDemoFrame: Failed to read demo file packet" ) );
 			StopDemo();
@@ -632,7 +886,7 @@ bool UDemoNetDriver::ReadDemoFrame()
 #if DEMO_CHECKSUMS == 1
 		{
 			uint32 ServerChecksum = 0;
-			*FileAr << ServerChecksum;
+			*StreamAr << ServerChecksum;
 
 			const uint32 Checksum = FCrc::MemCrc32( ReadBuffer, PacketBytes, 0 );
 
@@ -657,9 +911,221 @@ bool UDemoNetDriver::ReadDemoFrame()
 		}
 	}
 
+	// The first frame of a checkpoint replicated everything that still exists
+	if ( CheckpointActors.Num() > 0 )
+	{
+		DestroyCheckpointActors();
+	}
+
+	return true;
+}
+
+bool UDemoNetDriver::ReadDemoIndex()
+{
+	const int64 HeaderEnd = FileAr->Tell();
+	const int64 FileSize = FileAr->TotalSize();
+	const int64 FooterSize = sizeof( int64 ) + sizeof( uint32 );
+
+	DemoChunks.Empty();
+	PlaybackTotalFrames = 0;
+	DemoTotalTime = 0;
+
+	if ( FileSize - FooterSize >= HeaderEnd )
+	{
+		int64 IndexOffset = 0;
+		uint32 Magic = 0;
+
+		FileAr->Seek( FileSize - FooterSize );
+		(*FileAr) << IndexOffset;
+		(*FileAr) << Magic;
+
+		if ( Magic == DEMO_FILE_MAGIC && IndexOffset >= HeaderEnd && IndexOffset < FileSize - FooterSize )
+		{
+			FileAr->Seek( IndexOffset );
+			(*FileAr) << PlaybackTotalFrames;
+			(*FileAr) << DemoTotalTime;
+			(*FileAr) << DemoChunks;
+
+			return !FileAr->IsError() && DemoChunks.Num() > 0;
+		}
+	}
+
+	// The recording wasn't stopped properly, find the chunks that were completely written
+	UE_LOG( LogDemo, Warning, TEXT( "UDemoNetDriver::ReadDemoIndex: %s has no index, the recording was interrupted" ), *DemoFilename );
+
+	// Size of a serialized chunk info, so we don't read past the end of the file
+	TArray<uint8> InfoBytes;
+	FMemoryWriter InfoWriter( InfoBytes );
+	FDemoChunkInfo EmptyInfo;
+	InfoWriter << EmptyInfo;
+
+	FileAr->Seek( HeaderEnd );
+
+	while ( FileAr->Tell() + InfoBytes.Num() <= FileSize )
+	{
+		FDemoChunkInfo Info;
+		(*FileAr) << Info;
+
+		if ( FileAr->IsError() || Info.Offset != FileAr->Tell() || Info.FileSize <= 0 || Info.Offset + Info.FileSize > FileSize )
+		{
+			break;
+		}
+
+		DemoChunks.Add( Info );
+		FileAr->Seek( Info.Offset + Info.FileSize );
+	}
+
+	if ( DemoChunks.Num() > 0 )
+	{
+		// The length of the last chunk isn't known
+		PlaybackTotalFrames = DemoChunks.Last().StartFrame;
+		DemoTotalTime = DemoChunks.Last().StartTime;
+	}
+
+	return !FileAr->IsError() && DemoChunks.Num() > 0;
+}
+
+bool UDemoNetDriver::LoadDemoChunk( int32 ChunkIndex, bool bNewConnection )
+{
+	if ( !DemoChunks.IsValidIndex( ChunkIndex ) )
+	{
+		return false;
+	}
+
+	const FDemoChunkInfo& Info = DemoChunks[ChunkIndex];
+
+	ChunkData.Reset();
+	ChunkData.AddUninitialized( Info.UncompressedSize );
+
+	FileAr->Seek( Info.Offset );
+
+	if ( Info.CompressionFlags != COMPRESS_None )
+	{
+		FileAr->SerializeCompressed( ChunkData.GetData(), Info.UncompressedSize, (ECompressionFlags)Info.CompressionFlags );
+	}
+	else
+	{
+		FileAr->Serialize( ChunkData.GetData(), Info.UncompressedSize );
+	}
+
+	if ( FileAr->IsError() )
+	{
+		UE_LOG( LogDemo, Error, TEXT( "UDemoNetDriver::LoadDemoChunk: Failed to read chunk %i" ), ChunkIndex );
+		return false;
+	}
+
+	delete StreamAr;
+	StreamAr = new FMemoryReader( ChunkData );
+
+	CurrentChunkIndex = ChunkIndex;
+
+	if ( bNewConnection )
+	{
+		ResetPlaybackConnection();
+	}
+
 	return true;
 }
 
+void UDemoNetDriver::ResetPlaybackConnection()
+{
+	UNetConnection* OldConnection = ServerConnection;
+	const FURL URL = OldConnection->URL;
+
+	// Detach the replicated actors so cleaning up the connection doesn't destroy them,
+	// the checkpoint replicates them again with the same net guids and they are reused
+	for ( int32 i = OldConnection->OpenChannels.Num() - 1; i >= 0; i-- )
+	{
+		UActorChannel* ActorChannel = Cast< UActorChannel >( OldConnection->OpenChannels[i] );
+
+		if ( ActorChannel != NULL && ActorChannel->Actor != NULL )
+		{
+			CheckpointActors.Add( ActorChannel->Actor );
+			OldConnection->ActorChannels.Remove( ActorChannel->Actor );
+			ActorChannel->Actor = NULL;
+		}
+	}
+
+	// Same for the spectator, it is hooked up again when the checkpoint replicates it
+	OldConnection->PlayerController = NULL;
+	OldConnection->OwningActor = NULL;
+
+	OldConnection->State = USOCK_Closed;
+	OldConnection->Close();
+	OldConnection->CleanUp();
+
+	ServerConnection = ConstructObject<UNetConnection>( UDemoNetConnection::StaticClass() );
+	ServerConnection->InitConnection( this, USOCK_Pending, URL, 1000000 );
+	ServerConnection->CreateChannel( CHTYPE_Control, 1 );
+}
+
+void UDemoNetDriver::DestroyCheckpointActors()
+{
+	for ( int32 i = 0; i < CheckpointActors.Num(); i++ )
+	{
+		AActor* Actor = CheckpointActors[i].Get();
+
+		if ( Actor != NULL && !Actor->IsPendingKill() && !Actor->bNetTemporary && !ServerConnection->ActorChannels.Contains( Actor ) )
+		{
+			// Destroyed between the frame we jumped from and the checkpoint
+			Actor->Destroy( true );
+		}
+	}
+
+	CheckpointActors.Empty();
+}
+
+void UDemoNetDriver::GotoTimeInSeconds( float Time )
+{
+	if ( ServerConnection == NULL || FileAr == NULL || DemoChunks.Num() == 0 )
+	{
+		UE_LOG( LogDemo, Warning, TEXT( "GotoTimeInSeconds: No demo is playing" ) );
+		return;
+	}
+
+	Time = FMath::Clamp( Time, 0.0f, DemoTotalTime );
+
+	// Find the last checkpoint before Time, the first chunk always is one
+	int32 CheckpointIndex = 0;
+
+	for ( int32 i = 1; i < DemoChunks.Num() && DemoChunks[i].StartTime <= Time; i++ )
+	{
+		if ( DemoChunks[i].bIsCheckpoint )
+		{
+			CheckpointIndex = i;
+		}
+	}
+
+	if ( !LoadDemoChunk( CheckpointIndex, true ) )
+	{
+		StopDemo();
+		return;
+	}
+
+	if ( bDemoPlaybackDone )
+	{
+		// Undo the pause from reaching the end of the demo
+		for ( int32 i = 0; i < CheckpointActors.Num(); i++ )
+		{
+			if ( CheckpointActors[i].IsValid() )
+			{
+				CheckpointActors[i]->CustomTimeDilation = 1.0f;
+			}
+		}
+
+		bDemoPlaybackDone = false;
+	}
+
+	DemoFrameNum = DemoChunks[CheckpointIndex].StartFrame;
+	DemoCurrentTime = DemoChunks[CheckpointIndex].StartTime;
+
+	// TickDemoPlayback reads frames until this time is used up, catching up from the checkpoint to Time
+	DemoDeltaTime = Time - DemoCurrentTime;
+	bReadingCheckpointFrame = true;
+
+	UE_LOG( LogDemo, Log, TEXT( "GotoTimeInSeconds: %.2f, from the checkpoint at %.2f" ), Time, DemoCurrentTime );
+}
+
 void UDemoNetDriver::TickDemoPlayback( float DeltaSeconds )
 {
 	if ( ServerConnection == NULL || ServerConnection->State == USOCK_Closed )
@@ -756,7 +1222,7 @@ void UDemoNetConnection::LowLevelSend( void* Data, int32 Count )
 		UE_LOG( LogDemo, Fatal, TEXT( "UDemoNetConnection::LowLevelSend: Count > MAX_DEMO_READ_WRITE_BUFFER." ) );
 	}
 
-	if ( !GetDriver()->ServerConnection && GetDriver()->FileAr )
+	if ( !GetDriver()->ServerConnection && GetDriver()->StreamAr )
 	{
 		// If we're outside of an official demo frame, we need to queue this up or it will throw off the stream
 		if ( !GetDriver()->bIsRecordingDemoFrame )
@@ -767,12 +1233,12 @@ void UDemoNetConnection::LowLevelSend( void* Data, int32 Count )
 			return;
 		}
 
-		*GetDriver()->FileAr << Count;
-		GetDriver()->FileAr->Serialize( Data, Count );
+		*GetDriver()->StreamAr << Count;
+		GetDriver()->StreamAr->Serialize( Data, Count );
 		
 #if DEMO_CHECKSUMS == 1
 		uint32 Checksum = FCrc::MemCrc32( Data, Count, 0 );
-		*GetDriver()->FileAr << Checksum;
+		*GetDriver()->StreamAr << Checksum;
 #endif
 	}
 }
@@ -71,7 +71,10 @@ DEFINE_STAT(STAT_NetBroadcastTickTime);
 DEFINE_STAT(STAT_NetServerRepActorsTime);
 DEFINE_STAT(STAT_NetConsiderActorsTime);
 DEFINE_STAT(STAT_NetInitialDormantCheckTime);
+DEFINE_STAT(STAT_NetGatherPrioritizedActorsTime);
 DEFINE_STAT(STAT_NetPrioritizeActorsTime);
+DEFINE_STAT(STAT_NetPrioritizeActorsWaitTime);
+DEFINE_STAT(STAT_NetProcessPrioritizedActorsTime);
 DEFINE_STAT(STAT_NetReplicateActorsTime);
 DEFINE_STAT(STAT_NetReplicateDynamicPropTime);
 DEFINE_STAT(STAT_NetSkippedDynamicProps);
@@ -1292,12 +1295,17 @@ void UWorld::Tick( ELevelTick TickType, float DeltaSeconds )
 			bShouldDelayGarbageCollect = false;
 		}
 		// Perform incremental purge update if it's pending or in progress.
-		else if( !IsIncrementalPurgePending() 
+		else if( IsIncrementalReachabilityAnalysisPending() || (!IsIncrementalPurgePending() 
 		// Purge reference to pending kill objects every now and so often.
-		&&	(TimeSinceLastPendingKillPurge > TimeBetweenPurgingPendingKillObjects) && TimeBetweenPurgingPendingKillObjects > 0 )
+		&&	(TimeSinceLastPendingKillPurge > TimeBetweenPurgingPendingKillObjects) && TimeBetweenPurgingPendingKillObjects > 0) )
 		{
 			SCOPE_CYCLE_COUNTER(STAT_GCMarkTime);
-			PerformGarbageCollectionAndCleanupActors();
+			// Same as PerformGarbageCollectionAndCleanupActors, unless gc.IncrementalReachability spreads marking over several frames
+			if( !IsAsyncLoading() && IncrementalCollectGarbage( GARBAGE_COLLECTION_KEEPFLAGS ) )
+			{
+				CleanupActors();
+				TimeSinceLastPendingKillPurge = 0;
+			}
 		}
 		else
 		{
@@ -32,6 +32,7 @@ UNetConnection::UNetConnection(const FObjectInitializer& ObjectInitializer)
 ,	ResponseId			( 0 )
 ,	NegotiatedVer		( GEngineNegotiationVersion )
 
+,	ReceiveQueueDelay	( -1.f )
 ,	QueuedBytes			( 0 )
 ,	TickCount			( 0 )
 ,	ConnectTime			( 0.0 )
@@ -725,7 +726,9 @@ void UNetConnection::ReceivedPacket( FBitReader& Reader )
 			int32 Index = AckPacketId & (ARRAY_COUNT(OutLagPacketId)-1);
 			if( OutLagPacketId[Index]==AckPacketId )
 			{
-				float NewLag = Driver->Time - OutLagTime[Index] - (FrameTime/2.f);
+				// Don't count the time the ack waited to be processed, estimated as half a frame unless the driver measured it
+				const float ProcessDelay = ReceiveQueueDelay >= 0.f ? ReceiveQueueDelay : (FrameTime/2.f);
+				float NewLag = Driver->Time - OutLagTime[Index] - ProcessDelay;
 
 				LagAcc += NewLag;
 				LagCount++;
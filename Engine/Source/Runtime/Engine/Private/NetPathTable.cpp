@@ -0,0 +1,85 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	NetPathTable.cpp: Shared table of package names for NetGUID exports.
+=============================================================================*/
+
+#include "EnginePrivate.h"
+#include "Net/NetPathTable.h"
+
+static TAutoConsoleVariable<int32> CVarUseNetPathTable( TEXT( "net.UseNetPathTable" ), 1, TEXT( "Export packages in the cooked content as an index in a table shared by the server and clients, instead of their path name. Read once, when the table is first used." ) );
+
+const FNetPathTable& FNetPathTable::Get()
+{
+	static FNetPathTable Table;
+	static bool bIsBuilt = false;
+
+	check( IsInGameThread() );
+
+	if ( !bIsBuilt )
+	{
+		bIsBuilt = true;
+
+		// Uncooked content changes under the editor, and can't be expected to match on both sides
+		if ( FPlatformProperties::RequiresCookedData() && CVarUseNetPathTable.GetValueOnGameThread() > 0 )
+		{
+			const double StartTime = FPlatformTime::Seconds();
+
+			TArray<FString> Filenames;
+			FPackageName::FindPackagesInDirectory( Filenames, FPaths::EngineContentDir() );
+			FPackageName::FindPackagesInDirectory( Filenames, FPaths::GameContentDir() );
+
+			TArray<FString> PackageNames;
+			PackageNames.Reserve( Filenames.Num() );
+
+			for ( int32 i = 0; i < Filenames.Num(); i++ )
+			{
+				FString PackageName;
+				if ( FPackageName::TryConvertFilenameToLongPackageName( Filenames[i], PackageName ) )
+				{
+					PackageNames.Add( PackageName );
+				}
+			}
+
+			Table.Build( PackageNames );
+
+			UE_LOG( LogNet, Log, TEXT( "FNetPathTable: %i packages, checksum 0x%08X, built in %.2f ms" ), Table.Num(), Table.GetChecksum(), ( FPlatformTime::Seconds() - StartTime ) * 1000.0 );
+		}
+	}
+
+	return Table;
+}
+
+void FNetPathTable::Build( TArray<FString> InPackageNames )
+{
+	PackageNames.Reset();
+	PackageToIndex.Empty( InPackageNames.Num() );
+	Checksum = 0;
+
+	// FString sorts case insensitively, like FName compares, so the order doesn't depend on how files were found
+	InPackageNames.Sort();
+
+	for ( int32 i = 0; i < InPackageNames.Num(); i++ )
+	{
+		const FName PackageName( *InPackageNames[i] );
+
+		if ( PackageToIndex.Contains( PackageName ) )
+		{
+			continue;
+		}
+
+		PackageToIndex.Add( PackageName, PackageNames.Num() );
+		PackageNames.Add( PackageName );
+
+		// StrCrc32 hashes every character as 32 bits, so the checksum doesn't depend on the size of TCHAR.
+		// The separator keeps "A","B" and "AB" from colliding.
+		Checksum = FCrc::StrCrc32( *InPackageNames[i].ToUpper(), Checksum );
+		Checksum = FCrc::StrCrc32( TEXT( "\n" ), Checksum );
+	}
+
+	// 0 is reserved for an empty table
+	if ( PackageNames.Num() > 0 && Checksum == 0 )
+	{
+		Checksum = 1;
+	}
+}
@@ -0,0 +1,103 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	NetPushModel.cpp: Dirty tracking for push based replicated properties.
+=============================================================================*/
+
+#include "EnginePrivate.h"
+#include "Net/NetPushModel.h"
+
+uint32 FNetPushModel::Epoch = 1;
+
+/** Drops the dirty state of objects as they are deleted, so a new object at the same address starts clean */
+class FNetPushModelObjectListener : public FUObjectArray::FUObjectDeleteListener
+{
+public:
+	FNetPushModelObjectListener()
+	{
+		GUObjectArray.AddUObjectDeleteListener(this);
+	}
+
+	virtual void NotifyUObjectDeleted(const UObjectBase* Object, int32 Index) override
+	{
+		FNetPushModel::GetObjectStates().Remove(Object);
+	}
+};
+
+TMap<const UObjectBase*, FNetPushModel::FObjectState>& FNetPushModel::GetObjectStates()
+{
+	static TMap<const UObjectBase*, FObjectState> ObjectStates;
+	return ObjectStates;
+}
+
+FNetPushModel::FObjectState& FNetPushModel::FindOrAddObjectState(const UObject* Object)
+{
+	check(IsInGameThread());
+
+	// Only start listening once something is actually push based
+	static FNetPushModelObjectListener Listener;
+
+	return GetObjectStates().FindOrAdd(Object);
+}
+
+void FNetPushModel::MarkPropertyDirty(const UObject* Object, int32 RepIndex, int32 Count)
+{
+	check(RepIndex >= 0 && Count > 0);
+
+	FObjectState& State = FindOrAddObjectState(Object);
+	if (State.PropertyDirtyEpoch.Num() < RepIndex + Count)
+	{
+		State.PropertyDirtyEpoch.AddZeroed(RepIndex + Count - State.PropertyDirtyEpoch.Num());
+	}
+
+	for (int32 i = RepIndex; i < RepIndex + Count; i++)
+	{
+		State.PropertyDirtyEpoch[i] = Epoch;
+	}
+	State.LastDirtyEpoch = Epoch;
+}
+
+void FNetPushModel::MarkObjectDirty(const UObject* Object)
+{
+	FObjectState& State = FindOrAddObjectState(Object);
+	State.AllDirtyEpoch = Epoch;
+	State.LastDirtyEpoch = Epoch;
+}
+
+bool FNetPushModel::IsPropertyDirty(const UObject* Object, int32 RepIndex, uint32 SinceEpoch)
+{
+	if (SinceEpoch == 0)
+	{
+		return true;
+	}
+
+	const FObjectState* State = GetObjectStates().Find(Object);
+	if (State == NULL || State->LastDirtyEpoch < SinceEpoch)
+	{
+		return false;
+	}
+
+	return State->AllDirtyEpoch >= SinceEpoch || (State->PropertyDirtyEpoch.IsValidIndex(RepIndex) && State->PropertyDirtyEpoch[RepIndex] >= SinceEpoch);
+}
+
+bool FNetPushModel::IsObjectDirty(const UObject* Object, uint32 SinceEpoch)
+{
+	if (SinceEpoch == 0)
+	{
+		return true;
+	}
+
+	const FObjectState* State = GetObjectStates().Find(Object);
+	return State != NULL && State->LastDirtyEpoch >= SinceEpoch;
+}
+
+void FNetPushModel::AdvanceEpoch()
+{
+	check(IsInGameThread());
+
+	// Skip 0 on wrap around, it is reserved for "never compared"
+	if (++Epoch == 0)
+	{
+		Epoch = 1;
+	}
+}
@@ -0,0 +1,196 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	NetRelevancyGrid.cpp: Spatial index used to find relevancy candidates.
+=============================================================================*/
+
+#include "EnginePrivate.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/NetRelevancyGrid.h"
+#include "Engine/ActorChannel.h"
+
+FNetRelevancyGrid::FNetRelevancyGrid(float InCellSize)
+	: CellSize(FMath::Max(InCellSize, 100.f))
+	, MaxCullDistanceSquared(0.f)
+	, QueryTag(0)
+{
+}
+
+bool FNetRelevancyGrid::IsSpatiallyRelevant(AActor* Actor)
+{
+	// Anything that can be relevant through ownership, instigation or attachment goes through the full check every time
+	if (Actor->bAlwaysRelevant || Actor->bOnlyRelevantToOwner || Actor->bNetUseOwnerRelevancy || Actor->GetOwner() != NULL || Actor->Instigator != NULL)
+	{
+		return false;
+	}
+
+	// Classes that override IsNetRelevantFor can't be told apart at runtime, so only culling classes that opted in is safe
+	if (!Actor->bNetRelevancyGridCulling)
+	{
+		return false;
+	}
+
+	USceneComponent* RootComponent = Actor->GetRootComponent();
+	return RootComponent != NULL && RootComponent->AttachParent == NULL;
+}
+
+FIntPoint FNetRelevancyGrid::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+TArray<int32>& FNetRelevancyGrid::GetEntryList(const FEntry& Entry)
+{
+	return Entry.bSpatial ? Cells.FindChecked(Entry.Cell) : NonSpatialEntries;
+}
+
+void FNetRelevancyGrid::LinkEntry(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	TArray<int32>& List = Entry.bSpatial ? Cells.FindOrAdd(Entry.Cell) : NonSpatialEntries;
+	Entry.IndexInList = List.Add(EntryIndex);
+}
+
+void FNetRelevancyGrid::UnlinkEntry(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	TArray<int32>& List = GetEntryList(Entry);
+	check(List[Entry.IndexInList] == EntryIndex);
+
+	List.RemoveAtSwap(Entry.IndexInList, 1, false);
+	if (Entry.IndexInList < List.Num())
+	{
+		Entries[List[Entry.IndexInList]].IndexInList = Entry.IndexInList;
+	}
+	if (Entry.bSpatial && List.Num() == 0)
+	{
+		Cells.Remove(Entry.Cell);
+	}
+	Entry.IndexInList = INDEX_NONE;
+}
+
+void FNetRelevancyGrid::MarkConsidered(AActor* Actor, uint32 Frame)
+{
+	const bool bSpatial = IsSpatiallyRelevant(Actor);
+	const FIntPoint Cell = bSpatial ? GetCell(Actor->GetActorLocation()) : FIntPoint::ZeroValue;
+
+	int32* ExistingIndex = ActorToEntry.Find(Actor);
+	if (ExistingIndex == NULL)
+	{
+		FEntry NewEntry;
+		NewEntry.Actor = Actor;
+		NewEntry.Cell = Cell;
+		NewEntry.IndexInList = INDEX_NONE;
+		NewEntry.ConsiderFrame = Frame;
+		NewEntry.QueryTag = QueryTag;
+		NewEntry.bSpatial = bSpatial;
+
+		const int32 EntryIndex = Entries.Add(NewEntry);
+		ActorToEntry.Add(Actor, EntryIndex);
+		LinkEntry(EntryIndex);
+	}
+	else
+	{
+		const int32 EntryIndex = *ExistingIndex;
+		FEntry& Entry = Entries[EntryIndex];
+		Entry.ConsiderFrame = Frame;
+
+		if (Entry.bSpatial != bSpatial || (bSpatial && Entry.Cell != Cell))
+		{
+			UnlinkEntry(EntryIndex);
+			Entry.bSpatial = bSpatial;
+			Entry.Cell = Cell;
+			LinkEntry(EntryIndex);
+		}
+	}
+
+	if (bSpatial)
+	{
+		MaxCullDistanceSquared = FMath::Max(MaxCullDistanceSquared, Actor->NetCullDistanceSquared);
+	}
+}
+
+void FNetRelevancyGrid::RemoveActor(AActor* Actor)
+{
+	int32 EntryIndex = INDEX_NONE;
+	if (ActorToEntry.RemoveAndCopyValue(Actor, EntryIndex))
+	{
+		UnlinkEntry(EntryIndex);
+		Entries.RemoveAt(EntryIndex);
+	}
+}
+
+void FNetRelevancyGrid::Empty()
+{
+	Entries.Empty();
+	ActorToEntry.Empty();
+	Cells.Empty();
+	NonSpatialEntries.Empty();
+	MaxCullDistanceSquared = 0.f;
+}
+
+void FNetRelevancyGrid::GatherCell(const TArray<int32>& CellEntries, const FVector& ViewLocation, uint32 Frame, TArray<AActor*>& OutActors)
+{
+	for (int32 i = 0; i < CellEntries.Num(); i++)
+	{
+		FEntry& Entry = Entries[CellEntries[i]];
+		if (Entry.ConsiderFrame == Frame && (ViewLocation - Entry.Actor->GetActorLocation()).SizeSquared() < Entry.Actor->NetCullDistanceSquared)
+		{
+			GatherEntry(Entry, Frame, OutActors);
+		}
+	}
+}
+
+void FNetRelevancyGrid::GatherCandidates(UNetConnection* Connection, const TArray<FNetViewer>& Viewers, uint32 Frame, TArray<AActor*>& OutActors)
+{
+	QueryTag++;
+
+	// Actors with an open channel must be visited so that their channel can be kept alive or closed
+	for (auto It = Connection->ActorChannels.CreateConstIterator(); It; ++It)
+	{
+		const int32* EntryIndex = ActorToEntry.Find(It.Key());
+		if (EntryIndex != NULL)
+		{
+			GatherEntry(Entries[*EntryIndex], Frame, OutActors);
+		}
+	}
+
+	for (int32 i = 0; i < NonSpatialEntries.Num(); i++)
+	{
+		GatherEntry(Entries[NonSpatialEntries[i]], Frame, OutActors);
+	}
+
+	// Visit every cell overlapping the square around each viewer that bounds the largest cull distance
+	const float QueryRadius = FMath::Sqrt(MaxCullDistanceSquared);
+	const FVector QueryExtent(QueryRadius, QueryRadius, 0.f);
+
+	for (int32 ViewerIdx = 0; ViewerIdx < Viewers.Num(); ViewerIdx++)
+	{
+		const FVector& ViewLocation = Viewers[ViewerIdx].ViewLocation;
+		const FIntPoint MinCell = GetCell(ViewLocation - QueryExtent);
+		const FIntPoint MaxCell = GetCell(ViewLocation + QueryExtent);
+
+		// With a very large cull distance it is cheaper to walk the occupied cells than the covered ones
+		const int64 NumCoveredCells = int64(MaxCell.X - MinCell.X + 1) * int64(MaxCell.Y - MinCell.Y + 1);
+		if (NumCoveredCells > Cells.Num())
+		{
+			for (auto It = Cells.CreateConstIterator(); It; ++It)
+			{
+				GatherCell(It.Value(), ViewLocation, Frame, OutActors);
+			}
+			continue;
+		}
+
+		for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; CellY++)
+		{
+			for (int32 CellX = MinCell.X; CellX <= MaxCell.X; CellX++)
+			{
+				const TArray<int32>* CellEntries = Cells.Find(FIntPoint(CellX, CellY));
+				if (CellEntries != NULL)
+				{
+					GatherCell(*CellEntries, ViewLocation, Frame, OutActors);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,329 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	NetReplicationProfiler.cpp: In-process replication cost aggregation.
+=============================================================================*/
+
+#include "EnginePrivate.h"
+#include "Net/NetReplicationProfiler.h"
+
+#if USE_NET_REPLICATION_PROFILER
+
+static TAutoConsoleVariable<int32> CVarRepProfiler( TEXT( "net.RepProfiler" ), 0, TEXT( "Track replication cost per class, property and connection. See NETPROFILEREP" ) );
+static TAutoConsoleVariable<float> CVarRepProfilerCSVInterval( TEXT( "net.RepProfiler.CSVInterval" ), 0.0f, TEXT( "When net.RepProfiler is on, write the totals to a CSV in the profiling directory and reset them every this many seconds. 0 to disable" ) );
+
+/** Default number of rows printed per table by NETPROFILEREP */
+#define NET_REPLICATION_PROFILER_DEFAULT_ROWS (20)
+
+/** Global replication profiler instance. */
+FNetReplicationProfiler GNetReplicationProfiler;
+
+static double CyclesToMilliseconds( const uint64 Cycles )
+{
+	return Cycles * FPlatformTime::GetSecondsPerCycle() * 1000.0;
+}
+
+FNetReplicationProfiler::FNetReplicationProfiler()
+	: StartTime( 0.0 )
+	, StopTime( 0.0 )
+	, LastCSVTime( 0.0 )
+	, bIsTrackingEnabled( false )
+{
+}
+
+FNetReplicationProfiler::FClassStats& FNetReplicationProfiler::FindOrAddClassStats( const UStruct* Owner )
+{
+	const TWeakObjectPtr< UStruct > Key( const_cast< UStruct* >( Owner ) );
+
+	FClassStats* Stats = ClassStats.Find( Key );
+
+	if ( Stats == NULL )
+	{
+		Stats = &ClassStats.Add( Key, FClassStats() );
+		Stats->Name = Owner->GetName();
+
+		UClass* Class = Cast< UClass >( Key.Get() );
+
+		if ( Class != NULL && Class->IsChildOf( AActor::StaticClass() ) )
+		{
+			Stats->NetUpdateFrequency = Class->GetDefaultObject< AActor >()->NetUpdateFrequency;
+		}
+	}
+
+	return *Stats;
+}
+
+FNetReplicationProfiler::FConnectionStats& FNetReplicationProfiler::FindOrAddConnectionStats( const UNetConnection* Connection )
+{
+	const TWeakObjectPtr< UNetConnection > Key( const_cast< UNetConnection* >( Connection ) );
+
+	FConnectionStats* Stats = ConnectionStats.Find( Key );
+
+	if ( Stats == NULL )
+	{
+		Stats = &ConnectionStats.Add( Key, FConnectionStats() );
+		Stats->Name = Key->LowLevelGetRemoteAddress( true );
+	}
+
+	return *Stats;
+}
+
+void FNetReplicationProfiler::TrackReplicateActor( const AActor* Actor, const UNetConnection* Connection, const uint32 NumBits, const uint32 Cycles )
+{
+	FClassStats& Stats = FindOrAddClassStats( Actor->GetClass() );
+
+	Stats.NumReplicates++;
+	Stats.ReplicateCycles += Cycles;
+
+	if ( NumBits > 0 )
+	{
+		Stats.NumSends++;
+		Stats.NumBits += NumBits;
+
+		FConnectionStats& ConnStats = FindOrAddConnectionStats( Connection );
+
+		ConnStats.NumSends++;
+		ConnStats.NumBits += NumBits;
+	}
+}
+
+void FNetReplicationProfiler::TrackCompareProperties( const UStruct* Owner, const uint32 Cycles )
+{
+	FClassStats& Stats = FindOrAddClassStats( Owner );
+
+	Stats.NumCompares++;
+	Stats.CompareCycles += Cycles;
+}
+
+void FNetReplicationProfiler::TrackReplicateProperty( const UProperty* Property, const uint32 NumBits )
+{
+	const TWeakObjectPtr< UProperty > Key( const_cast< UProperty* >( Property ) );
+
+	FPropertyStats* Stats = PropertyStats.Find( Key );
+
+	if ( Stats == NULL )
+	{
+		Stats = &PropertyStats.Add( Key, FPropertyStats() );
+		Stats->Name = FString::Printf( TEXT( "%s.%s" ), *Property->GetOuter()->GetName(), *Property->GetName() );
+	}
+
+	Stats->NumSends++;
+	Stats->NumBits += NumBits;
+}
+
+void FNetReplicationProfiler::TrackSendRPC( const AActor* Actor, const UNetConnection* Connection, const uint32 NumBits )
+{
+	FClassStats& Stats = FindOrAddClassStats( Actor->GetClass() );
+
+	Stats.NumRPCs++;
+	Stats.RPCBits += NumBits;
+
+	FConnectionStats& ConnStats = FindOrAddConnectionStats( Connection );
+
+	ConnStats.NumRPCs++;
+	ConnStats.RPCBits += NumBits;
+}
+
+void FNetReplicationProfiler::Tick()
+{
+	const double Now = FPlatformTime::Seconds();
+	const bool bShouldTrack = CVarRepProfiler.GetValueOnGameThread() > 0;
+
+	if ( bShouldTrack != bIsTrackingEnabled )
+	{
+		bIsTrackingEnabled = bShouldTrack;
+
+		if ( bIsTrackingEnabled )
+		{
+			// Start from scratch, so the totals cover a known amount of time
+			Reset();
+		}
+		else
+		{
+			StopTime = Now;
+		}
+
+		UE_LOG( LogNet, Log, TEXT( "FNetReplicationProfiler: Tracking %s" ), bIsTrackingEnabled ? TEXT( "enabled" ) : TEXT( "disabled" ) );
+	}
+
+	if ( !bIsTrackingEnabled )
+	{
+		return;
+	}
+
+	const float CSVInterval = CVarRepProfilerCSVInterval.GetValueOnGameThread();
+
+	if ( CSVInterval > 0.0f && Now - LastCSVTime >= CSVInterval )
+	{
+		WriteCSV();
+		Reset();
+	}
+}
+
+void FNetReplicationProfiler::Reset()
+{
+	ClassStats.Empty();
+	PropertyStats.Empty();
+	ConnectionStats.Empty();
+
+	StartTime	= FPlatformTime::Seconds();
+	StopTime	= StartTime;
+	LastCSVTime	= StartTime;
+}
+
+double FNetReplicationProfiler::GetElapsedTime() const
+{
+	return FMath::Max( ( bIsTrackingEnabled ? FPlatformTime::Seconds() : StopTime ) - StartTime, 0.001 );
+}
+
+void FNetReplicationProfiler::Dump( FOutputDevice& Ar, const int32 MaxRows ) const
+{
+	const double ElapsedTime = GetElapsedTime();
+
+	Ar.Logf( TEXT( "Replication profile over %.1f seconds, sorted by bits sent" ), ElapsedTime );
+
+	TArray< FClassStats > SortedClasses;
+	ClassStats.GenerateValueArray( SortedClasses );
+	SortedClasses.Sort( []( const FClassStats& A, const FClassStats& B ) { return A.NumBits + A.RPCBits > B.NumBits + B.RPCBits; } );
+
+	Ar.Logf( TEXT( "" ) );
+	Ar.Logf( TEXT( "%-40s %9s %9s %9s %9s %10s %10s %10s %7s %9s" ), TEXT( "Class" ), TEXT( "UpdateHz" ), TEXT( "Rep/s" ), TEXT( "Sends/s" ), TEXT( "KB/s" ), TEXT( "Bits/Send" ), TEXT( "RepMs/s" ), TEXT( "CmpMs/s" ), TEXT( "RPC/s" ), TEXT( "RPCKB/s" ) );
+
+	for ( int32 i = 0; i < SortedClasses.Num() && i < MaxRows; i++ )
+	{
+		const FClassStats& Stats = SortedClasses[i];
+
+		Ar.Logf( TEXT( "%-40s %9.1f %9.1f %9.1f %9.2f %10.1f %10.3f %10.3f %7.1f %9.2f" ),
+			*Stats.Name,
+			Stats.NetUpdateFrequency,
+			Stats.NumReplicates / ElapsedTime,
+			Stats.NumSends / ElapsedTime,
+			Stats.NumBits / 8192.0 / ElapsedTime,
+			Stats.NumSends > 0 ? (double)Stats.NumBits / Stats.NumSends : 0.0,
+			CyclesToMilliseconds( Stats.ReplicateCycles ) / ElapsedTime,
+			CyclesToMilliseconds( Stats.CompareCycles ) / ElapsedTime,
+			Stats.NumRPCs / ElapsedTime,
+			Stats.RPCBits / 8192.0 / ElapsedTime );
+	}
+
+	TArray< FPropertyStats > SortedProperties;
+	PropertyStats.GenerateValueArray( SortedProperties );
+	SortedProperties.Sort( []( const FPropertyStats& A, const FPropertyStats& B ) { return A.NumBits > B.NumBits; } );
+
+	Ar.Logf( TEXT( "" ) );
+	Ar.Logf( TEXT( "%-60s %9s %9s %10s" ), TEXT( "Property" ), TEXT( "Sends/s" ), TEXT( "KB/s" ), TEXT( "Bits/Send" ) );
+
+	for ( int32 i = 0; i < SortedProperties.Num() && i < MaxRows; i++ )
+	{
+		const FPropertyStats& Stats = SortedProperties[i];
+
+		Ar.Logf( TEXT( "%-60s %9.1f %9.2f %10.1f" ),
+			*Stats.Name,
+			Stats.NumSends / ElapsedTime,
+			Stats.NumBits / 8192.0 / ElapsedTime,
+			Stats.NumSends > 0 ? (double)Stats.NumBits / Stats.NumSends : 0.0 );
+	}
+
+	TArray< FConnectionStats > SortedConnections;
+	ConnectionStats.GenerateValueArray( SortedConnections );
+	SortedConnections.Sort( []( const FConnectionStats& A, const FConnectionStats& B ) { return A.NumBits + A.RPCBits > B.NumBits + B.RPCBits; } );
+
+	Ar.Logf( TEXT( "" ) );
+	Ar.Logf( TEXT( "%-40s %9s %9s %7s %9s" ), TEXT( "Connection" ), TEXT( "Sends/s" ), TEXT( "KB/s" ), TEXT( "RPC/s" ), TEXT( "RPCKB/s" ) );
+
+	for ( int32 i = 0; i < SortedConnections.Num() && i < MaxRows; i++ )
+	{
+		const FConnectionStats& Stats = SortedConnections[i];
+
+		Ar.Logf( TEXT( "%-40s %9.1f %9.2f %7.1f %9.2f" ),
+			*Stats.Name,
+			Stats.NumSends / ElapsedTime,
+			Stats.NumBits / 8192.0 / ElapsedTime,
+			Stats.NumRPCs / ElapsedTime,
+			Stats.RPCBits / 8192.0 / ElapsedTime );
+	}
+}
+
+FString FNetReplicationProfiler::WriteCSV() const
+{
+	const double ElapsedTime = GetElapsedTime();
+
+	// One row per class, property and connection, with totals so intervals can be summed
+	FString CSV = TEXT( "Type,Name,Seconds,NetUpdateFrequency,Replicates,Sends,Bits,ReplicateMs,Compares,CompareMs,RPCs,RPCBits\n" );
+
+	for ( auto It = ClassStats.CreateConstIterator(); It; ++It )
+	{
+		const FClassStats& Stats = It.Value();
+		CSV += FString::Printf( TEXT( "Class,%s,%.3f,%.2f,%u,%u,%llu,%.3f,%u,%.3f,%u,%llu\n" ),
+			*Stats.Name, ElapsedTime, Stats.NetUpdateFrequency, Stats.NumReplicates, Stats.NumSends, Stats.NumBits,
+			CyclesToMilliseconds( Stats.ReplicateCycles ), Stats.NumCompares, CyclesToMilliseconds( Stats.CompareCycles ), Stats.NumRPCs, Stats.RPCBits );
+	}
+
+	for ( auto It = PropertyStats.CreateConstIterator(); It; ++It )
+	{
+		const FPropertyStats& Stats = It.Value();
+		CSV += FString::Printf( TEXT( "Property,%s,%.3f,,,%u,%llu,,,,,\n" ), *Stats.Name, ElapsedTime, Stats.NumSends, Stats.NumBits );
+	}
+
+	for ( auto It = ConnectionStats.CreateConstIterator(); It; ++It )
+	{
+		const FConnectionStats& Stats = It.Value();
+		CSV += FString::Printf( TEXT( "Connection,%s,%.3f,,,%u,%llu,,,,%u,%llu\n" ), *Stats.Name, ElapsedTime, Stats.NumSends, Stats.NumBits, Stats.NumRPCs, Stats.RPCBits );
+	}
+
+	const FString Filename = FPaths::ProfilingDir() / TEXT( "NetRepProfile" ) / FString::Printf( TEXT( "NetRepProfile-%s.csv" ), *FDateTime::Now().ToString() );
+
+	if ( !FFileHelper::SaveStringToFile( CSV, *Filename ) )
+	{
+		UE_LOG( LogNet, Warning, TEXT( "FNetReplicationProfiler: Failed to write %s" ), *Filename );
+		return FString();
+	}
+
+	UE_LOG( LogNet, Log, TEXT( "FNetReplicationProfiler: Wrote %s" ), *Filename );
+
+	return Filename;
+}
+
+bool FNetReplicationProfiler::Exec( UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar )
+{
+	if ( FParse::Command( &Cmd, TEXT( "ENABLE" ) ) )
+	{
+		CVarRepProfiler.AsVariable()->Set( TEXT( "1" ) );
+		Tick();
+	}
+	else if ( FParse::Command( &Cmd, TEXT( "DISABLE" ) ) )
+	{
+		CVarRepProfiler.AsVariable()->Set( TEXT( "0" ) );
+		Tick();
+	}
+	else if ( FParse::Command( &Cmd, TEXT( "RESET" ) ) )
+	{
+		Reset();
+	}
+	else if ( FParse::Command( &Cmd, TEXT( "CSV" ) ) )
+	{
+		const FString Filename = WriteCSV();
+
+		if ( !Filename.IsEmpty() )
+		{
+			Ar.Logf( TEXT( "Wrote %s" ), *Filename );
+		}
+	}
+	else
+	{
+		FParse::Command( &Cmd, TEXT( "DUMP" ) );
+
+		const int32 MaxRows = FCString::Atoi( Cmd );
+
+		if ( !bIsTrackingEnabled && ClassStats.Num() == 0 )
+		{
+			Ar.Logf( TEXT( "Replication profiler is disabled, use NETPROFILEREP ENABLE or net.RepProfiler 1" ) );
+		}
+
+		Dump( Ar, MaxRows > 0 ? MaxRows : NET_REPLICATION_PROFILER_DEFAULT_ROWS );
+	}
+
+	return true;
+}
+
+#endif	// USE_NET_REPLICATION_PROFILER
@@ -8,6 +8,7 @@
 #include "Net/DataReplication.h"
 #include "Net/UnrealNetwork.h"
 #include "Net/NetworkProfiler.h"
+#include "Net/NetReplicationProfiler.h"
 #include "Net/RepLayout.h"
 #include "Engine/ActorChannel.h"
 #include "Engine/VoiceChannel.h"
@@ -16,6 +17,7 @@
 #include "NetworkingDistanceConstants.h"
 #include "DataChannel.h"
 #include "Engine/PackageMapClient.h"
+#include "Net/NetRelevancyGrid.h"
 
 // Default net driver stats
 DEFINE_STAT(STAT_Ping);
@@ -47,6 +49,8 @@ DEFINE_STAT(STAT_ObjPathBytes);
 DEFINE_STAT(STAT_NetGUIDInRate);
 DEFINE_STAT(STAT_NetGUIDOutRate);
 DEFINE_STAT(STAT_NetSaturated);
+DEFINE_STAT(STAT_NetPushModelSkippedCompares);
+DEFINE_STAT(STAT_NetSharedSerializedChangelists);
 
 // Voice specific stats
 DEFINE_STAT(STAT_VoiceBytesSent);
@@ -91,6 +95,13 @@ static TAutoConsoleVariable<int32> CVarNetDormancyValidate(
 	TEXT("0: Dont validate. 1: Validate on wake up. 2: Validate on each net update"),
 	ECVF_Default);
 
+static TAutoConsoleVariable<int32> CVarNetParallelPrioritization(
+	TEXT("net.ParallelPrioritization"),
+	0,
+	TEXT("Scores and sorts each connection's relevant actor list on the task graph during ServerReplicateActors (server only)\n")
+	TEXT("0: Prioritize connections serially on the game thread. 1: Prioritize connections in parallel"),
+	ECVF_Default);
+
 /*-----------------------------------------------------------------------------
 	UNetDriver implementation.
 -----------------------------------------------------------------------------*/
@@ -100,6 +111,8 @@ UNetDriver::UNetDriver(const FObjectInitializer& ObjectInitializer)
 ,	MaxInternetClientRate(10000)
 , 	MaxClientRate(15000)
 ,	RequireEngineVersionMatch(true)
+,	bUseNetRelevancyGrid(false)
+,	NetRelevancyGridCellSize(10000.f)
 ,	ClientConnections()
 ,	Time( 0.f )
 ,	InBytes(0)
@@ -138,6 +151,11 @@ void UNetDriver::PostInitProperties()
 		GuidCache			= TSharedPtr< FNetGUIDCache >( new FNetGUIDCache( this ) );
 		NetCache			= TSharedPtr< FClassNetCacheMgr >( new FClassNetCacheMgr() );
 
+		if ( bUseNetRelevancyGrid )
+		{
+			RelevancyGrid	= MakeShareable( new FNetRelevancyGrid( NetRelevancyGridCellSize ) );
+		}
+
 		ProfileStats		= FParse::Param(FCommandLine::Get(),TEXT("profilestats"));
 	}
 	// By default we're the game net driver and any child ones must override this
@@ -150,6 +168,10 @@ void UNetDriver::AssertValid()
 
 void UNetDriver::TickFlush(float DeltaSeconds)
 {
+#if USE_NET_REPLICATION_PROFILER
+	GNetReplicationProfiler.Tick();
+#endif
+
 	if ( IsServer() && ClientConnections.Num() > 0 && ClientConnections[0]->InternalAck == false )
 	{
 		// Update all clients.
@@ -716,6 +738,7 @@ void UNetDriver::InternalProcessRemoteFunction
 
 		// Bump the ReplicationFrame value to invalidate any properties marked as "unchanged" for this frame.
 		ReplicationFrame++;
+		FNetPushModel::AdvanceEpoch();
 		
 		Ch->ReplicateActor();
 	}
@@ -877,6 +900,7 @@ void UNetDriver::InternalProcessRemoteFunction
 			UE_LOG(LogNetTraffic, Log,		TEXT("      Queing unreliable multicast RPC: %s::%s [%.1f bytes]"), *Actor->GetName(), *Function->GetName(), Bunch.GetNumBits() / 8.f );
 		}
 
+		NET_REPLICATION_PROFILER(GNetReplicationProfiler.TrackSendRPC(Actor, Ch->Connection, Bunch.GetNumBits()));
 		Ch->QueueRemoteFunctionBunch(TargetObj, Function, Bunch);
 	}
 	else
@@ -891,6 +915,7 @@ void UNetDriver::InternalProcessRemoteFunction
 		}
 
 		NETWORK_PROFILER(GNetworkProfiler.TrackSendRPC(Actor,Function,Bunch.GetNumBits()));
+		NET_REPLICATION_PROFILER(GNetReplicationProfiler.TrackSendRPC(Actor, Ch->Connection, Bunch.GetNumBits()));
 		Ch->SendBunch( &Bunch, 1 );
 	}
 }
@@ -1350,6 +1375,8 @@ void UNetDriver::NotifyActorDestroyed( AActor* ThisActor, bool IsSeamlessTravel
 {
 	// Remove the actor from the property tracker map
 	RepChangedPropertyTrackerMap.Remove(ThisActor);
+
+	RemoveNetworkActor(ThisActor);
 #if WITH_SERVER_CODE
 
 	FActorDestructionInfo* DestructionInfo = NULL;
@@ -1442,6 +1469,15 @@ void UNetDriver::NotifyStreamingLevelUnload( ULevel* Level)
  *  The main point is that it calls the normal NotifyActorDestroyed to destroy the channel on the server
  *	but also removes the Actor reference, sets broken flag, and cleans up actor class references on clients.
  */
+void UNetDriver::RemoveNetworkActor( AActor* Actor )
+{
+	// The grid keeps raw actor pointers, so it must not outlive the actor's membership in the network actor list
+	if ( RelevancyGrid.IsValid() )
+	{
+		RelevancyGrid->RemoveActor(Actor);
+	}
+}
+
 void UNetDriver::NotifyActorLevelUnloaded( AActor* TheActor )
 {
 	// server
@@ -1727,6 +1763,126 @@ FActorPriority::FActorPriority(class UNetConnection* InConnection, struct FActor
 	}
 }
 
+/**
+ * Prioritized actor list for a single connection, built on the game thread by ServerReplicateActors and
+ * then scored and sorted, possibly on a worker thread, before the actors are replicated.
+ */
+struct FConnectionReplicationWork
+{
+	/** Connection the actors will be replicated to */
+	UNetConnection*			Connection;
+	/** Viewers (connection + children) used for relevancy and priority */
+	TArray<FNetViewer>		Viewers;
+	/** Storage for the prioritized entries, allocated from the mem stack */
+	FActorPriority*			PriorityList;
+	/** Sortable pointers into PriorityList */
+	FActorPriority**		PriorityActors;
+	/** Capacity of PriorityList: the actors gathered, owned and destroyed for this connection */
+	int32					MaxConsiderCount;
+	/** Number of valid entries in PriorityList */
+	int32					ConsiderCount;
+	/** Number of those entries that are deletion entries */
+	int32					DeletedCount;
+	/** Whether the connection is considered low bandwidth for GetNetPriority */
+	bool					bLowNetBandwidth;
+
+	FConnectionReplicationWork(UNetConnection* InConnection)
+		: Connection(InConnection)
+		, PriorityList(NULL)
+		, PriorityActors(NULL)
+		, MaxConsiderCount(0)
+		, ConsiderCount(0)
+		, DeletedCount(0)
+		, bLowNetBandwidth(false)
+	{
+	}
+
+	/** Adds an actor entry, its priority is computed later by Prioritize */
+	void AddActor(AActor* Actor, UActorChannel* Channel)
+	{
+		check(ConsiderCount < MaxConsiderCount);
+		// the mem stack only reserves the entries, so fully initialize each one
+		FActorPriority& Entry = PriorityList[ConsiderCount];
+		Entry = FActorPriority();
+		Entry.Actor = Actor;
+		Entry.Channel = Channel;
+		PriorityActors[ConsiderCount] = &Entry;
+		ConsiderCount++;
+	}
+
+	/** Adds a deletion entry, its priority is computed later by Prioritize */
+	void AddDestructionInfo(FActorDestructionInfo* DestructionInfo)
+	{
+		check(ConsiderCount < MaxConsiderCount);
+		FActorPriority& Entry = PriorityList[ConsiderCount];
+		Entry = FActorPriority();
+		Entry.DestructionInfo = DestructionInfo;
+		PriorityActors[ConsiderCount] = &Entry;
+		ConsiderCount++;
+		DeletedCount++;
+	}
+
+	/**
+	 * Computes the priority of every entry and sorts the list, highest priority first.
+	 * Only reads actor and channel state, so it is safe to run for several connections at once.
+	 */
+	void Prioritize()
+	{
+		SCOPE_CYCLE_COUNTER(STAT_NetPrioritizeActorsTime);
+
+		for (int32 i = 0; i < ConsiderCount; i++)
+		{
+			FActorPriority& Entry = PriorityList[i];
+			if (Entry.Actor != NULL)
+			{
+				Entry = FActorPriority(Connection, Entry.Channel, Entry.Actor, Viewers, bLowNetBandwidth);
+			}
+			else
+			{
+				Entry = FActorPriority(Connection, Entry.DestructionInfo, Viewers);
+			}
+		}
+
+		// Sort by priority
+		struct FCompareFActorPriority
+		{
+			FORCEINLINE bool operator()( const FActorPriority& A, const FActorPriority& B ) const
+			{
+				return B.Priority < A.Priority;
+			}
+		};
+		Sort( PriorityActors, ConsiderCount, FCompareFActorPriority() );
+	}
+};
+
+/** Task graph task that prioritizes one connection's actor list */
+class FPrioritizeConnectionTask
+{
+	FConnectionReplicationWork* Work;
+
+public:
+	FPrioritizeConnectionTask(FConnectionReplicationWork* InWork)
+		: Work(InWork)
+	{
+	}
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FPrioritizeConnectionTask, STATGROUP_TaskGraphTasks);
+	}
+	static ENamedThreads::Type GetDesiredThread()
+	{
+		return ENamedThreads::AnyThread;
+	}
+	static ESubsequentsMode::Type GetSubsequentsMode() 
+	{ 
+		return ESubsequentsMode::TrackSubsequents; 
+	}
+	void DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+	{
+		Work->Prioritize();
+	}
+};
+
 int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 {
 	SCOPE_CYCLE_COUNTER(STAT_NetServerRepActorsTime);
@@ -1741,6 +1897,7 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 
 	// Bump the ReplicationFrame value to invalidate any properties marked as "unchanged" for this frame.
 	ReplicationFrame++;
+	FNetPushModel::AdvanceEpoch();
 
 	int32 NumClientsToTick = ClientConnections.Num();
 
@@ -1845,6 +2002,9 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 	TArray<AActor*> ConsiderList;
 	ConsiderList.Reserve(NetRelevantActorCount);
 
+	// the relevancy grid can only rule out actors by distance, so it is pointless unless relevancy is distance based
+	FNetRelevancyGrid* Grid = ( RelevancyGrid.IsValid() && GetDefault<AGameNetworkManager>()->bUseDistanceBasedRelevancy ) ? RelevancyGrid.Get() : NULL;
+
 	int32 NumInitiallyDormant = 0;
 
 	// Add WorldSettings to consider list if we have one
@@ -1856,6 +2016,11 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 			// For performance reasons, make sure we don't resize the array. It should already be appropriately sized above!
 			ensure(ConsiderList.Num() < ConsiderList.Max());
 			ConsiderList.Add(WorldSettings);
+
+			if ( Grid )
+			{
+				Grid->MarkConsidered(WorldSettings, ReplicationFrame);
+			}
 		}
 	}
 
@@ -1884,12 +2049,20 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 			if (Actor->IsPendingKill() )
 			{
 				World->NetworkActors.RemoveAtSwap( i );
+				if ( RelevancyGrid.IsValid() )
+				{
+					RelevancyGrid->RemoveActor( Actor );
+				}
 				continue;
 			}
 
 			if (Actor->GetRemoteRole()==ROLE_None)
 			{
 				World->NetworkActors.RemoveAtSwap( i );
+				if ( RelevancyGrid.IsValid() )
+				{
+					RelevancyGrid->RemoveActor( Actor );
+				}
 				continue;
 			}
 
@@ -1914,6 +2087,10 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 				SCOPE_CYCLE_COUNTER(STAT_NetInitialDormantCheckTime);		
 				NumInitiallyDormant++;
 				World->NetworkActors.RemoveAtSwap( i );
+				if ( RelevancyGrid.IsValid() )
+				{
+					RelevancyGrid->RemoveActor( Actor );
+				}
 				//UE_LOG(LogNetTraffic, Log, TEXT("Skipping Actor %s - its initially dormant!"), *Actor->GetName() );
 				continue;
 			}
@@ -1952,6 +2129,11 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 					ensure(ConsiderList.Num() < ConsiderList.Max());
 					ConsiderList.Add(Actor);
 
+					if ( Grid )
+					{
+						Grid->MarkConsidered(Actor, ReplicationFrame);
+					}
+
 					bWasConsidered = true;
 				}
 				else
@@ -2027,66 +2209,70 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 	SET_DWORD_STAT(STAT_NumInitiallyDormantActors,NumInitiallyDormant);
 	SET_DWORD_STAT(STAT_NumConsideredActors,ConsiderList.Num());
 
-	for( int32 i=0; i < ClientConnections.Num(); i++ )
+	// Connections are gathered, prioritized and replicated in batches, and each batch releases its prioritized lists from the mem stack
+	// before the next one starts. A batch has one connection per thread when prioritizing in parallel, a single connection otherwise.
+	const bool bParallelPrioritization = CVarNetParallelPrioritization.GetValueOnGameThread() > 0 && FApp::ShouldUseThreadingForPerformance();
+	const int32 ConnectionsPerBatch = bParallelPrioritization ? FTaskGraphInterface::Get().GetNumWorkerThreads() + 1 : 1;
+
+	TArray<FConnectionReplicationWork> ConnectionWork;
+	ConnectionWork.Reserve(ConnectionsPerBatch);
+
+	TArray<FNetViewer>& ConnectionViewers = WorldSettings->ReplicationViewers;
+	TArray<AActor*> GridCandidates;
+
+	for( int32 BatchStart = 0; BatchStart < ClientConnections.Num(); BatchStart += ConnectionsPerBatch )
 	{
-		UNetConnection* Connection = ClientConnections[i];
-		check(Connection);
-		int32 ActorUpdatesThisConnection = 0;
-		int32 ActorUpdatesThisConnectionSent = 0;
+		FMemMark RelevantActorMark(FMemStack::Get());
+		const int32 BatchEnd = FMath::Min(BatchStart + ConnectionsPerBatch, ClientConnections.Num());
+		ConnectionWork.Reset();
 
-		// if this client shouldn't be ticked this frame
-		if (i >= NumClientsToTick)
+		// Gather the prioritized actor list for every connection of the batch that is ticked this frame. This touches shared actor and
+		// channel state (NetTag, dormancy, relevancy) so it always runs serially on the game thread.
+		for( int32 i=BatchStart; i < BatchEnd; i++ )
 		{
-			//UE_LOG(LogNet, Log, TEXT("skipping update to %s"),*Connection->GetName());
-			// then mark each considered actor as bPendingNetUpdate so that they will be considered again the next frame when the connection is actually ticked
-			for (int32 ConsiderIdx = 0; ConsiderIdx < ConsiderList.Num(); ConsiderIdx++)
+			UNetConnection* Connection = ClientConnections[i];
+			check(Connection);
+
+			// if this client shouldn't be ticked this frame
+			if (i >= NumClientsToTick)
 			{
-				AActor *Actor = ConsiderList[ConsiderIdx];
-				// if the actor hasn't already been flagged by another connection,
-				if (Actor != NULL && !Actor->bPendingNetUpdate)
+				//UE_LOG(LogNet, Log, TEXT("skipping update to %s"),*Connection->GetName());
+				// then mark each considered actor as bPendingNetUpdate so that they will be considered again the next frame when the connection is actually ticked
+				for (int32 ConsiderIdx = 0; ConsiderIdx < ConsiderList.Num(); ConsiderIdx++)
 				{
-					// find the channel
-					UActorChannel *Channel = Connection->ActorChannels.FindRef(Actor);
-					// and if the channel last update time doesn't match the last net update time for the actor
-					if (Channel != NULL && Channel->LastUpdateTime < Actor->LastNetUpdateTime)
+					AActor *Actor = ConsiderList[ConsiderIdx];
+					// if the actor hasn't already been flagged by another connection,
+					if (Actor != NULL && !Actor->bPendingNetUpdate)
 					{
-						//UE_LOG(LogNet, Log, TEXT("flagging %s for a future update"),*Actor->GetName());
-						// flag it for a pending update
-						Actor->bPendingNetUpdate = true;
+						// find the channel
+						UActorChannel *Channel = Connection->ActorChannels.FindRef(Actor);
+						// and if the channel last update time doesn't match the last net update time for the actor
+						if (Channel != NULL && Channel->LastUpdateTime < Actor->LastNetUpdateTime)
+						{
+							//UE_LOG(LogNet, Log, TEXT("flagging %s for a future update"),*Actor->GetName());
+							// flag it for a pending update
+							Actor->bPendingNetUpdate = true;
+						}
 					}
 				}
-			}
-			// clear the time sensitive flag to avoid sending an extra packet to this connection
-			Connection->TimeSensitive = false;
+				// clear the time sensitive flag to avoid sending an extra packet to this connection
+				Connection->TimeSensitive = false;
 
-			Connection->OwnedConsiderList.Empty();
-			for (int32 ChildIdx = 0; ChildIdx < Connection->Children.Num(); ChildIdx++)
-			{
-				if (Connection->Children[ChildIdx])
+				Connection->OwnedConsiderList.Empty();
+				for (int32 ChildIdx = 0; ChildIdx < Connection->Children.Num(); ChildIdx++)
 				{
-					Connection->Children[ChildIdx]->OwnedConsiderList.Empty();
+					if (Connection->Children[ChildIdx])
+					{
+						Connection->Children[ChildIdx]->OwnedConsiderList.Empty();
+					}
 				}
 			}
-		}
-		else if (Connection->Viewer)
-		{
-			int32 j;
-			int32 ConsiderCount	= 0;
-			int32 DeletedCount = 0;
-			
-			int32 NetRelevantCount = 0;
-			FActorPriority* PriorityList = NULL;
-			FActorPriority** PriorityActors = NULL;
-
-			TArray<FNetViewer>& ConnectionViewers = WorldSettings->ReplicationViewers;
-
-			float PruneActors = 0.f;
-			CLOCK_CYCLES(PruneActors);
-			FMemMark RelevantActorMark(FMemStack::Get());
-
-			// Prioritize actors for this connection
+			else if (Connection->Viewer)
 			{
-				SCOPE_CYCLE_COUNTER(STAT_NetPrioritizeActorsTime);
+				SCOPE_CYCLE_COUNTER(STAT_NetGatherPrioritizedActorsTime);
+
+				int32 j;
+				FConnectionReplicationWork& Work = *new(ConnectionWork) FConnectionReplicationWork(Connection);
 
 				// send ClientAdjustment if necessary
 				// we do this here so that we send a maximum of one per packet to that client; there is no value in stacking additional corrections
@@ -2094,7 +2280,7 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 				{
 					Connection->PlayerController->SendClientAdjustment();
 				}
-				
+			
 				for (int32 ChildIdx = 0; ChildIdx < Connection->Children.Num(); ChildIdx++)
 				{
 					if (Connection->Children[ChildIdx]->PlayerController != NULL)
@@ -2104,7 +2290,7 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 				}
 
 				// Get list of visible/relevant actors.
-				
+			
 				NetTag++;
 				Connection->TickCount++;
 
@@ -2127,20 +2313,34 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 
 				// Make list of all actors to consider.
 				check(World == Connection->OwningActor->GetWorld());
-				
-				NetRelevantCount = World->GetNetRelevantActorCount() + DestroyedStartupOrDormantActors.Num();
-				PriorityList = new(FMemStack::Get(),NetRelevantCount+2)FActorPriority;
-				PriorityActors = new(FMemStack::Get(),NetRelevantCount+2)FActorPriority*;
-
+			
 				// determine whether we should priority sort the list of relevant actors based on the saturation/bandwidth of the current connection
 				//@note - if the server is currently CPU saturated then do not sort until framerate improves
 				check(World == Connection->Viewer->GetWorld());
 				AGameMode const* const GameMode = World->GetAuthGameMode();
-				bool bLowNetBandwidth = !bCPUSaturated && (Connection->CurrentNetSpeed / float(GameMode->NumPlayers + GameMode->NumBots) < 500.f );
+				Work.bLowNetBandwidth = !bCPUSaturated && (Connection->CurrentNetSpeed / float(GameMode->NumPlayers + GameMode->NumBots) < 500.f );
 
-				for( j=0; j<ConsiderList.Num(); j++ )
+				// with the relevancy grid only nearby, non spatial and already open actors are visited, otherwise every considered actor is
+				const TArray<AActor*>* ActorsToGather = &ConsiderList;
+				if ( Grid )
+				{
+					GridCandidates.Reset();
+					Grid->GatherCandidates(Connection, ConnectionViewers, ReplicationFrame, GridCandidates);
+					ActorsToGather = &GridCandidates;
+				}
+
+				// size the list by what this connection can add to it rather than by every net relevant actor in the world
+				Work.MaxConsiderCount = ActorsToGather->Num() + Connection->DestroyedStartupOrDormantActors.Num() + Connection->OwnedConsiderList.Num();
+				for (j = 0; j < Connection->Children.Num(); j++)
 				{
-					AActor* Actor = ConsiderList[j];
+					Work.MaxConsiderCount += Connection->Children[j]->OwnedConsiderList.Num();
+				}
+				Work.PriorityList = new(FMemStack::Get(),Work.MaxConsiderCount)FActorPriority;
+				Work.PriorityActors = new(FMemStack::Get(),Work.MaxConsiderCount)FActorPriority*;
+
+				for( j=0; j<ActorsToGather->Num(); j++ )
+				{
+					AActor* Actor = (*ActorsToGather)[j];
 					UActorChannel* Channel = Connection->ActorChannels.FindRef(Actor);
 
 					// Skip Actor if dormant
@@ -2173,7 +2373,7 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 								float Time  = Channel ? (Connection->Driver->Time - Channel->LastUpdateTime) : Connection->Driver->SpawnPrioritySeconds;
 								for (int32 viewerIdx = 0; viewerIdx < ConnectionViewers.Num(); viewerIdx++)
 								{
-									if (!Actor->GetNetDormancy(ConnectionViewers[viewerIdx].ViewLocation, ConnectionViewers[viewerIdx].ViewDir, ConnectionViewers[viewerIdx].InViewer, Channel, Time, bLowNetBandwidth))
+									if (!Actor->GetNetDormancy(ConnectionViewers[viewerIdx].ViewLocation, ConnectionViewers[viewerIdx].ViewDir, ConnectionViewers[viewerIdx].InViewer, Channel, Time, Work.bLowNetBandwidth))
 									{
 										ShouldGoDormant = false;
 										break;
@@ -2219,10 +2419,8 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 					if( Actor->NetTag!=NetTag ) // Do not consider actor for this connection if this connection has it marked dormant
 					{
 						UE_LOG(LogNetTraffic, Log, TEXT("Consider %s alwaysrelevant %d frequency %f "),*Actor->GetName(), Actor->bAlwaysRelevant, Actor->NetUpdateFrequency);
-						Actor->NetTag                 = NetTag;
-						PriorityList  [ConsiderCount] = FActorPriority(Connection, Channel, Actor, ConnectionViewers, bLowNetBandwidth);
-						PriorityActors[ConsiderCount] = PriorityList + ConsiderCount;
-						ConsiderCount++;
+						Actor->NetTag = NetTag;
+						Work.AddActor(Actor, Channel);
 
 						if (DebugRelevantActors)
 						{
@@ -2235,10 +2433,7 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 				for (auto It = Connection->DestroyedStartupOrDormantActors.CreateIterator(); It; ++It)
 				{
 					FActorDestructionInfo &DInfo = DestroyedStartupOrDormantActors.FindChecked(*It);
-					PriorityList  [ConsiderCount] = FActorPriority(Connection, &DInfo, ConnectionViewers);
-					PriorityActors[ConsiderCount] = PriorityList + ConsiderCount;
-					ConsiderCount++;
-					DeletedCount++;
+					Work.AddDestructionInfo(&DInfo);
 				}
 
 				UNetConnection* NextConnection = Connection;
@@ -2252,10 +2447,8 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 						if (Actor->NetTag != NetTag)
 						{
 							UActorChannel* Channel = Connection->ActorChannels.FindRef(Actor);
-							Actor->NetTag                 = NetTag;
-							PriorityList  [ConsiderCount] = FActorPriority(NextConnection, Channel, Actor, ConnectionViewers, bLowNetBandwidth);
-							PriorityActors[ConsiderCount] = PriorityList + ConsiderCount;
-							ConsiderCount++;
+							Actor->NetTag = NetTag;
+							Work.AddActor(Actor, Channel);
 
 							if (DebugRelevantActors)
 							{
@@ -2268,20 +2461,54 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 					NextConnection = (ChildIndex < Connection->Children.Num()) ? Connection->Children[ChildIndex++] : NULL;
 				}
 
-				SET_DWORD_STAT(STAT_PrioritizedActors,ConsiderCount);
-				SET_DWORD_STAT(STAT_NumRelevantDeletedActors,DeletedCount);
+				// keep a copy of the viewers, ReplicationViewers is reused by the next connection
+				Work.Viewers = ConnectionViewers;
+
+				SET_DWORD_STAT(STAT_PrioritizedActors,Work.ConsiderCount);
+				SET_DWORD_STAT(STAT_NumRelevantDeletedActors,Work.DeletedCount);
+			}
+		}
+
+		// Score and sort each connection's list. This only reads actor state and writes to the connection's own list,
+		// so it can be spread across the task graph when net.ParallelPrioritization is enabled.
+		{
+			SCOPE_CYCLE_COUNTER(STAT_NetPrioritizeActorsWaitTime);
 
-				// Sort by priority
-				struct FCompareFActorPriority
+			if (bParallelPrioritization && ConnectionWork.Num() > 1)
+			{
+				FGraphEventArray PrioritizeTasks;
+				PrioritizeTasks.Reserve(ConnectionWork.Num());
+				for (int32 WorkIdx = 0; WorkIdx < ConnectionWork.Num(); WorkIdx++)
 				{
-					FORCEINLINE bool operator()( const FActorPriority& A, const FActorPriority& B ) const
-					{
-						return B.Priority < A.Priority;
-					}
-				};
-				Sort( PriorityActors, ConsiderCount, FCompareFActorPriority() );
+					PrioritizeTasks.Add(TGraphTask<FPrioritizeConnectionTask>::CreateTask().ConstructAndDispatchWhenReady(&ConnectionWork[WorkIdx]));
+				}
+				FTaskGraphInterface::Get().WaitUntilTasksComplete(PrioritizeTasks, ENamedThreads::GameThread);
+			}
+			else
+			{
+				for (int32 WorkIdx = 0; WorkIdx < ConnectionWork.Num(); WorkIdx++)
+				{
+					ConnectionWork[WorkIdx].Prioritize();
+				}
+			}
+		}
+
+		// Replicate the prioritized actors. Connections are processed in their original order so the bunches
+		// written (and the actor state changes they cause) are identical to the serial path.
+		for (int32 WorkIdx = 0; WorkIdx < ConnectionWork.Num(); WorkIdx++)
+		{
+			SCOPE_CYCLE_COUNTER(STAT_NetProcessPrioritizedActorsTime);
+
+			FConnectionReplicationWork& Work = ConnectionWork[WorkIdx];
+			UNetConnection* Connection = Work.Connection;
+			FActorPriority** PriorityActors = Work.PriorityActors;
+			const int32 ConsiderCount = Work.ConsiderCount;
+			int32 ActorUpdatesThisConnection = 0;
+			int32 ActorUpdatesThisConnectionSent = 0;
+			int32 j;
 
-			} // END PRIORITIZE
+			// restore the viewers for this connection so that actors can query them while replicating
+			ConnectionViewers = Work.Viewers;
 
 			// Update all relevant actors in sorted order.
 			bool bNewSaturated = !Connection->IsNetReady(0);
@@ -2317,13 +2544,13 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 						continue;
 					}
 
-#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 					static IConsoleVariable* DebugObjectCvar = IConsoleManager::Get().FindConsoleVariable(TEXT("net.PackageMap.DebugObject"));
 					if (DebugObjectCvar && !DebugObjectCvar->GetString().IsEmpty() && PriorityActors[j]->Actor && PriorityActors[j]->Actor->GetName().Contains(DebugObjectCvar->GetString()) )
 					{
 						UE_LOG(LogNetPackageMap, Log, TEXT("Evaluating actor for replication %s"), *PriorityActors[j]->Actor->GetName());
 					}
-#endif
+	#endif
 
 					// Normal actor replication
 					UActorChannel* Channel     = PriorityActors[j]->Channel;
@@ -2365,7 +2592,7 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 							// exception: player controllers should never show up here
 							UE_LOG(LogNetTraffic, Log, TEXT("- Level not initialized for actor %s"), *Actor->GetName());
 						}
-						
+					
 						// if the actor is now relevant or was recently relevant
 						if( bIsRelevant || (Channel && Time - Channel->RelevantTime < RelevantTimeout) )
 						{	
@@ -2467,7 +2694,7 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 				}
 
 				UActorChannel* Channel = PriorityActors[k]->Channel;
-				
+			
 				UE_LOG(LogNetTraffic, Verbose, TEXT("Saturated. %s"), *Actor->GetName());
 				if (Channel != NULL && Time - Channel->RelevantTime <= 1.f)
 				{
@@ -2491,9 +2718,8 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 					}
 				}
 			}
-			RelevantActorMark.Pop();
-			UE_LOG(LogNetTraffic, Log, TEXT("Potential %04i ConsiderList %03i ConsiderCount %03i Prune=%01.4f "),NetRelevantCount, 
-						ConsiderList.Num(), ConsiderCount, FPlatformTime::ToMilliseconds(PruneActors) );
+			UE_LOG(LogNetTraffic, Log, TEXT("Potential %04i ConsiderList %03i ConsiderCount %03i "),Work.MaxConsiderCount, 
+						ConsiderList.Num(), ConsiderCount );
 
 			SET_DWORD_STAT(STAT_NumReplicatedActorAttempts,ActorUpdatesThisConnection);
 			SET_DWORD_STAT(STAT_NumReplicatedActors,ActorUpdatesThisConnectionSent);
@@ -2708,6 +2934,11 @@ void UNetDriver::ResetGameWorldState()
 {
 	DestroyedStartupOrDormantActors.Empty();
 
+	if ( RelevancyGrid.IsValid() )
+	{
+		RelevancyGrid->Empty();
+	}
+
 	if ( NetCache.IsValid() )
 	{
 		NetCache->ClearClassNetCache();	// Clear the cache net: it will recreate itself after seamless travel
@@ -8,6 +8,7 @@
 #include "Engine/ActorChannel.h"
 #include "RepLayout.h"
 #include "Engine/PackageMapClient.h"
+#include "Net/NetPathTable.h"
 
 // ( OutPacketId == GUID_PACKET_NOT_ACKED ) == NAK'd		(this GUID is not acked, and is not pending either, so sort of waiting)
 // ( OutPacketId == GUID_PACKET_ACKED )		== FULLY ACK'd	(this GUID is fully acked, and we no longer need to send full path)
@@ -25,6 +26,22 @@ static const int INTERNAL_LOAD_OBJECT_RECURSION_LIMIT = 16;
 static TAutoConsoleVariable<int32> CVarAllowAsyncLoading( TEXT( "net.AllowAsyncLoading" ), 0, TEXT( "Allow async loading" ) );
 static TAutoConsoleVariable<int32> CVarSimulateAsyncLoading( TEXT( "net.SimulateAsyncLoading" ), 0, TEXT( "Simulate async loading" ) );
 static TAutoConsoleVariable<int32> CVarIgnorePackageMismatch( TEXT( "net.IgnorePackageMismatch" ), 0, TEXT( "Ignore when package versions are different" ) );
+static TAutoConsoleVariable<int32> CVarCompressNetGUIDExports( TEXT( "net.CompressNetGUIDExports" ), 1, TEXT( "Compress NetGUID export bunches, so more exports fit in each packet" ) );
+
+/** Size of the export bunch header: NetGUID count, GuidSequence and the compressed flag. Exports start on the next byte */
+static const int32 NETGUID_EXPORT_HEADER_BYTES = sizeof( int32 ) + sizeof( int32 ) + sizeof( uint8 );
+
+/** Upper bound on the header of a compressed export bunch, which adds the packed uncompressed and compressed sizes */
+static const int64 NETGUID_EXPORT_COMPRESSED_HEADER_BITS = ( NETGUID_EXPORT_HEADER_BYTES + 5 + 5 ) * 8;
+
+/** How many packets worth of exports are written to an export bunch before it is compressed */
+static const int64 NETGUID_EXPORT_MAX_COMPRESSION_RATIO = 4;
+
+/** Room left in each compressed export bunch, in case exports added after the last check compress worse than expected */
+static const int64 NETGUID_EXPORT_COMPRESSION_SLACK_BITS = 64 * 8;
+
+/** Largest uncompressed export bunch a client accepts */
+static const uint32 MAX_NETGUID_EXPORT_UNCOMPRESSED_BYTES = 64 * 1024;
 
 /*-----------------------------------------------------------------------------
 	UPackageMapClient implementation.
@@ -307,8 +324,10 @@ struct FExportFlags
 	{
 		struct
 		{
-			uint8 bHasPath		: 1;
-			uint8 bNoLoad		: 1;
+			uint8 bHasPath			: 1;
+			uint8 bNoLoad			: 1;
+			uint8 bHasPathIndex		: 1;	// Package path is sent as its index in FNetPathTable
+			uint8 bNameFromOuter	: 1;	// Object name is derived from the short name of its outer package, see ENameFromOuter
 		};
 
 		uint8	Value;
@@ -320,6 +339,32 @@ struct FExportFlags
 	}
 };
 
+/** How the name of an object is derived from the short name of its outer package, for objects that follow the asset naming conventions */
+namespace ENameFromOuter
+{
+	enum Type
+	{
+		ShortName,			// Main object of the asset, e.g. /Game/Foo.Foo
+		GeneratedClass,		// Class generated by a blueprint, e.g. /Game/Foo.Foo_C
+		ClassDefault,		// CDO of that class, e.g. /Game/Foo.Default__Foo_C
+		Max,
+	};
+}
+
+static FString GetNameFromOuter( const FString& OuterPathName, const uint8 Kind )
+{
+	const FString ShortName = FPackageName::GetShortName( OuterPathName );
+
+	switch ( Kind )
+	{
+		case ENameFromOuter::ShortName:			return ShortName;
+		case ENameFromOuter::GeneratedClass:	return ShortName + TEXT( "_C" );
+		case ENameFromOuter::ClassDefault:		return FString( DEFAULT_OBJECT_PREFIX ) + ShortName + TEXT( "_C" );
+	}
+
+	return FString();
+}
+
 static bool CanClientLoadObject( const UObject* Object, const FNetworkGUID& NetGUID )
 {
 	if ( !NetGUID.IsValid() || NetGUID.IsDynamic() )
@@ -387,10 +432,12 @@ void UPackageMapClient::InternalWriteObject( FArchive & Ar, FNetworkGUID NetGUID
 		}
 
 		ExportFlags.bNoLoad	= bNoLoad ? 1 : 0;
-
-		Ar << ExportFlags.Value;
 	}
 
+	bool	bIsPackage		= false;
+	int32	PathIndex		= INDEX_NONE;
+	uint8	NameFromOuter	= ENameFromOuter::Max;
+
 	if ( ExportFlags.bHasPath )
 	{
 		if ( Object != NULL )
@@ -408,19 +455,71 @@ void UPackageMapClient::InternalWriteObject( FArchive & Ar, FNetworkGUID NetGUID
 			check( !ObjectPathName.IsEmpty() );
 		}
 
-		const bool bIsPackage = ( NetGUID.IsStatic() && Object != NULL && Object->GetOuter() == NULL );
+		bIsPackage = ( NetGUID.IsStatic() && Object != NULL && Object->GetOuter() == NULL );
 
 		check( bIsPackage == ( Cast< UPackage >( Object ) != NULL ) );		// Make sure it really is a package
 
+		const FString UnmappedPathName = ObjectPathName;
+
+		GEngine->NetworkRemapPath(Connection->Driver->GetWorld(), ObjectPathName, false);
+
+		// Only exports are sent compactly, and only when the name doesn't need to be remapped
+		if ( GuidCache->IsExportingNetGUIDBunch && !NetGUID.IsDefault() && ObjectPathName == UnmappedPathName )
+		{
+			if ( bIsPackage )
+			{
+				if ( bUsePathTable )
+				{
+					PathIndex = FNetPathTable::Get().FindPackageIndex( FName( *ObjectPathName, FNAME_Find ) );
+					ExportFlags.bHasPathIndex = PathIndex != INDEX_NONE ? 1 : 0;
+				}
+			}
+			else
+			{
+				const UPackage* OuterPackage = Cast< UPackage >( ObjectOuter );
+
+				if ( OuterPackage != NULL && !OuterPackage->ContainsMap() )
+				{
+					for ( uint8 Kind = 0; Kind < ENameFromOuter::Max; Kind++ )
+					{
+						if ( GetNameFromOuter( OuterPackage->GetName(), Kind ) == ObjectPathName )
+						{
+							NameFromOuter = Kind;
+							ExportFlags.bNameFromOuter = 1;
+							break;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if ( !NetGUID.IsDefault() && GuidCache->IsExportingNetGUIDBunch )
+	{
+		Ar << ExportFlags.Value;
+	}
+
+	if ( ExportFlags.bHasPath )
+	{
 		// Serialize reference to outer. This is basically a form of compression.
 		FNetworkGUID OuterNetGUID = GuidCache->GetOrAssignNetGUID( ObjectOuter );
 
 		InternalWriteObject( Ar, OuterNetGUID, ObjectOuter, TEXT( "" ), NULL );
 
-		GEngine->NetworkRemapPath(Connection->Driver->GetWorld(), ObjectPathName, false);
-
 		// Serialize Name of object
-		Ar << ObjectPathName;
+		if ( ExportFlags.bHasPathIndex )
+		{
+			uint32 PackedIndex = PathIndex;
+			Ar.SerializeIntPacked( PackedIndex );
+		}
+		else if ( ExportFlags.bNameFromOuter )
+		{
+			Ar << NameFromOuter;
+		}
+		else
+		{
+			Ar << ObjectPathName;
+		}
 
 		if ( bIsPackage )
 		{
@@ -569,7 +668,44 @@ FNetworkGUID UPackageMapClient::InternalLoadObject( FArchive & Ar, UObject *& Ob
 		FString PathName;
 		FGuid	PackageGuid;
 
-		Ar << PathName;
+		if ( ExportFlags.bHasPathIndex )
+		{
+			uint32 PathIndex = 0;
+			Ar.SerializeIntPacked( PathIndex );
+
+			const FName PackageName = FNetPathTable::Get().GetPackageName( PathIndex );
+
+			if ( PackageName == NAME_None || OuterGUID.IsValid() )
+			{
+				UE_LOG( LogNetPackageMap, Error, TEXT( "InternalLoadObject: Invalid path table index %u. NetGUID: %s" ), PathIndex, *NetGUID.ToString() );
+				Ar.SetError();
+			}
+			else
+			{
+				PathName = PackageName.ToString();
+			}
+		}
+		else if ( ExportFlags.bNameFromOuter )
+		{
+			uint8 NameFromOuter = ENameFromOuter::Max;
+			Ar << NameFromOuter;
+
+			// The outer was exported before this object, so it's either loaded or we know its path
+			const FNetGuidCacheObject* OuterCacheObject = GuidCache->ObjectLookup.Find( OuterGUID );
+			const FString OuterPathName = ObjOuter != NULL ? ObjOuter->GetName() : ( OuterCacheObject != NULL ? OuterCacheObject->PathName.ToString() : FString() );
+
+			PathName = GetNameFromOuter( OuterPathName, NameFromOuter );
+
+			if ( OuterPathName.IsEmpty() || PathName.IsEmpty() )
+			{
+				UE_LOG( LogNetPackageMap, Error, TEXT( "InternalLoadObject: Unable to derive name from outer. OuterGUID: %s, NetGUID: %s" ), *OuterGUID.ToString(), *NetGUID.ToString() );
+				Ar.SetError();
+			}
+		}
+		else
+		{
+			Ar << PathName;
+		}
 
 		const bool bIsPackage = NetGUID.IsStatic() && !OuterGUID.IsValid();
 
@@ -720,7 +856,11 @@ bool UPackageMapClient::ExportNetGUID( FNetworkGUID NetGUID, const UObject* Obje
 		{
 			check( ExportNetGUIDCount == 0 );
 
-			CurrentExportBunch = new FOutBunch(this, Connection->MaxPacket*8-MAX_BUNCH_HEADER_BITS-MAX_PACKET_TRAILER_BITS-MAX_PACKET_HEADER_BITS );
+			// When compressing, write more exports than fit in a packet, ExportNetGUIDHeader compresses them back under the limit
+			const int64 MaxExportBunchBits = GetMaxExportBunchBits();
+			const bool bCompress = CVarCompressNetGUIDExports.GetValueOnGameThread() > 0;
+
+			CurrentExportBunch = new FOutBunch(this, bCompress ? MaxExportBunchBits * NETGUID_EXPORT_MAX_COMPRESSION_RATIO : MaxExportBunchBits );
 			CurrentExportBunch->SetAllowResize(false);
 			CurrentExportBunch->bHasGUIDs = true;
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
@@ -730,7 +870,14 @@ bool UPackageMapClient::ExportNetGUID( FNetworkGUID NetGUID, const UObject* Obje
 			ExportNetGUIDCount = 0;
 			*CurrentExportBunch << ExportNetGUIDCount;
 			*CurrentExportBunch << GuidCache->GuidSequence;
+
+			uint8 bCompressed = 0;
+			*CurrentExportBunch << bCompressed;
+
 			NET_CHECKSUM( *CurrentExportBunch );
+
+			// Anything that fits in a packet can always be sent uncompressed
+			ExportBunchCheckBits = MaxExportBunchBits;
 		}
 
 		if ( CurrentExportNetGUIDs.Num() != 0 )
@@ -758,7 +905,7 @@ bool UPackageMapClient::ExportNetGUID( FNetworkGUID NetGUID, const UObject* Obje
 			return false;
 		}
 	
-		if ( !CurrentExportBunch->IsError() )
+		if ( !CurrentExportBunch->IsError() && ExportBunchFitsInPacket() )
 		{
 			// Success, append these exported guid's to the list going out on this bunch
 			CurrentExportBunch->ExportNetGUIDs.Append( CurrentExportNetGUIDs.Array() );
@@ -811,6 +958,45 @@ void UPackageMapClient::ExportNetGUIDHeader()
 	Out << GuidCache->GuidSequence;
 	Restore.PopWithoutClear(Out);
 
+	const int64 MaxExportBunchBits = GetMaxExportBunchBits();
+
+	if ( CVarCompressNetGUIDExports.GetValueOnGameThread() > 0 || Out.GetNumBits() > MaxExportBunchBits )
+	{
+		const int64 CompressedBits = CompressCurrentExportBunch();
+
+		if ( CompressedBits >= 0 && CompressedBits <= MaxExportBunchBits && CompressedBits < Out.GetNumBits() )
+		{
+			FOutBunch* CompressedBunch = new FOutBunch( this, MaxExportBunchBits );
+			CompressedBunch->SetAllowResize( false );
+			CompressedBunch->bHasGUIDs = true;
+			CompressedBunch->ExportNetGUIDs = Out.ExportNetGUIDs;
+			CompressedBunch->SetDebugString( Out.GetDebugString() );
+
+			uint8	bCompressed			= 1;
+			uint32	UncompressedBits	= Out.GetNumBits() - NETGUID_EXPORT_HEADER_BYTES * 8;
+			uint32	CompressedSize		= ExportCompressionBuffer.Num();
+
+			*CompressedBunch << ExportNetGUIDCount;
+			*CompressedBunch << GuidCache->GuidSequence;
+			*CompressedBunch << bCompressed;
+			CompressedBunch->SerializeIntPacked( UncompressedBits );
+			CompressedBunch->SerializeIntPacked( CompressedSize );
+			CompressedBunch->Serialize( ExportCompressionBuffer.GetData(), CompressedSize );
+
+			check( !CompressedBunch->IsError() );
+
+			UE_LOG( LogNetPackageMap, Log, TEXT( "	UPackageMapClient::ExportNetGUIDHeader. Compressed %d bytes to %d bytes" ), (int32)Out.GetNumBytes(), (int32)CompressedBunch->GetNumBytes() );
+
+			delete CurrentExportBunch;
+			CurrentExportBunch = CompressedBunch;
+		}
+		else if ( Out.GetNumBits() > MaxExportBunchBits )
+		{
+			// ExportBunchFitsInPacket leaves enough slack that this shouldn't happen
+			UE_LOG( LogNetPackageMap, Error, TEXT( "UPackageMapClient::ExportNetGUIDHeader: Exports don't fit in a packet once compressed. Bits: %lld, Compressed: %lld, Max: %lld" ), Out.GetNumBits(), CompressedBits, MaxExportBunchBits );
+		}
+	}
+
 	// If we've written new NetGUIDs to the 'bunch' set (current+1)
 	if (UE_LOG_ACTIVE(LogNetPackageMap,Verbose))
 	{
@@ -847,6 +1033,9 @@ void UPackageMapClient::ReceiveNetGUIDBunch( FInBunch &InBunch )
 
 	InBunch << NewGuidSequence;
 
+	uint8 bCompressed = 0;
+	InBunch << bCompressed;
+
 	if ( NewGuidSequence < GuidCache->GuidSequence )
 	{
 		// Older sequence, ignore
@@ -872,27 +1061,76 @@ void UPackageMapClient::ReceiveNetGUIDBunch( FInBunch &InBunch )
 		return;
 	}
 
-	NET_CHECKSUM(InBunch);
+	UE_LOG(LogNetPackageMap, Log, TEXT("UPackageMapClient::ReceiveNetGUIDBunch %d NetGUIDs. PacketId %d. ChSequence %d. ChIndex %d. Compressed %d"), NumGUIDsInBunch, InBunch.PacketId, InBunch.ChSequence, InBunch.ChIndex, bCompressed );
+
+	if ( bCompressed )
+	{
+		uint32 UncompressedBits = 0;
+		uint32 CompressedSize = 0;
+
+		InBunch.SerializeIntPacked( UncompressedBits );
+		InBunch.SerializeIntPacked( CompressedSize );
+
+		const uint32 UncompressedSize = ( UncompressedBits + 7 ) >> 3;
+
+		if ( InBunch.IsError() || UncompressedSize > MAX_NETGUID_EXPORT_UNCOMPRESSED_BYTES || CompressedSize > InBunch.GetBytesLeft() )
+		{
+			UE_LOG( LogNetPackageMap, Error, TEXT( "UPackageMapClient::ReceiveNetGUIDBunch: Invalid compressed exports. UncompressedBits: %u, CompressedSize: %u" ), UncompressedBits, CompressedSize );
+			InBunch.SetError();
+			GuidCache->IsExportingNetGUIDBunch = false;
+			return;
+		}
+
+		TArray< uint8 > CompressedData;
+		CompressedData.AddUninitialized( CompressedSize );
+		InBunch.Serialize( CompressedData.GetData(), CompressedSize );
+
+		TArray< uint8 > UncompressedData;
+		UncompressedData.AddUninitialized( UncompressedSize );
+
+		if ( !FCompression::UncompressMemory( COMPRESS_ZLIB, UncompressedData.GetData(), UncompressedSize, CompressedData.GetData(), CompressedSize ) )
+		{
+			UE_LOG( LogNetPackageMap, Error, TEXT( "UPackageMapClient::ReceiveNetGUIDBunch: Failed to uncompress exports" ) );
+			InBunch.SetError();
+			GuidCache->IsExportingNetGUIDBunch = false;
+			return;
+		}
+
+		FInBunch Exports( Connection, UncompressedData.GetData(), UncompressedBits );
+		ReceiveNetGUIDExports( Exports, NumGUIDsInBunch );
+
+		if ( Exports.IsError() )
+		{
+			InBunch.SetError();
+		}
+	}
+	else
+	{
+		ReceiveNetGUIDExports( InBunch, NumGUIDsInBunch );
+	}
 
-	UE_LOG(LogNetPackageMap, Log, TEXT("UPackageMapClient::ReceiveNetGUIDBunch %d NetGUIDs. PacketId %d. ChSequence %d. ChIndex %d"), NumGUIDsInBunch, InBunch.PacketId, InBunch.ChSequence, InBunch.ChIndex );
+	UE_LOG(LogNetPackageMap, Log, TEXT("UPackageMapClient::ReceiveNetGUIDBunch end. BitPos: %d"), InBunch.GetPosBits() );
+	GuidCache->IsExportingNetGUIDBunch = false;
+}
+
+/** Reads the exports of a NetGUID bunch, once it has been uncompressed */
+void UPackageMapClient::ReceiveNetGUIDExports( FArchive& Ar, const int32 NumGUIDsInBunch )
+{
+	NET_CHECKSUM(Ar);
 
 	int32 NumGUIDsRead = 0;
 	while( NumGUIDsRead < NumGUIDsInBunch )
 	{
 		UObject* Obj = NULL;
-		InternalLoadObject( InBunch, Obj, 0 );
+		InternalLoadObject( Ar, Obj, 0 );
 
-		if ( InBunch.IsError() )
+		if ( Ar.IsError() )
 		{
 			UE_LOG( LogNetPackageMap, Error, TEXT( "UPackageMapClient::ReceiveNetGUIDBunch: InBunch.IsError() after InternalLoadObject" ) );
-			GuidCache->IsExportingNetGUIDBunch = false;
 			return;
 		}
 		NumGUIDsRead++;
 	}
-
-	UE_LOG(LogNetPackageMap, Log, TEXT("UPackageMapClient::ReceiveNetGUIDBunch end. BitPos: %d"), InBunch.GetPosBits() );
-	GuidCache->IsExportingNetGUIDBunch = false;
 }
 
 bool UPackageMapClient::AppendExportBunches(TArray<FOutBunch *>& OutgoingBunches)
@@ -929,6 +1167,62 @@ bool UPackageMapClient::AppendExportBunches(TArray<FOutBunch *>& OutgoingBunches
 	return false;
 }
 
+int64 UPackageMapClient::GetMaxExportBunchBits() const
+{
+	return Connection->MaxPacket*8-MAX_BUNCH_HEADER_BITS-MAX_PACKET_TRAILER_BITS-MAX_PACKET_HEADER_BITS;
+}
+
+bool UPackageMapClient::ExportBunchFitsInPacket()
+{
+	if ( CurrentExportBunch->GetNumBits() <= ExportBunchCheckBits )
+	{
+		return true;
+	}
+
+	const int64 MaxExportBunchBits = GetMaxExportBunchBits();
+	const int64 CompressedBits = CompressCurrentExportBunch();
+
+	if ( CompressedBits < 0 || CompressedBits + NETGUID_EXPORT_COMPRESSION_SLACK_BITS > MaxExportBunchBits )
+	{
+		return false;
+	}
+
+	// Assume anything exported from now on doesn't compress at all, so this doesn't have to compress again for every export
+	ExportBunchCheckBits = CurrentExportBunch->GetNumBits() + MaxExportBunchBits - CompressedBits - NETGUID_EXPORT_COMPRESSION_SLACK_BITS;
+
+	return true;
+}
+
+int64 UPackageMapClient::CompressCurrentExportBunch()
+{
+	check( CurrentExportBunch != NULL );
+
+	const uint8* Exports = CurrentExportBunch->GetData() + NETGUID_EXPORT_HEADER_BYTES;
+	const int32 ExportsSize = CurrentExportBunch->GetNumBytes() - NETGUID_EXPORT_HEADER_BYTES;
+
+	int32 CompressedSize = FCompression::CompressMemoryBound( COMPRESS_ZLIB, ExportsSize );
+	ExportCompressionBuffer.SetNumUninitialized( CompressedSize );
+
+	if ( !FCompression::CompressMemory( COMPRESS_ZLIB, ExportCompressionBuffer.GetData(), CompressedSize, Exports, ExportsSize ) )
+	{
+		ExportCompressionBuffer.Reset();
+		return -1;
+	}
+
+	ExportCompressionBuffer.SetNumUninitialized( CompressedSize );
+
+	return NETGUID_EXPORT_COMPRESSED_HEADER_BITS + CompressedSize * 8;
+}
+
+void UPackageMapClient::SetRemotePathTableChecksum( const uint32 RemoteChecksum )
+{
+	const uint32 Checksum = FNetPathTable::Get().GetChecksum();
+
+	bUsePathTable = Checksum != 0 && RemoteChecksum == Checksum;
+
+	UE_LOG( LogNetPackageMap, Log, TEXT( "UPackageMapClient::SetRemotePathTableChecksum: Remote 0x%08X, local 0x%08X. Using path table: %d" ), RemoteChecksum, Checksum, bUsePathTable ? 1 : 0 );
+}
+
 //--------------------------------------------------------------------
 //
 //	Network - ACKing
@@ -8,6 +8,7 @@
 #include "Net/UnrealNetwork.h"
 #include "Net/NetworkProfiler.h"
 #include "Net/DataChannel.h"
+#include "Net/NetPathTable.h"
 
 UPendingNetGame::UPendingNetGame( const FObjectInitializer& ObjectInitializer, const FURL& InURL )
 	: Super(ObjectInitializer)
@@ -197,6 +198,14 @@ void UPendingNetGame::NotifyControlMessage(UNetConnection* Connection, uint8 Mes
 			FString URLString(PartialURL.ToString());
 			FNetControlMessage<NMT_Login>::Send(Connection, Connection->ClientResponse, URLString, UniqueIdRepl);
 			FNetControlMessage<NMT_Netspeed>::Send(Connection, Connection->CurrentNetSpeed);
+
+			// Let the server export packages as an index in our path table, if it has the same one
+			uint32 PathTableChecksum = FNetPathTable::Get().GetChecksum();
+			if (PathTableChecksum != 0)
+			{
+				FNetControlMessage<NMT_NetGUIDPathTable>::Send(Connection, PathTableChecksum);
+			}
+
 			NetDriver->ServerConnection->FlushNet();
 			break;
 		}
@@ -8,10 +8,16 @@
 #include "Net/RepLayout.h"
 #include "Net/DataReplication.h"
 #include "Net/NetworkProfiler.h"
+#include "Net/NetReplicationProfiler.h"
+#include "Net/NetPushModel.h"
 #include "Engine/ActorChannel.h"
 
 static TAutoConsoleVariable<int32> CVarAllowPropertySkipping( TEXT( "net.AllowPropertySkipping" ), 1, TEXT( "Allow skipping of properties that haven't changed for other clients" ) );
 
+static TAutoConsoleVariable<int32> CVarPushModelSkipCompare( TEXT( "net.PushModelSkipCompare" ), 1, TEXT( "Skip comparing push based properties that haven't been marked dirty since the last compare" ) );
+
+static TAutoConsoleVariable<int32> CVarShareSerializedProperties( TEXT( "net.ShareSerializedProperties" ), 1, TEXT( "Allow connections sending the same change list in the same frame to share the serialized properties" ) );
+
 static TAutoConsoleVariable<int32> CVarDoPropertyChecksum( TEXT( "net.DoPropertyChecksum" ), 0, TEXT( "" ) );
 
 FAutoConsoleVariable CVarDoReplicationContextString( TEXT( "net.ContextDebug" ), 0, TEXT( "" ) );
@@ -418,13 +424,19 @@ bool FRepLayout::CompareProperties(
 	const uint8* RESTRICT				CompareData,
 	const uint8* RESTRICT				Data, 
 	TArray< FRepChangedParent > &		OutChangedParents,
-	const TArray< uint16 > &			PropertyList ) const
+	const TArray< uint16 > &			PropertyList,
+	const uint32						PushSinceEpoch ) const
 {
 	bool PropertyChanged = false;
 
 	const uint16* RESTRICT FirstProp	= PropertyList.GetData();
 	const uint16* RESTRICT LastProp	= FirstProp + PropertyList.Num();
 
+	// Push based properties only need a compare if they were marked dirty since this FRepState last compared
+	const UObject* Object			= (const UObject*)Data;
+	const bool bObjectIsPushDirty	= PushSinceEpoch == 0 || FNetPushModel::IsObjectDirty( Object, PushSinceEpoch );
+	int32 NumSkippedPushProperties	= 0;
+
 	for ( const uint16* RESTRICT pLifeProp = FirstProp; pLifeProp < LastProp; ++pLifeProp )
 	{
 		const FRepParentCmd& ParentCmd = Parents[*pLifeProp];
@@ -434,6 +446,12 @@ bool FRepLayout::CompareProperties(
 
 		check( Changed.Num() == 0 );
 
+		if ( PushSinceEpoch != 0 && ( ParentCmd.Flags & PARENT_IsPushBased ) && ( !bObjectIsPushDirty || !FNetPushModel::IsPropertyDirty( Object, *pLifeProp, PushSinceEpoch ) ) )
+		{
+			NumSkippedPushProperties++;
+			continue;
+		}
+
 		// Loop over the block of child properties that are children of this parent
 		for ( int32 i = ParentCmd.CmdStart; i < ParentCmd.CmdEnd; i++ )
 		{
@@ -463,6 +481,8 @@ bool FRepLayout::CompareProperties(
 		}
 	}
 
+	INC_DWORD_STAT_BY( STAT_NetPushModelSkippedCompares, NumSkippedPushProperties );
+
 	return PropertyChanged;
 }
 
@@ -593,6 +613,9 @@ bool FRepLayout::ReplicateProperties(
 
 		RepState->RepFlags.Value		= RepFlags.Value;
 		RepState->ActiveStatusChanged	= ChangeTracker->ActiveStatusChanged;
+
+		// Newly active properties were never compared against our shadow state, so compare everything once
+		RepState->LastPushCompareEpoch	= 0;
 	}
 
 	bool PropertyChanged = false;
@@ -603,7 +626,14 @@ bool FRepLayout::ReplicateProperties(
 	if ( bIsAllAcked || !RepState->OpenAckedCalled )
 #endif
 	{
+#if USE_NET_REPLICATION_PROFILER
+		const uint32 CompareStartCycles = GNetReplicationProfiler.IsTrackingEnabled() ? FPlatformTime::Cycles() : 0;
+#endif
+
 		const int32	AllowSkipping = CVarAllowPropertySkipping.GetValueOnGameThread();
+
+		// Push based properties that weren't marked dirty since our last compare can't have changed against our shadow state
+		const uint32 PushSinceEpoch = CVarPushModelSkipCompare.GetValueOnGameThread() > 0 ? RepState->LastPushCompareEpoch : 0;
 		
 		const bool bCanSkip =	AllowSkipping > 0 && 
 								RepState->LastReplicationFrame != 0 &&
@@ -641,11 +671,12 @@ bool FRepLayout::ReplicateProperties(
 			}
 
 			// Loop over all unconditional lifetime properties
-			ChangeTracker->UnconditionalPropChanged = CompareProperties( RepState, CompareData, Data, ChangeTracker->Parents, UnconditionalLifetime );
+			ChangeTracker->UnconditionalPropChanged = CompareProperties( RepState, CompareData, Data, ChangeTracker->Parents, UnconditionalLifetime, PushSinceEpoch );
 		}
 
 		// Remember the last frame this FRepState was replicated, so we can note above when the FRepState replication group changes
 		RepState->LastReplicationFrame = NetDriver->ReplicationFrame;
+		RepState->LastPushCompareEpoch = FNetPushModel::GetEpoch();
 
 		if ( ChangeTracker->UnconditionalPropChanged )
 		{
@@ -653,10 +684,12 @@ bool FRepLayout::ReplicateProperties(
 		}
 
 		// Loop over all the conditional properties
-		if ( CompareProperties( RepState, CompareData, Data, ChangeTracker->Parents, RepState->ConditionalLifetime ) )
+		if ( CompareProperties( RepState, CompareData, Data, ChangeTracker->Parents, RepState->ConditionalLifetime, PushSinceEpoch ) )
 		{
 			PropertyChanged = true;
 		}
+
+		NET_REPLICATION_PROFILER( GNetReplicationProfiler.TrackCompareProperties( Owner, FPlatformTime::Cycles() - CompareStartCycles ) );
 	}
 #ifdef ENABLE_SUPER_CHECKSUMS
 	else
@@ -923,7 +956,10 @@ static bool ShouldSendProperty( FRepWriterState & WriterState, const uint16 Hand
 	if ( Handle == WriterState.Changed[WriterState.CurrentChanged] )
 	{
 		// Write out the handle
-		WritePropertyHandle( WriterState.Writer, Handle, WriterState.bDoChecksum );
+		if ( !WriterState.bStoreOnly )
+		{
+			WritePropertyHandle( WriterState.Writer, Handle, WriterState.bDoChecksum );
+		}
 
 		// Advance to the next expected handle
 		WriterState.CurrentChanged++;
@@ -950,7 +986,10 @@ void FRepLayout::SendProperties_DynamicArray_r(
 
 	// Write array num
 	uint16 ArrayNum = Array->Num();
-	WriterState.Writer << ArrayNum;
+	if ( !WriterState.bStoreOnly )
+	{
+		WriterState.Writer << ArrayNum;
+	}
 
 	// Make the shadow state match the actual state at the time of send
 	FScriptArrayHelper StoredArrayHelper( (UArrayProperty *)Cmd.Property, StoredData );
@@ -979,7 +1018,31 @@ void FRepLayout::SendProperties_DynamicArray_r(
 
 	WriterState.CurrentChanged++;
 
-	WritePropertyHandle( WriterState.Writer, 0, WriterState.bDoChecksum );		// Signify end of dynamic array
+	if ( !WriterState.bStoreOnly )
+	{
+		WritePropertyHandle( WriterState.Writer, 0, WriterState.bDoChecksum );		// Signify end of dynamic array
+	}
+}
+
+bool FRepLayout::CanShareSerialization( const FRepLayoutCmd & Cmd ) const
+{
+	// RemoteRole is downgraded per connection while replicating
+	if ( Cmd.ParentIndex == RemoteRoleIndex )
+	{
+		return false;
+	}
+
+	switch ( Cmd.Type )
+	{
+		// These go through the connection's package map, or may contain something that does
+		case REPCMD_Property:
+		case REPCMD_PropertyName:
+		case REPCMD_PropertyObject:
+		case REPCMD_PropertyNetId:
+			return false;
+	}
+
+	return true;
 }
 
 uint16 FRepLayout::SendProperties_r( 
@@ -1012,6 +1075,17 @@ uint16 FRepLayout::SendProperties_r(
 
 		if ( ShouldSendProperty( WriterState, Handle ) )
 		{
+			if ( WriterState.bStoreOnly )
+			{
+				StoreProperty( Cmd, (void*)( StoredData + Cmd.Offset ), (const void*)( Data + Cmd.Offset ) );
+				continue;
+			}
+
+			if ( !CanShareSerialization( Cmd ) )
+			{
+				WriterState.bCanShareSerialization = false;
+			}
+
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 			if (CVarDoReplicationContextString->GetInt() > 0)
 			{
@@ -1029,6 +1103,7 @@ uint16 FRepLayout::SendProperties_r(
 			const FRepParentCmd& ParentCmd = Parents[Cmd.ParentIndex];
 
 			NETWORK_PROFILER( GNetworkProfiler.TrackReplicateProperty( ParentCmd.Property, NumEndBits - NumStartBits ) );
+			NET_REPLICATION_PROFILER( GNetReplicationProfiler.TrackReplicateProperty( ParentCmd.Property, NumEndBits - NumStartBits ) );
 
 			// Make the shadow state match the actual state at the time of send
 			StoreProperty( Cmd, (void*)( StoredData + Cmd.Offset ), (const void*)( Data + Cmd.Offset ) );
@@ -1124,8 +1199,62 @@ void FRepLayout::SendProperties(
 	Writer.WriteBit( bDoChecksum ? 1 : 0 );
 #endif
 
+	// The serialized properties only depend on the change list and the object, which doesn't change during a frame,
+	// so connections sending the same change list in the same frame can share the bits
+	FRepChangedPropertyTracker* ChangeTracker		= RepState->RepChangedPropertyTracker.Get();
+	const uint32				ReplicationFrame	= OwningChannel->Connection->Driver->ReplicationFrame;
+
+	bool bShareSerialization = !bDoChecksum && ChangeTracker != NULL && CVarShareSerializedProperties.GetValueOnGameThread() > 0;
+
+#if USE_NETWORK_PROFILER
+	// The profiler tracks the size of each property, so it needs every connection to serialize them
+	bShareSerialization = bShareSerialization && !GNetworkProfiler.IsTrackingEnabled();
+#endif
+#if USE_NET_REPLICATION_PROFILER
+	bShareSerialization = bShareSerialization && !GNetReplicationProfiler.IsTrackingEnabled();
+#endif
+
+	if ( bShareSerialization )
+	{
+		if ( ChangeTracker->SerializedChangelistFrame != ReplicationFrame )
+		{
+			ChangeTracker->SerializedChangelists.Reset();
+			ChangeTracker->SerializedChangelistFrame = ReplicationFrame;
+		}
+
+		for ( int32 i = 0; i < ChangeTracker->SerializedChangelists.Num(); i++ )
+		{
+			FRepSerializedChangelist & Serialized = ChangeTracker->SerializedChangelists[i];
+
+			if ( Serialized.Changed == Changed )
+			{
+				Writer.SerializeBits( Serialized.Buffer.GetData(), Serialized.NumBits );
+
+				// Still walk the change list to make the shadow state match what we sent
+				WriterState.bStoreOnly = true;
+				SendProperties_r( RepState, RepFlags, WriterState, 0, Cmds.Num() - 1, RepState->StaticBuffer.GetData(), Data, 0 );
+
+				WritePropertyHandle( Writer, 0, bDoChecksum );
+
+				INC_DWORD_STAT( STAT_NetSharedSerializedChangelists );
+				return;
+			}
+		}
+	}
+
+	FBitWriterMark Mark( Writer );
+
 	SendProperties_r( RepState, RepFlags, WriterState, 0, Cmds.Num() - 1, RepState->StaticBuffer.GetData(), Data, 0 );
 
+	if ( bShareSerialization && WriterState.bCanShareSerialization && !Writer.IsError() && ChangeTracker->SerializedChangelists.Num() < FRepChangedPropertyTracker::MAX_SERIALIZED_CHANGELISTS )
+	{
+		FRepSerializedChangelist & Serialized = *new( ChangeTracker->SerializedChangelists ) FRepSerializedChangelist();
+
+		Serialized.Changed	= Changed;
+		Serialized.NumBits	= Writer.GetNumBits() - Mark.GetNumBits();
+		Mark.Copy( Writer, Serialized.Buffer );
+	}
+
 	WritePropertyHandle( Writer, 0, bDoChecksum );
 }
 
@@ -2242,6 +2371,11 @@ void FRepLayout::InitFromObjectClass( UClass * InObjectClass )
 			Parents[LifetimeProps[i].RepIndex].Condition = LifetimeProps[i].Condition;
 			Parents[LifetimeProps[i].RepIndex].RepNotifyCondition = LifetimeProps[i].RepNotifyCondition;
 
+			if ( LifetimeProps[i].bIsPushBased )
+			{
+				Parents[LifetimeProps[i].RepIndex].Flags |= PARENT_IsPushBased;
+			}
+
 			if ( Parents[LifetimeProps[i].RepIndex].Flags & PARENT_IsCustomDelta )
 			{
 				continue;		// We don't handle custom properties in the FRepLayout class
@@ -33,6 +33,7 @@
 #include "TargetPlatform.h"
 #include "AudioEffect.h"
 #include "Net/NetworkProfiler.h"
+#include "Net/NetReplicationProfiler.h"
 #include "MallocProfiler.h"
 #include "../../Launch/Resources/Version.h"
 #include "StereoRendering.h"
@@ -2482,6 +2483,12 @@ bool UEngine::Exec( UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar )
 	{
 		GNetworkProfiler.Exec( InWorld, Cmd, Ar );
 	}
+#endif
+#if USE_NET_REPLICATION_PROFILER
+	else if( FParse::Command(&Cmd,TEXT("NETPROFILEREP")) )
+	{
+		GNetReplicationProfiler.Exec( InWorld, Cmd, Ar );
+	}
 #endif
 	else 
 	{
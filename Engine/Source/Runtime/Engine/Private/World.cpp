@@ -20,6 +20,7 @@
 #include "ParticleDefinitions.h"
 #include "Database.h"
 #include "Net/NetworkProfiler.h"
+#include "Net/NetPathTable.h"
 #include "PrecomputedLightVolume.h"
 #include "UObjectAnnotation.h"
 #include "RenderCore.h"
@@ -2528,6 +2529,10 @@ bool UWorld::Exec( UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar )
 	{		
 		return HandleDemoStopCommand( Cmd, Ar, InWorld );
 	}
+	else if( FParse::Command( &Cmd, TEXT("DEMOSCRUB") ) )
+	{		
+		return HandleDemoScrubCommand( Cmd, Ar, InWorld );
+	}
 	else if( ExecPhysCommands( Cmd, &Ar, InWorld ) )
 	{
 		return HandleLogActorCountsCommand( Cmd, Ar, InWorld );
@@ -2688,6 +2693,26 @@ bool UWorld::HandleDemoStopCommand( const TCHAR* Cmd, FOutputDevice& Ar, UWorld*
 	return true;
 }
 
+bool UWorld::HandleDemoScrubCommand( const TCHAR* Cmd, FOutputDevice& Ar, UWorld* InWorld )
+{
+	FString TimeString;
+	if ( !FParse::Token( Cmd, TimeString, 0 ) )
+	{
+		Ar.Log( TEXT( "Usage: DEMOSCRUB <seconds>" ) );
+		return true;
+	}
+
+	if ( DemoNetDriver != NULL && DemoNetDriver->ServerConnection != NULL )
+	{
+		DemoNetDriver->GotoTimeInSeconds( FCString::Atof( *TimeString ) );
+	}
+	else
+	{
+		Ar.Log( TEXT( "DEMOSCRUB: No demo is playing" ) );
+	}
+	return true;
+}
+
 void UWorld::DestroyDemoNetDriver()
 {
 	if ( DemoNetDriver != NULL )
@@ -3206,6 +3231,16 @@ void UWorld::RemoveNetworkActor( AActor* Actor )
 	}
 
 	NetworkActors.RemoveSingleSwap( Actor );
+
+	if ( NetDriver )
+	{
+		NetDriver->RemoveNetworkActor( Actor );
+	}
+
+	if ( DemoNetDriver )
+	{
+		DemoNetDriver->RemoveNetworkActor( Actor );
+	}
 }
 
 void UWorld::AddOnActorSpawnedHandler( const FOnActorSpawned::FDelegate& InHandler )
@@ -3664,6 +3699,18 @@ void UWorld::NotifyControlMessage(UNetConnection* Connection, uint8 MessageType,
 				UE_LOG(LogNet, Log, TEXT("Client netspeed is %i"), Connection->CurrentNetSpeed);
 				break;
 			}
+			case NMT_NetGUIDPathTable:
+			{
+				uint32 PathTableChecksum = 0;
+				FNetControlMessage<NMT_NetGUIDPathTable>::Receive(Bunch, PathTableChecksum);
+
+				UPackageMapClient* PackageMapClient = Cast<UPackageMapClient>(Connection->PackageMap);
+				if (PackageMapClient != NULL)
+				{
+					PackageMapClient->SetRemotePathTableChecksum(PathTableChecksum);
+				}
+				break;
+			}
 			case NMT_Abort:
 			{
 				break;
@@ -3953,6 +4000,9 @@ bool UWorld::Listen( FURL& InURL )
 		NetDriver->MaxClientRate = NetDriver->MaxInternetClientRate;
 	}
 
+	// Build the path table now rather than when the first client logs in
+	FNetPathTable::Get();
+
 	NextSwitchCountdown = NetDriver->ServerTravelPause;
 	return true;
 }
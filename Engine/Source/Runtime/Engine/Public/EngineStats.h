@@ -61,7 +61,10 @@ DECLARE_CYCLE_STAT_EXTERN(TEXT("Net Broadcast Tick Time"),STAT_NetBroadcastTickT
 DECLARE_CYCLE_STAT_EXTERN(TEXT("  ServerReplicateActors Time"),STAT_NetServerRepActorsTime,STATGROUP_Game, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("  Consider Actors Time"),STAT_NetConsiderActorsTime,STATGROUP_Game, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("  Inital Dormant Time"),STAT_NetInitialDormantCheckTime,STATGROUP_Game, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("  Gather Prioritized Actors Time"),STAT_NetGatherPrioritizedActorsTime,STATGROUP_Game, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("  Prioritize Actors Time"),STAT_NetPrioritizeActorsTime,STATGROUP_Game, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("  Prioritize Actors Wait Time"),STAT_NetPrioritizeActorsWaitTime,STATGROUP_Game, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("  Process Prioritized Actors Time"),STAT_NetProcessPrioritizedActorsTime,STATGROUP_Game, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("  Replicate Actors Time"),STAT_NetReplicateActorsTime,STATGROUP_Game, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("  Dynamic Property Rep Time"),STAT_NetReplicateDynamicPropTime,STATGROUP_Game, );
 DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("  Skipped Dynamic Props"),STAT_NetSkippedDynamicProps,STATGROUP_Game, );
@@ -202,4 +205,6 @@ DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Num UnACKd NetGUIDs"),STAT_NumNetGUI
 DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Object path (bytes)"),STAT_ObjPathBytes,STATGROUP_Net, );
 DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("NetGUID Out Rate (bytes)"),STAT_NetGUIDOutRate,STATGROUP_Net, );
 DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("NetGUID In Rate (bytes)"),STAT_NetGUIDInRate,STATGROUP_Net, );
-DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Saturated"),STAT_NetSaturated,STATGROUP_Net, );
\ No newline at end of file
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Saturated"),STAT_NetSaturated,STATGROUP_Net, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Push Model Skipped Compares"),STAT_NetPushModelSkippedCompares,STATGROUP_Net, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Shared Serialized Changelists"),STAT_NetSharedSerializedChangelists,STATGROUP_Net, );
\ No newline at end of file
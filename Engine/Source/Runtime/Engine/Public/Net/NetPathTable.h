@@ -0,0 +1,67 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	NetPathTable.h:
+	Shared table of package names, used to reference packages by index in NetGUID exports.
+=============================================================================*/
+#pragma once
+
+/**
+ * FNetPathTable
+ *	A sorted list of every package in the cooked content, built the same way on the server and on clients.
+ *
+ *	When both sides of a connection have a table with the same checksum, UPackageMapClient exports packages as
+ *	their index in the table instead of their full path name. Clients send their checksum to the server after
+ *	logging in (NMT_NetGUIDPathTable), the server only uses indices for connections whose checksum matches its own.
+ *
+ *	Only cooked builds have a table, editor and uncooked builds have an empty table with a checksum of 0 and
+ *	always send path names. Game thread only.
+ */
+class ENGINE_API FNetPathTable
+{
+public:
+	FNetPathTable()
+		: Checksum(0)
+	{
+	}
+
+	/** @return the table for the cooked content, built on first use. Empty if net.UseNetPathTable was 0 at that point */
+	static const FNetPathTable& Get();
+
+	/** Replaces the table with the sorted, unique PackageNames */
+	void Build(TArray<FString> PackageNames);
+
+	/** @return the index of PackageName, or INDEX_NONE if it isn't in the table */
+	int32 FindPackageIndex(FName PackageName) const
+	{
+		const int32* Index = PackageToIndex.Find(PackageName);
+		return Index != NULL ? *Index : INDEX_NONE;
+	}
+
+	/** @return the package name at Index, or NAME_None if Index isn't valid */
+	FName GetPackageName(int32 Index) const
+	{
+		return PackageNames.IsValidIndex(Index) ? PackageNames[Index] : NAME_None;
+	}
+
+	/** @return the number of packages in the table */
+	int32 Num() const
+	{
+		return PackageNames.Num();
+	}
+
+	/** @return the checksum of every package name in order, 0 if the table is empty */
+	uint32 GetChecksum() const
+	{
+		return Checksum;
+	}
+
+private:
+	/** Every package, sorted */
+	TArray<FName>		PackageNames;
+
+	/** Index of each package in PackageNames */
+	TMap<FName, int32>	PackageToIndex;
+
+	uint32				Checksum;
+};
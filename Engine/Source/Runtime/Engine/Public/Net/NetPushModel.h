@@ -0,0 +1,69 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	NetPushModel.h:
+	Dirty tracking for push based replicated properties.
+=============================================================================*/
+#pragma once
+
+/**
+ * FNetPushModel
+ *	Records when push based replicated properties (see DOREPLIFETIME_PUSH) were last marked dirty.
+ *
+ *	Properties are identified by object and RepIndex. Instead of a bit that has to be cleared once every
+ *	connection has seen it, each property stores the replication epoch it was last marked dirty in. Every
+ *	FRepState remembers the epoch of its last compare, so FRepLayout can skip comparing a push based property
+ *	for a connection when it has not been marked dirty since that connection last compared it.
+ *
+ *	The epoch is advanced by the net driver after each replication pass. Game thread only.
+ */
+class ENGINE_API FNetPushModel
+{
+public:
+	/** Marks Count consecutive properties starting at RepIndex as dirty on Object */
+	static void MarkPropertyDirty(const UObject* Object, int32 RepIndex, int32 Count = 1);
+
+	/** Marks every replicated property of Object as dirty (e.g. after a bulk change or a load) */
+	static void MarkObjectDirty(const UObject* Object);
+
+	/**
+	 * @return true if the property was marked dirty in or after SinceEpoch.
+	 * An epoch of 0 means the caller never compared, so everything is dirty.
+	 */
+	static bool IsPropertyDirty(const UObject* Object, int32 RepIndex, uint32 SinceEpoch);
+
+	/** @return true if any property of the object was marked dirty in or after SinceEpoch */
+	static bool IsObjectDirty(const UObject* Object, uint32 SinceEpoch);
+
+	/** @return the current replication epoch, never 0 */
+	static uint32 GetEpoch()
+	{
+		return Epoch;
+	}
+
+	/** Called once replication has compared properties for this frame */
+	static void AdvanceEpoch();
+
+private:
+	struct FObjectState
+	{
+		FObjectState() : LastDirtyEpoch(0), AllDirtyEpoch(0) {}
+
+		/** Epoch each property was last marked dirty in, indexed by RepIndex */
+		TArray<uint32>	PropertyDirtyEpoch;
+		/** Most recent epoch any property was marked dirty in */
+		uint32			LastDirtyEpoch;
+		/** Epoch the whole object was last marked dirty in */
+		uint32			AllDirtyEpoch;
+	};
+
+	friend class FNetPushModelObjectListener;
+
+	/** @return the state of every object that was marked dirty, removed when the object is deleted */
+	static TMap<const UObjectBase*, FObjectState>& GetObjectStates();
+
+	/** @return the state for Object, creating it if needed */
+	static FObjectState& FindOrAddObjectState(const UObject* Object);
+
+	static uint32 Epoch;
+};
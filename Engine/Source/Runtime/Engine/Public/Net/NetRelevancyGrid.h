@@ -0,0 +1,120 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	NetRelevancyGrid.h:
+	Spatial index used by UNetDriver to find relevancy candidates per connection.
+=============================================================================*/
+#pragma once
+
+class AActor;
+class UNetConnection;
+struct FNetViewer;
+
+/**
+ * FNetRelevancyGrid
+ *	Optional relevancy policy for UNetDriver::ServerReplicateActors.
+ *
+ *	Network actors are bucketed into a uniform 2D (XY) grid of cells. Instead of testing every considered actor
+ *	against every connection, a connection only gathers:
+ *
+ *		- actors that already have an open channel on the connection (so they can time out / be closed),
+ *		- actors whose relevancy may not depend on distance alone (always relevant, owned, attached, or whose
+ *		  class hasn't set AActor::bNetRelevancyGridCulling, e.g. because it overrides IsNetRelevantFor),
+ *		- actors in the cells within NetCullDistance of one of the connection's viewers.
+ *
+ *	The gathered actors still go through AActor::IsNetRelevantFor, the grid only removes candidates that
+ *	are guaranteed to fail the distance check. Only used when AGameNetworkManager::bUseDistanceBasedRelevancy is set.
+ */
+class ENGINE_API FNetRelevancyGrid
+{
+public:
+	FNetRelevancyGrid(float InCellSize);
+
+	/**
+	 * Adds or refreshes an actor and flags it as being in this frame's consider list.
+	 * Moves the actor to a new cell if it changed cells since the last update.
+	 */
+	void MarkConsidered(AActor* Actor, uint32 Frame);
+
+	/** Removes an actor from the grid, must be called before the actor is destroyed */
+	void RemoveActor(AActor* Actor);
+
+	/** Removes all actors */
+	void Empty();
+
+	/**
+	 * Gathers the actors considered this frame that may be relevant to a connection.
+	 *
+	 * @param Connection	connection whose open channels are always gathered
+	 * @param Viewers		viewers (connection + children) to gather nearby actors for
+	 * @param Frame			frame passed to MarkConsidered, actors not considered this frame are skipped
+	 * @param OutActors		receives each candidate once
+	 */
+	void GatherCandidates(UNetConnection* Connection, const TArray<FNetViewer>& Viewers, uint32 Frame, TArray<AActor*>& OutActors);
+
+	/** @return number of actors tracked by the grid */
+	int32 Num() const
+	{
+		return ActorToEntry.Num();
+	}
+
+private:
+	struct FEntry
+	{
+		AActor*		Actor;
+		/** Cell the actor is in, unused for non spatial actors */
+		FIntPoint	Cell;
+		/** Index in the cell's (or the non spatial list's) actor array */
+		int32		IndexInList;
+		/** Last frame the actor was in the consider list */
+		uint32		ConsiderFrame;
+		/** Last query that gathered the actor, used to gather each actor once */
+		uint32		QueryTag;
+		/** False if relevancy for this actor does not depend on distance */
+		bool		bSpatial;
+	};
+
+	/** @return true if the actor's relevancy can only be decided by its distance to the viewer */
+	static bool IsSpatiallyRelevant(AActor* Actor);
+
+	/** @return the cell containing Location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** @return the list an entry currently lives in */
+	TArray<int32>& GetEntryList(const FEntry& Entry);
+
+	/** Adds an entry to the cell or non spatial list matching its current state */
+	void LinkEntry(int32 EntryIndex);
+
+	/** Removes an entry from the list it currently lives in */
+	void UnlinkEntry(int32 EntryIndex);
+
+	/** Gathers the entries of a cell that are within their cull distance of ViewLocation */
+	void GatherCell(const TArray<int32>& CellEntries, const FVector& ViewLocation, uint32 Frame, TArray<AActor*>& OutActors);
+
+	/** Adds an entry to OutActors if it was considered this frame and not yet gathered by this query */
+	FORCEINLINE void GatherEntry(FEntry& Entry, uint32 Frame, TArray<AActor*>& OutActors)
+	{
+		if (Entry.ConsiderFrame == Frame && Entry.QueryTag != QueryTag)
+		{
+			Entry.QueryTag = QueryTag;
+			OutActors.Add(Entry.Actor);
+		}
+	}
+
+	/** Size of a cell along X and Y */
+	float CellSize;
+	/** Largest NetCullDistanceSquared seen, bounds the cells visited by a query */
+	float MaxCullDistanceSquared;
+	/** Incremented for each GatherCandidates call */
+	uint32 QueryTag;
+
+	/** All tracked actors, with holes left by removed actors */
+	TSparseArray<FEntry> Entries;
+	/** Maps an actor to its index in Entries */
+	TMap<AActor*, int32> ActorToEntry;
+	/** Entries of spatial actors, per cell */
+	TMap<FIntPoint, TArray<int32> > Cells;
+	/** Entries of actors whose relevancy does not depend on distance */
+	TArray<int32> NonSpatialEntries;
+};
@@ -0,0 +1,157 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	NetReplicationProfiler.h:
+	In-process aggregation of replication cost per class, property and connection.
+=============================================================================*/
+#pragma once
+
+/** Available in every build but shipping, so it can run on test dedicated servers */
+#ifndef USE_NET_REPLICATION_PROFILER
+	#define USE_NET_REPLICATION_PROFILER !(UE_BUILD_SHIPPING)
+#endif
+
+#if USE_NET_REPLICATION_PROFILER
+
+#define NET_REPLICATION_PROFILER( x ) if ( GNetReplicationProfiler.IsTrackingEnabled() ) { x; }
+
+/**
+ * FNetReplicationProfiler
+ *	Unlike FNetworkProfiler, which streams every event to a file for the external NetworkProfiler tool, this
+ *	keeps running totals in memory: bits written, time spent replicating and comparing, and RPCs sent, for each
+ *	replicated class, property and connection. Meant to be left on for a while on a live server to find out
+ *	which classes are worth a lower NetUpdateFrequency.
+ *
+ *	Enabled with net.RepProfiler or the NETPROFILEREP console command, which also prints the totals. With
+ *	net.RepProfiler.CSVInterval set, the totals are also written to a CSV in the profiling directory and reset
+ *	every interval. Game thread only.
+ */
+class ENGINE_API FNetReplicationProfiler
+{
+public:
+	FNetReplicationProfiler();
+
+	/** @return true if events should be tracked, only changes in Tick */
+	bool FORCEINLINE IsTrackingEnabled() const { return bIsTrackingEnabled; }
+
+	/**
+	 * Tracks an actor being replicated to a connection.
+	 *
+	 * @param	Actor		Actor being replicated
+	 * @param	Connection	Connection it is replicated to
+	 * @param	NumBits		Bits written for the actor and its subobjects, 0 if nothing was sent
+	 * @param	Cycles		Time spent replicating the actor and its subobjects
+	 */
+	void TrackReplicateActor( const AActor* Actor, const UNetConnection* Connection, uint32 NumBits, uint32 Cycles );
+
+	/**
+	 * Tracks the properties of an object being compared against its shadow state.
+	 *
+	 * @param	Owner		Class or struct the properties belong to
+	 * @param	Cycles		Time spent comparing
+	 */
+	void TrackCompareProperties( const UStruct* Owner, uint32 Cycles );
+
+	/**
+	 * Tracks a property being written to a bunch.
+	 *
+	 * @param	Property	Top level property being replicated
+	 * @param	NumBits		Number of bits used to replicate this property
+	 */
+	void TrackReplicateProperty( const UProperty* Property, uint32 NumBits );
+
+	/**
+	 * Tracks an RPC being sent or queued.
+	 *
+	 * @param	Actor		Actor the RPC is called on
+	 * @param	Connection	Connection the RPC is sent to
+	 * @param	NumBits		Number of bits in the RPC bunch
+	 */
+	void TrackSendRPC( const AActor* Actor, const UNetConnection* Connection, uint32 NumBits );
+
+	/** Picks up net.RepProfiler and writes the periodic CSV. Called by every net driver each frame */
+	void Tick();
+
+	/** Clears every total */
+	void Reset();
+
+	/**
+	 * Processes NETPROFILEREP [ENABLE|DISABLE|RESET|CSV|DUMP [MaxRows]]. Dumps the totals if no sub command is given.
+	 *
+	 * @return	True if processed, false otherwise
+	 */
+	bool Exec( UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar );
+
+private:
+	struct FClassStats
+	{
+		FClassStats() : NetUpdateFrequency( 0.0f ), NumReplicates( 0 ), NumSends( 0 ), NumBits( 0 ), ReplicateCycles( 0 ), NumCompares( 0 ), CompareCycles( 0 ), NumRPCs( 0 ), RPCBits( 0 ) {}
+
+		FString		Name;
+		float		NetUpdateFrequency;		// Of the class default object, 0 for non actor classes
+		uint32		NumReplicates;			// Times an actor of this class was considered for replication
+		uint32		NumSends;				// Times it actually wrote something
+		uint64		NumBits;
+		uint64		ReplicateCycles;
+		uint32		NumCompares;
+		uint64		CompareCycles;
+		uint32		NumRPCs;
+		uint64		RPCBits;
+	};
+
+	struct FPropertyStats
+	{
+		FPropertyStats() : NumSends( 0 ), NumBits( 0 ) {}
+
+		FString		Name;
+		uint32		NumSends;
+		uint64		NumBits;
+	};
+
+	struct FConnectionStats
+	{
+		FConnectionStats() : NumSends( 0 ), NumBits( 0 ), NumRPCs( 0 ), RPCBits( 0 ) {}
+
+		FString		Name;
+		uint32		NumSends;
+		uint64		NumBits;
+		uint32		NumRPCs;
+		uint64		RPCBits;
+	};
+
+	FClassStats&		FindOrAddClassStats( const UStruct* Owner );
+	FConnectionStats&	FindOrAddConnectionStats( const UNetConnection* Connection );
+
+	/** Prints the top MaxRows of each table */
+	void Dump( FOutputDevice& Ar, int32 MaxRows ) const;
+
+	/** Writes every total to a new CSV in the profiling directory, returns the file name or an empty string on failure */
+	FString WriteCSV() const;
+
+	/** Seconds the current totals cover */
+	double GetElapsedTime() const;
+
+	TMap< TWeakObjectPtr< UStruct >, FClassStats >				ClassStats;
+	TMap< TWeakObjectPtr< UProperty >, FPropertyStats >			PropertyStats;
+	TMap< TWeakObjectPtr< UNetConnection >, FConnectionStats >	ConnectionStats;
+
+	/** FPlatformTime::Seconds() when the totals were last reset */
+	double		StartTime;
+
+	/** FPlatformTime::Seconds() when tracking was last disabled */
+	double		StopTime;
+
+	/** FPlatformTime::Seconds() when the last periodic CSV was written */
+	double		LastCSVTime;
+
+	bool		bIsTrackingEnabled;
+};
+
+/** Global replication profiler instance. */
+extern ENGINE_API FNetReplicationProfiler GNetReplicationProfiler;
+
+#else	// USE_NET_REPLICATION_PROFILER
+
+#define NET_REPLICATION_PROFILER(x)
+
+#endif
@@ -18,6 +18,20 @@ public:
 	uint32				IsConditional	: 1;
 };
 
+/** FRepSerializedChangelist
+ * The bits FRepLayout::SendProperties wrote for a change list, so other connections sending the same change list
+ * in the same frame can copy them instead of serializing the properties again
+ */
+class FRepSerializedChangelist
+{
+public:
+	FRepSerializedChangelist() : NumBits( 0 ) {}
+
+	TArray< uint16 >	Changed;
+	TArray< uint8 >		Buffer;
+	int64				NumBits;
+};
+
 /** FRepChangedPropertyTracker
  * This class is used to store the change list for a group of properties of a particular actor/object
  * This information is shared across connections when possible
@@ -25,7 +39,7 @@ public:
 class FRepChangedPropertyTracker : public IRepChangedPropertyTracker
 {
 public:
-	FRepChangedPropertyTracker() : LastReplicationGroupFrame( 0 ), LastReplicationFrame( 0 ), ActiveStatusChanged( false ), UnconditionalPropChanged( false ) { }
+	FRepChangedPropertyTracker() : LastReplicationGroupFrame( 0 ), LastReplicationFrame( 0 ), ActiveStatusChanged( false ), UnconditionalPropChanged( false ), SerializedChangelistFrame( 0 ) { }
 	virtual ~FRepChangedPropertyTracker() { }
 
 	virtual void SetCustomIsActiveOverride( const uint16 RepIndex, const bool bIsActive ) override
@@ -52,6 +66,11 @@ public:
 
 	uint32						ActiveStatusChanged;
 	bool						UnconditionalPropChanged;
+
+	static const int32					MAX_SERIALIZED_CHANGELISTS = 4;
+
+	uint32								SerializedChangelistFrame;		// Frame SerializedChangelists were written in, they are only valid during that frame
+	TArray< FRepSerializedChangelist >	SerializedChangelists;
 };
 
 class FRepLayout;
@@ -107,7 +126,8 @@ public:
 		NumNaks( 0 ),
 		OpenAckedCalled( false ),
 		AwakeFromDormancy( false ),
-		ActiveStatusChanged( 0 )
+		ActiveStatusChanged( 0 ),
+		LastPushCompareEpoch( 0 )
 	{ }
 
 	~FRepState();
@@ -139,6 +159,7 @@ public:
 	TArray< uint16 >				ConditionalLifetime;		// Properties the need to be checked conditionally (based on net initial, role, etc)
 	FReplicationFlags				RepFlags;
 	uint32							ActiveStatusChanged;
+	uint32							LastPushCompareEpoch;		// FNetPushModel epoch of the last property compare, 0 if never compared
 };
 
 enum ERepLayoutCmdType
@@ -172,7 +193,8 @@ enum ERepParentFlags
 	PARENT_IsLifetime			= ( 1 << 0 ),
 	PARENT_IsConditional		= ( 1 << 1 ),		// True if this property has a secondary condition to check
 	PARENT_IsConfig				= ( 1 << 2 ),		// True if this property is defaulted from a config file
-	PARENT_IsCustomDelta		= ( 1 << 3 )		// True if this property uses custom delta compression
+	PARENT_IsCustomDelta		= ( 1 << 3 ),		// True if this property uses custom delta compression
+	PARENT_IsPushBased			= ( 1 << 4 )		// True if this property is only compared once marked dirty (see FNetPushModel)
 };
 
 class FRepParentCmd
@@ -219,7 +241,9 @@ public:
 		Writer( InWriter ), 
 		Changed( InChanged ),
 		CurrentChanged( 0 ),
-		bDoChecksum( bInDoChecksum )
+		bDoChecksum( bInDoChecksum ),
+		bStoreOnly( false ),
+		bCanShareSerialization( true )
 	{
 	}
 
@@ -227,6 +251,8 @@ public:
 	TArray< uint16 > &	Changed;
 	int32				CurrentChanged;
 	bool				bDoChecksum;
+	bool				bStoreOnly;					// Only update the shadow state, the bits were copied from a FRepSerializedChangelist
+	bool				bCanShareSerialization;		// False once a property that serializes differently per connection was written
 };
 
 /** FRepLayout
@@ -352,7 +378,8 @@ private:
 		const uint8* RESTRICT				CompareData,
 		const uint8* RESTRICT				Data, 
 		TArray< FRepChangedParent > &		OutChangedParents,
-		const TArray< uint16 > &			PropertyList ) const;
+		const TArray< uint16 > &			PropertyList,
+		const uint32						PushSinceEpoch = 0 ) const;
 
 	void SendProperties_DynamicArray_r( 
 		FRepState *	RESTRICT		RepState, 
@@ -373,6 +400,8 @@ private:
 		const uint8* RESTRICT		Data, 
 		uint16						Handle ) const;
 
+	bool CanShareSerialization( const FRepLayoutCmd & Cmd ) const;
+
 	void UpdateUnmappedObjects_r( 
 		FRepState *			RepState, 
 		FUnmappedGuidMgr *	UnmappedGuids, 
@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include "Net/NetPushModel.h"
+
 class	UChannel;
 class	UControlChannel;
 class	UActorChannel;
@@ -104,6 +106,36 @@ static UProperty* GetReplicatedProperty(UClass* CallingClass, UClass* PropClass,
 	}																					\
 }
 
+/**
+ * Push based versions of DOREPLIFETIME and DOREPLIFETIME_CONDITION.
+ * The property is only compared against the shadow state after gamecode called MARK_PROPERTY_DIRTY on it,
+ * so every write to the property must be followed by MARK_PROPERTY_DIRTY.
+ */
+#define DOREPLIFETIME_PUSH(c,v) \
+{ \
+	static UProperty* sp##v = GetReplicatedProperty(StaticClass(), c::StaticClass(),GET_MEMBER_NAME_CHECKED(c,v)); \
+	for ( int32 i = 0; i < sp##v->ArrayDim; i++ )											\
+	{																						\
+		OutLifetimeProps.AddUnique( FLifetimeProperty( sp##v->RepIndex + i, COND_None, REPNOTIFY_OnChanged, true ) );	\
+	}																						\
+}
+
+#define DOREPLIFETIME_CONDITION_PUSH(c,v,cond) \
+{ \
+	static UProperty* sp##v = GetReplicatedProperty(StaticClass(), c::StaticClass(),GET_MEMBER_NAME_CHECKED(c,v)); \
+	for ( int32 i = 0; i < sp##v->ArrayDim; i++ )											\
+	{																						\
+		OutLifetimeProps.AddUnique( FLifetimeProperty( sp##v->RepIndex + i, cond, REPNOTIFY_OnChanged, true ) );	\
+	}																						\
+}
+
+/** Flags a push based property of Object (of class c) as changed so it is compared on the next net update */
+#define MARK_PROPERTY_DIRTY(Object,c,v) \
+{ \
+	static UProperty* sp##v = FindFieldChecked<UProperty>(c::StaticClass(),GET_MEMBER_NAME_CHECKED(c,v)); \
+	FNetPushModel::MarkPropertyDirty( Object, sp##v->RepIndex, sp##v->ArrayDim ); \
+}
+
 #define DOREPLIFETIME_ACTIVE_OVERRIDE(c,v,active)	\
 {													\
 	static UProperty* sp##v = GetReplicatedProperty(StaticClass(), c::StaticClass(),GET_MEMBER_NAME_CHECKED(c,v)); \
@@ -0,0 +1,277 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "JsonPrivatePCH.h"
+#include "AutomationTest.h"
+
+
+/* Internal helpers
+ *****************************************************************************/
+
+namespace JsonBufferTest
+{
+	/** Writes the same document with any writer having the TJsonWriter interface. */
+	template <class WriterType>
+	void WriteDocument( WriterType& Writer, int32 NumEntries )
+	{
+		Writer.WriteObjectStart();
+		Writer.WriteValue(TEXT("Name"), FString(TEXT("Json \"buffer\" test\r\n\t\\ \x00E9\x4E2D")));
+		Writer.WriteValue(TEXT("Version"), 3);
+		Writer.WriteValue(TEXT("Enabled"), true);
+		Writer.WriteNull(TEXT("Nothing"));
+		Writer.WriteArrayStart(TEXT("Entries"));
+
+		for (int32 Index = 0; Index < NumEntries; ++Index)
+		{
+			Writer.WriteObjectStart();
+			Writer.WriteValue(TEXT("Id"), (int64)Index * 1000003);
+			Writer.WriteValue(TEXT("Label"), FString::Printf(TEXT("Entry %d"), Index));
+			Writer.WriteValue(TEXT("Weight"), Index * 0.25 - 7.5);
+			Writer.WriteValue(TEXT("Visible"), (Index % 3) != 0);
+			Writer.WriteArrayStart(TEXT("Position"));
+			Writer.WriteValue((double)Index);
+			Writer.WriteValue(Index * -2.0);
+			Writer.WriteValue(1.0e-3);
+			Writer.WriteArrayEnd();
+			Writer.WriteArrayStart(TEXT("Tags"));
+			Writer.WriteValue(FString(TEXT("first")));
+			Writer.WriteValue(FString(TEXT("second")));
+			Writer.WriteArrayEnd();
+			Writer.WriteArrayStart(TEXT("Empty"));
+			Writer.WriteArrayEnd();
+			Writer.WriteObjectEnd();
+		}
+
+		Writer.WriteArrayEnd();
+		Writer.WriteObjectEnd();
+	}
+
+	/** Counts values and sums up numbers and string lengths, to compare readers. */
+	struct FCountingHandler
+	{
+		FCountingHandler()
+			: NumValues(0)
+			, NumberSum(0.0)
+			, StringLengthSum(0)
+		{ }
+
+		bool OnObjectStart( const TJsonStringSpan<TCHAR>& Identifier ) { ++NumValues; return true; }
+		bool OnObjectEnd() { return true; }
+		bool OnArrayStart( const TJsonStringSpan<TCHAR>& Identifier ) { ++NumValues; return true; }
+		bool OnArrayEnd() { return true; }
+		bool OnString( const TJsonStringSpan<TCHAR>& Identifier, const TJsonStringSpan<TCHAR>& Value ) { ++NumValues; StringLengthSum += Value.Len; return true; }
+		bool OnNumber( const TJsonStringSpan<TCHAR>& Identifier, double Value ) { ++NumValues; NumberSum += Value; return true; }
+		bool OnBoolean( const TJsonStringSpan<TCHAR>& Identifier, bool Value ) { ++NumValues; return true; }
+		bool OnNull( const TJsonStringSpan<TCHAR>& Identifier ) { ++NumValues; return true; }
+
+		int32 NumValues;
+		double NumberSum;
+		int32 StringLengthSum;
+	};
+
+	/** Stops reading at the first number. */
+	struct FStoppingHandler : public FCountingHandler
+	{
+		bool OnNumber( const TJsonStringSpan<TCHAR>& Identifier, double Value ) { return false; }
+	};
+}
+
+
+/* Tests
+ *****************************************************************************/
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FJsonBufferReaderWriterTest, "Core.Json.BufferReaderWriter", EAutomationTestFlags::ATF_SmokeTest)
+
+bool FJsonBufferReaderWriterTest::RunTest( const FString& Parameters )
+{
+	// the buffer writer must produce exactly what TJsonWriter does
+	FString Expected;
+	{
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Expected);
+		JsonBufferTest::WriteDocument(*Writer, 16);
+		Writer->Close();
+	}
+
+	TArray<TCHAR> Buffer;
+	{
+		TJsonBufferWriter<> Writer(Buffer);
+		JsonBufferTest::WriteDocument(Writer, 16);
+		TestTrue(TEXT("Buffer writer must close"), Writer.Close());
+	}
+
+	TestEqual(TEXT("Buffer writer output must match TJsonWriter"), FString(Buffer.Num(), Buffer.GetData()), Expected);
+
+	FString ExpectedCondensed;
+	{
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&ExpectedCondensed);
+		JsonBufferTest::WriteDocument(*Writer, 4);
+		Writer->Close();
+	}
+
+	TArray<TCHAR> CondensedBuffer;
+	{
+		TJsonBufferWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>> Writer(CondensedBuffer);
+		JsonBufferTest::WriteDocument(Writer, 4);
+	}
+
+	TestEqual(TEXT("Condensed buffer writer output must match TJsonWriter"), FString(CondensedBuffer.Num(), CondensedBuffer.GetData()), ExpectedCondensed);
+
+	// the arena document must read back what FJsonSerializer does
+	TSharedPtr<FJsonObject> Object;
+	TestTrue(TEXT("FJsonSerializer must read the document"), FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Expected), Object) && Object.IsValid());
+
+	TJsonArenaDocument<> Document;
+	TestTrue(TEXT("Arena document must read the document"), Document.Parse(Buffer.GetData(), Buffer.Num()));
+
+	if (Object.IsValid() && (Document.GetRoot().Type == EJson::Object))
+	{
+		const TJsonArenaValue<TCHAR>& Root = Document.GetRoot();
+		const TJsonArenaValue<TCHAR>* Name = Root.Find(TEXT("Name"));
+		const TJsonArenaValue<TCHAR>* Entries = Root.Find(TEXT("Entries"));
+		const TArray<TSharedPtr<FJsonValue>>& ExpectedEntries = Object->GetArrayField(TEXT("Entries"));
+
+		TestTrue(TEXT("Escaped strings must be unescaped"), (Name != nullptr) && (Name->AsString() == Object->GetStringField(TEXT("Name"))));
+		TestTrue(TEXT("Null must be read"), (Root.Find(TEXT("Nothing")) != nullptr) && Root.Find(TEXT("Nothing"))->IsNull());
+		TestTrue(TEXT("Missing fields must not be found"), Root.Find(TEXT("Missing")) == nullptr);
+		TestTrue(TEXT("Arrays must have all elements"), (Entries != nullptr) && (Entries->Num() == ExpectedEntries.Num()));
+
+		for (int32 Index = 0; (Entries != nullptr) && (Index < Entries->Num()) && (Index < ExpectedEntries.Num()); ++Index)
+		{
+			const TJsonArenaValue<TCHAR>& Entry = (*Entries)[Index];
+			const TSharedPtr<FJsonObject>& ExpectedEntry = ExpectedEntries[Index]->AsObject();
+
+			TestEqual(TEXT("Integers must be read exactly"), Entry.Find(TEXT("Id"))->AsNumber(), ExpectedEntry->GetNumberField(TEXT("Id")));
+			TestEqual(TEXT("Fractions must be read exactly"), Entry.Find(TEXT("Weight"))->AsNumber(), ExpectedEntry->GetNumberField(TEXT("Weight")));
+			TestEqual(TEXT("Booleans must be read"), Entry.Find(TEXT("Visible"))->AsBool(), ExpectedEntry->GetBoolField(TEXT("Visible")));
+			TestEqual(TEXT("Strings must be read"), Entry.Find(TEXT("Label"))->AsString(), ExpectedEntry->GetStringField(TEXT("Label")));
+			TestEqual(TEXT("Nested arrays must be read"), (*Entry.Find(TEXT("Position")))[2].AsNumber(), 1.0e-3);
+			TestEqual(TEXT("Empty arrays must be read"), Entry.Find(TEXT("Empty"))->Num(), 0);
+		}
+	}
+
+	// UTF-8 round trip
+	{
+		TArray<ANSICHAR> Utf8;
+		TJsonBufferWriter<ANSICHAR, TCondensedJsonPrintPolicy<ANSICHAR>> Writer(Utf8);
+		Writer.WriteArrayStart();
+		Writer.WriteValue(FString(TEXT("\x00E9\x4E2D")));
+		Writer.WriteArrayEnd();
+
+		TestTrue(TEXT("Non-ASCII characters must be written as UTF-8"), (Utf8.Num() == 9) && ((uint8)Utf8[2] == 0xC3) && ((uint8)Utf8[3] == 0xA9));
+
+		TJsonArenaDocument<ANSICHAR> Utf8Document;
+		TestTrue(TEXT("UTF-8 documents must be read"), Utf8Document.Parse(Utf8.GetData(), Utf8.Num()) && (Utf8Document.GetRoot()[0].AsString() == TEXT("\x00E9\x4E2D")));
+
+		const ANSICHAR Escaped[] = "[\"\\u00e9\\ud83d\\ude00\"]";
+		TestTrue(TEXT("Escaped code points must be read as UTF-8"), Utf8Document.Parse(Escaped, ARRAY_COUNT(Escaped) - 1) && (Utf8Document.GetRoot()[0].AsSpan().Len == 6));
+	}
+
+	// errors
+	{
+		const TCHAR* InvalidDocuments[] =
+		{
+			TEXT(""),
+			TEXT("\"root\""),
+			TEXT("{\"a\": 1"),
+			TEXT("{\"a\" 1}"),
+			TEXT("{\"a\": 1 \"b\": 2}"),
+			TEXT("[01]"),
+			TEXT("[1.]"),
+			TEXT("[\"unterminated]"),
+			TEXT("[\"\\x\"]"),
+			TEXT("[nul]"),
+			TEXT("[1] [2]"),
+		};
+
+		for (int32 Index = 0; Index < (int32)ARRAY_COUNT(InvalidDocuments); ++Index)
+		{
+			TJsonArenaDocument<> InvalidDocument;
+			TestFalse(FString::Printf(TEXT("Invalid document %d must be rejected"), Index), InvalidDocument.Parse(InvalidDocuments[Index], FCString::Strlen(InvalidDocuments[Index])));
+			TestFalse(TEXT("Errors must be reported"), InvalidDocument.GetErrorMessage().IsEmpty());
+			TestEqual(TEXT("Error locations must be reported once"), InvalidDocument.GetErrorMessage().Find(TEXT(" Line: ")), InvalidDocument.GetErrorMessage().Find(TEXT(" Line: "), ESearchCase::CaseSensitive, ESearchDir::FromEnd));
+		}
+
+		const FString Stop(TEXT("[\"a\", 1, \"b\"]"));
+		JsonBufferTest::FStoppingHandler StoppingHandler;
+		TJsonBufferReader<> Reader(*Stop, Stop.Len());
+		TestFalse(TEXT("Handlers must be able to stop reading"), Reader.Read(StoppingHandler));
+		TestEqual(TEXT("Nothing must be read after stopping"), StoppingHandler.NumValues, 2);
+	}
+
+	return true;
+}
+
+
+/**
+ * Compares the buffer reader, arena document and buffer writer to TJsonReader, FJsonSerializer and
+ * TJsonWriter on a large document and logs the times.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FJsonBufferBenchmarkTest, "Core.Json.BufferBenchmark", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game | EAutomationTestFlags::ATF_Commandlet)
+
+bool FJsonBufferBenchmarkTest::RunTest( const FString& Parameters )
+{
+	const int32 NumEntries = 20000;
+	double StartTime;
+
+	// writing
+	FString Document;
+	StartTime = FPlatformTime::Seconds();
+	{
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Document);
+		JsonBufferTest::WriteDocument(*Writer, NumEntries);
+		Writer->Close();
+	}
+	const double WriterTime = FPlatformTime::Seconds() - StartTime;
+
+	TArray<TCHAR> Buffer;
+	StartTime = FPlatformTime::Seconds();
+	{
+		TJsonBufferWriter<> Writer(Buffer);
+		JsonBufferTest::WriteDocument(Writer, NumEntries);
+	}
+	const double BufferWriterTime = FPlatformTime::Seconds() - StartTime;
+
+	AddLogItem(FString::Printf(TEXT("Writing %d characters: TJsonWriter %.2f ms, TJsonBufferWriter %.2f ms"), Document.Len(), WriterTime * 1000.0, BufferWriterTime * 1000.0));
+
+	// reading
+	StartTime = FPlatformTime::Seconds();
+	int32 NumTokens = 0;
+	{
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Document);
+		EJsonNotation Notation;
+		while (Reader->ReadNext(Notation))
+		{
+			++NumTokens;
+		}
+		TestTrue(TEXT("TJsonReader must read the document"), Reader->GetErrorMessage().IsEmpty());
+	}
+	const double ReaderTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	JsonBufferTest::FCountingHandler Handler;
+	{
+		TJsonBufferReader<> Reader(*Document, Document.Len());
+		TestTrue(TEXT("TJsonBufferReader must read the document"), Reader.Read(Handler));
+	}
+	const double BufferReaderTime = FPlatformTime::Seconds() - StartTime;
+
+	AddLogItem(FString::Printf(TEXT("Reading %d tokens: TJsonReader %.2f ms, TJsonBufferReader %.2f ms"), NumTokens, ReaderTime * 1000.0, BufferReaderTime * 1000.0));
+
+	// building a DOM
+	StartTime = FPlatformTime::Seconds();
+	{
+		TSharedPtr<FJsonObject> Object;
+		TestTrue(TEXT("FJsonSerializer must read the document"), FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Document), Object));
+	}
+	const double SerializerTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	{
+		TJsonArenaDocument<> ArenaDocument;
+		TestTrue(TEXT("TJsonArenaDocument must read the document"), ArenaDocument.Parse(*Document, Document.Len()));
+	}
+	const double ArenaDocumentTime = FPlatformTime::Seconds() - StartTime;
+
+	AddLogItem(FString::Printf(TEXT("Building and freeing a DOM: FJsonSerializer %.2f ms, TJsonArenaDocument %.2f ms"), SerializerTime * 1000.0, ArenaDocumentTime * 1000.0));
+
+	return true;
+}
@@ -0,0 +1,295 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "JsonBufferReader.h"
+
+
+/**
+ * A value in a TJsonArenaDocument.
+ *
+ * Values are plain data owned by their document, the children of an object or array are
+ * stored contiguously, in document order, and strings point into the document wherever possible.
+ *
+ * @param CharType The type of characters in the document, i.e. TCHAR, or ANSICHAR for UTF-8.
+ */
+template <class CharType>
+struct TJsonArenaValue
+{
+	typedef TJsonStringSpan<CharType> FSpan;
+
+	/** The type of this value, EJson::None only if the document failed to parse. */
+	EJson Type;
+
+	/** The identifier of this value in its parent object, empty in arrays. */
+	FSpan Identifier;
+
+	FORCEINLINE bool IsNull() const
+	{
+		return (Type == EJson::Null) || (Type == EJson::None);
+	}
+
+	FORCEINLINE const FSpan& AsSpan() const
+	{
+		check(Type == EJson::String);
+		return String;
+	}
+
+	FORCEINLINE FString AsString() const
+	{
+		return AsSpan().ToString();
+	}
+
+	FORCEINLINE double AsNumber() const
+	{
+		check(Type == EJson::Number);
+		return Number;
+	}
+
+	FORCEINLINE bool AsBool() const
+	{
+		check(Type == EJson::Boolean);
+		return bBoolean;
+	}
+
+	/** @return The number of children of an object or array, zero for anything else. */
+	FORCEINLINE int32 Num() const
+	{
+		return NumChildren;
+	}
+
+	FORCEINLINE const TJsonArenaValue& operator[]( int32 Index ) const
+	{
+		check((Index >= 0) && (Index < NumChildren));
+		return Children[Index];
+	}
+
+	/**
+	 * Finds a field of an object by a linear search, the first one wins if there are several.
+	 *
+	 * @param FieldName The case sensitive name of the field.
+	 * @return The field, or nullptr if there is none or this isn't an object.
+	 */
+	const TJsonArenaValue* Find( const TCHAR* FieldName ) const
+	{
+		if (Type == EJson::Object)
+		{
+			for (int32 Index = 0; Index < NumChildren; ++Index)
+			{
+				if (Children[Index].Identifier.Equals(FieldName))
+				{
+					return &Children[Index];
+				}
+			}
+		}
+
+		return nullptr;
+	}
+
+public:
+
+	FSpan String;
+	double Number;
+	bool bBoolean;
+	const TJsonArenaValue* Children;
+	int32 NumChildren;
+};
+
+
+/**
+ * A read-only Json document allocated in a memory arena.
+ *
+ * Parses with TJsonBufferReader into values owned by a single FMemStackBase, so that building the
+ * document takes a handful of allocations and freeing it takes none per value, unlike FJsonObject
+ * and FJsonValue, which are reference counted and allocated individually. Strings without escape
+ * sequences point into the source buffer, which therefore has to outlive the document.
+ *
+ * @param CharType The type of characters in the document, i.e. TCHAR, or ANSICHAR for UTF-8.
+ */
+template <class CharType = TCHAR>
+class TJsonArenaDocument
+{
+public:
+
+	typedef TJsonArenaValue<CharType> FValue;
+
+	TJsonArenaDocument()
+		: Arena(0)
+	{
+		Root.Type = EJson::None;
+		Root.NumChildren = 0;
+		Root.Children = nullptr;
+	}
+
+	/**
+	 * Parses a document, discarding the previous one.
+	 *
+	 * @param Data The document, doesn't need to be null-terminated.
+	 * @param Len The number of characters in the document.
+	 * @return true on success, see GetErrorMessage otherwise.
+	 */
+	bool Parse( const CharType* Data, int32 Len )
+	{
+		Arena.Flush();
+		Root.Type = EJson::None;
+		Root.NumChildren = 0;
+		Root.Children = nullptr;
+
+		TJsonBufferReader<CharType> Reader(Data, Len);
+		FBuilder Builder(Reader, Arena);
+
+		if (!Reader.Read(Builder))
+		{
+			Arena.Flush();
+			ErrorMessage = Reader.GetErrorMessage();
+
+			return false;
+		}
+
+		check(Builder.Values.Num() == 1);
+		Root = Builder.Values[0];
+		ErrorMessage.Empty();
+
+		return true;
+	}
+
+	/** @return The root object or array, of type EJson::None if nothing was parsed successfully. */
+	FORCEINLINE const FValue& GetRoot() const
+	{
+		return Root;
+	}
+
+	FORCEINLINE const FString& GetErrorMessage() const
+	{
+		return ErrorMessage;
+	}
+
+	/** @return The number of bytes used by the values and copied strings. */
+	FORCEINLINE int32 GetAllocatedSize() const
+	{
+		return Arena.GetByteCount();
+	}
+
+private:
+
+	/** Builds the values from the reader's callbacks, completed objects and arrays are moved into the arena. */
+	struct FBuilder
+	{
+		FBuilder( const TJsonBufferReader<CharType>& InReader, FMemStackBase& InArena )
+			: Reader(InReader)
+			, Arena(InArena)
+		{ }
+
+		bool OnObjectStart( const TJsonStringSpan<CharType>& Identifier )
+		{
+			return BeginScope(Identifier, EJson::Object);
+		}
+
+		bool OnObjectEnd()
+		{
+			return EndScope();
+		}
+
+		bool OnArrayStart( const TJsonStringSpan<CharType>& Identifier )
+		{
+			return BeginScope(Identifier, EJson::Array);
+		}
+
+		bool OnArrayEnd()
+		{
+			return EndScope();
+		}
+
+		bool OnString( const TJsonStringSpan<CharType>& Identifier, const TJsonStringSpan<CharType>& Value )
+		{
+			AddValue(Identifier, EJson::String).String = Persist(Value);
+			return true;
+		}
+
+		bool OnNumber( const TJsonStringSpan<CharType>& Identifier, double Value )
+		{
+			AddValue(Identifier, EJson::Number).Number = Value;
+			return true;
+		}
+
+		bool OnBoolean( const TJsonStringSpan<CharType>& Identifier, bool Value )
+		{
+			AddValue(Identifier, EJson::Boolean).bBoolean = Value;
+			return true;
+		}
+
+		bool OnNull( const TJsonStringSpan<CharType>& Identifier )
+		{
+			AddValue(Identifier, EJson::Null);
+			return true;
+		}
+
+		FValue& AddValue( const TJsonStringSpan<CharType>& Identifier, EJson Type )
+		{
+			FValue& Value = Values[Values.AddUninitialized()];
+
+			Value.Type = Type;
+			Value.Identifier = Persist(Identifier);
+			Value.Children = nullptr;
+			Value.NumChildren = 0;
+
+			return Value;
+		}
+
+		bool BeginScope( const TJsonStringSpan<CharType>& Identifier, EJson Type )
+		{
+			AddValue(Identifier, Type);
+			ScopeStarts.Push(Values.Num());
+
+			return true;
+		}
+
+		bool EndScope()
+		{
+			const int32 FirstChild = ScopeStarts.Pop(false);
+			const int32 NumChildren = Values.Num() - FirstChild;
+			FValue& Parent = Values[FirstChild - 1];
+
+			if (NumChildren > 0)
+			{
+				FValue* Children = (FValue*)Arena.PushBytes(NumChildren * sizeof(FValue), ALIGNOF(FValue));
+				FMemory::Memcpy(Children, &Values[FirstChild], NumChildren * sizeof(FValue));
+
+				Parent.Children = Children;
+				Parent.NumChildren = NumChildren;
+				Values.RemoveAt(FirstChild, NumChildren, false);
+			}
+
+			return true;
+		}
+
+		/** Copies a string into the arena unless it points into the document. */
+		TJsonStringSpan<CharType> Persist( const TJsonStringSpan<CharType>& Span )
+		{
+			if (Span.IsEmpty() || Reader.IsInDocument(Span))
+			{
+				return Span;
+			}
+
+			CharType* Copy = (CharType*)Arena.PushBytes(Span.Len * sizeof(CharType), ALIGNOF(CharType));
+			FMemory::Memcpy(Copy, Span.Data, Span.Len * sizeof(CharType));
+
+			return TJsonStringSpan<CharType>(Copy, Span.Len);
+		}
+
+		const TJsonBufferReader<CharType>& Reader;
+		FMemStackBase& Arena;
+
+		/** Values of the scopes being read, each followed by its children read so far. */
+		TArray<FValue> Values;
+
+		/** Index in Values of the first child of each scope being read. */
+		TArray<int32> ScopeStarts;
+	};
+
+private:
+
+	FMemStackBase Arena;
+	FValue Root;
+	FString ErrorMessage;
+};
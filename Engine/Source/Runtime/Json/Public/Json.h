@@ -26,3 +26,7 @@ JSON_API DECLARE_LOG_CATEGORY_EXTERN(LogJson, Log, All);
 #include "JsonReader.h"
 #include "JsonWriter.h"
 #include "JsonSerializer.h"
+
+#include "JsonBufferReader.h"
+#include "JsonBufferWriter.h"
+#include "JsonArenaDocument.h"
@@ -15,4 +15,8 @@ struct TCondensedJsonPrintPolicy
 	static inline void WriteLineTerminator(FArchive* Stream) {}
 	static inline void WriteTabs(FArchive* Stream, int32 Count) {}
 	static inline void WriteSpace(FArchive* Stream) {}
+
+	static inline void WriteLineTerminator(TArray<CharType>& Buffer) {}
+	static inline void WriteTabs(TArray<CharType>& Buffer, int32 Count) {}
+	static inline void WriteSpace(TArray<CharType>& Buffer) {}
 };
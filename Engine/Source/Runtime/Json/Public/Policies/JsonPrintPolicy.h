@@ -37,6 +37,31 @@ struct TJsonPrintPolicy
 			WriteChar(Stream, *CharPtr);
 		}
 	}
+
+	/**
+	 * Appends a single character to a buffer.
+	 *
+	 * @param Buffer The buffer to append to.
+	 * @param Char The character to write.
+	 */
+	static FORCEINLINE void WriteChar( TArray<CharType>& Buffer, CharType Char )
+	{
+		Buffer.Add(Char);
+	}
+
+	/**
+	 * Appends a string of ASCII characters to a buffer.
+	 *
+	 * @param Buffer The buffer to append to.
+	 * @param String The null-terminated string to write.
+	 */
+	static inline void WriteString( TArray<CharType>& Buffer, const TCHAR* String )
+	{
+		for (const TCHAR* CharPtr = String; *CharPtr != TCHAR('\0'); ++CharPtr)
+		{
+			Buffer.Add((CharType)*CharPtr);
+		}
+	}
 };
 
 
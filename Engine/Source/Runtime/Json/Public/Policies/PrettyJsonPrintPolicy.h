@@ -31,4 +31,24 @@ struct TPrettyJsonPrintPolicy
 	{
 		TJsonPrintPolicy<CharType>::WriteChar(Stream, CharType(' '));
 	}
+
+	static inline void WriteLineTerminator( TArray<CharType>& Buffer )
+	{
+		TJsonPrintPolicy<CharType>::WriteString(Buffer, LINE_TERMINATOR);
+	}
+
+	static inline void WriteTabs( TArray<CharType>& Buffer, int32 Count )
+	{
+		const int32 Start = Buffer.AddUninitialized(Count);
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Buffer[Start + i] = CharType('\t');
+		}
+	}
+
+	static inline void WriteSpace( TArray<CharType>& Buffer )
+	{
+		Buffer.Add(CharType(' '));
+	}
 };
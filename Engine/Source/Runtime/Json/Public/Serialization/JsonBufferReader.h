@@ -0,0 +1,772 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+
+/**
+ * A string in a Json document, pointing into the document if it had no escape sequences,
+ * or into a buffer of the reader otherwise. Not null-terminated.
+ *
+ * @param CharType The type of characters, i.e. TCHAR, or ANSICHAR for UTF-8.
+ */
+template <class CharType>
+struct TJsonStringSpan
+{
+	TJsonStringSpan()
+		: Data(nullptr)
+		, Len(0)
+	{ }
+
+	TJsonStringSpan( const CharType* InData, int32 InLen )
+		: Data(InData)
+		, Len(InLen)
+	{ }
+
+	FORCEINLINE bool IsEmpty() const
+	{
+		return Len == 0;
+	}
+
+	/** Copies the string, converting it from UTF-8 if needed. */
+	FString ToString() const
+	{
+		if (sizeof(CharType) == sizeof(TCHAR))
+		{
+			return FString(Len, (const TCHAR*)Data);
+		}
+
+		FUTF8ToTCHAR Converted((const ANSICHAR*)Data, Len);
+		return FString(Converted.Length(), Converted.Get());
+	}
+
+	/** Case sensitive comparison to a string, converting it to UTF-8 if needed. */
+	bool Equals( const TCHAR* Other ) const
+	{
+		if (sizeof(CharType) == sizeof(TCHAR))
+		{
+			return FCString::Strncmp((const TCHAR*)Data, Other, Len) == 0 && Other[Len] == TCHAR('\0');
+		}
+
+		FTCHARToUTF8 Converted(Other);
+		return Converted.Length() == Len && FMemory::Memcmp(Data, Converted.Get(), Len) == 0;
+	}
+
+	const CharType* Data;
+	int32 Len;
+};
+
+
+/**
+ * Reads a Json document from a contiguous buffer, calling a handler for every value, in order.
+ *
+ * Unlike TJsonReader, which reads one character at a time from an archive and copies every string,
+ * this tokenizes directly from the buffer, strings without escape sequences are passed to the handler
+ * without copying them, and nothing but escaped strings and the nesting stack is allocated. Line and
+ * character numbers are only worked out when an error is found.
+ *
+ * The handler is called directly, no virtual functions involved, and can be any class with these methods,
+ * each returning false to stop reading. Identifier is empty for array elements and the root value.
+ *
+ *		bool OnObjectStart( const TJsonStringSpan<CharType>& Identifier );
+ *		bool OnObjectEnd();
+ *		bool OnArrayStart( const TJsonStringSpan<CharType>& Identifier );
+ *		bool OnArrayEnd();
+ *		bool OnString( const TJsonStringSpan<CharType>& Identifier, const TJsonStringSpan<CharType>& Value );
+ *		bool OnNumber( const TJsonStringSpan<CharType>& Identifier, double Value );
+ *		bool OnBoolean( const TJsonStringSpan<CharType>& Identifier, bool Value );
+ *		bool OnNull( const TJsonStringSpan<CharType>& Identifier );
+ *
+ * Spans passed to the handler are only valid during the call, unless they point into the document, which
+ * can be checked with IsInDocument. The input must outlive the reader.
+ *
+ * @param CharType The type of characters in the buffer, i.e. TCHAR, or ANSICHAR for UTF-8.
+ */
+template <class CharType = TCHAR>
+class TJsonBufferReader
+{
+public:
+
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * @param InData The document, doesn't need to be null-terminated.
+	 * @param InLen The number of characters in the document.
+	 */
+	TJsonBufferReader( const CharType* InData, int32 InLen )
+		: Begin(InData)
+		, End(InData + InLen)
+		, Cur(InData)
+		, bNeedComma(false)
+		, LineNumber(1)
+		, CharacterNumber(0)
+	{ }
+
+	/**
+	 * Reads the whole document, calling the handler for every value.
+	 *
+	 * @param Handler The handler to call, see the class description.
+	 * @return true if the document is valid and the handler never stopped reading.
+	 */
+	template <class HandlerType>
+	bool Read( HandlerType& Handler )
+	{
+		Cur = Begin;
+		ParseState.Reset();
+		ErrorMessage.Empty();
+
+		const TJsonStringSpan<CharType> NoIdentifier;
+		TJsonStringSpan<CharType> Identifier;
+
+		SkipWhiteSpace();
+
+		if ((Cur == End) || ((*Cur != CharType('{')) && (*Cur != CharType('['))))
+		{
+			return SetErrorMessage(TEXT("Open Curly or Square Brace token expected, but not found."));
+		}
+
+		if (!ReadValue(Handler, NoIdentifier))
+		{
+			return false;
+		}
+
+		while (ParseState.Num() > 0)
+		{
+			SkipWhiteSpace();
+
+			if (Cur == End)
+			{
+				return SetErrorMessage(TEXT("Improperly formatted."));
+			}
+
+			const bool bInObject = (ParseState.Top() == EJson::Object);
+
+			if (*Cur == (bInObject ? CharType('}') : CharType(']')))
+			{
+				++Cur;
+				ParseState.Pop(false);
+				bNeedComma = true;
+
+				if (!(bInObject ? Handler.OnObjectEnd() : Handler.OnArrayEnd()))
+				{
+					return SetErrorMessage(TEXT("Reading was stopped by the handler."));
+				}
+
+				continue;
+			}
+
+			if (bNeedComma)
+			{
+				if (*Cur != CharType(','))
+				{
+					return SetErrorMessage(TEXT("Comma token expected, but not found."));
+				}
+
+				++Cur;
+				SkipWhiteSpace();
+			}
+
+			if (!bInObject)
+			{
+				if (!ReadValue(Handler, NoIdentifier))
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			if ((Cur == End) || (*Cur != CharType('\"')))
+			{
+				return SetErrorMessage(TEXT("String token expected, but not found."));
+			}
+
+			++Cur;
+
+			if (!ParseString(Identifier, IdentifierBuffer))
+			{
+				return false;
+			}
+
+			SkipWhiteSpace();
+
+			if ((Cur == End) || (*Cur != CharType(':')))
+			{
+				return SetErrorMessage(TEXT("Colon token expected, but not found."));
+			}
+
+			++Cur;
+			SkipWhiteSpace();
+
+			if (!ReadValue(Handler, Identifier))
+			{
+				return false;
+			}
+		}
+
+		// Buffers read from files or strings may have trailing null characters
+		SkipWhiteSpace();
+
+		while ((Cur < End) && (*Cur == CharType('\0')))
+		{
+			++Cur;
+		}
+
+		if (Cur != End)
+		{
+			return SetErrorMessage(TEXT("Unexpected additional input found."));
+		}
+
+		return true;
+	}
+
+	/** @return true if the span points into the document rather than into a buffer of the reader. */
+	FORCEINLINE bool IsInDocument( const TJsonStringSpan<CharType>& Span ) const
+	{
+		return (Span.Data >= Begin) && (Span.Data + Span.Len <= End);
+	}
+
+	FORCEINLINE const FString& GetErrorMessage() const
+	{
+		return ErrorMessage;
+	}
+
+	FORCEINLINE const uint32 GetLineNumber() const
+	{
+		return LineNumber;
+	}
+
+	FORCEINLINE const uint32 GetCharacterNumber() const
+	{
+		return CharacterNumber;
+	}
+
+private:
+
+	/** Works out the position of the error, and sets the error message like TJsonReader does. @return false */
+	bool SetErrorMessage( const TCHAR* Message )
+	{
+		LineNumber = 1;
+		CharacterNumber = 0;
+
+		for (const CharType* Char = Begin; Char < Cur; ++Char)
+		{
+			++CharacterNumber;
+
+			if (*Char == CharType('\n'))
+			{
+				++LineNumber;
+				CharacterNumber = 0;
+			}
+		}
+
+		ErrorMessage = FString(Message) + FString::Printf(TEXT(" Line: %u Ch: %u"), LineNumber, CharacterNumber);
+		return false;
+	}
+
+	/** Reads the value at the current position, pushing a scope for objects and arrays. */
+	template <class HandlerType>
+	bool ReadValue( HandlerType& Handler, const TJsonStringSpan<CharType>& Identifier )
+	{
+		if (Cur == End)
+		{
+			return SetErrorMessage(TEXT("Improperly formatted."));
+		}
+
+		bool bContinue = true;
+		const CharType Char = *Cur;
+
+		switch (Char)
+		{
+		case CharType('{'):
+			++Cur;
+			ParseState.Push(EJson::Object);
+			bNeedComma = false;
+			bContinue = Handler.OnObjectStart(Identifier);
+			break;
+
+		case CharType('['):
+			++Cur;
+			ParseState.Push(EJson::Array);
+			bNeedComma = false;
+			bContinue = Handler.OnArrayStart(Identifier);
+			break;
+
+		case CharType('\"'):
+			{
+				++Cur;
+
+				TJsonStringSpan<CharType> Value;
+
+				if (!ParseString(Value, ValueBuffer))
+				{
+					return false;
+				}
+
+				bNeedComma = true;
+				bContinue = Handler.OnString(Identifier, Value);
+			}
+			break;
+
+		case CharType('t'): case CharType('T'):
+		case CharType('f'): case CharType('F'):
+		case CharType('n'): case CharType('N'):
+			{
+				// Case insensitive, like TJsonReader
+				const CharType* Start = Cur;
+
+				while ((Cur < End) && IsAlpha(*Cur))
+				{
+					++Cur;
+				}
+
+				bNeedComma = true;
+
+				if (MatchesLiteral(Start, "true"))
+				{
+					bContinue = Handler.OnBoolean(Identifier, true);
+				}
+				else if (MatchesLiteral(Start, "false"))
+				{
+					bContinue = Handler.OnBoolean(Identifier, false);
+				}
+				else if (MatchesLiteral(Start, "null"))
+				{
+					bContinue = Handler.OnNull(Identifier);
+				}
+				else
+				{
+					Cur = Start;
+					return SetErrorMessage(TEXT("Invalid Json Token. Check that your member names have quotes around them!"));
+				}
+			}
+			break;
+
+		default:
+			{
+				if (!IsJsonNumber(Char))
+				{
+					return SetErrorMessage(TEXT("Invalid Json Token."));
+				}
+
+				double Value;
+
+				if (!ParseNumber(Value))
+				{
+					return false;
+				}
+
+				bNeedComma = true;
+				bContinue = Handler.OnNumber(Identifier, Value);
+			}
+			break;
+		}
+
+		if (!bContinue)
+		{
+			return SetErrorMessage(TEXT("Reading was stopped by the handler."));
+		}
+
+		return true;
+	}
+
+	/**
+	 * Parses a string, the current position being past the opening quote.
+	 *
+	 * @param OutString Will point into the document, or into Buffer if the string has escape sequences.
+	 * @param Buffer Buffer to unescape the string into.
+	 */
+	bool ParseString( TJsonStringSpan<CharType>& OutString, TArray<CharType>& Buffer )
+	{
+		const CharType* Start = Cur;
+		Cur = FindQuoteOrBackslash(Cur, End);
+
+		if ((Cur < End) && (*Cur == CharType('\"')))
+		{
+			OutString = TJsonStringSpan<CharType>(Start, Cur - Start);
+			++Cur;
+
+			return true;
+		}
+
+		Buffer.Reset();
+		Buffer.Append(Start, Cur - Start);
+
+		while (true)
+		{
+			if (Cur == End)
+			{
+				return SetErrorMessage(TEXT("String Token Abruptly Ended."));
+			}
+
+			if (*Cur == CharType('\"'))
+			{
+				++Cur;
+				break;
+			}
+
+			// Escape sequence
+			if (++Cur == End)
+			{
+				return SetErrorMessage(TEXT("String Token Abruptly Ended."));
+			}
+
+			switch (*Cur++)
+			{
+			case CharType('\"'): Buffer.Add(CharType('\"')); break;
+			case CharType('\\'): Buffer.Add(CharType('\\')); break;
+			case CharType('/'): Buffer.Add(CharType('/')); break;
+			case CharType('f'): Buffer.Add(CharType('\f')); break;
+			case CharType('r'): Buffer.Add(CharType('\r')); break;
+			case CharType('n'): Buffer.Add(CharType('\n')); break;
+			case CharType('b'): Buffer.Add(CharType('\b')); break;
+			case CharType('t'): Buffer.Add(CharType('\t')); break;
+			case CharType('u'):
+				{
+					uint32 CodeUnit;
+
+					if (!ParseHex4(CodeUnit))
+					{
+						return false;
+					}
+
+					// A surrogate pair is one code point in UTF-8
+					if ((sizeof(CharType) == 1) && (CodeUnit >= 0xD800) && (CodeUnit < 0xDC00) && (End - Cur >= 6) && (Cur[0] == CharType('\\')) && (Cur[1] == CharType('u')))
+					{
+						const CharType* HighSurrogateEnd = Cur;
+						uint32 LowSurrogate;
+						Cur += 2;
+
+						if (ParseHex4(LowSurrogate) && (LowSurrogate >= 0xDC00) && (LowSurrogate < 0xE000))
+						{
+							CodeUnit = 0x10000 + ((CodeUnit - 0xD800) << 10) + (LowSurrogate - 0xDC00);
+						}
+						else
+						{
+							Cur = HighSurrogateEnd;
+							ErrorMessage.Empty();
+						}
+					}
+
+					AppendCodePoint(Buffer, CodeUnit);
+				}
+				break;
+
+			default:
+				--Cur;
+				return SetErrorMessage(TEXT("Bad Json escaped char."));
+			}
+
+			const CharType* RunStart = Cur;
+			Cur = FindQuoteOrBackslash(Cur, End);
+			Buffer.Append(RunStart, Cur - RunStart);
+		}
+
+		OutString = TJsonStringSpan<CharType>(Buffer.GetData(), Buffer.Num());
+
+		return true;
+	}
+
+	/** Parses the 4 hex digits of a \u escape sequence. */
+	bool ParseHex4( uint32& OutValue )
+	{
+		if (End - Cur < 4)
+		{
+			Cur = End;
+			return SetErrorMessage(TEXT("String Token Abruptly Ended."));
+		}
+
+		OutValue = 0;
+
+		for (int32 DigitIndex = 0; DigitIndex < 4; ++DigitIndex, ++Cur)
+		{
+			const CharType Char = *Cur;
+			uint32 Digit;
+
+			if ((Char >= CharType('0')) && (Char <= CharType('9')))
+			{
+				Digit = Char - CharType('0');
+			}
+			else if ((Char >= CharType('a')) && (Char <= CharType('f')))
+			{
+				Digit = Char - CharType('a') + 10;
+			}
+			else if ((Char >= CharType('A')) && (Char <= CharType('F')))
+			{
+				Digit = Char - CharType('A') + 10;
+			}
+			else
+			{
+				return SetErrorMessage(TEXT("Invalid Hexadecimal digit parsed."));
+			}
+
+			OutValue = (OutValue << 4) | Digit;
+		}
+
+		return true;
+	}
+
+	/** Appends a code point as UTF-8, or as a single TCHAR like TJsonReader. */
+	static void AppendCodePoint( TArray<CharType>& Buffer, uint32 CodePoint )
+	{
+		if (sizeof(CharType) != 1)
+		{
+			Buffer.Add((CharType)CodePoint);
+		}
+		else if (CodePoint < 0x80)
+		{
+			Buffer.Add((CharType)CodePoint);
+		}
+		else if (CodePoint < 0x800)
+		{
+			Buffer.Add((CharType)(0xC0 | (CodePoint >> 6)));
+			Buffer.Add((CharType)(0x80 | (CodePoint & 0x3F)));
+		}
+		else if (CodePoint < 0x10000)
+		{
+			Buffer.Add((CharType)(0xE0 | (CodePoint >> 12)));
+			Buffer.Add((CharType)(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Buffer.Add((CharType)(0x80 | (CodePoint & 0x3F)));
+		}
+		else
+		{
+			Buffer.Add((CharType)(0xF0 | (CodePoint >> 18)));
+			Buffer.Add((CharType)(0x80 | ((CodePoint >> 12) & 0x3F)));
+			Buffer.Add((CharType)(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Buffer.Add((CharType)(0x80 | (CodePoint & 0x3F)));
+		}
+	}
+
+	/**
+	 * Parses a number with the same validation as TJsonReader, the current position being at its first character.
+	 * Integers short enough to be exact in a double are converted here, anything else by FCString::Atod.
+	 */
+	bool ParseNumber( double& OutValue )
+	{
+		const CharType* Start = Cur;
+
+		while ((Cur < End) && IsJsonNumber(*Cur))
+		{
+			++Cur;
+		}
+
+		// This switch statement is derived from a finite state automata derived from the Json spec
+		int32 State = 0;
+		bool bIsInteger = true;
+
+		for (const CharType* Char = Start; Char < Cur; ++Char)
+		{
+			const CharType C = *Char;
+
+			switch (State)
+			{
+			case 0:
+				if (C == CharType('-')) { State = 1; }
+				else if (C == CharType('0')) { State = 2; }
+				else if (IsNonZeroDigit(C)) { State = 3; }
+				else { State = -1; }
+				break;
+
+			case 1:
+				if (C == CharType('0')) { State = 2; }
+				else if (IsNonZeroDigit(C)) { State = 3; }
+				else { State = -1; }
+				break;
+
+			case 2:
+				if (C == CharType('.')) { State = 4; }
+				else if ((C == CharType('e')) || (C == CharType('E'))) { State = 5; }
+				else { State = -1; }
+				break;
+
+			case 3:
+				if (IsDigit(C)) { State = 3; }
+				else if (C == CharType('.')) { State = 4; }
+				else if ((C == CharType('e')) || (C == CharType('E'))) { State = 5; }
+				else { State = -1; }
+				break;
+
+			case 4:
+				if (IsDigit(C)) { State = 6; }
+				else { State = -1; }
+				break;
+
+			case 5:
+				if ((C == CharType('-')) || (C == CharType('+'))) { State = 7; }
+				else if (IsDigit(C)) { State = 8; }
+				else { State = -1; }
+				break;
+
+			case 6:
+				if (IsDigit(C)) { State = 6; }
+				else if ((C == CharType('e')) || (C == CharType('E'))) { State = 5; }
+				else { State = -1; }
+				break;
+
+			case 7:
+			case 8:
+				if (IsDigit(C)) { State = 8; }
+				else { State = -1; }
+				break;
+			}
+
+			if (State < 0)
+			{
+				break;
+			}
+
+			bIsInteger &= (State < 4);
+		}
+
+		if ((State != 2) && (State != 3) && (State != 6) && (State != 8))
+		{
+			return SetErrorMessage(TEXT("Poorly formed Json Number Token."));
+		}
+
+		const int32 Len = Cur - Start;
+		const bool bNegative = (*Start == CharType('-'));
+
+		// 15 digits always fit in the 53 bits of a double's mantissa
+		if (bIsInteger && (Len - (bNegative ? 1 : 0) <= 15))
+		{
+			int64 Integer = 0;
+
+			for (const CharType* Char = Start + (bNegative ? 1 : 0); Char < Cur; ++Char)
+			{
+				Integer = Integer * 10 + (*Char - CharType('0'));
+			}
+
+			OutValue = (double)(bNegative ? -Integer : Integer);
+
+			return true;
+		}
+
+		TCHAR Buffer[64];
+
+		if (Len < (int32)ARRAY_COUNT(Buffer))
+		{
+			for (int32 Index = 0; Index < Len; ++Index)
+			{
+				Buffer[Index] = (TCHAR)Start[Index];
+			}
+
+			Buffer[Len] = TCHAR('\0');
+			OutValue = FCString::Atod(Buffer);
+		}
+		else
+		{
+			FString String;
+
+			for (const CharType* Char = Start; Char < Cur; ++Char)
+			{
+				String += (TCHAR)*Char;
+			}
+
+			OutValue = FCString::Atod(*String);
+		}
+
+		return true;
+	}
+
+	/** @return true if the characters from Start to the current position are the lower case Literal, ignoring case. */
+	FORCEINLINE bool MatchesLiteral( const CharType* Start, const ANSICHAR* Literal ) const
+	{
+		const CharType* Char = Start;
+
+		for (; (Char < Cur) && (*Literal != '\0'); ++Char, ++Literal)
+		{
+			if ((*Char | 0x20) != *Literal)
+			{
+				return false;
+			}
+		}
+
+		return (Char == Cur) && (*Literal == '\0');
+	}
+
+	/**
+	 * Finds the end of a run of string characters. UTF-8 is checked eight characters at a time, see
+	 * "Determine if a word has a byte equal to n" in http://graphics.stanford.edu/~seander/bithacks.html
+	 */
+	static FORCEINLINE const CharType* FindQuoteOrBackslash( const CharType* Char, const CharType* EndChar )
+	{
+		if (sizeof(CharType) == 1)
+		{
+			const uint64 Ones = 0x0101010101010101ULL;
+			const uint64 HighBits = 0x8080808080808080ULL;
+
+			while (EndChar - Char >= 8)
+			{
+				uint64 Word;
+				FMemory::Memcpy(&Word, Char, sizeof(Word));
+
+				const uint64 Quotes = Word ^ (Ones * '\"');
+				const uint64 Backslashes = Word ^ (Ones * '\\');
+
+				if ((((Quotes - Ones) & ~Quotes) | ((Backslashes - Ones) & ~Backslashes)) & HighBits)
+				{
+					break;
+				}
+
+				Char += 8;
+			}
+		}
+
+		while ((Char < EndChar) && (*Char != CharType('\"')) && (*Char != CharType('\\')))
+		{
+			++Char;
+		}
+
+		return Char;
+	}
+
+	FORCEINLINE void SkipWhiteSpace()
+	{
+		while ((Cur < End) && IsWhitespace(*Cur))
+		{
+			++Cur;
+		}
+	}
+
+	static FORCEINLINE bool IsWhitespace( CharType Char )
+	{
+		return (Char == CharType(' ')) || (Char == CharType('\t')) || (Char == CharType('\n')) || (Char == CharType('\r'));
+	}
+
+	static FORCEINLINE bool IsJsonNumber( CharType Char )
+	{
+		return ((Char >= CharType('0')) && (Char <= CharType('9'))) ||
+			(Char == CharType('-')) || (Char == CharType('.')) || (Char == CharType('+')) || (Char == CharType('e')) || (Char == CharType('E'));
+	}
+
+	static FORCEINLINE bool IsDigit( CharType Char )
+	{
+		return (Char >= CharType('0')) && (Char <= CharType('9'));
+	}
+
+	static FORCEINLINE bool IsNonZeroDigit( CharType Char )
+	{
+		return (Char >= CharType('1')) && (Char <= CharType('9'));
+	}
+
+	static FORCEINLINE bool IsAlpha( CharType Char )
+	{
+		return ((Char >= CharType('a')) && (Char <= CharType('z'))) || ((Char >= CharType('A')) && (Char <= CharType('Z')));
+	}
+
+private:
+
+	const CharType* const Begin;
+	const CharType* const End;
+	const CharType* Cur;
+
+	TArray<EJson> ParseState;
+	bool bNeedComma;
+
+	/** Unescaped identifier, kept apart as it is passed along with the value following it. */
+	TArray<CharType> IdentifierBuffer;
+	TArray<CharType> ValueBuffer;
+
+	FString ErrorMessage;
+	uint32 LineNumber;
+	uint32 CharacterNumber;
+};
@@ -0,0 +1,431 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+
+/**
+ * Json writer appending directly to a buffer of characters.
+ *
+ * Produces the same output as TJsonWriter with the same print policy, without going through an archive
+ * one character at a time, virtual functions, or temporary strings for escaping and numbers. Reserve
+ * the buffer up front to avoid any allocation. With ANSICHAR, strings are written as UTF-8, matching
+ * TJsonBufferReader.
+ *
+ * @param CharType The type of characters to print, i.e. TCHAR, or ANSICHAR for UTF-8.
+ * @param PrintPolicy The print policy to use when writing the output string (default = TPrettyJsonPrintPolicy).
+ */
+template <class CharType = TCHAR, class PrintPolicy = TPrettyJsonPrintPolicy<CharType> >
+class TJsonBufferWriter
+{
+public:
+
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * @param InBuffer The buffer to append to, it isn't emptied.
+	 * @param InitialIndentLevel The initial indentation level.
+	 */
+	TJsonBufferWriter( TArray<CharType>& InBuffer, int32 InitialIndentLevel = 0 )
+		: Buffer(InBuffer)
+		, Stack()
+		, PreviousTokenWritten(EJsonToken::None)
+		, IndentLevel(InitialIndentLevel)
+	{ }
+
+	FORCEINLINE int32 GetIndentLevel() const { return IndentLevel; }
+
+	void WriteObjectStart()
+	{
+		check(CanWriteValueWithoutIdentifier());
+		if (PreviousTokenWritten != EJsonToken::None)
+		{
+			WriteCommaIfNeeded();
+			PrintPolicy::WriteLineTerminator(Buffer);
+			PrintPolicy::WriteTabs(Buffer, IndentLevel);
+		}
+
+		PrintPolicy::WriteChar(Buffer, CharType('{'));
+		++IndentLevel;
+		Stack.Push(EJson::Object);
+		PreviousTokenWritten = EJsonToken::CurlyOpen;
+	}
+
+	void WriteObjectStart( const TCHAR* Identifier )
+	{
+		check(Stack.Top() == EJson::Object);
+		WriteIdentifier(Identifier);
+
+		PrintPolicy::WriteLineTerminator(Buffer);
+		PrintPolicy::WriteTabs(Buffer, IndentLevel);
+		PrintPolicy::WriteChar(Buffer, CharType('{'));
+		++IndentLevel;
+		Stack.Push(EJson::Object);
+		PreviousTokenWritten = EJsonToken::CurlyOpen;
+	}
+
+	void WriteObjectEnd()
+	{
+		check(Stack.Top() == EJson::Object);
+
+		PrintPolicy::WriteLineTerminator(Buffer);
+
+		--IndentLevel;
+		PrintPolicy::WriteTabs(Buffer, IndentLevel);
+		PrintPolicy::WriteChar(Buffer, CharType('}'));
+		Stack.Pop();
+		PreviousTokenWritten = EJsonToken::CurlyClose;
+	}
+
+	void WriteArrayStart()
+	{
+		check(CanWriteValueWithoutIdentifier());
+		if (PreviousTokenWritten != EJsonToken::None)
+		{
+			WriteCommaIfNeeded();
+			PrintPolicy::WriteLineTerminator(Buffer);
+			PrintPolicy::WriteTabs(Buffer, IndentLevel);
+		}
+
+		PrintPolicy::WriteChar(Buffer, CharType('['));
+		++IndentLevel;
+		Stack.Push(EJson::Array);
+		PreviousTokenWritten = EJsonToken::SquareOpen;
+	}
+
+	void WriteArrayStart( const TCHAR* Identifier )
+	{
+		check(Stack.Top() == EJson::Object);
+		WriteIdentifier(Identifier);
+
+		PrintPolicy::WriteSpace(Buffer);
+		PrintPolicy::WriteChar(Buffer, CharType('['));
+		++IndentLevel;
+		Stack.Push(EJson::Array);
+		PreviousTokenWritten = EJsonToken::SquareOpen;
+	}
+
+	void WriteArrayEnd()
+	{
+		check(Stack.Top() == EJson::Array);
+
+		--IndentLevel;
+		if (PreviousTokenWritten == EJsonToken::SquareClose || PreviousTokenWritten == EJsonToken::CurlyClose || PreviousTokenWritten == EJsonToken::String)
+		{
+			PrintPolicy::WriteLineTerminator(Buffer);
+			PrintPolicy::WriteTabs(Buffer, IndentLevel);
+		}
+		else if (PreviousTokenWritten != EJsonToken::SquareOpen)
+		{
+			PrintPolicy::WriteSpace(Buffer);
+		}
+
+		PrintPolicy::WriteChar(Buffer, CharType(']'));
+		Stack.Pop();
+		PreviousTokenWritten = EJsonToken::SquareClose;
+	}
+
+	void WriteValue( const TCHAR* Identifier, const bool Value )
+	{
+		WriteIdentifierPrefix(Identifier);
+		WriteBoolValue(Value);
+		PreviousTokenWritten = Value ? EJsonToken::True : EJsonToken::False;
+	}
+
+	void WriteValue( const TCHAR* Identifier, const double Value )
+	{
+		WriteIdentifierPrefix(Identifier);
+		WriteNumberValue(Value);
+		PreviousTokenWritten = EJsonToken::Number;
+	}
+
+	void WriteValue( const TCHAR* Identifier, const int32 Value )
+	{
+		WriteIdentifierPrefix(Identifier);
+		WriteIntegerValue(Value);
+		PreviousTokenWritten = EJsonToken::Number;
+	}
+
+	void WriteValue( const TCHAR* Identifier, const int64 Value )
+	{
+		WriteIdentifierPrefix(Identifier);
+		WriteIntegerValue(Value);
+		PreviousTokenWritten = EJsonToken::Number;
+	}
+
+	void WriteValue( const TCHAR* Identifier, const TCHAR* Value )
+	{
+		WriteIdentifierPrefix(Identifier);
+		WriteStringValue(Value);
+		PreviousTokenWritten = EJsonToken::String;
+	}
+
+	void WriteValue( const TCHAR* Identifier, const FString& Value )
+	{
+		WriteValue(Identifier, *Value);
+	}
+
+	// WARNING: THIS IS DANGEROUS. Use this only if you know for a fact that the Value is valid JSON!
+	void WriteRawJSONValue( const TCHAR* Identifier, const FString& Value )
+	{
+		WriteIdentifierPrefix(Identifier);
+		for (int32 CharIndex = 0; CharIndex < Value.Len(); ++CharIndex)
+		{
+			PrintPolicy::WriteChar(Buffer, (CharType)Value[CharIndex]);
+		}
+		PreviousTokenWritten = EJsonToken::String;
+	}
+
+	void WriteNull( const TCHAR* Identifier )
+	{
+		WriteIdentifierPrefix(Identifier);
+		WriteNullValue();
+		PreviousTokenWritten = EJsonToken::Null;
+	}
+
+	void WriteValue( const bool Value )
+	{
+		check(CanWriteValueWithoutIdentifier());
+		WriteCommaIfNeeded();
+
+		if (PreviousTokenWritten != EJsonToken::True && PreviousTokenWritten != EJsonToken::False && PreviousTokenWritten != EJsonToken::SquareOpen)
+		{
+			PrintPolicy::WriteLineTerminator(Buffer);
+			PrintPolicy::WriteTabs(Buffer, IndentLevel);
+		}
+		else
+		{
+			PrintPolicy::WriteSpace(Buffer);
+		}
+
+		WriteBoolValue(Value);
+		PreviousTokenWritten = Value ? EJsonToken::True : EJsonToken::False;
+	}
+
+	void WriteValue( const double Value )
+	{
+		check(CanWriteValueWithoutIdentifier());
+		WriteCommaIfNeeded();
+
+		if (PreviousTokenWritten != EJsonToken::Number && PreviousTokenWritten != EJsonToken::SquareOpen)
+		{
+			PrintPolicy::WriteLineTerminator(Buffer);
+			PrintPolicy::WriteTabs(Buffer, IndentLevel);
+		}
+		else
+		{
+			PrintPolicy::WriteSpace(Buffer);
+		}
+
+		WriteNumberValue(Value);
+		PreviousTokenWritten = EJsonToken::Number;
+	}
+
+	/** Takes precedence over WriteValue(bool) for string literals, unlike with TJsonWriter. */
+	void WriteValue( const TCHAR* Value )
+	{
+		check(CanWriteValueWithoutIdentifier());
+		WriteCommaIfNeeded();
+		PrintPolicy::WriteLineTerminator(Buffer);
+		PrintPolicy::WriteTabs(Buffer, IndentLevel);
+		WriteStringValue(Value);
+		PreviousTokenWritten = EJsonToken::String;
+	}
+
+	void WriteValue( const FString& Value )
+	{
+		WriteValue(*Value);
+	}
+
+	void WriteNull()
+	{
+		check(CanWriteValueWithoutIdentifier());
+		WriteCommaIfNeeded();
+
+		if (PreviousTokenWritten != EJsonToken::Null && PreviousTokenWritten != EJsonToken::SquareOpen)
+		{
+			PrintPolicy::WriteLineTerminator(Buffer);
+			PrintPolicy::WriteTabs(Buffer, IndentLevel);
+		}
+		else
+		{
+			PrintPolicy::WriteSpace(Buffer);
+		}
+
+		WriteNullValue();
+		PreviousTokenWritten = EJsonToken::Null;
+	}
+
+	/** @return true if every object and array was closed. */
+	bool Close() const
+	{
+		return (PreviousTokenWritten == EJsonToken::None ||
+				PreviousTokenWritten == EJsonToken::CurlyClose ||
+				PreviousTokenWritten == EJsonToken::SquareClose)
+			&& Stack.Num() == 0;
+	}
+
+	/**
+	 * WriteValue("Foo", Bar) should be equivalent to WriteIdentifierPrefix("Foo"), WriteValue(Bar)
+	 */
+	void WriteIdentifierPrefix( const TCHAR* Identifier )
+	{
+		check(Stack.Top() == EJson::Object);
+		WriteIdentifier(Identifier);
+		PrintPolicy::WriteSpace(Buffer);
+		PreviousTokenWritten = EJsonToken::Identifier;
+	}
+
+	// FString overloads, for the same interface as TJsonWriter
+
+	void WriteObjectStart( const FString& Identifier ) { WriteObjectStart(*Identifier); }
+	void WriteArrayStart( const FString& Identifier ) { WriteArrayStart(*Identifier); }
+	void WriteValue( const FString& Identifier, const bool Value ) { WriteValue(*Identifier, Value); }
+	void WriteValue( const FString& Identifier, const double Value ) { WriteValue(*Identifier, Value); }
+	void WriteValue( const FString& Identifier, const int32 Value ) { WriteValue(*Identifier, Value); }
+	void WriteValue( const FString& Identifier, const int64 Value ) { WriteValue(*Identifier, Value); }
+	void WriteValue( const FString& Identifier, const TCHAR* Value ) { WriteValue(*Identifier, Value); }
+	void WriteValue( const FString& Identifier, const FString& Value ) { WriteValue(*Identifier, *Value); }
+	void WriteRawJSONValue( const FString& Identifier, const FString& Value ) { WriteRawJSONValue(*Identifier, Value); }
+	void WriteNull( const FString& Identifier ) { WriteNull(*Identifier); }
+	void WriteIdentifierPrefix( const FString& Identifier ) { WriteIdentifierPrefix(*Identifier); }
+
+private:
+
+	FORCEINLINE bool CanWriteValueWithoutIdentifier() const
+	{
+		return Stack.Num() <= 0 || Stack.Top() == EJson::Array || PreviousTokenWritten == EJsonToken::Identifier;
+	}
+
+	FORCEINLINE void WriteCommaIfNeeded()
+	{
+		if (PreviousTokenWritten != EJsonToken::CurlyOpen && PreviousTokenWritten != EJsonToken::SquareOpen && PreviousTokenWritten != EJsonToken::Identifier)
+		{
+			PrintPolicy::WriteChar(Buffer, CharType(','));
+		}
+	}
+
+	FORCEINLINE void WriteIdentifier( const TCHAR* Identifier )
+	{
+		WriteCommaIfNeeded();
+		PrintPolicy::WriteLineTerminator(Buffer);
+
+		PrintPolicy::WriteTabs(Buffer, IndentLevel);
+		WriteStringValue(Identifier);
+		PrintPolicy::WriteChar(Buffer, CharType(':'));
+	}
+
+	FORCEINLINE void WriteBoolValue( const bool Value )
+	{
+		PrintPolicy::WriteString(Buffer, Value ? TEXT("true") : TEXT("false"));
+	}
+
+	FORCEINLINE void WriteNumberValue( const double Value )
+	{
+		// Specify 17 significant digits, the most that can ever be useful from a double
+		TCHAR Number[MAX_SPRINTF];
+		FCString::Sprintf(Number, TEXT("%.17g"), Value);
+		PrintPolicy::WriteString(Buffer, Number);
+	}
+
+	FORCEINLINE void WriteIntegerValue( const int64 Value )
+	{
+		TCHAR Number[MAX_SPRINTF];
+		FCString::Sprintf(Number, TEXT("%lld"), Value);
+		PrintPolicy::WriteString(Buffer, Number);
+	}
+
+	FORCEINLINE void WriteNullValue()
+	{
+		PrintPolicy::WriteString(Buffer, TEXT("null"));
+	}
+
+	/** Escapes like TJsonWriter, copying runs of characters that need no escaping at once. */
+	void WriteStringValue( const TCHAR* String )
+	{
+		PrintPolicy::WriteChar(Buffer, CharType('\"'));
+
+		const TCHAR* RunStart = String;
+		for (const TCHAR* Char = String; ; ++Char)
+		{
+			const TCHAR* Escaped;
+
+			switch (*Char)
+			{
+			case TCHAR('\0'): Escaped = nullptr; break;
+			case TCHAR('\\'): Escaped = TEXT("\\\\"); break;
+			case TCHAR('\n'): Escaped = TEXT("\\n"); break;
+			case TCHAR('\t'): Escaped = TEXT("\\t"); break;
+			case TCHAR('\b'): Escaped = TEXT("\\b"); break;
+			case TCHAR('\f'): Escaped = TEXT("\\f"); break;
+			case TCHAR('\r'): Escaped = TEXT("\\r"); break;
+			case TCHAR('\"'): Escaped = TEXT("\\\""); break;
+			default: continue;
+			}
+
+			WriteCharacters(RunStart, Char - RunStart);
+
+			if (Escaped == nullptr)
+			{
+				break;
+			}
+
+			PrintPolicy::WriteString(Buffer, Escaped);
+			RunStart = Char + 1;
+		}
+
+		PrintPolicy::WriteChar(Buffer, CharType('\"'));
+	}
+
+	/** Appends characters of a string as they are, or as UTF-8 when writing ANSICHAR. */
+	void WriteCharacters( const TCHAR* Chars, int32 Count )
+	{
+		if (sizeof(CharType) == sizeof(TCHAR))
+		{
+			Buffer.Append((const CharType*)Chars, Count);
+			return;
+		}
+
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			uint32 CodePoint = (uint32)Chars[Index];
+
+			if (CodePoint < 0x80)
+			{
+				Buffer.Add((CharType)CodePoint);
+				continue;
+			}
+
+			// TCHAR is UTF-16 on some platforms
+			if ((sizeof(TCHAR) == 2) && (CodePoint >= 0xD800) && (CodePoint < 0xDC00) && (Index + 1 < Count) && ((uint32)Chars[Index + 1] >= 0xDC00) && ((uint32)Chars[Index + 1] < 0xE000))
+			{
+				CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + ((uint32)Chars[++Index] - 0xDC00);
+			}
+
+			if (CodePoint < 0x800)
+			{
+				Buffer.Add((CharType)(0xC0 | (CodePoint >> 6)));
+				Buffer.Add((CharType)(0x80 | (CodePoint & 0x3F)));
+			}
+			else if (CodePoint < 0x10000)
+			{
+				Buffer.Add((CharType)(0xE0 | (CodePoint >> 12)));
+				Buffer.Add((CharType)(0x80 | ((CodePoint >> 6) & 0x3F)));
+				Buffer.Add((CharType)(0x80 | (CodePoint & 0x3F)));
+			}
+			else
+			{
+				Buffer.Add((CharType)(0xF0 | (CodePoint >> 18)));
+				Buffer.Add((CharType)(0x80 | ((CodePoint >> 12) & 0x3F)));
+				Buffer.Add((CharType)(0x80 | ((CodePoint >> 6) & 0x3F)));
+				Buffer.Add((CharType)(0x80 | (CodePoint & 0x3F)));
+			}
+		}
+	}
+
+private:
+
+	TArray<CharType>& Buffer;
+	TArray<EJson> Stack;
+	EJsonToken PreviousTokenWritten;
+	int32 IndentLevel;
+};
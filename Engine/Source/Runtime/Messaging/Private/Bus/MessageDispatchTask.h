@@ -4,23 +4,48 @@
 
 
 /**
- * Implements an asynchronous task for dispatching a message to a recipient.
+ * Structure for a message that is to be delivered to a single recipient.
  */
-class FMessageDispatchTask
+struct FMessageDelivery
 {
-public:
+	/** Holds the message context. */
+	IMessageContextRef Context;
+
+	/** Holds a reference to the recipient. */
+	IReceiveMessagesWeakPtr RecipientPtr;
 
 	/**
 	 * Creates and initializes a new instance.
 	 *
-	 * @param InThread The name of the thread to dispatch the message on.
-	 * @param InContext The context of the message to dispatch.
+	 * @param InContext The context of the message to deliver.
 	 * @param InRecipient The message recipient.
-	 * @param InTracer The message tracer to notify.
 	 */
-	FMessageDispatchTask( ENamedThreads::Type InThread, IMessageContextRef InContext, IReceiveMessagesWeakPtr InRecipient, FMessageTracerPtr InTracer )
+	FMessageDelivery( const IMessageContextRef& InContext, const IReceiveMessagesWeakPtr& InRecipient )
 		: Context(InContext)
 		, RecipientPtr(InRecipient)
+	{ }
+};
+
+
+/**
+ * Implements an asynchronous task for dispatching a batch of messages to recipients on the same thread.
+ *
+ * The message router collects the deliveries for each recipient thread while it is processing its
+ * commands, so that only a single task needs to be dispatched per thread and router tick.
+ */
+class FMessageDispatchTask
+{
+public:
+
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * @param InThread The name of the thread to dispatch the messages on.
+	 * @param InDeliveries The messages to deliver, in the order in which they were routed.
+	 * @param InTracer The message tracer to notify.
+	 */
+	FMessageDispatchTask( ENamedThreads::Type InThread, TArray<FMessageDelivery> InDeliveries, FMessageTracerPtr InTracer )
+		: Deliveries(MoveTemp(InDeliveries))
 		, Thread(InThread)
 		, TracerPtr(InTracer)
 	{ }
@@ -35,22 +60,26 @@ public:
 	 */
 	void DoTask( ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent )
 	{
-		IReceiveMessagesPtr Recipient = RecipientPtr.Pin();
+		FMessageTracerPtr Tracer = TracerPtr.Pin();
 
-		if (Recipient.IsValid())
+		for (int32 DeliveryIndex = 0; DeliveryIndex < Deliveries.Num(); ++DeliveryIndex)
 		{
-			FMessageTracerPtr Tracer = TracerPtr.Pin();
+			const FMessageDelivery& Delivery = Deliveries[DeliveryIndex];
+			IReceiveMessagesPtr Recipient = Delivery.RecipientPtr.Pin();
 
-			if (Tracer.IsValid())
+			if (Recipient.IsValid())
 			{
-				Tracer->TraceDispatchedMessage(Context, Recipient.ToSharedRef(), true);
-			}
-		
-			Recipient->ReceiveMessage(Context);
+				if (Tracer.IsValid())
+				{
+					Tracer->TraceDispatchedMessage(Delivery.Context, Recipient.ToSharedRef(), true);
+				}
 
-			if (TracerPtr.IsValid())
-			{
-				Tracer->TraceHandledMessage(Context, Recipient.ToSharedRef());
+				Recipient->ReceiveMessage(Delivery.Context);
+
+				if (Tracer.IsValid())
+				{
+					Tracer->TraceHandledMessage(Delivery.Context, Recipient.ToSharedRef());
+				}
 			}
 		}
 	}
@@ -84,13 +113,10 @@ public:
 
 private:
 
-	/** Holds the message context. */
-	IMessageContextRef Context;
-
-	/** Holds a reference to the recipient. */
-	IReceiveMessagesWeakPtr RecipientPtr;
+	/** Holds the messages to deliver. */
+	TArray<FMessageDelivery> Deliveries;
 
-	/** Holds the name of the thread that the router is running on. */
+	/** Holds the name of the thread that the messages are dispatched on. */
 	ENamedThreads::Type Thread;
 
 	/** Holds a pointer to the message tracer. */
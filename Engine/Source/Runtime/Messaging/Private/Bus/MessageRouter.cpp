@@ -3,11 +3,26 @@
 #include "MessagingPrivatePCH.h"
 
 
+DECLARE_CYCLE_STAT(TEXT("Process Commands"), STAT_MessageRouter_ProcessCommands, STATGROUP_Messaging);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Routed Messages"), STAT_MessageRouter_RoutedMessages, STATGROUP_Messaging);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Intercepted Messages"), STAT_MessageRouter_InterceptedMessages, STATGROUP_Messaging);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Delivered Messages"), STAT_MessageRouter_DeliveredMessages, STATGROUP_Messaging);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dispatch Tasks"), STAT_MessageRouter_DispatchTasks, STATGROUP_Messaging);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Subscription Index Updates"), STAT_MessageRouter_SubscriptionIndexUpdates, STATGROUP_Messaging);
+
+
+/* FMessageRouter static initialization
+ *****************************************************************************/
+
+const int32 FMessageRouter::MaxPendingDeliveries = 1024;
+
+
 /* FMessageRouter structors
  *****************************************************************************/
 
 FMessageRouter::FMessageRouter()
-	: DelayedMessagesSequence(0)
+	: NumPendingDeliveries(0)
+	, DelayedMessagesSequence(0)
 	, Stopping(false)
 	, Tracer(MakeShareable(new FMessageTracer()))
 {
@@ -39,19 +54,24 @@ uint32 FMessageRouter::Run()
 	{
 		if (WorkEvent->Wait(CalculateWaitTime()))
 		{
+			SCOPE_CYCLE_COUNTER(STAT_MessageRouter_ProcessCommands);
+
 			CurrentTime = FDateTime::UtcNow();
 
+			// reset before draining the queue, so that a command enqueued
+			// while draining can't be left behind until the wait times out
+			WorkEvent->Reset();
+
 			CommandDelegate Command;
 
 			while (Commands.Dequeue(Command))
 			{
 				Command.Execute();
 			}
-
-			WorkEvent->Reset();
 		}
 
 		ProcessDelayedMessages();
+		FlushDispatchBatches();
 	}
 
 	return 0;
@@ -113,8 +133,6 @@ void FMessageRouter::DispatchMessage( const IMessageContextRef& Context )
 {
 	if (Context->IsValid())
 	{
-		TArray<IReceiveMessagesPtr> Recipients;
-
 		// get recipients, either from the context...
 		const TArray<FMessageAddress>& RecipientList = Context->GetRecipients();
 
@@ -126,7 +144,7 @@ void FMessageRouter::DispatchMessage( const IMessageContextRef& Context )
 
 				if (Recipient.IsValid())
 				{
-					Recipients.AddUnique(Recipient);
+					DispatchRecipients.AddUnique(Recipient);
 				}
 				else
 				{
@@ -135,16 +153,15 @@ void FMessageRouter::DispatchMessage( const IMessageContextRef& Context )
 			}
 		}
 		// ... or from subscriptions
-		else
+		else if (!FilterSubscribers(GetIndexedSubscribers(Context->GetMessageType()), Context, DispatchRecipients))
 		{
-			FilterSubscriptions(ActiveSubscriptions.FindOrAdd(Context->GetMessageType()), Context, Recipients);
-			FilterSubscriptions(ActiveSubscriptions.FindOrAdd(NAME_All), Context, Recipients);
+			PruneSubscriptions();
 		}
 
 		// dispatch the message
-		for (int32 RecipientIndex = 0; RecipientIndex < Recipients.Num(); RecipientIndex++)
+		for (int32 RecipientIndex = 0; RecipientIndex < DispatchRecipients.Num(); RecipientIndex++)
 		{
-			IReceiveMessagesPtr Recipient = Recipients[RecipientIndex];
+			const IReceiveMessagesPtr& Recipient = DispatchRecipients[RecipientIndex];
 			ENamedThreads::Type RecipientThread = Recipient->GetRecipientThread();
 
 			if (RecipientThread == ENamedThreads::AnyThread)
@@ -155,47 +172,164 @@ void FMessageRouter::DispatchMessage( const IMessageContextRef& Context )
 			}
 			else
 			{
-				TGraphTask<FMessageDispatchTask>::CreateTask().ConstructAndDispatchWhenReady(RecipientThread, Context, Recipient, Tracer);
+				FDispatchBatch* Batch = nullptr;
+
+				for (int32 BatchIndex = 0; BatchIndex < DispatchBatches.Num(); ++BatchIndex)
+				{
+					if (DispatchBatches[BatchIndex].Thread == RecipientThread)
+					{
+						Batch = &DispatchBatches[BatchIndex];
+
+						break;
+					}
+				}
+
+				if (Batch == nullptr)
+				{
+					Batch = &DispatchBatches[DispatchBatches.Add(FDispatchBatch(RecipientThread))];
+				}
+
+				Batch->Deliveries.Add(FMessageDelivery(Context, Recipient));
+
+				if (++NumPendingDeliveries >= MaxPendingDeliveries)
+				{
+					FlushDispatchBatches();
+				}
 			}
 		}
+
+		INC_DWORD_STAT_BY(STAT_MessageRouter_DeliveredMessages, DispatchRecipients.Num());
+
+		// don't keep the recipients alive
+		DispatchRecipients.Reset();
 	}
 }
 
 
-void FMessageRouter::FilterSubscriptions( TArray<IMessageSubscriptionPtr>& Subscriptions, const IMessageContextRef& Context, TArray<IReceiveMessagesPtr>& OutRecipients )
+bool FMessageRouter::FilterSubscribers( const TArray<FIndexedSubscriber>& Subscribers, const IMessageContextRef& Context, TArray<IReceiveMessagesPtr>& OutRecipients )
 {
 	EMessageScope MessageScope = Context->GetScope();
+	bool SubscribersAlive = true;
 
-	for (int32 SubscriptionIndex = 0; SubscriptionIndex < Subscriptions.Num(); ++SubscriptionIndex)
+	for (int32 SubscriberIndex = 0; SubscriberIndex < Subscribers.Num(); ++SubscriberIndex)
 	{
-		const IMessageSubscriptionPtr& Subscription = Subscriptions[SubscriptionIndex];
+		const FIndexedSubscriber& IndexedSubscriber = Subscribers[SubscriberIndex];
+		bool Subscribed = false;
 
-		if (Subscription->IsEnabled() && Subscription->GetScopeRange().Contains(MessageScope))
+		for (int32 SubscriptionIndex = 0; SubscriptionIndex < IndexedSubscriber.Subscriptions.Num(); ++SubscriptionIndex)
 		{
-			IReceiveMessagesPtr Subscriber = Subscription->GetSubscriber().Pin();
+			const IMessageSubscriptionPtr& Subscription = IndexedSubscriber.Subscriptions[SubscriptionIndex];
 
-			if (Subscriber.IsValid())
+			if (Subscription->IsEnabled() && Subscription->GetScopeRange().Contains(MessageScope))
 			{
-				if (MessageScope == EMessageScope::Thread)
+				Subscribed = true;
+
+				break;
+			}
+		}
+
+		if (!Subscribed)
+		{
+			continue;
+		}
+
+		IReceiveMessagesPtr Subscriber = IndexedSubscriber.Subscriber.Pin();
+
+		if (!Subscriber.IsValid())
+		{
+			SubscribersAlive = false;
+
+			continue;
+		}
+
+		if (MessageScope == EMessageScope::Thread)
+		{
+			ENamedThreads::Type RecipientThread = Subscriber->GetRecipientThread();
+			ENamedThreads::Type SenderThread = Context->GetSenderThread();
+
+			if (RecipientThread != SenderThread)
+			{
+				continue;
+			}
+		}
+
+		// the index holds each subscriber only once, so no need for AddUnique
+		OutRecipients.Add(Subscriber);
+	}
+
+	return SubscribersAlive;
+}
+
+
+void FMessageRouter::FlushDispatchBatches()
+{
+	for (int32 BatchIndex = 0; BatchIndex < DispatchBatches.Num(); ++BatchIndex)
+	{
+		FDispatchBatch& Batch = DispatchBatches[BatchIndex];
+
+		if (Batch.Deliveries.Num() > 0)
+		{
+			TGraphTask<FMessageDispatchTask>::CreateTask().ConstructAndDispatchWhenReady(Batch.Thread, MoveTemp(Batch.Deliveries), Tracer);
+			INC_DWORD_STAT(STAT_MessageRouter_DispatchTasks);
+		}
+	}
+
+	NumPendingDeliveries = 0;
+}
+
+
+const TArray<FMessageRouter::FIndexedSubscriber>& FMessageRouter::GetIndexedSubscribers( const FName& MessageType )
+{
+	TArray<FIndexedSubscriber>* IndexedSubscribers = SubscriptionIndex.Find(MessageType);
+
+	if (IndexedSubscribers != nullptr)
+	{
+		return *IndexedSubscribers;
+	}
+
+	// merge the subscriptions to the message type with the ones to all types
+	IndexedSubscribers = &SubscriptionIndex.Add(MessageType);
+
+	const FName SubscribedTypes[] = { MessageType, NAME_All };
+	const int32 NumSubscribedTypes = (MessageType == NAME_All) ? 1 : 2;
+
+	for (int32 TypeIndex = 0; TypeIndex < NumSubscribedTypes; ++TypeIndex)
+	{
+		const TArray<IMessageSubscriptionPtr>* Subscriptions = ActiveSubscriptions.Find(SubscribedTypes[TypeIndex]);
+
+		if (Subscriptions == nullptr)
+		{
+			continue;
+		}
+
+		for (int32 SubscriptionIndex = 0; SubscriptionIndex < Subscriptions->Num(); ++SubscriptionIndex)
+		{
+			const IMessageSubscriptionPtr& Subscription = (*Subscriptions)[SubscriptionIndex];
+			const IReceiveMessagesWeakPtr& Subscriber = Subscription->GetSubscriber();
+			FIndexedSubscriber* IndexedSubscriber = nullptr;
+
+			for (int32 SubscriberIndex = 0; SubscriberIndex < IndexedSubscribers->Num(); ++SubscriberIndex)
+			{
+				if ((*IndexedSubscribers)[SubscriberIndex].Subscriber == Subscriber)
 				{
-					ENamedThreads::Type RecipientThread = Subscriber->GetRecipientThread();
-					ENamedThreads::Type SenderThread = Context->GetSenderThread();
+					IndexedSubscriber = &(*IndexedSubscribers)[SubscriberIndex];
 
-					if (RecipientThread != SenderThread)
-					{
-						continue;
-					}
+					break;
 				}
-
-				OutRecipients.AddUnique(Subscriber);
 			}
-			else
+
+			if (IndexedSubscriber == nullptr)
 			{
-				Subscriptions.RemoveAtSwap(SubscriptionIndex);
-				--SubscriptionIndex;
+				IndexedSubscriber = &(*IndexedSubscribers)[IndexedSubscribers->Add(FIndexedSubscriber(Subscriber))];
 			}
+
+			IndexedSubscriber->Subscriptions.Add(Subscription);
 		}
 	}
+
+	INC_DWORD_STAT(STAT_MessageRouter_SubscriptionIndexUpdates);
+
+	return *IndexedSubscribers;
 }
 
 
@@ -211,6 +345,25 @@ void FMessageRouter::ProcessDelayedMessages()
 }
 
 
+void FMessageRouter::PruneSubscriptions()
+{
+	for (TMap<FName, TArray<IMessageSubscriptionPtr> >::TIterator It(ActiveSubscriptions); It; ++It)
+	{
+		TArray<IMessageSubscriptionPtr>& Subscriptions = It.Value();
+
+		for (int32 Index = Subscriptions.Num() - 1; Index >= 0; --Index)
+		{
+			if (!Subscriptions[Index]->GetSubscriber().IsValid())
+			{
+				Subscriptions.RemoveAtSwap(Index);
+			}
+		}
+	}
+
+	SubscriptionIndex.Reset();
+}
+
+
 /* FMessageRouter callbacks
  *****************************************************************************/
 
@@ -235,7 +388,20 @@ void FMessageRouter::HandleAddRecipient( FMessageAddress Address, IReceiveMessag
 
 void FMessageRouter::HandleAddSubscriber( IMessageSubscriptionRef Subscription )
 {
-	ActiveSubscriptions.FindOrAdd(Subscription->GetMessageType()).AddUnique(Subscription);
+	const FName MessageType = Subscription->GetMessageType();
+
+	ActiveSubscriptions.FindOrAdd(MessageType).AddUnique(Subscription);
+
+	// subscriptions to all types are merged into every index entry
+	if (MessageType == NAME_All)
+	{
+		SubscriptionIndex.Reset();
+	}
+	else
+	{
+		SubscriptionIndex.Remove(MessageType);
+	}
+
 	Tracer->TraceAddedSubscription(Subscription);
 }
 
@@ -289,31 +455,38 @@ void FMessageRouter::HandleRemoveSubscriber( IReceiveMessagesWeakPtr SubscriberP
 				{
 					if (Subsriptions[Index]->GetSubscriber().Pin() == Subscriber)
 					{
-						Subsriptions.RemoveAtSwap(Index);
-
 						Tracer->TraceRemovedSubscription(Subsriptions[Index].ToSharedRef(), MessageType);
+						Subsriptions.RemoveAtSwap(Index);
 
 						break;
 					}
 				}
 			}
 		}
+
+		SubscriptionIndex.Reset();
 	}
 }
 
 
 void FMessageRouter::HandleRouteMessage( IMessageContextRef Context )
 {
+	INC_DWORD_STAT(STAT_MessageRouter_RoutedMessages);
+
 	// intercept routing
-	TArray<IMessageInterceptorPtr>& Interceptors = ActiveInterceptors.FindOrAdd(Context->GetMessageType());
+	TArray<IMessageInterceptorPtr>* Interceptors = ActiveInterceptors.Find(Context->GetMessageType());
 
-	for (TArray<IMessageInterceptorPtr>::TIterator It(Interceptors); It; ++It)
+	if (Interceptors != nullptr)
 	{
-		if ((*It)->InterceptMessage(Context))
+		for (TArray<IMessageInterceptorPtr>::TIterator It(*Interceptors); It; ++It)
 		{
-			Tracer->TraceInterceptedMessage(Context, It->ToSharedRef());
+			if ((*It)->InterceptMessage(Context))
+			{
+				Tracer->TraceInterceptedMessage(Context, It->ToSharedRef());
+				INC_DWORD_STAT(STAT_MessageRouter_InterceptedMessages);
 
-			return;
+				return;
+			}
 		}
 	}
 
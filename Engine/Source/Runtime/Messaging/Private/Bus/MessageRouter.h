@@ -18,6 +18,36 @@ class FMessageRouter
 {
 	DECLARE_DELEGATE(CommandDelegate)
 
+	// Structure for messages that are waiting to be dispatched to recipients on a named thread.
+	struct FDispatchBatch
+	{
+		// Holds the messages to deliver.
+		TArray<FMessageDelivery> Deliveries;
+
+		// Holds the name of the thread that the messages are dispatched on.
+		ENamedThreads::Type Thread;
+
+		// Creates and initializes a new instance.
+		FDispatchBatch( ENamedThreads::Type InThread )
+			: Thread(InThread)
+		{ }
+	};
+
+	// Structure for subscribers in the subscription index.
+	struct FIndexedSubscriber
+	{
+		// Holds the subscriber.
+		IReceiveMessagesWeakPtr Subscriber;
+
+		// Holds the subscriber's subscriptions for the indexed message type (including NAME_All).
+		TArray<IMessageSubscriptionPtr, TInlineAllocator<1>> Subscriptions;
+
+		// Creates and initializes a new instance.
+		FIndexedSubscriber( const IReceiveMessagesWeakPtr& InSubscriber )
+			: Subscriber(InSubscriber)
+		{ }
+	};
+
 public:
 
 	/** Default constructor. */
@@ -150,25 +180,42 @@ protected:
 	}
 
 	/**
-	 * Filters a collection of subscriptions using the given message context.
+	 * Dispatches a single message to its recipients.
+	 *
+	 * Messages for recipients on named threads are added to the dispatch batch of
+	 * the recipient's thread, which is sent off by FlushDispatchBatches.
+	 *
+	 * @param Message The message to dispatch.
+	 */
+	void DispatchMessage( const IMessageContextRef& Message );
+
+	/**
+	 * Filters the indexed subscribers of a message type using the given message context.
 	 *
-	 * @param Subscriptions The subscriptions to filter.
+	 * @param Subscribers The subscribers to filter.
 	 * @param Context The message context to filter by.
-	 * @param Sender The message sender (may be nullptr if the sender has no subscriptions).
 	 * @param OutRecipients Will hold the collection of recipients.
+	 * @return true if all subscribers are still alive, false if any of them expired.
 	 */
-	void FilterSubscriptions( TArray<IMessageSubscriptionPtr>& Subscriptions, const IMessageContextRef& Context, TArray<IReceiveMessagesPtr>& OutRecipients );
+	bool FilterSubscribers( const TArray<FIndexedSubscriber>& Subscribers, const IMessageContextRef& Context, TArray<IReceiveMessagesPtr>& OutRecipients );
+
+	/** Dispatches the pending message batches of all recipient threads. */
+	void FlushDispatchBatches();
 
 	/**
-	 * Dispatches a single message to its recipients.
+	 * Gets the subscribers of the specified message type, building the index entry if needed.
 	 *
-	 * @param Message The message to dispatch.
+	 * @param MessageType The type of messages to get the subscribers for.
+	 * @return The subscribers.
 	 */
-	void DispatchMessage( const IMessageContextRef& Message );
+	const TArray<FIndexedSubscriber>& GetIndexedSubscribers( const FName& MessageType );
 
 	/** Processes all delayed messages. */
 	void ProcessDelayedMessages();
 
+	/** Removes the subscriptions of expired subscribers. */
+	void PruneSubscriptions();
+
 private:
 
 	// Structure for delayed messages.
@@ -241,6 +288,18 @@ private:
 	/** Holds the router command queue. */
 	TQueue<CommandDelegate, EQueueMode::Mpsc> Commands;
 
+	/** Holds the pending message batches for recipients on named threads. */
+	TArray<FDispatchBatch> DispatchBatches;
+
+	/** Holds a scratch array of recipients, reused to avoid allocations for every dispatched message. */
+	TArray<IReceiveMessagesPtr> DispatchRecipients;
+
+	/** Holds the number of messages in all dispatch batches. */
+	int32 NumPendingDeliveries;
+
+	/** Maps message types to their subscribers (built lazily from ActiveSubscriptions). */
+	TMap<FName, TArray<FIndexedSubscriber>> SubscriptionIndex;
+
 	/** Holds the current time. */
 	FDateTime CurrentTime;
 
@@ -258,4 +317,9 @@ private:
 
 	/** Holds an event signaling that work is available. */
 	FEvent* WorkEvent;
+
+private:
+
+	/** Defines the maximum number of messages that are batched up before they are dispatched. */
+	static const int32 MaxPendingDeliveries;
 };
@@ -10,6 +10,12 @@
 #include "TaskGraphInterfaces.h"
 
 
+/* Private stats
+ *****************************************************************************/
+
+DECLARE_STATS_GROUP(TEXT("Messaging"), STATGROUP_Messaging, STATCAT_Advanced);
+
+
 /* Private includes
  *****************************************************************************/
 
@@ -0,0 +1,231 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "MessagingPrivatePCH.h"
+#include "AutomationTest.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMessageRouterBenchmark, "Core.Messaging.MessageRouter.Benchmark", EAutomationTestFlags::ATF_Editor)
+
+
+namespace MessageRouterBenchmark
+{
+	const int32 NumMessages = 1000000;
+	const int32 NumSubscribers = 4;
+
+	/** Defines the maximum number of messages that may be queued up in the router, so that the benchmark doesn't measure the memory allocator. */
+	const int32 MaxMessagesInFlight = 65536;
+
+
+	/** Implements a message endpoint that counts the messages it receives. */
+	class FEndpoint
+		: public IReceiveMessages
+		, public ISendMessages
+	{
+	public:
+
+		FEndpoint( ENamedThreads::Type InRecipientThread, FThreadSafeCounter& InNumReceived )
+			: Address(FMessageAddress::NewAddress())
+			, NumReceived(InNumReceived)
+			, RecipientId(FGuid::NewGuid())
+			, RecipientThread(InRecipientThread)
+		{ }
+
+		virtual FName GetDebugName() const override
+		{
+			return FName(TEXT("MessageRouterBenchmark"));
+		}
+
+		virtual const FGuid& GetRecipientId() const override
+		{
+			return RecipientId;
+		}
+
+		virtual ENamedThreads::Type GetRecipientThread() const override
+		{
+			return RecipientThread;
+		}
+
+		virtual bool IsLocal() const override
+		{
+			return true;
+		}
+
+		virtual void ReceiveMessage( const IMessageContextRef& Context ) override
+		{
+			NumReceived.Increment();
+		}
+
+		virtual FMessageAddress GetSenderAddress() override
+		{
+			return Address;
+		}
+
+		virtual void NotifyMessageError( const IMessageContextRef& Context, const FString& Error ) override { }
+
+		FMessageAddress Address;
+
+	private:
+
+		FThreadSafeCounter& NumReceived;
+		FGuid RecipientId;
+		ENamedThreads::Type RecipientThread;
+	};
+
+	typedef TSharedRef<FEndpoint, ESPMode::ThreadSafe> FEndpointRef;
+
+
+	/** Waits until the recipients received the specified number of messages. */
+	bool WaitForMessages( const FThreadSafeCounter& NumReceived, int32 NumExpected, bool ProcessGameThread )
+	{
+		const double TimeoutTime = FPlatformTime::Seconds() + 60.0;
+
+		while (NumReceived.GetValue() < NumExpected)
+		{
+			if (FPlatformTime::Seconds() > TimeoutTime)
+			{
+				return false;
+			}
+
+			// recipients on the game thread only receive their messages while it processes its tasks
+			if (ProcessGameThread)
+			{
+				FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			}
+			else
+			{
+				FPlatformProcess::Sleep(0.0f);
+			}
+		}
+
+		return true;
+	}
+
+
+	/**
+	 * Pumps messages from a sender to its recipients.
+	 *
+	 * @param Bus The message bus to use.
+	 * @param TypeInfo The type of messages to pump.
+	 * @param Sender The message sender.
+	 * @param Recipients The addresses to send the messages to, or an empty array to publish them.
+	 * @param NumRecipients The number of recipients that receive each message.
+	 * @param NumReceived The number of messages received by all recipients.
+	 * @param ProcessGameThread Whether the recipients receive their messages on the game thread.
+	 * @return The time it took to deliver all messages (in seconds), or a negative value if the messages weren't delivered.
+	 */
+	double PumpMessages( const IMessageBusRef& Bus, UScriptStruct* TypeInfo, const FEndpointRef& Sender, const TArray<FMessageAddress>& Recipients, int32 NumRecipients, FThreadSafeCounter& NumReceived, bool ProcessGameThread )
+	{
+		NumReceived.Reset();
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (int32 MessageIndex = 0; MessageIndex < NumMessages; ++MessageIndex)
+		{
+			if ((MessageIndex - NumReceived.GetValue() / NumRecipients > MaxMessagesInFlight) && !WaitForMessages(NumReceived, (MessageIndex - MaxMessagesInFlight / 2) * NumRecipients, ProcessGameThread))
+			{
+				return -1.0;
+			}
+
+			// the message context takes ownership of the message
+			void* Message = FMemory::Malloc(TypeInfo->PropertiesSize);
+			TypeInfo->InitializeScriptStruct(Message);
+
+			if (Recipients.Num() > 0)
+			{
+				Bus->Send(Message, TypeInfo, nullptr, Recipients, FTimespan::Zero(), FDateTime::MaxValue(), Sender);
+			}
+			else
+			{
+				Bus->Publish(Message, TypeInfo, EMessageScope::Process, FTimespan::Zero(), FDateTime::MaxValue(), Sender);
+			}
+		}
+
+		if (!WaitForMessages(NumReceived, NumMessages * NumRecipients, ProcessGameThread))
+		{
+			return -1.0;
+		}
+
+		return FPlatformTime::Seconds() - StartTime;
+	}
+}
+
+
+bool FMessageRouterBenchmark::RunTest( const FString& Parameters )
+{
+	using namespace MessageRouterBenchmark;
+
+	// a private bus, so that the benchmark isn't affected by other endpoints
+	IMessageBusRef Bus = MakeShareable(new FMessageBus(nullptr));
+	UScriptStruct* TypeInfo = FindObjectChecked<UScriptStruct>(UObject::StaticClass(), TEXT("Guid"));
+	FThreadSafeCounter NumReceived;
+
+	FEndpointRef Sender = MakeShareable(new FEndpoint(ENamedThreads::AnyThread, NumReceived));
+	TArray<FEndpointRef> AnyThreadSubscribers;
+	TArray<FEndpointRef> GameThreadSubscribers;
+
+	for (int32 SubscriberIndex = 0; SubscriberIndex < NumSubscribers; ++SubscriberIndex)
+	{
+		AnyThreadSubscribers.Add(MakeShareable(new FEndpoint(ENamedThreads::AnyThread, NumReceived)));
+		GameThreadSubscribers.Add(MakeShareable(new FEndpoint(ENamedThreads::GameThread, NumReceived)));
+	}
+
+	FEndpointRef Recipient = MakeShareable(new FEndpoint(ENamedThreads::AnyThread, NumReceived));
+	Bus->Register(Recipient->Address, Recipient);
+
+	TArray<FMessageAddress> RecipientAddresses;
+	RecipientAddresses.Add(Recipient->Address);
+
+	// send to a single recipient
+	{
+		const double Seconds = PumpMessages(Bus, TypeInfo, Sender, RecipientAddresses, 1, NumReceived, false);
+
+		TestTrue(TEXT("All sent messages must be received"), Seconds > 0.0);
+
+		if (Seconds > 0.0)
+		{
+			AddLogItem(FString::Printf(TEXT("Send to 1 recipient (any thread): %i messages in %.3f s, %.0f messages/s"), NumMessages, Seconds, NumMessages / Seconds));
+		}
+	}
+
+	// publish to subscribers that receive on the router thread
+	for (int32 SubscriberIndex = 0; SubscriberIndex < NumSubscribers; ++SubscriberIndex)
+	{
+		Bus->Subscribe(AnyThreadSubscribers[SubscriberIndex], TypeInfo->GetFName(), FMessageScopeRange::AtLeast(EMessageScope::Thread));
+	}
+
+	{
+		const double Seconds = PumpMessages(Bus, TypeInfo, Sender, TArray<FMessageAddress>(), NumSubscribers, NumReceived, false);
+
+		TestTrue(TEXT("All published messages must be received by subscribers on any thread"), Seconds > 0.0);
+
+		if (Seconds > 0.0)
+		{
+			AddLogItem(FString::Printf(TEXT("Publish to %i subscribers (any thread): %i messages in %.3f s, %.0f messages/s, %.0f deliveries/s"), NumSubscribers, NumMessages, Seconds, NumMessages / Seconds, NumMessages * NumSubscribers / Seconds));
+		}
+	}
+
+	// publish to subscribers that receive on the game thread
+	for (int32 SubscriberIndex = 0; SubscriberIndex < NumSubscribers; ++SubscriberIndex)
+	{
+		Bus->Unsubscribe(AnyThreadSubscribers[SubscriberIndex], NAME_All);
+		Bus->Subscribe(GameThreadSubscribers[SubscriberIndex], TypeInfo->GetFName(), FMessageScopeRange::AtLeast(EMessageScope::Thread));
+	}
+
+	{
+		const double Seconds = PumpMessages(Bus, TypeInfo, Sender, TArray<FMessageAddress>(), NumSubscribers, NumReceived, true);
+
+		TestTrue(TEXT("All published messages must be received by subscribers on the game thread"), Seconds > 0.0);
+
+		if (Seconds > 0.0)
+		{
+			AddLogItem(FString::Printf(TEXT("Publish to %i subscribers (game thread): %i messages in %.3f s, %.0f messages/s, %.0f deliveries/s"), NumSubscribers, NumMessages, Seconds, NumMessages / Seconds, NumMessages * NumSubscribers / Seconds));
+		}
+	}
+
+	Bus->Shutdown();
+
+	// flush messages that were dispatched to the game thread after a timeout
+	FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+
+	return true;
+}
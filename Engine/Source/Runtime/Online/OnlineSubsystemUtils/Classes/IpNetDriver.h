@@ -7,6 +7,19 @@
 #pragma once
 #include "IpNetDriver.generated.h"
 
+/** A datagram queued by UIpNetDriver::QueueSend */
+struct FIpPendingSend
+{
+	/** Offset of the datagram in UIpNetDriver::PendingSendData */
+	int32 Offset;
+	/** Size of the datagram */
+	int32 Count;
+	/** Destination, kept alive until sent */
+	TSharedPtr<FInternetAddr> Address;
+};
+
+class FIpNetDriverReceiveThread;
+
 UCLASS(transient, config=Engine)
 class ONLINESUBSYSTEMUTILS_API UIpNetDriver : public UNetDriver
 {
@@ -24,12 +37,35 @@ class ONLINESUBSYSTEMUTILS_API UIpNetDriver : public UNetDriver
 	UPROPERTY(Config)
 	uint32 MaxPortCountToTry;
 
+	/** Read the socket on a dedicated thread, which timestamps packets as they arrive and keeps reading while the game thread hitches */
+	UPROPERTY(Config)
+	uint32 bUseReceiveThread:1;
+
+	/** Number of packets the receive thread can hold until TickDispatch processes them */
+	UPROPERTY(Config)
+	int32 ReceiveThreadQueueSize;
+
 	/** Local address this net driver is associated with */
 	TSharedPtr<FInternetAddr> LocalAddr;
 
 	/** Underlying socket communication */
 	FSocket* Socket;
 
+	/** Addresses FSocket::RecvMulti reads the senders into, reused every tick */
+	TArray< TSharedPtr<FInternetAddr> > RecvAddrs;
+
+	/** Reads Socket when bUseReceiveThread is set, NULL otherwise */
+	FIpNetDriverReceiveThread* ReceiveThread;
+
+	/** Data of the datagrams queued by QueueSend, back to back */
+	TArray<uint8> PendingSendData;
+
+	/** Datagrams queued by QueueSend, sent by FlushPendingSends */
+	TArray<FIpPendingSend> PendingSends;
+
+	/** Set while the connections flush in TickFlush, the only time QueueSend batches */
+	bool bBatchingSends;
+
 	// Begin UNetDriver interface.
 	virtual bool IsAvailable() const override;
 	virtual bool InitBase(bool bInitAsClient, FNetworkNotify* InNotify, const FURL& URL, bool bReuseAddressAndPort, FString& Error) override;
@@ -37,6 +73,7 @@ class ONLINESUBSYSTEMUTILS_API UIpNetDriver : public UNetDriver
 	virtual bool InitListen( FNetworkNotify* InNotify, FURL& LocalURL, bool bReuseAddressAndPort, FString& Error ) override;
 	virtual void ProcessRemoteFunction(class AActor* Actor, class UFunction* Function, void* Parameters, struct FOutParmRec* OutParms, struct FFrame* Stack, class UObject* SubObject = NULL) override;
 	virtual void TickDispatch( float DeltaTime ) override;
+	virtual void TickFlush( float DeltaSeconds ) override;
 	virtual FString LowLevelGetNetworkNumber() override;
 	virtual void LowLevelDestroy() override;
 	virtual class ISocketSubsystem* GetSocketSubsystem() override;
@@ -57,6 +94,32 @@ class ONLINESUBSYSTEMUTILS_API UIpNetDriver : public UNetDriver
 	 * @return The port number to use for client sockets. Base implementation returns 0.
 	 */
 	virtual int GetClientPort();
+
+	/**
+	 * Queues a datagram to be sent by the next FlushPendingSends, so the packets of every connection
+	 * can go out with as few socket calls as possible. Only batches during TickFlush, so packets sent
+	 * outside of it (e.g. NMT_Join before a blocking map load) go out right away, as does everything
+	 * when batching is disabled.
+	 *
+	 * @param Data the datagram to send, copied
+	 * @param Count the size of the datagram
+	 * @param Address the network byte ordered address to send to
+	 */
+	void QueueSend( const uint8* Data, int32 Count, const TSharedPtr<FInternetAddr>& Address );
+
+	/** Sends every datagram queued by QueueSend */
+	void FlushPendingSends();
+
+	/**
+	 * Routes a datagram read from the socket to its connection, accepting a new connection if needed.
+	 *
+	 * @param FromAddr the sender, or the address the error was reported for
+	 * @param Data the datagram, ignored for errors
+	 * @param Count the size of the datagram
+	 * @param bPortUnreachable true if the socket reported the address as unreachable instead of reading a datagram
+	 * @param QueueDelay seconds between reading the datagram and this call, negative if unknown
+	 */
+	void ProcessReceivedPacket( const FInternetAddr& FromAddr, uint8* Data, int32 Count, bool bPortUnreachable, float QueueDelay );
 	// End UIpNetDriver interface.
 
 	// Begin FExec Interface
@@ -128,12 +128,8 @@ void UIpConnection::LowLevelSend( void* Data, int32 Count )
 			ResolveInfo = NULL;
 		}
 	}
-	// Send to remote.
-	int32 BytesSent = 0;
-	CLOCK_CYCLES(Driver->SendCycles);
-	Socket->SendTo((uint8*)Data, Count, BytesSent, *RemoteAddr);
-	UNCLOCK_CYCLES(Driver->SendCycles);
-	NETWORK_PROFILER(GNetworkProfiler.TrackSocketSendTo(Socket->GetDescription(),Data,BytesSent,*RemoteAddr));
+	// Send to remote, batched with the packets of the other connections during TickFlush
+	((UIpNetDriver*)Driver)->QueueSend((uint8*)Data, Count, RemoteAddr);
 }
 
 FString UIpConnection::LowLevelGetRemoteAddress(bool bAppendPort)
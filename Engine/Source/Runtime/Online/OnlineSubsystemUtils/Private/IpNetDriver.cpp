@@ -12,6 +12,8 @@ Notes:
 
 #include "IPAddress.h"
 #include "Sockets.h"
+#include "Net/NetworkProfiler.h"
+#include "IpNetDriverReceiveThread.h"
 
 /*-----------------------------------------------------------------------------
 	Declarations.
@@ -20,6 +22,11 @@ Notes:
 /** Size of the network recv buffer */
 #define NETWORK_MAX_PACKET (576)
 
+/** Max number of packets read by a single FSocket::RecvMulti call */
+#define NETWORK_RECV_BATCH (32)
+
+static TAutoConsoleVariable<int32> CVarNetBatchSends( TEXT( "net.IpNetDriverBatchSends" ), 1, TEXT( "Queue the packets sent during the net driver's TickFlush and send them together at its end" ) );
+
 UIpNetDriver::UIpNetDriver(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -125,6 +132,17 @@ bool UIpNetDriver::InitBase( bool bInitAsClient, FNetworkNotify* InNotify, const
 		return false;
 	}
 
+	if( bUseReceiveThread && FPlatformProcess::SupportsMultithreading() )
+	{
+		ReceiveThread = new FIpNetDriverReceiveThread( Socket, SocketSubsystem, FMath::Max(ReceiveThreadQueueSize, NETWORK_RECV_BATCH), NETWORK_MAX_PACKET );
+		if( !ReceiveThread->IsRunning() )
+		{
+			UE_LOG(LogNet, Warning, TEXT("%s: unable to start the receive thread, reading the socket on the game thread"), *GetDescription() );
+			delete ReceiveThread;
+			ReceiveThread = NULL;
+		}
+	}
+
 	// Success.
 	return true;
 }
@@ -168,15 +186,59 @@ void UIpNetDriver::TickDispatch( float DeltaTime )
 
 	ISocketSubsystem* SocketSubsystem = GetSocketSubsystem();
 
-	// Process all incoming packets.
-	uint8 Data[NETWORK_MAX_PACKET];
-	TSharedRef<FInternetAddr> FromAddr = SocketSubsystem->CreateInternetAddr();
+	if( ReceiveThread != NULL )
+	{
+		// Process the packets the receive thread read since the last tick.
+		while( Socket != NULL && ReceiveThread != NULL )
+		{
+			FIpReceivedPacket* Packet = ReceiveThread->PeekPacket();
+			if( Packet == NULL )
+			{
+				break;
+			}
+
+			if( Packet->Error == SE_NO_ERROR || Packet->Error == SE_ECONNRESET || Packet->Error == SE_UDP_ERR_PORT_UNREACH )
+			{
+				const float QueueDelay = FPlatformTime::Seconds() - Packet->ReceiveTime;
+				ProcessReceivedPacket( *Packet->FromAddr, Packet->Data, Packet->Count, Packet->Error != SE_NO_ERROR, QueueDelay );
+			}
+			else
+			{
+				UE_LOG(LogNet, Warning, TEXT("UDP recvfrom error: %i (%s) from %s"),
+					(int32)Packet->Error,
+					SocketSubsystem->GetSocketError(Packet->Error),
+					*Packet->FromAddr->ToString(true));
+			}
+
+			// Processing the packet may have shut the driver down
+			if( ReceiveThread != NULL )
+			{
+				ReceiveThread->ReleasePacket();
+			}
+		}
+		return;
+	}
+
+	// Process all incoming packets, reading as many as possible with each socket call.
+	uint8 Data[NETWORK_RECV_BATCH][NETWORK_MAX_PACKET];
+	FSocketDatagram Datagrams[NETWORK_RECV_BATCH];
+	while( RecvAddrs.Num() < NETWORK_RECV_BATCH )
+	{
+		RecvAddrs.Add( SocketSubsystem->CreateInternetAddr() );
+	}
+	for( int32 i=0; i<NETWORK_RECV_BATCH; i++ )
+	{
+		Datagrams[i].Data = Data[i];
+		Datagrams[i].BufferSize = NETWORK_MAX_PACKET;
+		Datagrams[i].Address = RecvAddrs[i].Get();
+	}
+
 	for( ; Socket != NULL; )
 	{
-		int32 BytesRead = 0;
+		int32 NumRead = 0;
 		// Get data, if any.
 		CLOCK_CYCLES(RecvCycles);
-		bool bOk = Socket->RecvFrom(Data, sizeof(Data), BytesRead, *FromAddr);
+		bool bOk = Socket->RecvMulti(Datagrams, NETWORK_RECV_BATCH, NumRead);
 		UNCLOCK_CYCLES(RecvCycles);
 		// Handle result.
 		if( bOk == false )
@@ -195,88 +257,192 @@ void UIpNetDriver::TickDispatch( float DeltaTime )
 					UE_LOG(LogNet, Warning, TEXT("UDP recvfrom error: %i (%s) from %s"),
 						(int32)Error,
 						SocketSubsystem->GetSocketError(Error),
-						*FromAddr->ToString(true));
+						*Datagrams[0].Address->ToString(true));
 					break;
 				}
 			}
+
+			// Handle the error below, as coming from the address it was reported for
+			NumRead = 1;
 		}
-		// Figure out which socket the received data came from.
-		UIpConnection* Connection = NULL;
-		if (GetServerConnection() && (*GetServerConnection()->RemoteAddr == *FromAddr))
+
+		for( int32 DatagramIndex=0; DatagramIndex<NumRead && Socket != NULL; DatagramIndex++ )
 		{
-			Connection = GetServerConnection();
+			ProcessReceivedPacket( *Datagrams[DatagramIndex].Address, Data[DatagramIndex], Datagrams[DatagramIndex].BytesTransferred, bOk == false, -1.f );
 		}
-		for( int32 i=0; i<ClientConnections.Num() && !Connection; i++ )
+
+		// A partial batch means there is nothing left to read
+		if( bOk && NumRead < NETWORK_RECV_BATCH )
 		{
-			UIpConnection* TestConnection = (UIpConnection*)ClientConnections[i]; 
-            check(TestConnection);
-			if(*TestConnection->RemoteAddr == *FromAddr)
-			{
-				Connection = TestConnection;
-			}
+			break;
 		}
+	}
+}
 
-		if( bOk == false )
+void UIpNetDriver::ProcessReceivedPacket( const FInternetAddr& FromAddr, uint8* Data, int32 Count, bool bPortUnreachable, float QueueDelay )
+{
+	// Figure out which socket the received data came from.
+	UIpConnection* Connection = NULL;
+	if (GetServerConnection() && (*GetServerConnection()->RemoteAddr == FromAddr))
+	{
+		Connection = GetServerConnection();
+	}
+	for( int32 i=0; i<ClientConnections.Num() && !Connection; i++ )
+	{
+		UIpConnection* TestConnection = (UIpConnection*)ClientConnections[i]; 
+		check(TestConnection);
+		if(*TestConnection->RemoteAddr == FromAddr)
+		{
+			Connection = TestConnection;
+		}
+	}
+
+	if( bPortUnreachable )
+	{
+		if( Connection )
 		{
-			if( Connection )
+			if( Connection != GetServerConnection() )
 			{
-				if( Connection != GetServerConnection() )
+				// We received an ICMP port unreachable from the client, meaning the client is no longer running the game
+				// (or someone is trying to perform a DoS attack on the client)
+
+				// rcg08182002 Some buggy firewalls get occasional ICMP port
+				// unreachable messages from legitimate players. Still, this code
+				// will drop them unceremoniously, so there's an option in the .INI
+				// file for servers with such flakey connections to let these
+				// players slide...which means if the client's game crashes, they
+				// might get flooded to some degree with packets until they timeout.
+				// Either way, this should close up the usual DoS attacks.
+				if ((Connection->State != USOCK_Open) || (!AllowPlayerPortUnreach))
 				{
-					// We received an ICMP port unreachable from the client, meaning the client is no longer running the game
-					// (or someone is trying to perform a DoS attack on the client)
-
-					// rcg08182002 Some buggy firewalls get occasional ICMP port
-					// unreachable messages from legitimate players. Still, this code
-					// will drop them unceremoniously, so there's an option in the .INI
-					// file for servers with such flakey connections to let these
-					// players slide...which means if the client's game crashes, they
-					// might get flooded to some degree with packets until they timeout.
-					// Either way, this should close up the usual DoS attacks.
-					if ((Connection->State != USOCK_Open) || (!AllowPlayerPortUnreach))
+					if (LogPortUnreach)
 					{
-						if (LogPortUnreach)
-						{
-							UE_LOG(LogNet, Log, TEXT("Received ICMP port unreachable from client %s.  Disconnecting."),
-								*FromAddr->ToString(true));
-						}
-						Connection->CleanUp();
+						UE_LOG(LogNet, Log, TEXT("Received ICMP port unreachable from client %s.  Disconnecting."),
+							*FromAddr.ToString(true));
 					}
+					Connection->CleanUp();
 				}
 			}
-			else
+		}
+		else
+		{
+			if (LogPortUnreach)
 			{
-				if (LogPortUnreach)
-				{
-					UE_LOG(LogNet, Log, TEXT("Received ICMP port unreachable from %s.  No matching connection found."),
-						*FromAddr->ToString(true));
-				}
+				UE_LOG(LogNet, Log, TEXT("Received ICMP port unreachable from %s.  No matching connection found."),
+					*FromAddr.ToString(true));
 			}
 		}
-		else
+	}
+	else
+	{
+		// If we didn't find a client connection, maybe create a new one.
+		if( !Connection )
 		{
-			// If we didn't find a client connection, maybe create a new one.
-			if( !Connection )
+			// Determine if allowing for client/server connections
+			const bool bAcceptingConnection = Notify->NotifyAcceptingConnection() == EAcceptConnection::Accept;
+
+			if (bAcceptingConnection)
 			{
-				// Determine if allowing for client/server connections
-				const bool bAcceptingConnection = Notify->NotifyAcceptingConnection() == EAcceptConnection::Accept;
+				Connection = ConstructObject<UIpConnection>(NetConnectionClass);
+				check(Connection);
+				Connection->InitRemoteConnection( this, Socket,  FURL(), FromAddr, USOCK_Open);
+				Notify->NotifyAcceptedConnection( Connection );
+				AddClientConnection(Connection);
+			}
+		}
 
-				if (bAcceptingConnection)
-				{
-					Connection = ConstructObject<UIpConnection>(NetConnectionClass);
-                    check(Connection);
-					Connection->InitRemoteConnection( this, Socket,  FURL(), *FromAddr, USOCK_Open);
-					Notify->NotifyAcceptedConnection( Connection );
-					AddClientConnection(Connection);
-				}
+		// Send the packet to the connection for processing.
+		if( Connection )
+		{
+			Connection->ReceiveQueueDelay = QueueDelay;
+			Connection->ReceivedRawPacket( Data, Count );
+			Connection->ReceiveQueueDelay = -1.f;
+		}
+	}
+}
+
+void UIpNetDriver::TickFlush( float DeltaSeconds )
+{
+	bBatchingSends = CVarNetBatchSends.GetValueOnGameThread() != 0;
+	Super::TickFlush( DeltaSeconds );
+	bBatchingSends = false;
+
+	// Every connection has flushed by now, send all of their packets together
+	FlushPendingSends();
+}
+
+void UIpNetDriver::QueueSend( const uint8* Data, int32 Count, const TSharedPtr<FInternetAddr>& Address )
+{
+	if( !bBatchingSends )
+	{
+		// Keep the packets in order if anything is still queued
+		FlushPendingSends();
+
+		int32 BytesSent = 0;
+		CLOCK_CYCLES(SendCycles);
+		Socket->SendTo(Data, Count, BytesSent, *Address);
+		UNCLOCK_CYCLES(SendCycles);
+		NETWORK_PROFILER(GNetworkProfiler.TrackSocketSendTo(Socket->GetDescription(),Data,BytesSent,*Address));
+		return;
+	}
+
+	FIpPendingSend& PendingSend = *new(PendingSends) FIpPendingSend;
+	PendingSend.Offset = PendingSendData.Num();
+	PendingSend.Count = Count;
+	PendingSend.Address = Address;
+
+	PendingSendData.AddUninitialized( Count );
+	FMemory::Memcpy( PendingSendData.GetData() + PendingSend.Offset, Data, Count );
+}
+
+void UIpNetDriver::FlushPendingSends()
+{
+	if( PendingSends.Num() == 0 )
+	{
+		return;
+	}
+
+	if( Socket != NULL )
+	{
+		TArray<FSocketDatagram> Datagrams;
+		Datagrams.AddUninitialized( PendingSends.Num() );
+		for( int32 i=0; i<PendingSends.Num(); i++ )
+		{
+			Datagrams[i].Data = PendingSendData.GetData() + PendingSends[i].Offset;
+			Datagrams[i].BufferSize = PendingSends[i].Count;
+			Datagrams[i].BytesTransferred = 0;
+			Datagrams[i].Address = PendingSends[i].Address.Get();
+		}
+
+		for( int32 NumSent=0; NumSent<Datagrams.Num(); )
+		{
+			int32 BatchSent = 0;
+			CLOCK_CYCLES(SendCycles);
+			const bool bOk = Socket->SendMulti( Datagrams.GetData() + NumSent, Datagrams.Num() - NumSent, BatchSent );
+			UNCLOCK_CYCLES(SendCycles);
+
+			NumSent += BatchSent;
+
+			// Like LowLevelSend, a packet that can't be sent is dropped
+			if( !bOk )
+			{
+				NumSent++;
 			}
+		}
 
-			// Send the packet to the connection for processing.
-			if( Connection )
+#if USE_NETWORK_PROFILER
+		if( GNetworkProfiler.IsTrackingEnabled() )
+		{
+			for( int32 i=0; i<Datagrams.Num(); i++ )
 			{
-				Connection->ReceivedRawPacket( Data, BytesRead );
+				GNetworkProfiler.TrackSocketSendTo(Socket->GetDescription(),Datagrams[i].Data,Datagrams[i].BytesTransferred,*Datagrams[i].Address);
 			}
 		}
+#endif
 	}
+
+	PendingSends.Reset();
+	PendingSendData.Reset();
 }
 
 void UIpNetDriver::ProcessRemoteFunction(class AActor* Actor, UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack, class UObject* SubObject )
@@ -351,6 +517,16 @@ void UIpNetDriver::LowLevelDestroy()
 {
 	Super::LowLevelDestroy();
 
+	// Send anything the connections queued while closing
+	FlushPendingSends();
+
+	// Stop reading before the socket goes away
+	if( ReceiveThread != NULL )
+	{
+		delete ReceiveThread;
+		ReceiveThread = NULL;
+	}
+
 	// Close the socket.
 	if( Socket && !HasAnyFlags(RF_ClassDefaultObject) )
 	{
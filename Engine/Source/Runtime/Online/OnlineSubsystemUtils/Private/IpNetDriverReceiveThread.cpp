@@ -0,0 +1,135 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	IpNetDriverReceiveThread.cpp: Dedicated socket reader for UIpNetDriver.
+=============================================================================*/
+
+#include "OnlineSubsystemUtilsPrivatePCH.h"
+#include "IpNetDriverReceiveThread.h"
+
+#include "IPAddress.h"
+#include "Sockets.h"
+
+/** Max number of packets read by a single FSocket::RecvMulti call */
+#define RECEIVE_THREAD_BATCH (32)
+
+/** How long the thread blocks waiting for data before checking if it should exit, in milliseconds */
+#define RECEIVE_THREAD_WAIT_MS (10)
+
+FIpNetDriverReceiveThread::FIpNetDriverReceiveThread(FSocket* InSocket, ISocketSubsystem* InSocketSubsystem, int32 NumPackets, int32 InMaxPacketSize)
+	: Socket(InSocket)
+	, SocketSubsystem(InSocketSubsystem)
+	// One more than NumPackets, the queues can only hold one less than their size
+	, ReceivedPackets(NumPackets + 1)
+	, FreePackets(NumPackets + 1)
+	, MaxPacketSize(InMaxPacketSize)
+	, Thread(NULL)
+{
+	check(Socket != NULL);
+	check(NumPackets > 0);
+
+	PacketData.AddUninitialized(NumPackets * MaxPacketSize);
+	Packets.AddZeroed(NumPackets);
+	for (int32 i = 0; i < NumPackets; i++)
+	{
+		FIpReceivedPacket& Packet = Packets[i];
+		Packet.Data = PacketData.GetData() + i * MaxPacketSize;
+		Packet.FromAddr = SocketSubsystem->CreateInternetAddr();
+		Packet.Error = SE_NO_ERROR;
+		verify(FreePackets.Enqueue(&Packet));
+	}
+
+	Thread = FRunnableThread::Create(this, TEXT("IpNetDriverReceiveThread"), 128 * 1024, TPri_AboveNormal);
+}
+
+FIpNetDriverReceiveThread::~FIpNetDriverReceiveThread()
+{
+	if (Thread != NULL)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = NULL;
+	}
+}
+
+uint32 FIpNetDriverReceiveThread::Run()
+{
+	const FTimespan WaitTime = FTimespan::FromMilliseconds(RECEIVE_THREAD_WAIT_MS);
+
+	// Free packets owned by this thread, read into by the next RecvMulti
+	FIpReceivedPacket* Batch[RECEIVE_THREAD_BATCH];
+	FSocketDatagram Datagrams[RECEIVE_THREAD_BATCH];
+	int32 BatchSize = 0;
+
+	while (StopTaskCounter.GetValue() == 0)
+	{
+		while (BatchSize < RECEIVE_THREAD_BATCH && FreePackets.Dequeue(Batch[BatchSize]))
+		{
+			BatchSize++;
+		}
+
+		if (BatchSize == 0)
+		{
+			// Every buffer is waiting on the game thread, the socket buffer holds the datagrams until it catches up
+			FPlatformProcess::Sleep(0.001f);
+			continue;
+		}
+
+		if (!Socket->Wait(ESocketWaitConditions::WaitForRead, WaitTime))
+		{
+			continue;
+		}
+
+		for (int32 i = 0; i < BatchSize; i++)
+		{
+			Datagrams[i].Data = Batch[i]->Data;
+			Datagrams[i].BufferSize = MaxPacketSize;
+			Datagrams[i].BytesTransferred = 0;
+			Datagrams[i].Address = Batch[i]->FromAddr.Get();
+		}
+
+		int32 NumRead = 0;
+		const bool bOk = Socket->RecvMulti(Datagrams, BatchSize, NumRead);
+		const double ReceiveTime = FPlatformTime::Seconds();
+
+		ESocketErrors Error = SE_NO_ERROR;
+		if (!bOk)
+		{
+			Error = SocketSubsystem->GetLastErrorCode();
+			if (Error == SE_EWOULDBLOCK || Error == SE_NO_ERROR)
+			{
+				continue;
+			}
+
+			// Let the game thread handle the error, as coming from the address it was reported for
+			NumRead = 1;
+		}
+
+		for (int32 i = 0; i < NumRead; i++)
+		{
+			FIpReceivedPacket* Packet = Batch[i];
+			Packet->Count = bOk ? Datagrams[i].BytesTransferred : 0;
+			Packet->ReceiveTime = ReceiveTime;
+			Packet->Error = Error;
+
+			// Can't fail, the queue has room for every packet
+			ReceivedPackets.Enqueue(Packet);
+		}
+
+		BatchSize -= NumRead;
+		FMemory::Memmove(Batch, Batch + NumRead, BatchSize * sizeof(FIpReceivedPacket*));
+
+		if (!bOk && Error != SE_ECONNRESET && Error != SE_UDP_ERR_PORT_UNREACH)
+		{
+			// Unexpected errors tend to repeat, don't flood the game thread with them
+			FPlatformProcess::Sleep(RECEIVE_THREAD_WAIT_MS / 1000.f);
+		}
+	}
+
+	return 0;
+}
+
+void FIpNetDriverReceiveThread::Stop()
+{
+	StopTaskCounter.Increment();
+}
@@ -0,0 +1,114 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	IpNetDriverReceiveThread.h: Dedicated socket reader for UIpNetDriver.
+=============================================================================*/
+
+#pragma once
+
+#include "Containers/CircularQueue.h"
+
+/** A datagram read by FIpNetDriverReceiveThread, in one of its preallocated buffers */
+struct FIpReceivedPacket
+{
+	/** Preallocated buffer the datagram is read into */
+	uint8* Data;
+	/** Size of the datagram */
+	int32 Count;
+	/** Sender, or the address the error was reported for */
+	TSharedPtr<FInternetAddr> FromAddr;
+	/** FPlatformTime::Seconds() when the datagram was read from the socket */
+	double ReceiveTime;
+	/** SE_NO_ERROR, or the error the socket reported instead of a datagram */
+	ESocketErrors Error;
+};
+
+/**
+ * FIpNetDriverReceiveThread
+ *	Drains a UIpNetDriver socket on its own thread, so packets are timestamped when they arrive and the
+ *	socket buffer keeps being emptied while the game thread hitches.
+ *
+ *	Packets are read straight into a fixed pool of buffers. Two lock-free single producer / single consumer
+ *	queues move the buffers between the threads: the receive thread fills free buffers and queues them as
+ *	received, the game thread consumes them in TickDispatch and hands them back. When every buffer is waiting
+ *	on the game thread the receive thread stops reading and leaves the datagrams in the socket buffer.
+ */
+class FIpNetDriverReceiveThread : public FRunnable
+{
+public:
+
+	/**
+	 * Allocates the packet buffers and starts the thread.
+	 *
+	 * @param InSocket			non-blocking socket to read, must outlive the thread
+	 * @param InSocketSubsystem	subsystem that created the socket
+	 * @param NumPackets		number of packets that can be waiting for the game thread
+	 * @param MaxPacketSize		size of each packet buffer
+	 */
+	FIpNetDriverReceiveThread(FSocket* InSocket, ISocketSubsystem* InSocketSubsystem, int32 NumPackets, int32 MaxPacketSize);
+
+	/** Stops the thread, waiting for it to exit */
+	virtual ~FIpNetDriverReceiveThread();
+
+	/**
+	 * Game thread only.
+	 *
+	 * @return the oldest received packet, or NULL if there are none. Stays valid until ReleasePacket is called
+	 */
+	FIpReceivedPacket* PeekPacket()
+	{
+		FIpReceivedPacket* Packet = NULL;
+		ReceivedPackets.Peek(Packet);
+		return Packet;
+	}
+
+	/** Game thread only. Hands the packet returned by PeekPacket back to the receive thread */
+	void ReleasePacket()
+	{
+		FIpReceivedPacket* Packet = NULL;
+		if (ReceivedPackets.Dequeue(Packet))
+		{
+			FreePackets.Enqueue(Packet);
+		}
+	}
+
+	/** @return true if the thread was started */
+	bool IsRunning() const
+	{
+		return Thread != NULL;
+	}
+
+	// Begin FRunnable interface.
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	// End FRunnable interface.
+
+private:
+
+	/** Socket being read */
+	FSocket* Socket;
+
+	/** Subsystem used to query socket errors */
+	ISocketSubsystem* SocketSubsystem;
+
+	/** Storage for every packet buffer, back to back */
+	TArray<uint8> PacketData;
+
+	/** Every packet, each pointing in PacketData */
+	TArray<FIpReceivedPacket> Packets;
+
+	/** Packets read by the receive thread, waiting for the game thread */
+	TCircularQueue<FIpReceivedPacket*> ReceivedPackets;
+
+	/** Packets released by the game thread, waiting to be read into */
+	TCircularQueue<FIpReceivedPacket*> FreePackets;
+
+	/** Size of each packet buffer */
+	int32 MaxPacketSize;
+
+	/** Non zero once the thread has been asked to exit */
+	FThreadSafeCounter StopTaskCounter;
+
+	/** The thread running Run */
+	FRunnableThread* Thread;
+};
@@ -6,6 +6,8 @@ public class PakFile : ModuleRules
 {
 	public PakFile(TargetInfo Target)
 	{
+		PrivateIncludePaths.Add("Runtime/PakFile/Private");
+
 		PrivateDependencyModuleNames.Add("Core");
 	}
 }
\ No newline at end of file
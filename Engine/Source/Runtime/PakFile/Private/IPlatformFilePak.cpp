@@ -12,6 +12,7 @@
 #include "PublicKey.inl"
 #include "AES.h"
 #include "GenericPlatformChunkInstall.h"
+#include "PakFileReaders.h"
 
 DEFINE_LOG_CATEGORY(LogPakFile);
 
@@ -40,194 +41,348 @@ public:
 	}
 };
 
-/**
- * Thread local class to manage working buffers for file compression
- */
-class FCompressionScratchBuffers : public TThreadSingleton<FCompressionScratchBuffers>
+bool FPakEntry::VerifyPakEntriesMatch(const FPakEntry& FileEntryA, const FPakEntry& FileEntryB)
 {
-public:
-	FCompressionScratchBuffers()
-		: TempBufferSize(0)
-		, ScratchBufferSize(0)
-	{}
+	bool bResult = true;
+	if (FileEntryA.Size != FileEntryB.Size)
+	{
+		UE_LOG(LogPakFile, Error, TEXT("Pak header file size mismatch, got: %lld, expected: %lld"), FileEntryB.Size, FileEntryA.Size);
+		bResult = false;		
+	}
+	if (FileEntryA.UncompressedSize != FileEntryB.UncompressedSize)
+	{
+		UE_LOG(LogPakFile, Error, TEXT("Pak header uncompressed file size mismatch, got: %lld, expected: %lld"), FileEntryB.UncompressedSize, FileEntryA.UncompressedSize);
+		bResult = false;
+	}
+	if (FileEntryA.CompressionMethod != FileEntryB.CompressionMethod)
+	{
+		UE_LOG(LogPakFile, Error, TEXT("Pak header file compression method mismatch, got: %d, expected: %d"), FileEntryB.CompressionMethod, FileEntryA.CompressionMethod);
+		bResult = false;
+	}
+	if (FMemory::Memcmp(FileEntryA.Hash, FileEntryB.Hash, sizeof(FileEntryA.Hash)) != 0)
+	{
+		UE_LOG(LogPakFile, Error, TEXT("Pak file hash does not match its index entry"));
+		bResult = false;
+	}
+	return bResult;
+}
 
-	int64				TempBufferSize;
-	TAutoPtr<uint8>		TempBuffer;
-	int64				ScratchBufferSize;
-	TAutoPtr<uint8>		ScratchBuffer;
+/*------------------------------------------------------------------------------
+	FPakIndex.
+------------------------------------------------------------------------------*/
 
-	void EnsureBufferSpace(int64 CompressionBlockSize, int64 ScrachSize)
+namespace PakIndex
+{
+	/** Folds ASCII letters to lower case. Other characters are compared as they are, so that all platforms agree on hashes. */
+	FORCEINLINE uint32 ToLower(uint32 Char)
 	{
-		if(TempBufferSize < CompressionBlockSize)
+		return (Char >= 'A' && Char <= 'Z') ? Char + ('a' - 'A') : Char;
+	}
+
+	/** Compares two paths the way the index does, for sorting. */
+	int32 ComparePaths(const TCHAR* A, const TCHAR* B)
+	{
+		while (*A && ToLower(*A) == ToLower(*B))
 		{
-			TempBufferSize = CompressionBlockSize;
-			TempBuffer.Reset((uint8*)FMemory::Malloc(TempBufferSize));
+			A++;
+			B++;
 		}
-		if(ScratchBufferSize < ScrachSize)
+		return (int32)ToLower(*A) - (int32)ToLower(*B);
+	}
+
+	/** Finds the first element of a sorted array that isn't less than the given hash. */
+	int32 LowerBound(const TArray<uint64>& Hashes, uint64 Hash)
+	{
+		int32 First = 0;
+		int32 Count = Hashes.Num();
+		while (Count > 0)
 		{
-			ScratchBufferSize = ScrachSize;
-			ScratchBuffer.Reset((uint8*)FMemory::Malloc(ScratchBufferSize));
+			const int32 Step = Count / 2;
+			if (Hashes[First + Step] < Hash)
+			{
+				First += Step + 1;
+				Count -= Step + 1;
+			}
+			else
+			{
+				Count = Step;
+			}
 		}
+		return First;
 	}
-};
 
-/**
- * Class to handle correctly reading from a compressed file within a pak
- */
-template< typename EncryptionPolicy = FPakNoEncryption >
-class FPakCompressedReaderPolicy
+	/** Sorts indices by their hashes, and stores both. */
+	void BuildHashTable(const TArray<uint64>& UnsortedHashes, TArray<uint64>& OutHashes, TArray<int32>& OutIndices)
+	{
+		OutIndices.Empty(UnsortedHashes.Num());
+		for (int32 Index = 0; Index < UnsortedHashes.Num(); Index++)
+		{
+			OutIndices.Add(Index);
+		}
+		OutIndices.Sort([&UnsortedHashes](int32 A, int32 B)
+		{
+			return UnsortedHashes[A] < UnsortedHashes[B] || (UnsortedHashes[A] == UnsortedHashes[B] && A < B);
+		});
+		OutHashes.Empty(UnsortedHashes.Num());
+		for (int32 Index = 0; Index < OutIndices.Num(); Index++)
+		{
+			OutHashes.Add(UnsortedHashes[OutIndices[Index]]);
+		}
+	}
+}
+
+bool FPakIndex::Build(const TArray<FString>& Filenames, const TArray<FPakEntry>& InEntries)
 {
-public:
-	class FPakUncompressTask : public FNonAbandonableTask
+	check(Filenames.Num() == InEntries.Num());
+
+	Entries.Empty(InEntries.Num());
+	Files.Empty(InEntries.Num());
+	Directories.Empty();
+	NamePool.Empty();
+
+	// Find the directory of each file, and add the parents of each directory up to the mount point.
+	TMap<FString, int32> DirectoryIndices;
+	TArray<FString> DirectoryNames;
+	TArray<int32> FileDirectories;
+	FileDirectories.AddUninitialized(Filenames.Num());
+
+	for (int32 FileIndex = 0; FileIndex < Filenames.Num(); FileIndex++)
 	{
-	public:
-		uint8*				UncompressedBuffer;
-		int32				UncompressedSize;
-		uint8*				CompressedBuffer;
-		int32				CompressedSize;
-		ECompressionFlags	Flags;
-		void*				CopyOut;
-		int64				CopyOffset;
-		int64				CopyLength;
-
-		void DoWork()
-		{
-			// Decrypt and Uncompress from memory to memory.
-			int64 EncryptionSize = EncryptionPolicy::AlignReadRequest(CompressedSize);
-			EncryptionPolicy::DecryptBlock(CompressedBuffer, EncryptionSize);
-			FCompression::UncompressMemory(Flags, UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize, false);
-			if (CopyOut)
+		const FString& Filename = Filenames[FileIndex];
+		for (int32 CharIndex = 0; CharIndex < Filename.Len(); CharIndex++)
+		{
+			if ((uint32)Filename[CharIndex] > 0xffff)
 			{
-				FMemory::Memcpy(CopyOut, UncompressedBuffer+CopyOffset, CopyLength);
+				UE_LOG(LogPakFile, Error, TEXT("Filename \"%s\" has characters that can't be stored in a pak index."), *Filename);
+				return false;
 			}
 		}
-		static const TCHAR *Name()
+
+		FString Path = FPaths::GetPath(Filename);
+		FPakFile::MakeDirectoryFromPath(Path);
+		const int32* ExistingDirectoryIndex = DirectoryIndices.Find(Path);
+		if (ExistingDirectoryIndex != NULL)
 		{
-			return TEXT("FPakUncompressTask");
+			FileDirectories[FileIndex] = *ExistingDirectoryIndex;
+			continue;
 		}
-	};
 
-	FPakCompressedReaderPolicy(const FPakFile& InPakFile, const FPakEntry& InPakEntry, FArchive* InPakReader)
-		: PakFile(InPakFile)
-		, PakEntry(InPakEntry)
-		, PakReader(InPakReader)
+		FileDirectories[FileIndex] = DirectoryNames.Add(Path);
+		DirectoryIndices.Add(Path, FileDirectories[FileIndex]);
+
+		int32 SeparatorIndex = 0;
+		for (FString ParentPath = Path.LeftChop(1); ParentPath.FindLastChar('/', SeparatorIndex); ParentPath = ParentPath.LeftChop(1))
+		{
+			ParentPath = ParentPath.Left(SeparatorIndex + 1);
+			if (DirectoryIndices.Contains(ParentPath))
+			{
+				break;
+			}
+			DirectoryIndices.Add(ParentPath, DirectoryNames.Add(ParentPath));
+		}
+	}
+
+	// Sort directories by path, and files by directory and name, so that the index doesn't depend on the order of the files.
+	TArray<int32> SortedDirectories;
+	TArray<int32> DirectoryOrder;
+	for (int32 DirectoryIndex = 0; DirectoryIndex < DirectoryNames.Num(); DirectoryIndex++)
 	{
+		SortedDirectories.Add(DirectoryIndex);
+	}
+	SortedDirectories.Sort([&DirectoryNames](int32 A, int32 B)
+	{
+		return PakIndex::ComparePaths(*DirectoryNames[A], *DirectoryNames[B]) < 0;
+	});
+	DirectoryOrder.AddUninitialized(SortedDirectories.Num());
+	for (int32 SortedIndex = 0; SortedIndex < SortedDirectories.Num(); SortedIndex++)
+	{
+		DirectoryOrder[SortedDirectories[SortedIndex]] = SortedIndex;
 	}
 
-	/** Pak file that own this file data */
-	const FPakFile&		PakFile;
-	/** Pak file entry for this file. */
-	const FPakEntry&	PakEntry;
-	/** Pak file archive to read the data from. */
-	FArchive*			PakReader;
+	TArray<int32> SortedFiles;
+	for (int32 FileIndex = 0; FileIndex < Filenames.Num(); FileIndex++)
+	{
+		SortedFiles.Add(FileIndex);
+	}
+	SortedFiles.Sort([&](int32 A, int32 B)
+	{
+		if (DirectoryOrder[FileDirectories[A]] != DirectoryOrder[FileDirectories[B]])
+		{
+			return DirectoryOrder[FileDirectories[A]] < DirectoryOrder[FileDirectories[B]];
+		}
+		const int32 Result = PakIndex::ComparePaths(*Filenames[A], *Filenames[B]);
+		return Result < 0 || (Result == 0 && A < B);
+	});
 
-	FORCEINLINE int64 FileSize() const
+	// Store the names and files, keeping only the last of files with the same name.
+	TArray<uint64> UnsortedDirectoryHashes;
+	for (int32 SortedIndex = 0; SortedIndex < SortedDirectories.Num(); SortedIndex++)
 	{
-		return PakEntry.UncompressedSize;
+		FDirectory& Directory = Directories[Directories.AddUninitialized()];
+		Directory.NameOffset = AddName(DirectoryNames[SortedDirectories[SortedIndex]]);
+		Directory.FirstFile = 0;
+		Directory.NumFiles = 0;
+		UnsortedDirectoryHashes.Add(HashPath(*DirectoryNames[SortedDirectories[SortedIndex]]));
 	}
 
-	void Serialize(int64 DesiredPosition, void* V, int64 Length)
+	TArray<uint64> UnsortedFileHashes;
+	for (int32 SortedIndex = 0; SortedIndex < SortedFiles.Num(); SortedIndex++)
 	{
-		const int32 CompressionBlockSize = PakEntry.CompressionBlockSize;
-		uint32 CompressionBlockIndex = DesiredPosition / CompressionBlockSize;
-		uint8* WorkingBuffers[2];
-		int64 DirectCopyStart = DesiredPosition % PakEntry.CompressionBlockSize;
-		FAsyncTask<FPakUncompressTask> UncompressTask;
-		FCompressionScratchBuffers& ScratchSpace = FCompressionScratchBuffers::Get();
-		bool bStartedUncompress = false;
+		const int32 FileIndex = SortedFiles[SortedIndex];
+		if (SortedIndex + 1 < SortedFiles.Num() && FileDirectories[SortedFiles[SortedIndex + 1]] == FileDirectories[FileIndex] && PakIndex::ComparePaths(*Filenames[SortedFiles[SortedIndex + 1]], *Filenames[FileIndex]) == 0)
+		{
+			continue;
+		}
+
+		const int32 DirectoryIndex = DirectoryOrder[FileDirectories[FileIndex]];
+		const FString& DirectoryName = DirectoryNames[FileDirectories[FileIndex]];
+		FDirectory& Directory = Directories[DirectoryIndex];
+		if (Directory.NumFiles == 0)
+		{
+			Directory.FirstFile = Files.Num();
+		}
+		Directory.NumFiles++;
 
-		int64 WorkingBufferRequiredSize = FCompression::CompressMemoryBound((ECompressionFlags)PakEntry.CompressionMethod,CompressionBlockSize);
-		WorkingBufferRequiredSize = EncryptionPolicy::AlignReadRequest(WorkingBufferRequiredSize);
-		ScratchSpace.EnsureBufferSpace(CompressionBlockSize, WorkingBufferRequiredSize*2);
-		WorkingBuffers[0] = ScratchSpace.ScratchBuffer;
-		WorkingBuffers[1] = ScratchSpace.ScratchBuffer + WorkingBufferRequiredSize;
+		FFile& File = Files[Files.AddUninitialized()];
+		File.DirectoryIndex = DirectoryIndex;
+		File.NameOffset = AddName(Filenames[FileIndex].Mid(DirectoryName.Len()));
+		Entries.Add(InEntries[FileIndex]);
+		UnsortedFileHashes.Add(HashPath(*Filenames[FileIndex] + DirectoryName.Len(), UnsortedDirectoryHashes[DirectoryIndex]));
+	}
 
-		while (Length > 0)
+	PakIndex::BuildHashTable(UnsortedFileHashes, FileHashes, FileHashIndices);
+	PakIndex::BuildHashTable(UnsortedDirectoryHashes, DirectoryHashes, DirectoryHashIndices);
+	return true;
+}
+
+bool FPakIndex::Serialize(FArchive& Ar, int32 Version)
+{
+	int32 NumEntries = Entries.Num();
+	Ar << NumEntries;
+	if (Ar.IsLoading())
+	{
+		Entries.Empty(NumEntries);
+		for (int32 EntryIndex = 0; EntryIndex < NumEntries; EntryIndex++)
 		{
-			const FPakCompressedBlock& Block = PakEntry.CompressionBlocks[CompressionBlockIndex];
-			int64 Pos = CompressionBlockIndex * CompressionBlockSize;
-			int64 CompressedBlockSize = Block.CompressedEnd-Block.CompressedStart;
-			int64 UncompressedBlockSize = FMath::Min<int64>(PakEntry.UncompressedSize-Pos, PakEntry.CompressionBlockSize);
-			int64 ReadSize = EncryptionPolicy::AlignReadRequest(CompressedBlockSize);
-			int64 WriteSize = FMath::Min<int64>(UncompressedBlockSize - DirectCopyStart, Length);
-			PakReader->Seek(Block.CompressedStart);
-			PakReader->Serialize(WorkingBuffers[CompressionBlockIndex & 1],ReadSize);
-			if (bStartedUncompress)
-			{
-				UncompressTask.EnsureCompletion();
-				bStartedUncompress = false;
-			}
+			Entries.Add(FPakEntry());
+		}
+	}
+	for (int32 EntryIndex = 0; EntryIndex < NumEntries; EntryIndex++)
+	{
+		Entries[EntryIndex].Serialize(Ar, Version);
+	}
 
-			FPakUncompressTask& TaskDetails = UncompressTask.GetTask();
-			if (DirectCopyStart == 0 && Length >= CompressionBlockSize)
-			{
-				// Block can be decompressed directly into output buffer
-				TaskDetails.Flags = (ECompressionFlags)PakEntry.CompressionMethod;
-				TaskDetails.UncompressedBuffer = (uint8*)V;
-				TaskDetails.UncompressedSize = UncompressedBlockSize;
-				TaskDetails.CompressedBuffer = WorkingBuffers[CompressionBlockIndex & 1];
-				TaskDetails.CompressedSize = CompressedBlockSize;
-				TaskDetails.CopyOut = nullptr;
-			}
-			else
-			{
-				// Block needs to be copied from a working buffer
-				TaskDetails.Flags = (ECompressionFlags)PakEntry.CompressionMethod;
-				TaskDetails.UncompressedBuffer = (uint8*)ScratchSpace.TempBuffer;
-				TaskDetails.UncompressedSize = UncompressedBlockSize;
-				TaskDetails.CompressedBuffer = WorkingBuffers[CompressionBlockIndex & 1];
-				TaskDetails.CompressedSize = CompressedBlockSize;
-				TaskDetails.CopyOut = V;
-				TaskDetails.CopyOffset = DirectCopyStart;
-				TaskDetails.CopyLength = WriteSize;
-			}
-			
-			if (Length == WriteSize)
-			{
-				UncompressTask.StartSynchronousTask();
-			}
-			else
-			{
-				UncompressTask.StartBackgroundTask();
-			}
-			bStartedUncompress = true;
-			V = (void*)((uint8*)V + WriteSize);
-			Length -= WriteSize;
-			DirectCopyStart = 0;
-			++CompressionBlockIndex;
+	Files.BulkSerialize(Ar);
+	Directories.BulkSerialize(Ar);
+	FileHashes.BulkSerialize(Ar);
+	FileHashIndices.BulkSerialize(Ar);
+	DirectoryHashes.BulkSerialize(Ar);
+	DirectoryHashIndices.BulkSerialize(Ar);
+	NamePool.BulkSerialize(Ar);
+
+	return !Ar.IsError() && Files.Num() == Entries.Num() && FileHashes.Num() == Files.Num() && FileHashIndices.Num() == Files.Num()
+		&& DirectoryHashes.Num() == Directories.Num() && DirectoryHashIndices.Num() == Directories.Num()
+		&& (NamePool.Num() == 0 || NamePool.Last() == 0);
+}
+
+const FPakEntry* FPakIndex::FindFile(const TCHAR* RelativeFilename) const
+{
+	const uint64 Hash = HashPath(RelativeFilename);
+	for (int32 HashIndex = PakIndex::LowerBound(FileHashes, Hash); HashIndex < FileHashes.Num() && FileHashes[HashIndex] == Hash; HashIndex++)
+	{
+		// Hashes can collide, so compare the names too.
+		const int32 FileIndex = FileHashIndices[HashIndex];
+		const TCHAR* Name = MatchName(Directories[Files[FileIndex].DirectoryIndex].NameOffset, RelativeFilename);
+		const TCHAR* Rest = Name != NULL ? MatchName(Files[FileIndex].NameOffset, Name) : NULL;
+		if (Rest != NULL && *Rest == 0)
+		{
+			return &Entries[FileIndex];
 		}
+	}
+	return NULL;
+}
 
-		if(bStartedUncompress)
+int32 FPakIndex::FindDirectory(const TCHAR* RelativeDirectory) const
+{
+	const uint64 Hash = HashPath(RelativeDirectory);
+	for (int32 HashIndex = PakIndex::LowerBound(DirectoryHashes, Hash); HashIndex < DirectoryHashes.Num() && DirectoryHashes[HashIndex] == Hash; HashIndex++)
+	{
+		const int32 DirectoryIndex = DirectoryHashIndices[HashIndex];
+		const TCHAR* Rest = MatchName(Directories[DirectoryIndex].NameOffset, RelativeDirectory);
+		if (Rest != NULL && *Rest == 0)
 		{
-			UncompressTask.EnsureCompletion();
+			return DirectoryIndex;
 		}
 	}
-};
+	return INDEX_NONE;
+}
 
-bool FPakEntry::VerifyPakEntriesMatch(const FPakEntry& FileEntryA, const FPakEntry& FileEntryB)
+FString FPakIndex::GetFilename(int32 FileIndex) const
 {
-	bool bResult = true;
-	if (FileEntryA.Size != FileEntryB.Size)
+	FString Result;
+	AppendName(Result, Directories[Files[FileIndex].DirectoryIndex].NameOffset);
+	AppendName(Result, Files[FileIndex].NameOffset);
+	return Result;
+}
+
+FString FPakIndex::GetDirectoryName(int32 DirectoryIndex) const
+{
+	FString Result;
+	AppendName(Result, Directories[DirectoryIndex].NameOffset);
+	return Result;
+}
+
+uint32 FPakIndex::GetAllocatedSize() const
+{
+	uint32 Result = Entries.GetAllocatedSize() + Files.GetAllocatedSize() + Directories.GetAllocatedSize() + NamePool.GetAllocatedSize()
+		+ FileHashes.GetAllocatedSize() + FileHashIndices.GetAllocatedSize() + DirectoryHashes.GetAllocatedSize() + DirectoryHashIndices.GetAllocatedSize();
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); EntryIndex++)
 	{
-		UE_LOG(LogPakFile, Error, TEXT("Pak header file size mismatch, got: %lld, expected: %lld"), FileEntryB.Size, FileEntryA.Size);
-		bResult = false;		
+		Result += Entries[EntryIndex].CompressionBlocks.GetAllocatedSize();
 	}
-	if (FileEntryA.UncompressedSize != FileEntryB.UncompressedSize)
+	return Result;
+}
+
+uint64 FPakIndex::HashPath(const TCHAR* Path, uint64 Hash)
+{
+	// 64 bit FNV-1a
+	for (; *Path; Path++)
 	{
-		UE_LOG(LogPakFile, Error, TEXT("Pak header uncompressed file size mismatch, got: %lld, expected: %lld"), FileEntryB.UncompressedSize, FileEntryA.UncompressedSize);
-		bResult = false;
+		Hash = (Hash ^ PakIndex::ToLower(*Path)) * 0x100000001b3ull;
 	}
-	if (FileEntryA.CompressionMethod != FileEntryB.CompressionMethod)
+	return Hash;
+}
+
+int32 FPakIndex::AddName(const FString& Name)
+{
+	const int32 NameOffset = NamePool.AddUninitialized(Name.Len() + 1);
+	for (int32 CharIndex = 0; CharIndex < Name.Len(); CharIndex++)
 	{
-		UE_LOG(LogPakFile, Error, TEXT("Pak header file compression method mismatch, got: %d, expected: %d"), FileEntryB.CompressionMethod, FileEntryA.CompressionMethod);
-		bResult = false;
+		NamePool[NameOffset + CharIndex] = (uint16)Name[CharIndex];
 	}
-	if (FMemory::Memcmp(FileEntryA.Hash, FileEntryB.Hash, sizeof(FileEntryA.Hash)) != 0)
+	NamePool[NameOffset + Name.Len()] = 0;
+	return NameOffset;
+}
+
+void FPakIndex::AppendName(FString& Result, int32 NameOffset) const
+{
+	for (const uint16* Name = &NamePool[NameOffset]; *Name; Name++)
 	{
-		UE_LOG(LogPakFile, Error, TEXT("Pak file hash does not match its index entry"));
-		bResult = false;
+		Result.AppendChar((TCHAR)*Name);
 	}
-	return bResult;
+}
+
+const TCHAR* FPakIndex::MatchName(int32 NameOffset, const TCHAR* Path) const
+{
+	for (const uint16* Name = &NamePool[NameOffset]; *Name; Name++, Path++)
+	{
+		// Also stops at the end of the path, as names don't contain null characters.
+		if (PakIndex::ToLower(*Name) != PakIndex::ToLower(*Path))
+		{
+			return NULL;
+		}
+	}
+	return Path;
 }
 
 FPakFile::FPakFile(const TCHAR* Filename, bool bIsSigned)
@@ -267,6 +422,60 @@ FPakFile::~FPakFile()
 {
 }
 
+bool FPakFile::Map(IPlatformFile* LowerLevel)
+{
+#if !USING_SIGNED_CONTENT
+	if (bSigned || FParse::Param(FCommandLine::Get(), TEXT("signedpak")) || FParse::Param(FCommandLine::Get(), TEXT("signed")))
+#endif
+	{
+		return false;
+	}
+
+	if (!MappedPakRegion.IsValid())
+	{
+		MappedPakHandle = LowerLevel->OpenMapped(*PakFilename);
+		if (MappedPakHandle.IsValid())
+		{
+			MappedPakRegion = MappedPakHandle->MapRegion();
+		}
+		if (!MappedPakRegion.IsValid())
+		{
+			// 32 bit address spaces may not have room for large pak files, they're read through archives instead
+			MappedPakHandle.Reset();
+			UE_LOG(LogPakFile, Log, TEXT("Pak \"%s\" can't be mapped, reading it through file handles."), *PakFilename);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FPakFile::VerifyEntryHeader(const FPakEntry& Entry, FArchive& Reader) const
+{
+	FPakEntry FileHeader;
+	if (MappedPakRegion.IsValid())
+	{
+		// The index may point past the end of a truncated or corrupt pak file
+		const int64 HeaderSize = Entry.GetSerializedSize(Info.Version);
+		if (Entry.Offset < 0 || HeaderSize > GetMappedSize() - Entry.Offset)
+		{
+			return false;
+		}
+		FBufferReader HeaderReader((void*)(MappedPakRegion->GetMappedPtr() + Entry.Offset), HeaderSize, false);
+		FileHeader.Serialize(HeaderReader, Info.Version);
+	}
+	else
+	{
+		Reader.Seek(Entry.Offset);
+		FileHeader.Serialize(Reader, Info.Version);
+	}
+	if (FPakEntry::VerifyPakEntriesMatch(Entry, FileHeader))
+	{
+		Entry.Verified = true;
+		return true;
+	}
+	return false;
+}
+
 FArchive* FPakFile::CreatePakReader(const TCHAR* Filename)
 {
 	FArchive* ReaderArchive = IFileManager::Get().CreateFileReader(Filename);
@@ -296,6 +505,8 @@ FArchive* FPakFile::SetupSignedPakReader(FArchive* ReaderArchive)
 
 void FPakFile::Initialize(FArchive* Reader)
 {
+	BlockCache = new FPakBlockCache();
+
 	if (Reader->TotalSize() < Info.GetSerializedSize())
 	{
 		UE_LOG(LogPakFile, Fatal, TEXT("Corrupted pak file (too short)."));
@@ -337,60 +548,38 @@ void FPakFile::LoadIndex(FArchive* Reader)
 			UE_LOG(LogPakFile, Fatal, TEXT("Corrupted index in pak file (CRC mismatch)."));
 		}
 
-		// Read the default mount point and all entries.
-		int32 NumEntries = 0;
+		// Read the default mount point.
 		IndexReader << MountPoint;
-		IndexReader << NumEntries;
-
 		MakeDirectoryFromPath(MountPoint);
-		// Allocate enough memory to hold all entries (and not reallocate while they're being added to it).
-		Files.Empty(NumEntries);
 
-		for (int32 EntryIndex = 0; EntryIndex < NumEntries; EntryIndex++)
+		if (Info.Version >= FPakInfo::PakFile_Version_FlatIndex)
 		{
-			// Serialize from memory.
-			FPakEntry Entry;
-			FString Filename;
-			IndexReader << Filename;
-			Entry.Serialize(IndexReader, Info.Version);
-
-			// Add new file info.
-			Files.Add(Entry);
-
-			// Construct Index of all directories in pak file.
-			FString Path = FPaths::GetPath(Filename);
-			MakeDirectoryFromPath(Path);
-			FPakDirectory* Directory = Index.Find(Path);
-			if (Directory != NULL)
+			// The index is stored the way it is used.
+			if (!Index.Serialize(IndexReader, Info.Version))
 			{
-				Directory->Add(Filename, &Files.Last());	
+				UE_LOG(LogPakFile, Fatal, TEXT("Corrupted index in pak file."));
 			}
-			else
+		}
+		else
+		{
+			// Older pak files store a list of filenames and entries, which the index is built from.
+			int32 NumEntries = 0;
+			IndexReader << NumEntries;
+			TArray<FString> Filenames;
+			TArray<FPakEntry> Entries;
+			Filenames.Empty(NumEntries);
+			Entries.Empty(NumEntries);
+
+			for (int32 EntryIndex = 0; EntryIndex < NumEntries; EntryIndex++)
 			{
-				FPakDirectory NewDirectory;
-				NewDirectory.Add(Filename, &Files.Last());
-				Index.Add(Path, NewDirectory);
+				// Serialize from memory.
+				IndexReader << Filenames[Filenames.Add(FString())];
+				Entries[Entries.Add(FPakEntry())].Serialize(IndexReader, Info.Version);
+			}
 
-				// add the parent directories up to the mount point
-				while (MountPoint != Path)
-				{
-					Path = Path.Left(Path.Len()-1);
-					int32 Offset = 0;
-					if (Path.FindLastChar('/', Offset))
-					{
-						Path = Path.Left(Offset);
-						MakeDirectoryFromPath(Path);
-						if (Index.Find(Path) == NULL)
-						{
-							FPakDirectory ParentDirectory;
-							Index.Add(Path, ParentDirectory);
-						}
-					}
-					else
-					{
-						Path = MountPoint;
-					}
-				}
+			if (!Index.Build(Filenames, Entries))
+			{
+				UE_LOG(LogPakFile, Fatal, TEXT("Unsupported filenames in pak file."));
 			}
 		}
 	}
@@ -488,6 +677,7 @@ void FPakPlatformFile::HandlePakListCommand(const TCHAR* Cmd, FOutputDevice& Ar)
 FPakPlatformFile::FPakPlatformFile()
 	: LowerLevel(NULL)
 	, bSigned(false)
+	, bMapPaks(false)
 {
 }
 
@@ -633,6 +823,9 @@ bool FPakPlatformFile::Initialize(IPlatformFile* Inner, const TCHAR* CmdLine)
 #else
 	bSigned = true;
 #endif
+
+	// Mapping pak files needs address space for all of them, which only 64 bit platforms can spare.
+	bMapPaks = PLATFORM_64BITS && !FParse::Param(CmdLine, TEXT("NoMapPaks"));
 	
 	TArray<FString> PaksToLoad;
 #if !UE_BUILD_SHIPPING
@@ -687,6 +880,10 @@ bool FPakPlatformFile::Mount(const TCHAR* InPakFilename, uint32 PakOrder, const
 			{
 				Pak->SetMountPoint(InPath);
 			}
+			if (bMapPaks)
+			{
+				Pak->Map(LowerLevel);
+			}
 			{
 				// Add new pak file
 				FScopeLock ScopedLock(&PakListCritical);
@@ -763,6 +960,33 @@ IFileHandle* FPakPlatformFile::OpenRead(const TCHAR* Filename)
 	return Result;
 }
 
+IMappedFileHandle* FPakPlatformFile::OpenMapped(const TCHAR* Filename)
+{
+	IMappedFileHandle* Result = NULL;
+	FPakFile* PakFile = NULL;
+	const FPakEntry* FileEntry = FindFileInPakFiles(Filename, &PakFile);
+	if (FileEntry != NULL)
+	{
+		// Only files that are stored as they are can be used in place.
+		const bool bStoredAsIs = (FileEntry->CompressionMethod == COMPRESS_None || PakFile->GetInfo().Version < FPakInfo::PakFile_Version_CompressionEncryption) && !FileEntry->bEncrypted;
+		if (bStoredAsIs && PakFile->GetMappedRegion() != NULL)
+		{
+			if (FileEntry->Verified || PakFile->VerifyEntryHeader(*FileEntry, *PakFile->GetSharedReader(LowerLevel)))
+			{
+				Result = new FPakMappedFileHandle(*PakFile, *FileEntry);
+			}
+		}
+	}
+#if !USING_SIGNED_CONTENT
+	else if (!bSigned)
+	{
+		// Default to wrapped file but only if we don't force use signed content
+		Result = LowerLevel->OpenMapped(Filename);
+	}
+#endif
+	return Result;
+}
+
 bool FPakPlatformFile::BufferedCopyFile(IFileHandle& Dest, IFileHandle& Source, const int64 FileSize, uint8* Buffer, const int64 BufferSize) const
 {	
 	int64 RemainingSizeToCopy = FileSize;
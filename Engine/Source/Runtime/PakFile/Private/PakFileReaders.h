@@ -0,0 +1,459 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "IPlatformFilePak.h"
+#include "TaskGraphInterfaces.h"
+
+/**
+ * Thread local class to manage working buffers for file compression
+ */
+class FCompressionScratchBuffers : public TThreadSingleton<FCompressionScratchBuffers>
+{
+public:
+	FCompressionScratchBuffers()
+		: TempBufferSize(0)
+		, ScratchBufferSize(0)
+	{}
+
+	int64				TempBufferSize;
+	TAutoPtr<uint8>		TempBuffer;
+	int64				ScratchBufferSize;
+	TAutoPtr<uint8>		ScratchBuffer;
+
+	void EnsureBufferSpace(int64 CompressionBlockSize, int64 ScrachSize)
+	{
+		if(TempBufferSize < CompressionBlockSize)
+		{
+			TempBufferSize = CompressionBlockSize;
+			TempBuffer.Reset((uint8*)FMemory::Malloc(TempBufferSize));
+		}
+		if(ScratchBufferSize < ScrachSize)
+		{
+			ScratchBufferSize = ScrachSize;
+			ScratchBuffer.Reset((uint8*)FMemory::Malloc(ScratchBufferSize));
+		}
+	}
+};
+
+/**
+ * Thread safe LRU cache of decompressed blocks.
+ *
+ * Blocks that are only partially read are kept here, so that overlapping and small sequential
+ * reads don't decompress the same block over and over again.
+ */
+class FPakBlockCache
+{
+	struct FCachedBlock
+	{
+		/** Offset of the compressed block in the pak file. */
+		int64	BlockOffset;
+		/** Decompressed data. */
+		uint8*	Data;
+		/** Size of the decompressed data. */
+		int64	Size;
+		/** Allocated size of the data buffer. */
+		int64	Capacity;
+		/** Value of the use counter when the block was last used. */
+		uint64	LastUsed;
+	};
+
+	/** Cached blocks. */
+	TArray<FCachedBlock> Blocks;
+	/** Incremented each time a block is used. */
+	uint64 UseCounter;
+	/** Critical section for accessing the cached blocks. */
+	FCriticalSection CriticalSection;
+
+public:
+	enum
+	{
+		/** Maximum number of cached blocks per pak file. */
+		MaxCachedBlocks = 8,
+	};
+
+	FPakBlockCache()
+		: UseCounter(0)
+	{}
+
+	~FPakBlockCache()
+	{
+		for (int32 Index = 0; Index < Blocks.Num(); Index++)
+		{
+			FMemory::Free(Blocks[Index].Data);
+		}
+	}
+
+	/**
+	 * Copies data out of a cached block.
+	 *
+	 * @param BlockOffset Offset of the compressed block in the pak file.
+	 * @param Dest Buffer to copy the data to.
+	 * @param Offset Offset into the decompressed block.
+	 * @param Length Number of bytes to copy.
+	 * @return true if the block was cached, false otherwise.
+	 */
+	bool Read(int64 BlockOffset, void* Dest, int64 Offset, int64 Length)
+	{
+		FScopeLock ScopedLock(&CriticalSection);
+		for (int32 Index = 0; Index < Blocks.Num(); Index++)
+		{
+			FCachedBlock& Block = Blocks[Index];
+			if (Block.BlockOffset == BlockOffset && Offset + Length <= Block.Size)
+			{
+				FMemory::Memcpy(Dest, Block.Data + Offset, Length);
+				Block.LastUsed = ++UseCounter;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Adds a decompressed block, replacing the least recently used one if the cache is full.
+	 *
+	 * @param BlockOffset Offset of the compressed block in the pak file.
+	 * @param Data Decompressed data.
+	 * @param Size Size of the decompressed data.
+	 */
+	void Add(int64 BlockOffset, const uint8* Data, int64 Size)
+	{
+		FScopeLock ScopedLock(&CriticalSection);
+		FCachedBlock* Block = nullptr;
+		for (int32 Index = 0; Index < Blocks.Num(); Index++)
+		{
+			if (Blocks[Index].BlockOffset == BlockOffset)
+			{
+				// Another thread got here first.
+				Blocks[Index].LastUsed = ++UseCounter;
+				return;
+			}
+			if (Block == nullptr || Blocks[Index].LastUsed < Block->LastUsed)
+			{
+				Block = &Blocks[Index];
+			}
+		}
+		if (Blocks.Num() < MaxCachedBlocks)
+		{
+			Block = &Blocks[Blocks.AddZeroed()];
+		}
+		if (Block->Capacity < Size)
+		{
+			Block->Data = (uint8*)FMemory::Realloc(Block->Data, Size);
+			Block->Capacity = Size;
+		}
+		FMemory::Memcpy(Block->Data, Data, Size);
+		Block->BlockOffset = BlockOffset;
+		Block->Size = Size;
+		Block->LastUsed = ++UseCounter;
+	}
+};
+
+/**
+ * Class to handle correctly reading from a compressed file within a pak
+ *
+ * All compressed blocks a read touches are read from the pak with a single request and then decrypted
+ * and decompressed in parallel on the task graph. Blocks that are only partially read are cached.
+ */
+template< typename EncryptionPolicy = FPakNoEncryption >
+class FPakCompressedReaderPolicy
+{
+public:
+	enum
+	{
+		/** Maximum number of blocks that are read and decompressed at once. */
+		MaxBlocksPerBatch = 16,
+	};
+
+	/** A single block to decrypt and decompress. */
+	struct FPakUncompressBlock
+	{
+		uint8*				UncompressedBuffer;
+		int32				UncompressedSize;
+		uint8*				CompressedBuffer;
+		int32				CompressedSize;
+		ECompressionFlags	Flags;
+		void*				CopyOut;
+		int64				CopyOffset;
+		int64				CopyLength;
+		/** Offset of the compressed block in the pak file, used as the block cache key. */
+		int64				BlockOffset;
+
+		void DoWork()
+		{
+			// Decrypt and Uncompress from memory to memory.
+			int64 EncryptionSize = EncryptionPolicy::AlignReadRequest(CompressedSize);
+			EncryptionPolicy::DecryptBlock(CompressedBuffer, EncryptionSize);
+			FCompression::UncompressMemory(Flags, UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize, false);
+			if (CopyOut)
+			{
+				FMemory::Memcpy(CopyOut, UncompressedBuffer+CopyOffset, CopyLength);
+			}
+		}
+	};
+
+	typedef TArray<FPakUncompressBlock, TInlineAllocator<MaxBlocksPerBatch>> FPakUncompressBlockArray;
+
+	/**
+	 * Blocks that are decompressed in parallel.
+	 *
+	 * The reading thread and the task graph workers claim blocks until none are left. Batches are reference
+	 * counted, so tasks that only start after the read has finished find no work and never touch its buffers.
+	 */
+	class FPakUncompressBatch
+	{
+	public:
+		FPakUncompressBlockArray Blocks;
+		FThreadSafeCounter NextBlock;
+		FThreadSafeCounter NumCompletedBlocks;
+
+		void DoWork()
+		{
+			int32 BlockIndex;
+			while ((BlockIndex = NextBlock.Increment() - 1) < Blocks.Num())
+			{
+				Blocks[BlockIndex].DoWork();
+				NumCompletedBlocks.Increment();
+			}
+		}
+	};
+
+	typedef TSharedRef<FPakUncompressBatch, ESPMode::ThreadSafe> FPakUncompressBatchRef;
+
+	/** Task that helps decompressing a batch on a task graph worker. */
+	class FPakUncompressTask
+	{
+		FPakUncompressBatchRef Batch;
+
+	public:
+		FPakUncompressTask(const FPakUncompressBatchRef& InBatch)
+			: Batch(InBatch)
+		{}
+
+		void DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+		{
+			Batch->DoWork();
+		}
+
+		static ENamedThreads::Type GetDesiredThread()
+		{
+			return ENamedThreads::AnyThread;
+		}
+
+		static ESubsequentsMode::Type GetSubsequentsMode()
+		{
+			return ESubsequentsMode::FireAndForget;
+		}
+
+		FORCEINLINE TStatId GetStatId() const
+		{
+			RETURN_QUICK_DECLARE_CYCLE_STAT(FPakUncompressTask, STATGROUP_TaskGraphTasks);
+		}
+	};
+
+	FPakCompressedReaderPolicy(const FPakFile& InPakFile, const FPakEntry& InPakEntry, FArchive* InPakReader)
+		: PakFile(InPakFile)
+		, PakEntry(InPakEntry)
+		, PakReader(InPakReader)
+	{
+	}
+
+	/** Pak file that own this file data */
+	const FPakFile&		PakFile;
+	/** Pak file entry for this file. */
+	const FPakEntry&	PakEntry;
+	/** Pak file archive to read the data from. */
+	FArchive*			PakReader;
+
+	FORCEINLINE int64 FileSize() const
+	{
+		return PakEntry.UncompressedSize;
+	}
+
+	bool Serialize(int64 DesiredPosition, void* V, int64 Length)
+	{
+		const int64 CompressionBlockSize = PakEntry.CompressionBlockSize;
+		int32 CompressionBlockIndex = DesiredPosition / CompressionBlockSize;
+		int64 DirectCopyStart = DesiredPosition % CompressionBlockSize;
+		FPakBlockCache& BlockCache = PakFile.GetBlockCache();
+		FCompressionScratchBuffers& ScratchSpace = FCompressionScratchBuffers::Get();
+
+		// Only grow the scratch buffer as much as this read needs, so small reads don't allocate a full batch.
+		const int32 NumBlocks = (int32)((DesiredPosition + Length - 1) / CompressionBlockSize) - CompressionBlockIndex + 1;
+		int64 WorkingBufferRequiredSize = FCompression::CompressMemoryBound((ECompressionFlags)PakEntry.CompressionMethod,CompressionBlockSize);
+		WorkingBufferRequiredSize = EncryptionPolicy::AlignReadRequest(WorkingBufferRequiredSize);
+		ScratchSpace.EnsureBufferSpace(CompressionBlockSize * 2, WorkingBufferRequiredSize * FMath::Min<int32>(NumBlocks, MaxBlocksPerBatch));
+
+		while (Length > 0)
+		{
+			FPakUncompressBlockArray Blocks;
+			int64 ReadStart = 0;
+			int64 ReadEnd = 0;
+			int32 NumPartialBlocks = 0;
+
+			// Gather the blocks of the next batch, copying cached ones right away
+			while (Length > 0 && Blocks.Num() < MaxBlocksPerBatch)
+			{
+				const FPakCompressedBlock& Block = PakEntry.CompressionBlocks[CompressionBlockIndex];
+				int64 Pos = CompressionBlockIndex * CompressionBlockSize;
+				int64 CompressedBlockSize = Block.CompressedEnd-Block.CompressedStart;
+				int64 UncompressedBlockSize = FMath::Min<int64>(PakEntry.UncompressedSize-Pos, CompressionBlockSize);
+				int64 WriteSize = FMath::Min<int64>(UncompressedBlockSize - DirectCopyStart, Length);
+				bool bPartialBlock = WriteSize < UncompressedBlockSize;
+
+				if (!BlockCache.Read(Block.CompressedStart, V, DirectCopyStart, WriteSize))
+				{
+					// Blocks are stored back to back, so all blocks of a batch can be read with a single request
+					int64 BlockReadEnd = Block.CompressedStart + EncryptionPolicy::AlignReadRequest(CompressedBlockSize);
+					if (Blocks.Num() > 0 && (Block.CompressedStart < ReadEnd || BlockReadEnd - ReadStart > ScratchSpace.ScratchBufferSize))
+					{
+						break;
+					}
+					if (Blocks.Num() == 0)
+					{
+						ReadStart = Block.CompressedStart;
+					}
+					ReadEnd = BlockReadEnd;
+
+					FPakUncompressBlock& BlockDetails = Blocks[Blocks.AddUninitialized()];
+					BlockDetails.Flags = (ECompressionFlags)PakEntry.CompressionMethod;
+					BlockDetails.UncompressedSize = UncompressedBlockSize;
+					BlockDetails.CompressedBuffer = ScratchSpace.ScratchBuffer + (Block.CompressedStart - ReadStart);
+					BlockDetails.CompressedSize = CompressedBlockSize;
+					BlockDetails.BlockOffset = Block.CompressedStart;
+					if (!bPartialBlock)
+					{
+						// Block can be decompressed directly into output buffer
+						BlockDetails.UncompressedBuffer = (uint8*)V;
+						BlockDetails.CopyOut = nullptr;
+					}
+					else
+					{
+						// Block needs to be copied from a working buffer (only the first and last block of a read can be partial)
+						check(NumPartialBlocks < 2);
+						BlockDetails.UncompressedBuffer = ScratchSpace.TempBuffer + CompressionBlockSize * NumPartialBlocks++;
+						BlockDetails.CopyOut = V;
+						BlockDetails.CopyOffset = DirectCopyStart;
+						BlockDetails.CopyLength = WriteSize;
+					}
+				}
+
+				V = (void*)((uint8*)V + WriteSize);
+				Length -= WriteSize;
+				DirectCopyStart = 0;
+				++CompressionBlockIndex;
+			}
+
+			if (Blocks.Num() > 0)
+			{
+				PakReader->Seek(ReadStart);
+				PakReader->Serialize(ScratchSpace.ScratchBuffer, ReadEnd - ReadStart);
+				UncompressBlocks(Blocks);
+
+				for (int32 BlockIndex = 0; BlockIndex < Blocks.Num(); ++BlockIndex)
+				{
+					if (Blocks[BlockIndex].CopyOut)
+					{
+						BlockCache.Add(Blocks[BlockIndex].BlockOffset, Blocks[BlockIndex].UncompressedBuffer, Blocks[BlockIndex].UncompressedSize);
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+private:
+
+	/**
+	 * Decrypts and decompresses blocks, using the task graph workers if there is more than one block.
+	 *
+	 * @param Blocks Blocks to decompress.
+	 */
+	void UncompressBlocks(FPakUncompressBlockArray& Blocks)
+	{
+		if (Blocks.Num() == 1)
+		{
+			Blocks[0].DoWork();
+			return;
+		}
+
+		FPakUncompressBatchRef Batch = MakeShareable(new FPakUncompressBatch());
+		Batch->Blocks.Append(Blocks);
+
+		const int32 NumTasks = FMath::Min<int32>(Blocks.Num() - 1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+		for (int32 TaskIndex = 0; TaskIndex < NumTasks; ++TaskIndex)
+		{
+			TGraphTask<FPakUncompressTask>::CreateTask().ConstructAndDispatchWhenReady(Batch);
+		}
+
+		// This thread helps out rather than waiting for the tasks, so a busy task graph can't stall the read.
+		Batch->DoWork();
+
+		// Only blocks claimed by workers can still be in flight, wait for them to finish.
+		while (Batch->NumCompletedBlocks.GetValue() < Batch->Blocks.Num())
+		{
+			FPlatformProcess::Sleep(0.0f);
+		}
+	}
+};
+
+/**
+ * Region of a file in a mapped pak file. It points into the mapping of the whole pak file, which stays mapped
+ * while the pak file is mounted, so there is nothing to unmap.
+ */
+class FPakMappedFileRegion : public IMappedFileRegion
+{
+	/** Mapping of the whole pak file. */
+	IMappedFileRegion& PakRegion;
+
+public:
+	FPakMappedFileRegion(IMappedFileRegion& InPakRegion, const uint8* InMappedPtr, int64 InMappedSize)
+		: IMappedFileRegion(InMappedPtr, InMappedSize)
+		, PakRegion(InPakRegion)
+	{
+	}
+
+	virtual void PreloadHint(int64 PreloadOffset, int64 BytesToPreload) override
+	{
+		check(PreloadOffset >= 0 && PreloadOffset <= GetMappedSize());
+		if (BytesToPreload < 0 || BytesToPreload > GetMappedSize() - PreloadOffset)
+		{
+			BytesToPreload = GetMappedSize() - PreloadOffset;
+		}
+		PakRegion.PreloadHint(GetMappedPtr() - PakRegion.GetMappedPtr() + PreloadOffset, BytesToPreload);
+	}
+};
+
+/**
+ * Memory mapped handle of an uncompressed, unencrypted file in a mapped pak file.
+ */
+class FPakMappedFileHandle : public IMappedFileHandle
+{
+	/** Mapping of the whole pak file. */
+	IMappedFileRegion& PakRegion;
+	/** Offset to the file data in the pak file (excluding the file header). */
+	int64 OffsetToFile;
+
+public:
+	FPakMappedFileHandle(const FPakFile& PakFile, const FPakEntry& PakEntry)
+		: IMappedFileHandle(PakEntry.Size)
+		, PakRegion(*PakFile.GetMappedRegion())
+		, OffsetToFile(PakEntry.Offset + PakEntry.GetSerializedSize(PakFile.GetInfo().Version))
+	{
+	}
+
+	virtual IMappedFileRegion* MapRegion(int64 Offset, int64 BytesToMap, bool bPreloadHint) override
+	{
+		check(Offset >= 0 && Offset <= GetFileSize());
+		if (BytesToMap < 0 || BytesToMap > GetFileSize() - Offset)
+		{
+			BytesToMap = GetFileSize() - Offset;
+		}
+		FPakMappedFileRegion* Region = new FPakMappedFileRegion(PakRegion, PakRegion.GetMappedPtr() + OffsetToFile + Offset, BytesToMap);
+		if (bPreloadHint)
+		{
+			Region->PreloadHint(0, BytesToMap);
+		}
+		return Region;
+	}
+};
@@ -0,0 +1,498 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "PakFilePrivatePCH.h"
+#include "IPlatformFilePak.h"
+#include "PakFileReaders.h"
+#include "SecureHash.h"
+#include "AutomationTest.h"
+
+/*------------------------------------------------------------------------------
+	Benchmarks for reading pak entries.
+------------------------------------------------------------------------------*/
+
+/**
+ * Writes a pak file with a single entry, the way UnrealPak does.
+ *
+ * @param PakFilename Pak file to write.
+ * @param MountPoint Mount point of the pak file.
+ * @param Filename Filename of the entry, relative to the mount point.
+ * @param Entry Entry to write, its offset is set to the start of the pak file.
+ * @param Data Data of the entry, as it is stored in the pak file.
+ * @return true if the pak file was written, false otherwise.
+ */
+static bool WriteSingleEntryPakFile(const FString& PakFilename, const FString& MountPoint, const FString& Filename, FPakEntry& Entry, const TArray<uint8>& Data)
+{
+	TAutoPtr<FArchive> PakWriter(IFileManager::Get().CreateFileWriter(*PakFilename));
+	if (!PakWriter.IsValid())
+	{
+		return false;
+	}
+
+	FPakInfo Info;
+	Entry.Offset = 0;
+	Entry.Serialize(*PakWriter, FPakInfo::PakFile_Version_Latest);
+	PakWriter->Serialize((void*)Data.GetData(), Data.Num());
+	Info.IndexOffset = PakWriter->Tell();
+
+	TArray<FString> Filenames;
+	TArray<FPakEntry> Entries;
+	Filenames.Add(Filename);
+	Entries.Add(Entry);
+	FPakIndex Index;
+	Index.Build(Filenames, Entries);
+
+	TArray<uint8> IndexData;
+	FMemoryWriter IndexWriter(IndexData);
+	FString IndexMountPoint(MountPoint);
+	IndexWriter << IndexMountPoint;
+	Index.Serialize(IndexWriter, Info.Version);
+	PakWriter->Serialize(IndexData.GetData(), IndexData.Num());
+
+	FSHA1::HashBuffer(IndexData.GetData(), IndexData.Num(), Info.IndexHash);
+	Info.IndexSize = IndexData.Num();
+	Info.Serialize(*PakWriter);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPakCompressedReadBenchmark, "Core.PakFile.CompressedReadBenchmark", EAutomationTestFlags::ATF_Editor)
+
+bool FPakCompressedReadBenchmark::RunTest(const FString& Parameters)
+{
+	const int64 FileSize = 32 * 1024 * 1024;
+	const int32 CompressionBlockSize = 64 * 1024;
+	const int64 SmallReadSize = 4 * 1024;
+	const FString PakFilename = FPaths::AutomationTransientDir() / TEXT("CompressedReadBenchmark.pak");
+	const FString MountPoint(TEXT("/Benchmark/"));
+	const FString Filename(TEXT("Benchmark.bin"));
+
+	// Generate data that compresses about as well as cooked content, by repeating earlier runs of random bytes.
+	TArray<uint8> SourceData;
+	SourceData.AddUninitialized(FileSize);
+	FRandomStream Random(0x5A6F12E1);
+	for (int64 RunStart = 0; RunStart < FileSize; RunStart += 256)
+	{
+		const int64 RunSize = FMath::Min<int64>(256, FileSize - RunStart);
+		if (RunStart >= 4096 && Random.FRand() < 0.7f)
+		{
+			const int64 CopyStart = RunStart - 256 * Random.RandRange(1, 16);
+			FMemory::Memcpy(SourceData.GetData() + RunStart, SourceData.GetData() + CopyStart, RunSize);
+		}
+		else
+		{
+			for (int64 Index = RunStart; Index < RunStart + RunSize; Index++)
+			{
+				SourceData[Index] = (uint8)Random.GetUnsignedInt();
+			}
+		}
+	}
+
+	// Compress it the way UnrealPak does.
+	FPakEntry Entry;
+	TArray<uint8> CompressedData;
+	const int32 NumBlocks = (FileSize + CompressionBlockSize - 1) / CompressionBlockSize;
+	Entry.CompressionMethod = COMPRESS_ZLIB;
+	Entry.CompressionBlockSize = CompressionBlockSize;
+	Entry.CompressionBlocks.AddUninitialized(NumBlocks);
+	Entry.UncompressedSize = FileSize;
+	Entry.Offset = 0;
+	const int64 HeaderSize = Entry.GetSerializedSize(FPakInfo::PakFile_Version_Latest);
+	const int32 CompressedBufferSize = FCompression::CompressMemoryBound(COMPRESS_ZLIB, CompressionBlockSize);
+	for (int32 BlockIndex = 0; BlockIndex < NumBlocks; BlockIndex++)
+	{
+		const int32 BlockSize = (int32)FMath::Min<int64>(CompressionBlockSize, FileSize - (int64)BlockIndex * CompressionBlockSize);
+		int32 CompressedBlockSize = CompressedBufferSize;
+		const int32 CompressedStart = CompressedData.AddUninitialized(CompressedBufferSize);
+		if (!FCompression::CompressMemory(COMPRESS_ZLIB, CompressedData.GetData() + CompressedStart, CompressedBlockSize, SourceData.GetData() + (int64)BlockIndex * CompressionBlockSize, BlockSize))
+		{
+			AddError(TEXT("Failed to compress the benchmark data."));
+			return false;
+		}
+		CompressedData.SetNum(CompressedStart + CompressedBlockSize);
+		Entry.CompressionBlocks[BlockIndex].CompressedStart = HeaderSize + CompressedStart;
+		Entry.CompressionBlocks[BlockIndex].CompressedEnd = HeaderSize + CompressedStart + CompressedBlockSize;
+	}
+	Entry.Size = CompressedData.Num();
+	FSHA1::HashBuffer(CompressedData.GetData(), CompressedData.Num(), Entry.Hash);
+
+	if (!WriteSingleEntryPakFile(PakFilename, MountPoint, Filename, Entry, CompressedData))
+	{
+		AddError(FString::Printf(TEXT("Unable to create pak file \"%s\"."), *PakFilename));
+		return false;
+	}
+
+	{
+		FPakFile PakFile(*PakFilename, false);
+		const FPakEntry* PakEntry = PakFile.IsValid() ? PakFile.Find(MountPoint + Filename) : NULL;
+		if (PakEntry == NULL)
+		{
+			AddError(FString::Printf(TEXT("Unable to open pak file \"%s\"."), *PakFilename));
+			return false;
+		}
+
+		FPakFileHandle< FPakCompressedReaderPolicy<> > Handle(PakFile, *PakEntry, PakFile.GetSharedReader(NULL), true);
+		TArray<uint8> ReadData;
+		ReadData.AddZeroed(FileSize);
+		const double FileSizeMB = FileSize / (1024.0 * 1024.0);
+
+		// Cold: the whole file at once, all blocks are decompressed in parallel.
+		double StartTime = FPlatformTime::Seconds();
+		bool bReadSucceeded = Handle.Seek(0) && Handle.Read(ReadData.GetData(), FileSize);
+		double ReadTime = FPlatformTime::Seconds() - StartTime;
+		TestTrue(TEXT("Reading the whole file must return the original data"), bReadSucceeded && FMemory::Memcmp(ReadData.GetData(), SourceData.GetData(), FileSize) == 0);
+		AddLogItem(FString::Printf(TEXT("Single %.0f MB read (cold): %.3f s, %.1f MB/s"), FileSizeMB, ReadTime, FileSizeMB / ReadTime));
+
+		// Small sequential reads, each block is decompressed once and served from the block cache afterwards.
+		FMemory::Memzero(ReadData.GetData(), FileSize);
+		StartTime = FPlatformTime::Seconds();
+		bReadSucceeded = Handle.Seek(0);
+		for (int64 Offset = 0; Offset < FileSize && bReadSucceeded; Offset += SmallReadSize)
+		{
+			bReadSucceeded = Handle.Read(ReadData.GetData() + Offset, FMath::Min<int64>(SmallReadSize, FileSize - Offset));
+		}
+		ReadTime = FPlatformTime::Seconds() - StartTime;
+		TestTrue(TEXT("Reading the file in small chunks must return the original data"), bReadSucceeded && FMemory::Memcmp(ReadData.GetData(), SourceData.GetData(), FileSize) == 0);
+		AddLogItem(FString::Printf(TEXT("%lld KB sequential reads (cold): %.3f s, %.1f MB/s"), SmallReadSize / 1024, ReadTime, FileSizeMB / ReadTime));
+
+		// Warm: small random reads within as many blocks as the cache holds.
+		const int32 NumRandomReads = 16 * 1024;
+		const int64 WarmRegionSize = (int64)FPakBlockCache::MaxCachedBlocks * CompressionBlockSize;
+		uint8 RandomReadData[SmallReadSize];
+		for (int64 Offset = 0; Offset < WarmRegionSize; Offset += CompressionBlockSize)
+		{
+			Handle.Seek(Offset);
+			Handle.Read(RandomReadData, SmallReadSize);
+		}
+		StartTime = FPlatformTime::Seconds();
+		bReadSucceeded = true;
+		for (int32 ReadIndex = 0; ReadIndex < NumRandomReads && bReadSucceeded; ReadIndex++)
+		{
+			const int64 Offset = Random.RandRange(0, WarmRegionSize - SmallReadSize);
+			bReadSucceeded = Handle.Seek(Offset) && Handle.Read(RandomReadData, SmallReadSize) && FMemory::Memcmp(RandomReadData, SourceData.GetData() + Offset, SmallReadSize) == 0;
+		}
+		ReadTime = FPlatformTime::Seconds() - StartTime;
+		TestTrue(TEXT("Random reads must return the original data"), bReadSucceeded);
+		AddLogItem(FString::Printf(TEXT("%lld KB random reads (warm): %d reads in %.3f s, %.1f MB/s"), SmallReadSize / 1024, NumRandomReads, ReadTime, NumRandomReads * SmallReadSize / (1024.0 * 1024.0) / ReadTime));
+	}
+
+	IFileManager::Get().Delete(*PakFilename);
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPakMappedReadBenchmark, "Core.PakFile.MappedReadBenchmark", EAutomationTestFlags::ATF_Editor)
+
+bool FPakMappedReadBenchmark::RunTest(const FString& Parameters)
+{
+	const int64 FileSize = 32 * 1024 * 1024;
+	const int64 SmallReadSize = 4 * 1024;
+	const int32 NumRandomReads = 64 * 1024;
+	const FString PakFilename = FPaths::AutomationTransientDir() / TEXT("MappedReadBenchmark.pak");
+	const FString MountPoint(TEXT("/Benchmark/"));
+	const FString Filename(TEXT("Benchmark.bin"));
+
+	TArray<uint8> SourceData;
+	SourceData.AddUninitialized(FileSize);
+	FRandomStream Random(0x1D3A6B05);
+	for (int64 Index = 0; Index < FileSize; Index++)
+	{
+		SourceData[Index] = (uint8)Random.GetUnsignedInt();
+	}
+
+	FPakEntry Entry;
+	Entry.Size = FileSize;
+	Entry.UncompressedSize = FileSize;
+	FSHA1::HashBuffer(SourceData.GetData(), SourceData.Num(), Entry.Hash);
+	if (!WriteSingleEntryPakFile(PakFilename, MountPoint, Filename, Entry, SourceData))
+	{
+		AddError(FString::Printf(TEXT("Unable to create pak file \"%s\"."), *PakFilename));
+		return false;
+	}
+
+	{
+		FPakFile PakFile(&IPlatformFile::GetPlatformPhysical(), *PakFilename, false);
+		const FPakEntry* PakEntry = PakFile.IsValid() ? PakFile.Find(MountPoint + Filename) : NULL;
+		if (PakEntry == NULL)
+		{
+			AddError(FString::Printf(TEXT("Unable to open pak file \"%s\"."), *PakFilename));
+			return false;
+		}
+
+		// Small random reads through the pak file archive, then through the mapping.
+		uint8 ReadData[SmallReadSize];
+		for (int32 Pass = 0; Pass < 2; Pass++)
+		{
+			if (Pass == 1 && !PakFile.Map(&IPlatformFile::GetPlatformPhysical()))
+			{
+				AddLogItem(TEXT("Pak files can't be mapped on this platform."));
+				break;
+			}
+
+			FPakFileHandle<> Handle(PakFile, *PakEntry, PakFile.GetSharedReader(&IPlatformFile::GetPlatformPhysical()), true);
+			FRandomStream ReadRandom(0x2B9E4C17);
+			bool bReadSucceeded = true;
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 ReadIndex = 0; ReadIndex < NumRandomReads && bReadSucceeded; ReadIndex++)
+			{
+				const int64 Offset = ReadRandom.RandRange(0, (int32)(FileSize - SmallReadSize));
+				bReadSucceeded = Handle.Seek(Offset) && Handle.Read(ReadData, SmallReadSize) && FMemory::Memcmp(ReadData, SourceData.GetData() + Offset, SmallReadSize) == 0;
+			}
+			const double ReadTime = FPlatformTime::Seconds() - StartTime;
+			TestTrue(TEXT("Random reads must return the original data"), bReadSucceeded);
+			AddLogItem(FString::Printf(TEXT("%lld KB random reads (%s): %d reads in %.3f s, %.1f MB/s"), SmallReadSize / 1024, Pass == 0 ? TEXT("archive") : TEXT("mapped"), NumRandomReads, ReadTime, NumRandomReads * SmallReadSize / (1024.0 * 1024.0) / ReadTime));
+		}
+
+		// Mapped regions point straight at the data in the pak file.
+		if (PakFile.GetMappedRegion() != NULL)
+		{
+			FPakMappedFileHandle MappedHandle(PakFile, *PakEntry);
+			TAutoPtr<IMappedFileRegion> Region(MappedHandle.MapRegion(SmallReadSize));
+			TestTrue(TEXT("Mapped regions must cover the rest of the file"), Region.IsValid() && Region->GetMappedSize() == FileSize - SmallReadSize);
+			TestTrue(TEXT("Mapped regions must contain the original data"), Region.IsValid() && FMemory::Memcmp(Region->GetMappedPtr(), SourceData.GetData() + SmallReadSize, FileSize - SmallReadSize) == 0);
+
+			// An index pointing past the end of the mapping fails the read instead of reading outside of it.
+			uint8 CorruptReadData[SmallReadSize];
+			FPakEntry CorruptEntry(*PakEntry);
+			CorruptEntry.Offset = PakFile.GetMappedSize() - 1;
+			TestFalse(TEXT("Entry headers past the end of the mapping must fail verification"), PakFile.VerifyEntryHeader(CorruptEntry, *PakFile.GetSharedReader(&IPlatformFile::GetPlatformPhysical())));
+			CorruptEntry.Verified = true;
+			FPakFileHandle<> CorruptHandle(PakFile, CorruptEntry, PakFile.GetSharedReader(&IPlatformFile::GetPlatformPhysical()), true);
+			TestFalse(TEXT("Reads past the end of the mapping must fail"), CorruptHandle.Read(CorruptReadData, SmallReadSize));
+		}
+	}
+
+	IFileManager::Get().Delete(*PakFilename);
+
+	return true;
+}
+
+
+namespace PakIndexBenchmark
+{
+	/** Directory of the index that pak files used before PakFile_Version_FlatIndex. */
+	typedef TMap<FString, FPakEntry*> FLegacyDirectory;
+
+	/** The index that pak files used before PakFile_Version_FlatIndex, for comparison. */
+	struct FLegacyIndex
+	{
+		TArray<FPakEntry> Files;
+		TMap<FString, FLegacyDirectory> Index;
+
+		void Load(FArchive& IndexReader, int32 Version)
+		{
+			int32 NumEntries = 0;
+			IndexReader << NumEntries;
+			Files.Empty(NumEntries);
+
+			for (int32 EntryIndex = 0; EntryIndex < NumEntries; EntryIndex++)
+			{
+				FPakEntry Entry;
+				FString Filename;
+				IndexReader << Filename;
+				Entry.Serialize(IndexReader, Version);
+				Files.Add(Entry);
+
+				FString Path = FPaths::GetPath(Filename);
+				FPakFile::MakeDirectoryFromPath(Path);
+				FLegacyDirectory* Directory = Index.Find(Path);
+				if (Directory != NULL)
+				{
+					Directory->Add(Filename, &Files.Last());
+				}
+				else
+				{
+					FLegacyDirectory NewDirectory;
+					NewDirectory.Add(Filename, &Files.Last());
+					Index.Add(Path, NewDirectory);
+
+					int32 Offset = 0;
+					while (Path.Len() > 0)
+					{
+						Path = Path.Left(Path.Len() - 1);
+						if (!Path.FindLastChar('/', Offset))
+						{
+							break;
+						}
+						Path = Path.Left(Offset);
+						FPakFile::MakeDirectoryFromPath(Path);
+						if (Index.Find(Path) == NULL)
+						{
+							Index.Add(Path, FLegacyDirectory());
+						}
+					}
+				}
+			}
+		}
+
+		const FPakEntry* Find(const FString& MountPoint, const FString& Filename) const
+		{
+			const FPakEntry* const* FoundFile = NULL;
+			if (Filename.StartsWith(MountPoint))
+			{
+				FString Directory(FPaths::GetPath(Filename));
+				FPakFile::MakeDirectoryFromPath(Directory);
+				const FLegacyDirectory* PakDirectory = Directory.StartsWith(MountPoint) ? Index.Find(Directory.Mid(MountPoint.Len())) : NULL;
+				if (PakDirectory != NULL)
+				{
+					FoundFile = PakDirectory->Find(Filename.Mid(MountPoint.Len()));
+				}
+			}
+			return FoundFile ? *FoundFile : NULL;
+		}
+
+		uint32 GetAllocatedSize() const
+		{
+			uint32 Result = Files.GetAllocatedSize() + Index.GetAllocatedSize();
+			for (TMap<FString, FLegacyDirectory>::TConstIterator It(Index); It; ++It)
+			{
+				Result += It.Key().GetAllocatedSize() + It.Value().GetAllocatedSize();
+				for (FLegacyDirectory::TConstIterator DirectoryIt(It.Value()); DirectoryIt; ++DirectoryIt)
+				{
+					Result += DirectoryIt.Key().GetAllocatedSize();
+				}
+			}
+			return Result;
+		}
+	};
+}
+
+
+/**
+ * Compares the memory used by pak indices, their load time and the time it takes to look up files in them, between
+ * the index of PakFile_Version_FlatIndex and the nested maps used before it. The files are laid out like cooked
+ * content. Memory doesn't include allocator overhead, which the maps pay for every string.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPakIndexBenchmark, "Core.PakFile.IndexBenchmark", EAutomationTestFlags::ATF_Editor)
+
+bool FPakIndexBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace PakIndexBenchmark;
+
+	const int32 NumAreas = 40;
+	const int32 NumSetsPerArea = 50;
+	const int32 NumFilesPerSet = 100;
+	const FString MountPoint(TEXT("../../../"));
+
+	// Generate the files and both kinds of index data.
+	TArray<FString> Filenames;
+	TArray<FPakEntry> Entries;
+	for (int32 AreaIndex = 0; AreaIndex < NumAreas; AreaIndex++)
+	{
+		for (int32 SetIndex = 0; SetIndex < NumSetsPerArea; SetIndex++)
+		{
+			for (int32 FileIndex = 0; FileIndex < NumFilesPerSet; FileIndex++)
+			{
+				FPakEntry Entry;
+				Entry.Offset = (int64)Entries.Num() * 4096;
+				Entry.Size = 4096;
+				Entry.UncompressedSize = 4096;
+				Entries.Add(Entry);
+				Filenames.Add(FString::Printf(TEXT("Game/Content/Area%02d/Set%02d/Asset_%04d.uasset"), AreaIndex, SetIndex, FileIndex));
+			}
+		}
+	}
+
+	TArray<uint8> LegacyIndexData;
+	{
+		FMemoryWriter IndexWriter(LegacyIndexData);
+		int32 NumEntries = Entries.Num();
+		IndexWriter << NumEntries;
+		for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); EntryIndex++)
+		{
+			IndexWriter << Filenames[EntryIndex];
+			Entries[EntryIndex].Serialize(IndexWriter, FPakInfo::PakFile_Version_CompressionEncryption);
+		}
+	}
+
+	TArray<uint8> IndexData;
+	{
+		FPakIndex Index;
+		TestTrue(TEXT("The index must be built"), Index.Build(Filenames, Entries));
+		FMemoryWriter IndexWriter(IndexData);
+		Index.Serialize(IndexWriter, FPakInfo::PakFile_Version_Latest);
+	}
+
+	// Load both indices, the way pak files are mounted.
+	double StartTime = FPlatformTime::Seconds();
+	FLegacyIndex LegacyIndex;
+	{
+		FMemoryReader IndexReader(LegacyIndexData);
+		LegacyIndex.Load(IndexReader, FPakInfo::PakFile_Version_CompressionEncryption);
+	}
+	const double LegacyLoadTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	FPakIndex Index;
+	{
+		FMemoryReader IndexReader(IndexData);
+		TestTrue(TEXT("The index must be loaded"), Index.Serialize(IndexReader, FPakInfo::PakFile_Version_Latest));
+	}
+	const double LoadTime = FPlatformTime::Seconds() - StartTime;
+
+	TestEqual(TEXT("The index must contain all files"), Index.GetNumFiles(), Entries.Num());
+	TestEqual(TEXT("The index must contain the same directories"), Index.GetNumDirectories(), LegacyIndex.Index.Num());
+
+	AddLogItem(FString::Printf(TEXT("%d files, %d directories"), Entries.Num(), LegacyIndex.Index.Num()));
+	AddLogItem(FString::Printf(TEXT("Index data: %.2f MB (maps: %.2f MB)"), IndexData.Num() / (1024.0 * 1024.0), LegacyIndexData.Num() / (1024.0 * 1024.0)));
+	AddLogItem(FString::Printf(TEXT("Memory: %.2f MB (maps: %.2f MB)"), Index.GetAllocatedSize() / (1024.0 * 1024.0), LegacyIndex.GetAllocatedSize() / (1024.0 * 1024.0)));
+	AddLogItem(FString::Printf(TEXT("Load: %.1f ms (maps: %.1f ms)"), LoadTime * 1000.0, LegacyLoadTime * 1000.0));
+
+	// Look up all files in random order, with some differing in case, and some that don't exist.
+	TArray<FString> Lookups;
+	FRandomStream Random(0x3C71A9D5);
+	for (int32 FileIndex = 0; FileIndex < Filenames.Num(); FileIndex++)
+	{
+		FString Lookup = MountPoint + Filenames[FileIndex];
+		if (FileIndex % 10 == 0)
+		{
+			Lookup = Lookup.ToUpper();
+		}
+		else if (FileIndex % 10 == 1)
+		{
+			Lookup += TEXT(".missing");
+		}
+		Lookups.Add(Lookup);
+	}
+	for (int32 LookupIndex = Lookups.Num() - 1; LookupIndex > 0; LookupIndex--)
+	{
+		Lookups.Swap(LookupIndex, Random.RandRange(0, LookupIndex));
+	}
+
+	TArray<const FPakEntry*> LegacyResults;
+	LegacyResults.AddZeroed(Lookups.Num());
+	StartTime = FPlatformTime::Seconds();
+	for (int32 LookupIndex = 0; LookupIndex < Lookups.Num(); LookupIndex++)
+	{
+		LegacyResults[LookupIndex] = LegacyIndex.Find(MountPoint, Lookups[LookupIndex]);
+	}
+	const double LegacyLookupTime = FPlatformTime::Seconds() - StartTime;
+
+	TArray<const FPakEntry*> Results;
+	Results.AddZeroed(Lookups.Num());
+	StartTime = FPlatformTime::Seconds();
+	for (int32 LookupIndex = 0; LookupIndex < Lookups.Num(); LookupIndex++)
+	{
+		const FString& Lookup = Lookups[LookupIndex];
+		Results[LookupIndex] = Lookup.StartsWith(MountPoint) ? Index.FindFile(*Lookup + MountPoint.Len()) : NULL;
+	}
+	const double LookupTime = FPlatformTime::Seconds() - StartTime;
+
+	int32 NumMismatches = 0;
+	for (int32 LookupIndex = 0; LookupIndex < Lookups.Num(); LookupIndex++)
+	{
+		if ((Results[LookupIndex] == NULL) != (LegacyResults[LookupIndex] == NULL) || (Results[LookupIndex] != NULL && Results[LookupIndex]->Offset != LegacyResults[LookupIndex]->Offset))
+		{
+			NumMismatches++;
+		}
+	}
+	TestEqual(TEXT("Lookups must find the same files in both indices"), NumMismatches, 0);
+	AddLogItem(FString::Printf(TEXT("%d lookups: %.1f ms, %.0f ns each (maps: %.1f ms, %.0f ns each)"), Lookups.Num(), LookupTime * 1000.0, LookupTime * 1e9 / Lookups.Num(), LegacyLookupTime * 1000.0, LegacyLookupTime * 1e9 / Lookups.Num()));
+
+	// Directories and filenames must come back the way they were stored.
+	TestTrue(TEXT("Directories must be found"), Index.FindDirectory(TEXT("Game/Content/Area01/")) != INDEX_NONE && Index.FindDirectory(TEXT("Game/")) != INDEX_NONE);
+	TestTrue(TEXT("Missing directories must not be found"), Index.FindDirectory(TEXT("Game/Content/Area99/")) == INDEX_NONE);
+	const FPakEntry* FirstEntry = Index.FindFile(*Filenames[0]);
+	TestTrue(TEXT("Filenames must be kept"), FirstEntry != NULL && Index.GetFilename(Index.GetFileIndex(*FirstEntry)).Equals(Filenames[0]));
+
+	return true;
+}
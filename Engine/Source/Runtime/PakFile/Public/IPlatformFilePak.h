@@ -23,8 +23,9 @@ struct FPakInfo
 		PakFile_Version_Initial = 1,
 		PakFile_Version_NoTimestamps = 2,
 		PakFile_Version_CompressionEncryption = 3,
+		PakFile_Version_FlatIndex = 4,
 
-		PakFile_Version_Latest = PakFile_Version_CompressionEncryption
+		PakFile_Version_Latest = PakFile_Version_FlatIndex
 	};
 
 	/** Pak file magic value. */
@@ -242,8 +243,158 @@ struct FPakEntry
 	static bool VerifyPakEntriesMatch(const FPakEntry& FileEntryA, const FPakEntry& FileEntryB);
 };
 
-/** Pak directory type. */
-typedef TMap<FString, FPakEntry*> FPakDirectory;
+/**
+ * Pak file index.
+ *
+ * Entries are kept in a single array, sorted by directory. Directory and file names are stored once each in a
+ * string pool, and paths are looked up in sorted tables of their 64 bit hashes. Paths are hashed and compared in
+ * place, so lookups don't allocate. Paths are relative to the mount point, and compared case insensitively
+ * (ASCII letters only). Directories end with '/', except for the mount point itself, which is an empty path.
+ */
+class PAKFILE_API FPakIndex
+{
+public:
+	/** File in the index. */
+	struct FFile
+	{
+		/** Index of the directory the file is in. */
+		int32 DirectoryIndex;
+		/** Offset of the filename, without its directory, in the string pool. */
+		int32 NameOffset;
+
+		friend FArchive& operator<<(FArchive& Ar, FFile& File)
+		{
+			return Ar << File.DirectoryIndex << File.NameOffset;
+		}
+	};
+
+	/** Directory in the index. */
+	struct FDirectory
+	{
+		/** Offset of the directory path in the string pool. */
+		int32 NameOffset;
+		/** Index of the first file directly in this directory. */
+		int32 FirstFile;
+		/** Number of files directly in this directory. */
+		int32 NumFiles;
+
+		friend FArchive& operator<<(FArchive& Ar, FDirectory& Directory)
+		{
+			return Ar << Directory.NameOffset << Directory.FirstFile << Directory.NumFiles;
+		}
+	};
+
+	/**
+	 * Builds the index, which includes the parent directories of all files.
+	 *
+	 * @param Filenames Filenames relative to the mount point. Of files with the same name, the last one is used.
+	 * @param InEntries Entries of the files, in the same order.
+	 * @return true if the index was built, false if a filename has characters that can't be stored in the index.
+	 */
+	bool Build(const TArray<FString>& Filenames, const TArray<FPakEntry>& InEntries);
+
+	/**
+	 * Serializes the index, in the format of PakFile_Version_FlatIndex.
+	 *
+	 * @param Ar Archive to serialize data with.
+	 * @param Version Pak file version.
+	 * @return false if a loaded index is inconsistent, true otherwise.
+	 */
+	bool Serialize(FArchive& Ar, int32 Version);
+
+	/**
+	 * Finds a file.
+	 *
+	 * @param RelativeFilename Filename relative to the mount point.
+	 * @return Pointer to the entry of the file, or NULL if it isn't in the index.
+	 */
+	const FPakEntry* FindFile(const TCHAR* RelativeFilename) const;
+
+	/**
+	 * Finds a directory.
+	 *
+	 * @param RelativeDirectory Directory relative to the mount point, ending with '/'.
+	 * @return Index of the directory, or INDEX_NONE if it isn't in the index.
+	 */
+	int32 FindDirectory(const TCHAR* RelativeDirectory) const;
+
+	/** Gets the number of files. */
+	int32 GetNumFiles() const
+	{
+		return Entries.Num();
+	}
+
+	/** Gets the entry of a file. */
+	const FPakEntry& GetEntry(int32 FileIndex) const
+	{
+		return Entries[FileIndex];
+	}
+
+	/** Gets the index of a file from its entry. */
+	int32 GetFileIndex(const FPakEntry& Entry) const
+	{
+		return (int32)(&Entry - Entries.GetData());
+	}
+
+	/** Gets the filename of a file, relative to the mount point. */
+	FString GetFilename(int32 FileIndex) const;
+
+	/** Gets the number of directories. */
+	int32 GetNumDirectories() const
+	{
+		return Directories.Num();
+	}
+
+	/** Gets a directory. */
+	const FDirectory& GetDirectory(int32 DirectoryIndex) const
+	{
+		return Directories[DirectoryIndex];
+	}
+
+	/** Gets the path of a directory, relative to the mount point. */
+	FString GetDirectoryName(int32 DirectoryIndex) const;
+
+	/** Gets the memory allocated by the index. */
+	uint32 GetAllocatedSize() const;
+
+	/**
+	 * Hashes a path, ignoring the case of ASCII letters. Hashes of longer paths can be continued from
+	 * the hash of their start, so the hash of a file continues the hash of its directory.
+	 *
+	 * @param Path Path to hash.
+	 * @param Hash Hash to continue.
+	 * @return Hash of the path.
+	 */
+	static uint64 HashPath(const TCHAR* Path, uint64 Hash = 0xcbf29ce484222325ull);
+
+private:
+
+	/** Adds a null terminated name to the string pool and returns its offset. */
+	int32 AddName(const FString& Name);
+
+	/** Appends a name in the string pool to a string. */
+	void AppendName(FString& Result, int32 NameOffset) const;
+
+	/** Matches a name in the string pool against the start of a path, and returns the rest of the path, or NULL if it doesn't match. */
+	const TCHAR* MatchName(int32 NameOffset, const TCHAR* Path) const;
+
+	/** Entries of all files, sorted by directory. */
+	TArray<FPakEntry> Entries;
+	/** Names of all files, in the same order as the entries. */
+	TArray<FFile> Files;
+	/** All directories, sorted by path. */
+	TArray<FDirectory> Directories;
+	/** Sorted hashes of the paths of all files. */
+	TArray<uint64> FileHashes;
+	/** Indices of the files, in the same order as their hashes. */
+	TArray<int32> FileHashIndices;
+	/** Sorted hashes of the paths of all directories. */
+	TArray<uint64> DirectoryHashes;
+	/** Indices of the directories, in the same order as their hashes. */
+	TArray<int32> DirectoryHashIndices;
+	/** Null terminated UTF-16 names of all files and directories. */
+	TArray<uint16> NamePool;
+};
 
 /**
  * Pak file.
@@ -254,6 +405,12 @@ class PAKFILE_API FPakFile
 	FString PakFilename;
 	/** Archive to serialize the pak file from. */
 	TAutoPtr<class FChunkCacheWorker> Decryptor;
+	/** Cache of recently decompressed blocks, shared by all handles of this pak file. */
+	TAutoPtr<class FPakBlockCache> BlockCache;
+	/** Memory mapped pak file, if it is mapped. */
+	TAutoPtr<IMappedFileHandle> MappedPakHandle;
+	/** Mapping of the whole pak file. Declared after its handle, so that it is unmapped first. */
+	TAutoPtr<IMappedFileRegion> MappedPakRegion;
 	/** Map of readers assigned to threads. */
 	TMap<uint32, TAutoPtr<FArchive>> ReaderMap;
 	/** Critical section for accessing ReaderMap. */
@@ -262,10 +419,8 @@ class PAKFILE_API FPakFile
 	FPakInfo Info;
 	/** Mount point. */
 	FString MountPoint;
-	/** Info on all files stored in pak. */
-	TArray<FPakEntry> Files;	
-	/** Pak Index organized as a map of directories for faster Directory iteration. */
-	TMap<FString, FPakDirectory> Index;
+	/** Info on all files stored in pak, and their paths. */
+	FPakIndex Index;
 	/** Timestamp of this pak file. */
 	FDateTime Timestamp;	
 	/** True if this is a signed pak file. */
@@ -330,11 +485,21 @@ public:
 	 *
 	 * @return Pak index.
 	 */
-	const TMap<FString, FPakDirectory>& GetIndex() const
+	const FPakIndex& GetIndex() const
 	{
 		return Index;
 	}
 
+	/**
+	 * Gets the cache of recently decompressed blocks.
+	 *
+	 * @return Block cache.
+	 */
+	class FPakBlockCache& GetBlockCache() const
+	{
+		return *BlockCache;
+	}
+
 	/**
 	 * Gets shared pak file archive for given thrad
 	 *
@@ -342,6 +507,55 @@ public:
 	 */
 	FArchive* GetSharedReader(IPlatformFile* LowerLevel);
 
+	/**
+	 * Maps the whole pak file into memory, so that reads are served from the mapping. Must be called
+	 * before any handles are created. Signed pak files are never mapped, as their reads must be verified.
+	 *
+	 * @param LowerLevel Lower level platform file.
+	 * @return true if the pak file is mapped, false if it is signed or can't be mapped on this platform.
+	 */
+	bool Map(IPlatformFile* LowerLevel);
+
+	/**
+	 * Gets the mapping of the whole pak file.
+	 *
+	 * @return Pointer to the first byte of the pak file, or NULL if it isn't mapped.
+	 */
+	const uint8* GetMappedData() const
+	{
+		return MappedPakRegion.IsValid() ? MappedPakRegion->GetMappedPtr() : NULL;
+	}
+
+	/**
+	 * Gets the mapping of the whole pak file.
+	 *
+	 * @return The mapped region, or NULL if the pak file isn't mapped.
+	 */
+	IMappedFileRegion* GetMappedRegion() const
+	{
+		return MappedPakRegion.GetOwnedPointer();
+	}
+
+	/**
+	 * Gets the size of the mapping of the whole pak file.
+	 *
+	 * @return Number of bytes mapped, or 0 if the pak file isn't mapped.
+	 */
+	int64 GetMappedSize() const
+	{
+		return MappedPakRegion.IsValid() ? MappedPakRegion->GetMappedSize() : 0;
+	}
+
+	/**
+	 * Checks that the header stored in front of the data of an entry matches the entry in the index,
+	 * and marks the entry as verified if it does.
+	 *
+	 * @param Entry Entry to verify.
+	 * @param Reader Pak file archive to read the header from, if the pak file isn't mapped.
+	 * @return true if the header matches, false if the pak file is corrupt.
+	 */
+	bool VerifyEntryHeader(const FPakEntry& Entry, FArchive& Reader) const;
+
 	/**
 	 * Finds an entry in the pak file matching the given filename.
 	 *
@@ -350,18 +564,11 @@ public:
 	 */
 	const FPakEntry* Find(const FString& Filename) const
 	{		
-		const FPakEntry*const * FoundFile = NULL;
 		if (Filename.StartsWith(MountPoint))
 		{
-			FString Path(FPaths::GetPath(Filename));
-			const FPakDirectory* PakDirectory = FindDirectory(*Path);
-			if (PakDirectory != NULL)
-			{
-				FString RelativeFilename(Filename.Mid(MountPoint.Len()));
-				FoundFile = PakDirectory->Find(RelativeFilename);
-			}
+			return Index.FindFile(*Filename + MountPoint.Len());
 		}
-		return FoundFile ? *FoundFile : NULL;
+		return NULL;
 	}
 
 	/**
@@ -407,9 +614,10 @@ public:
 		if ((Directory.StartsWith(MountPoint)) || (MountPoint.StartsWith(Directory)))
 		{
 			TArray<FString> DirectoriesInPak; // List of all unique directories at path
-			for (TMap<FString, FPakDirectory>::TConstIterator It(Index); It; ++It)
+			for (int32 DirectoryIndex = 0; DirectoryIndex < Index.GetNumDirectories(); DirectoryIndex++)
 			{
-				FString PakPath(MountPoint + It.Key());
+				const FPakIndex::FDirectory& PakDirectory = Index.GetDirectory(DirectoryIndex);
+				FString PakPath(MountPoint + Index.GetDirectoryName(DirectoryIndex));
 				// Check if the file is under the specified path.
 				if (PakPath.StartsWith(Directory))
 				{				
@@ -418,9 +626,9 @@ public:
 						// Add everything
 						if (bIncludeFiles)
 						{
-							for (FPakDirectory::TConstIterator DirectoryIt(It.Value()); DirectoryIt; ++DirectoryIt)
+							for (int32 FileIndex = PakDirectory.FirstFile; FileIndex < PakDirectory.FirstFile + PakDirectory.NumFiles; FileIndex++)
 							{
-								OutFiles.Add(MountPoint + DirectoryIt.Key());
+								OutFiles.Add(MountPoint + Index.GetFilename(FileIndex));
 							}
 						}
 						if (bIncludeDirectories)
@@ -437,9 +645,9 @@ public:
 						// Add files in the specified folder only.
 						if (bIncludeFiles && SubDirIndex == INDEX_NONE)
 						{
-							for (FPakDirectory::TConstIterator DirectoryIt(It.Value()); DirectoryIt; ++DirectoryIt)
+							for (int32 FileIndex = PakDirectory.FirstFile; FileIndex < PakDirectory.FirstFile + PakDirectory.NumFiles; FileIndex++)
 							{
-								OutFiles.Add(MountPoint + DirectoryIt.Key());
+								OutFiles.Add(MountPoint + Index.GetFilename(FileIndex));
 							}
 						}
 						// Add sub-folders in the specified folder only
@@ -458,20 +666,20 @@ public:
 	 * Finds a directory in pak file.
 	 *
 	 * @param InPath Directory path.
-	 * @return Pointer to a map with directory contents if the directory was found, NULL otherwise.
+	 * @return Index of the directory in the pak index if the directory was found, INDEX_NONE otherwise.
 	 */
-	const FPakDirectory* FindDirectory(const TCHAR* InPath) const
+	int32 FindDirectory(const TCHAR* InPath) const
 	{
 		FString Directory(InPath);
 		MakeDirectoryFromPath(Directory);
-		const FPakDirectory* PakDirectory = NULL;
+		int32 DirectoryIndex = INDEX_NONE;
 
 		// Check the specified path is under the mount point of this pak file.
 		if (Directory.StartsWith(MountPoint))
 		{
-			PakDirectory = Index.Find(Directory.Mid(MountPoint.Len()));
+			DirectoryIndex = Index.FindDirectory(*Directory + MountPoint.Len());
 		}
-		return PakDirectory;
+		return DirectoryIndex;
 	}
 
 	/**
@@ -482,7 +690,7 @@ public:
 	 */
 	bool DirectoryExists(const TCHAR* InPath) const
 	{
-		return !!FindDirectory(InPath);
+		return FindDirectory(InPath) != INDEX_NONE;
 	}
 
 	/** Iterator class used to iterate over all files in pak. */
@@ -490,10 +698,8 @@ public:
 	{
 		/** Owner pak file. */
 		const FPakFile& PakFile;
-		/** Index iterator. */
-		TMap<FString, FPakDirectory>::TConstIterator IndexIt;
-		/** Directory iterator. */
-		FPakDirectory::TConstIterator DirectoryIt;
+		/** Index of the current file in the pak index. */
+		int32 FileIndex;
 
 	public:
 		/**
@@ -503,26 +709,13 @@ public:
 		 */
 		FFileIterator(const FPakFile& InPakFile)
 		:	PakFile(InPakFile)
-		, IndexIt(PakFile.GetIndex())
-		, DirectoryIt(IndexIt.Value())
+		, FileIndex(0)
 		{}
 
 		FFileIterator& operator++()		
 		{ 
 			// Continue with the next file
-			++DirectoryIt;
-			while (!DirectoryIt && IndexIt)
-			{
-				// No more files in the current directory, jump to the next one.
-				++IndexIt;
-				if (IndexIt)
-				{
-					// No need to check if there's files in the current directory. If a directory
-					// exists in the index it is always non-empty.
-					DirectoryIt.~TConstIterator();
-					new(&DirectoryIt) FPakDirectory::TConstIterator(IndexIt.Value());
-				}
-			}
+			++FileIndex;
 			return *this; 
 		}
 
@@ -530,7 +723,7 @@ public:
 		/** conversion to "bool" returning true if the iterator is valid. */
 		FORCEINLINE_EXPLICIT_OPERATOR_BOOL() const
 		{ 
-			return !!IndexIt; 
+			return FileIndex < PakFile.GetIndex().GetNumFiles(); 
 		}
 		/** inverse of the "bool" operator */
 		FORCEINLINE bool operator !() const
@@ -538,8 +731,8 @@ public:
 			return !(bool)*this;
 		}
 
-		const FString& Filename() const		{ return DirectoryIt.Key(); }
-		const FPakEntry& Info() const	{ return *DirectoryIt.Value(); }
+		FString Filename() const		{ return PakFile.GetIndex().GetFilename(FileIndex); }
+		const FPakEntry& Info() const	{ return PakFile.GetIndex().GetEntry(FileIndex); }
 	};
 
 	/**
@@ -622,6 +815,10 @@ public:
 	const FPakEntry&	PakEntry;
 	/** Pak file archive to read the data from. */
 	FArchive*			PakReader;
+	/** Mapping of the pak file, used instead of PakReader if the pak file is mapped. */
+	const uint8*		MappedPakData;
+	/** Size of the mapping of the pak file. */
+	int64				MappedPakSize;
 	/** Offset to the file in pak (including the file header). */
 	int64				OffsetToFile;
 
@@ -629,6 +826,8 @@ public:
 		: PakFile(InPakFile)
 		, PakEntry(InPakEntry)
 		, PakReader(InPakReader)
+		, MappedPakData(InPakFile.GetMappedData())
+		, MappedPakSize(InPakFile.GetMappedSize())
 	{
 		OffsetToFile = PakEntry.Offset + PakEntry.GetSerializedSize(PakFile.GetInfo().Version);
 	}
@@ -638,7 +837,30 @@ public:
 		return PakEntry.Size;
 	}
 
-	void Serialize(int64 DesiredPosition, void* V, int64 Length)
+	/**
+	 * Reads raw data at the given offset in the pak file.
+	 *
+	 * @return false if the data lies outside of the mapped pak file, which is corrupt then.
+	 */
+	FORCEINLINE bool ReadFromPak(int64 PakOffset, void* V, int64 Length)
+	{
+		if (MappedPakData)
+		{
+			if (PakOffset < 0 || Length < 0 || Length > MappedPakSize - PakOffset)
+			{
+				return false;
+			}
+			FMemory::Memcpy(V, MappedPakData + PakOffset, Length);
+		}
+		else
+		{
+			PakReader->Seek(PakOffset);
+			PakReader->Serialize(V, Length);
+		}
+		return true;
+	}
+
+	bool Serialize(int64 DesiredPosition, void* V, int64 Length)
 	{
 		uint8 TempBuffer[EncryptionPolicy::Alignment];
 		if (EncryptionPolicy::AlignReadRequest(DesiredPosition) != DesiredPosition)
@@ -646,8 +868,10 @@ public:
 			int64 Start = DesiredPosition & ~(EncryptionPolicy::Alignment-1);
 			int64 Offset = DesiredPosition - Start;
 			int32 CopySize = EncryptionPolicy::Alignment-(DesiredPosition-Start);
-			PakReader->Seek(OffsetToFile + Start);
-			PakReader->Serialize(TempBuffer, EncryptionPolicy::Alignment);
+			if (!ReadFromPak(OffsetToFile + Start, TempBuffer, EncryptionPolicy::Alignment))
+			{
+				return false;
+			}
 			EncryptionPolicy::DecryptBlock(TempBuffer, EncryptionPolicy::Alignment);
 			FMemory::Memcpy(V, TempBuffer+Offset, CopySize);
 			V = (void*)((uint8*)V + CopySize);
@@ -655,23 +879,26 @@ public:
 			Length -= CopySize;
 			check(DesiredPosition % EncryptionPolicy::Alignment == 0);
 		}
-		else
-		{
-			PakReader->Seek(OffsetToFile + DesiredPosition);
-		}
 		
 		int64 CopySize = Length & ~(EncryptionPolicy::Alignment-1);
-		PakReader->Serialize(V, CopySize);
+		if (!ReadFromPak(OffsetToFile + DesiredPosition, V, CopySize))
+		{
+			return false;
+		}
 		EncryptionPolicy::DecryptBlock(V, CopySize);
 		Length -= CopySize;
 		V = (void*)((uint8*)V + CopySize);
 
 		if (Length > 0)
 		{
-			PakReader->Serialize(TempBuffer, EncryptionPolicy::Alignment);
+			if (!ReadFromPak(OffsetToFile + DesiredPosition + CopySize, TempBuffer, EncryptionPolicy::Alignment))
+			{
+				return false;
+			}
 			EncryptionPolicy::DecryptBlock(TempBuffer, EncryptionPolicy::Alignment);
 			FMemory::Memcpy(V, TempBuffer, Length);
 		}
+		return true;
 	}
 };
 
@@ -738,14 +965,7 @@ public:
 		// Check that the file header is OK
 		if (!Reader.PakEntry.Verified)
 		{
-			FPakEntry FileHeader;
-			Reader.PakReader->Seek(Reader.PakEntry.Offset);
-			FileHeader.Serialize(*Reader.PakReader, Reader.PakFile.GetInfo().Version);
-			if (FPakEntry::VerifyPakEntriesMatch(Reader.PakEntry, FileHeader))
-			{
-				Reader.PakEntry.Verified = true;
-			}
-			else
+			if (!Reader.PakFile.VerifyEntryHeader(Reader.PakEntry, *Reader.PakReader))
 			{
 				//Header is corrupt, fail the read
 				return false;
@@ -755,7 +975,10 @@ public:
 		if (Reader.FileSize() >= (ReadPos + BytesToRead))
 		{
 			// Read directly from Pak.
-			Reader.Serialize(ReadPos, Destination, BytesToRead);
+			if (!Reader.Serialize(ReadPos, Destination, BytesToRead))
+			{
+				return false;
+			}
 			ReadPos += BytesToRead;
 			return true;
 		}
@@ -803,6 +1026,8 @@ class PAKFILE_API FPakPlatformFile : public IPlatformFile
 	TArray<FPakListEntry> PakFiles;
 	/** True if this we're using signed content. */
 	bool bSigned;
+	/** True if pak files are memory mapped when they are mounted. */
+	bool bMapPaks;
 	/** Synchronization object for accessing the list of currently mounted pak files. */
 	FCriticalSection PakListCritical;
 
@@ -1092,10 +1317,8 @@ public:
 		auto FileEntry = FindFileInPakFiles(Filename, &PakFile);
 		if (FileEntry)
 		{
-			const FString Path(FPaths::GetPath(Filename));
-			const FPakDirectory* PakDirectory = PakFile->FindDirectory(*Path);
-			const FString* RealFilename = PakDirectory->FindKey(const_cast<FPakEntry*>(FileEntry));
-			return *RealFilename;
+			const FPakIndex& PakIndex = PakFile->GetIndex();
+			return PakIndex.GetFilename(PakIndex.GetFileIndex(*FileEntry));
 		}
 		else
 		{
@@ -1106,6 +1329,12 @@ public:
 
 	virtual IFileHandle* OpenRead(const TCHAR* Filename) override;
 
+	/**
+	 * Opens an uncompressed, unencrypted file in a mapped pak file. Its regions point straight into the pak's
+	 * mapping, so they cost neither a copy nor a system call. Other files in pak files can't be mapped.
+	 */
+	virtual IMappedFileHandle* OpenMapped(const TCHAR* Filename) override;
+
 	virtual IFileHandle* OpenWrite(const TCHAR* Filename, bool bAppend = false, bool bAllowRead = false) override
 	{
 		// No modifications allowed on pak files.
@@ -11,6 +11,7 @@
 #include "../../Engine/Private/SkeletalRenderGPUSkin.h"		// GPrevPerBoneMotionBlur
 #include "SceneUtils.h"
 #include "PostProcessing.h"
+#include "ParallelFor.h"
 
 /*------------------------------------------------------------------------------
 	Globals
@@ -220,67 +221,108 @@ bool FViewInfo::IsDistanceCulled( float DistanceSquared, float MinDrawDistance,
 	return ( bDistanceCulled && !bStillFading );
 }
 
+static int32 GFrustumCullNumWordsPerTask = 8;
+static FAutoConsoleVariableRef CVarFrustumCullNumWordsPerTask(
+	TEXT("r.FrustumCullNumWordsPerTask"),
+	GFrustumCullNumWordsPerTask,
+	TEXT("Frustum culling is spread over the task graph in batches of this many 32 primitive words.\n")
+	TEXT("0 culls on the rendering thread only."),
+	ECVF_RenderThreadSafe
+	);
+
 /**
  * Frustum cull primitives in the scene against the view.
+ * Each task culls whole words of the visibility maps, so no two threads write to the same word.
+ * Custom visibility queries aren't required to be thread safe, so views using one are culled on this thread.
  */
 template<bool UseCustomCulling>
 static int32 FrustumCull(const FScene* Scene, FViewInfo& View)
 {
 	SCOPE_CYCLE_COUNTER(STAT_FrustumCull);
 
-	int32 NumCulledPrimitives = 0;
-	FVector ViewOriginForDistanceCulling = View.ViewMatrices.ViewOrigin;
-	float MaxDrawDistanceScale = GetCachedScalabilityCVars().ViewDistanceScale;
-	float FadeRadius = GDisableLODFade ? 0.0f : GDistanceFadeMaxTravel;
-	uint8 CustomVisibilityFlags = EOcclusionFlags::CanBeOccluded | EOcclusionFlags::HasPrecomputedVisibility;
+	FThreadSafeCounter NumCulledPrimitives;
+	const FVector ViewOriginForDistanceCulling = View.ViewMatrices.ViewOrigin;
+	const float MaxDrawDistanceScale = GetCachedScalabilityCVars().ViewDistanceScale;
+	const float FadeRadius = GDisableLODFade ? 0.0f : GDistanceFadeMaxTravel;
+	const uint8 CustomVisibilityFlags = EOcclusionFlags::CanBeOccluded | EOcclusionFlags::HasPrecomputedVisibility;
 
-	for (FSceneBitArray::FIterator BitIt(View.PrimitiveVisibilityMap); BitIt; ++BitIt)
+	const int32 BitArrayNum = View.PrimitiveVisibilityMap.Num();
+	const int32 BitArrayWords = (BitArrayNum + NumBitsPerDWORD - 1) / NumBitsPerDWORD;
+	const int32 NumWordsPerTask = FMath::Max(GFrustumCullNumWordsPerTask, 1);
+	const int32 NumTasks = (BitArrayWords + NumWordsPerTask - 1) / NumWordsPerTask;
+
+	ParallelFor(NumTasks, [&](int32 TaskIndex)
 	{
-		const FPrimitiveBounds& Bounds = Scene->PrimitiveBounds[BitIt.GetIndex()];
-		float DistanceSquared = (Bounds.Origin - ViewOriginForDistanceCulling).SizeSquared();
-		float MaxDrawDistance = Bounds.MaxDrawDistance * MaxDrawDistanceScale;
-		int32 VisibilityId = INDEX_NONE;
+		int32 NumCulledPrimitivesForTask = 0;
+		const int32 TaskWordOffset = TaskIndex * NumWordsPerTask;
 
-		if (UseCustomCulling &&
-			((Scene->PrimitiveOcclusionFlags[BitIt.GetIndex()] & CustomVisibilityFlags) == CustomVisibilityFlags))
+		for (int32 WordIndex = TaskWordOffset; WordIndex < TaskWordOffset + NumWordsPerTask && WordIndex < BitArrayWords; WordIndex++)
 		{
-			VisibilityId = Scene->PrimitiveVisibilityIds[BitIt.GetIndex()].ByteIndex;
-		}
+			uint32 VisBits = 0;
+			uint32 FadingBits = 0;
 
-		// If cull distance is disabled, always show (except foliage)
-		if (View.Family->EngineShowFlags.DistanceCulledPrimitives
-			&& !Scene->Primitives[BitIt.GetIndex()]->Proxy->IsDetailMesh())
-		{
-			MaxDrawDistance = FLT_MAX;
-		}
+			for (int32 BitSubIndex = 0; BitSubIndex < NumBitsPerDWORD && WordIndex * NumBitsPerDWORD + BitSubIndex < BitArrayNum; BitSubIndex++)
+			{
+				const uint32 Mask = 1u << BitSubIndex;
+				const int32 Index = WordIndex * NumBitsPerDWORD + BitSubIndex;
+				const FPrimitiveBounds& Bounds = Scene->PrimitiveBounds[Index];
+				float DistanceSquared = (Bounds.Origin - ViewOriginForDistanceCulling).SizeSquared();
+				float MaxDrawDistance = Bounds.MaxDrawDistance * MaxDrawDistanceScale;
+				int32 VisibilityId = INDEX_NONE;
+
+				if (UseCustomCulling &&
+					((Scene->PrimitiveOcclusionFlags[Index] & CustomVisibilityFlags) == CustomVisibilityFlags))
+				{
+					VisibilityId = Scene->PrimitiveVisibilityIds[Index].ByteIndex;
+				}
 
-		// The primitive is always culled if it exceeds the max fade distance or lay outside the view frustum.
-		if (DistanceSquared > FMath::Square(MaxDrawDistance + FadeRadius) ||
-			DistanceSquared < Bounds.MinDrawDistanceSq ||
-			(UseCustomCulling && !View.CustomVisibilityQuery->IsVisible(VisibilityId, FBoxSphereBounds(Bounds.Origin, Bounds.BoxExtent, Bounds.SphereRadius))) ||
-			View.ViewFrustum.IntersectSphere(Bounds.Origin, Bounds.SphereRadius) == false ||
-			View.ViewFrustum.IntersectBox(Bounds.Origin, Bounds.BoxExtent) == false)
-		{
-			STAT(NumCulledPrimitives++);
-			continue;
-		}
+				// If cull distance is disabled, always show (except foliage)
+				if (View.Family->EngineShowFlags.DistanceCulledPrimitives
+					&& !Scene->Primitives[Index]->Proxy->IsDetailMesh())
+				{
+					MaxDrawDistance = FLT_MAX;
+				}
 
-		if (DistanceSquared > FMath::Square(MaxDrawDistance))
-		{
-			View.PotentiallyFadingPrimitiveMap.AccessCorrespondingBit(BitIt) = true;
-		}
-		else
-		{
-			// The primitive is visible!
-			BitIt.GetValue() = true;
-			if (DistanceSquared > FMath::Square(MaxDrawDistance - FadeRadius))
+				// The primitive is always culled if it exceeds the max fade distance or lay outside the view frustum.
+				if (DistanceSquared > FMath::Square(MaxDrawDistance + FadeRadius) ||
+					DistanceSquared < Bounds.MinDrawDistanceSq ||
+					(UseCustomCulling && !View.CustomVisibilityQuery->IsVisible(VisibilityId, FBoxSphereBounds(Bounds.Origin, Bounds.BoxExtent, Bounds.SphereRadius))) ||
+					View.ViewFrustum.IntersectSphere(Bounds.Origin, Bounds.SphereRadius) == false ||
+					View.ViewFrustum.IntersectBox(Bounds.Origin, Bounds.BoxExtent) == false)
+				{
+					NumCulledPrimitivesForTask++;
+					continue;
+				}
+
+				if (DistanceSquared > FMath::Square(MaxDrawDistance))
+				{
+					FadingBits |= Mask;
+				}
+				else
+				{
+					// The primitive is visible!
+					VisBits |= Mask;
+					if (DistanceSquared > FMath::Square(MaxDrawDistance - FadeRadius))
+					{
+						FadingBits |= Mask;
+					}
+				}
+			}
+
+			if (VisBits)
 			{
-				View.PotentiallyFadingPrimitiveMap.AccessCorrespondingBit(BitIt) = true;
+				View.PrimitiveVisibilityMap.GetData()[WordIndex] |= VisBits;
+			}
+			if (FadingBits)
+			{
+				View.PotentiallyFadingPrimitiveMap.GetData()[WordIndex] |= FadingBits;
 			}
 		}
-	}
 
-	return NumCulledPrimitives;
+		NumCulledPrimitives.Add(NumCulledPrimitivesForTask);
+	}, (GFrustumCullNumWordsPerTask > 0 && !UseCustomCulling) ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+	return NumCulledPrimitives.GetValue();
 }
 
 /**
@@ -0,0 +1,108 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+
+/**
+ * Enumerates the tokens of the binary struct serialization format.
+ *
+ * Each token is written as a single byte. If bit 7 is set (see BINARY_STRUCT_NAMED_TOKEN), the token
+ * is followed by a reference to the property's name, and then by its value, if any:
+ *
+ *		Name reference:	VarInt N, N = 0 is followed by a new name (VarInt length and UTF-8 characters)
+ *						that is appended to the stream's name table, otherwise name table entry N - 1
+ *		Integer:		Zig-zag encoded VarInt
+ *		UnsignedInteger:VarInt
+ *		Float, Double:	Four or eight bytes, little endian
+ *		String:			VarInt length and UTF-8 characters
+ *		Name:			Name reference
+ *
+ * VarInts are little endian groups of seven bits, with bit 7 set in every byte but the last.
+ */
+enum class EBinaryStructToken : uint8
+{
+	StructureStart,
+	StructureEnd,
+	ArrayStart,
+	ArrayEnd,
+	Null,
+	False,
+	True,
+	Integer,
+	UnsignedInteger,
+	Float,
+	Double,
+	String,
+	Name
+};
+
+
+/** Flag set in a token byte that is followed by a name reference. */
+#define BINARY_STRUCT_NAMED_TOKEN 0x80
+
+
+namespace BinaryStructBackend
+{
+	/** Writes an unsigned integer as a VarInt. */
+	FORCEINLINE void WriteVarUInt( FArchive& Archive, uint64 Value )
+	{
+		uint8 Bytes[10];
+		int32 NumBytes = 0;
+
+		while (Value >= 0x80)
+		{
+			Bytes[NumBytes++] = (uint8)(Value | 0x80);
+			Value >>= 7;
+		}
+
+		Bytes[NumBytes++] = (uint8)Value;
+		Archive.Serialize(Bytes, NumBytes);
+	}
+
+	/** Writes a signed integer as a zig-zag encoded VarInt, so that small negative numbers stay small. */
+	FORCEINLINE void WriteVarInt( FArchive& Archive, int64 Value )
+	{
+		WriteVarUInt(Archive, ((uint64)Value << 1) ^ (uint64)(Value >> 63));
+	}
+
+	/** Reads a VarInt, @return false if it is malformed or the archive ran out of data. */
+	FORCEINLINE bool ReadVarUInt( FArchive& Archive, uint64& OutValue )
+	{
+		OutValue = 0;
+
+		for (int32 Shift = 0; Shift < 64; Shift += 7)
+		{
+			uint8 Byte = 0;
+			Archive << Byte;
+
+			if (Archive.IsError())
+			{
+				return false;
+			}
+
+			OutValue |= (uint64)(Byte & 0x7F) << Shift;
+
+			if ((Byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/** Reads a zig-zag encoded VarInt, @return false if it is malformed or the archive ran out of data. */
+	FORCEINLINE bool ReadVarInt( FArchive& Archive, int64& OutValue )
+	{
+		uint64 Value;
+
+		if (!ReadVarUInt(Archive, Value))
+		{
+			return false;
+		}
+
+		OutValue = (int64)(Value >> 1) ^ -(int64)(Value & 1);
+
+		return true;
+	}
+}
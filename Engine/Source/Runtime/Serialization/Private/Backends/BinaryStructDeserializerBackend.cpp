@@ -0,0 +1,509 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "SerializationPrivatePCH.h"
+#include "BinaryStructDeserializerBackend.h"
+#include "Backends/BinaryStructBackendTypes.h"
+
+
+/* Internal helpers
+ *****************************************************************************/
+
+namespace BinaryStructDeserializerBackend
+{
+	/**
+	 * Clears the value of the given property.
+	 *
+	 * @param Property The property to clear.
+	 * @param Outer The property that contains the property to be cleared, if any.
+	 * @param Data A pointer to the memory holding the property's data.
+	 * @param ArrayIndex The index of the element to clear (if the property is an array).
+	 * @return true on success, false otherwise.
+	 * @see SetPropertyValue
+	 */
+	bool ClearPropertyValue( UProperty* Property, UProperty* Outer, void* Data, int32 ArrayIndex )
+	{
+		UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Outer);
+
+		if (ArrayProperty != nullptr)
+		{
+			if (ArrayProperty->Inner != Property)
+			{
+				return false;
+			}
+
+			FScriptArrayHelper ArrayHelper(ArrayProperty, ArrayProperty->template ContainerPtrToValuePtr<void>(Data));
+			ArrayIndex = ArrayHelper.AddValue();
+		}
+
+		Property->ClearValue_InContainer(Data, ArrayIndex);
+
+		return true;
+	}
+
+
+	/**
+	 * Sets the value of the given property.
+	 *
+	 * @param Property The property to set.
+	 * @param Outer The property that contains the property to be set, if any.
+	 * @param Data A pointer to the memory holding the property's data.
+	 * @param ArrayIndex The index of the element to set (if the property is an array).
+	 * @return true on success, false otherwise.
+	 * @see ClearPropertyValue
+	 */
+	template<typename UPropertyType, typename PropertyType>
+	bool SetPropertyValue( UProperty* Property, UProperty* Outer, void* Data, int32 ArrayIndex, const PropertyType& Value )
+	{
+		PropertyType* ValuePtr = nullptr;
+		UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Outer);
+
+		if (ArrayProperty != nullptr)
+		{
+			if (ArrayProperty->Inner != Property)
+			{
+				return false;
+			}
+
+			FScriptArrayHelper ArrayHelper(ArrayProperty, ArrayProperty->template ContainerPtrToValuePtr<void>(Data));
+			int32 Index = ArrayHelper.AddValue();
+
+			ValuePtr = (PropertyType*)ArrayHelper.GetRawPtr(Index);
+		}
+		else
+		{
+			UPropertyType* TypedProperty = Cast<UPropertyType>(Property);
+
+			if (TypedProperty == nullptr)
+			{
+				return false;
+			}
+
+			ValuePtr = TypedProperty->template ContainerPtrToValuePtr<PropertyType>(Data, ArrayIndex);
+		}
+
+		if (ValuePtr == nullptr)
+		{
+			return false;
+		}
+
+		*ValuePtr = Value;
+
+		return true;
+	}
+
+
+	/**
+	 * Sets the value of the given numeric property, converting the value if needed.
+	 *
+	 * @return true on success, false if the property isn't numeric.
+	 */
+	template<typename ValueType>
+	bool SetNumericPropertyValue( UProperty* Property, UProperty* Outer, void* Data, int32 ArrayIndex, ValueType Value )
+	{
+		UClass* PropertyClass = Property->GetClass();
+
+		if (PropertyClass == UByteProperty::StaticClass())
+		{
+			return SetPropertyValue<UByteProperty, uint8>(Property, Outer, Data, ArrayIndex, (uint8)Value);
+		}
+
+		if (PropertyClass == UDoubleProperty::StaticClass())
+		{
+			return SetPropertyValue<UDoubleProperty, double>(Property, Outer, Data, ArrayIndex, (double)Value);
+		}
+
+		if (PropertyClass == UFloatProperty::StaticClass())
+		{
+			return SetPropertyValue<UFloatProperty, float>(Property, Outer, Data, ArrayIndex, (float)Value);
+		}
+
+		if (PropertyClass == UIntProperty::StaticClass())
+		{
+			return SetPropertyValue<UIntProperty, int32>(Property, Outer, Data, ArrayIndex, (int32)Value);
+		}
+
+		if (PropertyClass == UUInt32Property::StaticClass())
+		{
+			return SetPropertyValue<UUInt32Property, uint32>(Property, Outer, Data, ArrayIndex, (uint32)Value);
+		}
+
+		if (PropertyClass == UInt16Property::StaticClass())
+		{
+			return SetPropertyValue<UInt16Property, int16>(Property, Outer, Data, ArrayIndex, (int16)Value);
+		}
+
+		if (PropertyClass == UUInt16Property::StaticClass())
+		{
+			return SetPropertyValue<UUInt16Property, uint16>(Property, Outer, Data, ArrayIndex, (uint16)Value);
+		}
+
+		if (PropertyClass == UInt64Property::StaticClass())
+		{
+			return SetPropertyValue<UInt64Property, int64>(Property, Outer, Data, ArrayIndex, (int64)Value);
+		}
+
+		if (PropertyClass == UUInt64Property::StaticClass())
+		{
+			return SetPropertyValue<UUInt64Property, uint64>(Property, Outer, Data, ArrayIndex, (uint64)Value);
+		}
+
+		if (PropertyClass == UInt8Property::StaticClass())
+		{
+			return SetPropertyValue<UInt8Property, int8>(Property, Outer, Data, ArrayIndex, (int8)Value);
+		}
+
+		return false;
+	}
+}
+
+
+/* IStructDeserializerBackend interface
+ *****************************************************************************/
+
+const FString& FBinaryStructDeserializerBackend::GetCurrentPropertyName() const
+{
+	static const FString NoName;
+
+	return (CurrentNameIndex == INDEX_NONE) ? NoName : Names[CurrentNameIndex];
+}
+
+
+FString FBinaryStructDeserializerBackend::GetDebugString() const
+{
+	return FString::Printf(TEXT("Offset: %lld"), Archive.Tell());
+}
+
+
+const FString& FBinaryStructDeserializerBackend::GetLastErrorMessage() const
+{
+	return LastErrorMessage;
+}
+
+
+bool FBinaryStructDeserializerBackend::GetNextToken( EStructDeserializerBackendTokens& OutToken )
+{
+	using namespace BinaryStructBackend;
+
+	if (Archive.AtEnd() || Archive.IsError())
+	{
+		return false;
+	}
+
+	uint8 TokenByte = 0;
+	Archive << TokenByte;
+
+	LastToken = TokenByte & ~BINARY_STRUCT_NAMED_TOKEN;
+	CurrentNameIndex = INDEX_NONE;
+
+	if ((TokenByte & BINARY_STRUCT_NAMED_TOKEN) != 0)
+	{
+		CurrentNameIndex = ReadName();
+
+		if (CurrentNameIndex == INDEX_NONE)
+		{
+			OutToken = EStructDeserializerBackendTokens::Error;
+
+			return true;
+		}
+	}
+
+	bool Success = true;
+
+	switch ((EBinaryStructToken)LastToken)
+	{
+	case EBinaryStructToken::StructureStart:
+		OutToken = EStructDeserializerBackendTokens::StructureStart;
+		break;
+
+	case EBinaryStructToken::StructureEnd:
+		OutToken = EStructDeserializerBackendTokens::StructureEnd;
+		break;
+
+	case EBinaryStructToken::ArrayStart:
+		OutToken = EStructDeserializerBackendTokens::ArrayStart;
+		break;
+
+	case EBinaryStructToken::ArrayEnd:
+		OutToken = EStructDeserializerBackendTokens::ArrayEnd;
+		break;
+
+	case EBinaryStructToken::Null:
+	case EBinaryStructToken::False:
+	case EBinaryStructToken::True:
+		OutToken = EStructDeserializerBackendTokens::Property;
+		break;
+
+	case EBinaryStructToken::Integer:
+		OutToken = EStructDeserializerBackendTokens::Property;
+		Success = ReadVarInt(Archive, LastInteger);
+		break;
+
+	case EBinaryStructToken::UnsignedInteger:
+		OutToken = EStructDeserializerBackendTokens::Property;
+		Success = ReadVarUInt(Archive, LastUnsignedInteger);
+		break;
+
+	case EBinaryStructToken::Float:
+		{
+			float Value = 0.0f;
+			Archive << Value;
+
+			OutToken = EStructDeserializerBackendTokens::Property;
+			LastFloat = Value;
+		}
+		break;
+
+	case EBinaryStructToken::Double:
+		OutToken = EStructDeserializerBackendTokens::Property;
+		Archive << LastFloat;
+		break;
+
+	case EBinaryStructToken::String:
+		OutToken = EStructDeserializerBackendTokens::Property;
+		Success = ReadString(LastString);
+		break;
+
+	case EBinaryStructToken::Name:
+		{
+			const int32 NameIndex = ReadName();
+
+			OutToken = EStructDeserializerBackendTokens::Property;
+			Success = (NameIndex != INDEX_NONE);
+
+			if (Success)
+			{
+				LastString = Names[NameIndex];
+			}
+		}
+		break;
+
+	default:
+		LastErrorMessage = FString::Printf(TEXT("Unknown token %i"), LastToken);
+		Success = false;
+	}
+
+	if (!Success || Archive.IsError())
+	{
+		if (LastErrorMessage.IsEmpty())
+		{
+			LastErrorMessage = TEXT("Unexpected end of data or malformed value");
+		}
+
+		OutToken = EStructDeserializerBackendTokens::Error;
+	}
+
+	return true;
+}
+
+
+bool FBinaryStructDeserializerBackend::ReadProperty( UProperty* Property, UProperty* Outer, void* Data, int32 ArrayIndex )
+{
+	using namespace BinaryStructDeserializerBackend;
+
+	switch ((EBinaryStructToken)LastToken)
+	{
+	// boolean values
+	case EBinaryStructToken::False:
+	case EBinaryStructToken::True:
+		{
+			const bool BoolValue = ((EBinaryStructToken)LastToken == EBinaryStructToken::True);
+
+			if (Property->GetClass() == UBoolProperty::StaticClass())
+			{
+				return SetPropertyValue<UBoolProperty, bool>(Property, Outer, Data, ArrayIndex, BoolValue);
+			}
+
+			UE_LOG(LogSerialization, Verbose, TEXT("Boolean field %s is not supported in UProperty type %s (%s)"), *Property->GetFName().ToString(), *Property->GetClass()->GetName(), *GetDebugString());
+
+			return false;
+		}
+
+	// numeric values
+	case EBinaryStructToken::Integer:
+	case EBinaryStructToken::UnsignedInteger:
+	case EBinaryStructToken::Float:
+	case EBinaryStructToken::Double:
+		{
+			bool Success;
+
+			if ((EBinaryStructToken)LastToken == EBinaryStructToken::Integer)
+			{
+				Success = SetNumericPropertyValue(Property, Outer, Data, ArrayIndex, LastInteger);
+			}
+			else if ((EBinaryStructToken)LastToken == EBinaryStructToken::UnsignedInteger)
+			{
+				Success = SetNumericPropertyValue(Property, Outer, Data, ArrayIndex, LastUnsignedInteger);
+			}
+			else
+			{
+				Success = SetNumericPropertyValue(Property, Outer, Data, ArrayIndex, LastFloat);
+			}
+
+			if (!Success)
+			{
+				UE_LOG(LogSerialization, Verbose, TEXT("Numeric field %s is not supported in UProperty type %s (%s)"), *Property->GetFName().ToString(), *Property->GetClass()->GetName(), *GetDebugString());
+			}
+
+			return Success;
+		}
+
+	// null values
+	case EBinaryStructToken::Null:
+		return ClearPropertyValue(Property, Outer, Data, ArrayIndex);
+
+	// strings, names & enumerations
+	case EBinaryStructToken::String:
+	case EBinaryStructToken::Name:
+		{
+			if (Property->GetClass() == UStrProperty::StaticClass())
+			{
+				return SetPropertyValue<UStrProperty, FString>(Property, Outer, Data, ArrayIndex, LastString);
+			}
+
+			if (Property->GetClass() == UNameProperty::StaticClass())
+			{
+				return SetPropertyValue<UNameProperty, FName>(Property, Outer, Data, ArrayIndex, *LastString);
+			}
+
+			if (Property->GetClass() == UByteProperty::StaticClass())
+			{
+				UByteProperty* ByteProperty = Cast<UByteProperty>(Property);
+
+				if (ByteProperty->Enum == nullptr)
+				{
+					return false;
+				}
+
+				int32 Index = ByteProperty->Enum->FindEnumIndex(*LastString);
+
+				if (Index == INDEX_NONE)
+				{
+					return false;
+				}
+
+				return SetPropertyValue<UByteProperty, uint8>(Property, Outer, Data, ArrayIndex, (uint8)Index);
+			}
+
+			if (Property->GetClass() == UClassProperty::StaticClass())
+			{
+				return SetPropertyValue<UClassProperty, UClass*>(Property, Outer, Data, ArrayIndex, LoadObject<UClass>(NULL, *LastString, NULL, LOAD_NoWarn));
+			}
+
+			UE_LOG(LogSerialization, Verbose, TEXT("String field %s with value '%s' is not supported in UProperty type %s (%s)"), *Property->GetFName().ToString(), *LastString, *Property->GetClass()->GetName(), *GetDebugString());
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+void FBinaryStructDeserializerBackend::SkipArray()
+{
+	SkipScope();
+}
+
+
+void FBinaryStructDeserializerBackend::SkipStructure()
+{
+	SkipScope();
+}
+
+
+/* FBinaryStructDeserializerBackend implementation
+ *****************************************************************************/
+
+int32 FBinaryStructDeserializerBackend::ReadName()
+{
+	uint64 Reference = 0;
+
+	if (!BinaryStructBackend::ReadVarUInt(Archive, Reference))
+	{
+		return INDEX_NONE;
+	}
+
+	if (Reference == 0)
+	{
+		FString Name;
+
+		if (!ReadString(Name))
+		{
+			return INDEX_NONE;
+		}
+
+		return Names.Add(Name);
+	}
+
+	if (Reference > (uint64)Names.Num())
+	{
+		LastErrorMessage = FString::Printf(TEXT("Invalid name reference %llu"), Reference);
+
+		return INDEX_NONE;
+	}
+
+	return (int32)(Reference - 1);
+}
+
+
+bool FBinaryStructDeserializerBackend::ReadString( FString& OutString )
+{
+	uint64 Length = 0;
+
+	if (!BinaryStructBackend::ReadVarUInt(Archive, Length))
+	{
+		return false;
+	}
+
+	// don't trust the length before allocating memory for it
+	const int64 TotalSize = Archive.TotalSize();
+
+	if ((TotalSize >= 0) ? (Length > (uint64)(TotalSize - Archive.Tell())) : (Length > MAX_int32))
+	{
+		LastErrorMessage = FString::Printf(TEXT("Invalid string length %llu"), Length);
+
+		return false;
+	}
+
+	if (Length == 0)
+	{
+		OutString.Empty();
+
+		return true;
+	}
+
+	StringBuffer.Reset();
+	StringBuffer.AddUninitialized((int32)Length);
+	Archive.Serialize(StringBuffer.GetData(), Length);
+
+	FUTF8ToTCHAR Converted(StringBuffer.GetData(), (int32)Length);
+	OutString = FString(Converted.Length(), Converted.Get());
+
+	return !Archive.IsError();
+}
+
+
+void FBinaryStructDeserializerBackend::SkipScope()
+{
+	int32 Depth = 1;
+	EStructDeserializerBackendTokens Token;
+
+	while ((Depth > 0) && GetNextToken(Token))
+	{
+		switch (Token)
+		{
+		case EStructDeserializerBackendTokens::ArrayStart:
+		case EStructDeserializerBackendTokens::StructureStart:
+			++Depth;
+			break;
+
+		case EStructDeserializerBackendTokens::ArrayEnd:
+		case EStructDeserializerBackendTokens::StructureEnd:
+			--Depth;
+			break;
+
+		case EStructDeserializerBackendTokens::Error:
+			return;
+		}
+	}
+}
@@ -0,0 +1,235 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "SerializationPrivatePCH.h"
+#include "BinaryStructSerializerBackend.h"
+#include "Backends/BinaryStructBackendTypes.h"
+
+
+/* Internal helpers
+ *****************************************************************************/
+
+namespace BinaryStructSerializerBackend
+{
+	// Checks whether the given property is written as an element of an array, i.e. without its name.
+	FORCEINLINE bool IsArrayElement( UProperty* Property )
+	{
+		return (Property == nullptr) || (Property->ArrayDim > 1) || (Property->GetOuter()->GetClass() == UArrayProperty::StaticClass());
+	}
+
+	// Checks whether the given array or structure property is an element of a dynamic array.
+	FORCEINLINE bool IsInDynamicArray( UProperty* Property )
+	{
+		UObject* Outer = Property->GetOuter();
+
+		return (Outer != nullptr) && (Outer->GetClass() == UArrayProperty::StaticClass());
+	}
+}
+
+
+/* IStructSerializerBackend interface
+ *****************************************************************************/
+
+void FBinaryStructSerializerBackend::BeginArray( UProperty* Property )
+{
+	WriteToken(EBinaryStructToken::ArrayStart, BinaryStructSerializerBackend::IsInDynamicArray(Property) ? nullptr : Property);
+}
+
+
+void FBinaryStructSerializerBackend::BeginStructure( UProperty* Property )
+{
+	WriteToken(EBinaryStructToken::StructureStart, BinaryStructSerializerBackend::IsInDynamicArray(Property) ? nullptr : Property);
+}
+
+
+void FBinaryStructSerializerBackend::BeginStructure( UStruct* TypeInfo )
+{
+	WriteToken(EBinaryStructToken::StructureStart, nullptr);
+}
+
+
+void FBinaryStructSerializerBackend::EndArray( UProperty* Property )
+{
+	WriteToken(EBinaryStructToken::ArrayEnd, nullptr);
+}
+
+
+void FBinaryStructSerializerBackend::EndStructure()
+{
+	WriteToken(EBinaryStructToken::StructureEnd, nullptr);
+}
+
+
+void FBinaryStructSerializerBackend::WriteComment( const FString& Comment )
+{
+	// comments are not written
+}
+
+
+void FBinaryStructSerializerBackend::WriteProperty( UProperty* Property, const void* Data, UStruct* TypeInfo, int32 ArrayIndex )
+{
+	using namespace BinaryStructBackend;
+
+	UProperty* NamedProperty = BinaryStructSerializerBackend::IsArrayElement(Property) ? nullptr : Property;
+
+	// booleans
+	if (TypeInfo == UBoolProperty::StaticClass())
+	{
+		WriteToken(Cast<UBoolProperty>(Property)->GetPropertyValue_InContainer(Data, ArrayIndex) ? EBinaryStructToken::True : EBinaryStructToken::False, NamedProperty);
+	}
+
+	// unsigned bytes & enumerations
+	else if (TypeInfo == UByteProperty::StaticClass())
+	{
+		UByteProperty* ByteProperty = Cast<UByteProperty>(Property);
+
+		if (ByteProperty->IsEnum())
+		{
+			WriteToken(EBinaryStructToken::Name, NamedProperty);
+			WriteName(ByteProperty->Enum->GetEnum(ByteProperty->GetPropertyValue_InContainer(Data, ArrayIndex)));
+		}
+		else
+		{
+			WriteToken(EBinaryStructToken::UnsignedInteger, NamedProperty);
+			WriteVarUInt(Archive, ByteProperty->GetPropertyValue_InContainer(Data, ArrayIndex));
+		}
+	}
+
+	// floating point numbers
+	else if (TypeInfo == UDoubleProperty::StaticClass())
+	{
+		double Value = Cast<UDoubleProperty>(Property)->GetPropertyValue_InContainer(Data, ArrayIndex);
+
+		WriteToken(EBinaryStructToken::Double, NamedProperty);
+		Archive << Value;
+	}
+	else if (TypeInfo == UFloatProperty::StaticClass())
+	{
+		float Value = Cast<UFloatProperty>(Property)->GetPropertyValue_InContainer(Data, ArrayIndex);
+
+		WriteToken(EBinaryStructToken::Float, NamedProperty);
+		Archive << Value;
+	}
+
+	// signed integers
+	else if (TypeInfo == UIntProperty::StaticClass())
+	{
+		WriteToken(EBinaryStructToken::Integer, NamedProperty);
+		WriteVarInt(Archive, Cast<UIntProperty>(Property)->GetPropertyValue_InContainer(Data, ArrayIndex));
+	}
+	else if (TypeInfo == UInt8Property::StaticClass())
+	{
+		WriteToken(EBinaryStructToken::Integer, NamedProperty);
+		WriteVarInt(Archive, Cast<UInt8Property>(Property)->GetPropertyValue_InContainer(Data, ArrayIndex));
+	}
+	else if (TypeInfo == UInt16Property::StaticClass())
+	{
+		WriteToken(EBinaryStructToken::Integer, NamedProperty);
+		WriteVarInt(Archive, Cast<UInt16Property>(Property)->GetPropertyValue_InContainer(Data, ArrayIndex));
+	}
+	else if (TypeInfo == UInt64Property::StaticClass())
+	{
+		WriteToken(EBinaryStructToken::Integer, NamedProperty);
+		WriteVarInt(Archive, Cast<UInt64Property>(Property)->GetPropertyValue_InContainer(Data, ArrayIndex));
+	}
+
+	// unsigned integers
+	else if (TypeInfo == UUInt16Property::StaticClass())
+	{
+		WriteToken(EBinaryStructToken::UnsignedInteger, NamedProperty);
+		WriteVarUInt(Archive, Cast<UUInt16Property>(Property)->GetPropertyValue_InContainer(Data, ArrayIndex));
+	}
+	else if (TypeInfo == UUInt32Property::StaticClass())
+	{
+		WriteToken(EBinaryStructToken::UnsignedInteger, NamedProperty);
+		WriteVarUInt(Archive, Cast<UUInt32Property>(Property)->GetPropertyValue_InContainer(Data, ArrayIndex));
+	}
+	else if (TypeInfo == UUInt64Property::StaticClass())
+	{
+		WriteToken(EBinaryStructToken::UnsignedInteger, NamedProperty);
+		WriteVarUInt(Archive, Cast<UUInt64Property>(Property)->GetPropertyValue_InContainer(Data, ArrayIndex));
+	}
+
+	// names & strings
+	else if (TypeInfo == UNameProperty::StaticClass())
+	{
+		WriteToken(EBinaryStructToken::Name, NamedProperty);
+		WriteName(Cast<UNameProperty>(Property)->GetPropertyValue_InContainer(Data, ArrayIndex));
+	}
+	else if (TypeInfo == UStrProperty::StaticClass())
+	{
+		WriteToken(EBinaryStructToken::String, NamedProperty);
+		WriteString(Cast<UStrProperty>(Property)->GetPropertyValue_InContainer(Data, ArrayIndex));
+	}
+
+	// classes & objects
+	else if (TypeInfo == UClassProperty::StaticClass())
+	{
+		UObject* Class = Cast<UClassProperty>(Property)->GetPropertyValue_InContainer(Data, ArrayIndex);
+
+		if (Class != nullptr)
+		{
+			WriteToken(EBinaryStructToken::String, NamedProperty);
+			WriteString(Class->GetPathName());
+		}
+		else
+		{
+			WriteToken(EBinaryStructToken::Null, NamedProperty);
+		}
+	}
+	else if (TypeInfo == UObjectProperty::StaticClass())
+	{
+		WriteToken(EBinaryStructToken::Null, NamedProperty);
+	}
+
+	else
+	{
+		UE_LOG(LogSerialization, Verbose, TEXT("FBinaryStructSerializerBackend: Property %s cannot be serialized, because its type (%s) is not supported"), *Property->GetFName().ToString(), *TypeInfo->GetFName().ToString());
+	}
+}
+
+
+/* FBinaryStructSerializerBackend implementation
+ *****************************************************************************/
+
+void FBinaryStructSerializerBackend::WriteName( const FName& Name )
+{
+	const int32* Index = NameIndices.Find(Name);
+
+	if (Index != nullptr)
+	{
+		BinaryStructBackend::WriteVarUInt(Archive, *Index + 1);
+	}
+	else
+	{
+		BinaryStructBackend::WriteVarUInt(Archive, 0);
+		WriteString(Name.ToString());
+		NameIndices.Add(Name, NameIndices.Num());
+	}
+}
+
+
+void FBinaryStructSerializerBackend::WriteToken( EBinaryStructToken Token, UProperty* Property )
+{
+	uint8 TokenByte = (uint8)Token;
+
+	if (Property == nullptr)
+	{
+		Archive << TokenByte;
+	}
+	else
+	{
+		TokenByte |= BINARY_STRUCT_NAMED_TOKEN;
+		Archive << TokenByte;
+		WriteName(Property->GetFName());
+	}
+}
+
+
+void FBinaryStructSerializerBackend::WriteString( const FString& String )
+{
+	FTCHARToUTF8 Converted(*String);
+	const int32 Length = Converted.Length();
+
+	BinaryStructBackend::WriteVarUInt(Archive, Length);
+	Archive.Serialize((void*)Converted.Get(), Length);
+}
@@ -2,6 +2,8 @@
 
 #include "SerializationPrivatePCH.h"
 #include "AutomationTest.h"
+#include "BinaryStructDeserializerBackend.h"
+#include "BinaryStructSerializerBackend.h"
 #include "JsonStructDeserializerBackend.h"
 #include "JsonStructSerializerBackend.h"
 #include "StructDeserializer.h"
@@ -95,3 +97,103 @@ bool FJsonStructSerializerTest::RunTest( const FString& Parameters )
 
 	return true;
 }
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBinaryStructSerializerTest, "Core.Serialization.BinaryStructSerializer", EAutomationTestFlags::ATF_Editor)
+
+
+bool FBinaryStructSerializerTest::RunTest( const FString& Parameters )
+{
+	TArray<uint8> Buffer;
+	FMemoryReader Reader(Buffer);
+	FMemoryWriter Writer(Buffer);
+
+	FBinaryStructSerializerBackend SerializerBackend(Writer);
+	FBinaryStructDeserializerBackend DeserializerBackend(Reader);
+
+	StructSerializerTest::TestSerialization(*this, SerializerBackend, DeserializerBackend);
+
+	// truncated data must fail gracefully
+	for (int32 Size = 0; Size < Buffer.Num(); Size += 7)
+	{
+		TArray<uint8> TruncatedBuffer(Buffer.GetData(), Size);
+		FMemoryReader TruncatedReader(TruncatedBuffer);
+		FBinaryStructDeserializerBackend TruncatedBackend(TruncatedReader);
+		FStructSerializerTestStruct TestStruct;
+
+		TestFalse(TEXT("Deserialization of truncated data must fail"), FStructDeserializer::Deserialize(TestStruct, TruncatedBackend));
+	}
+
+	return true;
+}
+
+
+/**
+ * Compares the size and the serialization and deserialization times of the binary and Json backends.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStructSerializerBenchmarkTest, "Core.Serialization.StructSerializerBenchmark", EAutomationTestFlags::ATF_Editor)
+
+
+bool FStructSerializerBenchmarkTest::RunTest( const FString& Parameters )
+{
+	const int32 NumIterations = 2000;
+
+	FStructSerializerTestStruct TestStruct;
+	FStructDeserializerPolicies Policies;
+	TArray<uint8> Buffer;
+
+	// json
+	double StartTime = FPlatformTime::Seconds();
+
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		Buffer.Reset();
+		FMemoryWriter Writer(Buffer);
+		FJsonStructSerializerBackend Backend(Writer);
+		FStructSerializer::Serialize(TestStruct, Backend);
+	}
+
+	const double JsonWriteTime = FPlatformTime::Seconds() - StartTime;
+	const int32 JsonSize = Buffer.Num();
+	StartTime = FPlatformTime::Seconds();
+
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		FStructSerializerTestStruct ReadStruct(NoInit);
+		FMemoryReader Reader(Buffer);
+		FJsonStructDeserializerBackend Backend(Reader);
+		FStructDeserializer::Deserialize(ReadStruct, Backend, Policies);
+	}
+
+	const double JsonReadTime = FPlatformTime::Seconds() - StartTime;
+
+	// binary
+	StartTime = FPlatformTime::Seconds();
+
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		Buffer.Reset();
+		FMemoryWriter Writer(Buffer);
+		FBinaryStructSerializerBackend Backend(Writer);
+		FStructSerializer::Serialize(TestStruct, Backend);
+	}
+
+	const double BinaryWriteTime = FPlatformTime::Seconds() - StartTime;
+	const int32 BinarySize = Buffer.Num();
+	StartTime = FPlatformTime::Seconds();
+
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		FStructSerializerTestStruct ReadStruct(NoInit);
+		FMemoryReader Reader(Buffer);
+		FBinaryStructDeserializerBackend Backend(Reader);
+		FStructDeserializer::Deserialize(ReadStruct, Backend, Policies);
+	}
+
+	const double BinaryReadTime = FPlatformTime::Seconds() - StartTime;
+
+	AddLogItem(FString::Printf(TEXT("Json: %i bytes, %.2f us to serialize, %.2f us to deserialize"), JsonSize, JsonWriteTime * 1000000.0 / NumIterations, JsonReadTime * 1000000.0 / NumIterations));
+	AddLogItem(FString::Printf(TEXT("Binary: %i bytes, %.2f us to serialize, %.2f us to deserialize"), BinarySize, BinaryWriteTime * 1000000.0 / NumIterations, BinaryReadTime * 1000000.0 / NumIterations));
+
+	return true;
+}
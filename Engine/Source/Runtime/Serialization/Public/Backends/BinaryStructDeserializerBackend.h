@@ -0,0 +1,90 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "IStructDeserializerBackend.h"
+
+
+// forward declarations
+class UProperty;
+
+
+/**
+ * Implements a reader for UStruct deserialization using a compact binary format.
+ *
+ * @see FBinaryStructSerializerBackend
+ */
+class SERIALIZATION_API FBinaryStructDeserializerBackend
+	: public IStructDeserializerBackend
+{
+public:
+
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * @param InArchive The archive to deserialize from.
+	 */
+	FBinaryStructDeserializerBackend( FArchive& InArchive )
+		: Archive(InArchive)
+		, CurrentNameIndex(INDEX_NONE)
+		, LastToken(0)
+		, LastFloat(0.0)
+		, LastInteger(0)
+		, LastUnsignedInteger(0)
+	{ }
+
+public:
+
+	// IStructDeserializerBackend interface
+
+	virtual const FString& GetCurrentPropertyName() const override;
+	virtual FString GetDebugString() const override;
+	virtual const FString& GetLastErrorMessage() const override;
+	virtual bool GetNextToken( EStructDeserializerBackendTokens& OutToken ) override;
+	virtual bool ReadProperty( UProperty* Property, UProperty* Outer, void* Data, int32 ArrayIndex ) override;
+	virtual void SkipArray() override;
+	virtual void SkipStructure() override;
+
+private:
+
+	/** Reads a name reference, adding new names to the name table. @return The name's index in the table, or INDEX_NONE on error. */
+	int32 ReadName();
+
+	/** Reads a string written as UTF-8. @return true on success. */
+	bool ReadString( FString& OutString );
+
+	/** Skips tokens up to and including the end of the current array or structure. */
+	void SkipScope();
+
+private:
+
+	/** Holds the archive to deserialize from. */
+	FArchive& Archive;
+
+	/** Holds the name table index of the current property's name, or INDEX_NONE for array elements. */
+	int32 CurrentNameIndex;
+
+	/** Holds the last error message. */
+	FString LastErrorMessage;
+
+	/** Holds the last read token. */
+	uint8 LastToken;
+
+	/** Holds the last read floating point value. */
+	double LastFloat;
+
+	/** Holds the last read signed integer value. */
+	int64 LastInteger;
+
+	/** Holds the last read string or name value. */
+	FString LastString;
+
+	/** Holds the last read unsigned integer value. */
+	uint64 LastUnsignedInteger;
+
+	/** Holds the names read so far. */
+	TArray<FString> Names;
+
+	/** Holds a buffer for reading UTF-8 strings. */
+	TArray<ANSICHAR> StringBuffer;
+};
@@ -0,0 +1,69 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "IStructSerializerBackend.h"
+
+
+// forward declarations
+class UProperty;
+class UStruct;
+enum class EBinaryStructToken : uint8;
+
+
+/**
+ * Implements a writer for UStruct serialization using a compact binary format.
+ *
+ * Values are written as VarInts or raw floating point numbers and tagged with their property
+ * names, which are written once per stream and referenced by index afterwards, so that the output
+ * is a fraction of the size of the equivalent Json, and is much faster to read and write. Like Json,
+ * the format doesn't depend on the memory layout of the structures, so properties may be added or
+ * removed between the writer and the reader.
+ *
+ * @see FBinaryStructDeserializerBackend
+ */
+class SERIALIZATION_API FBinaryStructSerializerBackend
+	: public IStructSerializerBackend
+{
+public:
+
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * @param InArchive The archive to serialize into.
+	 */
+	FBinaryStructSerializerBackend( FArchive& InArchive )
+		: Archive(InArchive)
+	{ }
+
+public:
+
+	// IStructSerializerBackend interface
+
+	virtual void BeginArray( UProperty* Property ) override;
+	virtual void BeginStructure( UProperty* Property ) override;
+	virtual void BeginStructure( UStruct* TypeInfo ) override;
+	virtual void EndArray( UProperty* Property ) override;
+	virtual void EndStructure() override;
+	virtual void WriteComment( const FString& Comment ) override;
+	virtual void WriteProperty( UProperty* Property, const void* Data, UStruct* TypeInfo, int32 ArrayIndex ) override;
+
+private:
+
+	/** Writes a name reference, adding the name to the name table if needed. */
+	void WriteName( const FName& Name );
+
+	/** Writes a token, followed by the property's name unless Property is nullptr. */
+	void WriteToken( EBinaryStructToken Token, UProperty* Property );
+
+	/** Writes a string as UTF-8, preceded by its length. */
+	void WriteString( const FString& String );
+
+private:
+
+	/** Holds the archive to serialize into. */
+	FArchive& Archive;
+
+	/** Holds the name table indices of the names written so far. */
+	TMap<FName, int32> NameIndices;
+};
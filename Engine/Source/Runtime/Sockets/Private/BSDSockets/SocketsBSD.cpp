@@ -230,6 +230,102 @@ bool FSocketBSD::Recv(uint8* Data, int32 BufferSize, int32& BytesRead, ESocketRe
 }
 
 
+#if PLATFORM_HAS_BSD_SOCKET_FEATURE_MULTI_MESSAGE
+
+/** Max datagrams passed to a single sendmmsg / recvmmsg call */
+#define MAX_MULTI_MESSAGE_BATCH (64)
+
+/** Points a message header at a datagram's buffer and address */
+static void InitMultiMessage(mmsghdr& Message, iovec& IoVec, FSocketDatagram& Datagram)
+{
+	FMemory::Memzero(&Message, sizeof(mmsghdr));
+
+	IoVec.iov_base = Datagram.Data;
+	IoVec.iov_len = Datagram.BufferSize;
+
+	Message.msg_hdr.msg_name = (sockaddr*)(FInternetAddrBSD&)*Datagram.Address;
+	Message.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+	Message.msg_hdr.msg_iov = &IoVec;
+	Message.msg_hdr.msg_iovlen = 1;
+}
+
+
+bool FSocketBSD::SendMulti(FSocketDatagram* Datagrams, int32 Count, int32& NumSent)
+{
+	mmsghdr Messages[MAX_MULTI_MESSAGE_BATCH];
+	iovec IoVecs[MAX_MULTI_MESSAGE_BATCH];
+
+	NumSent = 0;
+	while (NumSent < Count)
+	{
+		const int32 BatchCount = FMath::Min(Count - NumSent, MAX_MULTI_MESSAGE_BATCH);
+		for (int32 i = 0; i < BatchCount; i++)
+		{
+			InitMultiMessage(Messages[i], IoVecs[i], Datagrams[NumSent + i]);
+		}
+
+		// A short count means the next datagram failed, the following call reports why
+		const int32 Result = sendmmsg(Socket, Messages, BatchCount, 0);
+		if (Result < 0)
+		{
+			return false;
+		}
+
+		for (int32 i = 0; i < Result; i++)
+		{
+			Datagrams[NumSent + i].BytesTransferred = Messages[i].msg_len;
+		}
+		NumSent += Result;
+		LastActivityTime = FDateTime::UtcNow();
+	}
+
+	return true;
+}
+
+
+bool FSocketBSD::RecvMulti(FSocketDatagram* Datagrams, int32 Count, int32& NumRead, ESocketReceiveFlags::Type Flags)
+{
+	mmsghdr Messages[MAX_MULTI_MESSAGE_BATCH];
+	iovec IoVecs[MAX_MULTI_MESSAGE_BATCH];
+
+	const int TranslatedFlags = TranslateFlags(Flags);
+
+	NumRead = 0;
+	while (NumRead < Count)
+	{
+		const int32 BatchCount = FMath::Min(Count - NumRead, MAX_MULTI_MESSAGE_BATCH);
+		for (int32 i = 0; i < BatchCount; i++)
+		{
+			InitMultiMessage(Messages[i], IoVecs[i], Datagrams[NumRead + i]);
+		}
+
+		const int32 Result = recvmmsg(Socket, Messages, BatchCount, TranslatedFlags, NULL);
+		if (Result < 0)
+		{
+			// Leave the error (usually would block) for the next call if something was read
+			return NumRead > 0;
+		}
+
+		for (int32 i = 0; i < Result; i++)
+		{
+			Datagrams[NumRead + i].BytesTransferred = Messages[i].msg_len;
+		}
+		NumRead += Result;
+		LastActivityTime = FDateTime::UtcNow();
+
+		if (Result < BatchCount)
+		{
+			// Nothing else is queued
+			break;
+		}
+	}
+
+	return true;
+}
+
+#endif	//PLATFORM_HAS_BSD_SOCKET_FEATURE_MULTI_MESSAGE
+
+
 bool FSocketBSD::Wait(ESocketWaitConditions::Type Condition, FTimespan WaitTime)
 {
 	if ((Condition == ESocketWaitConditions::WaitForRead) || (Condition == ESocketWaitConditions::WaitForReadOrWrite))
@@ -41,4 +41,33 @@ bool FSocket::Recv(uint8* Data, int32 BufferSize, int32& BytesRead, ESocketRecei
 		UE_LOG(LogSockets, Verbose, TEXT("Socket '%s' Recv %i Bytes"), *SocketDescription, BytesRead );
 	}
 	return true;
-}
\ No newline at end of file
+}
+
+
+bool FSocket::SendMulti(FSocketDatagram* Datagrams, int32 Count, int32& NumSent)
+{
+	for (NumSent = 0; NumSent < Count; NumSent++)
+	{
+		FSocketDatagram& Datagram = Datagrams[NumSent];
+		if (!SendTo(Datagram.Data, Datagram.BufferSize, Datagram.BytesTransferred, *Datagram.Address))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+bool FSocket::RecvMulti(FSocketDatagram* Datagrams, int32 Count, int32& NumRead, ESocketReceiveFlags::Type Flags)
+{
+	for (NumRead = 0; NumRead < Count; NumRead++)
+	{
+		FSocketDatagram& Datagram = Datagrams[NumRead];
+		if (!RecvFrom(Datagram.Data, Datagram.BufferSize, Datagram.BytesTransferred, *Datagram.Address, Flags))
+		{
+			// Leave the error (usually would block) for the next call if something was read
+			return NumRead > 0;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,256 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "SocketsPrivatePCH.h"
+#include "Sockets.h"
+#include "AutomationTest.h"
+
+
+/** Packets sent per simulated frame, roughly one per client of a busy server */
+#define MULTI_MESSAGE_TEST_PACKETS_PER_FRAME (100)
+
+/** Size of each packet */
+#define MULTI_MESSAGE_TEST_PACKET_SIZE (512)
+
+/** Number of simulated frames for each mode */
+#define MULTI_MESSAGE_TEST_FRAMES (200)
+
+/** Max packets read by a single RecvMulti call, matching UIpNetDriver */
+#define MULTI_MESSAGE_TEST_RECV_BATCH (32)
+
+
+/** Sends loopback traffic one way, counting packets and socket calls */
+class FMultiMessageTestRunner
+{
+public:
+
+	FMultiMessageTestRunner(FSocket* InSender, FSocket* InReceiver, const TSharedRef<FInternetAddr>& InDestination)
+		: NumReceived(0)
+		, NumCorrupt(0)
+		, NumSocketCalls(0)
+		, Sender(InSender)
+		, Receiver(InReceiver)
+		, Destination(InDestination)
+	{
+		ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get();
+
+		SendData.AddZeroed(MULTI_MESSAGE_TEST_PACKETS_PER_FRAME * MULTI_MESSAGE_TEST_PACKET_SIZE);
+		RecvData.AddZeroed(MULTI_MESSAGE_TEST_RECV_BATCH * MULTI_MESSAGE_TEST_PACKET_SIZE);
+		for (int32 i = 0; i < MULTI_MESSAGE_TEST_RECV_BATCH; i++)
+		{
+			RecvAddrs.Add(SocketSubsystem->CreateInternetAddr());
+		}
+	}
+
+	/** Runs every frame, returns the time it took in seconds */
+	double Run(bool bUseMulti)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (int32 Frame = 0; Frame < MULTI_MESSAGE_TEST_FRAMES; Frame++)
+		{
+			FillPackets(Frame);
+
+			if (bUseMulti)
+			{
+				SendMulti();
+				RecvMulti();
+			}
+			else
+			{
+				SendSingle();
+				RecvSingle();
+			}
+		}
+
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	int32 NumReceived;
+	int32 NumCorrupt;
+	int32 NumSocketCalls;
+
+private:
+
+	/** Stamps each packet with its frame and index so the receiver can validate it */
+	void FillPackets(int32 Frame)
+	{
+		for (int32 i = 0; i < MULTI_MESSAGE_TEST_PACKETS_PER_FRAME; i++)
+		{
+			uint8* Packet = SendData.GetData() + i * MULTI_MESSAGE_TEST_PACKET_SIZE;
+			FMemory::Memset(Packet, (uint8)(Frame + i), MULTI_MESSAGE_TEST_PACKET_SIZE);
+		}
+	}
+
+	void ValidatePacket(const uint8* Packet, int32 Size)
+	{
+		NumReceived++;
+		if (Size != MULTI_MESSAGE_TEST_PACKET_SIZE || Packet[0] != Packet[Size - 1])
+		{
+			NumCorrupt++;
+		}
+	}
+
+	void SendSingle()
+	{
+		for (int32 i = 0; i < MULTI_MESSAGE_TEST_PACKETS_PER_FRAME; i++)
+		{
+			int32 BytesSent = 0;
+			Sender->SendTo(SendData.GetData() + i * MULTI_MESSAGE_TEST_PACKET_SIZE, MULTI_MESSAGE_TEST_PACKET_SIZE, BytesSent, *Destination);
+			NumSocketCalls++;
+		}
+	}
+
+	void RecvSingle()
+	{
+		TSharedRef<FInternetAddr> FromAddr = RecvAddrs[0];
+		for (;;)
+		{
+			int32 BytesRead = 0;
+			NumSocketCalls++;
+			if (!Receiver->RecvFrom(RecvData.GetData(), MULTI_MESSAGE_TEST_PACKET_SIZE, BytesRead, *FromAddr))
+			{
+				break;
+			}
+			ValidatePacket(RecvData.GetData(), BytesRead);
+		}
+	}
+
+	void SendMulti()
+	{
+		FSocketDatagram Datagrams[MULTI_MESSAGE_TEST_PACKETS_PER_FRAME];
+		for (int32 i = 0; i < MULTI_MESSAGE_TEST_PACKETS_PER_FRAME; i++)
+		{
+			Datagrams[i].Data = SendData.GetData() + i * MULTI_MESSAGE_TEST_PACKET_SIZE;
+			Datagrams[i].BufferSize = MULTI_MESSAGE_TEST_PACKET_SIZE;
+			Datagrams[i].Address = &Destination.Get();
+		}
+
+		int32 NumSent = 0;
+		Sender->SendMulti(Datagrams, MULTI_MESSAGE_TEST_PACKETS_PER_FRAME, NumSent);
+		NumSocketCalls++;
+	}
+
+	void RecvMulti()
+	{
+		FSocketDatagram Datagrams[MULTI_MESSAGE_TEST_RECV_BATCH];
+		for (int32 i = 0; i < MULTI_MESSAGE_TEST_RECV_BATCH; i++)
+		{
+			Datagrams[i].Data = RecvData.GetData() + i * MULTI_MESSAGE_TEST_PACKET_SIZE;
+			Datagrams[i].BufferSize = MULTI_MESSAGE_TEST_PACKET_SIZE;
+			Datagrams[i].Address = &RecvAddrs[i].Get();
+		}
+
+		for (;;)
+		{
+			int32 NumRead = 0;
+			NumSocketCalls++;
+			if (!Receiver->RecvMulti(Datagrams, MULTI_MESSAGE_TEST_RECV_BATCH, NumRead))
+			{
+				break;
+			}
+
+			for (int32 i = 0; i < NumRead; i++)
+			{
+				ValidatePacket(Datagrams[i].Data, Datagrams[i].BytesTransferred);
+			}
+
+			if (NumRead < MULTI_MESSAGE_TEST_RECV_BATCH)
+			{
+				break;
+			}
+		}
+	}
+
+	FSocket* Sender;
+	FSocket* Receiver;
+	TSharedRef<FInternetAddr> Destination;
+
+	TArray<uint8> SendData;
+	TArray<uint8> RecvData;
+	TArray< TSharedRef<FInternetAddr> > RecvAddrs;
+};
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSocketMultiMessageTest, "Engine.Networking.Sockets.MultiMessage Benchmark", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+
+/**
+ * Sends packets over loopback with SendTo/RecvFrom and with SendMulti/RecvMulti, and reports packets per second
+ * and socket calls per frame for both. On platforms with PLATFORM_HAS_BSD_SOCKET_FEATURE_MULTI_MESSAGE each
+ * socket call is a single syscall for up to 64 datagrams.
+ */
+bool FSocketMultiMessageTest::RunTest(const FString& Parameters)
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get();
+	if (SocketSubsystem == NULL)
+	{
+		AddError(TEXT("No socket subsystem"));
+		return false;
+	}
+
+	FSocket* Sender = SocketSubsystem->CreateSocket(NAME_DGram, TEXT("MultiMessageTest Sender"));
+	FSocket* Receiver = SocketSubsystem->CreateSocket(NAME_DGram, TEXT("MultiMessageTest Receiver"));
+
+	bool bSuccess = false;
+	if (Sender != NULL && Receiver != NULL)
+	{
+		bool bIsValid = false;
+		TSharedRef<FInternetAddr> Destination = SocketSubsystem->CreateInternetAddr();
+		Destination->SetIp(TEXT("127.0.0.1"), bIsValid);
+		Destination->SetPort(0);
+
+		// Room for a whole frame of packets, so none are dropped before they are read
+		int32 NewSize = 0;
+		Receiver->SetReceiveBufferSize(MULTI_MESSAGE_TEST_PACKETS_PER_FRAME * MULTI_MESSAGE_TEST_PACKET_SIZE * 2, NewSize);
+		Sender->SetSendBufferSize(MULTI_MESSAGE_TEST_PACKETS_PER_FRAME * MULTI_MESSAGE_TEST_PACKET_SIZE * 2, NewSize);
+
+		if (bIsValid && Receiver->Bind(*Destination) && Receiver->SetNonBlocking() && Sender->SetNonBlocking())
+		{
+			// Pick up the port the receiver was bound to
+			Receiver->GetAddress(*Destination);
+
+			const int32 NumSent = MULTI_MESSAGE_TEST_FRAMES * MULTI_MESSAGE_TEST_PACKETS_PER_FRAME;
+
+			FMultiMessageTestRunner Single(Sender, Receiver, Destination);
+			const double SingleTime = Single.Run(false);
+
+			FMultiMessageTestRunner Multi(Sender, Receiver, Destination);
+			const double MultiTime = Multi.Run(true);
+
+			AddLogItem(FString::Printf(TEXT("SendTo/RecvFrom:      %.0f packets/sec, %.1f socket calls/frame, %d/%d packets received"),
+				Single.NumReceived / FMath::Max(SingleTime, 1e-6), (float)Single.NumSocketCalls / MULTI_MESSAGE_TEST_FRAMES, Single.NumReceived, NumSent));
+			AddLogItem(FString::Printf(TEXT("SendMulti/RecvMulti:  %.0f packets/sec, %.1f socket calls/frame, %d/%d packets received"),
+				Multi.NumReceived / FMath::Max(MultiTime, 1e-6), (float)Multi.NumSocketCalls / MULTI_MESSAGE_TEST_FRAMES, Multi.NumReceived, NumSent));
+
+			TestEqual(TEXT("Packets received with SendTo/RecvFrom must be intact"), Single.NumCorrupt, 0);
+			TestEqual(TEXT("Packets received with SendMulti/RecvMulti must be intact"), Multi.NumCorrupt, 0);
+
+			// Loopback can still drop packets on a busy machine, which doesn't make the results invalid
+			if (Single.NumReceived != NumSent || Multi.NumReceived != NumSent)
+			{
+				AddWarning(TEXT("Some packets were dropped, packets/sec only counts received packets"));
+			}
+
+			bSuccess = Single.NumCorrupt == 0 && Multi.NumCorrupt == 0;
+		}
+		else
+		{
+			AddError(TEXT("Unable to set up loopback sockets"));
+		}
+	}
+	else
+	{
+		AddError(TEXT("Unable to create sockets"));
+	}
+
+	if (Sender != NULL)
+	{
+		SocketSubsystem->DestroySocket(Sender);
+	}
+	if (Receiver != NULL)
+	{
+		SocketSubsystem->DestroySocket(Receiver);
+	}
+
+	return bSuccess;
+}
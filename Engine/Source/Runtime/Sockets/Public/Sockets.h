@@ -6,6 +6,32 @@
 #include "IPAddress.h"
 #include "SocketTypes.h"
 
+/**
+ * A datagram sent by FSocket::SendMulti or received by FSocket::RecvMulti
+ */
+struct FSocketDatagram
+{
+	/** The data to send, or the buffer to read into */
+	uint8* Data;
+
+	/** The size of the data to send, or the max size of the buffer to read into */
+	int32 BufferSize;
+
+	/** Out param indicating how many bytes were sent or read */
+	int32 BytesTransferred;
+
+	/** The network byte ordered address to send to, or receiving the address of the sender */
+	FInternetAddr* Address;
+
+	FSocketDatagram()
+		: Data(NULL)
+		, BufferSize(0)
+		, BytesTransferred(0)
+		, Address(NULL)
+	{
+	}
+};
+
 /**
  * This is our abstract base class that hides the platform specific socket implementation
  */
@@ -155,6 +181,32 @@ public:
 	 */
 	virtual bool Recv(uint8* Data, int32 BufferSize, int32& BytesRead, ESocketReceiveFlags::Type Flags = ESocketReceiveFlags::None);
 
+	/**
+	 * Sends several datagrams, each to its own network byte ordered address.
+	 * Platforms that support it send them with a single call, the default implementation calls SendTo for each one.
+	 *
+	 * @param Datagrams the datagrams to send
+	 * @param Count the number of datagrams to send
+	 * @param NumSent out param indicating how many datagrams were sent
+	 *
+	 * @return true if every datagram was sent, false if an error occurred sending datagram NumSent
+	 */
+	virtual bool SendMulti(FSocketDatagram* Datagrams, int32 Count, int32& NumSent);
+
+	/**
+	 * Reads up to Count datagrams from the socket. Gathers the source addresses too.
+	 * Platforms that support it read them with a single call, the default implementation calls RecvFrom for each one.
+	 *
+	 * @param Datagrams the buffers to read into, in order
+	 * @param Count the max number of datagrams to read
+	 * @param NumRead out param indicating how many datagrams were read
+	 * @param Flags the receive flags
+	 *
+	 * @return true if any datagram was read, false if an error occurred before the first one. Errors after the
+	 *		first datagram are reported by the next call. Reading fewer than Count datagrams means no more were queued.
+	 */
+	virtual bool RecvMulti(FSocketDatagram* Datagrams, int32 Count, int32& NumRead, ESocketReceiveFlags::Type Flags = ESocketReceiveFlags::None);
+
 	/**
 	 * Blocks until the specified condition is met.
 	 *